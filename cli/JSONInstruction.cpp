@@ -9,6 +9,8 @@
 
 #include <mumble/json_bridge/messages/Message.h>
 
+#include <vector>
+
 namespace Mumble {
 namespace JsonBridge {
 	namespace CLI {
@@ -16,9 +18,26 @@ namespace JsonBridge {
 		JSONInstruction::JSONInstruction(const nlohmann::json &msg) : m_msg(msg) {}
 
 		nlohmann::json JSONInstruction::execute(const JSONInterface &jsonInterface) {
+			if (m_msg.is_array()) {
+				// The API calls are sent all at once and their responses are returned in the same order
+				std::vector< nlohmann::json > calls;
+				for (const nlohmann::json &current : m_msg) {
+					MESSAGE_ASSERT_FIELD(current, "message_type", string);
+
+					if (current["message_type"].get< std::string >() != "api_call") {
+						throw Messages::InvalidMessageException("Only API calls can be sent as an array");
+					}
+
+					calls.push_back(current);
+				}
+
+				return jsonInterface.processAll(std::move(calls));
+			}
+
 			MESSAGE_ASSERT_FIELD(m_msg, "message_type", string);
 
-			if (m_msg["message_type"].get< std::string >() == "api_call") {
+			if (m_msg["message_type"].get< std::string >() == "api_call"
+				|| m_msg["message_type"].get< std::string >() == "batch") {
 				return jsonInterface.process(m_msg);
 			} else if (m_msg["message_type"].get< std::string >() == "operation") {
 				return handleOperation(m_msg["message"],
@@ -6,17 +6,103 @@
 #include "JSONInterface.h"
 
 #include <mumble/json_bridge/Bridge.h>
+#include <mumble/json_bridge/Framing.h>
 #include <mumble/json_bridge/Util.h>
+#include <mumble/json_bridge/transports/NamedPipeTransport.h>
+#include <mumble/json_bridge/transports/SharedMemoryTransport.h>
+#include <mumble/json_bridge/transports/SocketTransport.h>
 
 #include <filesystem>
 #include <iostream>
+#include <stdexcept>
+#include <unordered_map>
+
+#ifdef PLATFORM_UNIX
+#	include <unistd.h>
+#endif
 
 namespace Mumble {
 namespace JsonBridge {
 	namespace CLI {
 
-		JSONInterface::JSONInterface(uint32_t readTimeout, uint32_t writeTimeout)
-			: m_readTimeout(readTimeout), m_writeTimeout(writeTimeout) {
+		JSONInterface::JSONInterface(uint32_t readTimeout, uint32_t writeTimeout, Transport transport,
+									 Encoding encoding)
+			: m_readTimeout(readTimeout), m_writeTimeout(writeTimeout), m_transport(transport),
+			  m_encoding(Encoding::JSON) {
+			if (m_transport == Transport::SOCKET || m_transport == Transport::SHARED_MEMORY) {
+#ifdef PLATFORM_UNIX
+				// Being connected is all it takes - there is no need for registering with the Bridge
+				auto socket = std::make_unique< Transports::SocketConnection >(
+					SeqPacketSocket::connect(Bridge::s_socketAddress, m_writeTimeout));
+
+				if (m_transport == Transport::SHARED_MEMORY) {
+					// clang-format off
+					nlohmann::json registration = {
+						{"message_type", "registration"},
+						{"message",
+							{
+								{"transport", "shared_memory"},
+								{"encoding", to_string(encoding)}
+							}
+						}
+					};
+					// clang-format on
+
+					socket->send(registration.dump(), m_writeTimeout);
+
+					// The handles of the shared memory are passed along with the response
+					std::vector< int > handles;
+					nlohmann::json response = nlohmann::json::parse(socket->receive(handles, m_readTimeout));
+
+					if (response["response_type"] != "registration") {
+						for (int handle : handles) {
+							::close(handle);
+						}
+
+						throw std::runtime_error("The Bridge refused to set up shared memory: "
+												 + response["response"].value("error_message", std::string()));
+					}
+
+					m_connection = std::make_unique< Transports::SharedMemoryConnection >(
+						std::move(socket), SharedMemoryChannel::attach(handles));
+				} else {
+					m_connection = std::move(socket);
+
+					if (encoding != Encoding::JSON) {
+						// Registering is only needed for negotiating the encoding
+						// clang-format off
+						nlohmann::json registration = {
+							{"message_type", "registration"},
+							{"message",
+								{
+									{"transport", "socket"},
+									{"encoding", to_string(encoding)}
+								}
+							}
+						};
+						// clang-format on
+
+						nlohmann::json response = process(std::move(registration));
+
+						if (response["response_type"] != "registration") {
+							throw std::runtime_error("The Bridge refused to switch the encoding: "
+													 + response["response"].value("error_message", std::string()));
+						}
+					}
+				}
+
+				m_encoding = encoding;
+
+				return;
+#else
+				throw std::invalid_argument("Sockets are only available on Unix");
+#endif
+			}
+
+			if (isBinary(encoding)) {
+				throw std::invalid_argument("Binary encodings can't be used with named pipes");
+			}
+
 			std::filesystem::path pipePath;
 #ifdef PLATFORM_WINDOWS
 			pipePath = "\\\\.\\pipe\\";
@@ -26,7 +112,8 @@ namespace JsonBridge {
 
 			pipePath = pipePath / ".mumble-json-bridge-cli";
 
-			m_pipe = NamedPipe::create(pipePath);
+			m_connection = std::make_unique< Transports::NamedPipeConnection >(
+				Bridge::s_pipePath, NamedPipe::create(pipePath), Framing::NEWLINE);
 
 			m_secret = Util::generateRandomString(12);
 
@@ -36,21 +123,27 @@ namespace JsonBridge {
 				{"message",
 					{
 						{"pipe_path", pipePath.string()},
-						{"secret", m_secret}
+						{"secret", m_secret},
+						{"framing", to_string(Framing::NEWLINE)}
 					}
 				}
 			};
 			// clang-format off
 			
-			NamedPipe::write(Bridge::s_pipePath, registration.dump(), m_writeTimeout);
+			m_connection->send(registration.dump(), m_writeTimeout);
 
-			nlohmann::json response = nlohmann::json::parse(m_pipe.read_blocking(m_readTimeout));
+			nlohmann::json response = nlohmann::json::parse(m_connection->receive(m_readTimeout));
 
 			m_bridgeSecret = response["secret"].get<std::string>();
 			m_id = response["response"]["client_id"].get<client_id_t>();
 		}
 
 		JSONInterface::~JSONInterface() {
+			if (m_transport != Transport::NAMED_PIPE) {
+				// Closing the connection is all it takes to disconnect
+				return;
+			}
+
 			// clang-format off
 			nlohmann::json message = {
 				{ "message_type", "disconnect" },
@@ -60,10 +153,10 @@ namespace JsonBridge {
 			// clang-format on
 
 			try {
-				NamedPipe::write(Bridge::s_pipePath, message.dump(), m_writeTimeout);
+				m_connection->send(message.dump(), m_writeTimeout);
 				// We patiently wait for the Bridge's reply, even though we don't care about it. This is in
 				// order for the Bridge's operation to not error due to timeout.
-				std::string answer = m_pipe.read_blocking(m_readTimeout);
+				std::string answer = m_connection->receive(m_readTimeout);
 			} catch (...) {
 				// Ignore any exceptions that this might cause. If it does throw then this client might not
 				// be disconnected from the Bridge, which isn't that bad. Besides: We probably can't do anything
@@ -71,15 +164,23 @@ namespace JsonBridge {
 			}
 		}
 
-		nlohmann::json JSONInterface::process(nlohmann::json msg) const {
-			msg["secret"]    = m_secret;
-			msg["client_id"] = m_id;
+		std::uint64_t JSONInterface::prepare(nlohmann::json &msg) const {
+			if (m_transport == Transport::NAMED_PIPE) {
+				msg["secret"]    = m_secret;
+				msg["client_id"] = m_id;
+			}
 
-			NamedPipe::write(Bridge::s_pipePath, msg.dump(), m_writeTimeout);
+			std::uint64_t requestID = m_nextRequestID++;
+			msg["request_id"]       = requestID;
 
-			nlohmann::json response = nlohmann::json::parse(m_pipe.read_blocking(m_readTimeout));
+			return requestID;
+		}
 
-			if (response["secret"].get< std::string >() != m_bridgeSecret) {
+		nlohmann::json JSONInterface::parseResponse(std::string_view content) const {
+			nlohmann::json response = decode(content, m_encoding);
+
+			// Other connections identify both sides, so there is no need for checking secrets
+			if (m_transport == Transport::NAMED_PIPE && response["secret"].get< std::string >() != m_bridgeSecret) {
 				std::cerr << "[ERROR]: Bridge secret doesn't match" << std::endl;
 				return {};
 			}
@@ -89,6 +190,70 @@ namespace JsonBridge {
 
 			return response;
 		}
+
+		nlohmann::json JSONInterface::process(nlohmann::json msg) const {
+			std::uint64_t requestID = prepare(msg);
+
+			m_connection->send(encode(msg, m_encoding), m_writeTimeout);
+
+			while (true) {
+				nlohmann::json response = parseResponse(m_connection->receive(m_readTimeout));
+
+				if (response.is_null()) {
+					return {};
+				}
+
+				// Responses to requests that have timed out before are skipped
+				if (response.value("request_id", requestID) == requestID) {
+					response.erase("request_id");
+
+					return response;
+				}
+			}
+		}
+
+		std::vector< nlohmann::json > JSONInterface::processAll(std::vector< nlohmann::json > messages) const {
+			std::vector< nlohmann::json > responses(messages.size());
+
+			// The index of the message belonging to a request ID
+			std::unordered_map< std::uint64_t, std::size_t > pendingRequests;
+
+			auto handleResponse = [&](nlohmann::json response) {
+				if (!response.is_object() || !response.contains("request_id")
+					|| !response["request_id"].is_number_unsigned()) {
+					// Without a request ID there is no way of telling which request the response belongs to
+					return;
+				}
+
+				auto it = pendingRequests.find(response["request_id"].get< std::uint64_t >());
+				if (it == pendingRequests.end()) {
+					return;
+				}
+
+				response.erase("request_id");
+				responses[it->second] = std::move(response);
+
+				pendingRequests.erase(it);
+			};
+
+			for (std::size_t i = 0; i < messages.size(); i++) {
+				pendingRequests[prepare(messages[i])] = i;
+
+				m_connection->send(encode(messages[i], m_encoding), m_writeTimeout);
+
+				// Pick up the responses that have arrived already, so that they don't pile up on the Bridge's end
+				std::string_view content;
+				while (m_connection->tryReceive(content) == Transports::Status::OK) {
+					handleResponse(parseResponse(content));
+				}
+			}
+
+			while (!pendingRequests.empty()) {
+				handleResponse(parseResponse(m_connection->receive(m_readTimeout)));
+			}
+
+			return responses;
+		}
 	}; // namespace CLI
 };     // namespace JsonBridge
 };     // namespace Mumble
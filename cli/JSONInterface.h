@@ -7,7 +7,13 @@
 #define MUMBLE_JSONBRIDGE_CLI_INTERFACE_H_
 
 #include <mumble/json_bridge/BridgeClient.h>
-#include <mumble/json_bridge/NamedPipe.h>
+#include <mumble/json_bridge/Encoding.h>
+#include <mumble/json_bridge/transports/Transport.h>
+
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
 
 #include <nlohmann/json.hpp>
 
@@ -15,6 +21,24 @@ namespace Mumble {
 namespace JsonBridge {
 	namespace CLI {
 
+		/**
+		 * The ways of communicating with the Bridge
+		 */
+		enum class Transport {
+			/**
+			 * A pair of named pipes (one owned by the Bridge, one owned by the client)
+			 */
+			NAMED_PIPE,
+			/**
+			 * A connection to the Bridge's SOCK_SEQPACKET socket (only available on Unix)
+			 */
+			SOCKET,
+			/**
+			 * A pair of shared memory rings, set up via the Bridge's socket (only available on Unix)
+			 */
+			SHARED_MEMORY
+		};
+
 		/**
 		 * The interface used to communicate with the Mumble JSON bridge
 		 */
@@ -29,9 +53,17 @@ namespace JsonBridge {
 			 */
 			uint32_t m_writeTimeout;
 			/**
-			 * The pipe that is being used by this interface to receive answers from the Bridge
+			 * The transport used for communicating with the Bridge
+			 */
+			Transport m_transport;
+			/**
+			 * The encoding of the messages exchanged with the Bridge
+			 */
+			Encoding m_encoding;
+			/**
+			 * The connection to the Bridge
 			 */
-			NamedPipe m_pipe;
+			std::unique_ptr< Transports::Connection > m_connection;
 			/**
 			 * The ID the Bridge has assigned us
 			 */
@@ -44,9 +76,36 @@ namespace JsonBridge {
 			 * The Bridge's secret
 			 */
 			std::string m_bridgeSecret;
+			/**
+			 * The request ID used for the next message sent to the Bridge
+			 */
+			mutable std::uint64_t m_nextRequestID = 0;
+
+			/**
+			 * Adds everything to the given message that the Bridge needs for processing it (including a new request ID)
+			 *
+			 * @param msg The message to be sent
+			 * @returns The request ID that has been assigned to the message
+			 */
+			std::uint64_t prepare(nlohmann::json &msg) const;
+			/**
+			 * Parses the given response and verifies that it has been sent by the Bridge
+			 *
+			 * @param response The (unparsed) response
+			 * @returns The parsed response (without the Bridge's secret) or null if it hasn't been sent by the Bridge
+			 */
+			nlohmann::json parseResponse(std::string_view response) const;
 
 		public:
-			explicit JSONInterface(uint32_t readTimeout = 1000, uint32_t m_writeTimeout = 100);
+			/**
+			 * @param readTimeout The timeout to use for read operations
+			 * @param writeTimeout The timeout to use for write operations
+			 * @param transport The transport to use for communicating with the Bridge
+			 * @param encoding The encoding to use for the messages exchanged with the Bridge. Binary encodings are only
+			 * available for transports other than Transport::NAMED_PIPE.
+			 */
+			explicit JSONInterface(uint32_t readTimeout = 1000, uint32_t writeTimeout = 100,
+								   Transport transport = Transport::NAMED_PIPE, Encoding encoding = Encoding::JSON);
 			~JSONInterface();
 
 			/**
@@ -56,6 +115,14 @@ namespace JsonBridge {
 			 * @returns The Bridge's response
 			 */
 			nlohmann::json process(nlohmann::json msg) const;
+			/**
+			 * Sends all given messages to the Mumble JSON Bridge without waiting for the responses in between
+			 * (pipelining). The responses are told apart by their request IDs.
+			 *
+			 * @param messages The messages to be sent
+			 * @returns The Bridge's responses in the order of the respective messages
+			 */
+			std::vector< nlohmann::json > processAll(std::vector< nlohmann::json > messages) const;
 		};
 
 	}; // namespace CLI
@@ -8,6 +8,9 @@
 #include "JSONInterface.h"
 #include "handleOperation.h"
 
+#include <mumble/json_bridge/Encoding.h>
+#include <mumble/json_bridge/NamedPipe.h>
+
 #include <boost/algorithm/string.hpp>
 #include <boost/program_options.hpp>
 
@@ -15,6 +18,7 @@
 
 #include <filesystem>
 #include <iostream>
+#include <stdexcept>
 #include <string>
 
 int main(int argc, char **argv) {
@@ -23,6 +27,8 @@ int main(int argc, char **argv) {
 
 		uint32_t readTimeout;
 		uint32_t writeTimeout;
+		std::string transport;
+		std::string encoding;
 
 		desc.add_options()("help,h", "Produces this help message")("json,j",
 																   boost::program_options::value< std::string >(),
@@ -30,7 +36,12 @@ int main(int argc, char **argv) {
 			"read-timeout,r", boost::program_options::value< uint32_t >(&readTimeout)->default_value(1000),
 			"The timeout for read-operations (in ms)")(
 			"write-timeout,w", boost::program_options::value< uint32_t >(&writeTimeout)->default_value(100),
-			"The timeout for write-operations (in ms)");
+			"The timeout for write-operations (in ms)")(
+			"transport,t", boost::program_options::value< std::string >(&transport)->default_value("pipe"),
+			"The transport used for talking to the Bridge (\"pipe\", \"socket\" or \"shm\")")(
+			"encoding,e", boost::program_options::value< std::string >(&encoding)->default_value("json"),
+			"The encoding of the messages exchanged with the Bridge (\"json\", \"cbor\" or \"msgpack\"). Binary "
+			"encodings require the socket or shm transport.");
 
 		boost::program_options::variables_map vm;
 		boost::program_options::store(boost::program_options::parse_command_line(argc, argv, desc), vm);
@@ -54,7 +65,28 @@ int main(int argc, char **argv) {
 
 		Mumble::JsonBridge::CLI::JSONInstruction instruction(json);
 
-		Mumble::JsonBridge::CLI::JSONInterface jsonInterface(readTimeout, writeTimeout);
+		Mumble::JsonBridge::CLI::Transport selectedTransport;
+		if (boost::iequals(transport, "pipe")) {
+			selectedTransport = Mumble::JsonBridge::CLI::Transport::NAMED_PIPE;
+		} else if (boost::iequals(transport, "socket")) {
+			selectedTransport = Mumble::JsonBridge::CLI::Transport::SOCKET;
+		} else if (boost::iequals(transport, "shm")) {
+			selectedTransport = Mumble::JsonBridge::CLI::Transport::SHARED_MEMORY;
+		} else {
+			std::cerr << "[ERROR]: Unknown transport \"" << transport << "\"" << std::endl;
+			return 1;
+		}
+
+		Mumble::JsonBridge::Encoding selectedEncoding;
+		try {
+			selectedEncoding = Mumble::JsonBridge::encoding_from_string(encoding);
+		} catch (const std::invalid_argument &) {
+			std::cerr << "[ERROR]: Unknown encoding \"" << encoding << "\"" << std::endl;
+			return 1;
+		}
+
+		Mumble::JsonBridge::CLI::JSONInterface jsonInterface(readTimeout, writeTimeout, selectedTransport,
+															 selectedEncoding);
 
 		std::cout << instruction.execute(jsonInterface).dump(2) << std::endl;
 	} catch (const Mumble::JsonBridge::TimeoutException &) {
@@ -0,0 +1,106 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+#ifndef MUMBLE_JSONBRIDGE_ARENA_H_
+#define MUMBLE_JSONBRIDGE_ARENA_H_
+
+#include "mumble/json_bridge/NonCopyable.h"
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+namespace Mumble {
+namespace JsonBridge {
+
+	/**
+	 * A monotonic memory resource for data that only lives while a single message is being handled. Allocations are
+	 * served by bumping a pointer within the arena's blocks and memory is never given back individually. Instead the
+	 * whole arena is reset once the message has been handled.
+	 *
+	 * The memory is kept across resets: If a message needed more than one block, the blocks are merged into a single
+	 * one of the combined size on the next reset. Thus, once the arena has grown to the size the messages need,
+	 * handling them doesn't involve the global allocator at all anymore.
+	 *
+	 * An arena must only be used by a single thread at a time.
+	 */
+	class Arena : public std::pmr::memory_resource, NonCopyable {
+	private:
+		/**
+		 * A chunk of memory allocations are served from
+		 */
+		struct Block {
+			std::unique_ptr< std::byte[] > memory;
+			std::size_t size;
+		};
+
+		/**
+		 * The blocks of this arena. Only the last one is used for new allocations.
+		 */
+		std::vector< Block > m_blocks;
+		/**
+		 * The amount of bytes of the last block that have been handed out already
+		 */
+		std::size_t m_used = 0;
+		/**
+		 * The combined size of all blocks
+		 */
+		std::size_t m_capacity = 0;
+		/**
+		 * The size of the first block
+		 */
+		std::size_t m_initialSize;
+
+		/**
+		 * Appends a new block that is large enough to hold an allocation of the given size
+		 *
+		 * @param minSize The minimum size of the block
+		 */
+		void grow(std::size_t minSize);
+
+	protected:
+		void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+		void do_deallocate(void *ptr, std::size_t bytes, std::size_t alignment) override;
+		bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+
+	public:
+		/**
+		 * The size of the first block an arena allocates
+		 */
+		static constexpr std::size_t DEFAULT_INITIAL_SIZE = 4 * 1024;
+
+		/**
+		 * @param initialSize The size of the arena's first block. It is allocated lazily.
+		 */
+		explicit Arena(std::size_t initialSize = DEFAULT_INITIAL_SIZE);
+		~Arena();
+
+		/**
+		 * Releases all allocations at once, so that the arena's memory can be used again. Everything allocated from
+		 * the arena must not be used anymore after this call.
+		 */
+		void reset();
+
+		/**
+		 * @returns The combined size of the arena's blocks
+		 */
+		[[nodiscard]] std::size_t getCapacity() const noexcept;
+		/**
+		 * @returns The amount of blocks the arena consists of
+		 */
+		[[nodiscard]] std::size_t getBlockCount() const noexcept;
+
+		/**
+		 * @returns The arena of the calling thread. Every thread gets an arena of its own, which lives as long as the
+		 * thread does.
+		 */
+		static Arena &forThisThread();
+	};
+
+}; // namespace JsonBridge
+}; // namespace Mumble
+
+#endif // MUMBLE_JSONBRIDGE_ARENA_H_
@@ -7,14 +7,36 @@
 #define MUMBLE_JSONBRIDGE_BRIDGE_H_
 
 #include "mumble/json_bridge/BridgeClient.h"
+#include "mumble/json_bridge/Encoding.h"
+#include "mumble/json_bridge/Event.h"
+#include "mumble/json_bridge/EventLoop.h"
 #include "mumble/json_bridge/NamedPipe.h"
+#include "mumble/json_bridge/OutboundQueue.h"
+#include "mumble/json_bridge/ResponseWriter.h"
+#include "mumble/json_bridge/ServerState.h"
+#include "mumble/json_bridge/TalkingStateCoalescer.h"
+#include "mumble/json_bridge/WorkerGroup.h"
+#include "mumble/json_bridge/transports/Transport.h"
 
 #include "mumble/json_bridge/messages/APICall.h"
+#include "mumble/json_bridge/messages/APICallReader.h"
+#include "mumble/json_bridge/messages/Batch.h"
 #include "mumble/json_bridge/messages/Registration.h"
+#include "mumble/json_bridge/messages/Subscription.h"
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <vector>
 
 #include <boost/thread/thread.hpp>
 
@@ -25,10 +47,115 @@
 namespace Mumble {
 namespace JsonBridge {
 
+	/**
+	 * The amount of worker threads used by the stages of the Bridge's message pipeline. A stage without any threads
+	 * is executed by the thread of the preceding stage instead.
+	 *
+	 * @see Mumble::JsonBridge::Bridge
+	 */
+	struct PipelineConfig {
+		/**
+		 * The amount of threads parsing (and validating) received messages. The messages are still processed in the
+		 * order in which they have been received. Without any parse threads, messages are parsed by the Bridge's own
+		 * thread, straight from the connection's memory.
+		 */
+		std::size_t parseThreads = 1;
+		/**
+		 * The amount of threads executing requests (i.e. calling the MumbleAPI). The requests of a single client are
+		 * always executed one after another by the same thread, but requests of different clients are executed in
+		 * parallel.
+		 */
+		std::size_t executionThreads = 2;
+		/**
+		 * The amount of threads serializing responses
+		 */
+		std::size_t serializationThreads = 1;
+		/**
+		 * The amount of jobs that may be waiting for every single thread. If a stage falls behind, the preceding
+		 * stage is slowed down accordingly.
+		 */
+		std::size_t queueCapacity = 256;
+	};
+
+	/**
+	 * Limits for the messages the Bridge receives. Messages exceeding them are discarded without being parsed.
+	 */
+	struct InboundLimits {
+		/**
+		 * The maximum size of a single message in bytes. Messages received via the named pipe are discarded while
+		 * they are being received once they exceed this size, so that they never have to be buffered as a whole.
+		 */
+		std::size_t maxMessageSize = 1024 * 1024;
+		/**
+		 * The maximum size of a registration message in bytes. Registrations are accepted from anyone who can write
+		 * to the named pipe, whereas all other messages have to come from a registered client.
+		 */
+		std::size_t maxRegistrationSize = 4 * 1024;
+	};
+
+	/**
+	 * Settings for the events the Bridge pushes to its clients
+	 */
+	struct EventConfig {
+		/**
+		 * How often the recorded talking-state changes are collected. Windows are effectively rounded up to a
+		 * multiple of this interval.
+		 */
+		std::chrono::milliseconds collectionInterval = std::chrono::milliseconds(10);
+		/**
+		 * How long talking-state changes are collected before they are sent to a client (unless the client asks for
+		 * a window of its own when subscribing). Changes of the same user within the window are merged.
+		 */
+		std::chrono::milliseconds talkingStateWindow = std::chrono::milliseconds(50);
+		/**
+		 * The maximum amount of talking-state frames per second sent to a client (unless the client asks for a rate
+		 * of its own when subscribing). Zero means no limit.
+		 */
+		double maxTalkingStateRate = 20;
+		/**
+		 * The maximum amount of users whose talking-state changes may wait for being sent to a single client
+		 */
+		std::size_t maxPendingTalkingStates = TalkingStateCoalescer::DEFAULT_MAX_PENDING;
+	};
+
+	/**
+	 * Counters about the messages the Bridge has received. They can be read from any thread.
+	 */
+	struct InboundStatistics {
+		/**
+		 * The amount of messages that have been received
+		 */
+		std::atomic< std::uint64_t > receivedMessages = std::atomic< std::uint64_t >(0);
+		/**
+		 * The amount of messages that have been discarded for exceeding the InboundLimits
+		 */
+		std::atomic< std::uint64_t > oversizedMessages = std::atomic< std::uint64_t >(0);
+		/**
+		 * The amount of messages that have been discarded because they couldn't be parsed
+		 */
+		std::atomic< std::uint64_t > malformedMessages = std::atomic< std::uint64_t >(0);
+		/**
+		 * The amount of messages that have been discarded because they didn't come from a registered client (or
+		 * didn't carry its secret)
+		 */
+		std::atomic< std::uint64_t > unauthenticatedMessages = std::atomic< std::uint64_t >(0);
+		/**
+		 * The amount of invalid messages whose sender couldn't be told about the error
+		 */
+		std::atomic< std::uint64_t > unreportedErrors = std::atomic< std::uint64_t >(0);
+	};
+
 	/**
 	 * Tbis class represents the heart of the Mumble-JSON-Bridge. It is responsible for creating a new thread in which
-	 * it'll create the named pipe used for communication. It will enter a loop of polling for messages until the bridge
-	 * is stopped again.
+	 * it'll create the named pipe used for communication. This thread runs an EventLoop that processes incoming
+	 * messages (and any work posted to the Bridge) until the bridge is stopped again.
+	 *
+	 * The Bridge doesn't depend on any particular transport. Clients reach it through Transports::Listener instances
+	 * and are talked to through Transports::Connection instances (see addListener()).
+	 *
+	 * Messages pass through a pipeline: all I/O happens in the EventLoop, whereas parsing messages, executing
+	 * requests and serializing responses is done by worker threads (see PipelineConfig). Responses are always sent
+	 * to a client in the order in which it has sent the corresponding requests.
 	 */
 	class Bridge {
 	private:
@@ -42,9 +169,233 @@ namespace JsonBridge {
 		 */
 		boost::thread m_workerThread;
 		/**
-		 * The pipe-instance that is used for communication
+		 * The event loop run by m_workerThread
+		 */
+		EventLoop m_loop;
+		/**
+		 * The listeners that are always offered. These are created anew whenever the Bridge is started.
+		 */
+		std::vector< std::unique_ptr< Transports::Listener > > m_builtinListeners;
+		/**
+		 * The listeners that have been added via addListener()
+		 */
+		std::vector< std::unique_ptr< Transports::Listener > > m_additionalListeners;
+#ifdef PLATFORM_UNIX
+		/**
+		 * The address of the socket clients may connect to instead of using named pipes. If empty, no socket is
+		 * offered.
+		 */
+		std::string m_socketAddress = s_socketAddress;
+#endif
+#ifdef PLATFORM_UNIX
+		/**
+		 * Bookkeeping for a client whose outbound queue could not be written completely
 		 */
-		NamedPipe m_pipe;
+		struct PendingWrite {
+			/**
+			 * Whether a retry has been scheduled already (used while there is no reader on the client's pipe)
+			 */
+			bool retryScheduled = false;
+			/**
+			 * The amount of queued bytes at the last time progress has been made
+			 */
+			std::size_t queuedBytes = 0;
+			/**
+			 * The point in time at which progress has been made the last time
+			 */
+			EventLoop::clock::time_point stalledSince = EventLoop::clock::now();
+		};
+		/**
+		 * The clients that have messages queued that could not be written yet
+		 */
+		std::unordered_map< client_id_t, PendingWrite > m_pendingWrites;
+#endif
+		/**
+		 * Counters aggregated over the outbound queues of all clients
+		 */
+		OutboundStatistics m_outboundStatistics;
+		/**
+		 * The amount of bytes that may be queued for a single client
+		 */
+		std::size_t m_maxQueuedBytes = OutboundQueue::DEFAULT_MAX_QUEUED_BYTES;
+		/**
+		 * What happens if a message doesn't fit into a client's outbound queue
+		 */
+		OverflowPolicy m_overflowPolicy = OverflowPolicy::DROP;
+		/**
+		 * Counters about the received messages
+		 */
+		InboundStatistics m_inboundStatistics;
+		/**
+		 * The limits applied to received messages
+		 */
+		InboundLimits m_inboundLimits;
+		/**
+		 * A received message on its way to being parsed
+		 */
+		struct ParseJob {
+			/**
+			 * The position of the message among all received messages
+			 */
+			std::uint64_t sequence = 0;
+			/**
+			 * The ID of the client whose connection the message has been received from or INVALID_CLIENT_ID
+			 */
+			client_id_t connectedClient = INVALID_CLIENT_ID;
+			/**
+			 * The (unparsed) message. It is copied into a buffer taken from the BufferPool, which is given back once
+			 * the message has been parsed.
+			 */
+			std::string content;
+			/**
+			 * The encoding of the message
+			 */
+			Encoding encoding = Encoding::JSON;
+		};
+		/**
+		 * A parsed message waiting for all messages received before it to be processed
+		 */
+		struct ParsedMessage {
+			/**
+			 * The ID of the client whose connection the message has been received from or INVALID_CLIENT_ID
+			 */
+			client_id_t connectedClient = INVALID_CLIENT_ID;
+			/**
+			 * The parsed message. This is discarded if it is null (and there is no apiCall).
+			 */
+			nlohmann::json message;
+			/**
+			 * The API-call request, if the message could be read without building a JSON DOM for it
+			 */
+			std::optional< Messages::APICallRequest > apiCall;
+		};
+		/**
+		 * A request of a client on its way to being executed
+		 */
+		struct ExecutionJob {
+			/**
+			 * The ID of the client that has sent the request
+			 */
+			client_id_t client = INVALID_CLIENT_ID;
+			/**
+			 * The task producing the response
+			 */
+			std::function< nlohmann::json() > task;
+			/**
+			 * Used instead of task for responses that are written straight into their serialized form. It writes the
+			 * response_type and response fields of the response.
+			 */
+			std::function< void(ResponseWriter &) > write;
+			/**
+			 * Used instead of task and write for API calls whose parameter has been read already. Unlike a task, this
+			 * doesn't need any memory to be allocated for the call.
+			 */
+			const Messages::APIFunction *function = nullptr;
+			/**
+			 * The parameter to call function with
+			 */
+			Messages::APIParameter parameter;
+			/**
+			 * The request ID to echo in the response (may be null)
+			 */
+			nlohmann::json requestID;
+			/**
+			 * The encoding the response has to be sent in
+			 */
+			Encoding encoding = Encoding::JSON;
+		};
+		/**
+		 * A response on its way to being serialized
+		 */
+		struct SerializationJob {
+			/**
+			 * The ID of the client the response is meant for
+			 */
+			client_id_t client = INVALID_CLIENT_ID;
+			/**
+			 * The response
+			 */
+			nlohmann::json response;
+			/**
+			 * The already serialized response (as JSON text). If this is not empty, it is used instead of response.
+			 */
+			std::string message;
+			/**
+			 * The encoding the response has to be sent in
+			 */
+			Encoding encoding = Encoding::JSON;
+		};
+
+		/**
+		 * The amount of threads used by the pipeline's stages
+		 */
+		PipelineConfig m_pipelineConfig;
+		/**
+		 * The threads parsing received messages
+		 */
+		WorkerGroup< ParseJob > m_parseWorkers;
+		/**
+		 * The threads executing requests. Jobs are assigned based on the client's ID.
+		 */
+		WorkerGroup< ExecutionJob > m_executionWorkers;
+		/**
+		 * The threads serializing responses. Jobs are assigned based on the client's ID.
+		 */
+		WorkerGroup< SerializationJob > m_serializationWorkers;
+		/**
+		 * The sequence number assigned to the next received message. This must not be accessed outside of
+		 * m_workerThread.
+		 */
+		std::uint64_t m_nextParseSequence = 0;
+		/**
+		 * The sequence number of the next message to be processed. This must not be accessed outside of
+		 * m_workerThread.
+		 */
+		std::uint64_t m_nextParsedSequence = 0;
+		/**
+		 * Parsed messages that have overtaken messages received before them. This must not be accessed outside of
+		 * m_workerThread.
+		 */
+		std::map< std::uint64_t, ParsedMessage > m_parsedMessages;
+		/**
+		 * The mutex guarding m_handedOverParsed
+		 */
+		std::mutex m_parsedMutex;
+		/**
+		 * The messages (along with their sequence numbers) that have been parsed but haven't been processed yet. They
+		 * are processed by a single posted task, so that handing over a parsed message doesn't allocate a task of its
+		 * own.
+		 */
+		std::vector< std::pair< std::uint64_t, ParsedMessage > > m_handedOverParsed;
+		/**
+		 * The parsed messages that are currently being processed. This is swapped with m_handedOverParsed, so that the
+		 * storage of both vectors is reused. This must not be accessed outside of m_workerThread.
+		 */
+		std::vector< std::pair< std::uint64_t, ParsedMessage > > m_processingParsed;
+		/**
+		 * The clients whose connections aren't read from until the jobs held back by the pipeline's stages have been
+		 * handed over. This must not be accessed outside of m_workerThread.
+		 */
+		std::vector< client_id_t > m_pausedClients;
+		/**
+		 * Whether the listeners aren't read from until the jobs held back by the pipeline's stages have been handed
+		 * over. This must not be accessed outside of m_workerThread.
+		 */
+		bool m_listenersPaused = false;
+		/**
+		 * The mutex guarding m_handedOver
+		 */
+		std::mutex m_handOverMutex;
+		/**
+		 * The responses that have been handed over to m_workerThread but haven't been delivered yet. They are
+		 * delivered by a single posted task, so that handing over a response doesn't allocate a task of its own.
+		 */
+		std::vector< std::pair< client_id_t, std::string > > m_handedOver;
+		/**
+		 * The responses that are currently being delivered. This is swapped with m_handedOver, so that the storage of
+		 * both vectors is reused. This must not be accessed outside of m_workerThread.
+		 */
+		std::vector< std::pair< client_id_t, std::string > > m_delivering;
 		/**
 		 * A map of currently registered clients
 		 */
@@ -53,10 +404,53 @@ namespace JsonBridge {
 		 * The bridge's secret used to identify itself when talking to clients
 		 */
 		std::string m_secret;
+		/**
+		 * The serialized secret field (including the trailing comma) written into every response by a ResponseWriter.
+		 * Like m_secret, this doesn't change while the pipeline is running.
+		 */
+		std::string m_secretField;
 		/**
 		 * A **reference** to the MumbleAPI. API-call requests will be forwarded to and processed by it.
 		 */
 		const MumbleAPI &m_api;
+		/**
+		 * The model of the servers' users and channels that read-only API calls are answered from
+		 */
+		ServerState m_serverState;
+		/**
+		 * The union of the topics the clients have subscribed to (as bits indexed by the topics' numeric values). It
+		 * is read by publish() in order to not bother m_workerThread with events nobody is interested in, but must
+		 * not be written outside of m_workerThread.
+		 */
+		std::atomic< unsigned long > m_subscribedTopics = std::atomic< unsigned long >(0);
+		/**
+		 * The settings for pushed events
+		 */
+		EventConfig m_eventConfig;
+		/**
+		 * Counters about the pushed talking-state changes
+		 */
+		TalkingStateStatistics m_talkingStateStatistics;
+		/**
+		 * Records the talking-state changes published from within the plugin callbacks until they are collected by
+		 * m_workerThread
+		 */
+		TalkingStateRecorder m_talkingStateRecorder;
+		/**
+		 * The talking-state changes waiting to be sent to each client that has subscribed to them. This must not be
+		 * accessed outside of m_workerThread.
+		 */
+		std::unordered_map< client_id_t, TalkingStateCoalescer > m_talkingStateSubscribers;
+		/**
+		 * The timer collecting the recorded talking-state changes, if it is running. This must not be accessed outside
+		 * of m_workerThread.
+		 */
+		std::optional< EventLoop::timer_id_t > m_talkingStateTimer;
+		/**
+		 * The buffer the recorded talking-state changes are collected into. This must not be accessed outside of
+		 * m_workerThread.
+		 */
+		std::vector< TalkingStateChange > m_collectedTalkingStates;
 
 		/**
 		 * A continuous counter for assigning unique IDs to new clients. This variable must not be accessed
@@ -72,31 +466,373 @@ namespace JsonBridge {
 		 * @see Mumble::JsonBridge::Bridge::m_workerThread
 		 */
 		void doStart();
+		/**
+		 * Starts the worker threads of the pipeline according to m_pipelineConfig
+		 */
+		void startPipeline();
+		/**
+		 * Stops the worker threads of the pipeline once they have finished their current jobs. Jobs that are held
+		 * back are discarded.
+		 */
+		void stopPipeline();
+		/**
+		 * @returns Whether any of the pipeline's stages holds back jobs, as the queues of its workers are full. No
+		 * further messages are received until the jobs have been handed over.
+		 */
+		[[nodiscard]] bool isBacklogged() const noexcept;
+		/**
+		 * Stops receiving messages from the given client until the jobs held back by the pipeline's stages have been
+		 * handed over
+		 *
+		 * @param id The ID of the client
+		 */
+		void pauseClient(client_id_t id);
+		/**
+		 * Stops receiving messages via the listeners until the jobs held back by the pipeline's stages have been
+		 * handed over
+		 */
+		void pauseListeners();
+		/**
+		 * Hands the jobs held back by the pipeline's stages over to their workers for as long as there is room. Once
+		 * all of them have been handed over, the clients and listeners that have been paused are read from again.
+		 * This is called whenever a worker has made room in its queue.
+		 */
+		void drainBacklogs();
+		/**
+		 * Receives messages from the clients and listeners that have been paused again
+		 */
+		void resumeReceiving();
+		/**
+		 * Starts the given listener, making it hand over new connections and received messages to this Bridge
+		 *
+		 * @param listener The listener to start
+		 */
+		void startListener(Transports::Listener &listener);
+		/**
+		 * Called by a listener whenever a client has connected. Every connection becomes a new client.
+		 *
+		 * @param connection The connection to the client
+		 */
+		void onConnection(std::unique_ptr< Transports::Connection > connection);
+		/**
+		 * Registers the connection of the given client with m_loop
+		 *
+		 * @param id The ID of the client
+		 */
+		void watchClient(client_id_t id);
+		/**
+		 * Called by m_loop whenever the connection of the given client might have received messages
+		 *
+		 * @param id The ID of the client
+		 */
+		void onClientReadable(client_id_t id);
+#ifdef PLATFORM_UNIX
+		/**
+		 * Used to handle a registration message of a connected client that requests to exchange all further messages
+		 * through shared memory. The channel's handles are passed to the client along with the registration response.
+		 *
+		 * @param id The ID of the client
+		 * @param msg The registration message
+		 * @param requestID The request ID to echo in the response (may be null)
+		 */
+		void handleSharedMemoryRegistration(client_id_t id, const Messages::Registration &msg,
+											const nlohmann::json &requestID);
+#endif
+		/**
+		 * Used to handle a registration message of a connected client that keeps using its connection. Such a
+		 * registration only serves to switch the encoding of all further messages.
+		 *
+		 * @param id The ID of the client
+		 * @param msg The registration message
+		 * @param requestID The request ID to echo in the response (may be null)
+		 */
+		void handleSocketRegistration(client_id_t id, const Messages::Registration &msg,
+									  const nlohmann::json &requestID);
+		/**
+		 * Parses and processes the given messages that have been received by a listener (e.g. via the named pipe) in
+		 * the order in which they are given
+		 *
+		 * @param messages The (unparsed) messages
+		 */
+		void processMessages(const std::vector< std::string_view > &messages);
+		/**
+		 * Parses and processes the given message
+		 *
+		 * @param content The (unparsed) message
+		 * @param connectedClient The ID of the client whose connection the message has been received from or
+		 * INVALID_CLIENT_ID if it has been received by a listener
+		 */
+		void processReceived(std::string_view content, client_id_t connectedClient);
+		/**
+		 * Decides whether the given message is going to be parsed. This only looks at the message's size and, for
+		 * messages that haven't been received from a connection, at its envelope (which must identify a registered
+		 * client and carry its secret, unless the message is a registration). Discarded messages are counted in
+		 * m_inboundStatistics.
+		 *
+		 * @param content The (unparsed) message
+		 * @param connectedClient The ID of the client whose connection the message has been received from or
+		 * INVALID_CLIENT_ID
+		 * @returns Whether the message should be parsed
+		 */
+		bool admit(std::string_view content, client_id_t connectedClient);
+		/**
+		 * Counts a message that has been discarded for exceeding the maximum message size and reports the problem to
+		 * its sender, if the sender can be told from the message's envelope (or its connection)
+		 *
+		 * @param envelope The (beginning of the) message or the envelope captured from it (see DiscardedFrame)
+		 * @param connectedClient The ID of the client whose connection the message has been received from or
+		 * INVALID_CLIENT_ID
+		 */
+		void rejectOversized(std::string_view envelope, client_id_t connectedClient);
+		/**
+		 * Parses the given message. This is called from within the parse threads.
+		 *
+		 * @param job The message to parse
+		 */
+		void parse(ParseJob &job);
+		/**
+		 * Called whenever a message has been parsed. Messages are processed in the order in which they have been
+		 * received, so the message might have to wait for the ones received before it.
+		 *
+		 * @param sequence The sequence number of the message
+		 * @param parsed The parsed message
+		 */
+		void onParsed(std::uint64_t sequence, ParsedMessage parsed);
+		/**
+		 * Processes all messages that have been handed over by the parse threads
+		 */
+		void processHandedOverParsed();
+		/**
+		 * Processes the given parsed message, which is next in line
+		 *
+		 * @param parsed The parsed message
+		 */
+		void processParsed(ParsedMessage &parsed);
+		/**
+		 * Counts a message that has been discarded because processing it failed in an unexpected way. This may be
+		 * called from any thread.
+		 *
+		 * @param e The exception that processing the message has failed with
+		 */
+		void reportMalformed(const std::exception &e);
 		/**
 		 * Method used to process received messages
 		 *
 		 * @msg The JSON representation of the respective message
+		 * @param connectedClient The ID of the client whose connection the message has been received from or
+		 * INVALID_CLIENT_ID if it has been received by a listener (e.g. via the named pipe). Messages received from a
+		 * connection don't need to identify their sender.
+		 */
+		void processMessage(const nlohmann::json &msg, client_id_t connectedClient = INVALID_CLIENT_ID);
+		/**
+		 * Reads the given message, if it is an API-call request that can be read without building a JSON DOM for it
+		 *
+		 * @param content The (unparsed) message
+		 * @param connectedClient The ID of the client whose connection the message has been received from or
+		 * INVALID_CLIENT_ID
+		 * @param encoding The encoding of the message
+		 * @returns The read request or std::nullopt if the message has to be parsed regularly
+		 */
+		std::optional< Messages::APICallRequest > readAPICall(std::string_view content, client_id_t connectedClient,
+															  Encoding encoding) const;
+		/**
+		 * Method used to process API-call requests that have been read by readAPICall()
+		 *
+		 * @param request The request to process
+		 * @param connectedClient The ID of the client whose connection the message has been received from or
+		 * INVALID_CLIENT_ID
+		 */
+		void processAPICall(Messages::APICallRequest &request, client_id_t connectedClient = INVALID_CLIENT_ID);
+		/**
+		 * Verifies that the given client exists and that the given secret is the client's secret. Throws an
+		 * InvalidMessageException otherwise.
+		 *
+		 * @param id The ID of the client
+		 * @param secret The secret the client has used
+		 */
+		void authenticate(client_id_t id, const std::string &secret) const;
+		/**
+		 * Sends an error to the given client. If there is no such client, the error is only counted.
+		 *
+		 * @param id The ID of the client
+		 * @param message The error message
+		 * @param requestID The request ID to echo in the response (may be null)
 		 */
-		void processMessage(const nlohmann::json &msg);
+		void reportError(client_id_t id, const std::string &message, const nlohmann::json &requestID);
 
 		/**
 		 * Used to handle registration messages.
 		 *
 		 * @param msg The message to process
+		 * @param requestID The request ID to echo in the response (may be null)
 		 */
-		void handleRegistration(const Messages::Registration &msg);
+		void handleRegistration(const Messages::Registration &msg, const nlohmann::json &requestID);
 		/**
 		 * Used to handle API-call request messages.
 		 *
+		 * @param id The ID of the client that has sent the message
 		 * @param msg The message to process
+		 * @param requestID The request ID to echo in the response (may be null)
 		 */
-		void handleAPICall(const BridgeClient &client, const Messages::APICall &msg) const;
+		void handleAPICall(client_id_t id, const nlohmann::json &msg, const nlohmann::json &requestID);
+		/**
+		 * Used to handle batch messages (multiple API calls answered by a single response).
+		 *
+		 * @param id The ID of the client that has sent the message
+		 * @param msg The message to process
+		 * @param requestID The request ID to echo in the response (may be null)
+		 */
+		void handleBatch(client_id_t id, const nlohmann::json &msg, const nlohmann::json &requestID);
 		/**
 		 * Used to handle disconnect messages
 		 *
-		 * @param msg The JSON representation of the message to process
+		 * @param id The ID of the client that wants to disconnect
+		 * @param requestID The request ID to echo in the response (may be null)
+		 */
+		void handleDisconnect(client_id_t id, const nlohmann::json &requestID);
+		/**
+		 * Used to handle subscribe and unsubscribe messages
+		 *
+		 * @param id The ID of the client that has sent the message
+		 * @param msg The message to process
+		 * @param requestID The request ID to echo in the response (may be null)
+		 */
+		void handleSubscription(client_id_t id, const Messages::Subscription &msg, const nlohmann::json &requestID);
+		/**
+		 * Recomputes m_subscribedTopics from the subscriptions of all clients and starts or stops collecting the
+		 * recorded talking-state changes accordingly
+		 */
+		void updateSubscribedTopics();
+		/**
+		 * Pushes the given event to all clients that have subscribed to its topic
+		 *
+		 * @param event The event to push
+		 */
+		void dispatch(const Event &event);
+		/**
+		 * Collects the recorded talking-state changes, hands them to the subscribers' coalescers and sends the frames
+		 * that are due. This is run by a timer while anybody has subscribed to talking-state changes.
+		 */
+		void collectTalkingStates();
+		/**
+		 * Sends a message that has been written as JSON text to the given clients, transcoding it for the ones that
+		 * have negotiated a binary encoding. Clients that don't exist (anymore) are skipped.
+		 *
+		 * @param recipients The IDs of the clients to send the message to
+		 * @param message The message to send
 		 */
-		void handleDisconnect(const nlohmann::json &msg);
+		void sendWritten(const std::vector< client_id_t > &recipients, const std::string &message);
+
+		/**
+		 * Hands the given task over to the execution threads. Its response is sent to the given client once all
+		 * responses to the client's previous requests have been sent.
+		 *
+		 * @param id The ID of the client
+		 * @param task The task producing the response. If it throws an InvalidMessageException, an error is sent
+		 * instead.
+		 * @param requestID The request ID to echo in the response (may be null)
+		 */
+		void submit(client_id_t id, std::function< nlohmann::json() > task, nlohmann::json requestID);
+		/**
+		 * Hands the given task over to the execution threads. The task writes the response straight into its
+		 * serialized form, which is sent to the given client once all responses to the client's previous requests
+		 * have been sent.
+		 *
+		 * @param id The ID of the client
+		 * @param write The task writing the response_type and response fields of the response. If it throws an
+		 * InvalidMessageException, an error is sent instead.
+		 * @param requestID The request ID to echo in the response (may be null)
+		 */
+		void submit(client_id_t id, std::function< void(ResponseWriter &) > write, nlohmann::json requestID);
+		/**
+		 * Hands the given API call over to the execution threads. Its response is written straight into its serialized
+		 * form, which is sent to the given client once all responses to the client's previous requests have been sent.
+		 *
+		 * @param id The ID of the client
+		 * @param function The API function to call
+		 * @param parameter The (validated) parameter to call the function with
+		 * @param requestID The request ID to echo in the response (may be null)
+		 */
+		void submit(client_id_t id, const Messages::APIFunction &function, Messages::APIParameter parameter,
+					nlohmann::json requestID);
+		/**
+		 * Hands the given job over to the execution threads
+		 *
+		 * @param job The job (with all members set but the encoding)
+		 */
+		void submit(ExecutionJob job);
+		/**
+		 * Executes the given job. This is called from within the execution threads.
+		 *
+		 * @param job The job to execute
+		 */
+		void execute(ExecutionJob &job);
+		/**
+		 * Writes the response of the given job (which has to use ExecutionJob::write or ExecutionJob::function)
+		 *
+		 * @param job The job to execute
+		 * @returns The serialized response (written into a buffer taken from the BufferPool)
+		 */
+		std::string writeResponse(ExecutionJob &job) const;
+		/**
+		 * Serializes the given response and hands it over to m_loop for sending. This is called from within the
+		 * serialization threads (or the execution threads if there are none).
+		 *
+		 * @param job The response to serialize
+		 */
+		void serialize(SerializationJob &job);
+		/**
+		 * Hands the given serialized response over to m_loop for sending
+		 *
+		 * @param id The ID of the client the response is meant for
+		 * @param message The serialized response
+		 */
+		void handOver(client_id_t id, std::string message);
+		/**
+		 * Delivers all responses that have been handed over from other threads
+		 */
+		void deliverHandedOver();
+		/**
+		 * Sends a serialized response that has left the pipeline
+		 *
+		 * @param id The ID of the client the response is meant for
+		 * @param message The serialized response
+		 */
+		void deliver(client_id_t id, std::string message);
+		/**
+		 * @param message The error message
+		 * @returns An error response with the given message
+		 */
+		nlohmann::json createErrorResponse(const std::string &message) const;
+
+		/**
+		 * Queues the given message for the given client and writes as much of the client's queue as possible without
+		 * blocking. If the message doesn't fit into the queue, the configured OverflowPolicy is applied.
+		 *
+		 * @param id The ID of the client to send the message to
+		 * @param message The (unframed) message to send
+		 */
+		void send(client_id_t id, std::string message);
+		/**
+		 * Encodes the given message in the encoding the given client has negotiated and sends it like send()
+		 *
+		 * @param id The ID of the client to send the message to
+		 * @param message The message to send
+		 */
+		void send(client_id_t id, const nlohmann::json &message);
+		/**
+		 * Writes as much of the given client's outbound queue as possible without blocking. If not everything could be
+		 * written, the remainder is written once the client's connection becomes writable again.
+		 *
+		 * @param id The ID of the client
+		 */
+		void flushClient(client_id_t id);
+		/**
+		 * Removes the given client (and all of its queued messages)
+		 *
+		 * @param id The ID of the client
+		 */
+		void removeClient(client_id_t id);
 
 	public:
 		/**
@@ -104,6 +840,15 @@ namespace JsonBridge {
 		 * the Bridge has not started (yet).
 		 */
 		static const std::filesystem::path s_pipePath;
+#ifdef PLATFORM_UNIX
+		/**
+		 * The default address of the (SOCK_SEQPACKET) socket clients may connect to instead of using named pipes. This
+		 * is only available on Unix.
+		 *
+		 * @see Mumble::JsonBridge::Transports::SocketListener
+		 */
+		static const std::string s_socketAddress;
+#endif
 
 		/**
 		 * Creates a new instance of this Bridge
@@ -119,12 +864,117 @@ namespace JsonBridge {
 		 */
 		void start();
 		/**
-		 * Stops the bridge.
+		 * Stops the bridge. The worker thread is woken up immediately.
 		 *
 		 * @param join Whether this function should wait on the worker-thread to terminate. Otherwise this function will
 		 * return immediately.
 		 */
 		void stop(bool join);
+
+		/**
+		 * Hands the given task over to the Bridge's worker thread, which will execute it as soon as possible. If the
+		 * Bridge is not running right now, the task is executed once it has been started.
+		 *
+		 * @param task The task to execute
+		 *
+		 * @note This function is thread-safe
+		 */
+		void post(EventLoop::task_t task);
+
+		/**
+		 * Sets the limit for the amount of bytes that may be queued for a single client that doesn't keep up with
+		 * reading its messages. This only affects clients that register after this call.
+		 *
+		 * @param maxQueuedBytes The amount of bytes that may be queued per client
+		 * @param policy What happens if a message doesn't fit into a client's queue
+		 *
+		 * @note This function must not be called while the Bridge is running
+		 */
+		void setOutboundQueueLimit(std::size_t maxQueuedBytes, OverflowPolicy policy);
+		/**
+		 * @returns Counters aggregated over the outbound queues of all clients. The counters can be read from any
+		 * thread.
+		 */
+		const OutboundStatistics &getOutboundStatistics() const noexcept;
+
+		/**
+		 * Sets the limits for the messages the Bridge receives
+		 *
+		 * @param limits The limits to apply
+		 *
+		 * @note This function must not be called while the Bridge is running
+		 */
+		void setInboundLimits(const InboundLimits &limits);
+		/**
+		 * @returns Counters about the messages the Bridge has received. The counters can be read from any thread.
+		 */
+		const InboundStatistics &getInboundStatistics() const noexcept;
+
+		/**
+		 * @returns The model of the servers' users and channels. Its callbacks have to be invoked by the plugin in
+		 * order for it to be of any use.
+		 */
+		ServerState &getServerState() noexcept;
+
+		/**
+		 * Pushes the given event to all clients that have subscribed to its topic. Events are pushed as soon as they
+		 * have been published, so they don't wait for the responses to requests that are still being processed. If
+		 * no client has subscribed to the event's topic, this returns right away.
+		 *
+		 * Talking-state changes are merely recorded (without waiting for anything) and are pushed in coalesced frames
+		 * (see EventConfig).
+		 *
+		 * @param event The event to push
+		 *
+		 * @note This function is thread-safe and meant to be called from within the plugin callbacks
+		 */
+		void publish(const Event &event) noexcept;
+
+		/**
+		 * Sets the settings for pushed events. The talking-state window and rate only affect clients that subscribe
+		 * after this call.
+		 *
+		 * @param config The settings to use
+		 *
+		 * @note This function must not be called while the Bridge is running
+		 */
+		void setEventConfig(const EventConfig &config);
+		/**
+		 * @returns Counters about the pushed talking-state changes. The counters can be read from any thread.
+		 */
+		const TalkingStateStatistics &getTalkingStateStatistics() const noexcept;
+
+		/**
+		 * Sets the amount of threads used by the stages of the Bridge's message pipeline
+		 *
+		 * @param config The configuration to use
+		 *
+		 * @note This function must not be called while the Bridge is running
+		 */
+		void setPipelineConfig(const PipelineConfig &config);
+
+		/**
+		 * Adds a listener that is offered to clients in addition to the built-in ones (the named pipe and, on Unix,
+		 * the socket). Failing to start it doesn't prevent the Bridge from starting.
+		 *
+		 * @param listener The listener to add
+		 *
+		 * @note This function must not be called while the Bridge is running
+		 */
+		void addListener(std::unique_ptr< Transports::Listener > listener);
+
+#ifdef PLATFORM_UNIX
+		/**
+		 * Sets the address of the socket clients may connect to instead of using named pipes. This function is only
+		 * available on Unix.
+		 *
+		 * @param address The address of the socket (see Transports::SocketListener) or an empty string in order to not
+		 * offer a socket at all
+		 *
+		 * @note This function must not be called while the Bridge is running
+		 */
+		void setSocketAddress(const std::string &address);
+#endif
 	};
 
 }; // namespace JsonBridge
@@ -6,11 +6,17 @@
 #ifndef MUMBLE_JSONBRIDGE_BRIDGECLIENT_H_
 #define MUMBLE_JSONBRIDGE_BRIDGECLIENT_H_
 
+#include "mumble/json_bridge/Encoding.h"
+#include "mumble/json_bridge/Event.h"
+#include "mumble/json_bridge/Framing.h"
 #include "mumble/json_bridge/NonCopyable.h"
+#include "mumble/json_bridge/OutboundQueue.h"
+#include "mumble/json_bridge/transports/Transport.h"
 
-#include <filesystem>
 #include <limits>
+#include <memory>
 #include <string>
+#include <string_view>
 
 namespace Mumble {
 namespace JsonBridge {
@@ -28,7 +34,8 @@ namespace JsonBridge {
 
 	/**
 	 * This class represents a client that is currently connected to the Bridge. In particular it wraps functionality
-	 * like verifying a client's secret and writing messages to it.
+	 * like verifying a client's secret and writing messages to it. Messages are not written directly but are put into
+	 * a bounded outbound queue first, which is then flushed without blocking.
 	 *
 	 * @see Mumble::JsonBridge::Bridge
 	 */
@@ -39,9 +46,31 @@ namespace JsonBridge {
 		 */
 		client_id_t m_id = INVALID_CLIENT_ID;
 		/**
-		 * The path to the client's named pipe. This is where messages are being written to.
+		 * The connection to the client. This is where messages are being written to.
 		 */
-		std::filesystem::path m_pipePath;
+		std::unique_ptr< Transports::Connection > m_connection;
+		/**
+		 * Whether the client has a connection of its own that identifies it (instead of having registered via the
+		 * Bridge's named pipe)
+		 */
+		bool m_dedicatedConnection = false;
+		/**
+		 * The messages waiting to be written to the client
+		 */
+		OutboundQueue m_outbound;
+		/**
+		 * Whether the client has been notified about a message that had to be dropped since the last time its
+		 * outbound queue was empty
+		 */
+		bool m_overflowNotified = false;
+		/**
+		 * Whether the client is about to be removed (as soon as its remaining messages have been written)
+		 */
+		bool m_closing = false;
+		/**
+		 * The amount of requests of this client that are still being processed by the Bridge's pipeline
+		 */
+		std::size_t m_requestsInFlight = 0;
 		/**
 		 * The client's secret that it provided during registration. If a message is received claiming to
 		 * to come from this client it has to be verified that the provided secret matches this one. Otherwise
@@ -50,41 +79,187 @@ namespace JsonBridge {
 		 * @see Mumble::JsonBridge::BridgeClient::secretMatches()
 		 */
 		std::string m_secret;
+		/**
+		 * The framing that is applied to all messages written to this client
+		 */
+		Framing m_framing = Framing::NONE;
+		/**
+		 * The encoding of all messages exchanged with this client
+		 */
+		Encoding m_encoding = Encoding::JSON;
+		/**
+		 * The topics of the events that are pushed to this client
+		 */
+		EventTopics m_subscriptions;
 
 	public:
+		/**
+		 * The possible outcomes of flushing a client's outbound queue
+		 */
+		enum class FlushResult {
+			/**
+			 * All queued messages have been written
+			 */
+			DONE,
+			/**
+			 * The client's connection is full. Flushing should be resumed once it becomes writable.
+			 */
+			WOULD_BLOCK,
+			/**
+			 * The client currently isn't reading from its connection. Flushing should be retried later on.
+			 */
+			NO_READER,
+			/**
+			 * The client has closed its connection. It should be removed.
+			 */
+			DISCONNECTED
+		};
+
 		/**
 		 * Creates an **invalid** instance
 		 */
 		explicit BridgeClient() = default;
 		/**
-		 * Creates an instance of a client with the specified data.
+		 * Creates an instance of a client that has registered via the Bridge's named pipe
 		 *
-		 * @param path The path to the client's named pipe
+		 * @param connection The connection to the client
 		 * @param secret The secret the client has provided (used for identity verification)
 		 * @param id The ID that is assigned to this client. If not given, the ID of this client is set to be invalid.
+		 * @param framing The framing to apply to messages written to this client
+		 * @param maxQueuedBytes The amount of bytes that may be waiting to be written to this client at once
+		 * @param statistics The statistics this client's outbound queue shall contribute to (may be nullptr). The
+		 * object must outlive this client.
 		 */
-		explicit BridgeClient(const std::filesystem::path &pipePath, const std::string &secret,
-							  client_id_t id = INVALID_CLIENT_ID);
+		explicit BridgeClient(std::unique_ptr< Transports::Connection > connection, const std::string &secret,
+							  client_id_t id = INVALID_CLIENT_ID, Framing framing = Framing::NONE,
+							  std::size_t maxQueuedBytes        = OutboundQueue::DEFAULT_MAX_QUEUED_BYTES,
+							  OutboundStatistics *statistics = nullptr);
+		/**
+		 * Creates an instance of a client that has a connection of its own. As the connection itself identifies the
+		 * client, no secret is needed.
+		 *
+		 * @param connection The connection to the client
+		 * @param id The ID that is assigned to this client
+		 * @param maxQueuedBytes The amount of bytes that may be waiting to be written to this client at once
+		 * @param statistics The statistics this client's outbound queue shall contribute to (may be nullptr). The
+		 * object must outlive this client.
+		 */
+		explicit BridgeClient(std::unique_ptr< Transports::Connection > connection, client_id_t id,
+							  std::size_t maxQueuedBytes        = OutboundQueue::DEFAULT_MAX_QUEUED_BYTES,
+							  OutboundStatistics *statistics = nullptr);
 		~BridgeClient();
 
 		BridgeClient(BridgeClient &&) = default;
 		BridgeClient &operator=(BridgeClient &&) = default;
 
 		/**
-		 * Writes the given message to this client's named pipe
+		 * Appends the given message to this client's outbound queue, if it fits
 		 *
-		 * @param message The message to write
+		 * @param message The message to append
+		 * @returns Whether the message has been appended. If not, it has been dropped.
 		 */
-		void write(const std::string &message) const;
+		[[nodiscard]] bool enqueue(std::string message);
+		/**
+		 * Notifies the client that a message had to be dropped because its outbound queue is full. This is done only
+		 * once until the queue has been flushed completely.
+		 *
+		 * @param notification The (small) notification message. It is appended to the queue regardless of its limit.
+		 */
+		void notifyOverflow(const std::string &notification);
+		/**
+		 * Writes as many queued messages to this client's connection as possible without blocking
+		 *
+		 * @returns The outcome of the operation
+		 */
+		FlushResult flush();
+
+		/**
+		 * @returns This client's outbound queue
+		 */
+		[[nodiscard]] const OutboundQueue &getOutboundQueue() const noexcept;
+		/**
+		 * @returns This client's outbound queue
+		 */
+		[[nodiscard]] OutboundQueue &getOutboundQueue() noexcept;
+
+		/**
+		 * @returns The connection to this client
+		 */
+		[[nodiscard]] Transports::Connection &getConnection() noexcept;
+		/**
+		 * Replaces the connection to this client
+		 *
+		 * @param connection The new connection
+		 * @returns The previous connection
+		 */
+		std::unique_ptr< Transports::Connection >
+			replaceConnection(std::unique_ptr< Transports::Connection > connection);
+		/**
+		 * @returns Whether this client has a connection of its own that identifies it (instead of having registered
+		 * via the Bridge's named pipe)
+		 */
+		[[nodiscard]] bool hasDedicatedConnection() const noexcept;
+
+		/**
+		 * Marks this client as being about to be removed
+		 */
+		void markClosing() noexcept;
+		/**
+		 * @returns Whether this client is about to be removed
+		 */
+		[[nodiscard]] bool isClosing() const noexcept;
+
+		/**
+		 * Notes that a request of this client has been handed to the Bridge's pipeline
+		 */
+		void beginRequest() noexcept;
+		/**
+		 * Notes that the response to one of this client's requests has left the Bridge's pipeline
+		 */
+		void endRequest() noexcept;
+		/**
+		 * Forgets about all requests that are still being processed (used if the pipeline has been shut down)
+		 */
+		void clearRequests() noexcept;
+		/**
+		 * @returns Whether responses to requests of this client are still to be expected from the Bridge's pipeline
+		 */
+		[[nodiscard]] bool hasRequestsInFlight() const noexcept;
 
 		/**
 		 * @returns The ID of this client
 		 */
 		client_id_t getID() const noexcept;
 		/**
-		 * @returns The path to this client's named pipe
+		 * @returns The framing used for messages written to this client
+		 */
+		Framing getFraming() const noexcept;
+		/**
+		 * @returns The encoding of the messages exchanged with this client
 		 */
-		const std::filesystem::path &getPipePath() const noexcept;
+		Encoding getEncoding() const noexcept;
+		/**
+		 * Changes the encoding of the messages exchanged with this client. Messages that are queued already are not
+		 * affected.
+		 *
+		 * @param encoding The new encoding
+		 */
+		void setEncoding(Encoding encoding) noexcept;
+
+		/**
+		 * @returns The topics of the events that are pushed to this client
+		 */
+		const EventTopics &getSubscriptions() const noexcept;
+		/**
+		 * Changes the topics of the events that are pushed to this client
+		 *
+		 * @param topics The new topics
+		 */
+		void setSubscriptions(const EventTopics &topics) noexcept;
+		/**
+		 * @returns Whether events of the given topic are pushed to this client
+		 */
+		bool isSubscribed(EventTopic topic) const noexcept;
 
 		/**
 		 * Checks whether the provided secret matches with the one provided by this client.
@@ -92,12 +267,13 @@ namespace JsonBridge {
 		 * @param secret The secret to verify
 		 * @returns Whether the provided secret matches
 		 */
-		bool secretMatches(const std::string &secret) const noexcept;
+		bool secretMatches(std::string_view secret) const noexcept;
 
 		/**
 		 * @returns Whether this client is currently in a valid state
 		 */
 		operator bool() const noexcept;
+
 	};
 
 }; // namespace JsonBridge
@@ -0,0 +1,89 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+#ifndef MUMBLE_JSONBRIDGE_BUFFERPOOL_H_
+#define MUMBLE_JSONBRIDGE_BUFFERPOOL_H_
+
+#include "mumble/json_bridge/NonCopyable.h"
+
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Mumble {
+namespace JsonBridge {
+
+	/**
+	 * A pool of string buffers that outgoing messages are written into. Once a message has been sent, its buffer is
+	 * given back to the pool and keeps its capacity, so that writing the next message of a similar size doesn't
+	 * involve the global allocator. Buffers are usually taken by one thread and given back by another, which is why
+	 * this class is thread-safe.
+	 */
+	class BufferPool : NonCopyable {
+	private:
+		/**
+		 * Guards m_buffers
+		 */
+		std::mutex m_mutex;
+		/**
+		 * The buffers that are ready to be taken. The vector's capacity is reserved up front.
+		 */
+		std::vector< std::string > m_buffers;
+		/**
+		 * The maximum amount of buffers kept in m_buffers
+		 */
+		std::size_t m_maxBuffers;
+		/**
+		 * The maximum capacity of a buffer that is kept in the pool. Larger buffers are freed when given back, so that
+		 * a single large message doesn't keep its memory around.
+		 */
+		std::size_t m_maxBufferSize;
+
+	public:
+		/**
+		 * The maximum amount of buffers a pool keeps by default
+		 */
+		static constexpr std::size_t DEFAULT_MAX_BUFFERS = 32;
+		/**
+		 * The maximum capacity of a buffer that a pool keeps by default
+		 */
+		static constexpr std::size_t DEFAULT_MAX_BUFFER_SIZE = 16 * 1024;
+
+		/**
+		 * @param maxBuffers The maximum amount of buffers kept in the pool
+		 * @param maxBufferSize The maximum capacity of a buffer kept in the pool
+		 */
+		explicit BufferPool(std::size_t maxBuffers = DEFAULT_MAX_BUFFERS,
+							std::size_t maxBufferSize = DEFAULT_MAX_BUFFER_SIZE);
+
+		/**
+		 * @returns An empty buffer. If the pool has run dry, this is a new buffer without any capacity.
+		 */
+		[[nodiscard]] std::string take();
+		/**
+		 * Gives the given buffer back to the pool. Buffers that are too large or that don't fit into the pool anymore
+		 * are freed instead.
+		 *
+		 * @param buffer The buffer. Its content is discarded.
+		 */
+		void giveBack(std::string buffer) noexcept;
+
+		/**
+		 * @returns The amount of buffers that are ready to be taken
+		 */
+		[[nodiscard]] std::size_t size();
+
+		/**
+		 * @returns The pool shared by all parts of the Bridge writing or sending messages. It is never destroyed, so
+		 * that it is still around while static objects owning buffers are being destroyed.
+		 */
+		static BufferPool &shared();
+	};
+
+}; // namespace JsonBridge
+}; // namespace Mumble
+
+#endif // MUMBLE_JSONBRIDGE_BUFFERPOOL_H_
@@ -0,0 +1,85 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+#ifndef MUMBLE_JSONBRIDGE_ENCODING_H_
+#define MUMBLE_JSONBRIDGE_ENCODING_H_
+
+#include <string>
+#include <string_view>
+
+#include <nlohmann/json.hpp>
+
+namespace Mumble {
+namespace JsonBridge {
+
+	/**
+	 * An enum holding the supported ways of encoding the messages exchanged with a client. All of them represent the
+	 * same JSON data model, so the content of the messages is the same regardless of the encoding.
+	 */
+	enum class Encoding {
+		/**
+		 * JSON text. This is the default.
+		 */
+		JSON,
+		/**
+		 * CBOR (RFC 7049). This is a binary encoding and thus requires a transport that preserves message boundaries.
+		 */
+		CBOR,
+		/**
+		 * MessagePack. This is a binary encoding and thus requires a transport that preserves message boundaries.
+		 */
+		MSGPACK
+	};
+
+	/**
+	 * @return A unique string representation of the given Encoding
+	 *
+	 * @param encoding The encoding to convert to string
+	 */
+	std::string to_string(Encoding encoding);
+	/**
+	 * @return The Encoding corresponding to the provided string representation. If the provided string is not a valid
+	 * representation of an Encoding, this function will throw an std::invalid_argument exception.
+	 *
+	 * @param encoding The encoding's string representation
+	 */
+	Encoding encoding_from_string(const std::string &encoding);
+
+	/**
+	 * @return Whether the given encoding produces binary data (which can't be sent through a named pipe, as the
+	 * framing used on those relies on messages being text)
+	 *
+	 * @param encoding The encoding to check
+	 */
+	bool isBinary(Encoding encoding) noexcept;
+
+	/**
+	 * Encodes the given message
+	 *
+	 * @param message The message to encode
+	 * @param encoding The encoding to use
+	 * @returns The encoded message
+	 */
+	std::string encode(const nlohmann::json &message, Encoding encoding);
+	/**
+	 * Decodes the given message. If the message is not valid in the given encoding, a nlohmann::json::parse_error is
+	 * thrown.
+	 *
+	 * @param message The encoded message
+	 * @param encoding The encoding the message has been encoded with
+	 * @returns The decoded message
+	 */
+	nlohmann::json decode(std::string_view message, Encoding encoding);
+	/**
+	 * @returns The input format to use when SAX-parsing messages of the given encoding
+	 *
+	 * @param encoding The encoding
+	 */
+	nlohmann::json::input_format_t inputFormat(Encoding encoding);
+
+}; // namespace JsonBridge
+}; // namespace Mumble
+
+#endif // MUMBLE_JSONBRIDGE_ENCODING_H_
@@ -0,0 +1,109 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+#ifndef MUMBLE_JSONBRIDGE_EVENT_H_
+#define MUMBLE_JSONBRIDGE_EVENT_H_
+
+#include "mumble/json_bridge/ResponseWriter.h"
+
+#include <mumble/plugin/MumbleAPI.h>
+
+#include <bitset>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace Mumble {
+namespace JsonBridge {
+
+	/**
+	 * An enum holding the kinds of events clients can subscribe to
+	 */
+	enum class EventTopic {
+		TALKING_STATE,
+		CHANNEL_ENTERED,
+		CHANNEL_EXITED,
+		USER_ADDED,
+		USER_REMOVED,
+		SERVER_CONNECTED,
+		SERVER_DISCONNECTED
+	};
+
+	/**
+	 * The amount of values in EventTopic
+	 */
+	constexpr std::size_t EVENT_TOPIC_COUNT = static_cast< std::size_t >(EventTopic::SERVER_DISCONNECTED) + 1;
+
+	/**
+	 * A set of topics, indexed by the topics' numeric values
+	 */
+	using EventTopics = std::bitset< EVENT_TOPIC_COUNT >;
+
+	/**
+	 * @return A unique string representation of the given EventTopic. If no such representation can be found, an
+	 * exception is thrown.
+	 *
+	 * @param topic The topic to convert to string
+	 */
+	std::string to_string(EventTopic topic);
+	/**
+	 * @return The EventTopic corresponding to the provided string representation. If the provided string is not a valid
+	 * representation of an EventTopic, this function will throw an exception.
+	 *
+	 * @param topic The topic's string representation
+	 */
+	EventTopic topic_from_string(const std::string &topic);
+
+	/**
+	 * @returns The string representation of the given talking state ("invalid" for unknown states)
+	 *
+	 * @param state The talking state to convert to string
+	 */
+	std::string_view talkingStateName(mumble_talking_state_t state) noexcept;
+
+	/**
+	 * Something that has happened on one of the servers Mumble is connected to. Events are created from the plugin
+	 * callbacks and pushed to the clients that have subscribed to their topic. Only the fields that belong to the
+	 * event's topic are meaningful.
+	 */
+	struct Event {
+		/**
+		 * What has happened
+		 */
+		EventTopic topic = EventTopic::SERVER_CONNECTED;
+		/**
+		 * The connection to the server the event has happened on
+		 */
+		mumble_connection_t connection = 0;
+		/**
+		 * The user the event is about (not used for the server topics)
+		 */
+		mumble_userid_t userID = 0;
+		/**
+		 * The channel the user has entered or exited (only used for the channel topics)
+		 */
+		mumble_channelid_t channelID = 0;
+		/**
+		 * The channel the user has been in before (only used for EventTopic::CHANNEL_ENTERED). It is negative if the
+		 * user hasn't been in any channel before.
+		 */
+		mumble_channelid_t previousChannelID = -1;
+		/**
+		 * The user's new talking state (only used for EventTopic::TALKING_STATE)
+		 */
+		mumble_talking_state_t talkingState = MUMBLE_TS_INVALID;
+
+		/**
+		 * Writes the response_type and response fields of the message that pushes this event to a client
+		 *
+		 * @param writer The writer to write to
+		 */
+		void write(ResponseWriter &writer) const;
+	};
+
+}; // namespace JsonBridge
+}; // namespace Mumble
+
+#endif // MUMBLE_JSONBRIDGE_EVENT_H_
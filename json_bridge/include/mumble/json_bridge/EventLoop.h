@@ -0,0 +1,251 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+#ifndef MUMBLE_JSONBRIDGE_EVENTLOOP_H_
+#define MUMBLE_JSONBRIDGE_EVENTLOOP_H_
+
+#include "mumble/json_bridge/NonCopyable.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Mumble {
+namespace JsonBridge {
+
+	/**
+	 * A single-threaded event loop. The thread calling run() becomes the loop's thread and executes all callbacks
+	 * registered with the loop. Other threads can hand work over to the loop via post() and make it return via stop().
+	 *
+	 * On Unix the loop is built on top of epoll and uses an eventfd for waking it up, which means that an idle loop
+	 * doesn't wake up at all unless a timer expires. It can also watch arbitrary file descriptors for readiness. On
+	 * other platforms only posted tasks and timers are supported.
+	 */
+	class EventLoop : NonCopyable {
+	public:
+		/**
+		 * The clock used for all deadlines. It is monotonic and therefore immune to changes of the wall-clock time.
+		 */
+		using clock = std::chrono::steady_clock;
+		/**
+		 * The type of work that can be executed by the loop
+		 */
+		using task_t = std::function< void() >;
+		/**
+		 * The type used for identifying timers
+		 */
+		using timer_id_t = std::uint64_t;
+
+		/**
+		 * Flags describing the kind of readiness of a file descriptor
+		 */
+		enum IOEvents : std::uint32_t {
+			READABLE = 1 << 0,
+			WRITABLE = 1 << 1,
+		};
+
+		/**
+		 * The type of callbacks invoked once a watched file descriptor becomes ready. The parameter is a combination of
+		 * IOEvents flags. Error conditions on the descriptor are reported as being both, readable and writable, so that
+		 * the subsequent IO operation reports the actual error.
+		 */
+		using io_callback_t = std::function< void(std::uint32_t events) >;
+
+	private:
+		/**
+		 * The amount of posted tasks room is reserved for up front
+		 */
+		static constexpr std::size_t RESERVED_TASKS = 16;
+
+		/**
+		 * Guards m_postedTasks
+		 */
+		std::mutex m_taskMutex;
+		/**
+		 * Tasks that have been posted to the loop but have not been executed yet
+		 */
+		std::vector< task_t > m_postedTasks;
+		/**
+		 * The tasks that are currently being executed. This is swapped with m_postedTasks, so that both vectors keep
+		 * their capacity and posting doesn't have to allocate memory once the loop has warmed up.
+		 */
+		std::vector< task_t > m_runningTasks;
+		/**
+		 * Whether the loop has been asked to stop
+		 */
+		std::atomic< bool > m_stopRequested = std::atomic< bool >(false);
+		/**
+		 * The ID of the thread currently executing run()
+		 */
+		std::atomic< std::thread::id > m_loopThread;
+		/**
+		 * All active timers ordered by their deadline. The ID is part of the key in order to allow for multiple timers
+		 * sharing the same deadline.
+		 */
+		std::map< std::pair< clock::time_point, timer_id_t >, task_t > m_timers;
+		/**
+		 * Maps the ID of an active timer to its deadline
+		 */
+		std::unordered_map< timer_id_t, clock::time_point > m_timerDeadlines;
+		/**
+		 * The ID that will be assigned to the next timer
+		 */
+		timer_id_t m_nextTimerID = 0;
+
+#ifdef PLATFORM_UNIX
+		/**
+		 * The epoll instance used to wait for events
+		 */
+		int m_epollHandle = -1;
+		/**
+		 * The eventfd used to wake up the loop
+		 */
+		int m_wakeupHandle = -1;
+		/**
+		 * The callbacks of all watched file descriptors. They are shared, so that a callback can be kept alive while it
+		 * is being invoked without copying it.
+		 */
+		std::unordered_map< int, std::shared_ptr< io_callback_t > > m_watches;
+#else
+		/**
+		 * Used to wake up the loop
+		 */
+		std::condition_variable m_wakeupCondition;
+#endif
+
+		/**
+		 * Wakes up the loop if it is currently waiting for events
+		 */
+		void wakeup();
+		/**
+		 * Reserves room for RESERVED_TASKS posted tasks, so that posting doesn't have to grow the task vectors as long
+		 * as the loop keeps up
+		 */
+		void reserveTasks();
+		/**
+		 * Executes the given task. Exceptions thrown by the task are reported and swallowed, so that the loop keeps
+		 * running.
+		 *
+		 * @param task The task to execute
+		 */
+		void runTask(task_t &task);
+		/**
+		 * Executes all tasks that have been posted so far
+		 */
+		void runPostedTasks();
+		/**
+		 * Executes all timers whose deadline has passed
+		 */
+		void runExpiredTimers();
+		/**
+		 * @returns The deadline of the timer that is going to expire next or clock::time_point::max() if there is no
+		 * active timer
+		 */
+		clock::time_point nextDeadline() const;
+
+	public:
+		EventLoop();
+		~EventLoop();
+
+		/**
+		 * Runs the loop in the calling thread until stop() is called
+		 */
+		void run();
+		/**
+		 * Asks the loop to stop. The loop is woken up immediately and run() returns after it has finished executing
+		 * the callback it is currently executing (if any). If the loop isn't running right now, the next call to run()
+		 * will return immediately.
+		 *
+		 * @note This function is thread-safe
+		 */
+		void stop();
+		/**
+		 * Discards a stop request that has not been processed by run() yet. This must not be called while the loop is
+		 * running.
+		 */
+		void reset();
+
+		/**
+		 * Hands the given task over to the loop which will execute it in the loop's thread as soon as possible. Tasks
+		 * are executed in the order in which they have been posted.
+		 *
+		 * @param task The task to execute
+		 *
+		 * @note This function is thread-safe
+		 */
+		void post(task_t task);
+
+		/**
+		 * Schedules the given task to be executed once the given deadline has been reached. This must only be called
+		 * from within the loop's thread.
+		 *
+		 * @param deadline The point in time at which the task shall be executed
+		 * @param task The task to execute
+		 * @returns The ID of the created timer
+		 */
+		timer_id_t runAt(clock::time_point deadline, task_t task);
+		/**
+		 * Schedules the given task to be executed after the given delay. This must only be called from within the
+		 * loop's thread.
+		 *
+		 * @param delay The delay after which the task shall be executed
+		 * @param task The task to execute
+		 * @returns The ID of the created timer
+		 */
+		timer_id_t runAfter(clock::duration delay, task_t task);
+		/**
+		 * Cancels the timer with the given ID. Cancelling a timer that has already expired is a no-op. This must only
+		 * be called from within the loop's thread.
+		 *
+		 * @param id The ID of the timer to cancel
+		 */
+		void cancelTimer(timer_id_t id);
+
+#ifdef PLATFORM_UNIX
+		/**
+		 * Starts watching the given file descriptor. This must only be called from within the loop's thread.
+		 *
+		 * @param fd The file descriptor to watch. It should be in non-blocking mode.
+		 * @param events The IOEvents to watch for
+		 * @param callback The callback to invoke once the descriptor becomes ready
+		 */
+		void watch(int fd, std::uint32_t events, io_callback_t callback);
+		/**
+		 * Changes the events the given (already watched) file descriptor is watched for. This must only be called from
+		 * within the loop's thread.
+		 *
+		 * @param fd The file descriptor
+		 * @param events The IOEvents to watch for from now on
+		 */
+		void modifyWatch(int fd, std::uint32_t events);
+		/**
+		 * Stops watching the given file descriptor. This must be done before the descriptor is closed. This must only
+		 * be called from within the loop's thread.
+		 *
+		 * @param fd The file descriptor
+		 */
+		void unwatch(int fd);
+#endif
+
+		/**
+		 * @returns Whether the calling thread is the thread the loop is running in
+		 */
+		bool isInLoopThread() const noexcept;
+	};
+
+}; // namespace JsonBridge
+}; // namespace Mumble
+
+#endif // MUMBLE_JSONBRIDGE_EVENTLOOP_H_
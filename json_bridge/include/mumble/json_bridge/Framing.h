@@ -0,0 +1,318 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+#ifndef MUMBLE_JSONBRIDGE_FRAMING_H_
+#define MUMBLE_JSONBRIDGE_FRAMING_H_
+
+#include "mumble/json_bridge/ReceiveBuffer.h"
+
+#include <bitset>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Mumble {
+namespace JsonBridge {
+
+	/**
+	 * An enum holding the supported ways of delimiting messages from one another on a byte stream
+	 */
+	enum class Framing {
+		/**
+		 * No explicit framing. A message ends wherever the reader runs out of data. This is the legacy behavior which
+		 * breaks as soon as multiple messages are written at nearly the same time or a writer is slow.
+		 */
+		NONE,
+		/**
+		 * Every message is terminated by a single newline character (newline-delimited JSON). Compactly serialized
+		 * JSON never contains a raw newline. Newlines within a pretty-printed message are told apart from delimiters
+		 * by the message's structure.
+		 */
+		NEWLINE
+	};
+
+	/**
+	 * The character used to terminate a message when using Framing::NEWLINE
+	 */
+	constexpr char FRAME_DELIMITER = '\n';
+
+	/**
+	 * @return A unique string representation of the given Framing
+	 *
+	 * @param framing The framing to convert to string
+	 */
+	std::string to_string(Framing framing);
+	/**
+	 * @return The Framing corresponding to the provided string representation. If the provided string is not a valid
+	 * representation of a Framing, this function will throw an std::invalid_argument exception.
+	 *
+	 * @param framing The framing's string representation
+	 */
+	Framing framing_from_string(const std::string &framing);
+
+	/**
+	 * Applies the given framing to the given message
+	 *
+	 * @param message The message to frame. The framing is applied in place, so passing an rvalue avoids copying it.
+	 * @param framing The framing to apply
+	 * @returns The framed message (ready to be written)
+	 */
+	std::string frame(std::string message, Framing framing);
+
+	/**
+	 * Picks the scalar top-level fields that make up a message's envelope (message_type, client_id, secret and
+	 * request_id) out of a JSON object that is fed to it in pieces. Nothing but these fields is kept, so the object
+	 * may be arbitrarily large. This allows to identify the sender of a message that is too large to be buffered.
+	 *
+	 * @see Mumble::JsonBridge::Messages::Envelope
+	 */
+	class EnvelopeCapture {
+	public:
+		/**
+		 * The maximum size of a single captured field's value. Longer values are left out.
+		 */
+		static constexpr std::size_t MAX_VALUE_SIZE = 256;
+
+	private:
+		/**
+		 * The nesting depth of JSON objects and arrays at the current position
+		 */
+		int m_nestingDepth = 0;
+		/**
+		 * Whether the current position lies within a JSON string
+		 */
+		bool m_inString = false;
+		/**
+		 * Whether the last byte is an escaping backslash within a JSON string
+		 */
+		bool m_escaped = false;
+		/**
+		 * Whether the top-level object has ended
+		 */
+		bool m_complete = false;
+		/**
+		 * Whether the current position lies within a top-level key
+		 */
+		bool m_inKey = false;
+		/**
+		 * Whether the current position lies within the value of a top-level field
+		 */
+		bool m_inValue = false;
+		/**
+		 * Whether the value of the current top-level field is being captured
+		 */
+		bool m_capturing = false;
+		/**
+		 * The key of the current top-level field
+		 */
+		std::string m_key;
+		/**
+		 * The captured value of the current top-level field (as JSON text)
+		 */
+		std::string m_value;
+		/**
+		 * The fields captured so far (as the JSON text of an object's members)
+		 */
+		std::string m_fields;
+		/**
+		 * Which of the envelope fields have been captured already. Later occurrences are ignored, so that the
+		 * captured data stays bounded.
+		 */
+		std::bitset< 4 > m_capturedFields;
+
+		/**
+		 * Finishes the current top-level field, adding it to m_fields if it has been captured
+		 */
+		void finishField();
+
+	public:
+		/**
+		 * Feeds the next piece of the object to this capture
+		 *
+		 * @param data The next piece of the object
+		 * @returns The amount of bytes of the given data that belong to the object. This is less than the given size
+		 * only if the object has ended.
+		 */
+		std::size_t feed(std::string_view data);
+		/**
+		 * @returns Whether the end of the top-level object has been fed to this capture
+		 */
+		[[nodiscard]] bool isComplete() const noexcept;
+		/**
+		 * @returns A JSON object consisting of the captured fields. This doesn't reset the capture.
+		 */
+		[[nodiscard]] std::string getEnvelope() const;
+		/**
+		 * Resets this capture, so that it can be used for the next object
+		 */
+		void reset();
+	};
+
+	/**
+	 * A frame that has been discarded while it was being received, as it exceeded the maximum frame size
+	 */
+	struct DiscardedFrame {
+		/**
+		 * The amount of bytes that have been discarded
+		 */
+		std::size_t size = 0;
+		/**
+		 * The envelope fields of the frame that could be captured (as a JSON object)
+		 *
+		 * @see Mumble::JsonBridge::EnvelopeCapture
+		 */
+		std::string envelope;
+	};
+
+	/**
+	 * Accumulates data read from a byte stream and splits it into individual messages (frames). Newline-delimited
+	 * frames are always recognized. For the sake of legacy writers that don't use any framing, data that is not
+	 * terminated by a newline is treated as a complete message once the reader has run out of data and the pending
+	 * data is not merely the beginning of a JSON document whose remainder has yet to arrive.
+	 *
+	 * The received data is kept in a ReceiveBuffer that can be read into directly and extracted frames are handed out
+	 * as views into that buffer, so that no data has to be copied on its way from the stream to the parser.
+	 *
+	 * A frame exceeding the maximum frame size is not buffered. Instead it is discarded while it is being received,
+	 * keeping only what is needed for telling its sender about it (see DiscardedFrame).
+	 */
+	class FrameReader {
+	private:
+		/**
+		 * The data that has been received but not yet been extracted as a frame
+		 */
+		ReceiveBuffer m_buffer;
+		/**
+		 * The amount of bytes at the front of m_buffer that have been scanned for the end of the current frame
+		 */
+		std::size_t m_scannedBytes = 0;
+		/**
+		 * The nesting depth of JSON objects and arrays at the end of the scanned bytes
+		 */
+		int m_nestingDepth = 0;
+		/**
+		 * Whether the end of the scanned bytes lies within a JSON string
+		 */
+		bool m_inString = false;
+		/**
+		 * Whether the last scanned byte is an escaping backslash within a JSON string
+		 */
+		bool m_escaped = false;
+		/**
+		 * Whether the data that is received next belongs to a frame that is being discarded
+		 */
+		bool m_discarding = false;
+		/**
+		 * The frame that is currently being discarded
+		 */
+		DiscardedFrame m_discardedFrame;
+		/**
+		 * Captures the envelope of the frame that is currently being discarded
+		 */
+		EnvelopeCapture m_envelopeCapture;
+		/**
+		 * The frames that have been discarded but not been taken out via takeDiscardedFrames() yet
+		 */
+		std::vector< DiscardedFrame > m_discardedFrames;
+
+		/**
+		 * Tracks the JSON structure of the given data, continuing from where the last call left off, until it reaches
+		 * the newline that ends the current frame. Only a newline outside of the frame's top-level value ends it, as
+		 * pretty-printers put newlines anywhere within a message (without necessarily indenting nested values).
+		 * Tracking the structure also allows to cheaply rule out that pending data is a complete legacy message
+		 * without re-parsing all of it whenever a new chunk of a large message arrives.
+		 *
+		 * A message that has been cut short never ends this way, so it grows until it exceeds the maximum frame size
+		 * and is discarded. While discarding, a newline within the top-level value ends the frame as well if the next
+		 * line begins with an object, which is where the next message most likely begins.
+		 *
+		 * @param data The data to scan
+		 * @param scanned Set to the amount of bytes that have been scanned. If the frame has ended, this is the offset
+		 * of its delimiter. A trailing newline whose meaning can't be told yet (while discarding) is left unscanned.
+		 * @returns Whether the frame has ended within the given data
+		 */
+		bool scanStructure(std::string_view data, std::size_t &scanned) noexcept;
+		/**
+		 * Resets the state tracked by scanStructure()
+		 */
+		void resetScanState() noexcept;
+		/**
+		 * Discards the buffered data up to the end of the frame that is being discarded. If the frame ends within
+		 * the buffered data, it is added to m_discardedFrames.
+		 */
+		void discardFrame();
+		/**
+		 * Stops discarding the current frame and adds it to m_discardedFrames
+		 */
+		void finishDiscarding();
+
+	public:
+		/**
+		 * The default maximum size of a single frame
+		 */
+		static constexpr std::size_t DEFAULT_MAX_FRAME_SIZE = ReceiveBuffer::DEFAULT_MAX_CAPACITY - 1;
+
+		/**
+		 * @param maxFrameSize The maximum size of a single frame (excluding its delimiter). The buffer never holds more
+		 * than this (plus the delimiter).
+		 */
+		explicit FrameReader(std::size_t maxFrameSize = DEFAULT_MAX_FRAME_SIZE);
+
+		/**
+		 * Sets the maximum size of a single frame. Memory that has been allocated already is not released.
+		 *
+		 * @param maxFrameSize The maximum size of a single frame (excluding its delimiter)
+		 */
+		void setMaxFrameSize(std::size_t maxFrameSize) noexcept;
+
+		/**
+		 * Appends freshly received data to the internal buffer
+		 *
+		 * @param data The received data
+		 */
+		void append(std::string_view data);
+
+		/**
+		 * @returns The internal buffer. It can be used to read data from a stream directly into this reader.
+		 */
+		[[nodiscard]] ReceiveBuffer &getBuffer() noexcept;
+
+		/**
+		 * Extracts all complete frames from the internal buffer. This function should be called after the reader has
+		 * run out of data to read (for now).
+		 *
+		 * @returns The extracted frames (without delimiters) in the order in which they have been received. These are
+		 * views into the internal buffer that stay valid until new data is added to this reader.
+		 */
+		[[nodiscard]] std::vector< std::string_view > extractFrames();
+
+		/**
+		 * Takes all pending data out of the internal buffer regardless of whether it forms a complete frame. This is
+		 * meant to be used when the rest of a message is not going to arrive anymore. If a frame is being discarded,
+		 * it ends here.
+		 *
+		 * @returns The pending data (empty if a frame has been discarded instead)
+		 */
+		[[nodiscard]] std::string flush();
+
+		/**
+		 * @returns Whether there is data buffered that has not been extracted as a frame yet or a frame is being
+		 * discarded
+		 */
+		[[nodiscard]] bool hasPendingData() const noexcept;
+
+		/**
+		 * Takes the frames that have been discarded so far out of this reader
+		 *
+		 * @returns The discarded frames in the order in which they have been received
+		 */
+		[[nodiscard]] std::vector< DiscardedFrame > takeDiscardedFrames();
+	};
+
+}; // namespace JsonBridge
+}; // namespace Mumble
+
+#endif // MUMBLE_JSONBRIDGE_FRAMING_H_
@@ -0,0 +1,145 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+#ifndef MUMBLE_JSONBRIDGE_NAMEINDEX_H_
+#define MUMBLE_JSONBRIDGE_NAMEINDEX_H_
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Mumble {
+namespace JsonBridge {
+
+	/**
+	 * @returns The given name with all ASCII letters converted to lower case. Names are compared case-insensitively by
+	 * comparing their folded forms. Letters outside of ASCII are left as they are.
+	 *
+	 * @param name The name to fold
+	 */
+	std::string foldCase(std::string_view name);
+
+	/**
+	 * @returns Whether the given name matches the given query
+	 *
+	 * @param name The name to check
+	 * @param query The name (or prefix) that is looked for
+	 * @param caseSensitive Whether the case of ASCII letters has to match
+	 * @param prefix Whether the query only has to match the beginning of the name
+	 */
+	bool nameMatches(std::string_view name, std::string_view query, bool caseSensitive, bool prefix);
+
+	/**
+	 * An index of the names of users or channels. Exact lookups take a single hash lookup. Case-insensitive and prefix
+	 * lookups take a logarithmic amount of steps (plus one per match).
+	 *
+	 * Several IDs may share the same name. This class is not thread-safe.
+	 */
+	template< typename id_t > class NameIndex {
+	private:
+		/**
+		 * The IDs indexed by their exact name
+		 */
+		std::unordered_map< std::string, std::vector< id_t > > m_exact;
+		/**
+		 * The exact names indexed by their folded name and ID. Their order is what allows for prefix lookups.
+		 */
+		std::map< std::pair< std::string, id_t >, std::string > m_folded;
+
+	public:
+		/**
+		 * Adds the given name
+		 *
+		 * @param name The name
+		 * @param id The ID of the user or channel with this name
+		 */
+		void add(const std::string &name, id_t id) {
+			m_exact[name].push_back(id);
+			m_folded.emplace(std::make_pair(foldCase(name), id), name);
+		}
+
+		/**
+		 * Removes the given name. Names that haven't been added are ignored.
+		 *
+		 * @param name The name
+		 * @param id The ID of the user or channel with this name
+		 */
+		void remove(const std::string &name, id_t id) {
+			auto it = m_exact.find(name);
+			if (it == m_exact.end()) {
+				return;
+			}
+
+			std::vector< id_t > &ids = it->second;
+			ids.erase(std::remove(ids.begin(), ids.end(), id), ids.end());
+			if (ids.empty()) {
+				m_exact.erase(it);
+			}
+
+			m_folded.erase(std::make_pair(foldCase(name), id));
+		}
+
+		/**
+		 * @returns The lowest ID with exactly the given name, if there is any
+		 *
+		 * @param name The name
+		 */
+		[[nodiscard]] const id_t *find(const std::string &name) const {
+			auto it = m_exact.find(name);
+
+			return it == m_exact.end() ? nullptr : &*std::min_element(it->second.begin(), it->second.end());
+		}
+
+		/**
+		 * Looks up all IDs whose name matches the given query
+		 *
+		 * @param query The name (or prefix) that is looked for
+		 * @param caseSensitive Whether the case of ASCII letters has to match
+		 * @param prefix Whether the query only has to match the beginning of the name
+		 * @returns The matching IDs in ascending order
+		 */
+		[[nodiscard]] std::vector< id_t > find(const std::string &query, bool caseSensitive, bool prefix) const {
+			std::vector< id_t > matches;
+
+			if (caseSensitive && !prefix) {
+				auto it = m_exact.find(query);
+				if (it != m_exact.end()) {
+					matches = it->second;
+				}
+			} else {
+				// Every match is found among the names whose folded forms match the folded query
+				const std::string folded = foldCase(query);
+
+				for (auto it = m_folded.lower_bound(std::make_pair(folded, std::numeric_limits< id_t >::min()));
+					 it != m_folded.end() && nameMatches(it->first.first, folded, true, prefix); ++it) {
+					if (!caseSensitive || nameMatches(it->second, query, true, prefix)) {
+						matches.push_back(it->first.second);
+					}
+				}
+			}
+
+			std::sort(matches.begin(), matches.end());
+
+			return matches;
+		}
+
+		/**
+		 * Removes all names
+		 */
+		void clear() {
+			m_exact.clear();
+			m_folded.clear();
+		}
+	};
+
+}; // namespace JsonBridge
+}; // namespace Mumble
+
+#endif // MUMBLE_JSONBRIDGE_NAMEINDEX_H_
@@ -6,12 +6,17 @@
 #ifndef MUMBLE_JSONBRIDGE_NAMEDPIPE_H_
 #define MUMBLE_JSONBRIDGE_NAMEDPIPE_H_
 
+#include "mumble/json_bridge/Framing.h"
 #include "mumble/json_bridge/NonCopyable.h"
+#include "mumble/json_bridge/ReceiveBuffer.h"
 
+#include <cstddef>
 #include <filesystem>
 #include <limits>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #ifdef PLATFORM_WINDOWS
 #	include <windows.h>
@@ -74,7 +79,29 @@ namespace JsonBridge {
 		 * On Windows this holds the handle to the pipe. On other platforms this variable doesn't exist.
 		 */
 		HANDLE m_handle = INVALID_HANDLE_VALUE;
+#else
+		/**
+		 * The handle used in long-lived reader mode or -1 if that mode is not active. On Windows this variable doesn't
+		 * exist.
+		 *
+		 * @see Mumble::JsonBridge::NamedPipe::openPersistentReader()
+		 */
+		int m_readHandle = -1;
 #endif
+		/**
+		 * The reader used to split the content read from this pipe into individual messages. Its buffer serves as this
+		 * pipe's receive buffer and is reused for every message.
+		 *
+		 * @see Mumble::JsonBridge::NamedPipe::read_frames()
+		 */
+		mutable FrameReader m_frameReader;
+
+		/**
+		 * Waits until there is content available on the wrapped named pipe and reads it into m_frameReader
+		 *
+		 * @param timeout How long this function may wait for content
+		 */
+		void receive(unsigned int timeout) const;
 
 		/**
 		 * Instantiates this wrapper. On Windows the m_handle member variable has to be set
@@ -111,9 +138,10 @@ namespace JsonBridge {
 		 * @param timeout How long this function is allowed to take in milliseconds. Note that the timeout is only
 		 * respected very roughly (especially on Windows) and should therefore rather be used to specify the general
 		 * order of magnitude of the timeout instead of the exact timeout-interval.
+		 * @param framing The framing that should be applied to the given message
 		 */
 		static void write(const std::filesystem::path &pipePath, const std::string &content,
-						  unsigned int timeout = 1000);
+						  unsigned int timeout = 1000, Framing framing = Framing::NONE);
 
 		/**
 		 * @returns Whether a named pipe at the given path currently exists
@@ -124,10 +152,24 @@ namespace JsonBridge {
 		 * Writes to the named pipe wrapped by this object by calling NamedPipe::write
 		 * @content The message that should be written to the named pipe
 		 * @content How long this function is allowed to take in milliseconds. The remarks from NamedPipe::write apply.
+		 * @param framing The framing that should be applied to the given message
 		 *
 		 * @see Mumble::JsonBridge::NamedPipe::write()
 		 */
-		void write(const std::string &content, unsigned int timeout = 1000) const;
+		void write(const std::string &content, unsigned int timeout = 1000, Framing framing = Framing::NONE) const;
+
+		/**
+		 * Switches this pipe into long-lived reader mode. In this mode a single handle is kept open for reading until
+		 * the pipe is destroyed instead of opening and closing the pipe for every call to read_blocking(). This means
+		 * that writers never encounter a moment in which the pipe has no reader.
+		 *
+		 * On Unix the handle is opened in read-write mode, which prevents the reader from ever seeing a spurious EOF
+		 * once the last writer has closed its end of the pipe. On Windows the pipe's handle is already long-lived and
+		 * this function is a no-op.
+		 *
+		 * @note Calling this function multiple times is allowed. All but the first invocation are turned into no-opts.
+		 */
+		void openPersistentReader();
 
 		/**
 		 * Reads content from the wrapped named pipe. This function will block until there is content available or the
@@ -140,6 +182,73 @@ namespace JsonBridge {
 		[[nodiscard]] std::string
 			read_blocking(unsigned int timeout = (std::numeric_limits< unsigned int >::max)()) const;
 
+#ifdef PLATFORM_UNIX
+		/**
+		 * Reads everything that is currently available from the wrapped named pipe into its receive buffer without
+		 * blocking and returns all complete messages (frames). This is meant to be used in combination with an event
+		 * loop that watches getReadHandle() for readability. The pipe must be in long-lived reader mode. This function
+		 * is only available on Unix.
+		 *
+		 * @returns The read messages (without their delimiters) in the order in which they have been received. These
+		 * are views into the pipe's receive buffer that stay valid until the next read from this pipe.
+		 *
+		 * @see Mumble::JsonBridge::NamedPipe::openPersistentReader()
+		 * @see Mumble::JsonBridge::EventLoop
+		 */
+		[[nodiscard]] std::vector< std::string_view > read_available_frames() const;
+
+		/**
+		 * @returns The (non-blocking) handle used in long-lived reader mode or -1 if this mode is not active. This
+		 * function is only available on Unix.
+		 */
+		[[nodiscard]] int getReadHandle() const noexcept;
+#endif
+
+		/**
+		 * Reads from the wrapped named pipe until at least one complete message (frame) is available and returns all
+		 * messages that are available at that point. Newline-delimited messages are split from one another, data
+		 * belonging to a message that has not been received completely yet is kept back until the next call.
+		 * Unframed messages are supported as well, as long as they don't arrive in the same read as another message.
+		 * Messages exceeding the maximum frame size are not returned (see takeDiscardedFrames()).
+		 *
+		 * @param timeout How long this function may wait for content. The remarks from read_blocking apply.
+		 * @returns The read messages (without their delimiters) in the order in which they have been received
+		 *
+		 * @see Mumble::JsonBridge::FrameReader
+		 */
+		[[nodiscard]] std::vector< std::string >
+			read_frames(unsigned int timeout = (std::numeric_limits< unsigned int >::max)()) const;
+
+		/**
+		 * @returns Whether the beginning of a message has been received whose remainder is still missing
+		 */
+		[[nodiscard]] bool hasPartialFrame() const noexcept;
+		/**
+		 * Takes the beginning of a message whose remainder is still missing out of the receive buffer. This is meant
+		 * to be used when the rest of the message is not going to arrive anymore.
+		 *
+		 * @returns The partial message (empty if the message is being discarded as it exceeds the maximum frame size)
+		 */
+		[[nodiscard]] std::string flushPartialFrame() const;
+
+		/**
+		 * Sets the maximum size of a single message received via this pipe. Larger messages are discarded while they
+		 * are being received, so that the pipe's receive buffer never has to hold more than this.
+		 *
+		 * @param size The maximum size in bytes
+		 */
+		void setMaxFrameSize(std::size_t size) noexcept;
+		/**
+		 * Takes the messages out of this pipe that have been discarded, as they exceeded the maximum frame size
+		 *
+		 * @returns The discarded messages in the order in which they have been received
+		 */
+		[[nodiscard]] std::vector< DiscardedFrame > takeDiscardedFrames() const;
+		/**
+		 * @returns Statistics about the reads performed into the pipe's receive buffer
+		 */
+		[[nodiscard]] const ReceiveBuffer::Statistics &getReceiveStatistics() const noexcept;
+
 		/**
 		 * @returns The path of the wrapped named pipe
 		 */
@@ -160,6 +269,103 @@ namespace JsonBridge {
 		operator bool() const noexcept;
 	};
 
+	/**
+	 * A long-lived handle for writing to a named pipe. Other than NamedPipe::write, which opens and closes the pipe for
+	 * every message, this keeps the pipe open in between messages. If the reader has gone away in the meantime, the
+	 * pipe is reopened lazily on the next write.
+	 *
+	 * @note On Unix SIGPIPE is blocked for the calling thread while writing, so that a reader going away can't take
+	 * down the whole process.
+	 */
+	class PipeWriter : NonCopyable {
+	private:
+		/**
+		 * The path to the pipe written to
+		 */
+		std::filesystem::path m_pipePath;
+#ifdef PLATFORM_WINDOWS
+		/**
+		 * The handle to the pipe or INVALID_HANDLE_VALUE if it is currently not open
+		 */
+		HANDLE m_handle = INVALID_HANDLE_VALUE;
+#else
+		/**
+		 * The handle to the pipe or -1 if it is currently not open
+		 */
+		int m_handle = -1;
+#endif
+
+		/**
+		 * Opens the pipe, waiting for it to exist and to have a reader.
+		 *
+		 * @param timeout How long this function may wait in milliseconds. It is decreased by the time spent waiting.
+		 */
+		void connect(unsigned int &timeout);
+
+	public:
+		/**
+		 * Creates an empty (invalid) instance
+		 */
+		PipeWriter() = default;
+		/**
+		 * Creates a writer for the pipe at the given path. The pipe is not opened before it is used.
+		 *
+		 * @param pipePath The path of the pipe to write to
+		 */
+		explicit PipeWriter(const std::filesystem::path &pipePath);
+		~PipeWriter();
+
+		PipeWriter(PipeWriter &&other);
+		PipeWriter &operator=(PipeWriter &&other);
+
+		/**
+		 * Tries to open the pipe without waiting for it to become available
+		 *
+		 * @returns Whether the pipe is open now
+		 */
+		bool open();
+		/**
+		 * Writes a message to the pipe, opening (or reopening) it first if necessary.
+		 *
+		 * @param content The message to write
+		 * @param timeout How long this function is allowed to take in milliseconds. The remarks from NamedPipe::write
+		 * apply.
+		 * @param framing The framing that should be applied to the given message
+		 */
+		void write(const std::string &content, unsigned int timeout = 1000, Framing framing = Framing::NONE);
+#ifdef PLATFORM_UNIX
+		/**
+		 * Writes as much of the given data to the pipe as is possible without blocking. If the pipe is not open, it is
+		 * opened first (without waiting for a reader). If the reader has gone away, the pipe is closed. This function
+		 * is only available on Unix.
+		 *
+		 * @param data The data to write
+		 * @returns The amount of bytes written. If this is less than the size of the given data, isOpen() tells
+		 * whether the pipe is full (it is still open) or has no reader (it is closed).
+		 */
+		std::size_t tryWrite(std::string_view data);
+		/**
+		 * @returns The pipe's handle or -1 if it is currently not open. This function is only available on Unix.
+		 */
+		[[nodiscard]] int getHandle() const noexcept;
+#endif
+		/**
+		 * Closes the pipe. It will be reopened by the next write.
+		 *
+		 * @note Calling this function multiple times is allowed. All but the first invocation are turned into no-opts.
+		 */
+		void close() noexcept;
+
+		/**
+		 * @returns Whether the pipe is currently open
+		 */
+		[[nodiscard]] bool isOpen() const noexcept;
+		/**
+		 * @returns The path of the pipe written to
+		 */
+		[[nodiscard]] const std::filesystem::path &getPath() const noexcept;
+	};
+
 }; // namespace JsonBridge
 }; // namespace Mumble
 
@@ -0,0 +1,177 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+#ifndef MUMBLE_JSONBRIDGE_OUTBOUNDQUEUE_H_
+#define MUMBLE_JSONBRIDGE_OUTBOUNDQUEUE_H_
+
+#include "mumble/json_bridge/NonCopyable.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Mumble {
+namespace JsonBridge {
+
+	/**
+	 * An enum holding the possible ways of dealing with a message that doesn't fit into a client's outbound queue
+	 */
+	enum class OverflowPolicy {
+		/**
+		 * The message is dropped silently (it is only accounted for in the statistics)
+		 */
+		DROP,
+		/**
+		 * The client is disconnected
+		 */
+		DISCONNECT,
+		/**
+		 * The message is dropped and the client is sent an error message instead. (Not called ERROR as that name is
+		 * taken by a macro on Windows.)
+		 */
+		SEND_ERROR
+	};
+
+	/**
+	 * Counters aggregated over multiple outbound queues. They can be read from any thread.
+	 */
+	struct OutboundStatistics {
+		/**
+		 * The amount of bytes that are currently queued
+		 */
+		std::atomic< std::uint64_t > queuedBytes = std::atomic< std::uint64_t >(0);
+		/**
+		 * The amount of messages that have been dropped
+		 */
+		std::atomic< std::uint64_t > droppedMessages = std::atomic< std::uint64_t >(0);
+		/**
+		 * The amount of clients that have been disconnected because of OverflowPolicy::DISCONNECT
+		 */
+		std::atomic< std::uint64_t > disconnectedClients = std::atomic< std::uint64_t >(0);
+	};
+
+	/**
+	 * A bounded queue of (already framed) messages waiting to be written to a client. Messages may be written in
+	 * multiple parts, so the queue keeps track of how much of its first message has been written already.
+	 */
+	class OutboundQueue : NonCopyable {
+	public:
+		/**
+		 * The default amount of bytes that may be queued at once
+		 */
+		static constexpr std::size_t DEFAULT_MAX_QUEUED_BYTES = 1024 * 1024;
+
+	private:
+		/**
+		 * The queued messages (starting at m_firstMessage). Written messages are only erased once they make up half of
+		 * the vector, so that a queue that is emptied regularly keeps reusing its storage.
+		 */
+		std::vector< std::string > m_messages;
+		/**
+		 * The index of the first message that hasn't been written completely yet
+		 */
+		std::size_t m_firstMessage = 0;
+		/**
+		 * The amount of bytes of the first message that have been written already
+		 */
+		std::size_t m_frontOffset = 0;
+		/**
+		 * The amount of bytes that are currently queued (and not written yet)
+		 */
+		std::size_t m_queuedBytes = 0;
+		/**
+		 * The amount of bytes that may be queued at once
+		 */
+		std::size_t m_maxQueuedBytes;
+		/**
+		 * The amount of messages that have been dropped from (or not admitted into) this queue
+		 */
+		std::uint64_t m_droppedMessages = 0;
+		/**
+		 * The statistics this queue contributes to (may be nullptr)
+		 */
+		OutboundStatistics *m_sharedStatistics;
+
+		/**
+		 * Removes the first message from the queue and returns its buffer to the BufferPool
+		 */
+		void pop() noexcept;
+
+	public:
+		/**
+		 * @param maxQueuedBytes The amount of bytes that may be queued at once
+		 * @param sharedStatistics The statistics this queue shall contribute to (may be nullptr). The object must
+		 * outlive this queue.
+		 */
+		explicit OutboundQueue(std::size_t maxQueuedBytes = DEFAULT_MAX_QUEUED_BYTES,
+							   OutboundStatistics *sharedStatistics = nullptr);
+		~OutboundQueue();
+
+		OutboundQueue(OutboundQueue &&other);
+		OutboundQueue &operator=(OutboundQueue &&other);
+
+		/**
+		 * Appends the given message to the queue, if it fits
+		 *
+		 * @param message The message to append
+		 * @returns Whether the message has been appended. If not, the message has been dropped.
+		 */
+		[[nodiscard]] bool push(std::string message);
+		/**
+		 * Appends the given message to the queue, even if the queue's limit is exceeded that way. This is meant for
+		 * small messages that must be delivered no matter what.
+		 *
+		 * @param message The message to append
+		 */
+		void forcePush(std::string message);
+
+		/**
+		 * @returns The part of the first message that has not been written yet. Must not be called on an empty queue.
+		 */
+		[[nodiscard]] std::string_view front() const noexcept;
+		/**
+		 * Marks the given amount of bytes as written. Messages that have been written completely are removed.
+		 *
+		 * @param bytes The amount of written bytes. Must not exceed front().size().
+		 */
+		void consume(std::size_t bytes) noexcept;
+		/**
+		 * @returns Whether the first message has been partially written already
+		 */
+		[[nodiscard]] bool isFrontPartiallyWritten() const noexcept;
+		/**
+		 * Drops the first message (regardless of whether it has been partially written already)
+		 */
+		void dropFront() noexcept;
+		/**
+		 * Drops all queued messages
+		 */
+		void dropAll() noexcept;
+
+		/**
+		 * @returns Whether there are no messages queued
+		 */
+		[[nodiscard]] bool empty() const noexcept;
+		/**
+		 * @returns The amount of messages that are currently queued
+		 */
+		[[nodiscard]] std::size_t size() const noexcept;
+		/**
+		 * @returns The amount of bytes that are currently queued (and not written yet)
+		 */
+		[[nodiscard]] std::size_t getQueuedBytes() const noexcept;
+		/**
+		 * @returns The amount of messages that have been dropped from (or not admitted into) this queue
+		 */
+		[[nodiscard]] std::uint64_t getDroppedMessages() const noexcept;
+	};
+
+}; // namespace JsonBridge
+}; // namespace Mumble
+
+#endif // MUMBLE_JSONBRIDGE_OUTBOUNDQUEUE_H_
@@ -0,0 +1,160 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+#ifndef MUMBLE_JSONBRIDGE_RECEIVEBUFFER_H_
+#define MUMBLE_JSONBRIDGE_RECEIVEBUFFER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace Mumble {
+namespace JsonBridge {
+
+	/**
+	 * A contiguous buffer for data received from a byte stream. The buffer is meant to be kept around for the entire
+	 * lifetime of the stream, so that its memory can be reused for every message. It grows on demand but never beyond
+	 * the configured maximum capacity.
+	 *
+	 * Consuming data from the front of the buffer only advances a read position. The consumed space is reclaimed once
+	 * new data needs room, which means that views obtained via view() stay valid until the next call to append() or
+	 * readFrom().
+	 */
+	class ReceiveBuffer {
+	public:
+		/**
+		 * The capacity a buffer starts out with
+		 */
+		static constexpr std::size_t INITIAL_CAPACITY = 4 * 1024;
+		/**
+		 * The default maximum capacity of a buffer
+		 */
+		static constexpr std::size_t DEFAULT_MAX_CAPACITY = 16 * 1024 * 1024;
+
+		/**
+		 * Statistics about the reads performed via readFrom()
+		 */
+		struct Statistics {
+			/**
+			 * The number of read system calls issued (including the ones that only reported that no data is available)
+			 */
+			std::uint64_t readCalls = 0;
+			/**
+			 * The total number of bytes read
+			 */
+			std::uint64_t readBytes = 0;
+		};
+
+	private:
+		/**
+		 * The buffer's memory
+		 */
+		std::vector< char > m_data;
+		/**
+		 * The offset of the first byte that has not been consumed yet
+		 */
+		std::size_t m_begin = 0;
+		/**
+		 * The offset one past the last byte that has been received
+		 */
+		std::size_t m_end = 0;
+		/**
+		 * The capacity the buffer must never exceed
+		 */
+		std::size_t m_maxCapacity;
+		/**
+		 * The statistics about the reads performed so far
+		 */
+		Statistics m_statistics;
+
+		/**
+		 * Makes sure that there is room for at least the given amount of bytes after m_end. This may move the
+		 * unconsumed data to the front of the buffer and/or grow the buffer.
+		 *
+		 * @param size The required room in bytes. Must not exceed freeCapacity().
+		 */
+		void reserve(std::size_t size);
+
+	public:
+		/**
+		 * @param maxCapacity The capacity the buffer must never exceed
+		 */
+		explicit ReceiveBuffer(std::size_t maxCapacity = DEFAULT_MAX_CAPACITY);
+
+		/**
+		 * @returns A view on the data that has not been consumed yet. The view stays valid until new data is added to
+		 * the buffer.
+		 */
+		[[nodiscard]] std::string_view view() const noexcept;
+		/**
+		 * @returns The amount of bytes that have not been consumed yet
+		 */
+		[[nodiscard]] std::size_t size() const noexcept;
+		/**
+		 * @returns Whether all data has been consumed
+		 */
+		[[nodiscard]] bool empty() const noexcept;
+		/**
+		 * @returns The amount of bytes that can still be added to the buffer before it reaches its maximum capacity
+		 */
+		[[nodiscard]] std::size_t freeCapacity() const noexcept;
+		/**
+		 * @returns The amount of memory currently allocated by the buffer
+		 */
+		[[nodiscard]] std::size_t capacity() const noexcept;
+		/**
+		 * @returns The capacity the buffer must never exceed
+		 */
+		[[nodiscard]] std::size_t maxCapacity() const noexcept;
+		/**
+		 * Sets the capacity the buffer must never exceed. Memory that has been allocated already is not released.
+		 *
+		 * @param maxCapacity The new maximum capacity
+		 */
+		void setMaxCapacity(std::size_t maxCapacity) noexcept;
+
+		/**
+		 * Marks the given amount of bytes at the front of the buffer as consumed
+		 *
+		 * @param size The amount of bytes to consume. Must not exceed size().
+		 */
+		void consume(std::size_t size) noexcept;
+		/**
+		 * Discards all data in the buffer
+		 */
+		void clear() noexcept;
+
+		/**
+		 * Appends the given data to the buffer. Data exceeding the buffer's maximum capacity is not added.
+		 *
+		 * @param data The data to append
+		 * @returns The amount of bytes actually appended
+		 */
+		std::size_t append(std::string_view data);
+
+#ifdef PLATFORM_UNIX
+		/**
+		 * Reads everything that is currently available from the given non-blocking file descriptor into the buffer
+		 * (until the buffer has reached its maximum capacity). Reads are performed as scatter reads into the buffer's
+		 * free space and a stack-allocated overflow area, so that a single system call can receive more data than the
+		 * buffer currently has room for. This function is only available on Unix.
+		 *
+		 * @param fd The file descriptor to read from
+		 * @returns The amount of bytes read
+		 */
+		std::size_t readFrom(int fd);
+#endif
+
+		/**
+		 * @returns The statistics about the reads performed via readFrom() so far
+		 */
+		[[nodiscard]] const Statistics &getStatistics() const noexcept;
+	};
+
+}; // namespace JsonBridge
+}; // namespace Mumble
+
+#endif // MUMBLE_JSONBRIDGE_RECEIVEBUFFER_H_
@@ -0,0 +1,120 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+#ifndef MUMBLE_JSONBRIDGE_RESPONSEWRITER_H_
+#define MUMBLE_JSONBRIDGE_RESPONSEWRITER_H_
+
+#include <mumble/plugin/MumbleAPI.h>
+
+#include <charconv>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include <nlohmann/json.hpp>
+
+namespace Mumble {
+namespace JsonBridge {
+
+	/**
+	 * Writes the JSON text of a response straight into a string, without building a JSON DOM first. The writer doesn't
+	 * keep track of the document's structure: It is up to the caller to produce valid JSON.
+	 */
+	class ResponseWriter {
+	private:
+		/**
+		 * The buffer the response is written to
+		 */
+		std::string &m_buffer;
+
+		/**
+		 * Writes the given integer
+		 */
+		template< typename T > void writeInteger(T value) {
+			char digits[24];
+			std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value);
+
+			m_buffer.append(digits, result.ptr);
+		}
+
+	public:
+		/**
+		 * @param buffer The buffer to append the response to. The writer must not outlive it.
+		 */
+		explicit ResponseWriter(std::string &buffer);
+
+		/**
+		 * Appends the given (pre-serialized) JSON text as it is
+		 *
+		 * @param json The JSON text
+		 */
+		void raw(std::string_view json) { m_buffer.append(json); }
+
+		/**
+		 * Writes the given string as JSON string (quoted and escaped). The string is expected to be valid UTF-8 (as are
+		 * all strings handed out by Mumble).
+		 *
+		 * @param str The string
+		 */
+		void string(std::string_view str);
+
+		/**
+		 * Writes the given string as JSON string (quoted and escaped)
+		 *
+		 * @param str The string
+		 */
+		void value(const MumbleString &str) { string(str.c_str()); }
+
+		/**
+		 * Writes the given JSON value
+		 *
+		 * @param json The value
+		 */
+		void value(const nlohmann::json &json);
+
+		/**
+		 * Writes the given value. Booleans, numbers (including enums) and ranges of them (written as arrays) are
+		 * supported.
+		 *
+		 * @param value The value
+		 */
+		template< typename T > void value(const T &value) {
+			if constexpr (std::is_same_v< T, bool >) {
+				raw(value ? "true" : "false");
+			} else if constexpr (std::is_enum_v< T >) {
+				writeInteger(static_cast< std::underlying_type_t< T > >(value));
+			} else if constexpr (std::is_integral_v< T >) {
+				writeInteger(value);
+			} else if constexpr (std::is_floating_point_v< T >) {
+				// Floating point numbers are rare enough to not bother with writing them ourselves
+				this->value(nlohmann::json(value));
+			} else {
+				m_buffer.push_back('[');
+
+				bool first = true;
+				for (const auto &current : value) {
+					if (!first) {
+						m_buffer.push_back(',');
+					}
+					first = false;
+
+					this->value(current);
+				}
+
+				m_buffer.push_back(']');
+			}
+		}
+
+		/**
+		 * @returns The buffer the response is written to
+		 */
+		std::string &buffer() noexcept { return m_buffer; }
+	};
+
+}; // namespace JsonBridge
+}; // namespace Mumble
+
+#endif // MUMBLE_JSONBRIDGE_RESPONSEWRITER_H_
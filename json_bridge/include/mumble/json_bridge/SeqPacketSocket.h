@@ -0,0 +1,213 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+#ifndef MUMBLE_JSONBRIDGE_SEQPACKETSOCKET_H_
+#define MUMBLE_JSONBRIDGE_SEQPACKETSOCKET_H_
+
+#include "mumble/json_bridge/NonCopyable.h"
+
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Mumble {
+namespace JsonBridge {
+
+#ifdef PLATFORM_UNIX
+	/**
+	 * A connected AF_UNIX socket of type SOCK_SEQPACKET. Other than with a named pipe, every connection is
+	 * bidirectional and the kernel preserves the boundaries of the messages sent over it, so no framing is required.
+	 * This class is only available on Unix.
+	 *
+	 * Socket addresses starting with an '@' refer to the abstract namespace (Linux only), all other addresses are
+	 * paths in the filesystem.
+	 *
+	 * @see Mumble::JsonBridge::SeqPacketListener
+	 */
+	class SeqPacketSocket : NonCopyable {
+	private:
+		/**
+		 * The socket's handle or -1 if it is not open
+		 */
+		int m_handle = -1;
+		/**
+		 * Whether the peer is still connected (as far as we know)
+		 */
+		bool m_connected = false;
+
+	public:
+		/**
+		 * The size of the biggest message that can be received. Note that the size of messages that can be sent is
+		 * further limited by the socket's send buffer.
+		 */
+		static constexpr std::size_t MAX_MESSAGE_SIZE = 1024 * 1024;
+
+		/**
+		 * Creates an empty (invalid) instance
+		 */
+		SeqPacketSocket() = default;
+		/**
+		 * Wraps the given (connected) socket handle and takes ownership of it
+		 *
+		 * @param handle The handle to wrap
+		 */
+		explicit SeqPacketSocket(int handle);
+		~SeqPacketSocket();
+
+		SeqPacketSocket(SeqPacketSocket &&other);
+		SeqPacketSocket &operator=(SeqPacketSocket &&other);
+
+		/**
+		 * Connects to the listening socket at the given address
+		 *
+		 * @param address The address of the listening socket
+		 * @param timeout How long this function may wait for the listener to accept the connection (in milliseconds)
+		 * @returns The connected socket
+		 */
+		[[nodiscard]] static SeqPacketSocket connect(const std::string &address, unsigned int timeout = 1000);
+
+		/**
+		 * Sends the given message, waiting for room in the socket's send buffer if necessary
+		 *
+		 * @param message The message to send
+		 * @param timeout How long this function may wait (in milliseconds)
+		 */
+		void send(std::string_view message, unsigned int timeout = 1000) const;
+		/**
+		 * Sends the given message without blocking
+		 *
+		 * @param message The message to send
+		 * @param handles File descriptors to pass to the peer along with the message. They stay owned by the caller.
+		 * @returns Whether the message has been sent. If not, isConnected() tells whether the socket's send buffer is
+		 * full or the peer has gone away.
+		 */
+		[[nodiscard]] bool trySend(std::string_view message, const std::vector< int > &handles = {});
+
+		/**
+		 * Waits for a message and receives it
+		 *
+		 * @param timeout How long this function may wait (in milliseconds)
+		 * @returns The received message
+		 */
+		[[nodiscard]] std::string
+			receive(unsigned int timeout = (std::numeric_limits< unsigned int >::max)()) const;
+		/**
+		 * Waits for a message and receives it along with the file descriptors passed with it
+		 *
+		 * @param handles Set to the passed file descriptors. The caller takes ownership of them.
+		 * @param timeout How long this function may wait (in milliseconds)
+		 * @returns The received message
+		 */
+		[[nodiscard]] std::string receive(std::vector< int > &handles, unsigned int timeout) const;
+		/**
+		 * Receives the next message without blocking. File descriptors passed along with the message are closed.
+		 *
+		 * @param buffer The buffer to receive the message into. It is grown to MAX_MESSAGE_SIZE if necessary.
+		 * @param message Set to the received message, which is a view into the given buffer
+		 * @param truncated If given, a message exceeding MAX_MESSAGE_SIZE is handed out truncated (with the rest of it
+		 * being dropped) and this is set to whether that has happened. Otherwise such a message makes this function
+		 * throw.
+		 * @returns Whether a message has been received. If not, isConnected() tells whether there simply was no
+		 * message available or the peer has closed the connection.
+		 */
+		[[nodiscard]] bool tryReceive(std::vector< char > &buffer, std::string_view &message,
+									  bool *truncated = nullptr);
+
+		/**
+		 * Closes the socket
+		 *
+		 * @note Calling this function multiple times is allowed. All but the first invocation are turned into no-opts.
+		 */
+		void close() noexcept;
+		/**
+		 * @returns Whether the socket is currently open
+		 */
+		[[nodiscard]] bool isOpen() const noexcept;
+		/**
+		 * @returns Whether the socket is open and the peer hasn't closed the connection (as far as is known). The
+		 * handle stays open after the peer has gone away, until close() is called.
+		 */
+		[[nodiscard]] bool isConnected() const noexcept;
+		/**
+		 * @returns The socket's handle or -1 if it is not open
+		 */
+		[[nodiscard]] int getHandle() const noexcept;
+		/**
+		 * @returns Whether the process on the other end of this socket runs as the same user as this process
+		 */
+		[[nodiscard]] bool peerIsSameUser() const noexcept;
+	};
+
+	/**
+	 * A listening AF_UNIX socket of type SOCK_SEQPACKET. Accepting a connection from it replaces the registration
+	 * handshake needed when communicating via named pipes. This class is only available on Unix.
+	 *
+	 * @see Mumble::JsonBridge::SeqPacketSocket
+	 */
+	class SeqPacketListener : NonCopyable {
+	private:
+		/**
+		 * The listening socket's handle or -1 if it is not open
+		 */
+		int m_handle = -1;
+		/**
+		 * The address the socket is listening on
+		 */
+		std::string m_address;
+
+	public:
+		/**
+		 * Creates an empty (invalid) instance
+		 */
+		SeqPacketListener() = default;
+		~SeqPacketListener();
+
+		SeqPacketListener(SeqPacketListener &&other);
+		SeqPacketListener &operator=(SeqPacketListener &&other);
+
+		/**
+		 * Starts listening at the given address. A socket file that has been left behind by a process that no longer
+		 * exists is replaced. Filesystem sockets are only accessible by the current user.
+		 *
+		 * @param address The address to listen at
+		 * @returns The listening socket (in non-blocking mode)
+		 */
+		[[nodiscard]] static SeqPacketListener listen(const std::string &address);
+
+		/**
+		 * Accepts a pending connection without blocking
+		 *
+		 * @returns The accepted connection (in non-blocking mode) or an invalid socket if there is none
+		 */
+		[[nodiscard]] SeqPacketSocket accept() const;
+
+		/**
+		 * Stops listening and removes the socket file (if any)
+		 *
+		 * @note Calling this function multiple times is allowed. All but the first invocation are turned into no-opts.
+		 */
+		void close() noexcept;
+		/**
+		 * @returns The listening socket's handle or -1 if it is not open
+		 */
+		[[nodiscard]] int getHandle() const noexcept;
+		/**
+		 * @returns The address the socket is listening on
+		 */
+		[[nodiscard]] const std::string &getAddress() const noexcept;
+
+		/**
+		 * @returns Whether this listener is currently in a valid state
+		 */
+		operator bool() const noexcept;
+	};
+#endif
+
+}; // namespace JsonBridge
+}; // namespace Mumble
+
+#endif // MUMBLE_JSONBRIDGE_SEQPACKETSOCKET_H_
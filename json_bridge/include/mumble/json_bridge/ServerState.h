@@ -0,0 +1,220 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+#ifndef MUMBLE_JSONBRIDGE_SERVERSTATE_H_
+#define MUMBLE_JSONBRIDGE_SERVERSTATE_H_
+
+#include "mumble/json_bridge/NameIndex.h"
+#include "mumble/json_bridge/NonCopyable.h"
+#include "mumble/json_bridge/ResponseWriter.h"
+#include "mumble/json_bridge/messages/APIParameter.h"
+
+#include <mumble/plugin/MumbleAPI.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+namespace Mumble {
+namespace JsonBridge {
+
+	/**
+	 * An in-memory model of the users and channels on the servers Mumble is connected to. It is maintained from the
+	 * plugin callbacks (which are invoked in Mumble's main thread) and allows read-only API calls to be answered
+	 * without a round trip to Mumble's main thread. A server is only modelled once it has been synchronized. Calls
+	 * concerning any other server (or anything the model doesn't know about) are left to the Mumble API.
+	 *
+	 * The callbacks may call into the Mumble API themselves (e.g. in order to look up the name of a new user). Should
+	 * that fail, the affected server is dropped from the model, so that the model never answers with outdated data.
+	 *
+	 * Every change to the model bumps the state version and is recorded in a bounded change log. This allows clients
+	 * to ask for what has changed since a given version (getChangesSince) instead of fetching everything again.
+	 *
+	 * The names of users and channels are indexed, so that looking them up by name doesn't require a linear scan.
+	 *
+	 * All functions are thread-safe.
+	 */
+	class ServerState : NonCopyable {
+	public:
+		/**
+		 * The default amount of changes the change log holds
+		 */
+		static constexpr std::size_t DEFAULT_CHANGE_LOG_CAPACITY = 4096;
+
+		/**
+		 * A user on a server
+		 */
+		struct User {
+			/**
+			 * The user's name
+			 */
+			std::string name;
+			/**
+			 * The channel the user is in. This is empty while the user is in between channels.
+			 */
+			std::optional< mumble_channelid_t > channel;
+		};
+
+		/**
+		 * A channel on a server
+		 */
+		struct Channel {
+			/**
+			 * The channel's name
+			 */
+			std::string name;
+		};
+
+	private:
+		/**
+		 * The model of a single server
+		 */
+		struct Server {
+			std::unordered_map< mumble_userid_t, User > users;
+			std::unordered_map< mumble_channelid_t, Channel > channels;
+			NameIndex< mumble_userid_t > userNames;
+			NameIndex< mumble_channelid_t > channelNames;
+			/**
+			 * The state version at which the server has been synchronized. Older changes aren't known for it.
+			 */
+			std::uint64_t synchronizedAt = 0;
+		};
+
+		/**
+		 * An entry of the change log: A user or channel has been added, removed or modified. The entry only tells
+		 * which one, its current state is looked up in the model.
+		 */
+		struct Change {
+			/**
+			 * The state version the change has led to
+			 */
+			std::uint64_t version;
+			mumble_connection_t connection;
+			/**
+			 * Whether the change is about a user (rather than a channel)
+			 */
+			bool isUser;
+			/**
+			 * The ID of the user or channel
+			 */
+			std::int64_t id;
+		};
+
+		/**
+		 * The API used for looking up what the callbacks don't tell
+		 */
+		const MumbleAPI &m_api;
+		/**
+		 * Guards m_servers. The callbacks take it exclusively, API calls answered from the model share it.
+		 */
+		mutable std::shared_mutex m_mutex;
+		/**
+		 * The servers that have been synchronized, indexed by their connection
+		 */
+		std::unordered_map< mumble_connection_t, Server > m_servers;
+		/**
+		 * The current state version. It is bumped by every change and only ever increases.
+		 */
+		std::uint64_t m_version = 0;
+		/**
+		 * The latest changes, ordered by their version
+		 */
+		std::deque< Change > m_changes;
+		/**
+		 * The maximum amount of entries in m_changes
+		 */
+		std::size_t m_changeLogCapacity;
+		/**
+		 * The version of the latest change that has been dropped from the change log (zero if none has been dropped)
+		 */
+		std::uint64_t m_droppedVersion = 0;
+
+		/**
+		 * @returns The model of the server behind the given connection or nullptr if it isn't modelled. m_mutex has
+		 * to be held.
+		 */
+		const Server *findServer(mumble_connection_t connection) const;
+		/**
+		 * Looks up the given user via the Mumble API and stores it in the model (if the server is modelled)
+		 */
+		void loadUser(mumble_connection_t connection, mumble_userid_t userID);
+		/**
+		 * Looks up the given channel via the Mumble API and stores it in the model (if the server is modelled)
+		 */
+		void loadChannel(mumble_connection_t connection, mumble_channelid_t channelID);
+		/**
+		 * Drops the given server from the model. This is used if a callback has failed at keeping the model up to
+		 * date.
+		 */
+		void invalidate(mumble_connection_t connection) noexcept;
+		/**
+		 * Bumps the state version and records the change of the given user or channel in the change log. m_mutex
+		 * has to be held exclusively.
+		 */
+		void recordChange(mumble_connection_t connection, bool isUser, std::int64_t id);
+		/**
+		 * Writes the return value of getChangesSince. m_mutex has to be held.
+		 */
+		void writeChanges(const Messages::Parameter_getChangesSince &call, ResponseWriter &writer) const;
+		/**
+		 * Writes the response to getServerSnapshot, if the server is modelled. What the model doesn't keep track of
+		 * (local mutes and channel descriptions) is looked up via the API. m_mutex must not be held.
+		 *
+		 * @returns Whether the call has been answered
+		 */
+		bool writeSnapshot(const Messages::Parameter_getServerSnapshot &call, ResponseWriter &writer) const;
+
+	public:
+		/**
+		 * @param api The API to use for looking up what the callbacks don't tell. It must outlive this object.
+		 * @param changeLogCapacity The maximum amount of changes the change log holds. Clients asking for changes
+		 * that have already been dropped from the log are told to resynchronize.
+		 */
+		explicit ServerState(const MumbleAPI &api, std::size_t changeLogCapacity = DEFAULT_CHANGE_LOG_CAPACITY);
+
+		// The callbacks maintaining the model. They correspond to the plugin callbacks of the same names.
+
+		void onServerSynchronized(mumble_connection_t connection) noexcept;
+		void onServerDisconnected(mumble_connection_t connection) noexcept;
+		void onUserAdded(mumble_connection_t connection, mumble_userid_t userID) noexcept;
+		void onUserRemoved(mumble_connection_t connection, mumble_userid_t userID) noexcept;
+		void onChannelAdded(mumble_connection_t connection, mumble_channelid_t channelID) noexcept;
+		void onChannelRemoved(mumble_connection_t connection, mumble_channelid_t channelID) noexcept;
+		void onChannelRenamed(mumble_connection_t connection, mumble_channelid_t channelID) noexcept;
+		void onChannelEntered(mumble_connection_t connection, mumble_userid_t userID,
+							  mumble_channelid_t previousChannelID, mumble_channelid_t newChannelID) noexcept;
+		void onChannelExited(mumble_connection_t connection, mumble_userid_t userID,
+							 mumble_channelid_t channelID) noexcept;
+
+		/**
+		 * @returns Whether the server behind the given connection is modelled
+		 */
+		[[nodiscard]] bool isSynchronized(mumble_connection_t connection) const;
+		/**
+		 * @returns The current state version
+		 */
+		[[nodiscard]] std::uint64_t getVersion() const;
+
+		/**
+		 * Answers an API call from the model, if possible. The response is written in the exact same way the API
+		 * function's writer would write it. Calls to getChangesSince are always answered. Snapshots of modelled
+		 * servers carry the state version they have been taken at.
+		 *
+		 * @param parameter The parameter of the call (which also tells which API function has been called)
+		 * @param writer The writer to write the response to
+		 * @returns Whether the call has been answered. If not, nothing has been written and the call has to be
+		 * forwarded to the Mumble API.
+		 */
+		bool write(const Messages::APIParameter &parameter, ResponseWriter &writer) const;
+	};
+
+}; // namespace JsonBridge
+}; // namespace Mumble
+
+#endif // MUMBLE_JSONBRIDGE_SERVERSTATE_H_
@@ -0,0 +1,198 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+#ifndef MUMBLE_JSONBRIDGE_SHAREDMEMORYCHANNEL_H_
+#define MUMBLE_JSONBRIDGE_SHAREDMEMORYCHANNEL_H_
+
+#include "mumble/json_bridge/NonCopyable.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Mumble {
+namespace JsonBridge {
+
+#ifdef PLATFORM_UNIX
+	struct SharedMemoryRing;
+
+	/**
+	 * A bidirectional message channel between the Bridge and a client running on the same host. It consists of a
+	 * memfd-backed memory region that holds two lock-free single-producer/single-consumer rings (one for requests and
+	 * one for responses) and two eventfds that serve as doorbells for the two sides. A doorbell is only rung if the
+	 * respective ring transitions from empty to non-empty (or if the other side is waiting for room in a full ring),
+	 * so a busy channel doesn't need any system calls at all. This class is only available on Unix.
+	 *
+	 * The Bridge creates the channel and hands its handles over to the client (see SeqPacketSocket), which then
+	 * attaches to it.
+	 */
+	class SharedMemoryChannel : NonCopyable {
+	public:
+		/**
+		 * The default size of each of the two rings in bytes
+		 */
+		static constexpr std::size_t DEFAULT_RING_SIZE = 256 * 1024;
+
+	private:
+		/**
+		 * The mapped memory region
+		 */
+		void *m_memory = nullptr;
+		/**
+		 * The size of the mapped memory region
+		 */
+		std::size_t m_mappingSize = 0;
+		/**
+		 * The handle of the memfd backing the memory region or -1
+		 */
+		int m_memoryHandle = -1;
+		/**
+		 * The handle of the eventfd that is rung in order to wake up this side of the channel or -1
+		 */
+		int m_ownDoorbell = -1;
+		/**
+		 * The handle of the eventfd that is rung in order to wake up the other side of the channel or -1
+		 */
+		int m_peerDoorbell = -1;
+		/**
+		 * The ring this side of the channel produces messages into
+		 */
+		SharedMemoryRing *m_outgoing = nullptr;
+		/**
+		 * The ring this side of the channel consumes messages from
+		 */
+		SharedMemoryRing *m_incoming = nullptr;
+		/**
+		 * The size of each ring. This is kept locally (instead of being read from the shared region whenever it is
+		 * needed), so that the other side can't trick us into accessing memory outside of the region.
+		 */
+		std::size_t m_ringSize = 0;
+		/**
+		 * The position up to which this side has produced messages into the outgoing ring
+		 */
+		std::uint64_t m_outgoingTail = 0;
+		/**
+		 * The position up to which this side has consumed messages from the incoming ring
+		 */
+		std::uint64_t m_incomingHead = 0;
+		/**
+		 * The size of the message handed out by the last call to peek() (including its record header and padding)
+		 */
+		std::uint64_t m_peekedRecordSize = 0;
+
+		/**
+		 * Maps the memory region of m_memoryHandle and sets up the ring pointers
+		 *
+		 * @param createdByBridge Whether this instance represents the Bridge's side of the channel
+		 */
+		void map(bool createdByBridge);
+		/**
+		 * Rings the given doorbell
+		 *
+		 * @param doorbell The handle of the doorbell's eventfd
+		 */
+		static void ring(int doorbell);
+
+	public:
+		/**
+		 * Creates an empty (invalid) instance
+		 */
+		SharedMemoryChannel() = default;
+		~SharedMemoryChannel();
+
+		SharedMemoryChannel(SharedMemoryChannel &&other);
+		SharedMemoryChannel &operator=(SharedMemoryChannel &&other);
+
+		/**
+		 * Creates a new channel. The returned instance represents the Bridge's side of it.
+		 *
+		 * @param ringSize The size of each ring in bytes. It is rounded up to the next power of two.
+		 * @returns The created channel
+		 */
+		[[nodiscard]] static SharedMemoryChannel create(std::size_t ringSize = DEFAULT_RING_SIZE);
+		/**
+		 * Attaches to an existing channel as the client. Ownership of the given handles is transferred to the returned
+		 * instance.
+		 *
+		 * @param handles The handles as returned by getHandles() on the Bridge's side
+		 * @returns The channel
+		 */
+		[[nodiscard]] static SharedMemoryChannel attach(const std::vector< int > &handles);
+
+		/**
+		 * @returns The handles that are needed for attaching to this channel (the memfd and both doorbells). They stay
+		 * owned by this instance.
+		 */
+		[[nodiscard]] std::vector< int > getHandles() const;
+
+		/**
+		 * Appends the given message to the outgoing ring without blocking. If the message doesn't fit, the other side
+		 * is asked to ring this side's doorbell once it has made room.
+		 *
+		 * @param message The message to send
+		 * @returns Whether the message has been sent
+		 */
+		[[nodiscard]] bool trySend(std::string_view message);
+		/**
+		 * Appends the given message to the outgoing ring, waiting for room if necessary
+		 *
+		 * @param message The message to send
+		 * @param timeout How long this function may wait (in milliseconds)
+		 */
+		void send(std::string_view message, unsigned int timeout = 1000);
+
+		/**
+		 * Gets the next message from the incoming ring without removing it. No copy is made.
+		 *
+		 * @param message Set to the next message, which is a view into the shared memory region. It stays valid until
+		 * pop() is called.
+		 * @returns Whether there is a message
+		 */
+		[[nodiscard]] bool peek(std::string_view &message);
+		/**
+		 * Removes the message returned by the last successful call to peek() from the incoming ring
+		 */
+		void pop();
+		/**
+		 * Waits for a message and takes it out of the incoming ring
+		 *
+		 * @param timeout How long this function may wait (in milliseconds)
+		 * @returns The received message
+		 */
+		[[nodiscard]] std::string receive(unsigned int timeout = (std::numeric_limits< unsigned int >::max)());
+
+		/**
+		 * @returns The handle of the eventfd that becomes readable when this side of the channel is woken up
+		 */
+		[[nodiscard]] int getDoorbellHandle() const noexcept;
+		/**
+		 * Resets this side's doorbell. This has to be done before checking the rings after having been woken up.
+		 */
+		void resetDoorbell() noexcept;
+		/**
+		 * Rings this side's own doorbell, e.g. in order to get woken up again after having left messages in the
+		 * incoming ring
+		 */
+		void wakeSelf() noexcept;
+
+		/**
+		 * @returns The size of each ring in bytes
+		 */
+		[[nodiscard]] std::size_t getRingSize() const noexcept;
+
+		/**
+		 * @returns Whether this channel is currently in a valid state
+		 */
+		operator bool() const noexcept;
+	};
+#endif
+
+}; // namespace JsonBridge
+}; // namespace Mumble
+
+#endif // MUMBLE_JSONBRIDGE_SHAREDMEMORYCHANNEL_H_
@@ -0,0 +1,313 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+#ifndef MUMBLE_JSONBRIDGE_TALKINGSTATECOALESCER_H_
+#define MUMBLE_JSONBRIDGE_TALKINGSTATECOALESCER_H_
+
+#include "mumble/json_bridge/NonCopyable.h"
+#include "mumble/json_bridge/ResponseWriter.h"
+
+#include <mumble/plugin/MumbleAPI.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace Mumble {
+namespace JsonBridge {
+
+	/**
+	 * Counters about the talking-state changes that have been pushed to clients. They can be read from any thread.
+	 */
+	struct TalkingStateStatistics {
+		/**
+		 * The amount of changes that have been recorded
+		 */
+		std::atomic< std::uint64_t > recordedChanges = std::atomic< std::uint64_t >(0);
+		/**
+		 * The amount of changes that have been superseded by a later change of the same user before being sent
+		 */
+		std::atomic< std::uint64_t > mergedChanges = std::atomic< std::uint64_t >(0);
+		/**
+		 * The amount of changes that have been dropped for lack of room
+		 */
+		std::atomic< std::uint64_t > droppedChanges = std::atomic< std::uint64_t >(0);
+		/**
+		 * The amount of frames (each carrying any amount of changes) that have been sent
+		 */
+		std::atomic< std::uint64_t > sentFrames = std::atomic< std::uint64_t >(0);
+	};
+
+	/**
+	 * A change of a user's talking state
+	 */
+	struct TalkingStateChange {
+		/**
+		 * The connection to the server the user is on
+		 */
+		mumble_connection_t connection = 0;
+		/**
+		 * The user whose talking state has changed
+		 */
+		mumble_userid_t userID = 0;
+		/**
+		 * The user's new talking state
+		 */
+		mumble_talking_state_t state = MUMBLE_TS_INVALID;
+		/**
+		 * The position of the change among all recorded changes
+		 */
+		std::uint64_t sequence = 0;
+		/**
+		 * The amount of earlier changes of the same user this change has superseded while being recorded
+		 */
+		std::uint32_t merged = 0;
+	};
+
+	/**
+	 * Records talking-state changes as they are reported by the plugin callbacks. Only the latest state of every user
+	 * is kept until the changes are collected by drain().
+	 *
+	 * Recording is wait-free, so that it doesn't slow down the thread reporting the changes: the changes are stored in
+	 * a fixed-size open-addressing table, which is probed a bounded amount of times. If no slot can be found within
+	 * these probes, the change is dropped. Slots of users that have stopped changing their state are reclaimed by
+	 * drain().
+	 *
+	 * Any amount of threads may record changes at once, but only a single thread may drain them.
+	 */
+	class TalkingStateRecorder : NonCopyable {
+	public:
+		/**
+		 * The default amount of users whose changes can be recorded at once
+		 */
+		static constexpr std::size_t DEFAULT_CAPACITY = 4096;
+
+	private:
+		/**
+		 * The key of a slot that doesn't belong to anybody
+		 */
+		static constexpr std::uint64_t EMPTY_KEY = ~std::uint64_t(0);
+		/**
+		 * The key of a slot that is being reclaimed
+		 */
+		static constexpr std::uint64_t RECLAIMING_KEY = EMPTY_KEY - 1;
+
+		/**
+		 * A slot of the table. The key identifies the connection and user the slot belongs to.
+		 */
+		struct Slot {
+			std::atomic< std::uint64_t > key = std::atomic< std::uint64_t >(EMPTY_KEY);
+			/**
+			 * The latest recorded change (the sequence number in the upper bits, the talking state in the lowest
+			 * byte)
+			 */
+			std::atomic< std::uint64_t > value = std::atomic< std::uint64_t >(0);
+			/**
+			 * Whether the latest change hasn't been drained yet
+			 */
+			std::atomic< bool > dirty = std::atomic< bool >(false);
+			/**
+			 * The amount of changes that have been superseded since the slot has been drained last
+			 */
+			std::atomic< std::uint32_t > merged = std::atomic< std::uint32_t >(0);
+			/**
+			 * The amount of threads that are currently recording into this slot. A slot is only reclaimed while this
+			 * is zero.
+			 */
+			std::atomic< std::uint32_t > writers = std::atomic< std::uint32_t >(0);
+			/**
+			 * The amount of consecutive drains that haven't found a change in this slot. This is only accessed by
+			 * drain().
+			 */
+			unsigned int idleDrains = 0;
+		};
+
+		/**
+		 * The slots (whose amount is a power of two)
+		 */
+		std::unique_ptr< Slot[] > m_slots;
+		/**
+		 * The amount of slots minus one
+		 */
+		std::size_t m_mask;
+		/**
+		 * The sequence number of the next recorded change
+		 */
+		std::atomic< std::uint64_t > m_nextSequence = std::atomic< std::uint64_t >(0);
+		/**
+		 * The amount of changes that have been dropped since the last drain
+		 */
+		std::atomic< std::uint64_t > m_dropped = std::atomic< std::uint64_t >(0);
+		/**
+		 * The statistics this recorder contributes to (may be nullptr)
+		 */
+		TalkingStateStatistics *m_statistics;
+
+		/**
+		 * Records the given value into the given slot, if it (still) belongs to the given key
+		 *
+		 * @returns Whether the value has been recorded
+		 */
+		bool write(Slot &slot, std::uint64_t key, std::uint64_t value) noexcept;
+		/**
+		 * Appends the change recorded in the given slot to the given changes, if it hasn't been drained yet
+		 */
+		static void take(Slot &slot, std::uint64_t key, std::vector< TalkingStateChange > &changes);
+		/**
+		 * Frees the given slot. A change that has been recorded while reclaiming is appended to the given changes.
+		 */
+		static void reclaim(Slot &slot, std::uint64_t key, std::vector< TalkingStateChange > &changes);
+
+	public:
+		/**
+		 * @param capacity The minimum amount of users whose changes can be recorded at once (it is rounded up to the
+		 * next power of two)
+		 * @param statistics The statistics this recorder shall contribute to (may be nullptr). The object must
+		 * outlive this recorder.
+		 */
+		explicit TalkingStateRecorder(std::size_t capacity            = DEFAULT_CAPACITY,
+									  TalkingStateStatistics *statistics = nullptr);
+
+		/**
+		 * Records the given change, replacing any change of the same user that hasn't been drained yet. This is
+		 * wait-free.
+		 *
+		 * @param connection The connection to the server the user is on
+		 * @param userID The user whose talking state has changed
+		 * @param state The user's new talking state
+		 * @returns Whether the change has been recorded. If not, it has been dropped.
+		 */
+		bool record(mumble_connection_t connection, mumble_userid_t userID, mumble_talking_state_t state) noexcept;
+		/**
+		 * Collects all changes recorded since the last call, ordered by the time they have been recorded
+		 *
+		 * @param changes The vector to append the changes to
+		 * @returns The amount of changes that have been dropped since the last call
+		 */
+		std::uint64_t drain(std::vector< TalkingStateChange > &changes);
+	};
+
+	/**
+	 * Collects the talking-state changes meant for a single client and merges the changes of the same user, so that
+	 * the client is sent compact frames containing only the latest state of each user. Frames are sent once changes
+	 * have been collected for the client's window, but never more often than the client's maximum rate.
+	 *
+	 * This class is not thread-safe.
+	 */
+	class TalkingStateCoalescer {
+	public:
+		using clock = std::chrono::steady_clock;
+
+	private:
+		/**
+		 * How long changes are collected before they are sent
+		 */
+		std::chrono::milliseconds m_window;
+		/**
+		 * The maximum amount of frames per second (zero for no limit)
+		 */
+		double m_maxRate;
+		/**
+		 * The maximum amount of users whose changes are waiting to be sent
+		 */
+		std::size_t m_maxPending;
+		/**
+		 * The changes waiting to be sent, in the order in which the users have first changed their state
+		 */
+		std::vector< TalkingStateChange > m_pending;
+		/**
+		 * The index of every user's change in m_pending, indexed by connection and user
+		 */
+		std::unordered_map< std::uint64_t, std::size_t > m_pendingIndex;
+		/**
+		 * The point in time at which the first of the pending changes has been added
+		 */
+		clock::time_point m_pendingSince;
+		/**
+		 * The point in time at which the last frame has been written
+		 */
+		clock::time_point m_lastFrame;
+		/**
+		 * The amount of changes that have been merged since the last frame
+		 */
+		std::uint64_t m_merged = 0;
+		/**
+		 * The amount of changes that have been dropped since the last frame
+		 */
+		std::uint64_t m_dropped = 0;
+		/**
+		 * The statistics this coalescer contributes to (may be nullptr)
+		 */
+		TalkingStateStatistics *m_statistics;
+
+	public:
+		/**
+		 * The default amount of users whose changes may wait for being sent to a single client
+		 */
+		static constexpr std::size_t DEFAULT_MAX_PENDING = 1024;
+
+		/**
+		 * @param window How long changes are collected before they are sent
+		 * @param maxRate The maximum amount of frames per second (zero for no limit)
+		 * @param maxPending The maximum amount of users whose changes may wait for being sent. Changes of further
+		 * users are dropped.
+		 * @param statistics The statistics this coalescer shall contribute to (may be nullptr). The object must
+		 * outlive this coalescer.
+		 */
+		explicit TalkingStateCoalescer(std::chrono::milliseconds window, double maxRate,
+									   std::size_t maxPending             = DEFAULT_MAX_PENDING,
+									   TalkingStateStatistics *statistics = nullptr);
+
+		/**
+		 * Changes how long changes are collected before they are sent. Pending changes are kept.
+		 */
+		void setWindow(std::chrono::milliseconds window) noexcept;
+		/**
+		 * Changes the maximum amount of frames per second (zero for no limit)
+		 */
+		void setMaxRate(double maxRate) noexcept;
+
+		/**
+		 * Adds the given change, replacing a pending change of the same user
+		 *
+		 * @param change The change to add. Changes have to be added in the order in which they have been recorded.
+		 * @param now The current point in time
+		 */
+		void add(const TalkingStateChange &change, clock::time_point now);
+		/**
+		 * Accounts for changes that have been dropped before they could be added. They are reported along with the
+		 * next frame.
+		 *
+		 * @param amount The amount of dropped changes
+		 */
+		void addDropped(std::uint64_t amount) noexcept;
+		/**
+		 * @param now The current point in time
+		 * @returns Whether a frame is due to be sent
+		 */
+		[[nodiscard]] bool isDue(clock::time_point now) const noexcept;
+		/**
+		 * Writes the pending changes as the response_type and response fields of a single event message and clears
+		 * them afterwards
+		 *
+		 * @param writer The writer to write to
+		 * @param now The current point in time
+		 */
+		void write(ResponseWriter &writer, clock::time_point now);
+
+		/**
+		 * @returns The amount of users whose changes are waiting to be sent
+		 */
+		[[nodiscard]] std::size_t pendingChanges() const noexcept;
+	};
+
+}; // namespace JsonBridge
+}; // namespace Mumble
+
+#endif // MUMBLE_JSONBRIDGE_TALKINGSTATECOALESCER_H_
@@ -0,0 +1,346 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+#ifndef MUMBLE_JSONBRIDGE_WORKERGROUP_H_
+#define MUMBLE_JSONBRIDGE_WORKERGROUP_H_
+
+#include "mumble/json_bridge/NonCopyable.h"
+
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+namespace Mumble {
+namespace JsonBridge {
+
+	/**
+	 * A thread-safe FIFO queue that holds a limited amount of items. Pushing to a full queue blocks until there is
+	 * room again, which makes producers slow down to the pace of their consumers. Producers that must not block use
+	 * tryPush() instead.
+	 *
+	 * The room for all items is reserved up front, so that passing items through the queue doesn't allocate memory.
+	 */
+	template< typename item_t > class BoundedQueue : NonCopyable {
+	private:
+		/**
+		 * The ring buffer holding the queued items
+		 */
+		std::vector< item_t > m_items;
+		/**
+		 * The index of the first queued item in m_items
+		 */
+		std::size_t m_head = 0;
+		/**
+		 * The amount of queued items
+		 */
+		std::size_t m_size = 0;
+		/**
+		 * Whether the queue has been closed
+		 */
+		bool m_closed = false;
+		/**
+		 * The mutex guarding all members of this queue
+		 */
+		mutable boost::mutex m_mutex;
+		/**
+		 * Notified whenever an item has been popped
+		 */
+		boost::condition_variable m_notFull;
+		/**
+		 * Notified whenever an item has been pushed
+		 */
+		boost::condition_variable m_notEmpty;
+
+		/**
+		 * Appends the given item behind the queued ones. The caller has to hold m_mutex and make sure that there is
+		 * room.
+		 */
+		void append(item_t &item) {
+			m_items[(m_head + m_size) % m_items.size()] = std::move(item);
+			m_size++;
+			m_notEmpty.notify_one();
+		}
+
+	public:
+		/**
+		 * @param capacity The maximum amount of items in this queue (at least 1)
+		 */
+		explicit BoundedQueue(std::size_t capacity) : m_items(capacity > 0 ? capacity : 1) {}
+
+		/**
+		 * Appends the given item to this queue. If the queue is full, this function blocks until there is room.
+		 *
+		 * @param item The item to append
+		 * @returns Whether the item has been appended. This is only false if the queue has been closed.
+		 */
+		bool push(item_t item) {
+			boost::unique_lock< boost::mutex > lock(m_mutex);
+
+			m_notFull.wait(lock, [this]() { return m_closed || m_size < m_items.size(); });
+
+			if (m_closed) {
+				return false;
+			}
+
+			append(item);
+
+			return true;
+		}
+
+		/**
+		 * Appends the given item to this queue unless the queue is full. This function never blocks.
+		 *
+		 * @param item The item to append. It is left untouched if it hasn't been appended.
+		 * @returns Whether the item has been appended. This is false if the queue is full or has been closed.
+		 */
+		bool tryPush(item_t &item) {
+			boost::lock_guard< boost::mutex > guard(m_mutex);
+
+			if (m_closed || m_size >= m_items.size()) {
+				return false;
+			}
+
+			append(item);
+
+			return true;
+		}
+
+		/**
+		 * Removes the first item from this queue. If the queue is empty, this function blocks until an item has been
+		 * pushed.
+		 *
+		 * @param item Set to the removed item
+		 * @param wasFull Set to whether the queue has been full before the item has been removed
+		 * @returns Whether an item has been removed. This is only false if the queue has been closed and all items
+		 * that had been pushed before have been removed already.
+		 */
+		bool pop(item_t &item, bool &wasFull) {
+			boost::unique_lock< boost::mutex > lock(m_mutex);
+
+			m_notEmpty.wait(lock, [this]() { return m_closed || m_size > 0; });
+
+			if (m_size == 0) {
+				return false;
+			}
+
+			wasFull = m_size >= m_items.size();
+
+			item   = std::move(m_items[m_head]);
+			m_head = (m_head + 1) % m_items.size();
+			m_size--;
+			m_notFull.notify_one();
+
+			return true;
+		}
+
+		/**
+		 * Closes this queue. Further pushes fail, but the items that are queued already can still be popped. Blocked
+		 * calls to push() and pop() return right away.
+		 */
+		void close() {
+			boost::lock_guard< boost::mutex > guard(m_mutex);
+
+			m_closed = true;
+			m_notFull.notify_all();
+			m_notEmpty.notify_all();
+		}
+
+		/**
+		 * @returns The amount of queued items
+		 */
+		[[nodiscard]] std::size_t size() const {
+			boost::lock_guard< boost::mutex > guard(m_mutex);
+
+			return m_size;
+		}
+	};
+
+	/**
+	 * A group of worker threads that process jobs of the given type. Every worker has a BoundedQueue of its own and
+	 * jobs are assigned to workers based on a key, so that all jobs with the same key are processed one after another
+	 * in the order in which they have been dispatched.
+	 *
+	 * Jobs can either be dispatched in a blocking way (dispatch()) or without ever blocking (tryDispatch()). The latter
+	 * holds jobs back while their worker's queue is full and is meant for threads that must not wait for the workers
+	 * (e.g. the Bridge's event loop).
+	 */
+	template< typename job_t > class WorkerGroup : NonCopyable {
+	public:
+		/**
+		 * The type of the function processing jobs. It is called from within the workers' threads.
+		 */
+		using handler_t = std::function< void(job_t &) >;
+		/**
+		 * The type of the function notifying about room for jobs that have been held back. It is called from within
+		 * the workers' threads.
+		 */
+		using room_callback_t = std::function< void() >;
+
+	private:
+		/**
+		 * The queues of the workers (one per worker)
+		 */
+		std::vector< std::unique_ptr< BoundedQueue< job_t > > > m_queues;
+		/**
+		 * The worker threads
+		 */
+		std::vector< boost::thread > m_threads;
+		/**
+		 * The jobs (along with their keys) held back by tryDispatch(), in the order in which they have been
+		 * dispatched. This must only be accessed by the thread calling tryDispatch().
+		 */
+		std::deque< std::pair< std::size_t, job_t > > m_backlog;
+		/**
+		 * Whether a job has been held back since the workers have last reported room for it
+		 */
+		std::atomic_bool m_waitingForRoom = false;
+
+		/**
+		 * Appends the given job to its worker's queue unless the queue is full
+		 *
+		 * @param key The key determining the worker
+		 * @param job The job to append. It is left untouched if it hasn't been appended.
+		 * @returns Whether the job has been appended
+		 */
+		bool tryPush(std::size_t key, job_t &job) {
+			// This is set before trying, so that a worker making room right after the attempt has failed can't go
+			// unnoticed
+			m_waitingForRoom = true;
+
+			if (!m_queues[key % m_queues.size()]->tryPush(job)) {
+				return false;
+			}
+
+			m_waitingForRoom = false;
+
+			return true;
+		}
+
+	public:
+		~WorkerGroup() { stop(); }
+
+		/**
+		 * Starts the given amount of workers. A group without workers doesn't accept any jobs.
+		 *
+		 * @param threadCount The amount of workers to start
+		 * @param queueCapacity The amount of jobs that may be waiting for every single worker
+		 * @param handler The function processing the jobs. It must not throw.
+		 * @param onRoom The function invoked whenever a worker has made room after tryDispatch() has held back a job.
+		 * The jobs are not handed over before drain() is called. It must not throw.
+		 */
+		void start(std::size_t threadCount, std::size_t queueCapacity, handler_t handler,
+				   room_callback_t onRoom = nullptr) {
+			stop();
+
+			for (std::size_t i = 0; i < threadCount; i++) {
+				m_queues.push_back(std::make_unique< BoundedQueue< job_t > >(queueCapacity));
+			}
+
+			for (std::size_t i = 0; i < threadCount; i++) {
+				m_threads.emplace_back([this, queue = m_queues[i].get(), handler, onRoom]() {
+					job_t job;
+					bool wasFull;
+					while (queue->pop(job, wasFull)) {
+						if (wasFull && onRoom && m_waitingForRoom.exchange(false)) {
+							onRoom();
+						}
+
+						handler(job);
+					}
+				});
+			}
+		}
+
+		/**
+		 * Stops all workers once they have processed the jobs that have been dispatched to them already and waits
+		 * for them to terminate. Jobs that are held back are discarded.
+		 */
+		void stop() {
+			for (std::unique_ptr< BoundedQueue< job_t > > &current : m_queues) {
+				current->close();
+			}
+
+			for (boost::thread &current : m_threads) {
+				current.join();
+			}
+
+			m_threads.clear();
+			m_queues.clear();
+			m_backlog.clear();
+			m_waitingForRoom = false;
+		}
+
+		/**
+		 * @returns Whether this group has any workers
+		 */
+		[[nodiscard]] bool isRunning() const noexcept { return !m_threads.empty(); }
+
+		/**
+		 * Hands the given job to one of the workers. If the worker's queue is full, this function blocks until there
+		 * is room. This must only be called while the group is running.
+		 *
+		 * @param key The key determining the worker
+		 * @param job The job to process
+		 * @returns Whether the job has been accepted. This is only false if the group is being stopped.
+		 */
+		bool dispatch(std::size_t key, job_t job) { return m_queues[key % m_queues.size()]->push(std::move(job)); }
+
+		/**
+		 * Hands the given job to one of the workers without blocking. If the worker's queue is full (or other jobs are
+		 * held back already), the job is held back until drain() finds room for it. Held back jobs keep the order in
+		 * which they have been dispatched. This must only be called while the group is running and always from the
+		 * same thread (the one calling drain()).
+		 *
+		 * @param key The key determining the worker
+		 * @param job The job to process
+		 * @returns Whether the job has been handed to its worker right away
+		 */
+		bool tryDispatch(std::size_t key, job_t job) {
+			if (m_backlog.empty() && tryPush(key, job)) {
+				return true;
+			}
+
+			m_backlog.emplace_back(key, std::move(job));
+
+			return false;
+		}
+
+		/**
+		 * Hands the jobs held back by tryDispatch() to their workers for as long as there is room. This must only be
+		 * called from the thread calling tryDispatch().
+		 *
+		 * @returns Whether all jobs have been handed over
+		 */
+		bool drain() {
+			while (!m_backlog.empty()) {
+				if (!tryPush(m_backlog.front().first, m_backlog.front().second)) {
+					return false;
+				}
+
+				m_backlog.pop_front();
+			}
+
+			return true;
+		}
+
+		/**
+		 * @returns Whether tryDispatch() has held back jobs that haven't been handed to their workers yet. This must
+		 * only be called from the thread calling tryDispatch().
+		 */
+		[[nodiscard]] bool hasBacklog() const noexcept { return !m_backlog.empty(); }
+	};
+
+}; // namespace JsonBridge
+}; // namespace Mumble
+
+#endif // MUMBLE_JSONBRIDGE_WORKERGROUP_H_
@@ -6,45 +6,130 @@
 #ifndef MUMBLE_JSONBRIDGE_MESSAGES_APICALL_H_
 #define MUMBLE_JSONBRIDGE_MESSAGES_APICALL_H_
 
+#include "mumble/json_bridge/ResponseWriter.h"
+#include "mumble/json_bridge/messages/APIParameter.h"
 #include "mumble/json_bridge/messages/Message.h"
 
 #include <mumble/plugin/MumbleAPI.h>
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
-#include <unordered_set>
+#include <string_view>
 
 #include <nlohmann/json.hpp>
 
 namespace Mumble {
 namespace JsonBridge {
+	class ServerState;
+
 	namespace Messages {
 
+		/**
+		 * A single scalar value (or the start of an array) as it is encountered while reading the parameter of an
+		 * API call without building a JSON DOM for it.
+		 */
+		struct ParameterValue {
+			enum class Type { INTEGER, UNSIGNED, FLOAT, BOOLEAN, STRING, ARRAY_BEGIN };
+
+			Type type;
+			std::int64_t integer          = 0;
+			std::uint64_t unsignedInteger = 0;
+			double floatingPoint          = 0;
+			bool boolean                  = false;
+			/**
+			 * The string value. It is only valid during the call to the reader, so readers have to copy it.
+			 */
+			std::string_view string;
+			/**
+			 * Whether this value is an element of the array the current parameter field consists of
+			 */
+			bool arrayElement = false;
+		};
+
+		/**
+		 * Describes an API function that can be called via an APICall
+		 */
+		struct APIFunction {
+			/**
+			 * The type of the function converting the JSON representation of the call's parameter into its typed
+			 * representation. Throws an InvalidMessageException if the parameter is invalid.
+			 */
+			using parser_t = APIParameter (*)(const nlohmann::json &parameter);
+			/**
+			 * The type of the function storing a single value of the parameter field with the given name. It
+			 * returns the index of the field or -1 if there is no such field or if the value has the wrong type.
+			 */
+			using reader_t = int (*)(APIParameter &parameter, std::string_view name, ParameterValue &value);
+			/**
+			 * The type of the function handling a call to the API function. It is given the call's parameter and
+			 * writes the response_type and response fields of the response to the call. It returns whether the
+			 * function has been executed successfully.
+			 */
+			using writer_t = bool (*)(const MumbleAPI &api, const APIParameter &parameter, ResponseWriter &writer);
+
+			/**
+			 * The name of the API function
+			 */
+			std::string_view name;
+			/**
+			 * The amount of parameters the API function takes
+			 */
+			std::size_t parameterCount;
+			/**
+			 * The function parsing the JSON representation of the parameter (nullptr if there are no parameters)
+			 */
+			parser_t parse;
+			/**
+			 * The function reading the parameter value by value (nullptr if there are no parameters)
+			 */
+			reader_t read;
+			/**
+			 * The function handling a call to the API function
+			 */
+			writer_t write;
+		};
+
+		/**
+		 * Looks up the API function with the given name. This only takes a single hash computation and string
+		 * comparison.
+		 *
+		 * @param name The name of the API function
+		 * @returns The description of the API function or nullptr if there is no such function
+		 */
+		const APIFunction *findAPIFunction(std::string_view name);
+
+		/**
+		 * Writes the 64-bit FNV-1a hash of the given channel description as a string of 16 hex digits (as used by
+		 * getServerSnapshot). Clients can compare it to tell whether a description has changed without fetching the
+		 * description itself.
+		 *
+		 * @param writer The writer to write the hash to
+		 * @param description The channel description
+		 */
+		void writeDescriptionHash(ResponseWriter &writer, std::string_view description);
+
 		/**
 		 * This class represents a message that requests the Bridge to call a specific Mumble API function
 		 */
 		class APICall : public Message {
 		private:
 			/**
-			 * The name of the API function that should be called
+			 * The API function that should be called
 			 */
-			std::string m_functionName;
+			const APIFunction *m_function;
 			/**
 			 * A reference to a MumbleAPI
 			 */
 			const MumbleAPI &m_api;
 			/**
-			 * The **body** of the API-call request message
-			 */
-			nlohmann::json m_msg;
-
-			/**
-			 * A set of all available API function names
+			 * The model of the server state that read-only calls are answered from, if possible (may be nullptr)
 			 */
-			static const std::unordered_set< std::string > s_allFunctions;
+			const ServerState *m_serverState;
 			/**
-			 * A set of the names of all API functions that don't take any parameter
+			 * The parameter the API function is called with
 			 */
-			static const std::unordered_set< std::string > s_noParamFunctions;
+			APIParameter m_parameter;
 
 		public:
 			/**
@@ -54,16 +139,33 @@ namespace JsonBridge {
 			 * @param api A **reference** to a MumbleAPI. The lifetime of this API must not be shorter than the one of
 			 * this instance
 			 * @param msg The **body** of the API-call request message
+			 * @param serverState The model of the server state to answer read-only calls from (may be nullptr). It
+			 * must outlive this instance.
+			 */
+			explicit APICall(const MumbleAPI &api, const nlohmann::json &msg,
+							 const ServerState *serverState = nullptr);
+			/**
+			 * Creates an instance of this Message from an already parsed parameter.
+			 *
+			 * @param api A **reference** to a MumbleAPI. The lifetime of this API must not be shorter than the one of
+			 * this instance
+			 * @param function The API function that should be called
+			 * @param parameter The parameter to call the function with. It has to be valid for the given function.
+			 * @param serverState The model of the server state to answer read-only calls from (may be nullptr). It
+			 * must outlive this instance.
 			 */
-			explicit APICall(const MumbleAPI &api, const nlohmann::json &msg);
+			explicit APICall(const MumbleAPI &api, const APIFunction &function, APIParameter parameter,
+							 const ServerState *serverState = nullptr);
 
 			/**
-			 * Executes the requested API function
+			 * Executes the requested API function and writes the response_type and response fields of the message
+			 * describing the status of the invocation (including potential return values). The surrounding object
+			 * (and e.g. the Bridge's secret) has to be written by the caller.
 			 *
-			 * @returns JSON representation of the message describing the status of the invocation (including potential
-			 * return values)
+			 * @param writer The writer to write the response to
+			 * @returns Whether the API function has been executed successfully
 			 */
-			nlohmann::json execute(const std::string &bridgeSecret) const;
+			bool write(ResponseWriter &writer) const;
 		};
 	}; // namespace Messages
 };     // namespace JsonBridge
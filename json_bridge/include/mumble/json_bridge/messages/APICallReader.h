@@ -0,0 +1,68 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+#ifndef MUMBLE_JSONBRIDGE_MESSAGES_APICALLREADER_H_
+#define MUMBLE_JSONBRIDGE_MESSAGES_APICALLREADER_H_
+
+#include "mumble/json_bridge/Encoding.h"
+#include "mumble/json_bridge/messages/APICall.h"
+#include "mumble/json_bridge/messages/APIParameter.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <nlohmann/json.hpp>
+
+namespace Mumble {
+namespace JsonBridge {
+	namespace Messages {
+
+		/**
+		 * An API-call request message that has been read without building a JSON DOM for it
+		 */
+		struct APICallRequest {
+			/**
+			 * The value of the message's client_id field (if any)
+			 */
+			std::optional< std::uint64_t > clientID;
+			/**
+			 * The value of the message's secret field (if any)
+			 */
+			std::optional< std::string > secret;
+			/**
+			 * The request ID to echo in the response (may be null)
+			 */
+			nlohmann::json requestID;
+			/**
+			 * The API function that should be called
+			 */
+			const APIFunction *function = nullptr;
+			/**
+			 * The parameter the API function should be called with
+			 */
+			APIParameter parameter;
+		};
+
+		/**
+		 * Reads the given message straight into an APICallRequest, if it is an API-call request. The message's fields
+		 * are validated while reading, so no JSON DOM has to be built for the message.
+		 *
+		 * Only well-formed requests are read. For anything else (including messages that aren't API-call requests
+		 * and messages with fields this function doesn't know about) false is returned and the message has to go
+		 * through the regular parsing, which also produces the appropriate error messages.
+		 *
+		 * @param message The (unparsed) message
+		 * @param request The request to read the message into
+		 * @param encoding The encoding of the message
+		 * @returns Whether the message has been read successfully
+		 */
+		bool readAPICall(std::string_view message, APICallRequest &request, Encoding encoding = Encoding::JSON);
+	}; // namespace Messages
+};     // namespace JsonBridge
+};     // namespace Mumble
+
+#endif // MUMBLE_JSONBRIDGE_MESSAGES_APICALLREADER_H_
@@ -0,0 +1,366 @@
+// Copyright 2021-2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+// This file was auto-generated by scripts/generate_APICall_implementation.py. DO NOT EDIT MANUALLY!
+
+#ifndef MUMBLE_JSONBRIDGE_MESSAGES_APIPARAMETER_H_
+#define MUMBLE_JSONBRIDGE_MESSAGES_APIPARAMETER_H_
+
+#include <mumble/plugin/MumbleAPI.h>
+
+#include <cstdint>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace Mumble {
+namespace JsonBridge {
+	namespace Messages {
+
+		/**
+		 * The parameter of the API function freeMemory
+		 */
+		struct Parameter_freeMemory {
+			void *pointer = {};
+		};
+
+		/**
+		 * The parameter of the API function isConnectionSynchronized
+		 */
+		struct Parameter_isConnectionSynchronized {
+			mumble_connection_t connection = {};
+		};
+
+		/**
+		 * The parameter of the API function getLocalUserID
+		 */
+		struct Parameter_getLocalUserID {
+			mumble_connection_t connection = {};
+		};
+
+		/**
+		 * The parameter of the API function getUserName
+		 */
+		struct Parameter_getUserName {
+			mumble_connection_t connection = {};
+			mumble_userid_t user_id = {};
+		};
+
+		/**
+		 * The parameter of the API function getChannelName
+		 */
+		struct Parameter_getChannelName {
+			mumble_connection_t connection = {};
+			mumble_channelid_t channel_id = {};
+		};
+
+		/**
+		 * The parameter of the API function getAllUsers
+		 */
+		struct Parameter_getAllUsers {
+			mumble_connection_t connection = {};
+		};
+
+		/**
+		 * The parameter of the API function getAllChannels
+		 */
+		struct Parameter_getAllChannels {
+			mumble_connection_t connection = {};
+		};
+
+		/**
+		 * The parameter of the API function getChannelOfUser
+		 */
+		struct Parameter_getChannelOfUser {
+			mumble_connection_t connection = {};
+			mumble_userid_t user_id = {};
+		};
+
+		/**
+		 * The parameter of the API function getUsersInChannel
+		 */
+		struct Parameter_getUsersInChannel {
+			mumble_connection_t connection = {};
+			mumble_channelid_t channel_id = {};
+		};
+
+		/**
+		 * The parameter of the API function isUserLocallyMuted
+		 */
+		struct Parameter_isUserLocallyMuted {
+			mumble_connection_t connection = {};
+			mumble_userid_t user_id = {};
+		};
+
+		/**
+		 * The parameter of the API function getUserHash
+		 */
+		struct Parameter_getUserHash {
+			mumble_connection_t connection = {};
+			mumble_userid_t user_id = {};
+		};
+
+		/**
+		 * The parameter of the API function getServerHash
+		 */
+		struct Parameter_getServerHash {
+			mumble_connection_t connection = {};
+		};
+
+		/**
+		 * The parameter of the API function getUserComment
+		 */
+		struct Parameter_getUserComment {
+			mumble_connection_t connection = {};
+			mumble_userid_t user_id = {};
+		};
+
+		/**
+		 * The parameter of the API function getChannelDescription
+		 */
+		struct Parameter_getChannelDescription {
+			mumble_connection_t connection = {};
+			mumble_channelid_t channel_id = {};
+		};
+
+		/**
+		 * The parameter of the API function requestLocalUserTransmissionMode
+		 */
+		struct Parameter_requestLocalUserTransmissionMode {
+			mumble_transmission_mode_t transmission_mode = {};
+		};
+
+		/**
+		 * The parameter of the API function requestUserMove
+		 */
+		struct Parameter_requestUserMove {
+			mumble_connection_t connection = {};
+			mumble_userid_t user_id = {};
+			mumble_channelid_t channel_id = {};
+			std::string password = {};
+		};
+
+		/**
+		 * The parameter of the API function requestMicrophoneActivationOvewrite
+		 */
+		struct Parameter_requestMicrophoneActivationOvewrite {
+			bool activate = {};
+		};
+
+		/**
+		 * The parameter of the API function requestLocalMute
+		 */
+		struct Parameter_requestLocalMute {
+			mumble_connection_t connection = {};
+			mumble_userid_t user_id = {};
+			bool muted = {};
+		};
+
+		/**
+		 * The parameter of the API function requestLocalUserMute
+		 */
+		struct Parameter_requestLocalUserMute {
+			bool muted = {};
+		};
+
+		/**
+		 * The parameter of the API function requestLocalUserDeaf
+		 */
+		struct Parameter_requestLocalUserDeaf {
+			bool deafened = {};
+		};
+
+		/**
+		 * The parameter of the API function requestSetLocalUserComment
+		 */
+		struct Parameter_requestSetLocalUserComment {
+			mumble_connection_t connection = {};
+			std::string comment = {};
+		};
+
+		/**
+		 * The parameter of the API function findUserByName
+		 */
+		struct Parameter_findUserByName {
+			mumble_connection_t connection = {};
+			std::string user_name = {};
+		};
+
+		/**
+		 * The parameter of the API function findUserByName_noexcept
+		 */
+		struct Parameter_findUserByName_noexcept {
+			mumble_connection_t connection = {};
+			std::string user_name = {};
+		};
+
+		/**
+		 * The parameter of the API function findChannelByName
+		 */
+		struct Parameter_findChannelByName {
+			mumble_connection_t connection = {};
+			std::string channel_name = {};
+		};
+
+		/**
+		 * The parameter of the API function findChannelByName_noexcept
+		 */
+		struct Parameter_findChannelByName_noexcept {
+			mumble_connection_t connection = {};
+			std::string channel_name = {};
+		};
+
+		/**
+		 * The parameter of the API function getMumbleSetting_bool
+		 */
+		struct Parameter_getMumbleSetting_bool {
+			mumble_settings_key_t key = {};
+		};
+
+		/**
+		 * The parameter of the API function getMumbleSetting_int
+		 */
+		struct Parameter_getMumbleSetting_int {
+			mumble_settings_key_t key = {};
+		};
+
+		/**
+		 * The parameter of the API function getMumbleSetting_double
+		 */
+		struct Parameter_getMumbleSetting_double {
+			mumble_settings_key_t key = {};
+		};
+
+		/**
+		 * The parameter of the API function getMumbleSetting_string
+		 */
+		struct Parameter_getMumbleSetting_string {
+			mumble_settings_key_t key = {};
+		};
+
+		/**
+		 * The parameter of the API function setMumbleSetting_bool
+		 */
+		struct Parameter_setMumbleSetting_bool {
+			mumble_settings_key_t key = {};
+			bool value = {};
+		};
+
+		/**
+		 * The parameter of the API function setMumbleSetting_int
+		 */
+		struct Parameter_setMumbleSetting_int {
+			mumble_settings_key_t key = {};
+			int value = {};
+		};
+
+		/**
+		 * The parameter of the API function setMumbleSetting_double
+		 */
+		struct Parameter_setMumbleSetting_double {
+			mumble_settings_key_t key = {};
+			double value = {};
+		};
+
+		/**
+		 * The parameter of the API function setMumbleSetting_string
+		 */
+		struct Parameter_setMumbleSetting_string {
+			mumble_settings_key_t key = {};
+			std::string value = {};
+		};
+
+		/**
+		 * The parameter of the API function sendData
+		 */
+		struct Parameter_sendData {
+			mumble_connection_t connection = {};
+			std::vector< mumble_userid_t > receivers = {};
+			std::vector< uint8_t > data = {};
+			std::string data_id = {};
+		};
+
+		/**
+		 * The parameter of the API function log
+		 */
+		struct Parameter_log {
+			std::string message = {};
+		};
+
+		/**
+		 * The parameter of the API function log_noexcept
+		 */
+		struct Parameter_log_noexcept {
+			std::string message = {};
+		};
+
+		/**
+		 * The parameter of the API function playSample
+		 */
+		struct Parameter_playSample {
+			std::string sample_path = {};
+		};
+
+		/**
+		 * The parameter of the API function getServerSnapshot
+		 */
+		struct Parameter_getServerSnapshot {
+			mumble_connection_t connection = {};
+		};
+
+		/**
+		 * The parameter of the API function getChangesSince
+		 */
+		struct Parameter_getChangesSince {
+			mumble_connection_t connection = {};
+			uint64_t version = {};
+		};
+
+		/**
+		 * The parameter of the API function findUsersByName
+		 */
+		struct Parameter_findUsersByName {
+			mumble_connection_t connection = {};
+			std::string user_name = {};
+			bool case_sensitive = {};
+			bool prefix = {};
+		};
+
+		/**
+		 * The parameter of the API function findChannelsByName
+		 */
+		struct Parameter_findChannelsByName {
+			mumble_connection_t connection = {};
+			std::string channel_name = {};
+			bool case_sensitive = {};
+			bool prefix = {};
+		};
+
+		/**
+		 * The parameter of any API function. Functions that don't take any parameter use std::monostate.
+		 */
+		using APIParameter = std::variant< std::monostate, Parameter_freeMemory, Parameter_isConnectionSynchronized,
+										   Parameter_getLocalUserID, Parameter_getUserName, Parameter_getChannelName,
+										   Parameter_getAllUsers, Parameter_getAllChannels, Parameter_getChannelOfUser,
+										   Parameter_getUsersInChannel, Parameter_isUserLocallyMuted,
+										   Parameter_getUserHash, Parameter_getServerHash, Parameter_getUserComment,
+										   Parameter_getChannelDescription, Parameter_requestLocalUserTransmissionMode,
+										   Parameter_requestUserMove, Parameter_requestMicrophoneActivationOvewrite,
+										   Parameter_requestLocalMute, Parameter_requestLocalUserMute,
+										   Parameter_requestLocalUserDeaf, Parameter_requestSetLocalUserComment,
+										   Parameter_findUserByName, Parameter_findUserByName_noexcept,
+										   Parameter_findChannelByName, Parameter_findChannelByName_noexcept,
+										   Parameter_getMumbleSetting_bool, Parameter_getMumbleSetting_int,
+										   Parameter_getMumbleSetting_double, Parameter_getMumbleSetting_string,
+										   Parameter_setMumbleSetting_bool, Parameter_setMumbleSetting_int,
+										   Parameter_setMumbleSetting_double, Parameter_setMumbleSetting_string,
+										   Parameter_sendData, Parameter_log, Parameter_log_noexcept,
+										   Parameter_playSample, Parameter_getServerSnapshot, Parameter_getChangesSince,
+										   Parameter_findUsersByName, Parameter_findChannelsByName >;
+	}; // namespace Messages
+};     // namespace JsonBridge
+};     // namespace Mumble
+
+#endif // MUMBLE_JSONBRIDGE_MESSAGES_APIPARAMETER_H_
@@ -0,0 +1,75 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+#ifndef MUMBLE_JSONBRIDGE_MESSAGES_BATCH_H_
+#define MUMBLE_JSONBRIDGE_MESSAGES_BATCH_H_
+
+#include "mumble/json_bridge/ResponseWriter.h"
+#include "mumble/json_bridge/messages/Message.h"
+
+#include <mumble/plugin/MumbleAPI.h>
+
+#include <string>
+
+#include <nlohmann/json.hpp>
+
+namespace Mumble {
+namespace JsonBridge {
+	class ServerState;
+
+	namespace Messages {
+
+		/**
+		 * This class represents a message that requests the Bridge to call multiple Mumble API functions one after
+		 * another. The whole batch is authenticated once and answered with a single response.
+		 */
+		class Batch : public Message {
+		private:
+			/**
+			 * A reference to a MumbleAPI
+			 */
+			const MumbleAPI &m_api;
+			/**
+			 * The model of the server state that read-only calls are answered from, if possible (may be nullptr)
+			 */
+			const ServerState *m_serverState;
+			/**
+			 * The **bodies** of the API-call requests that make up this batch
+			 */
+			nlohmann::json m_calls;
+			/**
+			 * Whether the remaining calls should be skipped once a call has failed
+			 */
+			bool m_stopOnError = false;
+
+		public:
+			/**
+			 * Creates an instance of this Message. If the provided message doesn't fulfill
+			 * the requirements of this class, this constructor will throw an InvalidMessageException. The individual
+			 * calls are only validated when executing the batch.
+			 *
+			 * @param api A **reference** to a MumbleAPI. The lifetime of this API must not be shorter than the one of
+			 * this instance
+			 * @param msg The **body** of the batch message
+			 * @param serverState The model of the server state to answer read-only calls from (may be nullptr). It
+			 * must outlive this instance.
+			 */
+			explicit Batch(const MumbleAPI &api, const nlohmann::json &msg, const ServerState *serverState = nullptr);
+
+			/**
+			 * Executes the requested API functions in the given order and writes the response_type and response
+			 * fields of the message describing the status of every invocation (including potential return values). A
+			 * call that turns out to be invalid doesn't fail the whole batch, but is reported as an error in its entry
+			 * of the response.
+			 *
+			 * @param writer The writer to write the response to
+			 */
+			void write(ResponseWriter &writer) const;
+		};
+	}; // namespace Messages
+};     // namespace JsonBridge
+};     // namespace Mumble
+
+#endif // MUMBLE_JSONBRIDGE_MESSAGES_BATCH_H_
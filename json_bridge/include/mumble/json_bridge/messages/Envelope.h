@@ -0,0 +1,68 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+#ifndef MUMBLE_JSONBRIDGE_MESSAGES_ENVELOPE_H_
+#define MUMBLE_JSONBRIDGE_MESSAGES_ENVELOPE_H_
+
+#include "mumble/json_bridge/Arena.h"
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#include <nlohmann/json.hpp>
+
+namespace Mumble {
+namespace JsonBridge {
+	namespace Messages {
+
+		/**
+		 * The top-level fields of a message that decide whether the message is worth parsing at all. The strings are
+		 * views that only stay valid as long as the message and the arena it has been read with.
+		 */
+		struct Envelope {
+			/**
+			 * The value of the message's message_type field (empty if there is none)
+			 */
+			std::string_view messageType;
+			/**
+			 * The value of the message's client_id field, if it is an unsigned integer
+			 */
+			std::optional< std::uint64_t > clientID;
+			/**
+			 * The value of the message's secret field, if it is a string
+			 */
+			std::optional< std::string_view > secret;
+			/**
+			 * Whether the message has a secret field at all
+			 */
+			bool hasSecret = false;
+			/**
+			 * The value of the message's request_id field, if it is a string or an integer (null otherwise)
+			 */
+			nlohmann::json requestID;
+
+			/**
+			 * @returns Whether the message claims to be a registration
+			 */
+			bool isRegistration() const;
+		};
+
+		/**
+		 * Reads the envelope of the given JSON message without looking into the message body (or any other field the
+		 * envelope doesn't consist of). Unlike the envelope, the body isn't validated either, so even a message whose
+		 * envelope has been read successfully can turn out to be malformed when it is parsed.
+		 *
+		 * @param message The (unparsed) message
+		 * @param envelope The envelope to read the message's envelope into
+		 * @param arena The arena to decode strings containing escape sequences into
+		 * @returns Whether the message is a JSON object whose envelope fields could be read
+		 */
+		bool readEnvelope(std::string_view message, Envelope &envelope, Arena &arena);
+	}; // namespace Messages
+};     // namespace JsonBridge
+};     // namespace Mumble
+
+#endif // MUMBLE_JSONBRIDGE_MESSAGES_ENVELOPE_H_
@@ -0,0 +1,539 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+#ifndef MUMBLE_JSONBRIDGE_MESSAGES_JSONTEXTREADER_H_
+#define MUMBLE_JSONBRIDGE_MESSAGES_JSONTEXTREADER_H_
+
+#include "mumble/json_bridge/Arena.h"
+
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <system_error>
+
+namespace Mumble {
+namespace JsonBridge {
+	namespace Messages {
+
+		/**
+		 * Reads JSON text and feeds it into a SAX handler. Unlike nlohmann::json's parser this doesn't allocate any
+		 * memory: Strings are handed out as views into the text and only strings containing escape sequences are
+		 * decoded (into an Arena). The views stay valid until the text goes away or the arena is reset.
+		 *
+		 * The handler provides the callbacks of nlohmann::json_sax (taking std::string_view for strings and keys and
+		 * no size hints) plus skipValue(), which is asked after every key. If it returns true, the key's value is
+		 * skipped without being validated or handed to the handler at all.
+		 *
+		 * The same text is accepted as by nlohmann::json, except for numbers that don't fit into 64 bits, a
+		 * leading byte order mark and documents that are nested deeper than any request. Reading those fails,
+		 * which makes them go through the regular parsing.
+		 */
+		template< typename handler_t > class JSONTextReader {
+		public:
+			explicit JSONTextReader(std::string_view text, handler_t &reader, Arena &arena)
+				: m_pos(text.data()), m_end(text.data() + text.size()), m_reader(reader), m_arena(arena) {}
+
+			/**
+			 * @returns Whether the text consists of a single JSON value that has been read successfully
+			 */
+			bool read() {
+				if (!readValue(0)) {
+					return false;
+				}
+
+				skipWhitespace();
+
+				return m_pos == m_end;
+			}
+
+		private:
+			/**
+			 * Requests are never nested deeper than this. Anything deeper is left to the regular parsing.
+			 */
+			static constexpr int MAX_DEPTH = 8;
+
+			const char *m_pos;
+			const char *m_end;
+			handler_t &m_reader;
+			Arena &m_arena;
+
+			static bool isDigit(char c) noexcept { return c >= '0' && c <= '9'; }
+
+			void skipDigits() noexcept {
+				while (m_pos != m_end && isDigit(*m_pos)) {
+					m_pos++;
+				}
+			}
+
+			void skipWhitespace() noexcept {
+				while (m_pos != m_end && (*m_pos == ' ' || *m_pos == '\t' || *m_pos == '\n' || *m_pos == '\r')) {
+					m_pos++;
+				}
+			}
+
+			/**
+			 * Skips whitespace and the given character, if that is what follows
+			 */
+			bool consume(char expected) noexcept {
+				skipWhitespace();
+
+				if (m_pos == m_end || *m_pos != expected) {
+					return false;
+				}
+
+				m_pos++;
+				return true;
+			}
+
+			bool consumeLiteral(std::string_view literal) noexcept {
+				if (static_cast< std::size_t >(m_end - m_pos) < literal.size()
+					|| std::string_view(m_pos, literal.size()) != literal) {
+					return false;
+				}
+
+				m_pos += literal.size();
+				return true;
+			}
+
+			bool readValue(int depth) {
+				skipWhitespace();
+
+				if (m_pos == m_end) {
+					return false;
+				}
+
+				switch (*m_pos) {
+					case '{':
+						return readObject(depth + 1);
+					case '[':
+						return readArray(depth + 1);
+					case '"': {
+						std::string_view str;
+						return readString(str) && m_reader.string(str);
+					}
+					case 't':
+						return consumeLiteral("true") && m_reader.boolean(true);
+					case 'f':
+						return consumeLiteral("false") && m_reader.boolean(false);
+					case 'n':
+						return consumeLiteral("null") && m_reader.null();
+					default:
+						return readNumber();
+				}
+			}
+
+			bool readObject(int depth) {
+				if (depth > MAX_DEPTH || !m_reader.start_object()) {
+					return false;
+				}
+				m_pos++;
+
+				if (consume('}')) {
+					return m_reader.end_object();
+				}
+
+				do {
+					skipWhitespace();
+					if (m_pos == m_end || *m_pos != '"') {
+						return false;
+					}
+
+					std::string_view key;
+					if (!readString(key) || !m_reader.key(key) || !consume(':')) {
+						return false;
+					}
+
+					if (m_reader.skipValue() ? !skipValue() : !readValue(depth)) {
+						return false;
+					}
+				} while (consume(','));
+
+				return consume('}') && m_reader.end_object();
+			}
+
+			bool readArray(int depth) {
+				if (depth > MAX_DEPTH || !m_reader.start_array()) {
+					return false;
+				}
+				m_pos++;
+
+				if (consume(']')) {
+					return m_reader.end_array();
+				}
+
+				do {
+					if (!readValue(depth)) {
+						return false;
+					}
+				} while (consume(','));
+
+				return consume(']') && m_reader.end_array();
+			}
+
+			/**
+			 * Skips the value starting at the current position. Only the structure of the value is looked at, as far
+			 * as needed for finding its end.
+			 */
+			bool skipValue() noexcept {
+				skipWhitespace();
+
+				// Containers don't need to be read recursively, so there is no limit on how deep they may be nested
+				std::size_t depth = 0;
+				while (m_pos != m_end) {
+					switch (*m_pos) {
+						case '"':
+							if (!skipString()) {
+								return false;
+							}
+							if (depth == 0) {
+								return true;
+							}
+							break;
+						case '{':
+						case '[':
+							depth++;
+							m_pos++;
+							break;
+						case '}':
+						case ']':
+							if (depth == 0) {
+								// This closes the surrounding object
+								return true;
+							}
+
+							depth--;
+							m_pos++;
+							if (depth == 0) {
+								return true;
+							}
+							break;
+						case ',':
+						case ' ':
+						case '\t':
+						case '\n':
+						case '\r':
+							if (depth == 0) {
+								return true;
+							}
+
+							m_pos++;
+							break;
+						default:
+							m_pos++;
+							break;
+					}
+				}
+
+				return depth == 0;
+			}
+
+			/**
+			 * Skips the string starting at the current position (which has to be its opening quote)
+			 */
+			bool skipString() noexcept {
+				m_pos++;
+
+				while (true) {
+					const char *quote =
+						static_cast< const char * >(std::memchr(m_pos, '"', static_cast< std::size_t >(m_end - m_pos)));
+
+					if (!quote) {
+						return false;
+					}
+
+					// The quote is escaped if it is preceded by an odd amount of backslashes
+					const char *backslashes = quote;
+					while (backslashes != m_pos && backslashes[-1] == '\\') {
+						backslashes--;
+					}
+
+					m_pos = quote + 1;
+
+					if ((quote - backslashes) % 2 == 0) {
+						return true;
+					}
+				}
+			}
+
+			bool readNumber() {
+				const char *start = m_pos;
+
+				if (*m_pos == '-') {
+					m_pos++;
+				}
+
+				if (m_pos == m_end || !isDigit(*m_pos)) {
+					return false;
+				}
+
+				// Leading zeros are not allowed
+				if (*m_pos == '0') {
+					m_pos++;
+				} else {
+					skipDigits();
+				}
+
+				bool isFloat = false;
+				if (m_pos != m_end && *m_pos == '.') {
+					m_pos++;
+					if (m_pos == m_end || !isDigit(*m_pos)) {
+						return false;
+					}
+					skipDigits();
+
+					isFloat = true;
+				}
+				if (m_pos != m_end && (*m_pos == 'e' || *m_pos == 'E')) {
+					m_pos++;
+					if (m_pos != m_end && (*m_pos == '+' || *m_pos == '-')) {
+						m_pos++;
+					}
+					if (m_pos == m_end || !isDigit(*m_pos)) {
+						return false;
+					}
+					skipDigits();
+
+					isFloat = true;
+				}
+
+				// Numbers that don't fit are reported as errors rather than being turned into floats
+				if (isFloat) {
+					double value;
+					std::from_chars_result result = std::from_chars(start, m_pos, value);
+
+					return result.ec == std::errc() && m_reader.number_float(value);
+				} else if (*start == '-') {
+					std::int64_t value;
+					std::from_chars_result result = std::from_chars(start, m_pos, value);
+
+					return result.ec == std::errc() && m_reader.number_integer(value);
+				} else {
+					std::uint64_t value;
+					std::from_chars_result result = std::from_chars(start, m_pos, value);
+
+					return result.ec == std::errc() && m_reader.number_unsigned(value);
+				}
+			}
+
+			/**
+			 * Reads the string starting at the current position (which has to be its opening quote)
+			 */
+			bool readString(std::string_view &str) {
+				m_pos++;
+
+				const char *start = m_pos;
+				bool escaped      = false;
+
+				while (true) {
+					if (m_pos == m_end) {
+						return false;
+					}
+
+					unsigned char current = static_cast< unsigned char >(*m_pos);
+
+					if (current == '"') {
+						break;
+					} else if (current == '\\') {
+						// The escape sequence itself is validated while decoding the string
+						if (m_end - m_pos < 2) {
+							return false;
+						}
+
+						m_pos += 2;
+						escaped = true;
+					} else if (current < 0x20) {
+						// Control characters have to be escaped
+						return false;
+					} else if (current < 0x80) {
+						m_pos++;
+					} else if (!skipUTF8Sequence()) {
+						return false;
+					}
+				}
+
+				const char *end = m_pos;
+				m_pos++;
+
+				if (!escaped) {
+					str = std::string_view(start, static_cast< std::size_t >(end - start));
+					return true;
+				}
+
+				return unescape(start, end, str);
+			}
+
+			/**
+			 * Decodes the given content of a string that contains escape sequences
+			 */
+			bool unescape(const char *begin, const char *end, std::string_view &str) {
+				// Escape sequences are never shorter than what they stand for
+				char *buffer = static_cast< char * >(m_arena.allocate(static_cast< std::size_t >(end - begin), 1));
+				char *out    = buffer;
+
+				for (const char *in = begin; in != end;) {
+					if (*in != '\\') {
+						*out++ = *in++;
+						continue;
+					}
+
+					in++;
+					switch (*in++) {
+						case '"':
+							*out++ = '"';
+							break;
+						case '\\':
+							*out++ = '\\';
+							break;
+						case '/':
+							*out++ = '/';
+							break;
+						case 'b':
+							*out++ = '\b';
+							break;
+						case 'f':
+							*out++ = '\f';
+							break;
+						case 'n':
+							*out++ = '\n';
+							break;
+						case 'r':
+							*out++ = '\r';
+							break;
+						case 't':
+							*out++ = '\t';
+							break;
+						case 'u': {
+							std::uint32_t codePoint;
+							if (!readHex(in, end, codePoint)) {
+								return false;
+							}
+							in += 4;
+
+							if (codePoint >= 0xD800 && codePoint <= 0xDBFF) {
+								// A high surrogate has to be followed by an escaped low surrogate
+								std::uint32_t low;
+								if (end - in < 6 || in[0] != '\\' || in[1] != 'u' || !readHex(in + 2, end, low)
+									|| low < 0xDC00 || low > 0xDFFF) {
+									return false;
+								}
+								in += 6;
+
+								codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+							} else if (codePoint >= 0xDC00 && codePoint <= 0xDFFF) {
+								return false;
+							}
+
+							out = encodeUTF8(codePoint, out);
+							break;
+						}
+						default:
+							return false;
+					}
+				}
+
+				str = std::string_view(buffer, static_cast< std::size_t >(out - buffer));
+				return true;
+			}
+
+			/**
+			 * Skips the UTF-8 sequence starting at the current position, if it is a valid one
+			 */
+			bool skipUTF8Sequence() noexcept {
+				unsigned char lead = static_cast< unsigned char >(*m_pos);
+
+				// The allowed range of the first continuation byte depends on the lead byte, which rules out
+				// overlong encodings, surrogates and code points beyond U+10FFFF
+				std::size_t length;
+				unsigned char min = 0x80;
+				unsigned char max = 0xBF;
+				if (lead >= 0xC2 && lead <= 0xDF) {
+					length = 2;
+				} else if (lead >= 0xE0 && lead <= 0xEF) {
+					length = 3;
+					if (lead == 0xE0) {
+						min = 0xA0;
+					} else if (lead == 0xED) {
+						max = 0x9F;
+					}
+				} else if (lead >= 0xF0 && lead <= 0xF4) {
+					length = 4;
+					if (lead == 0xF0) {
+						min = 0x90;
+					} else if (lead == 0xF4) {
+						max = 0x8F;
+					}
+				} else {
+					return false;
+				}
+
+				if (static_cast< std::size_t >(m_end - m_pos) < length) {
+					return false;
+				}
+
+				for (std::size_t i = 1; i < length; i++) {
+					unsigned char current = static_cast< unsigned char >(m_pos[i]);
+
+					if (current < min || current > max) {
+						return false;
+					}
+
+					min = 0x80;
+					max = 0xBF;
+				}
+
+				m_pos += length;
+				return true;
+			}
+
+			static bool readHex(const char *in, const char *end, std::uint32_t &value) noexcept {
+				if (end - in < 4) {
+					return false;
+				}
+
+				value = 0;
+				for (int i = 0; i < 4; i++) {
+					char current = in[i];
+
+					value <<= 4;
+					if (current >= '0' && current <= '9') {
+						value |= static_cast< std::uint32_t >(current - '0');
+					} else if (current >= 'a' && current <= 'f') {
+						value |= static_cast< std::uint32_t >(current - 'a' + 10);
+					} else if (current >= 'A' && current <= 'F') {
+						value |= static_cast< std::uint32_t >(current - 'A' + 10);
+					} else {
+						return false;
+					}
+				}
+
+				return true;
+			}
+
+			static char *encodeUTF8(std::uint32_t codePoint, char *out) noexcept {
+				if (codePoint < 0x80) {
+					*out++ = static_cast< char >(codePoint);
+				} else if (codePoint < 0x800) {
+					*out++ = static_cast< char >(0xC0 | (codePoint >> 6));
+					*out++ = static_cast< char >(0x80 | (codePoint & 0x3F));
+				} else if (codePoint < 0x10000) {
+					*out++ = static_cast< char >(0xE0 | (codePoint >> 12));
+					*out++ = static_cast< char >(0x80 | ((codePoint >> 6) & 0x3F));
+					*out++ = static_cast< char >(0x80 | (codePoint & 0x3F));
+				} else {
+					*out++ = static_cast< char >(0xF0 | (codePoint >> 18));
+					*out++ = static_cast< char >(0x80 | ((codePoint >> 12) & 0x3F));
+					*out++ = static_cast< char >(0x80 | ((codePoint >> 6) & 0x3F));
+					*out++ = static_cast< char >(0x80 | (codePoint & 0x3F));
+				}
+
+				return out;
+			}
+		};
+	}; // namespace Messages
+};     // namespace JsonBridge
+};     // namespace Mumble
+
+#endif // MUMBLE_JSONBRIDGE_MESSAGES_JSONTEXTREADER_H_
@@ -36,7 +36,7 @@ namespace JsonBridge {
 		/**
 		 * An enum holding the possible message types
 		 */
-		enum class MessageType { REGISTRATION, API_CALL, DISCONNECT };
+		enum class MessageType { REGISTRATION, API_CALL, DISCONNECT, BATCH, SUBSCRIBE, UNSUBSCRIBE };
 
 		/**
 		 * @return A unique string representation of the give MessageType. If no such
@@ -67,6 +67,15 @@ namespace JsonBridge {
 		 * @see Mumble::JsonBridge::Messages::MessageType
 		 */
 		MessageType parseBasicFormat(const nlohmann::json &msg);
+		/**
+		 * Extracts the optional request ID from the given message. A client may use any string or integer as request
+		 * ID, which is then echoed in the response to the message. This allows clients to have multiple requests in
+		 * flight and to tell which response belongs to which request.
+		 *
+		 * @param msg The JSON representation of the message
+		 * @returns The request ID or null if the message doesn't have one
+		 */
+		nlohmann::json parseRequestID(const nlohmann::json &msg);
 
 		/**
 		 * This class represents a message received by the Mumble-JSON-Bridge
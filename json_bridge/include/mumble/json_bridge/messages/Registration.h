@@ -6,6 +6,8 @@
 #ifndef MUMBLE_JSONBRIDGE_MESSAGES_REGISTRATION_H_
 #define MUMBLE_JSONBRIDGE_MESSAGES_REGISTRATION_H_
 
+#include "mumble/json_bridge/Encoding.h"
+#include "mumble/json_bridge/Framing.h"
 #include "mumble/json_bridge/messages/Message.h"
 
 #include <string>
@@ -29,6 +31,34 @@ namespace JsonBridge {
 			 * The extracted secret the client has provided
 			 */
 			std::string m_secret;
+			/**
+			 * The framing the client has requested for the messages exchanged with it. If the client didn't request
+			 * any, this is Framing::NONE.
+			 */
+			Framing m_framing = Framing::NONE;
+			/**
+			 * Whether the client has explicitly requested a framing
+			 */
+			bool m_framingRequested = false;
+			/**
+			 * Whether the client has requested to exchange messages via shared memory instead of named pipes. Such a
+			 * registration has to be sent via the Bridge's socket and doesn't need a pipe path or secret.
+			 */
+			bool m_sharedMemory = false;
+			/**
+			 * Whether the client keeps exchanging messages via the connection it has established with the Bridge's
+			 * socket already. Such a registration only serves to negotiate the encoding.
+			 */
+			bool m_socket = false;
+			/**
+			 * The encoding the client has requested for the messages exchanged with it. If the client didn't request
+			 * any, this is Encoding::JSON.
+			 */
+			Encoding m_encoding = Encoding::JSON;
+			/**
+			 * Whether the client has explicitly requested an encoding
+			 */
+			bool m_encodingRequested = false;
 
 			/**
 			 * Parses the given message and populates the members of this instance accordingly. If the message
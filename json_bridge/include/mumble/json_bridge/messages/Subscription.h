@@ -0,0 +1,60 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+#ifndef MUMBLE_JSONBRIDGE_MESSAGES_SUBSCRIPTION_H_
+#define MUMBLE_JSONBRIDGE_MESSAGES_SUBSCRIPTION_H_
+
+#include "mumble/json_bridge/Event.h"
+#include "mumble/json_bridge/messages/Message.h"
+
+#include <chrono>
+#include <optional>
+
+#include <nlohmann/json.hpp>
+
+namespace Mumble {
+namespace JsonBridge {
+	namespace Messages {
+
+		/**
+		 * This class represents a message for subscribing to (or unsubscribing from) the events the Bridge pushes to
+		 * its clients
+		 */
+		class Subscription : public Message {
+		public:
+			/**
+			 * The extracted topics to subscribe to (or to unsubscribe from)
+			 */
+			EventTopics m_topics;
+			/**
+			 * How long talking-state changes shall be collected before they are sent, if the client has asked for a
+			 * window of its own. This is only considered when subscribing.
+			 */
+			std::optional< std::chrono::milliseconds > m_talkingStateWindow;
+			/**
+			 * The maximum amount of talking-state frames per second (zero for no limit), if the client has asked for
+			 * a rate of its own. This is only considered when subscribing.
+			 */
+			std::optional< double > m_maxTalkingStateRate;
+
+			/**
+			 * Parses the given message and populates the members of this instance accordingly. If the message
+			 * doesn't fulfill the requirements, this constructor will throw an InvalidMessageException.
+			 *
+			 * @param type Either MessageType::SUBSCRIBE or MessageType::UNSUBSCRIBE
+			 * @param msg The **body** of the subscription message
+			 */
+			explicit Subscription(MessageType type, const nlohmann::json &msg);
+
+			/**
+			 * @returns Whether this message subscribes to its topics (as opposed to unsubscribing from them)
+			 */
+			bool isSubscribe() const noexcept;
+		};
+	}; // namespace Messages
+};     // namespace JsonBridge
+};     // namespace Mumble
+
+#endif // MUMBLE_JSONBRIDGE_MESSAGES_SUBSCRIPTION_H_
@@ -0,0 +1,233 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+#ifndef MUMBLE_JSONBRIDGE_TRANSPORTS_NAMEDPIPETRANSPORT_H_
+#define MUMBLE_JSONBRIDGE_TRANSPORTS_NAMEDPIPETRANSPORT_H_
+
+#include "mumble/json_bridge/Framing.h"
+#include "mumble/json_bridge/NamedPipe.h"
+#include "mumble/json_bridge/transports/Transport.h"
+
+#include <deque>
+#include <filesystem>
+#include <string>
+
+#include <boost/thread/thread.hpp>
+
+namespace Mumble {
+namespace JsonBridge {
+	namespace Transports {
+
+		/**
+		 * A connection consisting of (up to) two named pipes: one that is written to and one that is read from. As
+		 * the Bridge's pipe is shared by all clients, the Bridge's end of such a connection is write-only - messages
+		 * sent by clients are received by the NamedPipeListener instead. Named pipes are streams, so messages
+		 * written to them have to be framed.
+		 *
+		 * @see Mumble::JsonBridge::Transports::NamedPipeListener
+		 */
+		class NamedPipeConnection : public Connection {
+		private:
+			/**
+			 * The long-lived writer for the pipe messages are sent to
+			 */
+			PipeWriter m_writer;
+			/**
+			 * The pipe messages are received from. This is invalid for write-only connections.
+			 */
+			NamedPipe m_reader;
+			/**
+			 * The framing applied by send()
+			 */
+			Framing m_framing = Framing::NONE;
+			/**
+			 * Messages that have been received but not handed out yet
+			 */
+			std::deque< std::string > m_receivedMessages;
+			/**
+			 * Messages that have been discarded while being received but not been reported via tryReceive() yet
+			 */
+			std::deque< DiscardedFrame > m_discardedMessages;
+			/**
+			 * The message handed out by the last call to tryReceive()
+			 */
+			std::string m_currentMessage;
+#ifdef PLATFORM_UNIX
+			/**
+			 * The loop this connection is registered with or nullptr
+			 */
+			EventLoop *m_loop = nullptr;
+			/**
+			 * The callback invoked when the connection becomes readable
+			 */
+			std::function< void() > m_onReadable;
+			/**
+			 * The callback invoked when the connection becomes writable again
+			 */
+			std::function< void() > m_onWritable;
+			/**
+			 * Whether the caller wants to be notified about writability
+			 */
+			bool m_writeInterest = false;
+			/**
+			 * Whether the caller wants to be notified about readability
+			 */
+			bool m_readInterest = true;
+			/**
+			 * The write handle that is currently being watched or -1
+			 */
+			int m_watchedWriteHandle = -1;
+			/**
+			 * The read handle that is currently being watched or -1
+			 */
+			int m_watchedReadHandle = -1;
+
+			/**
+			 * Makes sure that the writer's current handle is watched if (and only if) writability is of interest
+			 */
+			void updateWriteWatch();
+			/**
+			 * Makes sure that the reader's handle is watched if (and only if) readability is of interest
+			 */
+			void updateReadWatch();
+#endif
+
+		public:
+			/**
+			 * Creates a write-only connection (as used by the Bridge for writing to its clients)
+			 *
+			 * @param writePath The path to the pipe to write to. The pipe is not opened before it is used.
+			 * @param framing The framing applied by send()
+			 */
+			explicit NamedPipeConnection(const std::filesystem::path &writePath, Framing framing = Framing::NONE);
+			/**
+			 * Creates a bidirectional connection (as used by clients)
+			 *
+			 * @param writePath The path to the pipe to write to (i.e. the Bridge's pipe)
+			 * @param readPipe The pipe to read from. It is switched into long-lived reader mode.
+			 * @param framing The framing applied by send()
+			 */
+			explicit NamedPipeConnection(const std::filesystem::path &writePath, NamedPipe readPipe,
+										 Framing framing = Framing::NONE);
+			~NamedPipeConnection();
+
+			/**
+			 * Tries to open the pipe written to without waiting for it to become available. This is not necessary,
+			 * but it avoids the overhead of opening the pipe for the first message.
+			 *
+			 * @returns Whether the pipe is open now
+			 */
+			bool open();
+			/**
+			 * @returns The path of the pipe written to
+			 */
+			[[nodiscard]] const std::filesystem::path &getWritePath() const noexcept;
+
+			[[nodiscard]] Status trySend(std::string_view data, std::size_t &sent) override;
+			void send(std::string_view message, unsigned int timeout = 1000) override;
+
+			[[nodiscard]] Status tryReceive(std::string_view &message) override;
+			[[nodiscard]] std::string
+				receive(unsigned int timeout = (std::numeric_limits< unsigned int >::max)()) override;
+
+			void watch(EventLoop &loop, std::function< void() > onReadable,
+					   std::function< void() > onWritable) override;
+			void setWriteInterest(bool interested) override;
+			void setReadInterest(bool interested) override;
+			void unwatch() noexcept override;
+		};
+
+		/**
+		 * The Bridge's named pipe that all clients write their messages to. As the pipe can't tell who has written a
+		 * message, this listener never hands out connections. Instead clients have to register (and identify
+		 * themselves in every message), after which the Bridge opens a NamedPipeConnection to the client's pipe.
+		 *
+		 * @see Mumble::JsonBridge::Transports::NamedPipeConnection
+		 */
+		class NamedPipeListener : public Listener {
+		private:
+			/**
+			 * The path at which the pipe is created
+			 */
+			std::filesystem::path m_path;
+			/**
+			 * The pipe messages are received from
+			 */
+			NamedPipe m_pipe;
+			/**
+			 * The loop this listener runs in or nullptr if it isn't started
+			 */
+			EventLoop *m_loop = nullptr;
+			/**
+			 * The maximum size of a single message
+			 */
+			std::size_t m_maxMessageSize;
+			/**
+			 * The callback received messages are handed to
+			 */
+			message_callback_t m_onMessages;
+			/**
+			 * The callback discarded messages are reported to
+			 */
+			discard_callback_t m_onDiscarded;
+
+			/**
+			 * Reports the messages m_pipe has discarded since the last call
+			 */
+			void reportDiscardedMessages();
+#ifdef PLATFORM_UNIX
+			/**
+			 * The timer that fires if the remainder of a partially received message doesn't arrive in time
+			 */
+			EventLoop::timer_id_t m_partialMessageTimer;
+			/**
+			 * Whether m_partialMessageTimer is currently active
+			 */
+			bool m_partialMessageTimerActive = false;
+			/**
+			 * Whether m_pipe is currently being watched for messages
+			 */
+			bool m_readInterest = false;
+
+			/**
+			 * Called by the loop whenever there is data available on m_pipe
+			 */
+			void onReadable();
+#else
+			/**
+			 * The thread that waits for data on m_pipe and hands it over to the loop. This is needed as there is no
+			 * way to wait on the pipe and the loop's wakeup at the same time.
+			 */
+			boost::thread m_readerThread;
+
+			/**
+			 * Reads messages from m_pipe and posts them to the loop until m_readerThread is interrupted
+			 */
+			void readPipe();
+#endif
+
+		public:
+			/**
+			 * @param path The path at which the pipe shall be created once the listener is started
+			 * @param maxMessageSize The maximum size of a single message. Larger messages are discarded while they are
+			 * being received.
+			 */
+			explicit NamedPipeListener(const std::filesystem::path &path,
+									   std::size_t maxMessageSize = FrameReader::DEFAULT_MAX_FRAME_SIZE);
+			~NamedPipeListener();
+
+			void start(EventLoop &loop, connection_callback_t onConnection, message_callback_t onMessages,
+					   discard_callback_t onDiscarded) override;
+			void stop() noexcept override;
+			void setReadInterest(bool interested) override;
+
+			[[nodiscard]] std::string getAddress() const override;
+		};
+
+	}; // namespace Transports
+};     // namespace JsonBridge
+};     // namespace Mumble
+
+#endif // MUMBLE_JSONBRIDGE_TRANSPORTS_NAMEDPIPETRANSPORT_H_
@@ -0,0 +1,97 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+#ifndef MUMBLE_JSONBRIDGE_TRANSPORTS_SHAREDMEMORYTRANSPORT_H_
+#define MUMBLE_JSONBRIDGE_TRANSPORTS_SHAREDMEMORYTRANSPORT_H_
+
+#include "mumble/json_bridge/SharedMemoryChannel.h"
+#include "mumble/json_bridge/transports/Transport.h"
+
+#include <memory>
+
+namespace Mumble {
+namespace JsonBridge {
+	namespace Transports {
+
+#ifdef PLATFORM_UNIX
+		/**
+		 * A connection that exchanges messages through a SharedMemoryChannel. As there is no way of telling whether
+		 * the other end of the channel is still around, the connection the channel has been set up through (the
+		 * control connection) is kept open alongside it. Messages that still arrive via the control connection are
+		 * received as well. This class is only available on Unix.
+		 *
+		 * Received messages are handed out as views into the shared memory and are only removed from the channel once
+		 * the next message is received, so no copy is made.
+		 */
+		class SharedMemoryConnection : public Connection {
+		private:
+			/**
+			 * The connection the channel has been set up through
+			 */
+			std::unique_ptr< Connection > m_control;
+			/**
+			 * The channel messages are exchanged through
+			 */
+			SharedMemoryChannel m_channel;
+			/**
+			 * Whether the last message handed out by tryReceive() is still in the channel
+			 */
+			bool m_peeked = false;
+			/**
+			 * Whether the control connection has been closed
+			 */
+			bool m_closed = false;
+			/**
+			 * The loop this connection is registered with or nullptr
+			 */
+			EventLoop *m_loop = nullptr;
+			/**
+			 * Whether the caller wants to be notified about writability
+			 */
+			bool m_writeInterest = false;
+			/**
+			 * Whether the caller wants to be notified about readability
+			 */
+			bool m_readInterest = true;
+
+			/**
+			 * Removes the message handed out by the last call to tryReceive() from the channel (if any)
+			 */
+			void releasePeekedMessage();
+
+		public:
+			/**
+			 * @param control The connection the channel has been set up through. It must not be watched anymore.
+			 * @param channel This end of the channel
+			 */
+			explicit SharedMemoryConnection(std::unique_ptr< Connection > control, SharedMemoryChannel channel);
+			~SharedMemoryConnection();
+
+			/**
+			 * @returns The channel messages are exchanged through
+			 */
+			[[nodiscard]] const SharedMemoryChannel &getChannel() const noexcept;
+
+			[[nodiscard]] Status trySend(std::string_view data, std::size_t &sent) override;
+			void send(std::string_view message, unsigned int timeout = 1000) override;
+
+			[[nodiscard]] Status tryReceive(std::string_view &message) override;
+			[[nodiscard]] std::string
+				receive(unsigned int timeout = (std::numeric_limits< unsigned int >::max)()) override;
+
+			void watch(EventLoop &loop, std::function< void() > onReadable,
+					   std::function< void() > onWritable) override;
+			void setWriteInterest(bool interested) override;
+			void setReadInterest(bool interested) override;
+			void unwatch() noexcept override;
+			void resumeReading() noexcept override;
+		};
+#endif
+
+	}; // namespace Transports
+};     // namespace JsonBridge
+};     // namespace Mumble
+
+#endif // MUMBLE_JSONBRIDGE_TRANSPORTS_SHAREDMEMORYTRANSPORT_H_
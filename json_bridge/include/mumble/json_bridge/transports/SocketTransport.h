@@ -0,0 +1,141 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+#ifndef MUMBLE_JSONBRIDGE_TRANSPORTS_SOCKETTRANSPORT_H_
+#define MUMBLE_JSONBRIDGE_TRANSPORTS_SOCKETTRANSPORT_H_
+
+#include "mumble/json_bridge/SeqPacketSocket.h"
+#include "mumble/json_bridge/transports/Transport.h"
+
+#include <string>
+#include <vector>
+
+namespace Mumble {
+namespace JsonBridge {
+	namespace Transports {
+
+#ifdef PLATFORM_UNIX
+		/**
+		 * A connection via a SOCK_SEQPACKET socket. The connection itself identifies the client, so there is no need
+		 * for registering or framing. This class is only available on Unix.
+		 *
+		 * @see Mumble::JsonBridge::Transports::SocketListener
+		 */
+		class SocketConnection : public Connection {
+		private:
+			/**
+			 * The wrapped socket
+			 */
+			SeqPacketSocket m_socket;
+			/**
+			 * The buffer messages are received into
+			 */
+			std::vector< char > m_receiveBuffer;
+			/**
+			 * The envelope of the message that tryReceive() has discarded last
+			 */
+			std::string m_discardedEnvelope;
+			/**
+			 * The loop this connection is registered with or nullptr
+			 */
+			EventLoop *m_loop = nullptr;
+			/**
+			 * Whether the caller wants to be notified about writability
+			 */
+			bool m_writeInterest = false;
+			/**
+			 * Whether the caller wants to be notified about readability
+			 */
+			bool m_readInterest = true;
+
+			/**
+			 * @returns The events the socket has to be watched for, according to m_writeInterest and m_readInterest
+			 */
+			[[nodiscard]] std::uint32_t getWatchedEvents() const noexcept;
+
+		public:
+			/**
+			 * @param socket The (connected) socket to wrap
+			 */
+			explicit SocketConnection(SeqPacketSocket socket);
+			~SocketConnection();
+
+			/**
+			 * Waits for a message and receives it along with the handles passed with it
+			 *
+			 * @param handles Set to the passed handles. The caller takes ownership of them.
+			 * @param timeout How long this function may wait (in milliseconds)
+			 * @returns The received message
+			 */
+			[[nodiscard]] std::string receive(std::vector< int > &handles, unsigned int timeout);
+
+			[[nodiscard]] Status trySend(std::string_view data, std::size_t &sent) override;
+			void send(std::string_view message, unsigned int timeout = 1000) override;
+
+			[[nodiscard]] Status tryReceive(std::string_view &message) override;
+			[[nodiscard]] std::string
+				receive(unsigned int timeout = (std::numeric_limits< unsigned int >::max)()) override;
+
+			void watch(EventLoop &loop, std::function< void() > onReadable,
+					   std::function< void() > onWritable) override;
+			void setWriteInterest(bool interested) override;
+			void setReadInterest(bool interested) override;
+			void unwatch() noexcept override;
+
+			[[nodiscard]] bool canPassHandles() const noexcept override;
+			[[nodiscard]] Status trySendWithHandles(std::string_view message,
+													 const std::vector< int > &handles) override;
+		};
+
+		/**
+		 * A listening SOCK_SEQPACKET socket. Every accepted connection is handed out as a SocketConnection.
+		 * Connections from other users are rejected. This class is only available on Unix.
+		 *
+		 * @see Mumble::JsonBridge::Transports::SocketConnection
+		 */
+		class SocketListener : public Listener {
+		private:
+			/**
+			 * The address to listen at
+			 */
+			std::string m_address;
+			/**
+			 * The listening socket
+			 */
+			SeqPacketListener m_listener;
+			/**
+			 * The loop this listener runs in or nullptr if it isn't started
+			 */
+			EventLoop *m_loop = nullptr;
+			/**
+			 * The callback accepted connections are handed to
+			 */
+			connection_callback_t m_onConnection;
+
+			/**
+			 * Called by the loop whenever there are pending connections
+			 */
+			void onAcceptable();
+
+		public:
+			/**
+			 * @param address The address to listen at once the listener is started
+			 */
+			explicit SocketListener(const std::string &address);
+			~SocketListener();
+
+			void start(EventLoop &loop, connection_callback_t onConnection, message_callback_t onMessages,
+					   discard_callback_t onDiscarded) override;
+			void stop() noexcept override;
+
+			[[nodiscard]] std::string getAddress() const override;
+		};
+#endif
+
+	}; // namespace Transports
+};     // namespace JsonBridge
+};     // namespace Mumble
+
+#endif // MUMBLE_JSONBRIDGE_TRANSPORTS_SOCKETTRANSPORT_H_
@@ -0,0 +1,228 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+#ifndef MUMBLE_JSONBRIDGE_TRANSPORTS_TRANSPORT_H_
+#define MUMBLE_JSONBRIDGE_TRANSPORTS_TRANSPORT_H_
+
+#include "mumble/json_bridge/EventLoop.h"
+#include "mumble/json_bridge/Framing.h"
+#include "mumble/json_bridge/NonCopyable.h"
+
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Mumble {
+namespace JsonBridge {
+	namespace Transports {
+
+		/**
+		 * The possible outcomes of a non-blocking transport operation
+		 */
+		enum class Status {
+			/**
+			 * The operation has completed
+			 */
+			OK,
+			/**
+			 * The operation can't make any (further) progress right now. It should be retried once the connection
+			 * has reported to be ready again.
+			 */
+			WOULD_BLOCK,
+			/**
+			 * There currently is nobody on the other end of the connection, but somebody might show up again later
+			 * on. There is no way of getting notified about that, so the operation has to be retried periodically.
+			 */
+			NO_PEER,
+			/**
+			 * The connection has been closed for good
+			 */
+			CLOSED,
+			/**
+			 * A message has been received but discarded, as it exceeded the maximum message size
+			 */
+			DISCARDED
+		};
+
+		/**
+		 * A connection between the Bridge and one of its clients. The same interface is used on both ends of the
+		 * connection: the Bridge uses the non-blocking functions along with the readiness notifications of its
+		 * EventLoop, whereas clients usually use the blocking ones.
+		 *
+		 * @see Mumble::JsonBridge::Transports::Listener
+		 */
+		class Connection : NonCopyable {
+		public:
+			virtual ~Connection() = default;
+
+			/**
+			 * Sends as much of the given data as possible without blocking. Stream-based transports may send only a
+			 * part of it, in which case the caller is expected to frame its messages. Message-based transports send
+			 * the given data as one message and either send all of it or nothing.
+			 *
+			 * @param data The data to send
+			 * @param sent Set to the amount of bytes that have been sent
+			 * @returns Status::OK if all of the data has been sent. Otherwise the reason for why it hasn't.
+			 */
+			[[nodiscard]] virtual Status trySend(std::string_view data, std::size_t &sent) = 0;
+			/**
+			 * Sends the given message (framed as necessary), waiting for the connection to become writable if needed
+			 *
+			 * @param message The message to send
+			 * @param timeout How long this function may wait (in milliseconds)
+			 */
+			virtual void send(std::string_view message, unsigned int timeout = 1000) = 0;
+
+			/**
+			 * Receives the next message without blocking
+			 *
+			 * @param message Set to the received message. This is a view into memory owned by the connection that
+			 * stays valid until the next call to tryReceive() or receive(). If the message has been discarded, this is
+			 * set to its envelope instead (see DiscardedFrame).
+			 * @returns Status::OK if a message has been received, Status::WOULD_BLOCK if there is none available,
+			 * Status::DISCARDED if the received message has been too large or Status::CLOSED if the other end has
+			 * closed the connection
+			 */
+			[[nodiscard]] virtual Status tryReceive(std::string_view &message) = 0;
+			/**
+			 * Waits for a message and receives it
+			 *
+			 * @param timeout How long this function may wait (in milliseconds)
+			 * @returns The received message
+			 */
+			[[nodiscard]] virtual std::string
+				receive(unsigned int timeout = (std::numeric_limits< unsigned int >::max)()) = 0;
+
+			/**
+			 * Registers this connection with the given loop, so that the given callbacks are invoked (in the loop's
+			 * thread) whenever the connection is ready for receiving or sending (if sending has been asked for via
+			 * setWriteInterest()).
+			 *
+			 * @param loop The loop to register with. It must outlive this connection or unwatch() has to be called
+			 * before it is destroyed.
+			 * @param onReadable Invoked when tryReceive() might yield a message
+			 * @param onWritable Invoked when trySend() might make progress again
+			 */
+			virtual void watch(EventLoop &loop, std::function< void() > onReadable,
+							   std::function< void() > onWritable) = 0;
+			/**
+			 * Sets whether the onWritable callback given to watch() should be invoked once the connection can make
+			 * progress with sending again. This is meant to be enabled after trySend() has returned
+			 * Status::WOULD_BLOCK and to be disabled once everything has been sent.
+			 *
+			 * @param interested Whether to be notified about writability
+			 */
+			virtual void setWriteInterest(bool interested) = 0;
+			/**
+			 * Sets whether the onReadable callback given to watch() should be invoked. Readability is of interest by
+			 * default. Disabling it makes the watcher stop receiving from this connection for a while (e.g. in order
+			 * to let a backlog drain) without keeping the loop busy. Once it is enabled again, the callback is invoked
+			 * if there is anything to receive.
+			 *
+			 * @param interested Whether to be notified about readability
+			 */
+			virtual void setReadInterest(bool interested) = 0;
+			/**
+			 * Undoes watch()
+			 *
+			 * @note Calling this function multiple times is allowed. All but the first invocation are turned into
+			 * no-opts.
+			 */
+			virtual void unwatch() noexcept = 0;
+			/**
+			 * Has to be called if the watcher stops calling tryReceive() before it has returned Status::WOULD_BLOCK
+			 * (e.g. in order to not starve other connections). Connections whose readiness is edge-triggered make
+			 * sure that the onReadable callback is invoked again.
+			 */
+			virtual void resumeReading() noexcept {}
+
+#ifdef PLATFORM_UNIX
+			/**
+			 * @returns Whether this connection is able to pass handles (file descriptors) to the other end. This
+			 * function is only available on Unix.
+			 */
+			[[nodiscard]] virtual bool canPassHandles() const noexcept { return false; }
+			/**
+			 * Sends the given message along with the given handles without blocking. This function is only available
+			 * on Unix.
+			 *
+			 * @param message The message to send
+			 * @param handles The handles to pass to the other end. They stay owned by the caller.
+			 * @returns Status::OK if the message has been sent. Otherwise the reason for why it hasn't.
+			 *
+			 * @see canPassHandles()
+			 */
+			[[nodiscard]] virtual Status trySendWithHandles(std::string_view message,
+															const std::vector< int > &handles);
+#endif
+		};
+
+		/**
+		 * The Bridge's well-known endpoint of a transport that clients initially talk to. Depending on the transport,
+		 * a listener either hands out a new Connection for every client that connects to it, or it receives messages
+		 * from clients that aren't connected (yet), which then have to identify themselves within these messages.
+		 *
+		 * @see Mumble::JsonBridge::Transports::Connection
+		 */
+		class Listener : NonCopyable {
+		public:
+			/**
+			 * The type of callback a listener hands new connections to
+			 */
+			using connection_callback_t = std::function< void(std::unique_ptr< Connection > connection) >;
+			/**
+			 * The type of callback a listener hands messages to that don't belong to any connection. The messages
+			 * are views that are only valid during the callback.
+			 */
+			using message_callback_t = std::function< void(const std::vector< std::string_view > &messages) >;
+			/**
+			 * The type of callback a listener reports messages to that don't belong to any connection and that have
+			 * been discarded, as they exceeded the maximum message size
+			 */
+			using discard_callback_t = std::function< void(const DiscardedFrame &frame) >;
+
+			virtual ~Listener() = default;
+
+			/**
+			 * Starts listening. All callbacks are invoked in the thread running the given loop.
+			 *
+			 * @param loop The loop to use for waiting for clients
+			 * @param onConnection Invoked for every client that has connected
+			 * @param onMessages Invoked for messages that have been received from clients that aren't connected
+			 * @param onDiscarded Invoked for messages from clients that aren't connected that have been discarded
+			 */
+			virtual void start(EventLoop &loop, connection_callback_t onConnection, message_callback_t onMessages,
+							   discard_callback_t onDiscarded) = 0;
+			/**
+			 * Stops listening. Connections handed out before stay intact.
+			 *
+			 * @note Calling this function multiple times is allowed. All but the first invocation are turned into
+			 * no-opts.
+			 */
+			virtual void stop() noexcept = 0;
+			/**
+			 * Sets whether messages from clients that aren't connected should be received. Disabling it makes the
+			 * listener leave these messages where they are until it is enabled again. New connections are still
+			 * handed out. Listeners that only hand out connections ignore this.
+			 *
+			 * @param interested Whether to receive messages
+			 */
+			virtual void setReadInterest(bool interested);
+
+			/**
+			 * @returns A human-readable description of where this listener is listening
+			 */
+			[[nodiscard]] virtual std::string getAddress() const = 0;
+		};
+
+	}; // namespace Transports
+};     // namespace JsonBridge
+};     // namespace Mumble
+
+#endif // MUMBLE_JSONBRIDGE_TRANSPORTS_TRANSPORT_H_
@@ -0,0 +1,76 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+#include "mumble/json_bridge/Arena.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace Mumble {
+namespace JsonBridge {
+
+	Arena::Arena(std::size_t initialSize) : m_initialSize(initialSize) {}
+
+	Arena::~Arena() = default;
+
+	void Arena::grow(std::size_t minSize) {
+		// Every block is as large as all previous ones combined, so that a growing arena needs few blocks
+		std::size_t size = std::max(m_blocks.empty() ? m_initialSize : m_capacity, minSize);
+
+		m_blocks.push_back({ std::make_unique< std::byte[] >(size), size });
+		m_capacity += size;
+		m_used = 0;
+	}
+
+	void *Arena::do_allocate(std::size_t bytes, std::size_t alignment) {
+		if (!m_blocks.empty()) {
+			Block &block = m_blocks.back();
+
+			std::uintptr_t base    = reinterpret_cast< std::uintptr_t >(block.memory.get());
+			std::uintptr_t aligned = (base + m_used + alignment - 1) & ~(static_cast< std::uintptr_t >(alignment) - 1);
+
+			if (aligned + bytes <= base + block.size) {
+				m_used = aligned + bytes - base;
+
+				return reinterpret_cast< void * >(aligned);
+			}
+		}
+
+		// Make sure that the allocation fits even if the new block's memory needs to be aligned
+		grow(bytes + alignment);
+
+		return do_allocate(bytes, alignment);
+	}
+
+	void Arena::do_deallocate(void *, std::size_t, std::size_t) {
+		// Memory is only given back by reset()
+	}
+
+	bool Arena::do_is_equal(const std::pmr::memory_resource &other) const noexcept { return this == &other; }
+
+	void Arena::reset() {
+		if (m_blocks.size() > 1) {
+			// Merge the blocks, so that the next message of the same size fits into a single one
+			std::size_t capacity = m_capacity;
+
+			m_blocks.clear();
+			m_blocks.push_back({ std::make_unique< std::byte[] >(capacity), capacity });
+		}
+
+		m_used = 0;
+	}
+
+	std::size_t Arena::getCapacity() const noexcept { return m_capacity; }
+
+	std::size_t Arena::getBlockCount() const noexcept { return m_blocks.size(); }
+
+	Arena &Arena::forThisThread() {
+		thread_local Arena s_arena;
+
+		return s_arena;
+	}
+
+}; // namespace JsonBridge
+}; // namespace Mumble
@@ -4,12 +4,20 @@
 // source tree.
 
 #include "mumble/json_bridge/Bridge.h"
+#include "mumble/json_bridge/Arena.h"
+#include "mumble/json_bridge/BufferPool.h"
+#include "mumble/json_bridge/MumbleAssert.h"
 #include "mumble/json_bridge/NamedPipe.h"
 #include "mumble/json_bridge/Util.h"
 
+#include "mumble/json_bridge/messages/Envelope.h"
 #include "mumble/json_bridge/messages/Message.h"
 #include "mumble/json_bridge/messages/Registration.h"
+#include "mumble/json_bridge/transports/NamedPipeTransport.h"
+#include "mumble/json_bridge/transports/SharedMemoryTransport.h"
+#include "mumble/json_bridge/transports/SocketTransport.h"
 
+#include <chrono>
 #include <exception>
 #include <filesystem>
 #include <iostream>
@@ -32,198 +40,1583 @@ namespace JsonBridge {
 
 	client_id_t Bridge::s_nextClientID = 0;
 	const std::filesystem::path Bridge::s_pipePath(std::filesystem::path(PIPE_DIR) / ".mumble-json-bridge");
+#ifdef PLATFORM_UNIX
+	const std::string Bridge::s_socketAddress(PIPE_DIR ".mumble-json-bridge-socket");
+#endif
+
+	Bridge::Bridge(const MumbleAPI &api)
+		: m_api(api), m_serverState(api),
+		  m_talkingStateRecorder(TalkingStateRecorder::DEFAULT_CAPACITY, &m_talkingStateStatistics) {}
+
+	// How long we keep on trying to write to a client that isn't reading from its pipe before dropping its messages
+	constexpr std::chrono::milliseconds CLIENT_WRITE_TIMEOUT(1000);
+	// The interval in which we check whether a client has started reading from its pipe again
+	constexpr std::chrono::milliseconds CLIENT_WRITE_RETRY_INTERVAL(5);
+
+	void Bridge::doStart() {
+		{
+			// Make sure that m_workerThread has been assigned properly before accessing it
+			std::lock_guard< std::mutex > guard(m_startMutex);
+			CHECK_THREAD;
+		}
+
+		// Generate a secret that we are going to use. It must not change while the pipeline is running.
+		m_secret = Util::generateRandomString(12);
+
+		m_secretField.clear();
+		ResponseWriter secretWriter(m_secretField);
+		secretWriter.raw(R"("secret":)");
+		secretWriter.string(m_secret);
+		secretWriter.raw(",");
+
+		startPipeline();
+
+		// Clients that have registered via the named pipe keep their subscriptions across restarts
+		updateSubscribedTopics();
+
+		m_builtinListeners.clear();
+		m_builtinListeners.push_back(
+			std::make_unique< Transports::NamedPipeListener >(s_pipePath, m_inboundLimits.maxMessageSize));
+#ifdef PLATFORM_UNIX
+		if (!m_socketAddress.empty()) {
+			m_builtinListeners.push_back(std::make_unique< Transports::SocketListener >(m_socketAddress));
+		}
+#endif
+
+		try {
+			// Without the named pipe nobody could talk to us, but all other transports are optional
+			startListener(*m_builtinListeners.front());
+
+			std::vector< Transports::Listener * > optionalListeners;
+			for (std::size_t i = 1; i < m_builtinListeners.size(); i++) {
+				optionalListeners.push_back(m_builtinListeners[i].get());
+			}
+			for (const std::unique_ptr< Transports::Listener > &listener : m_additionalListeners) {
+				optionalListeners.push_back(listener.get());
+			}
+
+			for (Transports::Listener *listener : optionalListeners) {
+				try {
+					startListener(*listener);
+				} catch (const std::exception &e) {
+					std::cerr << "Mumble-JSON-Bridge: Can't listen on " << listener->getAddress() << ": " << e.what()
+							  << std::endl;
+				}
+			}
+
+			// Process events until stop() is called
+			m_loop.run();
+
+			std::cout << "Stopping pipe-query" << std::endl;
+		} catch (const std::exception &e) {
+			std::cerr << "Mumble-JSON-Bridge failed: " << e.what() << std::endl;
+		}
+
+		for (const std::unique_ptr< Transports::Listener > &listener : m_builtinListeners) {
+			listener->stop();
+		}
+		for (const std::unique_ptr< Transports::Listener > &listener : m_additionalListeners) {
+			listener->stop();
+		}
+
+		stopPipeline();
+
+		// Events published while the Bridge isn't running are not delivered later on
+		m_subscribedTopics = 0;
+		if (m_talkingStateTimer) {
+			m_loop.cancelTimer(*m_talkingStateTimer);
+			m_talkingStateTimer.reset();
+		}
+
+#ifdef PLATFORM_UNIX
+		m_pendingWrites.clear();
+#endif
+
+		// Connections don't survive a restart of the Bridge
+		for (auto it = m_clients.begin(); it != m_clients.end();) {
+			it->second.getConnection().unwatch();
+			it->second.clearRequests();
+
+			if (it->second.hasDedicatedConnection()) {
+				m_talkingStateSubscribers.erase(it->first);
+				it = m_clients.erase(it);
+			} else {
+				++it;
+			}
+		}
+	}
+
+	void Bridge::startPipeline() {
+		CHECK_THREAD;
+
+		// Messages that have been received before the last stop are never going to be processed
+		m_parsedMessages.clear();
+		m_nextParsedSequence = m_nextParseSequence;
+
+		// Jobs that don't fit into the workers' queues are held back, as this thread must never wait for the workers
+		// (that would stall all clients). They are handed over once the workers have made room.
+		auto onRoom = [this]() { m_loop.post([this]() { drainBacklogs(); }); };
+
+		// Later stages have to be running before the earlier ones can hand jobs over to them
+		m_serializationWorkers.start(m_pipelineConfig.serializationThreads, m_pipelineConfig.queueCapacity,
+									 [this](SerializationJob &job) { serialize(job); }, onRoom);
+		m_executionWorkers.start(m_pipelineConfig.executionThreads, m_pipelineConfig.queueCapacity,
+								 [this](ExecutionJob &job) { execute(job); }, onRoom);
+		m_parseWorkers.start(m_pipelineConfig.parseThreads, m_pipelineConfig.queueCapacity,
+							 [this](ParseJob &job) { parse(job); }, onRoom);
+	}
+
+	void Bridge::stopPipeline() {
+		CHECK_THREAD;
+
+		m_parseWorkers.stop();
+		m_executionWorkers.stop();
+		m_serializationWorkers.stop();
+
+		// Whatever has been held back is gone now
+		resumeReceiving();
+	}
+
+	bool Bridge::isBacklogged() const noexcept {
+		return m_parseWorkers.hasBacklog() || m_executionWorkers.hasBacklog() || m_serializationWorkers.hasBacklog();
+	}
+
+	void Bridge::pauseClient(client_id_t id) {
+		CHECK_THREAD;
+
+		auto it = m_clients.find(id);
+		if (it == m_clients.end()) {
+			return;
+		}
+
+		it->second.getConnection().setReadInterest(false);
+		m_pausedClients.push_back(id);
+	}
+
+	void Bridge::pauseListeners() {
+		CHECK_THREAD;
+
+		for (const std::unique_ptr< Transports::Listener > &listener : m_builtinListeners) {
+			listener->setReadInterest(false);
+		}
+		for (const std::unique_ptr< Transports::Listener > &listener : m_additionalListeners) {
+			listener->setReadInterest(false);
+		}
+
+		m_listenersPaused = true;
+	}
+
+	void Bridge::drainBacklogs() {
+		CHECK_THREAD;
+
+		// Every stage is drained, even if an earlier one still holds back jobs
+		const bool parseDrained         = m_parseWorkers.drain();
+		const bool executionDrained     = m_executionWorkers.drain();
+		const bool serializationDrained = m_serializationWorkers.drain();
+
+		if (parseDrained && executionDrained && serializationDrained) {
+			resumeReceiving();
+		}
+	}
+
+	void Bridge::resumeReceiving() {
+		CHECK_THREAD;
+
+		for (client_id_t current : m_pausedClients) {
+			// The client might have gone away in the meantime
+			auto it = m_clients.find(current);
+			if (it != m_clients.end()) {
+				it->second.getConnection().setReadInterest(true);
+			}
+		}
+		m_pausedClients.clear();
+
+		if (m_listenersPaused) {
+			for (const std::unique_ptr< Transports::Listener > &listener : m_builtinListeners) {
+				listener->setReadInterest(true);
+			}
+			for (const std::unique_ptr< Transports::Listener > &listener : m_additionalListeners) {
+				listener->setReadInterest(true);
+			}
+
+			m_listenersPaused = false;
+		}
+	}
+
+	void Bridge::startListener(Transports::Listener &listener) {
+		CHECK_THREAD;
+
+		listener.start(
+			m_loop,
+			[this](std::unique_ptr< Transports::Connection > connection) { onConnection(std::move(connection)); },
+			[this](const std::vector< std::string_view > &messages) {
+				processMessages(messages);
+
+				if (isBacklogged()) {
+					pauseListeners();
+				}
+			},
+			[this](const DiscardedFrame &frame) {
+				m_inboundStatistics.receivedMessages++;
+				rejectOversized(frame.envelope, INVALID_CLIENT_ID);
+			});
+	}
+
+	void Bridge::onConnection(std::unique_ptr< Transports::Connection > connection) {
+		CHECK_THREAD;
+
+		// The connection replaces the registration
+		client_id_t id = s_nextClientID;
+		s_nextClientID++;
+
+		m_clients[id] = BridgeClient(std::move(connection), id, m_maxQueuedBytes, &m_outboundStatistics);
+
+		watchClient(id);
+	}
+
+	void Bridge::watchClient(client_id_t id) {
+		CHECK_THREAD;
+
+		auto it = m_clients.find(id);
+		MUMBLE_ASSERT(it != m_clients.end());
+
+		it->second.getConnection().watch(
+			m_loop, [this, id]() { onClientReadable(id); }, [this, id]() { flushClient(id); });
+	}
+
+	void Bridge::onClientReadable(client_id_t id) {
+		CHECK_THREAD;
+
+		// Limit the amount of messages processed in one go, so that a single client can't starve all others. The
+		// remaining messages are processed the next time the connection is reported as readable.
+		constexpr int maxMessagesPerWakeup = 64;
+
+		for (int i = 0; i < maxMessagesPerWakeup; i++) {
+			// The client might have been removed while processing its previous message
+			auto it = m_clients.find(id);
+			if (it == m_clients.end()) {
+				return;
+			}
+
+			if (isBacklogged()) {
+				// The workers can't keep up. Any further request would only grow the backlog, so the client's messages
+				// stay where they are for now.
+				pauseClient(id);
+				return;
+			}
+
+			std::string_view message;
+			Transports::Status status;
+			try {
+				status = it->second.getConnection().tryReceive(message);
+			} catch (const PipeException< int > &e) {
+				// Errors that would go away by themselves are reported as a status, so retrying would only end up in
+				// the same error again and again
+				std::cerr << "Mumble-JSON-Bridge: Disconnecting client " << id
+						  << " as its messages can't be received: " << e.what() << std::endl;
+
+				removeClient(id);
+				return;
+			}
+
+			if (status == Transports::Status::CLOSED) {
+				// The client has closed the connection
+				removeClient(id);
+				return;
+			}
+			if (status == Transports::Status::DISCARDED) {
+				m_inboundStatistics.receivedMessages++;
+				rejectOversized(message, id);
+				continue;
+			}
+			if (status != Transports::Status::OK) {
+				return;
+			}
+
+			// The message is either parsed right away or copied for the parse threads before the next one is received
+			processReceived(message, id);
+		}
+
+		auto it = m_clients.find(id);
+		if (it != m_clients.end()) {
+			it->second.getConnection().resumeReading();
+		}
+	}
+
+#ifdef PLATFORM_UNIX
+	void Bridge::handleSharedMemoryRegistration(client_id_t id, const Messages::Registration &msg,
+												const nlohmann::json &requestID) {
+		CHECK_THREAD;
+
+		auto it = m_clients.find(id);
+		if (it == m_clients.end()) {
+			// The client has gone away in the meantime
+			return;
+		}
+
+		BridgeClient &client = it->second;
+
+		if (!client.getConnection().canPassHandles()) {
+			throw Messages::InvalidMessageException("Shared memory can't be set up via this connection");
+		}
+
+		if (!client.getOutboundQueue().empty() || client.hasRequestsInFlight()) {
+			// These would otherwise end up being sent after the registration response
+			throw Messages::InvalidMessageException("Can't switch to shared memory while responses are pending");
+		}
+
+		SharedMemoryChannel channel;
+		try {
+			channel = SharedMemoryChannel::create();
+		} catch (const PipeException< int > &e) {
+			throw Messages::InvalidMessageException(std::string("Can't set up shared memory: ") + e.what());
+		}
+
+		// clang-format off
+		nlohmann::json response = {
+			{ "response_type", "registration" },
+			{ "secret", m_secret },
+			{ "response",
+				{
+					{ "client_id", id },
+					{ "transport", "shared_memory" },
+					{ "ring_size", channel.getRingSize() }
+				}
+			}
+		};
+		// clang-format on
+
+		if (msg.m_encodingRequested) {
+			// Confirm the encoding that will be used from now on (this response still uses the previous one)
+			response["response"]["encoding"] = to_string(msg.m_encoding);
+		}
+
+		if (!requestID.is_null()) {
+			response["request_id"] = requestID;
+		}
+
+		// The response can't be queued like all others, as the channel's handles have to be passed along with it
+		if (client.getConnection().trySendWithHandles(encode(response, client.getEncoding()), channel.getHandles())
+			!= Transports::Status::OK) {
+			// If the client has gone away, this is noticed by the next read from its connection
+			std::cerr << "Mumble-JSON-Bridge: Can't hand over shared memory to client " << id << std::endl;
+			return;
+		}
+
+		// The previous connection is kept open in order to notice when the client goes away
+		client.getConnection().unwatch();
+		std::unique_ptr< Transports::Connection > control = client.replaceConnection(nullptr);
+
+		client.replaceConnection(
+			std::make_unique< Transports::SharedMemoryConnection >(std::move(control), std::move(channel)));
+
+		if (msg.m_encodingRequested) {
+			client.setEncoding(msg.m_encoding);
+		}
+
+		watchClient(id);
+	}
+#endif
+
+	void Bridge::handleSocketRegistration(client_id_t id, const Messages::Registration &msg,
+										  const nlohmann::json &requestID) {
+		CHECK_THREAD;
+
+		auto it = m_clients.find(id);
+		if (it == m_clients.end()) {
+			// The client has gone away in the meantime
+			return;
+		}
+
+		BridgeClient &client = it->second;
+
+		if (!client.getOutboundQueue().empty() || client.hasRequestsInFlight()) {
+			// The client couldn't tell which encoding these would end up being sent in
+			throw Messages::InvalidMessageException("Can't switch the encoding while responses are pending");
+		}
+
+		// clang-format off
+		nlohmann::json response = {
+			{ "response_type", "registration" },
+			{ "secret", m_secret },
+			{ "response",
+				{
+					{ "client_id", id },
+					{ "transport", "socket" },
+					{ "encoding", to_string(msg.m_encodingRequested ? msg.m_encoding : client.getEncoding()) }
+				}
+			}
+		};
+		// clang-format on
+
+		if (!requestID.is_null()) {
+			response["request_id"] = requestID;
+		}
+
+		// The confirmation is sent in the previous encoding. All further messages use the new one.
+		send(id, response);
+
+		if (msg.m_encodingRequested) {
+			client.setEncoding(msg.m_encoding);
+		}
+	}
+
+	void Bridge::processMessages(const std::vector< std::string_view > &messages) {
+		CHECK_THREAD;
+
+		for (std::string_view content : messages) {
+			processReceived(content, INVALID_CLIENT_ID);
+		}
+	}
+
+	void Bridge::processReceived(std::string_view content, client_id_t connectedClient) {
+		CHECK_THREAD;
+
+		if (!admit(content, connectedClient)) {
+			return;
+		}
+
+		// Messages received via the named pipe are always JSON. Connected clients might have negotiated otherwise.
+		Encoding encoding = Encoding::JSON;
+		if (connectedClient != INVALID_CLIENT_ID) {
+			auto it = m_clients.find(connectedClient);
+			if (it != m_clients.end()) {
+				encoding = it->second.getEncoding();
+			}
+		}
+
+		if (m_parseWorkers.isRunning()) {
+			ParseJob job;
+			job.sequence        = m_nextParseSequence++;
+			job.connectedClient = connectedClient;
+			job.content         = BufferPool::shared().take();
+			job.encoding        = encoding;
+
+			// The message has to be copied out of the connection's memory (or the listener's buffer), as that is
+			// reused for the next one
+			job.content.assign(content.data(), content.size());
+
+			// Consecutive messages are parsed by different threads. onParsed() restores their order.
+			m_parseWorkers.tryDispatch(job.sequence, std::move(job));
+
+			return;
+		}
+
+		// Without parse threads, the message is parsed right here, straight from the connection's memory
+		try {
+			if (std::optional< Messages::APICallRequest > request = readAPICall(content, connectedClient, encoding)) {
+				processAPICall(*request, connectedClient);
+				return;
+			}
+
+			// Parse directly from the receive buffer instead of copying the message out of it first
+			nlohmann::json message = decode(content, encoding);
+
+			processMessage(message, connectedClient);
+		} catch (const nlohmann::json::parse_error &) {
+			m_inboundStatistics.malformedMessages++;
+		} catch (const TimeoutException &) {
+			std::cerr << "Mumble-JSON-Bridge: NamedPipe IO timed out" << std::endl;
+		} catch (const std::exception &e) {
+			// Whatever is wrong with this message, it must not keep the following ones from being processed
+			reportMalformed(e);
+		}
+	}
+
+	bool Bridge::admit(std::string_view content, client_id_t connectedClient) {
+		CHECK_THREAD;
+
+		m_inboundStatistics.receivedMessages++;
+
+		if (content.size() > m_inboundLimits.maxMessageSize) {
+			rejectOversized(content, connectedClient);
+			return false;
+		}
+
+		if (connectedClient != INVALID_CLIENT_ID) {
+			// The connection already tells us who sent the message
+			return true;
+		}
+
+		// Only the envelope is read here. The message body is parsed once it is clear that the message is going to
+		// be processed. Messages received via the named pipe are always JSON.
+		Arena &arena = Arena::forThisThread();
+		arena.reset();
+
+		Messages::Envelope envelope;
+		if (!Messages::readEnvelope(content, envelope, arena)) {
+			m_inboundStatistics.malformedMessages++;
+			return false;
+		}
+
+		if (envelope.isRegistration()) {
+			if (content.size() > m_inboundLimits.maxRegistrationSize) {
+				m_inboundStatistics.oversizedMessages++;
+				return false;
+			}
+
+			return true;
+		}
+
+		if (!envelope.clientID) {
+			// There is nobody we could report the error to
+			m_inboundStatistics.unauthenticatedMessages++;
+			return false;
+		}
+
+		client_id_t id = static_cast< client_id_t >(*envelope.clientID);
+
+		auto it = m_clients.find(id);
+		if (it == m_clients.end() || it->second.isClosing()) {
+			m_inboundStatistics.unauthenticatedMessages++;
+			return false;
+		}
+
+		if (!envelope.secret || !it->second.secretMatches(*envelope.secret)) {
+			m_inboundStatistics.unauthenticatedMessages++;
+
+			if (!envelope.hasSecret) {
+				reportError(id, "The given message does not specify a \"secret\" field", envelope.requestID);
+			} else if (!envelope.secret) {
+				reportError(id, "The \"secret\" field is expected to be of type string", envelope.requestID);
+			} else {
+				reportError(id, "Permission denied (invalid secret)", envelope.requestID);
+			}
+
+			return false;
+		}
+
+		return true;
+	}
+
+	void Bridge::rejectOversized(std::string_view envelope, client_id_t connectedClient) {
+		CHECK_THREAD;
+
+		m_inboundStatistics.oversizedMessages++;
+
+		Arena &arena = Arena::forThisThread();
+		arena.reset();
+
+		// Binary encodings have no envelope we could read, but the connection still tells who the sender is
+		Messages::Envelope parsedEnvelope;
+		if (!Messages::readEnvelope(envelope, parsedEnvelope, arena)) {
+			parsedEnvelope = Messages::Envelope();
+		}
+
+		client_id_t id = connectedClient;
+
+		if (id == INVALID_CLIENT_ID) {
+			if (!parsedEnvelope.clientID || !parsedEnvelope.secret) {
+				// There is nobody we could report the error to
+				return;
+			}
+
+			id = static_cast< client_id_t >(*parsedEnvelope.clientID);
+
+			auto it = m_clients.find(id);
+			if (it == m_clients.end() || it->second.isClosing() || !it->second.secretMatches(*parsedEnvelope.secret)) {
+				return;
+			}
+		}
+
+		std::string error =
+			"The message exceeds the maximum size of " + std::to_string(m_inboundLimits.maxMessageSize) + " bytes";
+
+		reportError(id, error, parsedEnvelope.requestID);
+	}
+
+	void Bridge::parse(ParseJob &job) {
+		ParsedMessage parsed;
+		parsed.connectedClient = job.connectedClient;
+
+		try {
+			parsed.apiCall = readAPICall(job.content, job.connectedClient, job.encoding);
+
+			if (!parsed.apiCall) {
+				parsed.message = decode(job.content, job.encoding);
+			}
+		} catch (const nlohmann::json::parse_error &) {
+			m_inboundStatistics.malformedMessages++;
+		} catch (const std::exception &e) {
+			reportMalformed(e);
+		}
+
+		BufferPool::shared().giveBack(std::move(job.content));
+
+		bool processingPending;
+		{
+			std::lock_guard< std::mutex > guard(m_parsedMutex);
+
+			processingPending = !m_handedOverParsed.empty();
+			m_handedOverParsed.emplace_back(job.sequence, std::move(parsed));
+		}
+
+		if (!processingPending) {
+			// Messages handed over before this one are processed along with it
+			m_loop.post([this]() { processHandedOverParsed(); });
+		}
+	}
+
+	void Bridge::processHandedOverParsed() {
+		CHECK_THREAD;
+
+		// Messages that are left over because processing one of them has thrown are dropped
+		m_processingParsed.clear();
+		{
+			std::lock_guard< std::mutex > guard(m_parsedMutex);
+
+			m_processingParsed.swap(m_handedOverParsed);
+		}
+
+		for (std::pair< std::uint64_t, ParsedMessage > &current : m_processingParsed) {
+			onParsed(current.first, std::move(current.second));
+		}
+		m_processingParsed.clear();
+	}
+
+	void Bridge::onParsed(std::uint64_t sequence, ParsedMessage parsed) {
+		CHECK_THREAD;
+
+		if (sequence < m_nextParsedSequence) {
+			// The message has been received before the Bridge has been restarted
+			return;
+		}
+
+		if (sequence > m_nextParsedSequence) {
+			m_parsedMessages.emplace(sequence, std::move(parsed));
+			return;
+		}
+
+		// Messages that arrive in order don't have to wait in m_parsedMessages
+		m_nextParsedSequence++;
+		processParsed(parsed);
+
+		while (!m_parsedMessages.empty() && m_parsedMessages.begin()->first == m_nextParsedSequence) {
+			ParsedMessage current = std::move(m_parsedMessages.begin()->second);
+			m_parsedMessages.erase(m_parsedMessages.begin());
+			m_nextParsedSequence++;
+
+			processParsed(current);
+		}
+	}
+
+	void Bridge::processParsed(ParsedMessage &parsed) {
+		CHECK_THREAD;
+
+		if (parsed.message.is_null() && !parsed.apiCall) {
+			// The message could not be parsed
+			return;
+		}
+
+		if (parsed.connectedClient != INVALID_CLIENT_ID && m_clients.find(parsed.connectedClient) == m_clients.end()) {
+			// The client has gone away while its message has been parsed
+			return;
+		}
+
+		try {
+			if (parsed.apiCall) {
+				processAPICall(*parsed.apiCall, parsed.connectedClient);
+			} else {
+				processMessage(parsed.message, parsed.connectedClient);
+			}
+		} catch (const TimeoutException &) {
+			std::cerr << "Mumble-JSON-Bridge: NamedPipe IO timed out" << std::endl;
+		} catch (const std::exception &e) {
+			reportMalformed(e);
+		}
+	}
+
+	void Bridge::reportMalformed(const std::exception &e) {
+		m_inboundStatistics.malformedMessages++;
+
+		std::cerr << "Mumble-JSON-Bridge: Discarding message that can't be processed: " << e.what() << std::endl;
+	}
+
+	void Bridge::processMessage(const nlohmann::json &msg, client_id_t connectedClient) {
+		CHECK_THREAD;
+
+		// For clients with a connection of their own, the connection already tells us who sent the message
+		client_id_t id = connectedClient;
+		nlohmann::json requestID;
+
+		try {
+			Messages::MessageType type;
+			try {
+				// The request ID is extracted first, so that it can be echoed even if the message turns out to be
+				// invalid
+				requestID = Messages::parseRequestID(msg);
+				type      = Messages::parseBasicFormat(msg);
+			} catch (const Messages::InvalidMessageException &) {
+				// See if the message contains a client_id field as this would allow us to actually return
+				// an error to the respective client instead of simply writing something to cerr (which the
+				// client won't see).
+				if (connectedClient == INVALID_CLIENT_ID && msg.contains("client_id")) {
+					id = msg["client_id"].get< client_id_t >();
+				}
+
+				// Rethrow original exception
+				throw;
+			}
+
+			if (connectedClient != INVALID_CLIENT_ID) {
+				auto it = m_clients.find(id);
+				if (it == m_clients.end() || it->second.isClosing()) {
+					// The client has gone away or has sent a disconnect message already
+					return;
+				}
+
+				if (type == Messages::MessageType::REGISTRATION) {
+					// The only reasons for registering via a connection are switching over to shared memory and
+					// negotiating the encoding
+					Messages::Registration registration(msg["message"]);
+#ifdef PLATFORM_UNIX
+					if (registration.m_sharedMemory) {
+						handleSharedMemoryRegistration(id, registration, requestID);
+						return;
+					}
+#endif
+					if (registration.m_socket) {
+						handleSocketRegistration(id, registration, requestID);
+						return;
+					}
+
+					throw Messages::InvalidMessageException("Connected clients don't need to register");
+				}
+			} else if (type != Messages::MessageType::REGISTRATION) {
+				MESSAGE_ASSERT_FIELD(msg, "client_id", number_integer);
+
+				id = msg["client_id"].get< client_id_t >();
+
+				MESSAGE_ASSERT_FIELD(msg, "secret", string);
+
+				authenticate(id, msg["secret"].get< std::string >());
+			}
+
+			switch (type) {
+				case Messages::MessageType::REGISTRATION:
+					handleRegistration(Messages::Registration(msg["message"]), requestID);
+					break;
+				case Messages::MessageType::API_CALL:
+					handleAPICall(id, msg, requestID);
+					break;
+				case Messages::MessageType::DISCONNECT:
+					handleDisconnect(id, requestID);
+					break;
+				case Messages::MessageType::BATCH:
+					handleBatch(id, msg, requestID);
+					break;
+				case Messages::MessageType::SUBSCRIBE:
+				case Messages::MessageType::UNSUBSCRIBE:
+					handleSubscription(id, Messages::Subscription(type, msg["message"]), requestID);
+					break;
+			}
+		} catch (const Messages::InvalidMessageException &e) {
+			reportError(id, e.what(), requestID);
+		}
+	}
+
+	std::optional< Messages::APICallRequest > Bridge::readAPICall(std::string_view content, client_id_t connectedClient,
+																  Encoding encoding) const {
+		Messages::APICallRequest request;
+
+		if (!Messages::readAPICall(content, request, encoding)) {
+			return std::nullopt;
+		}
+
+		if (connectedClient == INVALID_CLIENT_ID && (!request.clientID || !request.secret)) {
+			// Leave it to the regular parsing to complain about the missing fields
+			return std::nullopt;
+		}
+
+		return request;
+	}
+
+	void Bridge::processAPICall(Messages::APICallRequest &request, client_id_t connectedClient) {
+		CHECK_THREAD;
+
+		client_id_t id = connectedClient;
+
+		if (connectedClient != INVALID_CLIENT_ID) {
+			auto it = m_clients.find(id);
+			if (it == m_clients.end() || it->second.isClosing()) {
+				// The client has gone away or has sent a disconnect message already
+				return;
+			}
+		} else {
+			id = static_cast< client_id_t >(*request.clientID);
+
+			try {
+				authenticate(id, *request.secret);
+			} catch (const Messages::InvalidMessageException &e) {
+				reportError(id, e.what(), request.requestID);
+				return;
+			}
+		}
+
+		// The parameter has been validated while reading the request already
+		submit(id, *request.function, std::move(request.parameter), std::move(request.requestID));
+	}
+
+	void Bridge::authenticate(client_id_t id, const std::string &secret) const {
+		auto it = m_clients.find(id);
+
+		if (it == m_clients.end() || it->second.isClosing()) {
+			throw Messages::InvalidMessageException("Invalid client ID");
+		}
+
+		if (!it->second.secretMatches(secret)) {
+			throw Messages::InvalidMessageException("Permission denied (invalid secret)");
+		}
+	}
+
+	void Bridge::reportError(client_id_t id, const std::string &message, const nlohmann::json &requestID) {
+		auto it = m_clients.find(id);
+
+		if (id != INVALID_CLIENT_ID && it != m_clients.end() && !it->second.isClosing()) {
+			// The error must not overtake the responses to the client's previous requests
+			submit(
+				id, [errorMsg = createErrorResponse(message)]() { return errorMsg; }, requestID);
+		} else {
+			m_inboundStatistics.unreportedErrors++;
+		}
+	}
+
+	void Bridge::handleRegistration(const Messages::Registration &msg, const nlohmann::json &requestID) {
+		CHECK_THREAD;
+
+		if (msg.m_sharedMemory) {
+			// There is no way of passing the shared memory through a named pipe (and no way of replying either)
+			std::cerr << "Mumble-JSON-Bridge: Shared memory can only be requested via the Bridge's socket" << std::endl;
+			return;
+		}
+
+		if (msg.m_socket) {
+			std::cerr << "Mumble-JSON-Bridge: Socket registrations can only be sent via the Bridge's socket"
+					  << std::endl;
+			return;
+		}
+
+		if (isBinary(msg.m_encoding)) {
+			// Messages on named pipes are delimited by means that only work for text
+			std::cerr << "Mumble-JSON-Bridge: Binary encodings can only be used via the Bridge's socket" << std::endl;
+			return;
+		}
+
+		std::error_code errorCode;
+		if (std::filesystem::exists(msg.m_pipePath, errorCode)) {
+			client_id_t id = s_nextClientID;
+			s_nextClientID++;
+
+			auto connection = std::make_unique< Transports::NamedPipeConnection >(msg.m_pipePath);
+
+			// Open the client's pipe once, so that it can be reused for all responses
+			connection->open();
+
+			m_clients[id] = BridgeClient(std::move(connection), msg.m_secret, id, msg.m_framing, m_maxQueuedBytes,
+										 &m_outboundStatistics);
+
+			watchClient(id);
+
+			// Tell the client about its assigned ID
+			// clang-format off
+			nlohmann::json response = {
+				{ "response_type", "registration" },
+				{ "secret", m_secret },
+				{ "response",
+					{
+						{ "client_id", id }
+					}
+				}
+			};
+			// clang-format on
+
+			if (msg.m_framingRequested) {
+				// Confirm the framing that will be used from now on (including for this very response)
+				response["response"]["framing"] = to_string(msg.m_framing);
+			}
+
+			if (msg.m_encodingRequested) {
+				response["response"]["encoding"] = to_string(msg.m_encoding);
+			}
+
+			if (!requestID.is_null()) {
+				response["request_id"] = requestID;
+			}
+
+			send(id, response);
+		}
+	}
+
+	void Bridge::handleAPICall(client_id_t id, const nlohmann::json &msg, const nlohmann::json &requestID) {
+		CHECK_THREAD;
+
+		// The message is validated by the execution thread as well
+		submit(
+			id,
+			[this, message = msg["message"]](ResponseWriter &writer) {
+				Messages::APICall(m_api, message, &m_serverState).write(writer);
+			},
+			requestID);
+	}
+
+	void Bridge::handleBatch(client_id_t id, const nlohmann::json &msg, const nlohmann::json &requestID) {
+		CHECK_THREAD;
+
+		// The batch has been authenticated as a whole, so its calls are executed without any further checks
+		submit(
+			id,
+			[this, message = msg["message"]](ResponseWriter &writer) {
+				Messages::Batch(m_api, message, &m_serverState).write(writer);
+			},
+			requestID);
+	}
+
+	void Bridge::handleDisconnect(client_id_t id, const nlohmann::json &requestID) {
+		auto it = m_clients.find(id);
+		if (it == m_clients.end()) {
+			return;
+		}
+
+		// The client is removed once the response has been written to it. Until then it can't send any more messages.
+		it->second.markClosing();
+
+		// clang-format off
+		nlohmann::json response = {
+			{ "response_type", "disconnect" },
+			{ "secret", m_secret },
+		};
+		// clang-format on
+
+		// The confirmation must not overtake the responses to the client's previous requests
+		submit(
+			id, [response]() { return response; }, requestID);
+	}
+
+	void Bridge::handleSubscription(client_id_t id, const Messages::Subscription &msg,
+									const nlohmann::json &requestID) {
+		CHECK_THREAD;
+
+		auto it = m_clients.find(id);
+		if (it == m_clients.end()) {
+			// The client has gone away in the meantime
+			return;
+		}
 
-	Bridge::Bridge(const MumbleAPI &api) : m_api(api) {}
+		BridgeClient &client = it->second;
 
-	void Bridge::doStart() {
-		{
-			// Make sure that m_workerThread has been assigned properly before accessing it
-			std::lock_guard< std::mutex > guard(m_startMutex);
-			CHECK_THREAD;
+		EventTopics topics = client.getSubscriptions();
+		if (msg.isSubscribe()) {
+			topics |= msg.m_topics;
+		} else {
+			topics &= ~msg.m_topics;
 		}
 
-		// Generate a secret that we are going to use
-		m_secret = Util::generateRandomString(12);
-
-		try {
-			m_pipe = NamedPipe::create(s_pipePath);
+		if (topics.test(static_cast< std::size_t >(EventTopic::TALKING_STATE))) {
+			auto it = m_talkingStateSubscribers.find(id);
+			if (it == m_talkingStateSubscribers.end()) {
+				it = m_talkingStateSubscribers
+						 .emplace(id, TalkingStateCoalescer(m_eventConfig.talkingStateWindow,
+															m_eventConfig.maxTalkingStateRate,
+															m_eventConfig.maxPendingTalkingStates,
+															&m_talkingStateStatistics))
+						 .first;
+			}
 
-			if (!m_pipe) {
-				std::cerr << "Error creating pipe" << std::endl;
-				return;
+			if (msg.isSubscribe() && msg.m_talkingStateWindow) {
+				it->second.setWindow(*msg.m_talkingStateWindow);
 			}
+			if (msg.isSubscribe() && msg.m_maxTalkingStateRate) {
+				it->second.setMaxRate(*msg.m_maxTalkingStateRate);
+			}
+		} else {
+			m_talkingStateSubscribers.erase(id);
+		}
 
-			std::string content;
-			// Loop until the thread is interrupted
-			while (true) {
-				content = m_pipe.read_blocking();
+		// Events are pushed from now on, even before the client has received the response
+		client.setSubscriptions(topics);
+		updateSubscribedTopics();
 
-				try {
-					nlohmann::json message = nlohmann::json::parse(content);
+		// Tell the client about all of the topics it is subscribed to now
+		nlohmann::json subscribedTopics = nlohmann::json::array();
+		for (std::size_t i = 0; i < EVENT_TOPIC_COUNT; i++) {
+			if (topics.test(i)) {
+				subscribedTopics.push_back(to_string(static_cast< EventTopic >(i)));
+			}
+		}
 
-					processMessage(message);
-				} catch (const nlohmann::json::parse_error &e) {
-					std::cerr << "Mumble-JSON-Bridge: Can't parse message: " << e.what() << std::endl;
-				} catch (const TimeoutException &) {
-					std::cerr << "Mumble-JSON-Bridge: NamedPipe IO timed out" << std::endl;
+		// clang-format off
+		nlohmann::json response = {
+			{ "response_type", Messages::to_string(msg.getType()) },
+			{ "secret", m_secret },
+			{ "response",
+				{
+					{ "topics", subscribedTopics }
 				}
-			};
+			}
+		};
+		// clang-format on
 
-			std::cout << "Stopping pipe-query" << std::endl;
-		} catch (const boost::thread_interrupted &) {
-			// Destroy the client-pipe
-			m_pipe.destroy();
+		// The confirmation must not overtake the responses to the client's previous requests
+		submit(
+			id, [response]() { return response; }, requestID);
+	}
 
-			// rethrow
-			throw;
-		} catch (const std::exception &e) {
-			// Destroy the client-pipe
-			m_pipe.destroy();
+	void Bridge::updateSubscribedTopics() {
+		CHECK_THREAD;
 
-			std::cerr << "Mumble-JSON-Bridge failed: " << e.what() << std::endl;
+		EventTopics topics;
+		for (const auto &current : m_clients) {
+			topics |= current.second.getSubscriptions();
+		}
+
+		m_subscribedTopics = topics.to_ulong();
+
+		bool talkingStates = topics.test(static_cast< std::size_t >(EventTopic::TALKING_STATE));
+		if (talkingStates && !m_talkingStateTimer) {
+			// Whatever has been recorded before is of no interest to the new subscribers
+			m_talkingStateRecorder.drain(m_collectedTalkingStates);
+			m_collectedTalkingStates.clear();
+
+			m_talkingStateTimer =
+				m_loop.runAfter(m_eventConfig.collectionInterval, [this]() { collectTalkingStates(); });
+		} else if (!talkingStates && m_talkingStateTimer) {
+			m_loop.cancelTimer(*m_talkingStateTimer);
+			m_talkingStateTimer.reset();
+		}
+	}
+
+	void Bridge::dispatch(const Event &event) {
+		CHECK_THREAD;
+
+		// Sending might remove clients, so the subscribers are looked up first
+		std::vector< client_id_t > subscribers;
+		for (const auto &current : m_clients) {
+			if (current.second.isSubscribed(event.topic) && !current.second.isClosing()) {
+				subscribers.push_back(current.first);
+			}
+		}
 
-			// Exit thread
+		if (subscribers.empty()) {
 			return;
 		}
+
+		// The event is written only once for all subscribers
+		std::string message;
+		ResponseWriter writer(message);
+		writer.raw("{");
+		writer.raw(m_secretField);
+		event.write(writer);
+		writer.raw("}");
+
+		sendWritten(subscribers, message);
 	}
 
-	void Bridge::processMessage(const nlohmann::json &msg) {
+	void Bridge::collectTalkingStates() {
 		CHECK_THREAD;
 
-		client_id_t id = INVALID_CLIENT_ID;
+		m_collectedTalkingStates.clear();
+		std::uint64_t dropped = m_talkingStateRecorder.drain(m_collectedTalkingStates);
 
-		try {
-			Messages::MessageType type;
-			try {
-				type = Messages::parseBasicFormat(msg);
-			} catch (const Messages::InvalidMessageException &) {
-				// See if the message contains a client_id field as this would allow us to actually return
-				// an error to the respective client instead of simply writing something to cerr (which the
-				// client won't see).
-				if (msg.contains("client_id")) {
-					id = msg["client_id"].get< client_id_t >();
-				}
+		TalkingStateCoalescer::clock::time_point now = TalkingStateCoalescer::clock::now();
 
-				// Rethrow original exception
-				throw;
+		// Sending might remove clients, so the frames that are due are written first. Subscribers that have been
+		// collecting the same changes end up with identical frames, which only have to be transcoded once.
+		std::unordered_map< std::string, std::vector< client_id_t > > frames;
+		for (auto &current : m_talkingStateSubscribers) {
+			TalkingStateCoalescer &coalescer = current.second;
+
+			coalescer.addDropped(dropped);
+			for (const TalkingStateChange &change : m_collectedTalkingStates) {
+				coalescer.add(change, now);
 			}
 
-			if (type != Messages::MessageType::REGISTRATION) {
-				MESSAGE_ASSERT_FIELD(msg, "client_id", number_integer);
+			auto it = m_clients.find(current.first);
+			if (coalescer.isDue(now) && it != m_clients.end() && !it->second.isClosing()) {
+				std::string message;
+				ResponseWriter writer(message);
+				writer.raw("{");
+				writer.raw(m_secretField);
+				coalescer.write(writer, now);
+				writer.raw("}");
 
-				id = msg["client_id"].get< client_id_t >();
+				frames[std::move(message)].push_back(current.first);
+			}
+		}
 
-				MESSAGE_ASSERT_FIELD(msg, "secret", string);
+		for (const auto &current : frames) {
+			sendWritten(current.second, current.first);
+		}
 
-				auto it = m_clients.find(id);
+		m_talkingStateTimer = m_loop.runAfter(m_eventConfig.collectionInterval, [this]() { collectTalkingStates(); });
+	}
 
-				if (it == m_clients.end()) {
-					throw Messages::InvalidMessageException("Invalid client ID");
-				}
+	void Bridge::sendWritten(const std::vector< client_id_t > &recipients, const std::string &message) {
+		CHECK_THREAD;
+
+		// The message is parsed at most once and transcoded at most once per encoding, no matter how many of the
+		// recipients share that encoding
+		std::optional< nlohmann::json > parsed;
+		std::map< Encoding, std::string > encoded;
+
+		for (client_id_t id : recipients) {
+			auto it = m_clients.find(id);
+			if (it == m_clients.end()) {
+				// Sending to one of the previous recipients has removed this one
+				continue;
+			}
+
+			Encoding encoding = it->second.getEncoding();
+			if (!isBinary(encoding)) {
+				send(id, message);
+				continue;
+			}
 
-				if (!it->second.secretMatches(msg["secret"].get< std::string >())) {
-					throw Messages::InvalidMessageException("Permission denied (invalid secret)");
+			auto encodedIt = encoded.find(encoding);
+			if (encodedIt == encoded.end()) {
+				if (!parsed) {
+					parsed = nlohmann::json::parse(message);
 				}
+
+				encodedIt = encoded.emplace(encoding, encode(*parsed, encoding)).first;
 			}
 
-			switch (type) {
-				case Messages::MessageType::REGISTRATION:
-					handleRegistration(Messages::Registration(msg["message"]));
-					break;
-				case Messages::MessageType::API_CALL:
-					handleAPICall(m_clients[id], Messages::APICall(m_api, msg["message"]));
-					break;
-				case Messages::MessageType::DISCONNECT:
-					handleDisconnect(msg);
-					break;
+			send(id, encodedIt->second);
+		}
+	}
+
+	void Bridge::submit(client_id_t id, std::function< nlohmann::json() > task, nlohmann::json requestID) {
+		ExecutionJob job;
+		job.client    = id;
+		job.task      = std::move(task);
+		job.requestID = std::move(requestID);
+
+		submit(std::move(job));
+	}
+
+	void Bridge::submit(client_id_t id, std::function< void(ResponseWriter &) > write, nlohmann::json requestID) {
+		ExecutionJob job;
+		job.client    = id;
+		job.write     = std::move(write);
+		job.requestID = std::move(requestID);
+
+		submit(std::move(job));
+	}
+
+	void Bridge::submit(client_id_t id, const Messages::APIFunction &function, Messages::APIParameter parameter,
+						nlohmann::json requestID) {
+		ExecutionJob job;
+		job.client    = id;
+		job.function  = &function;
+		job.parameter = std::move(parameter);
+		job.requestID = std::move(requestID);
+
+		submit(std::move(job));
+	}
+
+	void Bridge::submit(ExecutionJob job) {
+		CHECK_THREAD;
+
+		auto it = m_clients.find(job.client);
+		if (it == m_clients.end()) {
+			// The client has gone away in the meantime, so there is nobody to send the response to
+			return;
+		}
+
+		BridgeClient &client = it->second;
+
+		// The client must not be removed before the response has been sent
+		client.beginRequest();
+
+		job.encoding = client.getEncoding();
+
+		if (m_executionWorkers.isRunning()) {
+			// All requests of a client end up with the same thread, so they can't overtake one another
+			std::size_t key = job.client;
+			m_executionWorkers.tryDispatch(key, std::move(job));
+		} else {
+			execute(job);
+		}
+	}
+
+	void Bridge::execute(ExecutionJob &job) {
+		SerializationJob serializationJob;
+		serializationJob.client   = job.client;
+		serializationJob.encoding = job.encoding;
+
+		try {
+			if (job.write || job.function) {
+				// The response is written straight into its serialized form. It still passes the serialization stage,
+				// so that it can't overtake the client's other responses.
+				serializationJob.message = writeResponse(job);
+			} else {
+				serializationJob.response = job.task();
 			}
 		} catch (const Messages::InvalidMessageException &e) {
-			if (id != INVALID_CLIENT_ID && m_clients.find(id) != m_clients.end()) {
-				const BridgeClient &client = m_clients[id];
-
-				// clang-format off
-				nlohmann::json errorMsg = {
-					{ "response_type", "error" },
-					{ "secret", m_secret },
-					{ "response", 
-						{
-							{ "error_message", std::string(e.what()) }
-						}
-					}
-				};
-				// clang-format on
+			serializationJob.response = createErrorResponse(e.what());
+		} catch (const std::exception &e) {
+			std::cerr << "Mumble-JSON-Bridge: Failed at processing request of client " << job.client << ": "
+					  << e.what() << std::endl;
 
-				client.write(errorMsg.dump());
+			serializationJob.response = createErrorResponse(e.what());
+		}
+
+		if (!job.requestID.is_null() && serializationJob.message.empty()) {
+			// Every response (including errors) tells the client which of its requests it belongs to
+			serializationJob.response["request_id"] = std::move(job.requestID);
+		}
+
+		if (m_serializationWorkers.isRunning()) {
+			if (m_loop.isInLoopThread()) {
+				// There are no execution threads, but the Bridge's thread must not wait for the serialization threads
+				m_serializationWorkers.tryDispatch(job.client, std::move(serializationJob));
 			} else {
-				std::cerr << "Mumble-JSON-Bridge: Got error for unknown client: " << e.what() << std::endl;
+				m_serializationWorkers.dispatch(job.client, std::move(serializationJob));
 			}
+		} else {
+			serialize(serializationJob);
 		}
 	}
 
-	void Bridge::handleRegistration(const Messages::Registration &msg) {
-		CHECK_THREAD;
+	std::string Bridge::writeResponse(ExecutionJob &job) const {
+		// Responses tend to be of similar size, so the buffer is sized after the previous response written by this
+		// thread (plus room for the framing) in order to avoid growing it while writing
+		thread_local std::size_t s_expectedSize = 256;
 
-		std::error_code errorCode;
-		if (std::filesystem::exists(msg.m_pipePath, errorCode)) {
-			client_id_t id = s_nextClientID;
-			s_nextClientID++;
+		std::string message = BufferPool::shared().take();
+		message.reserve(s_expectedSize);
 
-			m_clients[id] = BridgeClient(msg.m_pipePath, msg.m_secret, id);
+		ResponseWriter writer(message);
+		writer.raw("{");
+		if (!job.requestID.is_null()) {
+			writer.raw(R"("request_id":)");
+			writer.value(job.requestID);
+			writer.raw(",");
+		}
+		writer.raw(m_secretField);
+		if (job.function) {
+			Messages::APICall(m_api, *job.function, std::move(job.parameter), &m_serverState).write(writer);
+		} else {
+			job.write(writer);
+		}
+		writer.raw("}");
 
-			// Tell the client about its assigned ID
-			// clang-format off
-			nlohmann::json response = {
-				{ "response_type", "registration" },
-				{ "secret", m_secret },
-				{ "response",
-					{
-						{ "client_id", id }
-					}
-				}
-			};
-			// clang-format on
+		s_expectedSize = message.size() + 1;
+
+		return message;
+	}
+
+	void Bridge::serialize(SerializationJob &job) {
+		if (isBinary(job.encoding)) {
+			if (!job.message.empty()) {
+				// Responses are always written as JSON text, which has to be transcoded for the client
+				job.response = nlohmann::json::parse(job.message);
+			}
 
-			m_clients[id].write(response.dump());
+			handOver(job.client, encode(job.response, job.encoding));
+		} else if (!job.message.empty()) {
+			handOver(job.client, std::move(job.message));
+		} else {
+			handOver(job.client, job.response.dump());
 		}
 	}
 
-	void Bridge::handleAPICall(const BridgeClient &client, const Messages::APICall &msg) const {
-		nlohmann::json response = msg.execute(m_secret);
+	void Bridge::handOver(client_id_t id, std::string message) {
+		if (m_loop.isInLoopThread()) {
+			// Neither executing nor serializing the response has been handed over to other threads
+			deliver(id, std::move(message));
+			return;
+		}
+
+		bool deliveryPending;
+		{
+			std::lock_guard< std::mutex > guard(m_handOverMutex);
+
+			deliveryPending = !m_handedOver.empty();
+			m_handedOver.emplace_back(id, std::move(message));
+		}
 
-		client.write(response.dump());
+		if (!deliveryPending) {
+			// Responses handed over before this one are delivered along with it
+			m_loop.post([this]() { deliverHandedOver(); });
+		}
 	}
 
-	void Bridge::handleDisconnect(const nlohmann::json &msg) {
-		client_id_t id = msg["client_id"].get< client_id_t >();
-		// Move the client out of the list of known clients
-		BridgeClient client = std::move(m_clients[id]);
-		m_clients.erase(id);
+	void Bridge::deliverHandedOver() {
+		CHECK_THREAD;
+
+		// Responses that are left over because delivering one of them has thrown are dropped
+		m_delivering.clear();
+		{
+			std::lock_guard< std::mutex > guard(m_handOverMutex);
+
+			m_delivering.swap(m_handedOver);
+		}
 
+		for (std::pair< client_id_t, std::string > &current : m_delivering) {
+			deliver(current.first, std::move(current.second));
+		}
+		m_delivering.clear();
+	}
+
+	void Bridge::deliver(client_id_t id, std::string message) {
+		CHECK_THREAD;
+
+		auto it = m_clients.find(id);
+		if (it == m_clients.end()) {
+			// The client has gone away in the meantime
+			return;
+		}
+
+		it->second.endRequest();
 
+		send(id, std::move(message));
+	}
+
+	nlohmann::json Bridge::createErrorResponse(const std::string &message) const {
 		// clang-format off
-		nlohmann::json response = {
-			{ "response_type", "disconnect" },
+		return {
+			{ "response_type", "error" },
 			{ "secret", m_secret },
+			{ "response",
+				{
+					{ "error_message", message }
+				}
+			}
 		};
 		// clang-format on
+	}
+
+	void Bridge::send(client_id_t id, std::string message) {
+		CHECK_THREAD;
+
+		auto it = m_clients.find(id);
+		if (it == m_clients.end()) {
+			// The client has gone away in the meantime
+			return;
+		}
+
+		BridgeClient &client = it->second;
+
+		// If there are queued messages already, the client is waiting for its pipe to become writable (again) and the
+		// new message will be written along with the others
+		bool flushNeeded = client.getOutboundQueue().empty();
+
+		if (!client.enqueue(std::move(message))) {
+			// The client isn't keeping up with reading its messages
+			switch (m_overflowPolicy) {
+				case OverflowPolicy::DROP:
+					break;
+				case OverflowPolicy::DISCONNECT:
+					std::cerr << "Mumble-JSON-Bridge: Disconnecting client " << id
+							  << " as it doesn't read its messages" << std::endl;
+
+					m_outboundStatistics.disconnectedClients++;
+					removeClient(id);
+
+					return;
+				case OverflowPolicy::SEND_ERROR: {
+					// clang-format off
+					nlohmann::json errorMsg = {
+						{ "response_type", "error" },
+						{ "secret", m_secret },
+						{ "response",
+							{
+								{ "error_message", "Outbound queue is full - message has been dropped" }
+							}
+						}
+					};
+					// clang-format on
+
+					client.notifyOverflow(encode(errorMsg, client.getEncoding()));
+					break;
+				}
+			}
+		}
+
+		if (flushNeeded) {
+			flushClient(id);
+		}
+	}
+
+	void Bridge::send(client_id_t id, const nlohmann::json &message) {
+		CHECK_THREAD;
+
+		auto it = m_clients.find(id);
+		if (it == m_clients.end()) {
+			return;
+		}
+
+		send(id, encode(message, it->second.getEncoding()));
+	}
+
+	void Bridge::flushClient(client_id_t id) {
+		CHECK_THREAD;
+
+		auto it = m_clients.find(id);
+		if (it == m_clients.end()) {
+			return;
+		}
+
+		BridgeClient &client = it->second;
 
-		client.write(response.dump());
+		BridgeClient::FlushResult result;
+		try {
+			result = client.flush();
+		} catch (const std::exception &e) {
+			std::cerr << "Mumble-JSON-Bridge: Failed at writing to client " << id << ": " << e.what() << std::endl;
+
+			client.getOutboundQueue().dropAll();
+			result = BridgeClient::FlushResult::DONE;
+		}
+
+		if (result == BridgeClient::FlushResult::DISCONNECTED) {
+			removeClient(id);
+			return;
+		}
+
+#ifdef PLATFORM_UNIX
+		auto pendingIt = m_pendingWrites.find(id);
+
+		if (result == BridgeClient::FlushResult::DONE) {
+			if (pendingIt != m_pendingWrites.end()) {
+				client.getConnection().setWriteInterest(false);
+
+				m_pendingWrites.erase(pendingIt);
+			}
+		} else {
+			if (pendingIt == m_pendingWrites.end()) {
+				pendingIt = m_pendingWrites.emplace(id, PendingWrite()).first;
+			}
+			PendingWrite &pending = pendingIt->second;
+
+			if (client.getOutboundQueue().getQueuedBytes() != pending.queuedBytes) {
+				// Some progress has been made
+				pending.queuedBytes  = client.getOutboundQueue().getQueuedBytes();
+				pending.stalledSince = EventLoop::clock::now();
+			}
+
+			if (result == BridgeClient::FlushResult::WOULD_BLOCK) {
+				// Resume as soon as the client has made room in its connection
+				client.getConnection().setWriteInterest(true);
+			} else if (EventLoop::clock::now() - pending.stalledSince >= CLIENT_WRITE_TIMEOUT) {
+				std::cerr << "Mumble-JSON-Bridge: Client " << id << " doesn't read from its pipe - dropping "
+						  << client.getOutboundQueue().size() << " message(s)" << std::endl;
+
+				client.getOutboundQueue().dropAll();
+				client.getConnection().setWriteInterest(false);
+				m_pendingWrites.erase(pendingIt);
+
+				result = BridgeClient::FlushResult::DONE;
+			} else if (!pending.retryScheduled) {
+				// There is no way of getting notified once the client starts reading again, so we have to poll
+				pending.retryScheduled = true;
+
+				m_loop.runAfter(CLIENT_WRITE_RETRY_INTERVAL, [this, id]() {
+					auto it = m_pendingWrites.find(id);
+					if (it != m_pendingWrites.end()) {
+						it->second.retryScheduled = false;
+
+						flushClient(id);
+					}
+				});
+			}
+		}
+#else
+		if (result != BridgeClient::FlushResult::DONE) {
+			std::cerr << "Mumble-JSON-Bridge: Client " << id << " doesn't read from its pipe - dropping "
+					  << client.getOutboundQueue().size() << " message(s)" << std::endl;
+
+			client.getOutboundQueue().dropAll();
+			result = BridgeClient::FlushResult::DONE;
+		}
+#endif
+
+		if (result == BridgeClient::FlushResult::DONE && client.isClosing() && !client.hasRequestsInFlight()) {
+			removeClient(id);
+		}
+	}
+
+	void Bridge::removeClient(client_id_t id) {
+		CHECK_THREAD;
+
+#ifdef PLATFORM_UNIX
+		m_pendingWrites.erase(id);
+#endif
+
+		// The client's connection stops being watched once it is destroyed
+		m_clients.erase(id);
+		m_talkingStateSubscribers.erase(id);
+
+		updateSubscribedTopics();
+	}
+
+	void Bridge::setOutboundQueueLimit(std::size_t maxQueuedBytes, OverflowPolicy policy) {
+		m_maxQueuedBytes = maxQueuedBytes;
+		m_overflowPolicy = policy;
+	}
+
+	const OutboundStatistics &Bridge::getOutboundStatistics() const noexcept { return m_outboundStatistics; }
+
+	void Bridge::setInboundLimits(const InboundLimits &limits) { m_inboundLimits = limits; }
+
+	const InboundStatistics &Bridge::getInboundStatistics() const noexcept { return m_inboundStatistics; }
+
+	ServerState &Bridge::getServerState() noexcept { return m_serverState; }
+
+	void Bridge::publish(const Event &event) noexcept {
+		if (!(m_subscribedTopics & (1ul << static_cast< unsigned int >(event.topic)))) {
+			return;
+		}
+
+		if (event.topic == EventTopic::TALKING_STATE) {
+			// These change far too often for each of them to be handed over to m_workerThread
+			m_talkingStateRecorder.record(event.connection, event.userID, event.talkingState);
+			return;
+		}
+
+		try {
+			m_loop.post([this, event]() { dispatch(event); });
+		} catch (const std::exception &e) {
+			std::cerr << "Mumble-JSON-Bridge: Failed at publishing event: " << e.what() << std::endl;
+		}
+	}
+
+	void Bridge::setEventConfig(const EventConfig &config) { m_eventConfig = config; }
+
+	const TalkingStateStatistics &Bridge::getTalkingStateStatistics() const noexcept {
+		return m_talkingStateStatistics;
 	}
 
+	void Bridge::setPipelineConfig(const PipelineConfig &config) { m_pipelineConfig = config; }
+
+	void Bridge::addListener(std::unique_ptr< Transports::Listener > listener) {
+		m_additionalListeners.push_back(std::move(listener));
+	}
+
+#ifdef PLATFORM_UNIX
+	void Bridge::setSocketAddress(const std::string &address) { m_socketAddress = address; }
+#endif
+
 	void Bridge::start() {
 		// We need a mutex here in order to make sure that doStart won't start using m_workerThread before
 		// it has been initialized properly by below statement.
 		std::lock_guard< std::mutex > guard(m_startMutex);
+
+		// Discard a stop request that a previous run didn't get to process
+		m_loop.reset();
+
 		m_workerThread = boost::thread(&Bridge::doStart, this);
 	}
 
 	void Bridge::stop(bool join) {
-		m_workerThread.interrupt();
+		m_loop.stop();
 
 		if (join) {
 			m_workerThread.join();
 		}
 	}
 
+	void Bridge::post(EventLoop::task_t task) { m_loop.post(std::move(task)); }
+
 }; // namespace JsonBridge
 }; // namespace Mumble
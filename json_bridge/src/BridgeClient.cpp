@@ -6,20 +6,137 @@
 #include "mumble/json_bridge/BridgeClient.h"
 #include "mumble/json_bridge/NamedPipe.h"
 
+#include <iostream>
+
 namespace Mumble {
 namespace JsonBridge {
-	BridgeClient::BridgeClient(const std::filesystem::path &pipePath, const std::string &secret, client_id_t id)
-		: m_pipePath(pipePath), m_secret(secret), m_id(id) {}
+	BridgeClient::BridgeClient(std::unique_ptr< Transports::Connection > connection, const std::string &secret,
+							   client_id_t id, Framing framing, std::size_t maxQueuedBytes,
+							   OutboundStatistics *statistics)
+		: m_id(id), m_connection(std::move(connection)), m_outbound(maxQueuedBytes, statistics), m_secret(secret),
+		  m_framing(framing) {}
+
+	BridgeClient::BridgeClient(std::unique_ptr< Transports::Connection > connection, client_id_t id,
+							   std::size_t maxQueuedBytes, OutboundStatistics *statistics)
+		: m_id(id), m_connection(std::move(connection)), m_dedicatedConnection(true),
+		  m_outbound(maxQueuedBytes, statistics) {}
 
 	BridgeClient::~BridgeClient() {}
 
-	void BridgeClient::write(const std::string &message) const { NamedPipe::write(m_pipePath, message); }
+	bool BridgeClient::enqueue(std::string message) { return m_outbound.push(frame(std::move(message), m_framing)); }
+
+	void BridgeClient::notifyOverflow(const std::string &notification) {
+		if (!m_overflowNotified) {
+			m_outbound.forcePush(frame(notification, m_framing));
+
+			m_overflowNotified = true;
+		}
+	}
+
+	BridgeClient::FlushResult BridgeClient::flush() {
+		if (!m_connection) {
+			m_outbound.dropAll();
+
+			return FlushResult::DISCONNECTED;
+		}
+
+		while (!m_outbound.empty()) {
+			std::string_view data = m_outbound.front();
+
+			std::size_t sent = 0;
+			Transports::Status status;
+			try {
+				status = m_connection->trySend(data, sent);
+			} catch (const PipeException< int > &e) {
+				// E.g. the message exceeds what the connection is able to transport. This only affects this specific
+				// message.
+				std::cerr << "Mumble-JSON-Bridge: Failed at sending message to client " << m_id << ": " << e.what()
+						  << std::endl;
+
+				m_outbound.dropFront();
+				continue;
+			}
+
+			m_outbound.consume(sent);
+
+			switch (status) {
+				case Transports::Status::OK:
+					break;
+				case Transports::Status::WOULD_BLOCK:
+					return FlushResult::WOULD_BLOCK;
+				case Transports::Status::NO_PEER:
+					// The rest of a partially written message can't be delivered to whoever is going to read from the
+					// connection next, as they would only get to see its end
+					if (m_outbound.isFrontPartiallyWritten()) {
+						m_outbound.dropFront();
+					}
+
+					return FlushResult::NO_READER;
+				case Transports::Status::CLOSED:
+					m_outbound.dropAll();
+
+					return FlushResult::DISCONNECTED;
+				case Transports::Status::DISCARDED:
+					// This is only ever reported when receiving (too large messages throw when being sent). Should a
+					// connection report it anyway, sending is retried once the connection becomes writable again.
+					return FlushResult::WOULD_BLOCK;
+			}
+		}
+
+		m_overflowNotified = false;
+
+		return FlushResult::DONE;
+	}
+
+	const OutboundQueue &BridgeClient::getOutboundQueue() const noexcept { return m_outbound; }
+
+	OutboundQueue &BridgeClient::getOutboundQueue() noexcept { return m_outbound; }
+
+	Transports::Connection &BridgeClient::getConnection() noexcept { return *m_connection; }
+
+	std::unique_ptr< Transports::Connection >
+		BridgeClient::replaceConnection(std::unique_ptr< Transports::Connection > connection) {
+		std::swap(m_connection, connection);
+
+		return connection;
+	}
+
+	bool BridgeClient::hasDedicatedConnection() const noexcept { return m_dedicatedConnection; }
+
+	void BridgeClient::markClosing() noexcept { m_closing = true; }
+
+	bool BridgeClient::isClosing() const noexcept { return m_closing; }
+
+	void BridgeClient::beginRequest() noexcept { m_requestsInFlight++; }
+
+	void BridgeClient::endRequest() noexcept {
+		// Responses that have been processed before a restart of the Bridge are no longer accounted for
+		if (m_requestsInFlight > 0) {
+			m_requestsInFlight--;
+		}
+	}
+
+	void BridgeClient::clearRequests() noexcept { m_requestsInFlight = 0; }
+
+	bool BridgeClient::hasRequestsInFlight() const noexcept { return m_requestsInFlight > 0; }
 
 	client_id_t BridgeClient::getID() const noexcept { return m_id; }
 
-	const std::filesystem::path &BridgeClient::getPipePath() const noexcept { return m_pipePath; }
+	Framing BridgeClient::getFraming() const noexcept { return m_framing; }
+
+	Encoding BridgeClient::getEncoding() const noexcept { return m_encoding; }
+
+	void BridgeClient::setEncoding(Encoding encoding) noexcept { m_encoding = encoding; }
+
+	const EventTopics &BridgeClient::getSubscriptions() const noexcept { return m_subscriptions; }
+
+	void BridgeClient::setSubscriptions(const EventTopics &topics) noexcept { m_subscriptions = topics; }
+
+	bool BridgeClient::isSubscribed(EventTopic topic) const noexcept {
+		return m_subscriptions.test(static_cast< std::size_t >(topic));
+	}
 
-	bool BridgeClient::secretMatches(const std::string &secret) const noexcept { return m_secret == secret; }
+	bool BridgeClient::secretMatches(std::string_view secret) const noexcept { return m_secret == secret; }
 
 	BridgeClient::operator bool() const noexcept { return m_id != INVALID_CLIENT_ID; }
 }; // namespace JsonBridge
@@ -0,0 +1,60 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+#include "mumble/json_bridge/BufferPool.h"
+
+#include <utility>
+
+namespace Mumble {
+namespace JsonBridge {
+
+	BufferPool::BufferPool(std::size_t maxBuffers, std::size_t maxBufferSize)
+		: m_maxBuffers(maxBuffers), m_maxBufferSize(maxBufferSize) {
+		m_buffers.reserve(m_maxBuffers);
+	}
+
+	std::string BufferPool::take() {
+		std::lock_guard< std::mutex > guard(m_mutex);
+
+		if (m_buffers.empty()) {
+			return std::string();
+		}
+
+		std::string buffer = std::move(m_buffers.back());
+		m_buffers.pop_back();
+
+		return buffer;
+	}
+
+	void BufferPool::giveBack(std::string buffer) noexcept {
+		// Buffers without memory of their own (see small string optimization) aren't worth keeping
+		if (buffer.capacity() > m_maxBufferSize || buffer.capacity() <= std::string().capacity()) {
+			return;
+		}
+
+		buffer.clear();
+
+		std::lock_guard< std::mutex > guard(m_mutex);
+
+		// Pushing never allocates, as the room for all buffers has been reserved up front
+		if (m_buffers.size() < m_maxBuffers) {
+			m_buffers.push_back(std::move(buffer));
+		}
+	}
+
+	std::size_t BufferPool::size() {
+		std::lock_guard< std::mutex > guard(m_mutex);
+
+		return m_buffers.size();
+	}
+
+	BufferPool &BufferPool::shared() {
+		static BufferPool *s_pool = new BufferPool();
+
+		return *s_pool;
+	}
+
+}; // namespace JsonBridge
+}; // namespace Mumble
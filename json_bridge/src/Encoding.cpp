@@ -0,0 +1,90 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+#include "mumble/json_bridge/Encoding.h"
+
+#include <stdexcept>
+
+#include <boost/algorithm/string.hpp>
+
+namespace Mumble {
+namespace JsonBridge {
+
+	std::string to_string(Encoding encoding) {
+		switch (encoding) {
+			case Encoding::JSON:
+				return "json";
+			case Encoding::CBOR:
+				return "cbor";
+			case Encoding::MSGPACK:
+				return "msgpack";
+		}
+
+		throw std::invalid_argument(std::string("Unknown encoding \"") + std::to_string(static_cast< int >(encoding))
+									+ "\"");
+	}
+
+	Encoding encoding_from_string(const std::string &encoding) {
+		if (boost::iequals(encoding, "json")) {
+			return Encoding::JSON;
+		} else if (boost::iequals(encoding, "cbor")) {
+			return Encoding::CBOR;
+		} else if (boost::iequals(encoding, "msgpack")) {
+			return Encoding::MSGPACK;
+		} else {
+			throw std::invalid_argument(std::string("Unknown encoding \"") + encoding + "\"");
+		}
+	}
+
+	bool isBinary(Encoding encoding) noexcept { return encoding != Encoding::JSON; }
+
+	std::string encode(const nlohmann::json &message, Encoding encoding) {
+		std::string encoded;
+
+		switch (encoding) {
+			case Encoding::JSON:
+				return message.dump();
+			case Encoding::CBOR:
+				nlohmann::json::to_cbor(message, nlohmann::detail::output_adapter< char >(encoded));
+				return encoded;
+			case Encoding::MSGPACK:
+				nlohmann::json::to_msgpack(message, nlohmann::detail::output_adapter< char >(encoded));
+				return encoded;
+		}
+
+		throw std::invalid_argument(std::string("Unknown encoding \"") + std::to_string(static_cast< int >(encoding))
+									+ "\"");
+	}
+
+	nlohmann::json decode(std::string_view message, Encoding encoding) {
+		switch (encoding) {
+			case Encoding::JSON:
+				return nlohmann::json::parse(message.begin(), message.end());
+			case Encoding::CBOR:
+				return nlohmann::json::from_cbor(message.begin(), message.end());
+			case Encoding::MSGPACK:
+				return nlohmann::json::from_msgpack(message.begin(), message.end());
+		}
+
+		throw std::invalid_argument(std::string("Unknown encoding \"") + std::to_string(static_cast< int >(encoding))
+									+ "\"");
+	}
+
+	nlohmann::json::input_format_t inputFormat(Encoding encoding) {
+		switch (encoding) {
+			case Encoding::JSON:
+				return nlohmann::json::input_format_t::json;
+			case Encoding::CBOR:
+				return nlohmann::json::input_format_t::cbor;
+			case Encoding::MSGPACK:
+				return nlohmann::json::input_format_t::msgpack;
+		}
+
+		throw std::invalid_argument(std::string("Unknown encoding \"") + std::to_string(static_cast< int >(encoding))
+									+ "\"");
+	}
+
+}; // namespace JsonBridge
+}; // namespace Mumble
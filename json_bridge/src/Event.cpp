@@ -0,0 +1,110 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+#include "mumble/json_bridge/Event.h"
+
+#include <stdexcept>
+#include <string_view>
+
+#include <boost/algorithm/string.hpp>
+
+namespace Mumble {
+namespace JsonBridge {
+
+	std::string to_string(EventTopic topic) {
+		switch (topic) {
+			case EventTopic::TALKING_STATE:
+				return "talking_state";
+			case EventTopic::CHANNEL_ENTERED:
+				return "channel_entered";
+			case EventTopic::CHANNEL_EXITED:
+				return "channel_exited";
+			case EventTopic::USER_ADDED:
+				return "user_added";
+			case EventTopic::USER_REMOVED:
+				return "user_removed";
+			case EventTopic::SERVER_CONNECTED:
+				return "server_connected";
+			case EventTopic::SERVER_DISCONNECTED:
+				return "server_disconnected";
+		}
+
+		throw std::invalid_argument(std::string("Unknown event topic \"") + std::to_string(static_cast< int >(topic))
+									+ "\"");
+	}
+
+	EventTopic topic_from_string(const std::string &topic) {
+		for (std::size_t i = 0; i < EVENT_TOPIC_COUNT; i++) {
+			EventTopic current = static_cast< EventTopic >(i);
+
+			if (boost::iequals(topic, to_string(current))) {
+				return current;
+			}
+		}
+
+		throw std::invalid_argument(std::string("Unknown event topic \"") + topic + "\"");
+	}
+
+	std::string_view talkingStateName(mumble_talking_state_t state) noexcept {
+		switch (state) {
+			case MUMBLE_TS_PASSIVE:
+				return "passive";
+			case MUMBLE_TS_TALKING:
+				return "talking";
+			case MUMBLE_TS_WHISPERING:
+				return "whispering";
+			case MUMBLE_TS_SHOUTING:
+				return "shouting";
+			case MUMBLE_TS_TALKING_MUTED:
+				return "talking_muted";
+			default:
+				return "invalid";
+		}
+	}
+
+	void Event::write(ResponseWriter &writer) const {
+		writer.raw(R"("response_type":"event","response":{"topic":")");
+		writer.raw(to_string(topic));
+		writer.raw(R"(","connection":)");
+		writer.value(connection);
+
+		switch (topic) {
+			case EventTopic::TALKING_STATE:
+				writer.raw(R"(,"user_id":)");
+				writer.value(userID);
+				writer.raw(R"(,"talking_state":)");
+				writer.string(talkingStateName(talkingState));
+				break;
+			case EventTopic::CHANNEL_ENTERED:
+				writer.raw(R"(,"user_id":)");
+				writer.value(userID);
+				writer.raw(R"(,"channel_id":)");
+				writer.value(channelID);
+				if (previousChannelID >= 0) {
+					writer.raw(R"(,"previous_channel_id":)");
+					writer.value(previousChannelID);
+				}
+				break;
+			case EventTopic::CHANNEL_EXITED:
+				writer.raw(R"(,"user_id":)");
+				writer.value(userID);
+				writer.raw(R"(,"channel_id":)");
+				writer.value(channelID);
+				break;
+			case EventTopic::USER_ADDED:
+			case EventTopic::USER_REMOVED:
+				writer.raw(R"(,"user_id":)");
+				writer.value(userID);
+				break;
+			case EventTopic::SERVER_CONNECTED:
+			case EventTopic::SERVER_DISCONNECTED:
+				break;
+		}
+
+		writer.raw("}");
+	}
+
+}; // namespace JsonBridge
+}; // namespace Mumble
@@ -0,0 +1,319 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+#include "mumble/json_bridge/EventLoop.h"
+#include "mumble/json_bridge/MumbleAssert.h"
+#include "mumble/json_bridge/NamedPipe.h"
+
+#ifdef PLATFORM_UNIX
+#	include <sys/epoll.h>
+#	include <sys/eventfd.h>
+#	include <unistd.h>
+#endif
+
+#include <cerrno>
+#include <exception>
+#include <iostream>
+
+namespace Mumble {
+namespace JsonBridge {
+
+	// The maximum amount of events processed per call to epoll_wait
+	constexpr int EVENTLOOP_MAX_EVENTS = 16;
+
+#ifdef PLATFORM_UNIX
+	static std::uint32_t toEpollEvents(std::uint32_t events) {
+		std::uint32_t epollEvents = 0;
+
+		if (events & EventLoop::READABLE) {
+			epollEvents |= EPOLLIN;
+		}
+		if (events & EventLoop::WRITABLE) {
+			epollEvents |= EPOLLOUT;
+		}
+
+		return epollEvents;
+	}
+
+	static std::uint32_t fromEpollEvents(std::uint32_t epollEvents) {
+		std::uint32_t events = 0;
+
+		if (epollEvents & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+			events |= EventLoop::READABLE;
+		}
+		if (epollEvents & (EPOLLOUT | EPOLLHUP | EPOLLERR)) {
+			events |= EventLoop::WRITABLE;
+		}
+
+		return events;
+	}
+
+	EventLoop::EventLoop() {
+		reserveTasks();
+
+		m_epollHandle = ::epoll_create1(EPOLL_CLOEXEC);
+		if (m_epollHandle == -1) {
+			throw PipeException< int >(errno, "Create epoll instance");
+		}
+
+		m_wakeupHandle = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+		if (m_wakeupHandle == -1) {
+			int error = errno;
+			::close(m_epollHandle);
+
+			throw PipeException< int >(error, "Create eventfd");
+		}
+
+		epoll_event event = {};
+		event.events      = EPOLLIN;
+		event.data.fd     = m_wakeupHandle;
+		if (::epoll_ctl(m_epollHandle, EPOLL_CTL_ADD, m_wakeupHandle, &event) != 0) {
+			int error = errno;
+			::close(m_wakeupHandle);
+			::close(m_epollHandle);
+
+			throw PipeException< int >(error, "Watch eventfd");
+		}
+	}
+
+	EventLoop::~EventLoop() {
+		::close(m_wakeupHandle);
+		::close(m_epollHandle);
+	}
+
+	void EventLoop::wakeup() {
+		std::uint64_t value = 1;
+		// The only possible failure is an overflow of the counter, in which case the loop is going to wake up anyway
+		if (::write(m_wakeupHandle, &value, sizeof(value)) != sizeof(value) && errno != EAGAIN) {
+			std::cerr << "Mumble-JSON-Bridge: Failed at waking up event loop: " << errno << std::endl;
+		}
+	}
+
+	void EventLoop::run() {
+		m_loopThread = std::this_thread::get_id();
+
+		epoll_event events[EVENTLOOP_MAX_EVENTS];
+
+		while (!m_stopRequested) {
+			int timeout = -1;
+
+			clock::time_point deadline = nextDeadline();
+			if (deadline != clock::time_point::max()) {
+				clock::time_point now = clock::now();
+
+				// Round up in order to not wake up right before the deadline only to go back to sleep again
+				timeout = deadline <= now ? 0
+										  : static_cast< int >(
+											  std::chrono::ceil< std::chrono::milliseconds >(deadline - now).count());
+			}
+
+			int eventCount = ::epoll_wait(m_epollHandle, events, EVENTLOOP_MAX_EVENTS, timeout);
+
+			if (eventCount == -1) {
+				if (errno == EINTR) {
+					continue;
+				}
+
+				m_loopThread = std::thread::id();
+
+				throw PipeException< int >(errno, "Wait for events");
+			}
+
+			for (int i = 0; i < eventCount && !m_stopRequested; i++) {
+				if (events[i].data.fd == m_wakeupHandle) {
+					std::uint64_t value;
+					while (::read(m_wakeupHandle, &value, sizeof(value)) > 0) {
+					}
+
+					continue;
+				}
+
+				// A previously processed callback may have stopped watching this descriptor
+				auto it = m_watches.find(events[i].data.fd);
+				if (it != m_watches.end()) {
+					// Keep the callback alive as it might unwatch its own descriptor
+					std::shared_ptr< io_callback_t > callback = it->second;
+					(*callback)(fromEpollEvents(events[i].events));
+				}
+			}
+
+			if (!m_stopRequested) {
+				runPostedTasks();
+			}
+			if (!m_stopRequested) {
+				runExpiredTimers();
+			}
+		}
+
+		m_stopRequested = false;
+		m_loopThread    = std::thread::id();
+	}
+
+	void EventLoop::watch(int fd, std::uint32_t events, io_callback_t callback) {
+		MUMBLE_ASSERT(m_watches.find(fd) == m_watches.end());
+
+		epoll_event event = {};
+		event.events      = toEpollEvents(events);
+		event.data.fd     = fd;
+		if (::epoll_ctl(m_epollHandle, EPOLL_CTL_ADD, fd, &event) != 0) {
+			throw PipeException< int >(errno, "Watch");
+		}
+
+		m_watches[fd] = std::make_shared< io_callback_t >(std::move(callback));
+	}
+
+	void EventLoop::modifyWatch(int fd, std::uint32_t events) {
+		MUMBLE_ASSERT(m_watches.find(fd) != m_watches.end());
+
+		epoll_event event = {};
+		event.events      = toEpollEvents(events);
+		event.data.fd     = fd;
+		if (::epoll_ctl(m_epollHandle, EPOLL_CTL_MOD, fd, &event) != 0) {
+			throw PipeException< int >(errno, "Modify watch");
+		}
+	}
+
+	void EventLoop::unwatch(int fd) {
+		if (m_watches.erase(fd) > 0) {
+			if (::epoll_ctl(m_epollHandle, EPOLL_CTL_DEL, fd, nullptr) != 0) {
+				std::cerr << "Mumble-JSON-Bridge: Failed at unwatching descriptor: " << errno << std::endl;
+			}
+		}
+	}
+#else
+	EventLoop::EventLoop() { reserveTasks(); }
+
+	EventLoop::~EventLoop() {}
+
+	void EventLoop::wakeup() {
+		// Lock the mutex in order to not miss the loop's transition into its waiting state
+		std::lock_guard< std::mutex > guard(m_taskMutex);
+		m_wakeupCondition.notify_all();
+	}
+
+	void EventLoop::run() {
+		m_loopThread = std::this_thread::get_id();
+
+		while (!m_stopRequested) {
+			{
+				std::unique_lock< std::mutex > lock(m_taskMutex);
+
+				auto isWoken = [this]() { return m_stopRequested || !m_postedTasks.empty(); };
+
+				clock::time_point deadline = nextDeadline();
+				if (deadline == clock::time_point::max()) {
+					m_wakeupCondition.wait(lock, isWoken);
+				} else {
+					m_wakeupCondition.wait_until(lock, deadline, isWoken);
+				}
+			}
+
+			if (!m_stopRequested) {
+				runPostedTasks();
+			}
+			if (!m_stopRequested) {
+				runExpiredTimers();
+			}
+		}
+
+		m_stopRequested = false;
+		m_loopThread    = std::thread::id();
+	}
+#endif
+
+	void EventLoop::stop() {
+		m_stopRequested = true;
+
+		wakeup();
+	}
+
+	void EventLoop::reset() { m_stopRequested = false; }
+
+	void EventLoop::post(task_t task) {
+		{
+			std::lock_guard< std::mutex > guard(m_taskMutex);
+			m_postedTasks.push_back(std::move(task));
+		}
+
+		wakeup();
+	}
+
+	void EventLoop::reserveTasks() {
+		m_postedTasks.reserve(RESERVED_TASKS);
+		m_runningTasks.reserve(RESERVED_TASKS);
+	}
+
+	void EventLoop::runTask(task_t &task) {
+		// A single failing task must not take down everything else that runs in this loop
+		try {
+			task();
+		} catch (const std::exception &e) {
+			std::cerr << "Mumble-JSON-Bridge: Failed at running task of event loop: " << e.what() << std::endl;
+		}
+	}
+
+	void EventLoop::runPostedTasks() {
+		m_runningTasks.clear();
+		{
+			std::lock_guard< std::mutex > guard(m_taskMutex);
+			std::swap(m_runningTasks, m_postedTasks);
+		}
+
+		// Tasks posted while these are being executed are processed in the next iteration of the loop
+		for (task_t &currentTask : m_runningTasks) {
+			runTask(currentTask);
+		}
+
+		m_runningTasks.clear();
+	}
+
+	EventLoop::timer_id_t EventLoop::runAt(clock::time_point deadline, task_t task) {
+		timer_id_t id = m_nextTimerID++;
+
+		m_timers[{ deadline, id }] = std::move(task);
+		m_timerDeadlines[id]       = deadline;
+
+		return id;
+	}
+
+	EventLoop::timer_id_t EventLoop::runAfter(clock::duration delay, task_t task) {
+		return runAt(clock::now() + delay, std::move(task));
+	}
+
+	void EventLoop::cancelTimer(timer_id_t id) {
+		auto it = m_timerDeadlines.find(id);
+
+		if (it != m_timerDeadlines.end()) {
+			m_timers.erase({ it->second, id });
+			m_timerDeadlines.erase(it);
+		}
+	}
+
+	void EventLoop::runExpiredTimers() {
+		clock::time_point now = clock::now();
+
+		// Timers created by the executed tasks are not run before the next iteration, even if they are due already
+		std::vector< task_t > expired;
+		while (!m_timers.empty() && m_timers.begin()->first.first <= now) {
+			auto it = m_timers.begin();
+
+			m_timerDeadlines.erase(it->first.second);
+			expired.push_back(std::move(it->second));
+			m_timers.erase(it);
+		}
+
+		for (task_t &currentTask : expired) {
+			runTask(currentTask);
+		}
+	}
+
+	EventLoop::clock::time_point EventLoop::nextDeadline() const {
+		return m_timers.empty() ? clock::time_point::max() : m_timers.begin()->first.first;
+	}
+
+	bool EventLoop::isInLoopThread() const noexcept { return m_loopThread.load() == std::this_thread::get_id(); }
+
+}; // namespace JsonBridge
+}; // namespace Mumble
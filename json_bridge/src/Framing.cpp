@@ -0,0 +1,441 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+#include "mumble/json_bridge/Framing.h"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <stdexcept>
+
+#include <boost/algorithm/string.hpp>
+
+#include <nlohmann/json.hpp>
+
+namespace Mumble {
+namespace JsonBridge {
+
+	std::string to_string(Framing framing) {
+		switch (framing) {
+			case Framing::NONE:
+				return "none";
+			case Framing::NEWLINE:
+				return "newline";
+		}
+
+		throw std::invalid_argument(std::string("Unknown framing \"") + std::to_string(static_cast< int >(framing))
+									+ "\"");
+	}
+
+	Framing framing_from_string(const std::string &framing) {
+		if (boost::iequals(framing, "none")) {
+			return Framing::NONE;
+		} else if (boost::iequals(framing, "newline")) {
+			return Framing::NEWLINE;
+		} else {
+			throw std::invalid_argument(std::string("Unknown framing \"") + framing + "\"");
+		}
+	}
+
+	std::string frame(std::string message, Framing framing) {
+		switch (framing) {
+			case Framing::NONE:
+				return message;
+			case Framing::NEWLINE:
+				message.push_back(FRAME_DELIMITER);
+				return message;
+		}
+
+		throw std::invalid_argument(std::string("Unknown framing \"") + std::to_string(static_cast< int >(framing))
+									+ "\"");
+	}
+
+	static bool isBlank(std::string_view str) {
+		for (char current : str) {
+			if (!std::isspace(static_cast< unsigned char >(current))) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	/**
+	 * Follows a JSON document without building it, remembering where the parser gave up (if it did)
+	 */
+	class ErrorPositionSax : public nlohmann::json_sax< nlohmann::json > {
+	public:
+		bool null() override { return true; }
+		bool boolean(bool) override { return true; }
+		bool number_integer(number_integer_t) override { return true; }
+		bool number_unsigned(number_unsigned_t) override { return true; }
+		bool number_float(number_float_t, const string_t &) override { return true; }
+		bool string(string_t &) override { return true; }
+		bool binary(binary_t &) override { return true; }
+		bool start_object(std::size_t) override { return true; }
+		bool key(string_t &) override { return true; }
+		bool end_object() override { return true; }
+		bool start_array(std::size_t) override { return true; }
+		bool end_array() override { return true; }
+		bool parse_error(std::size_t position, const std::string &, const nlohmann::detail::exception &) override {
+			m_errorPosition = position;
+
+			return false;
+		}
+
+		/**
+		 * The position (counted in bytes read, starting at 1) at which the parser has given up
+		 */
+		std::size_t m_errorPosition = 0;
+	};
+
+	/**
+	 * @returns Whether the given data (that is not terminated by a delimiter) should be treated as a complete message.
+	 * This is the case unless the data is the beginning of a JSON document that is still missing its end.
+	 */
+	static bool isCompleteUnterminatedMessage(std::string_view data) {
+		ErrorPositionSax sax;
+		if (nlohmann::json::sax_parse(data.begin(), data.end(), &sax)) {
+			return true;
+		}
+
+		// If the parser ran past the end of the input, the data is incomplete (the writer might be slow). Otherwise the
+		// data is malformed and passing it on allows the error to be reported.
+		return sax.m_errorPosition <= data.size();
+	}
+
+	/**
+	 * The keys of the fields an EnvelopeCapture picks up (in the order of EnvelopeCapture::m_capturedFields)
+	 */
+	static constexpr std::array< std::string_view, 4 > ENVELOPE_KEYS = { "message_type", "client_id", "secret",
+																		 "request_id" };
+	/**
+	 * The amount of bytes of a key an EnvelopeCapture keeps. This only has to be enough to tell the envelope keys
+	 * apart from all others.
+	 */
+	constexpr std::size_t ENVELOPE_MAX_KEY_SIZE = 16;
+
+	std::size_t EnvelopeCapture::feed(std::string_view data) {
+		for (std::size_t i = 0; i < data.size(); ++i) {
+			char current = data[i];
+
+			if (m_complete) {
+				return i;
+			}
+
+			if (m_nestingDepth == 0) {
+				// Before the beginning of the object. If the data turns out to not be an object, there is nothing to
+				// capture and the end of the data is not recognized either.
+				if (current == '{') {
+					m_nestingDepth = 1;
+				} else if (!std::isspace(static_cast< unsigned char >(current))) {
+					m_nestingDepth = -1;
+				}
+
+				continue;
+			}
+
+			if (m_nestingDepth < 0) {
+				return data.size();
+			}
+
+			if (m_inString) {
+				if (m_escaped) {
+					m_escaped = false;
+				} else if (current == '\\') {
+					m_escaped = true;
+				} else if (current == '"') {
+					m_inString = false;
+				}
+
+				if (m_inKey) {
+					if (m_inString && m_key.size() < ENVELOPE_MAX_KEY_SIZE) {
+						m_key.push_back(current);
+					}
+
+					m_inKey = m_inString;
+				} else if (m_capturing) {
+					if (m_value.size() < MAX_VALUE_SIZE) {
+						m_value.push_back(current);
+					} else {
+						m_capturing = false;
+					}
+				}
+
+				continue;
+			}
+
+			if (m_nestingDepth > 1) {
+				// Within a nested value, which is never captured
+				if (current == '"') {
+					m_inString = true;
+				} else if (current == '{' || current == '[') {
+					m_nestingDepth++;
+				} else if (current == '}' || current == ']') {
+					m_nestingDepth--;
+				}
+
+				continue;
+			}
+
+			switch (current) {
+				case '"':
+					m_inString = true;
+
+					if (!m_inValue) {
+						m_inKey = true;
+						m_key.clear();
+					} else if (m_capturing) {
+						m_value.push_back(current);
+					}
+					break;
+				case ':':
+					m_inValue   = true;
+					m_capturing = false;
+					m_value.clear();
+
+					for (std::size_t field = 0; field < ENVELOPE_KEYS.size(); ++field) {
+						if (m_key == ENVELOPE_KEYS[field] && !m_capturedFields.test(field)) {
+							m_capturing = true;
+						}
+					}
+					break;
+				case ',':
+					finishField();
+					break;
+				case '}':
+					finishField();
+
+					m_nestingDepth = 0;
+					m_complete     = true;
+					break;
+				case '{':
+				case '[':
+					m_nestingDepth++;
+					m_capturing = false;
+					break;
+				default:
+					if (m_capturing && !std::isspace(static_cast< unsigned char >(current))) {
+						if (m_value.size() < MAX_VALUE_SIZE) {
+							m_value.push_back(current);
+						} else {
+							m_capturing = false;
+						}
+					}
+			}
+		}
+
+		return data.size();
+	}
+
+	void EnvelopeCapture::finishField() {
+		if (m_capturing && !m_value.empty()) {
+			for (std::size_t field = 0; field < ENVELOPE_KEYS.size(); ++field) {
+				if (m_key == ENVELOPE_KEYS[field]) {
+					m_capturedFields.set(field);
+				}
+			}
+
+			if (!m_fields.empty()) {
+				m_fields.push_back(',');
+			}
+
+			m_fields.push_back('"');
+			m_fields.append(m_key);
+			m_fields.append("\":");
+			m_fields.append(m_value);
+		}
+
+		m_inValue   = false;
+		m_capturing = false;
+		m_value.clear();
+	}
+
+	bool EnvelopeCapture::isComplete() const noexcept { return m_complete; }
+
+	std::string EnvelopeCapture::getEnvelope() const { return "{" + m_fields + "}"; }
+
+	void EnvelopeCapture::reset() { *this = EnvelopeCapture(); }
+
+	FrameReader::FrameReader(std::size_t maxFrameSize) : m_buffer(maxFrameSize + 1) {}
+
+	void FrameReader::setMaxFrameSize(std::size_t maxFrameSize) noexcept { m_buffer.setMaxCapacity(maxFrameSize + 1); }
+
+	void FrameReader::append(std::string_view data) { m_buffer.append(data); }
+
+	ReceiveBuffer &FrameReader::getBuffer() noexcept { return m_buffer; }
+
+	bool FrameReader::scanStructure(std::string_view data, std::size_t &scanned) noexcept {
+		for (scanned = 0; scanned < data.size(); scanned++) {
+			char current = data[scanned];
+
+			if (current == FRAME_DELIMITER) {
+				if (m_nestingDepth <= 0) {
+					return true;
+				}
+
+				if (!m_discarding) {
+					// Newlines within a message (as written by pretty-printers) don't end it
+					continue;
+				}
+
+				if (scanned + 1 == data.size()) {
+					// Whether the frame continues on the next line can only be told once that has arrived
+					return false;
+				}
+
+				if (data[scanned + 1] == '{') {
+					// The frame being discarded is either oversized or a message that has been cut short (and thus
+					// swallowed the following messages until it has exceeded the maximum frame size). Either way a
+					// line starting with an object is the best guess for where the next message begins.
+					return true;
+				}
+			} else if (m_inString) {
+				if (m_escaped) {
+					m_escaped = false;
+				} else if (current == '\\') {
+					m_escaped = true;
+				} else if (current == '"') {
+					m_inString = false;
+				}
+			} else if (current == '"') {
+				m_inString = true;
+			} else if (current == '{' || current == '[') {
+				m_nestingDepth++;
+			} else if (current == '}' || current == ']') {
+				m_nestingDepth--;
+			}
+		}
+
+		return false;
+	}
+
+	void FrameReader::resetScanState() noexcept {
+		m_scannedBytes = 0;
+		m_nestingDepth = 0;
+		m_inString     = false;
+		m_escaped      = false;
+	}
+
+	void FrameReader::discardFrame() {
+		std::string_view pending = m_buffer.view();
+
+		std::size_t frameEnd;
+		bool ended = scanStructure(pending, frameEnd);
+
+		std::size_t frameSize = m_envelopeCapture.feed(pending.substr(0, frameEnd));
+		m_discardedFrame.size += frameSize;
+
+		if (m_envelopeCapture.isComplete()) {
+			// A message without any framing ends with its top-level object
+			m_buffer.consume(frameSize);
+			finishDiscarding();
+		} else if (ended) {
+			m_buffer.consume(frameEnd + 1);
+			finishDiscarding();
+		} else {
+			// Only a trailing newline that might turn out to end the frame is kept
+			m_buffer.consume(frameEnd);
+		}
+	}
+
+	void FrameReader::finishDiscarding() {
+		m_discardedFrame.envelope = m_envelopeCapture.getEnvelope();
+		m_discardedFrames.push_back(std::move(m_discardedFrame));
+
+		m_discardedFrame = DiscardedFrame();
+		m_envelopeCapture.reset();
+		m_discarding = false;
+
+		resetScanState();
+	}
+
+	std::vector< std::string_view > FrameReader::extractFrames() {
+		std::vector< std::string_view > frames;
+
+		if (m_discarding) {
+			discardFrame();
+
+			if (m_discarding) {
+				return frames;
+			}
+		}
+
+		std::string_view pending = m_buffer.view();
+
+		std::size_t frameBegin = 0;
+		std::size_t scanned;
+		while (scanStructure(pending.substr(frameBegin + m_scannedBytes), scanned)) {
+			std::size_t frameEnd   = frameBegin + m_scannedBytes + scanned;
+			std::string_view frame = pending.substr(frameBegin, frameEnd - frameBegin);
+
+			if (!isBlank(frame)) {
+				frames.push_back(frame);
+			}
+
+			// The remaining data belongs to a new message
+			frameBegin = frameEnd + 1;
+			resetScanState();
+		}
+		m_scannedBytes += scanned;
+
+		// Consuming data doesn't invalidate the views into the buffer
+		m_buffer.consume(frameBegin);
+		pending = m_buffer.view();
+
+		if (isBlank(pending)) {
+			m_buffer.clear();
+			resetScanState();
+		} else if (m_buffer.freeCapacity() == 0) {
+			// The frame exceeds the maximum frame size. Instead of buffering it, we drop it bit by bit as it arrives,
+			// only keeping what is needed in order to report the problem to its sender.
+			resetScanState();
+
+			m_discarding = true;
+			discardFrame();
+
+			if (!m_discarding) {
+				// The frame has ended within the buffered data -> continue with whatever follows it
+				std::vector< std::string_view > remainingFrames = extractFrames();
+				frames.insert(frames.end(), remainingFrames.begin(), remainingFrames.end());
+			}
+		} else if (!m_inString && m_nestingDepth <= 0 && isCompleteUnterminatedMessage(pending)) {
+			// A legacy message without any framing
+			frames.push_back(pending);
+
+			m_buffer.consume(pending.size());
+			resetScanState();
+		}
+
+		return frames;
+	}
+
+	std::string FrameReader::flush() {
+		if (m_discarding) {
+			m_buffer.clear();
+			finishDiscarding();
+
+			return {};
+		}
+
+		std::string data(m_buffer.view());
+
+		m_buffer.clear();
+		resetScanState();
+
+		return data;
+	}
+
+	bool FrameReader::hasPendingData() const noexcept { return m_discarding || !m_buffer.empty(); }
+
+	std::vector< DiscardedFrame > FrameReader::takeDiscardedFrames() {
+		std::vector< DiscardedFrame > frames;
+		frames.swap(m_discardedFrames);
+
+		return frames;
+	}
+
+}; // namespace JsonBridge
+}; // namespace Mumble
@@ -0,0 +1,44 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+#include "mumble/json_bridge/NameIndex.h"
+
+namespace Mumble {
+namespace JsonBridge {
+
+	/**
+	 * @returns The given character converted to lower case, if it is an ASCII letter
+	 */
+	static char foldChar(char c) { return c >= 'A' && c <= 'Z' ? static_cast< char >(c - 'A' + 'a') : c; }
+
+	std::string foldCase(std::string_view name) {
+		std::string folded(name);
+		for (char &current : folded) {
+			current = foldChar(current);
+		}
+
+		return folded;
+	}
+
+	bool nameMatches(std::string_view name, std::string_view query, bool caseSensitive, bool prefix) {
+		if (prefix ? name.size() < query.size() : name.size() != query.size()) {
+			return false;
+		}
+
+		if (caseSensitive) {
+			return name.compare(0, query.size(), query) == 0;
+		}
+
+		for (std::size_t i = 0; i < query.size(); i++) {
+			if (foldChar(name[i]) != foldChar(query[i])) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+}; // namespace JsonBridge
+}; // namespace Mumble
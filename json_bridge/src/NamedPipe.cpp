@@ -13,6 +13,8 @@
 #	include <fcntl.h>
 #	include <unistd.h>
 #	include <poll.h>
+#	include <pthread.h>
+#	include <signal.h>
 #	include <sys/stat.h>
 #endif
 
@@ -20,6 +22,7 @@
 #	include <windows.h>
 #endif
 
+#include <chrono>
 #include <fstream>
 #include <iostream>
 
@@ -72,7 +75,9 @@ namespace JsonBridge {
 
 	constexpr int PIPE_WAIT_INTERVAL       = 10;
 	constexpr int PIPE_WRITE_WAIT_INTERVAL = 5;
-	constexpr int PIPE_BUFFER_SIZE         = 32;
+	constexpr int PIPE_BUFFER_SIZE         = 4096;
+	// How long we wait for the remainder of a partially received message before giving up on it
+	constexpr unsigned int PIPE_PARTIAL_FRAME_TIMEOUT = 1000;
 
 #ifdef PLATFORM_UNIX
 	using handle_t = FileHandleWrapper< int, int (*)(int), -1, 0 >;
@@ -89,23 +94,179 @@ namespace JsonBridge {
 		return NamedPipe(pipePath);
 	}
 
-	void NamedPipe::write(const std::filesystem::path &pipePath, const std::string &content, unsigned int timeout) {
-		handle_t handle;
-		do {
-			handle = handle_t(::open(pipePath.c_str(), O_WRONLY | O_NONBLOCK), &::close);
+	void NamedPipe::write(const std::filesystem::path &pipePath, const std::string &content, unsigned int timeout,
+						  Framing framing) {
+		PipeWriter writer(pipePath);
 
-			if (!handle) {
-				if (timeout > PIPE_WRITE_WAIT_INTERVAL) {
-					timeout -= PIPE_WRITE_WAIT_INTERVAL;
-					boost::this_thread::sleep_for(boost::chrono::milliseconds(PIPE_WRITE_WAIT_INTERVAL));
-				} else {
-					throw TimeoutException();
+		writer.write(content, timeout, framing);
+	}
+
+	/**
+	 * Blocks SIGPIPE for the current thread for as long as this object exists. Writing to a pipe without a reader
+	 * raises SIGPIPE, which would terminate the process by default. With the signal blocked, the write fails with
+	 * EPIPE instead.
+	 */
+	class SigpipeGuard : NonCopyable {
+	private:
+		sigset_t m_previousMask;
+		bool m_wasPending;
+
+	public:
+		SigpipeGuard() {
+			sigset_t sigpipe;
+			sigemptyset(&sigpipe);
+			sigaddset(&sigpipe, SIGPIPE);
+
+			pthread_sigmask(SIG_BLOCK, &sigpipe, &m_previousMask);
+
+			sigset_t pending;
+			sigpending(&pending);
+			m_wasPending = sigismember(&pending, SIGPIPE);
+		}
+
+		~SigpipeGuard() { pthread_sigmask(SIG_SETMASK, &m_previousMask, nullptr); }
+
+		/**
+		 * Discards the SIGPIPE raised by a failed write, so that it isn't delivered once the signal is unblocked
+		 * again. A signal that was pending already before this guard was created is left alone.
+		 */
+		void discardSignal() {
+			if (m_wasPending) {
+				return;
+			}
+
+			sigset_t sigpipe;
+			sigemptyset(&sigpipe);
+			sigaddset(&sigpipe, SIGPIPE);
+
+			timespec noWait = { 0, 0 };
+			while (sigtimedwait(&sigpipe, nullptr, &noWait) == -1 && errno == EINTR) {
+			}
+		}
+	};
+
+	bool PipeWriter::open() {
+		if (m_handle == -1) {
+			m_handle = ::open(m_pipePath.c_str(), O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+		}
+
+		return m_handle != -1;
+	}
+
+	void PipeWriter::connect(unsigned int &timeout) {
+		// Opening fails with ENXIO as long as there is no reader (and with ENOENT if the pipe doesn't exist yet)
+		while (!open()) {
+			if (timeout > PIPE_WRITE_WAIT_INTERVAL) {
+				timeout -= PIPE_WRITE_WAIT_INTERVAL;
+				boost::this_thread::sleep_for(boost::chrono::milliseconds(PIPE_WRITE_WAIT_INTERVAL));
+			} else {
+				throw TimeoutException();
+			}
+		}
+	}
+
+	void PipeWriter::write(const std::string &content, unsigned int timeout, Framing framing) {
+		const std::string framedContent = frame(content, framing);
+
+		SigpipeGuard guard;
+
+		bool reconnected    = false;
+		std::size_t written = 0;
+		while (written < framedContent.size()) {
+			if (m_handle == -1) {
+				connect(timeout);
+			}
+
+			ssize_t result = ::write(m_handle, framedContent.data() + written, framedContent.size() - written);
+
+			if (result >= 0) {
+				// The pipe's buffer might not have had enough room for the entire message
+				written += static_cast< std::size_t >(result);
+				continue;
+			}
+
+			switch (errno) {
+				case EINTR:
+					break;
+				case EAGAIN: {
+					// The pipe is full -> wait for the reader to make room
+					pollfd pollData = { m_handle, POLLOUT, 0 };
+					if (::poll(&pollData, 1, PIPE_WRITE_WAIT_INTERVAL) == 0) {
+						if (timeout > PIPE_WRITE_WAIT_INTERVAL) {
+							timeout -= PIPE_WRITE_WAIT_INTERVAL;
+						} else {
+							throw TimeoutException();
+						}
+					}
+					break;
 				}
+				case EPIPE:
+					guard.discardSignal();
+					close();
+
+					if (!reconnected && written == 0) {
+						// The reader has gone away since we last wrote to the pipe. Reopen it, so that we get to
+						// write to whoever is reading now.
+						reconnected = true;
+						break;
+					}
+
+					throw PipeException< int >(EPIPE, "Write");
+				default:
+					int error = errno;
+					close();
+
+					throw PipeException< int >(error, "Write");
 			}
-		} while (!handle);
+		}
+	}
 
-		if (::write(handle, content.c_str(), content.size()) < 0) {
-			throw PipeException< int >(errno, "Write");
+	std::size_t PipeWriter::tryWrite(std::string_view data) {
+		if (!open()) {
+			// There is no reader
+			return 0;
+		}
+
+		SigpipeGuard guard;
+
+		std::size_t written = 0;
+		while (written < data.size()) {
+			ssize_t result = ::write(m_handle, data.data() + written, data.size() - written);
+
+			if (result >= 0) {
+				written += static_cast< std::size_t >(result);
+				continue;
+			}
+
+			if (errno == EINTR) {
+				continue;
+			}
+			if (errno == EAGAIN) {
+				// The pipe is full
+				break;
+			}
+			if (errno == EPIPE) {
+				// The reader has gone away
+				guard.discardSignal();
+				close();
+				break;
+			}
+
+			int error = errno;
+			close();
+
+			throw PipeException< int >(error, "Write");
+		}
+
+		return written;
+	}
+
+	int PipeWriter::getHandle() const noexcept { return m_handle; }
+
+	void PipeWriter::close() noexcept {
+		if (m_handle != -1) {
+			::close(m_handle);
+			m_handle = -1;
 		}
 	}
 
@@ -114,43 +275,102 @@ namespace JsonBridge {
 		return std::filesystem::exists(pipePath);
 	}
 
-	std::string NamedPipe::read_blocking(unsigned int timeout) const {
-		std::string content;
+	void NamedPipe::openPersistentReader() {
+		if (m_readHandle != -1) {
+			return;
+		}
 
-		handle_t handle(::open(m_pipePath.c_str(), O_RDONLY | O_NONBLOCK), &::close);
+		// Opening the FIFO for reading and writing means that there is always at least one writer (us) and therefore
+		// read() will never report EOF just because the last client has closed its end of the pipe. It also means
+		// that open() does not block waiting for a writer to appear.
+		m_readHandle = ::open(m_pipePath.c_str(), O_RDWR | O_NONBLOCK);
 
-		if (handle == -1) {
+		if (m_readHandle == -1) {
+			throw PipeException< int >(errno, "Open persistent reader");
+		}
+	}
+
+	/**
+	 * Opens the pipe at the given path for reading, unless there is a long-lived handle for it already
+	 *
+	 * @param pipePath The path of the pipe
+	 * @param persistentHandle The pipe's long-lived handle or -1 if there is none
+	 * @param ownedHandle The wrapper that takes ownership of the handle if one has to be opened
+	 * @returns The handle to read from
+	 */
+	static int openForReading(const std::filesystem::path &pipePath, int persistentHandle, handle_t &ownedHandle) {
+		if (persistentHandle != -1) {
+			return persistentHandle;
+		}
+
+		ownedHandle = handle_t(::open(pipePath.c_str(), O_RDONLY | O_NONBLOCK), &::close);
+
+		if (!ownedHandle) {
 			throw PipeException< int >(errno, "Open");
 		}
 
+		return ownedHandle.get();
+	}
+
+	/**
+	 * Waits until there is data available on the given handle
+	 *
+	 * @param handle The handle to wait on
+	 * @param timeout How long to wait at most
+	 */
+	static void waitForData(int handle, unsigned int timeout) {
 		pollfd pollData = { handle, POLLIN, 0 };
 		while (::poll(&pollData, 1, PIPE_WAIT_INTERVAL) != -1 && !(pollData.revents & POLLIN)) {
 			// Check if the thread has been interrupted
 			boost::this_thread::interruption_point();
 
+			if (pollData.revents & POLLHUP) {
+				// A writer has closed its end of the pipe before we got to see any data. poll() will keep on
+				// reporting this state immediately until the next writer shows up, so we have to wait explicitly in
+				// order to not spin through the timeout.
+				boost::this_thread::sleep_for(boost::chrono::milliseconds(PIPE_WAIT_INTERVAL));
+			}
+
 			if (timeout > PIPE_WAIT_INTERVAL) {
 				timeout -= PIPE_WAIT_INTERVAL;
 			} else {
 				throw TimeoutException();
 			}
 		}
+	}
 
-		char buffer[PIPE_BUFFER_SIZE];
+	std::string NamedPipe::read_blocking(unsigned int timeout) const {
+		// In long-lived reader mode we reuse the already open handle. Otherwise the pipe has to be opened for the
+		// duration of this call.
+		handle_t ownedHandle;
+		int handle = openForReading(m_pipePath, m_readHandle, ownedHandle);
 
-		ssize_t readBytes;
-		while ((readBytes = ::read(handle, &buffer, PIPE_BUFFER_SIZE)) > 0) {
-			content.append(buffer, readBytes);
-		}
+		waitForData(handle, timeout);
 
-		// 0 Means there is no more input, negative numbers indicate errors
-		// If the error simply is EAGAIN this means that the message has been read completely
-		// and a request for further data would block (since atm there is no more data available).
-		if (readBytes == -1 && errno != EAGAIN) {
-			throw PipeException< int >(errno, "Read");
-		}
+		ReceiveBuffer buffer;
+		buffer.readFrom(handle);
 
-		return content;
+		return std::string(buffer.view());
 	}
+
+	void NamedPipe::receive(unsigned int timeout) const {
+		handle_t ownedHandle;
+		int handle = openForReading(m_pipePath, m_readHandle, ownedHandle);
+
+		waitForData(handle, timeout);
+
+		m_frameReader.getBuffer().readFrom(handle);
+	}
+
+	std::vector< std::string_view > NamedPipe::read_available_frames() const {
+		MUMBLE_ASSERT(m_readHandle != -1);
+
+		m_frameReader.getBuffer().readFrom(m_readHandle);
+
+		return m_frameReader.extractFrames();
+	}
+
+	int NamedPipe::getReadHandle() const noexcept { return m_readHandle; }
 #endif
 
 #ifdef PLATFORM_WINDOWS
@@ -200,13 +420,29 @@ namespace JsonBridge {
 		return pipe;
 	}
 
-	void NamedPipe::write(const std::filesystem::path &pipePath, const std::string &content, unsigned int timeout) {
+	void NamedPipe::write(const std::filesystem::path &pipePath, const std::string &content, unsigned int timeout,
+						  Framing framing) {
 		MUMBLE_ASSERT(pipePath.parent_path() == "\\\\.\\pipe");
 
+		PipeWriter writer(pipePath);
+
+		writer.write(content, timeout, framing);
+	}
+
+	bool PipeWriter::open() {
+		if (m_handle == INVALID_HANDLE_VALUE) {
+			m_handle = CreateFile(m_pipePath.string().c_str(), GENERIC_WRITE, 0, NULL, OPEN_EXISTING,
+								  FILE_FLAG_OVERLAPPED, NULL);
+		}
+
+		return m_handle != INVALID_HANDLE_VALUE;
+	}
+
+	void PipeWriter::connect(unsigned int &timeout) {
 		while (true) {
 			// We can't use a timeout of 0 as this would be the special value NMPWAIT_USE_DEFAULT_WAIT causing
 			// the function to use a default wait-time
-			if (!WaitNamedPipe(pipePath.string().c_str(), 1)) {
+			if (!WaitNamedPipe(m_pipePath.string().c_str(), 1)) {
 				if (GetLastError() == ERROR_FILE_NOT_FOUND || GetLastError() == ERROR_SEM_TIMEOUT) {
 					if (timeout > PIPE_WRITE_WAIT_INTERVAL) {
 						timeout -= PIPE_WRITE_WAIT_INTERVAL;
@@ -224,22 +460,52 @@ namespace JsonBridge {
 			}
 		}
 
-		handle_t handle(
-			CreateFile(pipePath.string().c_str(), GENERIC_WRITE, 0, NULL, OPEN_EXISTING, FILE_FLAG_OVERLAPPED, NULL),
-			&CloseHandle);
-
-		if (!handle) {
+		if (!open()) {
 			throw PipeException< DWORD >(GetLastError(), "Open for write");
 		}
+	}
 
-		OVERLAPPED overlapped;
-		memset(&overlapped, 0, sizeof(OVERLAPPED));
-		if (!WriteFile(handle, content.c_str(), static_cast< DWORD >(content.size()), NULL, &overlapped)) {
-			if (GetLastError() == ERROR_IO_PENDING) {
-				waitOnAsyncIO(handle, &overlapped, timeout);
-			} else {
-				throw PipeException< DWORD >(GetLastError(), "Write");
+	void PipeWriter::write(const std::string &content, unsigned int timeout, Framing framing) {
+		const std::string framedContent = frame(content, framing);
+
+		bool reconnected = false;
+		while (true) {
+			if (m_handle == INVALID_HANDLE_VALUE) {
+				connect(timeout);
+			}
+
+			OVERLAPPED overlapped;
+			memset(&overlapped, 0, sizeof(OVERLAPPED));
+			if (WriteFile(m_handle, framedContent.c_str(), static_cast< DWORD >(framedContent.size()), NULL,
+						  &overlapped)) {
+				return;
 			}
+
+			DWORD error = GetLastError();
+			if (error == ERROR_IO_PENDING) {
+				waitOnAsyncIO(m_handle, &overlapped, timeout);
+
+				return;
+			}
+
+			close();
+
+			if (!reconnected
+				&& (error == ERROR_NO_DATA || error == ERROR_PIPE_NOT_CONNECTED || error == ERROR_BROKEN_PIPE)) {
+				// The reader has disconnected since we last wrote to the pipe. Reopen it, so that we get to write to
+				// whoever is reading now.
+				reconnected = true;
+				continue;
+			}
+
+			throw PipeException< DWORD >(error, "Write");
+		}
+	}
+
+	void PipeWriter::close() noexcept {
+		if (m_handle != INVALID_HANDLE_VALUE) {
+			CloseHandle(m_handle);
+			m_handle = INVALID_HANDLE_VALUE;
 		}
 	}
 
@@ -307,6 +573,12 @@ namespace JsonBridge {
 		}
 	}
 
+	void NamedPipe::openPersistentReader() {
+		// The handle obtained from CreateNamedPipe is kept for the entire lifetime of this object already
+	}
+
+	void NamedPipe::receive(unsigned int timeout) const { m_frameReader.append(read_blocking(timeout)); }
+
 	std::string NamedPipe::read_blocking(unsigned int timeout) const {
 		std::string content;
 
@@ -390,14 +662,17 @@ namespace JsonBridge {
 	NamedPipe::NamedPipe(const std::filesystem::path &path) : m_pipePath(path) {}
 
 #ifdef PLATFORM_WINDOWS
-	NamedPipe::NamedPipe(NamedPipe &&other) : m_pipePath(std::move(other.m_pipePath)), m_handle(other.m_handle) {
+	NamedPipe::NamedPipe(NamedPipe &&other)
+		: m_pipePath(std::move(other.m_pipePath)), m_handle(other.m_handle),
+		  m_frameReader(std::move(other.m_frameReader)) {
 		other.m_pipePath.clear();
 		other.m_handle = INVALID_HANDLE_VALUE;
 	}
 
 	NamedPipe &NamedPipe::operator=(NamedPipe &&other) {
-		m_pipePath = std::move(other.m_pipePath);
-		m_handle   = other.m_handle;
+		m_pipePath    = std::move(other.m_pipePath);
+		m_handle      = other.m_handle;
+		m_frameReader = std::move(other.m_frameReader);
 
 		other.m_pipePath.clear();
 		other.m_handle = INVALID_HANDLE_VALUE;
@@ -416,17 +691,37 @@ namespace JsonBridge {
 		}
 	}
 #else  // PLATFORM_WINDOWS
-	NamedPipe::NamedPipe(NamedPipe &&other) : m_pipePath(std::move(other.m_pipePath)) { other.m_pipePath.clear(); }
+	NamedPipe::NamedPipe(NamedPipe &&other)
+		: m_pipePath(std::move(other.m_pipePath)), m_readHandle(other.m_readHandle),
+		  m_frameReader(std::move(other.m_frameReader)) {
+		other.m_pipePath.clear();
+		other.m_readHandle = -1;
+	}
 
 	NamedPipe &NamedPipe::operator=(NamedPipe &&other) {
-		m_pipePath = std::move(other.m_pipePath);
+		if (m_readHandle != -1) {
+			::close(m_readHandle);
+		}
+
+		m_pipePath    = std::move(other.m_pipePath);
+		m_readHandle  = other.m_readHandle;
+		m_frameReader = std::move(other.m_frameReader);
 
 		other.m_pipePath.clear();
+		other.m_readHandle = -1;
 
 		return *this;
 	}
 
 	void NamedPipe::destroy() {
+		if (m_readHandle != -1) {
+			if (::close(m_readHandle) != 0) {
+				std::cerr << "Failed at closing pipe handle: " << errno << std::endl;
+			}
+
+			m_readHandle = -1;
+		}
+
 		if (!m_pipePath.empty()) {
 			std::error_code errorCode;
 			std::filesystem::remove(m_pipePath, errorCode);
@@ -444,11 +739,99 @@ namespace JsonBridge {
 
 	std::filesystem::path NamedPipe::getPath() const noexcept { return m_pipePath; }
 
-	void NamedPipe::write(const std::string &content, unsigned int timeout) const {
-		write(m_pipePath, content, timeout);
+	void NamedPipe::write(const std::string &content, unsigned int timeout, Framing framing) const {
+		write(m_pipePath, content, timeout, framing);
+	}
+
+	std::vector< std::string > NamedPipe::read_frames(unsigned int timeout) const {
+		auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+
+		while (true) {
+			if (m_frameReader.hasPendingData() && timeout > PIPE_PARTIAL_FRAME_TIMEOUT) {
+				try {
+					receive(PIPE_PARTIAL_FRAME_TIMEOUT);
+				} catch (const TimeoutException &) {
+					// The rest of the message didn't arrive in time. Pass on what we have got, so that the problem
+					// can be reported instead of having the partial message prepended to whatever arrives next.
+					std::string partialFrame = m_frameReader.flush();
+
+					if (!partialFrame.empty()) {
+						return { std::move(partialFrame) };
+					}
+				}
+			} else {
+				receive(timeout);
+			}
+
+			std::vector< std::string_view > frames = m_frameReader.extractFrames();
+
+			if (!frames.empty()) {
+				return std::vector< std::string >(frames.begin(), frames.end());
+			}
+
+			// We have only received the beginning of a message so far -> wait for the rest of it
+			auto now = std::chrono::steady_clock::now();
+			if (now >= deadline) {
+				throw TimeoutException();
+			}
+
+			timeout = static_cast< unsigned int >(
+				std::chrono::duration_cast< std::chrono::milliseconds >(deadline - now).count());
+		}
+	}
+
+	bool NamedPipe::hasPartialFrame() const noexcept { return m_frameReader.hasPendingData(); }
+
+	std::string NamedPipe::flushPartialFrame() const { return m_frameReader.flush(); }
+
+	void NamedPipe::setMaxFrameSize(std::size_t size) noexcept { m_frameReader.setMaxFrameSize(size); }
+
+	std::vector< DiscardedFrame > NamedPipe::takeDiscardedFrames() const {
+		return m_frameReader.takeDiscardedFrames();
+	}
+
+	const ReceiveBuffer::Statistics &NamedPipe::getReceiveStatistics() const noexcept {
+		return m_frameReader.getBuffer().getStatistics();
 	}
 
 	NamedPipe::operator bool() const noexcept { return !m_pipePath.empty(); }
 
+	PipeWriter::PipeWriter(const std::filesystem::path &pipePath) : m_pipePath(pipePath) {}
+
+	PipeWriter::~PipeWriter() { close(); }
+
+	PipeWriter::PipeWriter(PipeWriter &&other) : m_pipePath(std::move(other.m_pipePath)), m_handle(other.m_handle) {
+		other.m_pipePath.clear();
+#ifdef PLATFORM_WINDOWS
+		other.m_handle = INVALID_HANDLE_VALUE;
+#else
+		other.m_handle = -1;
+#endif
+	}
+
+	PipeWriter &PipeWriter::operator=(PipeWriter &&other) {
+		close();
+
+		m_pipePath = std::move(other.m_pipePath);
+		m_handle   = other.m_handle;
+
+		other.m_pipePath.clear();
+#ifdef PLATFORM_WINDOWS
+		other.m_handle = INVALID_HANDLE_VALUE;
+#else
+		other.m_handle = -1;
+#endif
+
+		return *this;
+	}
+
+#ifdef PLATFORM_WINDOWS
+	bool PipeWriter::isOpen() const noexcept { return m_handle != INVALID_HANDLE_VALUE; }
+#else
+	bool PipeWriter::isOpen() const noexcept { return m_handle != -1; }
+#endif
+
+	const std::filesystem::path &PipeWriter::getPath() const noexcept { return m_pipePath; }
+
 }; // namespace JsonBridge
 }; // namespace Mumble
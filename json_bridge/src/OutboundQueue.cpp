@@ -0,0 +1,154 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+#include "mumble/json_bridge/OutboundQueue.h"
+#include "mumble/json_bridge/BufferPool.h"
+#include "mumble/json_bridge/MumbleAssert.h"
+
+#include <iterator>
+
+namespace Mumble {
+namespace JsonBridge {
+
+	OutboundQueue::OutboundQueue(std::size_t maxQueuedBytes, OutboundStatistics *sharedStatistics)
+		: m_maxQueuedBytes(maxQueuedBytes), m_sharedStatistics(sharedStatistics) {}
+
+	OutboundQueue::~OutboundQueue() {
+		// Whatever is still queued at this point is never going to be written
+		dropAll();
+	}
+
+	OutboundQueue::OutboundQueue(OutboundQueue &&other)
+		: m_messages(std::move(other.m_messages)), m_firstMessage(other.m_firstMessage),
+		  m_frontOffset(other.m_frontOffset), m_queuedBytes(other.m_queuedBytes),
+		  m_maxQueuedBytes(other.m_maxQueuedBytes), m_droppedMessages(other.m_droppedMessages),
+		  m_sharedStatistics(other.m_sharedStatistics) {
+		other.m_messages.clear();
+		other.m_firstMessage = 0;
+		other.m_frontOffset  = 0;
+		other.m_queuedBytes  = 0;
+	}
+
+	OutboundQueue &OutboundQueue::operator=(OutboundQueue &&other) {
+		dropAll();
+
+		m_messages         = std::move(other.m_messages);
+		m_firstMessage     = other.m_firstMessage;
+		m_frontOffset      = other.m_frontOffset;
+		m_queuedBytes      = other.m_queuedBytes;
+		m_maxQueuedBytes   = other.m_maxQueuedBytes;
+		m_droppedMessages  = other.m_droppedMessages;
+		m_sharedStatistics = other.m_sharedStatistics;
+
+		other.m_messages.clear();
+		other.m_firstMessage = 0;
+		other.m_frontOffset  = 0;
+		other.m_queuedBytes  = 0;
+
+		return *this;
+	}
+
+	bool OutboundQueue::push(std::string message) {
+		// A message that is larger than the limit on its own is still admitted into an empty queue as it could never
+		// be delivered otherwise
+		if (!empty() && m_queuedBytes + message.size() > m_maxQueuedBytes) {
+			m_droppedMessages++;
+			if (m_sharedStatistics) {
+				m_sharedStatistics->droppedMessages++;
+			}
+
+			return false;
+		}
+
+		forcePush(std::move(message));
+
+		return true;
+	}
+
+	void OutboundQueue::forcePush(std::string message) {
+		m_queuedBytes += message.size();
+		if (m_sharedStatistics) {
+			m_sharedStatistics->queuedBytes += message.size();
+		}
+
+		m_messages.push_back(std::move(message));
+	}
+
+	std::string_view OutboundQueue::front() const noexcept {
+		MUMBLE_ASSERT(!empty());
+
+		return std::string_view(m_messages[m_firstMessage]).substr(m_frontOffset);
+	}
+
+	void OutboundQueue::pop() noexcept {
+		std::string &message = m_messages[m_firstMessage];
+
+		std::size_t remainingBytes = message.size() - m_frontOffset;
+
+		m_queuedBytes -= remainingBytes;
+		if (m_sharedStatistics) {
+			m_sharedStatistics->queuedBytes -= remainingBytes;
+		}
+
+		BufferPool::shared().giveBack(std::move(message));
+		m_firstMessage++;
+		m_frontOffset = 0;
+
+		if (m_firstMessage == m_messages.size()) {
+			m_messages.clear();
+			m_firstMessage = 0;
+		} else if (m_firstMessage * 2 >= m_messages.size()) {
+			m_messages.erase(m_messages.begin(), std::next(m_messages.begin(), m_firstMessage));
+			m_firstMessage = 0;
+		}
+	}
+
+	void OutboundQueue::consume(std::size_t bytes) noexcept {
+		if (bytes == 0) {
+			return;
+		}
+
+		MUMBLE_ASSERT(bytes <= front().size());
+
+		if (m_frontOffset + bytes == m_messages[m_firstMessage].size()) {
+			pop();
+		} else {
+			m_frontOffset += bytes;
+			m_queuedBytes -= bytes;
+			if (m_sharedStatistics) {
+				m_sharedStatistics->queuedBytes -= bytes;
+			}
+		}
+	}
+
+	bool OutboundQueue::isFrontPartiallyWritten() const noexcept { return m_frontOffset > 0; }
+
+	void OutboundQueue::dropFront() noexcept {
+		MUMBLE_ASSERT(!empty());
+
+		pop();
+
+		m_droppedMessages++;
+		if (m_sharedStatistics) {
+			m_sharedStatistics->droppedMessages++;
+		}
+	}
+
+	void OutboundQueue::dropAll() noexcept {
+		while (!empty()) {
+			dropFront();
+		}
+	}
+
+	bool OutboundQueue::empty() const noexcept { return m_firstMessage == m_messages.size(); }
+
+	std::size_t OutboundQueue::size() const noexcept { return m_messages.size() - m_firstMessage; }
+
+	std::size_t OutboundQueue::getQueuedBytes() const noexcept { return m_queuedBytes; }
+
+	std::uint64_t OutboundQueue::getDroppedMessages() const noexcept { return m_droppedMessages; }
+
+}; // namespace JsonBridge
+}; // namespace Mumble
@@ -0,0 +1,160 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+#include "mumble/json_bridge/ReceiveBuffer.h"
+#include "mumble/json_bridge/MumbleAssert.h"
+#include "mumble/json_bridge/NamedPipe.h"
+
+#ifdef PLATFORM_UNIX
+#	include <sys/uio.h>
+#	include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+namespace Mumble {
+namespace JsonBridge {
+
+	// The size of the stack-allocated area that reads spill over into if the buffer itself doesn't have enough room
+	constexpr std::size_t RECEIVEBUFFER_OVERFLOW_AREA_SIZE = 64 * 1024;
+
+	ReceiveBuffer::ReceiveBuffer(std::size_t maxCapacity) : m_maxCapacity(maxCapacity) {}
+
+	void ReceiveBuffer::reserve(std::size_t size) {
+		if (m_data.size() - m_end >= size) {
+			return;
+		}
+
+		MUMBLE_ASSERT(size <= freeCapacity());
+
+		// Reclaim the space of the data that has been consumed already
+		std::size_t used = m_end - m_begin;
+		if (m_begin > 0) {
+			std::memmove(m_data.data(), m_data.data() + m_begin, used);
+			m_begin = 0;
+			m_end   = used;
+		}
+
+		if (m_data.size() - m_end < size) {
+			// Grow exponentially in order to keep the amount of reallocations low
+			std::size_t newCapacity = std::max({ INITIAL_CAPACITY, 2 * m_data.size(), used + size });
+
+			m_data.resize(std::min(newCapacity, std::max(m_maxCapacity, used + size)));
+		}
+	}
+
+	std::string_view ReceiveBuffer::view() const noexcept {
+		return std::string_view(m_data.data() + m_begin, m_end - m_begin);
+	}
+
+	std::size_t ReceiveBuffer::size() const noexcept { return m_end - m_begin; }
+
+	bool ReceiveBuffer::empty() const noexcept { return m_begin == m_end; }
+
+	std::size_t ReceiveBuffer::freeCapacity() const noexcept {
+		return m_maxCapacity > size() ? m_maxCapacity - size() : 0;
+	}
+
+	std::size_t ReceiveBuffer::capacity() const noexcept { return m_data.size(); }
+
+	std::size_t ReceiveBuffer::maxCapacity() const noexcept { return m_maxCapacity; }
+
+	void ReceiveBuffer::setMaxCapacity(std::size_t maxCapacity) noexcept { m_maxCapacity = maxCapacity; }
+
+	void ReceiveBuffer::consume(std::size_t size) noexcept {
+		MUMBLE_ASSERT(size <= this->size());
+
+		m_begin += size;
+
+		if (m_begin == m_end) {
+			// Start over at the front, so that new data doesn't have to be moved there later on
+			m_begin = 0;
+			m_end   = 0;
+		}
+	}
+
+	void ReceiveBuffer::clear() noexcept {
+		m_begin = 0;
+		m_end   = 0;
+	}
+
+	std::size_t ReceiveBuffer::append(std::string_view data) {
+		std::size_t size = std::min(data.size(), freeCapacity());
+
+		if (size > 0) {
+			reserve(size);
+
+			std::memcpy(m_data.data() + m_end, data.data(), size);
+			m_end += size;
+		}
+
+		return size;
+	}
+
+#ifdef PLATFORM_UNIX
+	std::size_t ReceiveBuffer::readFrom(int fd) {
+		char overflowArea[RECEIVEBUFFER_OVERFLOW_AREA_SIZE];
+
+		std::size_t totalBytes = 0;
+
+		while (freeCapacity() > 0) {
+			if (m_end == m_data.size()) {
+				// Make sure there is at least some room in the buffer itself
+				reserve(std::min(freeCapacity(), INITIAL_CAPACITY));
+			}
+
+			std::size_t bufferRoom   = std::min(m_data.size() - m_end, freeCapacity());
+			std::size_t overflowRoom = std::min(RECEIVEBUFFER_OVERFLOW_AREA_SIZE, freeCapacity() - bufferRoom);
+
+			iovec vectors[2] = { { m_data.data() + m_end, bufferRoom }, { overflowArea, overflowRoom } };
+
+			m_statistics.readCalls++;
+			ssize_t readBytes = ::readv(fd, vectors, overflowRoom > 0 ? 2 : 1);
+
+			if (readBytes < 0) {
+				if (errno == EINTR) {
+					continue;
+				}
+				if (errno == EAGAIN) {
+					// There is no more data available right now
+					break;
+				}
+
+				throw PipeException< int >(errno, "Read");
+			}
+
+			if (readBytes == 0) {
+				// EOF
+				break;
+			}
+
+			std::size_t bytes = static_cast< std::size_t >(readBytes);
+			m_statistics.readBytes += bytes;
+			totalBytes += bytes;
+
+			if (bytes <= bufferRoom) {
+				m_end += bytes;
+			} else {
+				m_end += bufferRoom;
+				append(std::string_view(overflowArea, bytes - bufferRoom));
+			}
+
+			if (bytes < bufferRoom + overflowRoom) {
+				// A short read means that we have drained everything that is available at the moment. Thus there is no
+				// need to issue another read that would only report EAGAIN.
+				break;
+			}
+		}
+
+		return totalBytes;
+	}
+#endif
+
+	const ReceiveBuffer::Statistics &ReceiveBuffer::getStatistics() const noexcept { return m_statistics; }
+
+}; // namespace JsonBridge
+}; // namespace Mumble
@@ -0,0 +1,68 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+#include "mumble/json_bridge/ResponseWriter.h"
+
+namespace Mumble {
+namespace JsonBridge {
+
+	ResponseWriter::ResponseWriter(std::string &buffer) : m_buffer(buffer) {}
+
+	void ResponseWriter::string(std::string_view str) {
+		constexpr char hexDigits[] = "0123456789abcdef";
+
+		m_buffer.push_back('"');
+
+		// Copy the characters that don't need escaping in chunks
+		std::size_t chunkStart = 0;
+		for (std::size_t i = 0; i < str.size(); i++) {
+			unsigned char current = static_cast< unsigned char >(str[i]);
+
+			if (current >= 0x20 && current != '"' && current != '\\') {
+				continue;
+			}
+
+			m_buffer.append(str.data() + chunkStart, i - chunkStart);
+			chunkStart = i + 1;
+
+			// Escape the same way nlohmann::json::dump() does
+			switch (current) {
+				case '"':
+					m_buffer.append("\\\"");
+					break;
+				case '\\':
+					m_buffer.append("\\\\");
+					break;
+				case '\b':
+					m_buffer.append("\\b");
+					break;
+				case '\f':
+					m_buffer.append("\\f");
+					break;
+				case '\n':
+					m_buffer.append("\\n");
+					break;
+				case '\r':
+					m_buffer.append("\\r");
+					break;
+				case '\t':
+					m_buffer.append("\\t");
+					break;
+				default:
+					m_buffer.append("\\u00");
+					m_buffer.push_back(hexDigits[current >> 4]);
+					m_buffer.push_back(hexDigits[current & 0xF]);
+					break;
+			}
+		}
+
+		m_buffer.append(str.data() + chunkStart, str.size() - chunkStart);
+		m_buffer.push_back('"');
+	}
+
+	void ResponseWriter::value(const nlohmann::json &json) { m_buffer.append(json.dump()); }
+
+}; // namespace JsonBridge
+}; // namespace Mumble
@@ -0,0 +1,478 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+#include "mumble/json_bridge/SeqPacketSocket.h"
+#include "mumble/json_bridge/NamedPipe.h"
+
+#ifdef PLATFORM_UNIX
+#	include <poll.h>
+#	include <sys/socket.h>
+#	include <sys/stat.h>
+#	include <sys/un.h>
+#	include <unistd.h>
+
+#	include <boost/thread/thread.hpp>
+
+#	include <cerrno>
+#	include <cstddef>
+#	include <cstring>
+
+namespace Mumble {
+namespace JsonBridge {
+
+	// The interval in which connecting to a listener that doesn't exist (yet) is retried
+	constexpr unsigned int SOCKET_CONNECT_WAIT_INTERVAL = 10;
+
+	/**
+	 * Translates the given address into a socket address
+	 *
+	 * @param address The address. If it starts with an '@', it refers to the abstract namespace.
+	 * @param socketAddress The socket address to fill in
+	 * @returns The length of the socket address
+	 */
+	static socklen_t toSocketAddress(const std::string &address, sockaddr_un &socketAddress) {
+		std::memset(&socketAddress, 0, sizeof(socketAddress));
+		socketAddress.sun_family = AF_UNIX;
+
+		// The abstract namespace is indicated by a leading null byte. Filesystem paths have to be null-terminated.
+		bool abstract = !address.empty() && address[0] == '@';
+		if (address.empty() || address.size() >= sizeof(socketAddress.sun_path)) {
+			throw PipeException< int >(ENAMETOOLONG, "Socket address");
+		}
+
+		std::memcpy(socketAddress.sun_path, address.data(), address.size());
+		if (abstract) {
+			socketAddress.sun_path[0] = '\0';
+
+			return static_cast< socklen_t >(offsetof(sockaddr_un, sun_path) + address.size());
+		}
+
+		return static_cast< socklen_t >(offsetof(sockaddr_un, sun_path) + address.size() + 1);
+	}
+
+	/**
+	 * Waits until the given events are reported for the given handle
+	 *
+	 * @param handle The handle to wait on
+	 * @param events The events to wait for
+	 * @param timeout How long to wait at most (in milliseconds)
+	 */
+	static void waitFor(int handle, short events, unsigned int timeout) {
+		pollfd pollData = { handle, events, 0 };
+
+		int result;
+		do {
+			int pollTimeout = timeout > static_cast< unsigned int >((std::numeric_limits< int >::max)())
+								  ? -1
+								  : static_cast< int >(timeout);
+
+			result = ::poll(&pollData, 1, pollTimeout);
+		} while (result == -1 && errno == EINTR);
+
+		if (result == 0) {
+			throw TimeoutException();
+		}
+		if (result == -1) {
+			throw PipeException< int >(errno, "Poll");
+		}
+	}
+
+	// The maximum amount of file descriptors that can be received along with a single message
+	constexpr std::size_t SOCKET_MAX_PASSED_HANDLES = 4;
+
+	/**
+	 * Closes all file descriptors passed along with the given (received) message
+	 *
+	 * @param header The header of the received message
+	 * @param handles If not nullptr, the passed file descriptors are handed over to this vector instead of being closed
+	 */
+	static void takePassedHandles(msghdr &header, std::vector< int > *handles) {
+		for (cmsghdr *control = CMSG_FIRSTHDR(&header); control; control = CMSG_NXTHDR(&header, control)) {
+			if (control->cmsg_level != SOL_SOCKET || control->cmsg_type != SCM_RIGHTS) {
+				continue;
+			}
+
+			std::size_t count = (control->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+			for (std::size_t i = 0; i < count; i++) {
+				int handle;
+				std::memcpy(&handle, CMSG_DATA(control) + i * sizeof(int), sizeof(int));
+
+				if (handles) {
+					handles->push_back(handle);
+				} else {
+					::close(handle);
+				}
+			}
+		}
+	}
+
+	SeqPacketSocket::SeqPacketSocket(int handle) : m_handle(handle), m_connected(handle != -1) {}
+
+	SeqPacketSocket::~SeqPacketSocket() { close(); }
+
+	SeqPacketSocket::SeqPacketSocket(SeqPacketSocket &&other)
+		: m_handle(other.m_handle), m_connected(other.m_connected) {
+		other.m_handle    = -1;
+		other.m_connected = false;
+	}
+
+	SeqPacketSocket &SeqPacketSocket::operator=(SeqPacketSocket &&other) {
+		close();
+
+		m_handle    = other.m_handle;
+		m_connected = other.m_connected;
+
+		other.m_handle    = -1;
+		other.m_connected = false;
+
+		return *this;
+	}
+
+	SeqPacketSocket SeqPacketSocket::connect(const std::string &address, unsigned int timeout) {
+		sockaddr_un socketAddress;
+		socklen_t addressLength = toSocketAddress(address, socketAddress);
+
+		while (true) {
+			SeqPacketSocket socket(::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0));
+			if (!socket.isOpen()) {
+				throw PipeException< int >(errno, "Socket");
+			}
+
+			if (::connect(socket.m_handle, reinterpret_cast< const sockaddr * >(&socketAddress), addressLength) == 0) {
+				return socket;
+			}
+
+			switch (errno) {
+				case EINTR:
+					break;
+				case ENOENT:
+				case ECONNREFUSED:
+				case EAGAIN:
+					// There is no listener (yet) or its backlog is full
+					if (timeout > SOCKET_CONNECT_WAIT_INTERVAL) {
+						timeout -= SOCKET_CONNECT_WAIT_INTERVAL;
+						boost::this_thread::sleep_for(boost::chrono::milliseconds(SOCKET_CONNECT_WAIT_INTERVAL));
+					} else {
+						throw TimeoutException();
+					}
+					break;
+				default:
+					throw PipeException< int >(errno, "Connect");
+			}
+		}
+	}
+
+	void SeqPacketSocket::send(std::string_view message, unsigned int timeout) const {
+		while (::send(m_handle, message.data(), message.size(), MSG_NOSIGNAL) < 0) {
+			switch (errno) {
+				case EINTR:
+					break;
+				case EAGAIN:
+					waitFor(m_handle, POLLOUT, timeout);
+					break;
+				default:
+					throw PipeException< int >(errno, "Send");
+			}
+		}
+	}
+
+	bool SeqPacketSocket::trySend(std::string_view message, const std::vector< int > &handles) {
+		iovec vector = { const_cast< char * >(message.data()), message.size() };
+
+		msghdr header     = {};
+		header.msg_iov    = &vector;
+		header.msg_iovlen = 1;
+
+		std::vector< char > control;
+		if (!handles.empty()) {
+			control.resize(CMSG_SPACE(handles.size() * sizeof(int)));
+
+			header.msg_control    = control.data();
+			header.msg_controllen = control.size();
+
+			cmsghdr *handleData    = CMSG_FIRSTHDR(&header);
+			handleData->cmsg_level = SOL_SOCKET;
+			handleData->cmsg_type  = SCM_RIGHTS;
+			handleData->cmsg_len   = CMSG_LEN(handles.size() * sizeof(int));
+			std::memcpy(CMSG_DATA(handleData), handles.data(), handles.size() * sizeof(int));
+		}
+
+		while (::sendmsg(m_handle, &header, MSG_NOSIGNAL | MSG_DONTWAIT) < 0) {
+			switch (errno) {
+				case EINTR:
+					break;
+				case EAGAIN:
+					// The send buffer is full
+					return false;
+				case EPIPE:
+				case ECONNRESET:
+					// The peer has gone away
+					m_connected = false;
+					return false;
+				default:
+					throw PipeException< int >(errno, "Send");
+			}
+		}
+
+		return true;
+	}
+
+	std::string SeqPacketSocket::receive(unsigned int timeout) const {
+		std::vector< int > handles;
+		std::string message = receive(handles, timeout);
+
+		for (int handle : handles) {
+			::close(handle);
+		}
+
+		return message;
+	}
+
+	std::string SeqPacketSocket::receive(std::vector< int > &handles, unsigned int timeout) const {
+		waitFor(m_handle, POLLIN, timeout);
+
+		// Find out about the message's size first, so that it can be received into a buffer of matching size
+		ssize_t size;
+		do {
+			size = ::recv(m_handle, nullptr, 0, MSG_PEEK | MSG_TRUNC);
+		} while (size < 0 && errno == EINTR);
+
+		if (size < 0) {
+			throw PipeException< int >(errno, "Receive");
+		}
+		if (size == 0) {
+			throw PipeException< int >(ECONNRESET, "Receive");
+		}
+
+		std::string message(static_cast< std::size_t >(size), '\0');
+
+		iovec vector = { message.data(), message.size() };
+		char control[CMSG_SPACE(SOCKET_MAX_PASSED_HANDLES * sizeof(int))];
+
+		msghdr header         = {};
+		header.msg_iov        = &vector;
+		header.msg_iovlen     = 1;
+		header.msg_control    = control;
+		header.msg_controllen = sizeof(control);
+
+		ssize_t received;
+		do {
+			received = ::recvmsg(m_handle, &header, MSG_CMSG_CLOEXEC);
+		} while (received < 0 && errno == EINTR);
+
+		if (received < 0) {
+			throw PipeException< int >(errno, "Receive");
+		}
+
+		takePassedHandles(header, &handles);
+
+		message.resize(static_cast< std::size_t >(received));
+
+		return message;
+	}
+
+	bool SeqPacketSocket::tryReceive(std::vector< char > &buffer, std::string_view &message, bool *truncated) {
+		if (buffer.size() < MAX_MESSAGE_SIZE) {
+			buffer.resize(MAX_MESSAGE_SIZE);
+		}
+
+		iovec vector = { buffer.data(), buffer.size() };
+		char control[CMSG_SPACE(SOCKET_MAX_PASSED_HANDLES * sizeof(int))];
+
+		msghdr header         = {};
+		header.msg_iov        = &vector;
+		header.msg_iovlen     = 1;
+		header.msg_control    = control;
+		header.msg_controllen = sizeof(control);
+
+		ssize_t received;
+		do {
+			received = ::recvmsg(m_handle, &header, MSG_DONTWAIT | MSG_CMSG_CLOEXEC);
+		} while (received < 0 && errno == EINTR);
+
+		if (received >= 0) {
+			// We never expect to be passed any file descriptors. They must not pile up in our process though.
+			takePassedHandles(header, nullptr);
+		}
+
+		if (received < 0) {
+			if (errno == EAGAIN) {
+				return false;
+			}
+			if (errno == ECONNRESET) {
+				m_connected = false;
+				return false;
+			}
+
+			throw PipeException< int >(errno, "Receive");
+		}
+
+		if (received == 0) {
+			// The peer has closed the connection
+			m_connected = false;
+			return false;
+		}
+
+		if (truncated) {
+			*truncated = header.msg_flags & MSG_TRUNC;
+		} else if (header.msg_flags & MSG_TRUNC) {
+			throw PipeException< int >(EMSGSIZE, "Receive");
+		}
+
+		message = std::string_view(buffer.data(), static_cast< std::size_t >(received));
+
+		return true;
+	}
+
+	void SeqPacketSocket::close() noexcept {
+		if (m_handle != -1) {
+			::close(m_handle);
+			m_handle = -1;
+		}
+
+		m_connected = false;
+	}
+
+	bool SeqPacketSocket::isOpen() const noexcept { return m_handle != -1; }
+
+	bool SeqPacketSocket::isConnected() const noexcept { return m_connected; }
+
+	int SeqPacketSocket::getHandle() const noexcept { return m_handle; }
+
+	bool SeqPacketSocket::peerIsSameUser() const noexcept {
+#	ifdef SO_PEERCRED
+		ucred credentials;
+		socklen_t length = sizeof(credentials);
+
+		if (::getsockopt(m_handle, SOL_SOCKET, SO_PEERCRED, &credentials, &length) != 0) {
+			return false;
+		}
+
+		return credentials.uid == ::geteuid();
+#	else
+		uid_t uid;
+		gid_t gid;
+
+		if (::getpeereid(m_handle, &uid, &gid) != 0) {
+			return false;
+		}
+
+		return uid == ::geteuid();
+#	endif
+	}
+
+	SeqPacketListener::~SeqPacketListener() { close(); }
+
+	SeqPacketListener::SeqPacketListener(SeqPacketListener &&other)
+		: m_handle(other.m_handle), m_address(std::move(other.m_address)) {
+		other.m_handle = -1;
+		other.m_address.clear();
+	}
+
+	SeqPacketListener &SeqPacketListener::operator=(SeqPacketListener &&other) {
+		close();
+
+		m_handle  = other.m_handle;
+		m_address = std::move(other.m_address);
+
+		other.m_handle = -1;
+		other.m_address.clear();
+
+		return *this;
+	}
+
+	SeqPacketListener SeqPacketListener::listen(const std::string &address) {
+		sockaddr_un socketAddress;
+		socklen_t addressLength = toSocketAddress(address, socketAddress);
+		bool abstract           = address[0] == '@';
+
+		SeqPacketListener listener;
+		listener.m_handle = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+		if (listener.m_handle == -1) {
+			throw PipeException< int >(errno, "Socket");
+		}
+
+		if (::bind(listener.m_handle, reinterpret_cast< const sockaddr * >(&socketAddress), addressLength) != 0) {
+			int error = errno;
+
+			if (error != EADDRINUSE || abstract) {
+				throw PipeException< int >(error, "Bind");
+			}
+
+			// The socket file might be a left-over of a process that has crashed. Only if nobody is listening on it
+			// anymore, it is safe to replace it.
+			try {
+				SeqPacketSocket probe = SeqPacketSocket::connect(address, 0);
+
+				throw PipeException< int >(EADDRINUSE, "Bind");
+			} catch (const TimeoutException &) {
+				::unlink(address.c_str());
+			}
+
+			if (::bind(listener.m_handle, reinterpret_cast< const sockaddr * >(&socketAddress), addressLength) != 0) {
+				throw PipeException< int >(errno, "Bind");
+			}
+		}
+
+		// Only the owner may connect to the socket. Note that there are no permissions in the abstract namespace,
+		// which is why connected peers should be checked via SeqPacketSocket::peerIsSameUser() as well.
+		if (!abstract && ::chmod(address.c_str(), S_IRUSR | S_IWUSR) != 0) {
+			int error = errno;
+			::unlink(address.c_str());
+
+			throw PipeException< int >(error, "Chmod");
+		}
+
+		listener.m_address = address;
+
+		if (::listen(listener.m_handle, SOMAXCONN) != 0) {
+			throw PipeException< int >(errno, "Listen");
+		}
+
+		return listener;
+	}
+
+	SeqPacketSocket SeqPacketListener::accept() const {
+		while (true) {
+			int handle = ::accept4(m_handle, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+
+			if (handle != -1) {
+				return SeqPacketSocket(handle);
+			}
+
+			switch (errno) {
+				case EINTR:
+					break;
+				case EAGAIN:
+				case ECONNABORTED:
+					// There is no pending connection (anymore)
+					return SeqPacketSocket();
+				default:
+					throw PipeException< int >(errno, "Accept");
+			}
+		}
+	}
+
+	void SeqPacketListener::close() noexcept {
+		if (m_handle != -1) {
+			::close(m_handle);
+			m_handle = -1;
+
+			if (!m_address.empty() && m_address[0] != '@') {
+				::unlink(m_address.c_str());
+			}
+			m_address.clear();
+		}
+	}
+
+	int SeqPacketListener::getHandle() const noexcept { return m_handle; }
+
+	const std::string &SeqPacketListener::getAddress() const noexcept { return m_address; }
+
+	SeqPacketListener::operator bool() const noexcept { return m_handle != -1; }
+
+}; // namespace JsonBridge
+}; // namespace Mumble
+#endif
@@ -0,0 +1,584 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+#include "mumble/json_bridge/ServerState.h"
+#include "mumble/json_bridge/messages/APICall.h"
+
+#include <algorithm>
+#include <exception>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace Mumble {
+namespace JsonBridge {
+
+	/**
+	 * Writes everything of a successful API call's response up to its return value
+	 *
+	 * @param writer The writer to write to
+	 * @param function The name of the called API function
+	 */
+	static void writeResponseBeginning(ResponseWriter &writer, std::string_view function) {
+		writer.raw(R"("response_type":"api_call","response":{"function":")");
+		writer.raw(function);
+		writer.raw(R"(","status":"executed","return_value":)");
+	}
+
+	/**
+	 * Writes the given IDs as an array, sorted in ascending order
+	 */
+	template< typename id_t > static void writeSortedIDs(ResponseWriter &writer, std::vector< id_t > &ids) {
+		std::sort(ids.begin(), ids.end());
+
+		writer.value(ids);
+	}
+
+	ServerState::ServerState(const MumbleAPI &api, std::size_t changeLogCapacity)
+		: m_api(api), m_changeLogCapacity(std::max< std::size_t >(changeLogCapacity, 1)) {}
+
+	const ServerState::Server *ServerState::findServer(mumble_connection_t connection) const {
+		auto it = m_servers.find(connection);
+
+		return it == m_servers.end() ? nullptr : &it->second;
+	}
+
+	void ServerState::loadUser(mumble_connection_t connection, mumble_userid_t userID) {
+		// The API must not be called while holding the lock, as API calls made by other threads are executed in the
+		// thread that invokes the callbacks
+		User user;
+		user.name    = m_api.getUserName(connection, userID).c_str();
+		user.channel = m_api.getChannelOfUser(connection, userID);
+
+		std::unique_lock< std::shared_mutex > guard(m_mutex);
+
+		auto it = m_servers.find(connection);
+		if (it != m_servers.end()) {
+			Server &server = it->second;
+
+			auto userIt = server.users.find(userID);
+			if (userIt != server.users.end()) {
+				server.userNames.remove(userIt->second.name, userID);
+			}
+			server.userNames.add(user.name, userID);
+
+			server.users[userID] = std::move(user);
+
+			recordChange(connection, true, userID);
+		}
+	}
+
+	void ServerState::loadChannel(mumble_connection_t connection, mumble_channelid_t channelID) {
+		Channel channel;
+		channel.name = m_api.getChannelName(connection, channelID).c_str();
+
+		std::unique_lock< std::shared_mutex > guard(m_mutex);
+
+		auto it = m_servers.find(connection);
+		if (it != m_servers.end()) {
+			Server &server = it->second;
+
+			// The channel might have been renamed
+			auto channelIt = server.channels.find(channelID);
+			if (channelIt != server.channels.end()) {
+				server.channelNames.remove(channelIt->second.name, channelID);
+			}
+			server.channelNames.add(channel.name, channelID);
+
+			server.channels[channelID] = std::move(channel);
+
+			recordChange(connection, false, channelID);
+		}
+	}
+
+	void ServerState::invalidate(mumble_connection_t connection) noexcept {
+		std::unique_lock< std::shared_mutex > guard(m_mutex);
+
+		m_servers.erase(connection);
+	}
+
+	void ServerState::recordChange(mumble_connection_t connection, bool isUser, std::int64_t id) {
+		m_changes.push_back({ ++m_version, connection, isUser, id });
+
+		if (m_changes.size() > m_changeLogCapacity) {
+			m_droppedVersion = m_changes.front().version;
+			m_changes.pop_front();
+		}
+	}
+
+	void ServerState::onServerSynchronized(mumble_connection_t connection) noexcept {
+		try {
+			Server server;
+
+			for (mumble_userid_t current : m_api.getAllUsers(connection)) {
+				User &user   = server.users[current];
+				user.name    = m_api.getUserName(connection, current).c_str();
+				user.channel = m_api.getChannelOfUser(connection, current);
+
+				server.userNames.add(user.name, current);
+			}
+			for (mumble_channelid_t current : m_api.getAllChannels(connection)) {
+				Channel &channel = server.channels[current];
+				channel.name     = m_api.getChannelName(connection, current).c_str();
+
+				server.channelNames.add(channel.name, current);
+			}
+
+			std::unique_lock< std::shared_mutex > guard(m_mutex);
+
+			// Clients that have seen an older state of this server have to start over
+			server.synchronizedAt = ++m_version;
+
+			m_servers[connection] = std::move(server);
+		} catch (const std::exception &) {
+			invalidate(connection);
+		}
+	}
+
+	void ServerState::onServerDisconnected(mumble_connection_t connection) noexcept { invalidate(connection); }
+
+	void ServerState::onUserAdded(mumble_connection_t connection, mumble_userid_t userID) noexcept {
+		if (!isSynchronized(connection)) {
+			// Users appearing while the server is being synchronized are picked up by onServerSynchronized()
+			return;
+		}
+
+		try {
+			loadUser(connection, userID);
+		} catch (const std::exception &) {
+			invalidate(connection);
+		}
+	}
+
+	void ServerState::onUserRemoved(mumble_connection_t connection, mumble_userid_t userID) noexcept {
+		std::unique_lock< std::shared_mutex > guard(m_mutex);
+
+		auto it = m_servers.find(connection);
+		if (it == m_servers.end()) {
+			return;
+		}
+
+		auto userIt = it->second.users.find(userID);
+		if (userIt != it->second.users.end()) {
+			it->second.userNames.remove(userIt->second.name, userID);
+			it->second.users.erase(userIt);
+
+			recordChange(connection, true, userID);
+		}
+	}
+
+	void ServerState::onChannelAdded(mumble_connection_t connection, mumble_channelid_t channelID) noexcept {
+		if (!isSynchronized(connection)) {
+			return;
+		}
+
+		try {
+			loadChannel(connection, channelID);
+		} catch (const std::exception &) {
+			invalidate(connection);
+		}
+	}
+
+	void ServerState::onChannelRemoved(mumble_connection_t connection, mumble_channelid_t channelID) noexcept {
+		std::unique_lock< std::shared_mutex > guard(m_mutex);
+
+		auto it = m_servers.find(connection);
+		if (it == m_servers.end()) {
+			return;
+		}
+
+		auto channelIt = it->second.channels.find(channelID);
+		if (channelIt != it->second.channels.end()) {
+			it->second.channelNames.remove(channelIt->second.name, channelID);
+			it->second.channels.erase(channelIt);
+
+			recordChange(connection, false, channelID);
+		}
+	}
+
+	void ServerState::onChannelRenamed(mumble_connection_t connection, mumble_channelid_t channelID) noexcept {
+		// The callback doesn't tell the new name
+		onChannelAdded(connection, channelID);
+	}
+
+	void ServerState::onChannelEntered(mumble_connection_t connection, mumble_userid_t userID, mumble_channelid_t,
+									   mumble_channelid_t newChannelID) noexcept {
+		{
+			std::unique_lock< std::shared_mutex > guard(m_mutex);
+
+			auto it = m_servers.find(connection);
+			if (it == m_servers.end()) {
+				return;
+			}
+
+			auto userIt = it->second.users.find(userID);
+			if (userIt != it->second.users.end()) {
+				userIt->second.channel = newChannelID;
+
+				recordChange(connection, true, userID);
+				return;
+			}
+		}
+
+		// The user entered its first channel before we got to know about it
+		onUserAdded(connection, userID);
+	}
+
+	void ServerState::onChannelExited(mumble_connection_t connection, mumble_userid_t userID,
+									  mumble_channelid_t channelID) noexcept {
+		std::unique_lock< std::shared_mutex > guard(m_mutex);
+
+		auto it = m_servers.find(connection);
+		if (it == m_servers.end()) {
+			return;
+		}
+
+		// The user is either about to enter another channel or to leave the server
+		auto userIt = it->second.users.find(userID);
+		if (userIt != it->second.users.end() && userIt->second.channel == channelID) {
+			userIt->second.channel.reset();
+
+			recordChange(connection, true, userID);
+		}
+	}
+
+	bool ServerState::isSynchronized(mumble_connection_t connection) const {
+		std::shared_lock< std::shared_mutex > guard(m_mutex);
+
+		return findServer(connection) != nullptr;
+	}
+
+	std::uint64_t ServerState::getVersion() const {
+		std::shared_lock< std::shared_mutex > guard(m_mutex);
+
+		return m_version;
+	}
+
+	void ServerState::writeChanges(const Messages::Parameter_getChangesSince &call, ResponseWriter &writer) const {
+		writer.raw(R"({"version":)");
+		writer.value(m_version);
+
+		// The changes since the given version are only known if the server has been modelled (without interruption)
+		// ever since and if none of them has been dropped from the change log yet
+		const Server *server = findServer(call.connection);
+		if (!server || call.version < server->synchronizedAt || call.version < m_droppedVersion
+			|| call.version > m_version) {
+			writer.raw(R"(,"resync":true})");
+			return;
+		}
+
+		std::vector< mumble_userid_t > users;
+		std::vector< mumble_channelid_t > channels;
+
+		auto first =
+			std::upper_bound(m_changes.begin(), m_changes.end(), call.version,
+							 [](std::uint64_t version, const Change &change) { return version < change.version; });
+		for (auto it = first; it != m_changes.end(); ++it) {
+			if (it->connection != call.connection) {
+				continue;
+			}
+
+			if (it->isUser) {
+				users.push_back(static_cast< mumble_userid_t >(it->id));
+			} else {
+				channels.push_back(static_cast< mumble_channelid_t >(it->id));
+			}
+		}
+
+		// Whatever has changed several times is reported once, with its current state
+		std::sort(users.begin(), users.end());
+		users.erase(std::unique(users.begin(), users.end()), users.end());
+		std::sort(channels.begin(), channels.end());
+		channels.erase(std::unique(channels.begin(), channels.end()), channels.end());
+
+		std::vector< mumble_userid_t > removedUsers;
+		std::vector< mumble_channelid_t > removedChannels;
+
+		writer.raw(R"(,"resync":false,"users":[)");
+		bool firstEntry = true;
+		for (mumble_userid_t current : users) {
+			auto userIt = server->users.find(current);
+			if (userIt == server->users.end()) {
+				removedUsers.push_back(current);
+				continue;
+			}
+
+			writer.raw(firstEntry ? R"({"id":)" : R"(,{"id":)");
+			writer.value(current);
+			writer.raw(R"(,"name":)");
+			writer.string(userIt->second.name);
+			writer.raw(R"(,"channel":)");
+			if (userIt->second.channel) {
+				writer.value(*userIt->second.channel);
+			} else {
+				writer.raw("null");
+			}
+			writer.raw("}");
+
+			firstEntry = false;
+		}
+
+		writer.raw(R"(],"channels":[)");
+		firstEntry = true;
+		for (mumble_channelid_t current : channels) {
+			auto channelIt = server->channels.find(current);
+			if (channelIt == server->channels.end()) {
+				removedChannels.push_back(current);
+				continue;
+			}
+
+			writer.raw(firstEntry ? R"({"id":)" : R"(,{"id":)");
+			writer.value(current);
+			writer.raw(R"(,"name":)");
+			writer.string(channelIt->second.name);
+			writer.raw("}");
+
+			firstEntry = false;
+		}
+
+		writer.raw(R"(],"removed_users":)");
+		writer.value(removedUsers);
+		writer.raw(R"(,"removed_channels":)");
+		writer.value(removedChannels);
+		writer.raw("}");
+	}
+
+	bool ServerState::writeSnapshot(const Messages::Parameter_getServerSnapshot &call, ResponseWriter &writer) const {
+		std::uint64_t version;
+		std::vector< std::pair< mumble_userid_t, User > > users;
+		std::vector< std::pair< mumble_channelid_t, Channel > > channels;
+
+		{
+			// The version is taken along with the users and channels, so that getChangesSince picks up exactly where
+			// the snapshot leaves off
+			std::shared_lock< std::shared_mutex > guard(m_mutex);
+
+			const Server *server = findServer(call.connection);
+			if (!server) {
+				return false;
+			}
+
+			version = m_version;
+			users.assign(server->users.begin(), server->users.end());
+			channels.assign(server->channels.begin(), server->channels.end());
+		}
+
+		auto byID = [](const auto &lhs, const auto &rhs) { return lhs.first < rhs.first; };
+		std::sort(users.begin(), users.end(), byID);
+		std::sort(channels.begin(), channels.end(), byID);
+
+		// The rest is looked up via the API, as there are no callbacks telling about changes to it. A failing call
+		// leaves a partial response behind that has to be discarded.
+		const std::size_t responseStart = writer.buffer().size();
+
+		try {
+			writeResponseBeginning(writer, "getServerSnapshot");
+			writer.raw(R"({"version":)");
+			writer.value(version);
+
+			writer.raw(R"(,"users":[)");
+			bool first = true;
+			for (const auto &current : users) {
+				writer.raw(first ? R"({"id":)" : R"(,{"id":)");
+				writer.value(current.first);
+				writer.raw(R"(,"name":)");
+				writer.string(current.second.name);
+				writer.raw(R"(,"channel":)");
+				if (current.second.channel) {
+					writer.value(*current.second.channel);
+				} else {
+					writer.raw("null");
+				}
+				writer.raw(R"(,"locally_muted":)");
+				writer.value(m_api.isUserLocallyMuted(call.connection, current.first));
+				writer.raw("}");
+
+				first = false;
+			}
+
+			writer.raw(R"(],"channels":[)");
+			first = true;
+			for (const auto &current : channels) {
+				writer.raw(first ? R"({"id":)" : R"(,{"id":)");
+				writer.value(current.first);
+				writer.raw(R"(,"name":)");
+				writer.string(current.second.name);
+				writer.raw(R"(,"description_hash":)");
+				Messages::writeDescriptionHash(writer,
+											   m_api.getChannelDescription(call.connection, current.first).c_str());
+				writer.raw("}");
+
+				first = false;
+			}
+
+			writer.raw("]}}");
+
+			return true;
+		} catch (const MumbleAPIException &) {
+			// Leave it to the API to report the error
+			writer.buffer().resize(responseStart);
+
+			return false;
+		}
+	}
+
+	bool ServerState::write(const Messages::APIParameter &parameter, ResponseWriter &writer) const {
+		if (const auto *call = std::get_if< Messages::Parameter_getServerSnapshot >(&parameter)) {
+			// This has to call the API, which must not happen while holding the lock
+			return writeSnapshot(*call, writer);
+		}
+
+		std::shared_lock< std::shared_mutex > guard(m_mutex);
+
+		if (const auto *call = std::get_if< Messages::Parameter_getUserName >(&parameter)) {
+			const Server *server = findServer(call->connection);
+			if (!server) {
+				return false;
+			}
+
+			auto it = server->users.find(call->user_id);
+			if (it == server->users.end()) {
+				return false;
+			}
+
+			writeResponseBeginning(writer, "getUserName");
+			writer.string(it->second.name);
+		} else if (const auto *call = std::get_if< Messages::Parameter_getChannelName >(&parameter)) {
+			const Server *server = findServer(call->connection);
+			if (!server) {
+				return false;
+			}
+
+			auto it = server->channels.find(call->channel_id);
+			if (it == server->channels.end()) {
+				return false;
+			}
+
+			writeResponseBeginning(writer, "getChannelName");
+			writer.string(it->second.name);
+		} else if (const auto *call = std::get_if< Messages::Parameter_getAllUsers >(&parameter)) {
+			const Server *server = findServer(call->connection);
+			if (!server) {
+				return false;
+			}
+
+			std::vector< mumble_userid_t > users;
+			users.reserve(server->users.size());
+			for (const auto &current : server->users) {
+				users.push_back(current.first);
+			}
+
+			writeResponseBeginning(writer, "getAllUsers");
+			writeSortedIDs(writer, users);
+		} else if (const auto *call = std::get_if< Messages::Parameter_getAllChannels >(&parameter)) {
+			const Server *server = findServer(call->connection);
+			if (!server) {
+				return false;
+			}
+
+			std::vector< mumble_channelid_t > channels;
+			channels.reserve(server->channels.size());
+			for (const auto &current : server->channels) {
+				channels.push_back(current.first);
+			}
+
+			writeResponseBeginning(writer, "getAllChannels");
+			writeSortedIDs(writer, channels);
+		} else if (const auto *call = std::get_if< Messages::Parameter_getChannelOfUser >(&parameter)) {
+			const Server *server = findServer(call->connection);
+			if (!server) {
+				return false;
+			}
+
+			auto it = server->users.find(call->user_id);
+			if (it == server->users.end() || !it->second.channel) {
+				return false;
+			}
+
+			writeResponseBeginning(writer, "getChannelOfUser");
+			writer.value(*it->second.channel);
+		} else if (const auto *call = std::get_if< Messages::Parameter_getUsersInChannel >(&parameter)) {
+			const Server *server = findServer(call->connection);
+			if (!server || server->channels.count(call->channel_id) == 0) {
+				return false;
+			}
+
+			std::vector< mumble_userid_t > users;
+			for (const auto &current : server->users) {
+				if (current.second.channel == call->channel_id) {
+					users.push_back(current.first);
+				}
+			}
+
+			writeResponseBeginning(writer, "getUsersInChannel");
+			writeSortedIDs(writer, users);
+		} else if (const auto *call = std::get_if< Messages::Parameter_findUserByName >(&parameter)) {
+			// Names the index doesn't know are left to the API, so that the error is reported as usual
+			const Server *server          = findServer(call->connection);
+			const mumble_userid_t *userID = server ? server->userNames.find(call->user_name) : nullptr;
+			if (!userID) {
+				return false;
+			}
+
+			writeResponseBeginning(writer, "findUserByName");
+			writer.value(*userID);
+		} else if (const auto *call = std::get_if< Messages::Parameter_findUserByName_noexcept >(&parameter)) {
+			const Server *server          = findServer(call->connection);
+			const mumble_userid_t *userID = server ? server->userNames.find(call->user_name) : nullptr;
+			if (!userID) {
+				return false;
+			}
+
+			writeResponseBeginning(writer, "findUserByName_noexcept");
+			writer.value(*userID);
+		} else if (const auto *call = std::get_if< Messages::Parameter_findChannelByName >(&parameter)) {
+			const Server *server                = findServer(call->connection);
+			const mumble_channelid_t *channelID = server ? server->channelNames.find(call->channel_name) : nullptr;
+			if (!channelID) {
+				return false;
+			}
+
+			writeResponseBeginning(writer, "findChannelByName");
+			writer.value(*channelID);
+		} else if (const auto *call = std::get_if< Messages::Parameter_findChannelByName_noexcept >(&parameter)) {
+			const Server *server                = findServer(call->connection);
+			const mumble_channelid_t *channelID = server ? server->channelNames.find(call->channel_name) : nullptr;
+			if (!channelID) {
+				return false;
+			}
+
+			writeResponseBeginning(writer, "findChannelByName_noexcept");
+			writer.value(*channelID);
+		} else if (const auto *call = std::get_if< Messages::Parameter_findUsersByName >(&parameter)) {
+			const Server *server = findServer(call->connection);
+			if (!server) {
+				return false;
+			}
+
+			writeResponseBeginning(writer, "findUsersByName");
+			writer.value(server->userNames.find(call->user_name, call->case_sensitive, call->prefix));
+		} else if (const auto *call = std::get_if< Messages::Parameter_findChannelsByName >(&parameter)) {
+			const Server *server = findServer(call->connection);
+			if (!server) {
+				return false;
+			}
+
+			writeResponseBeginning(writer, "findChannelsByName");
+			writer.value(server->channelNames.find(call->channel_name, call->case_sensitive, call->prefix));
+		} else if (const auto *call = std::get_if< Messages::Parameter_getChangesSince >(&parameter)) {
+			// This is always answered, as only the model knows about the changes
+			writeResponseBeginning(writer, "getChangesSince");
+			writeChanges(*call, writer);
+		} else {
+			return false;
+		}
+
+		writer.raw("}");
+
+		return true;
+	}
+
+}; // namespace JsonBridge
+}; // namespace Mumble
@@ -0,0 +1,405 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+#include "mumble/json_bridge/SharedMemoryChannel.h"
+#include "mumble/json_bridge/MumbleAssert.h"
+#include "mumble/json_bridge/NamedPipe.h"
+
+#ifdef PLATFORM_UNIX
+#	include <fcntl.h>
+#	include <poll.h>
+#	include <sys/eventfd.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+
+#	include <algorithm>
+#	include <atomic>
+#	include <cerrno>
+#	include <chrono>
+#	include <cstring>
+#	include <new>
+
+namespace Mumble {
+namespace JsonBridge {
+
+	// Identifies a memory region as belonging to a SharedMemoryChannel ("MJBR")
+	constexpr std::uint32_t SHARED_MEMORY_MAGIC = 0x4D4A4252;
+	// Increased whenever the layout of the memory region changes
+	constexpr std::uint32_t SHARED_MEMORY_VERSION = 1;
+	// Placed into a ring instead of a record's size if the record didn't fit into the end of the ring and has been
+	// placed at its beginning instead
+	constexpr std::uint32_t SHARED_MEMORY_WRAP_MARKER = 0xFFFFFFFF;
+	// Every record starts at a multiple of this
+	constexpr std::size_t SHARED_MEMORY_RECORD_ALIGNMENT = 8;
+	constexpr std::size_t SHARED_MEMORY_MIN_RING_SIZE    = 4 * 1024;
+	constexpr std::size_t SHARED_MEMORY_MAX_RING_SIZE    = 64 * 1024 * 1024;
+	// Keeps the parts written by the two sides in separate cache lines
+	constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+	static_assert(std::atomic< std::uint64_t >::is_always_lock_free,
+				  "Shared memory requires lock-free (and therefore address-free) atomics");
+
+	/**
+	 * The header at the beginning of the shared memory region
+	 */
+	struct alignas(CACHE_LINE_SIZE) SharedMemoryHeader {
+		std::uint32_t magic;
+		std::uint32_t version;
+		std::uint64_t ringSize;
+	};
+
+	/**
+	 * The control block of a single ring. It is immediately followed by the ring's data.
+	 */
+	struct SharedMemoryRing {
+		/**
+		 * The position up to which the producer has written records. Only written by the producer.
+		 */
+		alignas(CACHE_LINE_SIZE) std::atomic< std::uint64_t > tail;
+		/**
+		 * The position up to which the consumer has read records. Only written by the consumer.
+		 */
+		alignas(CACHE_LINE_SIZE) std::atomic< std::uint64_t > head;
+		/**
+		 * Set by the producer if it is waiting for room in the ring. The consumer rings the producer's doorbell once
+		 * it has made room.
+		 */
+		alignas(CACHE_LINE_SIZE) std::atomic< std::uint32_t > producerWaiting;
+
+		char *data() noexcept { return reinterpret_cast< char * >(this) + sizeof(SharedMemoryRing); }
+	};
+
+	/**
+	 * @returns The size of the record holding a message of the given size
+	 */
+	static std::uint64_t recordSize(std::size_t messageSize) {
+		return (sizeof(std::uint32_t) + messageSize + SHARED_MEMORY_RECORD_ALIGNMENT - 1)
+			   & ~static_cast< std::uint64_t >(SHARED_MEMORY_RECORD_ALIGNMENT - 1);
+	}
+
+	/**
+	 * @returns The size of the memory region for the given ring size
+	 */
+	static std::size_t mappingSize(std::size_t ringSize) {
+		return sizeof(SharedMemoryHeader) + 2 * (sizeof(SharedMemoryRing) + ringSize);
+	}
+
+	SharedMemoryChannel::~SharedMemoryChannel() {
+		if (m_memory) {
+			::munmap(m_memory, m_mappingSize);
+		}
+
+		for (int handle : { m_memoryHandle, m_ownDoorbell, m_peerDoorbell }) {
+			if (handle != -1) {
+				::close(handle);
+			}
+		}
+	}
+
+	SharedMemoryChannel::SharedMemoryChannel(SharedMemoryChannel &&other) { *this = std::move(other); }
+
+	SharedMemoryChannel &SharedMemoryChannel::operator=(SharedMemoryChannel &&other) {
+		std::swap(m_memory, other.m_memory);
+		std::swap(m_mappingSize, other.m_mappingSize);
+		std::swap(m_memoryHandle, other.m_memoryHandle);
+		std::swap(m_ownDoorbell, other.m_ownDoorbell);
+		std::swap(m_peerDoorbell, other.m_peerDoorbell);
+		std::swap(m_outgoing, other.m_outgoing);
+		std::swap(m_incoming, other.m_incoming);
+		std::swap(m_ringSize, other.m_ringSize);
+		std::swap(m_outgoingTail, other.m_outgoingTail);
+		std::swap(m_incomingHead, other.m_incomingHead);
+		std::swap(m_peekedRecordSize, other.m_peekedRecordSize);
+
+		// Whatever this instance held before is cleaned up by other's destructor
+		return *this;
+	}
+
+	void SharedMemoryChannel::map(bool createdByBridge) {
+		m_mappingSize = mappingSize(m_ringSize);
+
+		m_memory = ::mmap(nullptr, m_mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, m_memoryHandle, 0);
+		if (m_memory == MAP_FAILED) {
+			m_memory = nullptr;
+			throw PipeException< int >(errno, "Map shared memory");
+		}
+
+		char *base = static_cast< char * >(m_memory) + sizeof(SharedMemoryHeader);
+
+		SharedMemoryRing *requests = reinterpret_cast< SharedMemoryRing * >(base);
+		SharedMemoryRing *responses =
+			reinterpret_cast< SharedMemoryRing * >(base + sizeof(SharedMemoryRing) + m_ringSize);
+
+		m_outgoing = createdByBridge ? responses : requests;
+		m_incoming = createdByBridge ? requests : responses;
+	}
+
+	SharedMemoryChannel SharedMemoryChannel::create(std::size_t ringSize) {
+		SharedMemoryChannel channel;
+
+		channel.m_ringSize = SHARED_MEMORY_MIN_RING_SIZE;
+		while (channel.m_ringSize < ringSize && channel.m_ringSize < SHARED_MEMORY_MAX_RING_SIZE) {
+			channel.m_ringSize *= 2;
+		}
+
+		channel.m_memoryHandle = ::memfd_create("mumble-json-bridge", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+		if (channel.m_memoryHandle == -1) {
+			throw PipeException< int >(errno, "Create shared memory");
+		}
+
+		if (::ftruncate(channel.m_memoryHandle, static_cast< off_t >(mappingSize(channel.m_ringSize))) != 0) {
+			throw PipeException< int >(errno, "Resize shared memory");
+		}
+
+		// Make sure the client can't shrink the region, which would cause us to crash when accessing it
+		if (::fcntl(channel.m_memoryHandle, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) != 0) {
+			throw PipeException< int >(errno, "Seal shared memory");
+		}
+
+		channel.m_ownDoorbell  = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+		channel.m_peerDoorbell = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+		if (channel.m_ownDoorbell == -1 || channel.m_peerDoorbell == -1) {
+			throw PipeException< int >(errno, "Create doorbell");
+		}
+
+		channel.map(true);
+
+		SharedMemoryHeader *header = new (channel.m_memory) SharedMemoryHeader();
+		header->magic              = SHARED_MEMORY_MAGIC;
+		header->version            = SHARED_MEMORY_VERSION;
+		header->ringSize           = channel.m_ringSize;
+
+		for (SharedMemoryRing *ring : { channel.m_outgoing, channel.m_incoming }) {
+			SharedMemoryRing *initialized = new (ring) SharedMemoryRing();
+			initialized->tail.store(0);
+			initialized->head.store(0);
+			initialized->producerWaiting.store(0);
+		}
+
+		return channel;
+	}
+
+	SharedMemoryChannel SharedMemoryChannel::attach(const std::vector< int > &handles) {
+		SharedMemoryChannel channel;
+
+		if (handles.size() != 3) {
+			for (int handle : handles) {
+				::close(handle);
+			}
+
+			throw PipeException< int >(EINVAL, "Attach to shared memory");
+		}
+
+		channel.m_memoryHandle = handles[0];
+		// Our doorbell is the one the Bridge rings and vice versa
+		channel.m_peerDoorbell = handles[1];
+		channel.m_ownDoorbell  = handles[2];
+
+		SharedMemoryHeader header;
+		if (::pread(channel.m_memoryHandle, &header, sizeof(header), 0) != static_cast< ssize_t >(sizeof(header))
+			|| header.magic != SHARED_MEMORY_MAGIC || header.version != SHARED_MEMORY_VERSION
+			|| header.ringSize < SHARED_MEMORY_MIN_RING_SIZE || header.ringSize > SHARED_MEMORY_MAX_RING_SIZE
+			|| (header.ringSize & (header.ringSize - 1)) != 0) {
+			throw PipeException< int >(EPROTO, "Attach to shared memory");
+		}
+
+		struct stat status;
+		if (::fstat(channel.m_memoryHandle, &status) != 0
+			|| static_cast< std::size_t >(status.st_size) < mappingSize(header.ringSize)) {
+			throw PipeException< int >(EPROTO, "Attach to shared memory");
+		}
+
+		channel.m_ringSize = static_cast< std::size_t >(header.ringSize);
+		channel.map(false);
+
+		channel.m_outgoingTail = channel.m_outgoing->tail.load();
+		channel.m_incomingHead = channel.m_incoming->head.load();
+
+		return channel;
+	}
+
+	std::vector< int > SharedMemoryChannel::getHandles() const {
+		// The order is the one expected by attach()
+		return { m_memoryHandle, m_ownDoorbell, m_peerDoorbell };
+	}
+
+	void SharedMemoryChannel::ring(int doorbell) {
+		std::uint64_t value = 1;
+		while (::write(doorbell, &value, sizeof(value)) < 0 && errno == EINTR) {
+		}
+		// EAGAIN means that the counter is saturated, which means the doorbell is ringing anyway
+	}
+
+	/**
+	 * Waits until the given doorbell rings or the given deadline has passed
+	 *
+	 * @param doorbell The handle of the doorbell's eventfd
+	 * @param deadline The point in time until which to wait at most
+	 */
+	static void waitForDoorbell(int doorbell, std::chrono::steady_clock::time_point deadline) {
+		auto remaining =
+			std::chrono::duration_cast< std::chrono::milliseconds >(deadline - std::chrono::steady_clock::now());
+		if (remaining.count() <= 0) {
+			throw TimeoutException();
+		}
+
+		pollfd pollData = { doorbell, POLLIN, 0 };
+		::poll(&pollData, 1,
+			   static_cast< int >(std::min< std::chrono::milliseconds::rep >(remaining.count(),
+																			 (std::numeric_limits< int >::max)())));
+	}
+
+	bool SharedMemoryChannel::trySend(std::string_view message) {
+		MUMBLE_ASSERT(m_memory);
+
+		std::uint64_t record = recordSize(message.size());
+		if (record > m_ringSize / 2) {
+			// Up to half of the ring might be needed as padding in front of the record
+			throw PipeException< int >(EMSGSIZE, "Send via shared memory");
+		}
+
+		const std::uint64_t oldTail = m_outgoingTail;
+		const std::size_t index     = static_cast< std::size_t >(oldTail & (m_ringSize - 1));
+		const std::size_t untilEnd  = m_ringSize - index;
+		const std::uint64_t padding = record > untilEnd ? untilEnd : 0;
+
+		std::uint64_t head = m_outgoing->head.load();
+		if (oldTail - head > m_ringSize) {
+			throw PipeException< int >(EPROTO, "Send via shared memory");
+		}
+
+		if (oldTail - head + padding + record > m_ringSize) {
+			// The ring is full. Ask the consumer to wake us up once it has made room and check again in case it has
+			// done so in the meantime.
+			m_outgoing->producerWaiting.store(1);
+
+			head = m_outgoing->head.load();
+			if (oldTail - head + padding + record > m_ringSize) {
+				return false;
+			}
+
+			m_outgoing->producerWaiting.store(0);
+		}
+
+		char *data                  = m_outgoing->data();
+		std::size_t recordIndex     = index;
+		if (padding > 0) {
+			std::memcpy(data + index, &SHARED_MEMORY_WRAP_MARKER, sizeof(SHARED_MEMORY_WRAP_MARKER));
+			recordIndex = 0;
+		}
+
+		std::uint32_t size = static_cast< std::uint32_t >(message.size());
+		std::memcpy(data + recordIndex, &size, sizeof(size));
+		std::memcpy(data + recordIndex + sizeof(size), message.data(), message.size());
+
+		m_outgoingTail = oldTail + padding + record;
+		m_outgoing->tail.store(m_outgoingTail);
+
+		// Only if the consumer had caught up with everything we had produced before, it might be waiting for its
+		// doorbell to ring. Otherwise it is going to see the new message anyway.
+		if (m_outgoing->head.load() == oldTail) {
+			ring(m_peerDoorbell);
+		}
+
+		return true;
+	}
+
+	void SharedMemoryChannel::send(std::string_view message, unsigned int timeout) {
+		auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+
+		while (!trySend(message)) {
+			waitForDoorbell(m_ownDoorbell, deadline);
+			resetDoorbell();
+		}
+	}
+
+	bool SharedMemoryChannel::peek(std::string_view &message) {
+		MUMBLE_ASSERT(m_memory);
+
+		const std::uint64_t tail = m_incoming->tail.load();
+		if (tail - m_incomingHead > m_ringSize) {
+			throw PipeException< int >(EPROTO, "Receive via shared memory");
+		}
+
+		std::uint64_t position = m_incomingHead;
+		const char *data       = m_incoming->data();
+
+		while (position != tail) {
+			std::size_t index = static_cast< std::size_t >(position & (m_ringSize - 1));
+
+			std::uint32_t size;
+			std::memcpy(&size, data + index, sizeof(size));
+
+			if (size == SHARED_MEMORY_WRAP_MARKER) {
+				// The record has been placed at the beginning of the ring
+				if (m_ringSize - index >= tail - position) {
+					throw PipeException< int >(EPROTO, "Receive via shared memory");
+				}
+
+				position += m_ringSize - index;
+				continue;
+			}
+
+			// Don't trust the other side: the record must lie within the produced part of the ring
+			std::uint64_t record = recordSize(size);
+			if (record > tail - position || index + record > m_ringSize) {
+				throw PipeException< int >(EPROTO, "Receive via shared memory");
+			}
+
+			message            = std::string_view(data + index + sizeof(size), size);
+			m_peekedRecordSize = position + record - m_incomingHead;
+
+			return true;
+		}
+
+		return false;
+	}
+
+	void SharedMemoryChannel::pop() {
+		MUMBLE_ASSERT(m_peekedRecordSize > 0);
+
+		m_incomingHead += m_peekedRecordSize;
+		m_peekedRecordSize = 0;
+
+		m_incoming->head.store(m_incomingHead);
+
+		if (m_incoming->producerWaiting.load() && m_incoming->producerWaiting.exchange(0)) {
+			ring(m_peerDoorbell);
+		}
+	}
+
+	std::string SharedMemoryChannel::receive(unsigned int timeout) {
+		auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+
+		std::string_view message;
+		while (!peek(message)) {
+			waitForDoorbell(m_ownDoorbell, deadline);
+			resetDoorbell();
+		}
+
+		std::string content(message);
+		pop();
+
+		return content;
+	}
+
+	int SharedMemoryChannel::getDoorbellHandle() const noexcept { return m_ownDoorbell; }
+
+	void SharedMemoryChannel::resetDoorbell() noexcept {
+		std::uint64_t value;
+		while (::read(m_ownDoorbell, &value, sizeof(value)) < 0 && errno == EINTR) {
+		}
+	}
+
+	void SharedMemoryChannel::wakeSelf() noexcept { ring(m_ownDoorbell); }
+
+	std::size_t SharedMemoryChannel::getRingSize() const noexcept { return m_ringSize; }
+
+	SharedMemoryChannel::operator bool() const noexcept { return m_memory != nullptr; }
+
+}; // namespace JsonBridge
+}; // namespace Mumble
+#endif
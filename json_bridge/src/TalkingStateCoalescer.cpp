@@ -0,0 +1,264 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+#include "mumble/json_bridge/TalkingStateCoalescer.h"
+#include "mumble/json_bridge/Event.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace Mumble {
+namespace JsonBridge {
+
+	/**
+	 * The amount of slots a change may be recorded in. Bounding the probes is what makes recording wait-free.
+	 */
+	constexpr std::size_t MAX_PROBES = 16;
+	/**
+	 * The amount of consecutive drains without any change after which a slot is reclaimed
+	 */
+	constexpr unsigned int RECLAIM_AFTER_DRAINS = 64;
+
+	/**
+	 * @returns The key identifying the given user on the given connection
+	 */
+	static std::uint64_t toKey(mumble_connection_t connection, mumble_userid_t userID) {
+		return (static_cast< std::uint64_t >(static_cast< std::uint32_t >(connection)) << 32) | userID;
+	}
+
+	/**
+	 * @returns The change described by the given key and recorded value
+	 */
+	static TalkingStateChange toChange(std::uint64_t key, std::uint64_t value) {
+		TalkingStateChange change;
+		change.connection = static_cast< mumble_connection_t >(static_cast< std::uint32_t >(key >> 32));
+		change.userID     = static_cast< mumble_userid_t >(key & 0xFFFFFFFF);
+		// The state is stored with an offset of one, so that MUMBLE_TS_INVALID fits into an unsigned byte
+		change.state    = static_cast< mumble_talking_state_t >(static_cast< int >(value & 0xFF) - 1);
+		change.sequence = value >> 8;
+
+		return change;
+	}
+
+	TalkingStateRecorder::TalkingStateRecorder(std::size_t capacity, TalkingStateStatistics *statistics)
+		: m_statistics(statistics) {
+		std::size_t slots = MAX_PROBES;
+		while (slots < capacity) {
+			slots *= 2;
+		}
+
+		m_slots = std::make_unique< Slot[] >(slots);
+		m_mask  = slots - 1;
+	}
+
+	bool TalkingStateRecorder::write(Slot &slot, std::uint64_t key, std::uint64_t value) noexcept {
+		// Announce the write before checking the key, so that the slot can't be reclaimed in between
+		slot.writers++;
+
+		if (slot.key != key) {
+			slot.writers--;
+			return false;
+		}
+
+		slot.value = value;
+		if (slot.dirty.exchange(true)) {
+			// The previous change hasn't been drained yet
+			slot.merged++;
+
+			if (m_statistics) {
+				m_statistics->mergedChanges++;
+			}
+		}
+
+		slot.writers--;
+
+		return true;
+	}
+
+	bool TalkingStateRecorder::record(mumble_connection_t connection, mumble_userid_t userID,
+									  mumble_talking_state_t state) noexcept {
+		std::uint64_t key = toKey(connection, userID);
+		if (key >= RECLAIMING_KEY) {
+			return false;
+		}
+
+		std::uint64_t value = (m_nextSequence++ << 8) | static_cast< std::uint8_t >(static_cast< int >(state) + 1);
+
+		if (m_statistics) {
+			m_statistics->recordedChanges++;
+		}
+
+		// Fibonacci hashing spreads the users of a connection (whose IDs are usually consecutive) over the table
+		std::size_t start = static_cast< std::size_t >((key * 0x9E3779B97F4A7C15ull) >> 32);
+
+		for (std::size_t i = 0; i < MAX_PROBES; i++) {
+			Slot &slot = m_slots[(start + i) & m_mask];
+
+			std::uint64_t current = slot.key;
+			if (current == EMPTY_KEY) {
+				// If somebody else claims the slot first, the slot might still have been claimed for the same user
+				slot.key.compare_exchange_strong(current, key);
+				current = slot.key;
+			}
+
+			if (current == key && write(slot, key, value)) {
+				return true;
+			}
+		}
+
+		m_dropped++;
+		if (m_statistics) {
+			m_statistics->droppedChanges++;
+		}
+
+		return false;
+	}
+
+	void TalkingStateRecorder::take(Slot &slot, std::uint64_t key, std::vector< TalkingStateChange > &changes) {
+		if (slot.dirty.exchange(false)) {
+			TalkingStateChange change = toChange(key, slot.value);
+			change.merged             = slot.merged.exchange(0);
+
+			changes.push_back(change);
+			slot.idleDrains = 0;
+		}
+	}
+
+	void TalkingStateRecorder::reclaim(Slot &slot, std::uint64_t key, std::vector< TalkingStateChange > &changes) {
+		if (!slot.key.compare_exchange_strong(key, RECLAIMING_KEY)) {
+			return;
+		}
+
+		// Writers that have seen the old key are about to finish (which takes them a bounded amount of steps)
+		while (slot.writers != 0) {
+			std::this_thread::yield();
+		}
+
+		take(slot, key, changes);
+
+		slot.idleDrains = 0;
+		slot.key        = EMPTY_KEY;
+	}
+
+	std::uint64_t TalkingStateRecorder::drain(std::vector< TalkingStateChange > &changes) {
+		std::size_t first = changes.size();
+
+		for (std::size_t i = 0; i <= m_mask; i++) {
+			Slot &slot = m_slots[i];
+
+			std::uint64_t key = slot.key;
+			if (key >= RECLAIMING_KEY) {
+				continue;
+			}
+
+			if (slot.dirty) {
+				take(slot, key, changes);
+			} else if (++slot.idleDrains >= RECLAIM_AFTER_DRAINS) {
+				reclaim(slot, key, changes);
+			}
+		}
+
+		// The same user might have ended up in two slots (if the first one has been reclaimed while recording into
+		// the second one), so the order of the slots isn't necessarily the order of the changes
+		std::sort(changes.begin() + static_cast< std::ptrdiff_t >(first), changes.end(),
+				  [](const TalkingStateChange &lhs, const TalkingStateChange &rhs) {
+					  return lhs.sequence < rhs.sequence;
+				  });
+
+		return m_dropped.exchange(0);
+	}
+
+	TalkingStateCoalescer::TalkingStateCoalescer(std::chrono::milliseconds window, double maxRate,
+												 std::size_t maxPending, TalkingStateStatistics *statistics)
+		: m_window(window), m_maxRate(maxRate), m_maxPending(maxPending), m_statistics(statistics) {}
+
+	void TalkingStateCoalescer::setWindow(std::chrono::milliseconds window) noexcept { m_window = window; }
+
+	void TalkingStateCoalescer::setMaxRate(double maxRate) noexcept { m_maxRate = maxRate; }
+
+	void TalkingStateCoalescer::add(const TalkingStateChange &change, clock::time_point now) {
+		std::uint64_t key = toKey(change.connection, change.userID);
+
+		// Changes that have been merged while being recorded have been counted in the statistics already
+		m_merged += change.merged;
+
+		auto it = m_pendingIndex.find(key);
+		if (it != m_pendingIndex.end()) {
+			m_pending[it->second] = change;
+
+			m_merged++;
+			if (m_statistics) {
+				m_statistics->mergedChanges++;
+			}
+
+			return;
+		}
+
+		if (m_pending.size() >= m_maxPending) {
+			m_dropped++;
+			if (m_statistics) {
+				m_statistics->droppedChanges++;
+			}
+
+			return;
+		}
+
+		if (m_pending.empty()) {
+			m_pendingSince = now;
+		}
+
+		m_pendingIndex[key] = m_pending.size();
+		m_pending.push_back(change);
+	}
+
+	void TalkingStateCoalescer::addDropped(std::uint64_t amount) noexcept { m_dropped += amount; }
+
+	bool TalkingStateCoalescer::isDue(clock::time_point now) const noexcept {
+		if (m_pending.empty() || now - m_pendingSince < m_window) {
+			return false;
+		}
+
+		if (m_maxRate <= 0) {
+			return true;
+		}
+
+		return now - m_lastFrame >= std::chrono::duration< double >(1 / m_maxRate);
+	}
+
+	void TalkingStateCoalescer::write(ResponseWriter &writer, clock::time_point now) {
+		// Every change is written as [connection, user_id, talking_state]
+		writer.raw(R"("response_type":"event","response":{"topic":"talking_state","changes":[)");
+		for (std::size_t i = 0; i < m_pending.size(); i++) {
+			const TalkingStateChange &change = m_pending[i];
+
+			writer.raw(i == 0 ? "[" : ",[");
+			writer.value(change.connection);
+			writer.raw(",");
+			writer.value(change.userID);
+			writer.raw(",");
+			writer.string(talkingStateName(change.state));
+			writer.raw("]");
+		}
+		writer.raw(R"(],"merged":)");
+		writer.value(m_merged);
+		writer.raw(R"(,"dropped":)");
+		writer.value(m_dropped);
+		writer.raw("}");
+
+		m_pending.clear();
+		m_pendingIndex.clear();
+		m_merged    = 0;
+		m_dropped   = 0;
+		m_lastFrame = now;
+
+		if (m_statistics) {
+			m_statistics->sentFrames++;
+		}
+	}
+
+	std::size_t TalkingStateCoalescer::pendingChanges() const noexcept { return m_pending.size(); }
+
+}; // namespace JsonBridge
+}; // namespace Mumble
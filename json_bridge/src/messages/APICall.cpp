@@ -4,43 +4,327 @@
 // source tree.
 
 #include "mumble/json_bridge/messages/APICall.h"
+#include "mumble/json_bridge/NameIndex.h"
+#include "mumble/json_bridge/ServerState.h"
 
-// define JSON serialization functions
-template< typename ContentType > void to_json(nlohmann::json &j, const MumbleArray< ContentType > &array) {
-	std::vector< ContentType > vec;
-	vec.reserve(array.size());
-
-	for (const auto &current : array) {
-		vec.push_back(current);
-	}
-
-	j = vec;
-}
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
 
 namespace Mumble {
 namespace JsonBridge {
 	namespace Messages {
 
+		/**
+		 * Hashes the given function name (32-bit FNV-1a mixed with the given seed). This has to match the hash used by
+		 * scripts/generate_APICall_implementation.py for building the function table.
+		 */
+		constexpr std::uint32_t hashFunctionName(std::string_view name, std::uint32_t seed) {
+			std::uint32_t hash = 2166136261u ^ seed;
+
+			for (char current : name) {
+				hash ^= static_cast< unsigned char >(current);
+				hash *= 16777619u;
+			}
+
+			return hash;
+		}
+
+		// Helper for storing values encountered while reading a parameter into the respective parameter field. They
+		// return false if the value has a type that doesn't match the field's type.
+
+		template< typename T > bool readInteger(T &field, const ParameterValue &value) {
+			if (value.type == ParameterValue::Type::INTEGER) {
+				if (value.integer < static_cast< std::int64_t >(std::numeric_limits< T >::min())
+					|| value.integer > static_cast< std::int64_t >(std::numeric_limits< T >::max())) {
+					return false;
+				}
+				field = static_cast< T >(value.integer);
+				return true;
+			}
+			if (value.type == ParameterValue::Type::UNSIGNED) {
+				if (value.unsignedInteger > static_cast< std::uint64_t >(std::numeric_limits< T >::max())) {
+					return false;
+				}
+				field = static_cast< T >(value.unsignedInteger);
+				return true;
+			}
+
+			return false;
+		}
+
+		template< typename T > bool readUnsigned(T &field, const ParameterValue &value) {
+			if (value.type != ParameterValue::Type::UNSIGNED
+				|| value.unsignedInteger > static_cast< std::uint64_t >(std::numeric_limits< T >::max())) {
+				return false;
+			}
+
+			field = static_cast< T >(value.unsignedInteger);
+			return true;
+		}
+
+		bool readUnsigned(void *&field, const ParameterValue &value) {
+			if (value.type != ParameterValue::Type::UNSIGNED) {
+				return false;
+			}
+
+			field = reinterpret_cast< void * >(static_cast< std::uintptr_t >(value.unsignedInteger));
+			return true;
+		}
+
+		template< typename T > bool readFloat(T &field, const ParameterValue &value) {
+			if (value.type != ParameterValue::Type::FLOAT) {
+				return false;
+			}
+
+			field = static_cast< T >(value.floatingPoint);
+			return true;
+		}
+
+		bool readBoolean(bool &field, const ParameterValue &value) {
+			if (value.type != ParameterValue::Type::BOOLEAN) {
+				return false;
+			}
+
+			field = value.boolean;
+			return true;
+		}
+
+		bool readString(std::string &field, ParameterValue &value) {
+			if (value.type != ParameterValue::Type::STRING) {
+				return false;
+			}
+
+			field = value.string;
+			return true;
+		}
+
+		template< typename T > bool readString(T &, const ParameterValue &) {
+			// Fields that are represented by a string but aren't strings themselves (e.g. enums) are only supported
+			// when parsing the JSON representation of the parameter
+			return false;
+		}
+
+		template< typename T > bool readArray(std::vector< T > &field, ParameterValue &value) {
+			if (value.type == ParameterValue::Type::ARRAY_BEGIN) {
+				field.clear();
+				return true;
+			}
+			if (!value.arrayElement) {
+				return false;
+			}
+
+			T element;
+			bool success;
+			if constexpr (std::is_same_v< T, std::string >) {
+				success = readString(element, value);
+			} else if constexpr (std::is_same_v< T, bool >) {
+				success = readBoolean(element, value);
+			} else if constexpr (std::is_floating_point_v< T >) {
+				success = readFloat(element, value);
+			} else {
+				success = readInteger(element, value);
+			}
+
+			if (success) {
+				field.push_back(std::move(element));
+			}
+
+			return success;
+		}
+
+		/**
+		 * Writes the response_type and response fields of the response to a call that failed with the given exception
+		 */
+		void writeAPIError(ResponseWriter &writer, const MumbleAPIException &e) {
+			writer.raw(R"("response_type":"api_error","response":{"error_code":)");
+			writer.value(e.errorCode());
+			writer.raw(R"(,"error_message":)");
+			writer.string(e.what());
+			writer.raw("}");
+		}
+
+		void writeDescriptionHash(ResponseWriter &writer, std::string_view description) {
+			std::uint64_t hash = 14695981039346656037ull;
+			for (char current : description) {
+				hash ^= static_cast< unsigned char >(current);
+				hash *= 1099511628211ull;
+			}
+
+			// Quoted, with all leading zeros
+			char digits[18];
+			digits[0]  = '"';
+			digits[17] = '"';
+			for (int i = 16; i > 0; i--, hash >>= 4) {
+				digits[i] = "0123456789abcdef"[hash & 0xF];
+			}
+
+			writer.raw(std::string_view(digits, sizeof(digits)));
+		}
+
+		// Implementations of the functions that are provided by the Bridge itself (see BRIDGE_FUNCTIONS in
+		// scripts/generate_APICall_implementation.py). Their parse_* and read_* functions are generated.
+
+		bool write_getServerSnapshot(const MumbleAPI &api, const APIParameter &parameter, ResponseWriter &writer) {
+			const Parameter_getServerSnapshot &fields = std::get< Parameter_getServerSnapshot >(parameter);
+
+			// The snapshot is written while walking the users and channels, so a failing call leaves a partial
+			// response behind that has to be discarded
+			const std::size_t responseStart = writer.buffer().size();
+
+			try {
+				writer.raw(R"("response_type":"api_call","response":{"function":"getServerSnapshot",)");
+				// Only the model of the server state keeps track of versions (and answers this call itself for the
+				// servers it models). getChangesSince tells the client to take a new snapshot for any other server.
+				writer.raw(R"("status":"executed","return_value":{"version":0,"users":[)");
+
+				bool first = true;
+				for (mumble_userid_t current : api.getAllUsers(fields.connection)) {
+					writer.raw(first ? R"({"id":)" : R"(,{"id":)");
+					writer.value(current);
+					writer.raw(R"(,"name":)");
+					writer.value(api.getUserName(fields.connection, current));
+					writer.raw(R"(,"channel":)");
+					writer.value(api.getChannelOfUser(fields.connection, current));
+					writer.raw(R"(,"locally_muted":)");
+					writer.value(api.isUserLocallyMuted(fields.connection, current));
+					writer.raw("}");
+
+					first = false;
+				}
+
+				writer.raw(R"(],"channels":[)");
+
+				first = true;
+				for (mumble_channelid_t current : api.getAllChannels(fields.connection)) {
+					writer.raw(first ? R"({"id":)" : R"(,{"id":)");
+					writer.value(current);
+					writer.raw(R"(,"name":)");
+					writer.value(api.getChannelName(fields.connection, current));
+					writer.raw(R"(,"description_hash":)");
+					writeDescriptionHash(writer, api.getChannelDescription(fields.connection, current).c_str());
+					writer.raw("}");
+
+					first = false;
+				}
+
+				writer.raw("]}}");
+
+				return true;
+			} catch (const MumbleAPIException &e) {
+				writer.buffer().resize(responseStart);
+
+				writeAPIError(writer, e);
+
+				return false;
+			}
+		}
+
+		bool write_getChangesSince(const MumbleAPI &, const APIParameter &, ResponseWriter &writer) {
+			// The changes are only known to the model of the server state (which answers this call itself), so
+			// without one all the client can do is fetching everything again
+			writer.raw(R"("response_type":"api_call","response":{"function":"getChangesSince","status":"executed",)");
+			writer.raw(R"("return_value":{"version":0,"resync":true}})");
+
+			return true;
+		}
+
+		/**
+		 * Writes the response of findUsersByName or findChannelsByName by asking the API for the name of every single
+		 * user or channel. This is only used if the server isn't modelled (otherwise the model's name index answers
+		 * the call).
+		 *
+		 * @param getName The function looking up the name belonging to an ID via the API
+		 */
+		template< typename id_t, typename GetName >
+		void writeNameMatches(ResponseWriter &writer, std::string_view function, const MumbleArray< id_t > &ids,
+							  GetName getName, std::string_view query, bool caseSensitive, bool prefix) {
+			std::vector< id_t > matches;
+			for (id_t current : ids) {
+				if (nameMatches(getName(current).c_str(), query, caseSensitive, prefix)) {
+					matches.push_back(current);
+				}
+			}
+
+			std::sort(matches.begin(), matches.end());
+
+			writer.raw(R"("response_type":"api_call","response":{"function":")");
+			writer.raw(function);
+			writer.raw(R"(","status":"executed","return_value":)");
+			writer.value(matches);
+			writer.raw("}");
+		}
+
+		bool write_findUsersByName(const MumbleAPI &api, const APIParameter &parameter, ResponseWriter &writer) {
+			const Parameter_findUsersByName &fields = std::get< Parameter_findUsersByName >(parameter);
+
+			try {
+				writeNameMatches(
+					writer, "findUsersByName", api.getAllUsers(fields.connection),
+					[&](mumble_userid_t id) { return api.getUserName(fields.connection, id); }, fields.user_name,
+					fields.case_sensitive, fields.prefix);
+
+				return true;
+			} catch (const MumbleAPIException &e) {
+				writeAPIError(writer, e);
+
+				return false;
+			}
+		}
+
+		bool write_findChannelsByName(const MumbleAPI &api, const APIParameter &parameter, ResponseWriter &writer) {
+			const Parameter_findChannelsByName &fields = std::get< Parameter_findChannelsByName >(parameter);
+
+			try {
+				writeNameMatches(
+					writer, "findChannelsByName", api.getAllChannels(fields.connection),
+					[&](mumble_channelid_t id) { return api.getChannelName(fields.connection, id); },
+					fields.channel_name, fields.case_sensitive, fields.prefix);
+
+				return true;
+			} catch (const MumbleAPIException &e) {
+				writeAPIError(writer, e);
+
+				return false;
+			}
+		}
+
 // include function implementations
 #include "APICall_handleImpl.cpp"
 
-		APICall::APICall(const MumbleAPI &api, const nlohmann::json &msg)
-			: Message(MessageType::API_CALL), m_api(api), m_msg(msg) {
+		APICall::APICall(const MumbleAPI &api, const nlohmann::json &msg, const ServerState *serverState)
+			: Message(MessageType::API_CALL), m_api(api), m_serverState(serverState) {
 			MESSAGE_ASSERT_FIELD(msg, "function", string);
 
-			m_functionName = msg["function"].get< std::string >();
+			const std::string &functionName = msg["function"].get_ref< const std::string & >();
 
-			if (s_allFunctions.count(m_functionName) == 0) {
-				throw InvalidMessageException(std::string("Unknown API function \"") + m_functionName + "\"");
+			m_function = findAPIFunction(functionName);
+
+			if (!m_function) {
+				throw InvalidMessageException(std::string("Unknown API function \"") + functionName + "\"");
 			}
 
-			if (s_noParamFunctions.count(m_functionName) == 0) {
+			if (m_function->parameterCount > 0) {
 				MESSAGE_ASSERT_FIELD(msg, "parameter", object);
+
+				m_parameter = m_function->parse(msg["parameter"]);
 			}
 		}
 
-		nlohmann::json APICall::execute(const std::string &bridgeSecret) const {
-			return ::Mumble::JsonBridge::Messages::execute(m_functionName, m_api, bridgeSecret, m_msg);
+		APICall::APICall(const MumbleAPI &api, const APIFunction &function, APIParameter parameter,
+						 const ServerState *serverState)
+			: Message(MessageType::API_CALL), m_function(&function), m_api(api), m_serverState(serverState),
+			  m_parameter(std::move(parameter)) {}
+
+		bool APICall::write(ResponseWriter &writer) const {
+			if (m_serverState && m_serverState->write(m_parameter, writer)) {
+				return true;
+			}
+
+			return m_function->write(m_api, m_parameter, writer);
 		}
 
 	}; // namespace Messages
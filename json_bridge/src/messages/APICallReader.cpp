@@ -0,0 +1,333 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+#include "mumble/json_bridge/messages/APICallReader.h"
+#include "mumble/json_bridge/Arena.h"
+#include "mumble/json_bridge/messages/JSONTextReader.h"
+
+#include <bitset>
+#include <cstdint>
+
+#include <boost/algorithm/string.hpp>
+
+namespace Mumble {
+namespace JsonBridge {
+	namespace Messages {
+
+		namespace {
+			/**
+			 * SAX handler that reads an API-call request into an APICallRequest. Every handler returns false (which
+			 * aborts reading) as soon as the message turns out to be something it can't read. Strings are handed to
+			 * it as views that only stay valid until the end of the message, so whatever is kept is copied.
+			 */
+			class APICallSaxReader {
+			public:
+				explicit APICallSaxReader(APICallRequest &request) : m_request(request) {}
+
+				/**
+				 * @returns Whether a complete API-call request has been read
+				 */
+				bool isComplete() const {
+					return m_scope == Scope::DONE
+						   && m_envelopeFields.test(static_cast< std::size_t >(Field::MESSAGE_TYPE))
+						   && m_envelopeFields.test(static_cast< std::size_t >(Field::MESSAGE)) && m_request.function
+						   && m_parameterFields.count() == m_request.function->parameterCount;
+				}
+
+				bool null() { return false; }
+
+				bool boolean(bool val) {
+					ParameterValue value;
+					value.type    = ParameterValue::Type::BOOLEAN;
+					value.boolean = val;
+
+					return readParameter(value);
+				}
+
+				bool number_integer(std::int64_t val) {
+					if (m_scope == Scope::ENVELOPE && m_field == Field::REQUEST_ID) {
+						m_request.requestID = val;
+						return true;
+					}
+
+					// Negative client IDs are left to the regular parsing
+					ParameterValue value;
+					value.type    = ParameterValue::Type::INTEGER;
+					value.integer = val;
+
+					return readParameter(value);
+				}
+
+				bool number_unsigned(std::uint64_t val) {
+					if (m_scope == Scope::ENVELOPE) {
+						switch (m_field) {
+							case Field::CLIENT_ID:
+								m_request.clientID = val;
+								return true;
+							case Field::REQUEST_ID:
+								m_request.requestID = val;
+								return true;
+							default:
+								return false;
+						}
+					}
+
+					ParameterValue value;
+					value.type            = ParameterValue::Type::UNSIGNED;
+					value.unsignedInteger = val;
+
+					return readParameter(value);
+				}
+
+				bool number_float(double val) {
+					ParameterValue value;
+					value.type          = ParameterValue::Type::FLOAT;
+					value.floatingPoint = val;
+
+					return readParameter(value);
+				}
+
+				bool string(std::string_view val) {
+					if (m_scope == Scope::ENVELOPE) {
+						switch (m_field) {
+							case Field::MESSAGE_TYPE:
+								return boost::iequals(val, to_string(MessageType::API_CALL));
+							case Field::SECRET:
+								m_request.secret = std::string(val);
+								return true;
+							case Field::REQUEST_ID:
+								m_request.requestID = std::string(val);
+								return true;
+							default:
+								return false;
+						}
+					}
+
+					if (m_scope == Scope::MESSAGE) {
+						if (m_field != Field::FUNCTION) {
+							return false;
+						}
+
+						m_request.function = findAPIFunction(val);
+
+						return m_request.function != nullptr;
+					}
+
+					ParameterValue value;
+					value.type   = ParameterValue::Type::STRING;
+					value.string = val;
+
+					return readParameter(value);
+				}
+
+				bool start_object() {
+					switch (m_scope) {
+						case Scope::NONE:
+							m_scope = Scope::ENVELOPE;
+							return true;
+						case Scope::ENVELOPE:
+							if (m_field != Field::MESSAGE) {
+								return false;
+							}
+
+							m_scope = Scope::MESSAGE;
+							return true;
+						case Scope::MESSAGE:
+							// The parameter can only be read once it is known which function it belongs to
+							if (m_field != Field::PARAMETER || !m_request.function
+								|| m_request.function->parameterCount == 0) {
+								return false;
+							}
+
+							m_scope = Scope::PARAMETER;
+							return true;
+						default:
+							return false;
+					}
+				}
+
+				bool key(std::string_view val) {
+					switch (m_scope) {
+						case Scope::ENVELOPE:
+							if (val == "message_type") {
+								return expect(Field::MESSAGE_TYPE);
+							} else if (val == "client_id") {
+								return expect(Field::CLIENT_ID);
+							} else if (val == "secret") {
+								return expect(Field::SECRET);
+							} else if (val == "request_id") {
+								return expect(Field::REQUEST_ID);
+							} else if (val == "message") {
+								return expect(Field::MESSAGE);
+							}
+
+							return false;
+						case Scope::MESSAGE:
+							if (val == "function") {
+								return expect(Field::FUNCTION);
+							} else if (val == "parameter") {
+								return expect(Field::PARAMETER);
+							}
+
+							return false;
+						case Scope::PARAMETER:
+							m_parameterName = val;
+							return true;
+						default:
+							return false;
+					}
+				}
+
+				bool end_object() {
+					switch (m_scope) {
+						case Scope::ENVELOPE:
+							m_scope = Scope::DONE;
+							return true;
+						case Scope::MESSAGE:
+							m_scope = Scope::ENVELOPE;
+							return true;
+						case Scope::PARAMETER:
+							m_scope = Scope::MESSAGE;
+							return true;
+						default:
+							return false;
+					}
+				}
+
+				bool skipValue() const { return false; }
+
+				bool start_array() {
+					if (m_scope != Scope::PARAMETER) {
+						return false;
+					}
+
+					ParameterValue value;
+					value.type = ParameterValue::Type::ARRAY_BEGIN;
+
+					if (!readParameter(value)) {
+						return false;
+					}
+
+					m_scope = Scope::ARRAY;
+					return true;
+				}
+
+				bool end_array() {
+					if (m_scope != Scope::ARRAY) {
+						return false;
+					}
+
+					m_scope = Scope::PARAMETER;
+					return true;
+				}
+
+			private:
+				enum class Scope { NONE, ENVELOPE, MESSAGE, PARAMETER, ARRAY, DONE };
+				enum class Field { MESSAGE_TYPE, CLIENT_ID, SECRET, REQUEST_ID, MESSAGE, FUNCTION, PARAMETER };
+
+				/**
+				 * Remembers that the next value belongs to the given field. Fields must not be given more than once.
+				 */
+				bool expect(Field field) {
+					std::size_t index = static_cast< std::size_t >(field);
+
+					if (m_envelopeFields.test(index)) {
+						return false;
+					}
+
+					m_envelopeFields.set(index);
+					m_field = field;
+
+					return true;
+				}
+
+				/**
+				 * Stores the given value in the parameter field whose key has been read last
+				 */
+				bool readParameter(ParameterValue &value) {
+					if (m_scope == Scope::ARRAY) {
+						value.arrayElement = true;
+
+						return m_request.function->read(m_request.parameter, m_parameterName, value) >= 0;
+					}
+
+					if (m_scope != Scope::PARAMETER) {
+						return false;
+					}
+
+					int index = m_request.function->read(m_request.parameter, m_parameterName, value);
+
+					if (index < 0 || m_parameterFields.test(static_cast< std::size_t >(index))) {
+						return false;
+					}
+
+					m_parameterFields.set(static_cast< std::size_t >(index));
+
+					return true;
+				}
+
+				APICallRequest &m_request;
+				Scope m_scope = Scope::NONE;
+				Field m_field = Field::MESSAGE_TYPE;
+				std::bitset< 8 > m_envelopeFields;
+				std::bitset< 64 > m_parameterFields;
+				std::string_view m_parameterName;
+			};
+
+			/**
+			 * Feeds the messages nlohmann::json reads (in binary encodings) into an APICallSaxReader
+			 */
+			class NlohmannSaxAdapter : public nlohmann::json_sax< nlohmann::json > {
+			public:
+				explicit NlohmannSaxAdapter(APICallSaxReader &reader) : m_reader(reader) {}
+
+				bool null() override { return m_reader.null(); }
+				bool boolean(bool val) override { return m_reader.boolean(val); }
+				bool number_integer(number_integer_t val) override { return m_reader.number_integer(val); }
+				bool number_unsigned(number_unsigned_t val) override { return m_reader.number_unsigned(val); }
+				bool number_float(number_float_t val, const string_t &) override { return m_reader.number_float(val); }
+				bool string(string_t &val) override { return m_reader.string(val); }
+				bool binary(binary_t &) override { return false; }
+				bool start_object(std::size_t) override { return m_reader.start_object(); }
+				bool key(string_t &val) override {
+					// The reader keeps a view of the key while reading the value that belongs to it
+					m_key = std::move(val);
+
+					return m_reader.key(m_key);
+				}
+				bool end_object() override { return m_reader.end_object(); }
+				bool start_array(std::size_t) override { return m_reader.start_array(); }
+				bool end_array() override { return m_reader.end_array(); }
+				bool parse_error(std::size_t, const std::string &, const nlohmann::detail::exception &) override {
+					return false;
+				}
+
+			private:
+				APICallSaxReader &m_reader;
+				std::string m_key;
+			};
+		}; // namespace
+
+		bool readAPICall(std::string_view message, APICallRequest &request, Encoding encoding) {
+			request = APICallRequest();
+
+			APICallSaxReader reader(request);
+
+			if (encoding == Encoding::JSON) {
+				// Decoded strings only need to live until the request has been read
+				Arena &arena = Arena::forThisThread();
+				arena.reset();
+
+				return JSONTextReader< APICallSaxReader >(message, reader, arena).read() && reader.isComplete();
+			}
+
+			NlohmannSaxAdapter adapter(reader);
+
+			return nlohmann::json::sax_parse(message.begin(), message.end(), &adapter, inputFormat(encoding))
+				   && reader.isComplete();
+		}
+	}; // namespace Messages
+};     // namespace JsonBridge
+};     // namespace Mumble
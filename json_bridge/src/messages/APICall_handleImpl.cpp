@@ -5,54 +5,7 @@
 
 // This file was auto-generated by scripts/generate_APICall_implementation.py. DO NOT EDIT MANUALLY!
 
-const std::unordered_set< std::string > APICall::s_allFunctions = { "freeMemory",
-																	"getActiveServerConnection",
-																	"isConnectionSynchronized",
-																	"getLocalUserID",
-																	"getUserName",
-																	"getChannelName",
-																	"getAllUsers",
-																	"getAllChannels",
-																	"getChannelOfUser",
-																	"getUsersInChannel",
-																	"getLocalUserTransmissionMode",
-																	"isUserLocallyMuted",
-																	"isLocalUserMuted",
-																	"isLocalUserDeafened",
-																	"getUserHash",
-																	"getServerHash",
-																	"getUserComment",
-																	"getChannelDescription",
-																	"requestLocalUserTransmissionMode",
-																	"requestUserMove",
-																	"requestMicrophoneActivationOvewrite",
-																	"requestLocalMute",
-																	"requestLocalUserMute",
-																	"requestLocalUserDeaf",
-																	"requestSetLocalUserComment",
-																	"findUserByName",
-																	"findUserByName_noexcept",
-																	"findChannelByName",
-																	"findChannelByName_noexcept",
-																	"getMumbleSetting_bool",
-																	"getMumbleSetting_int",
-																	"getMumbleSetting_double",
-																	"getMumbleSetting_string",
-																	"setMumbleSetting_bool",
-																	"setMumbleSetting_int",
-																	"setMumbleSetting_double",
-																	"setMumbleSetting_string",
-																	"sendData",
-																	"log",
-																	"log_noexcept",
-																	"playSample" };
-
-const std::unordered_set< std::string > APICall::s_noParamFunctions = { "getActiveServerConnection",
-																		"getLocalUserTransmissionMode",
-																		"isLocalUserMuted", "isLocalUserDeafened" };
-
-nlohmann::json handle_freeMemory(const MumbleAPI &api, const std::string &bridgeSecret,
-								 const nlohmann::json &parameter) {
+APIParameter parse_freeMemory(const nlohmann::json &parameter) {
 	// Validate specified parameter
 	if (parameter.size() != 1) {
 		throw InvalidMessageException(std::string("API function \"freeMemory\" expects 1 parameter(s) but got ")
@@ -61,84 +14,60 @@ nlohmann::json handle_freeMemory(const MumbleAPI &api, const std::string &bridge
 	MESSAGE_ASSERT_FIELD(parameter, "pointer", number_unsigned);
 
 	// Convert the parameter from JSON to the corresponding cpp types
-	void *pointer = reinterpret_cast< void * >(parameter["pointer"].get< uintptr_t >());
+	Parameter_freeMemory fields;
+	fields.pointer = reinterpret_cast< void * >(parameter["pointer"].get< uintptr_t >());
 
-	// Call respective API function with extracted parameter
-	nlohmann::json response;
+	return fields;
+}
+
+int read_freeMemory(APIParameter &parameter, std::string_view name, ParameterValue &value) {
+	if (!std::holds_alternative< Parameter_freeMemory >(parameter)) {
+		parameter.emplace< Parameter_freeMemory >();
+	}
+	Parameter_freeMemory &fields = std::get< Parameter_freeMemory >(parameter);
+
+	if (name == "pointer") {
+		return readUnsigned(fields.pointer, value) ? 0 : -1;
+	}
+
+	return -1;
+}
 
+bool write_freeMemory(const MumbleAPI &api, const APIParameter &parameter, ResponseWriter &writer) {
+	const Parameter_freeMemory &fields = std::get< Parameter_freeMemory >(parameter);
+
+	// Call respective API function with extracted parameter
 	try {
-		api.freeMemory(pointer);
-
-		// clang-format off
-		response = {
-			{"response_type", "api_call"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"function", "freeMemory"},
-					{"status", "executed"}
-				}
-			}
-		};
-		// clang-format on
+		api.freeMemory(fields.pointer);
+
+		writer.raw(R"("response_type":"api_call","response":{"function":"freeMemory","status":"executed"})");
+
+		return true;
 	} catch (const MumbleAPIException &e) {
-		// clang-format off
-		response = {
-			{"response_type", "api_error"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"error_code", e.errorCode()},
-					{"error_message", e.what()}
-				}
-			}
-		};
-		// clang-format on
-	}
+		writeAPIError(writer, e);
 
-	return response;
+		return false;
+	}
 }
 
-nlohmann::json handle_getActiveServerConnection(const MumbleAPI &api, const std::string &bridgeSecret) {
+bool write_getActiveServerConnection(const MumbleAPI &api, const APIParameter &, ResponseWriter &writer) {
 	// Call respective API function
-	nlohmann::json response;
-
 	try {
 		mumble_connection_t ret = api.getActiveServerConnection();
 
-		// clang-format off
-		response = {
-			{"response_type", "api_call"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"function", "getActiveServerConnection"},
-					{"status", "executed"},
-					{"return_value", ret}
-				}
-			}
-		};
-		// clang-format on
+		writer.raw(R"("response_type":"api_call","response":{"function":"getActiveServerConnection","status":"executed","return_value":)");
+		writer.value(ret);
+		writer.raw("}");
+
+		return true;
 	} catch (const MumbleAPIException &e) {
-		// clang-format off
-		response = {
-			{"response_type", "api_error"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"error_code", e.errorCode()},
-					{"error_message", e.what()}
-				}
-			}
-		};
-		// clang-format on
-	}
+		writeAPIError(writer, e);
 
-	return response;
+		return false;
+	}
 }
 
-nlohmann::json handle_isConnectionSynchronized(const MumbleAPI &api, const std::string &bridgeSecret,
-											   const nlohmann::json &parameter) {
+APIParameter parse_isConnectionSynchronized(const nlohmann::json &parameter) {
 	// Validate specified parameter
 	if (parameter.size() != 1) {
 		throw InvalidMessageException(
@@ -148,47 +77,45 @@ nlohmann::json handle_isConnectionSynchronized(const MumbleAPI &api, const std::
 	MESSAGE_ASSERT_FIELD(parameter, "connection", number_integer);
 
 	// Convert the parameter from JSON to the corresponding cpp types
-	mumble_connection_t connection = parameter["connection"].get< mumble_connection_t >();
+	Parameter_isConnectionSynchronized fields;
+	fields.connection = parameter["connection"].get< mumble_connection_t >();
 
-	// Call respective API function with extracted parameter
-	nlohmann::json response;
+	return fields;
+}
+
+int read_isConnectionSynchronized(APIParameter &parameter, std::string_view name, ParameterValue &value) {
+	if (!std::holds_alternative< Parameter_isConnectionSynchronized >(parameter)) {
+		parameter.emplace< Parameter_isConnectionSynchronized >();
+	}
+	Parameter_isConnectionSynchronized &fields = std::get< Parameter_isConnectionSynchronized >(parameter);
+
+	if (name == "connection") {
+		return readInteger(fields.connection, value) ? 0 : -1;
+	}
 
+	return -1;
+}
+
+bool write_isConnectionSynchronized(const MumbleAPI &api, const APIParameter &parameter, ResponseWriter &writer) {
+	const Parameter_isConnectionSynchronized &fields = std::get< Parameter_isConnectionSynchronized >(parameter);
+
+	// Call respective API function with extracted parameter
 	try {
-		bool ret = api.isConnectionSynchronized(connection);
-
-		// clang-format off
-		response = {
-			{"response_type", "api_call"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"function", "isConnectionSynchronized"},
-					{"status", "executed"},
-					{"return_value", ret}
-				}
-			}
-		};
-		// clang-format on
+		bool ret = api.isConnectionSynchronized(fields.connection);
+
+		writer.raw(R"("response_type":"api_call","response":{"function":"isConnectionSynchronized","status":"executed","return_value":)");
+		writer.value(ret);
+		writer.raw("}");
+
+		return true;
 	} catch (const MumbleAPIException &e) {
-		// clang-format off
-		response = {
-			{"response_type", "api_error"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"error_code", e.errorCode()},
-					{"error_message", e.what()}
-				}
-			}
-		};
-		// clang-format on
-	}
+		writeAPIError(writer, e);
 
-	return response;
+		return false;
+	}
 }
 
-nlohmann::json handle_getLocalUserID(const MumbleAPI &api, const std::string &bridgeSecret,
-									 const nlohmann::json &parameter) {
+APIParameter parse_getLocalUserID(const nlohmann::json &parameter) {
 	// Validate specified parameter
 	if (parameter.size() != 1) {
 		throw InvalidMessageException(std::string("API function \"getLocalUserID\" expects 1 parameter(s) but got ")
@@ -197,47 +124,45 @@ nlohmann::json handle_getLocalUserID(const MumbleAPI &api, const std::string &br
 	MESSAGE_ASSERT_FIELD(parameter, "connection", number_integer);
 
 	// Convert the parameter from JSON to the corresponding cpp types
-	mumble_connection_t connection = parameter["connection"].get< mumble_connection_t >();
+	Parameter_getLocalUserID fields;
+	fields.connection = parameter["connection"].get< mumble_connection_t >();
 
-	// Call respective API function with extracted parameter
-	nlohmann::json response;
+	return fields;
+}
+
+int read_getLocalUserID(APIParameter &parameter, std::string_view name, ParameterValue &value) {
+	if (!std::holds_alternative< Parameter_getLocalUserID >(parameter)) {
+		parameter.emplace< Parameter_getLocalUserID >();
+	}
+	Parameter_getLocalUserID &fields = std::get< Parameter_getLocalUserID >(parameter);
+
+	if (name == "connection") {
+		return readInteger(fields.connection, value) ? 0 : -1;
+	}
+
+	return -1;
+}
 
+bool write_getLocalUserID(const MumbleAPI &api, const APIParameter &parameter, ResponseWriter &writer) {
+	const Parameter_getLocalUserID &fields = std::get< Parameter_getLocalUserID >(parameter);
+
+	// Call respective API function with extracted parameter
 	try {
-		mumble_userid_t ret = api.getLocalUserID(connection);
-
-		// clang-format off
-		response = {
-			{"response_type", "api_call"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"function", "getLocalUserID"},
-					{"status", "executed"},
-					{"return_value", ret}
-				}
-			}
-		};
-		// clang-format on
+		mumble_userid_t ret = api.getLocalUserID(fields.connection);
+
+		writer.raw(R"("response_type":"api_call","response":{"function":"getLocalUserID","status":"executed","return_value":)");
+		writer.value(ret);
+		writer.raw("}");
+
+		return true;
 	} catch (const MumbleAPIException &e) {
-		// clang-format off
-		response = {
-			{"response_type", "api_error"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"error_code", e.errorCode()},
-					{"error_message", e.what()}
-				}
-			}
-		};
-		// clang-format on
-	}
+		writeAPIError(writer, e);
 
-	return response;
+		return false;
+	}
 }
 
-nlohmann::json handle_getUserName(const MumbleAPI &api, const std::string &bridgeSecret,
-								  const nlohmann::json &parameter) {
+APIParameter parse_getUserName(const nlohmann::json &parameter) {
 	// Validate specified parameter
 	if (parameter.size() != 2) {
 		throw InvalidMessageException(std::string("API function \"getUserName\" expects 2 parameter(s) but got ")
@@ -247,48 +172,49 @@ nlohmann::json handle_getUserName(const MumbleAPI &api, const std::string &bridg
 	MESSAGE_ASSERT_FIELD(parameter, "user_id", number_unsigned);
 
 	// Convert the parameter from JSON to the corresponding cpp types
-	mumble_connection_t connection = parameter["connection"].get< mumble_connection_t >();
-	mumble_userid_t user_id        = parameter["user_id"].get< mumble_userid_t >();
+	Parameter_getUserName fields;
+	fields.connection = parameter["connection"].get< mumble_connection_t >();
+	fields.user_id = parameter["user_id"].get< mumble_userid_t >();
 
-	// Call respective API function with extracted parameter
-	nlohmann::json response;
+	return fields;
+}
 
+int read_getUserName(APIParameter &parameter, std::string_view name, ParameterValue &value) {
+	if (!std::holds_alternative< Parameter_getUserName >(parameter)) {
+		parameter.emplace< Parameter_getUserName >();
+	}
+	Parameter_getUserName &fields = std::get< Parameter_getUserName >(parameter);
+
+	if (name == "connection") {
+		return readInteger(fields.connection, value) ? 0 : -1;
+	}
+	if (name == "user_id") {
+		return readUnsigned(fields.user_id, value) ? 1 : -1;
+	}
+
+	return -1;
+}
+
+bool write_getUserName(const MumbleAPI &api, const APIParameter &parameter, ResponseWriter &writer) {
+	const Parameter_getUserName &fields = std::get< Parameter_getUserName >(parameter);
+
+	// Call respective API function with extracted parameter
 	try {
-		MumbleString ret = api.getUserName(connection, user_id);
-
-		// clang-format off
-		response = {
-			{"response_type", "api_call"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"function", "getUserName"},
-					{"status", "executed"},
-					{"return_value", ret}
-				}
-			}
-		};
-		// clang-format on
+		MumbleString ret = api.getUserName(fields.connection, fields.user_id);
+
+		writer.raw(R"("response_type":"api_call","response":{"function":"getUserName","status":"executed","return_value":)");
+		writer.value(ret);
+		writer.raw("}");
+
+		return true;
 	} catch (const MumbleAPIException &e) {
-		// clang-format off
-		response = {
-			{"response_type", "api_error"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"error_code", e.errorCode()},
-					{"error_message", e.what()}
-				}
-			}
-		};
-		// clang-format on
-	}
+		writeAPIError(writer, e);
 
-	return response;
+		return false;
+	}
 }
 
-nlohmann::json handle_getChannelName(const MumbleAPI &api, const std::string &bridgeSecret,
-									 const nlohmann::json &parameter) {
+APIParameter parse_getChannelName(const nlohmann::json &parameter) {
 	// Validate specified parameter
 	if (parameter.size() != 2) {
 		throw InvalidMessageException(std::string("API function \"getChannelName\" expects 2 parameter(s) but got ")
@@ -298,48 +224,49 @@ nlohmann::json handle_getChannelName(const MumbleAPI &api, const std::string &br
 	MESSAGE_ASSERT_FIELD(parameter, "channel_id", number_integer);
 
 	// Convert the parameter from JSON to the corresponding cpp types
-	mumble_connection_t connection = parameter["connection"].get< mumble_connection_t >();
-	mumble_channelid_t channel_id  = parameter["channel_id"].get< mumble_channelid_t >();
+	Parameter_getChannelName fields;
+	fields.connection = parameter["connection"].get< mumble_connection_t >();
+	fields.channel_id = parameter["channel_id"].get< mumble_channelid_t >();
 
-	// Call respective API function with extracted parameter
-	nlohmann::json response;
+	return fields;
+}
+
+int read_getChannelName(APIParameter &parameter, std::string_view name, ParameterValue &value) {
+	if (!std::holds_alternative< Parameter_getChannelName >(parameter)) {
+		parameter.emplace< Parameter_getChannelName >();
+	}
+	Parameter_getChannelName &fields = std::get< Parameter_getChannelName >(parameter);
+
+	if (name == "connection") {
+		return readInteger(fields.connection, value) ? 0 : -1;
+	}
+	if (name == "channel_id") {
+		return readInteger(fields.channel_id, value) ? 1 : -1;
+	}
 
+	return -1;
+}
+
+bool write_getChannelName(const MumbleAPI &api, const APIParameter &parameter, ResponseWriter &writer) {
+	const Parameter_getChannelName &fields = std::get< Parameter_getChannelName >(parameter);
+
+	// Call respective API function with extracted parameter
 	try {
-		MumbleString ret = api.getChannelName(connection, channel_id);
-
-		// clang-format off
-		response = {
-			{"response_type", "api_call"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"function", "getChannelName"},
-					{"status", "executed"},
-					{"return_value", ret}
-				}
-			}
-		};
-		// clang-format on
+		MumbleString ret = api.getChannelName(fields.connection, fields.channel_id);
+
+		writer.raw(R"("response_type":"api_call","response":{"function":"getChannelName","status":"executed","return_value":)");
+		writer.value(ret);
+		writer.raw("}");
+
+		return true;
 	} catch (const MumbleAPIException &e) {
-		// clang-format off
-		response = {
-			{"response_type", "api_error"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"error_code", e.errorCode()},
-					{"error_message", e.what()}
-				}
-			}
-		};
-		// clang-format on
-	}
+		writeAPIError(writer, e);
 
-	return response;
+		return false;
+	}
 }
 
-nlohmann::json handle_getAllUsers(const MumbleAPI &api, const std::string &bridgeSecret,
-								  const nlohmann::json &parameter) {
+APIParameter parse_getAllUsers(const nlohmann::json &parameter) {
 	// Validate specified parameter
 	if (parameter.size() != 1) {
 		throw InvalidMessageException(std::string("API function \"getAllUsers\" expects 1 parameter(s) but got ")
@@ -348,47 +275,45 @@ nlohmann::json handle_getAllUsers(const MumbleAPI &api, const std::string &bridg
 	MESSAGE_ASSERT_FIELD(parameter, "connection", number_integer);
 
 	// Convert the parameter from JSON to the corresponding cpp types
-	mumble_connection_t connection = parameter["connection"].get< mumble_connection_t >();
+	Parameter_getAllUsers fields;
+	fields.connection = parameter["connection"].get< mumble_connection_t >();
 
-	// Call respective API function with extracted parameter
-	nlohmann::json response;
+	return fields;
+}
+
+int read_getAllUsers(APIParameter &parameter, std::string_view name, ParameterValue &value) {
+	if (!std::holds_alternative< Parameter_getAllUsers >(parameter)) {
+		parameter.emplace< Parameter_getAllUsers >();
+	}
+	Parameter_getAllUsers &fields = std::get< Parameter_getAllUsers >(parameter);
 
+	if (name == "connection") {
+		return readInteger(fields.connection, value) ? 0 : -1;
+	}
+
+	return -1;
+}
+
+bool write_getAllUsers(const MumbleAPI &api, const APIParameter &parameter, ResponseWriter &writer) {
+	const Parameter_getAllUsers &fields = std::get< Parameter_getAllUsers >(parameter);
+
+	// Call respective API function with extracted parameter
 	try {
-		MumbleArray< mumble_userid_t > ret = api.getAllUsers(connection);
-
-		// clang-format off
-		response = {
-			{"response_type", "api_call"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"function", "getAllUsers"},
-					{"status", "executed"},
-					{"return_value", ret}
-				}
-			}
-		};
-		// clang-format on
+		MumbleArray< mumble_userid_t > ret = api.getAllUsers(fields.connection);
+
+		writer.raw(R"("response_type":"api_call","response":{"function":"getAllUsers","status":"executed","return_value":)");
+		writer.value(ret);
+		writer.raw("}");
+
+		return true;
 	} catch (const MumbleAPIException &e) {
-		// clang-format off
-		response = {
-			{"response_type", "api_error"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"error_code", e.errorCode()},
-					{"error_message", e.what()}
-				}
-			}
-		};
-		// clang-format on
-	}
+		writeAPIError(writer, e);
 
-	return response;
+		return false;
+	}
 }
 
-nlohmann::json handle_getAllChannels(const MumbleAPI &api, const std::string &bridgeSecret,
-									 const nlohmann::json &parameter) {
+APIParameter parse_getAllChannels(const nlohmann::json &parameter) {
 	// Validate specified parameter
 	if (parameter.size() != 1) {
 		throw InvalidMessageException(std::string("API function \"getAllChannels\" expects 1 parameter(s) but got ")
@@ -397,47 +322,45 @@ nlohmann::json handle_getAllChannels(const MumbleAPI &api, const std::string &br
 	MESSAGE_ASSERT_FIELD(parameter, "connection", number_integer);
 
 	// Convert the parameter from JSON to the corresponding cpp types
-	mumble_connection_t connection = parameter["connection"].get< mumble_connection_t >();
+	Parameter_getAllChannels fields;
+	fields.connection = parameter["connection"].get< mumble_connection_t >();
 
-	// Call respective API function with extracted parameter
-	nlohmann::json response;
+	return fields;
+}
+
+int read_getAllChannels(APIParameter &parameter, std::string_view name, ParameterValue &value) {
+	if (!std::holds_alternative< Parameter_getAllChannels >(parameter)) {
+		parameter.emplace< Parameter_getAllChannels >();
+	}
+	Parameter_getAllChannels &fields = std::get< Parameter_getAllChannels >(parameter);
+
+	if (name == "connection") {
+		return readInteger(fields.connection, value) ? 0 : -1;
+	}
 
+	return -1;
+}
+
+bool write_getAllChannels(const MumbleAPI &api, const APIParameter &parameter, ResponseWriter &writer) {
+	const Parameter_getAllChannels &fields = std::get< Parameter_getAllChannels >(parameter);
+
+	// Call respective API function with extracted parameter
 	try {
-		MumbleArray< mumble_channelid_t > ret = api.getAllChannels(connection);
-
-		// clang-format off
-		response = {
-			{"response_type", "api_call"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"function", "getAllChannels"},
-					{"status", "executed"},
-					{"return_value", ret}
-				}
-			}
-		};
-		// clang-format on
+		MumbleArray< mumble_channelid_t > ret = api.getAllChannels(fields.connection);
+
+		writer.raw(R"("response_type":"api_call","response":{"function":"getAllChannels","status":"executed","return_value":)");
+		writer.value(ret);
+		writer.raw("}");
+
+		return true;
 	} catch (const MumbleAPIException &e) {
-		// clang-format off
-		response = {
-			{"response_type", "api_error"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"error_code", e.errorCode()},
-					{"error_message", e.what()}
-				}
-			}
-		};
-		// clang-format on
-	}
+		writeAPIError(writer, e);
 
-	return response;
+		return false;
+	}
 }
 
-nlohmann::json handle_getChannelOfUser(const MumbleAPI &api, const std::string &bridgeSecret,
-									   const nlohmann::json &parameter) {
+APIParameter parse_getChannelOfUser(const nlohmann::json &parameter) {
 	// Validate specified parameter
 	if (parameter.size() != 2) {
 		throw InvalidMessageException(std::string("API function \"getChannelOfUser\" expects 2 parameter(s) but got ")
@@ -447,48 +370,49 @@ nlohmann::json handle_getChannelOfUser(const MumbleAPI &api, const std::string &
 	MESSAGE_ASSERT_FIELD(parameter, "user_id", number_unsigned);
 
 	// Convert the parameter from JSON to the corresponding cpp types
-	mumble_connection_t connection = parameter["connection"].get< mumble_connection_t >();
-	mumble_userid_t user_id        = parameter["user_id"].get< mumble_userid_t >();
+	Parameter_getChannelOfUser fields;
+	fields.connection = parameter["connection"].get< mumble_connection_t >();
+	fields.user_id = parameter["user_id"].get< mumble_userid_t >();
 
-	// Call respective API function with extracted parameter
-	nlohmann::json response;
+	return fields;
+}
+
+int read_getChannelOfUser(APIParameter &parameter, std::string_view name, ParameterValue &value) {
+	if (!std::holds_alternative< Parameter_getChannelOfUser >(parameter)) {
+		parameter.emplace< Parameter_getChannelOfUser >();
+	}
+	Parameter_getChannelOfUser &fields = std::get< Parameter_getChannelOfUser >(parameter);
+
+	if (name == "connection") {
+		return readInteger(fields.connection, value) ? 0 : -1;
+	}
+	if (name == "user_id") {
+		return readUnsigned(fields.user_id, value) ? 1 : -1;
+	}
+
+	return -1;
+}
+
+bool write_getChannelOfUser(const MumbleAPI &api, const APIParameter &parameter, ResponseWriter &writer) {
+	const Parameter_getChannelOfUser &fields = std::get< Parameter_getChannelOfUser >(parameter);
 
+	// Call respective API function with extracted parameter
 	try {
-		mumble_channelid_t ret = api.getChannelOfUser(connection, user_id);
-
-		// clang-format off
-		response = {
-			{"response_type", "api_call"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"function", "getChannelOfUser"},
-					{"status", "executed"},
-					{"return_value", ret}
-				}
-			}
-		};
-		// clang-format on
+		mumble_channelid_t ret = api.getChannelOfUser(fields.connection, fields.user_id);
+
+		writer.raw(R"("response_type":"api_call","response":{"function":"getChannelOfUser","status":"executed","return_value":)");
+		writer.value(ret);
+		writer.raw("}");
+
+		return true;
 	} catch (const MumbleAPIException &e) {
-		// clang-format off
-		response = {
-			{"response_type", "api_error"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"error_code", e.errorCode()},
-					{"error_message", e.what()}
-				}
-			}
-		};
-		// clang-format on
-	}
+		writeAPIError(writer, e);
 
-	return response;
+		return false;
+	}
 }
 
-nlohmann::json handle_getUsersInChannel(const MumbleAPI &api, const std::string &bridgeSecret,
-										const nlohmann::json &parameter) {
+APIParameter parse_getUsersInChannel(const nlohmann::json &parameter) {
 	// Validate specified parameter
 	if (parameter.size() != 2) {
 		throw InvalidMessageException(std::string("API function \"getUsersInChannel\" expects 2 parameter(s) but got ")
@@ -498,86 +422,66 @@ nlohmann::json handle_getUsersInChannel(const MumbleAPI &api, const std::string
 	MESSAGE_ASSERT_FIELD(parameter, "channel_id", number_integer);
 
 	// Convert the parameter from JSON to the corresponding cpp types
-	mumble_connection_t connection = parameter["connection"].get< mumble_connection_t >();
-	mumble_channelid_t channel_id  = parameter["channel_id"].get< mumble_channelid_t >();
+	Parameter_getUsersInChannel fields;
+	fields.connection = parameter["connection"].get< mumble_connection_t >();
+	fields.channel_id = parameter["channel_id"].get< mumble_channelid_t >();
 
-	// Call respective API function with extracted parameter
-	nlohmann::json response;
+	return fields;
+}
+
+int read_getUsersInChannel(APIParameter &parameter, std::string_view name, ParameterValue &value) {
+	if (!std::holds_alternative< Parameter_getUsersInChannel >(parameter)) {
+		parameter.emplace< Parameter_getUsersInChannel >();
+	}
+	Parameter_getUsersInChannel &fields = std::get< Parameter_getUsersInChannel >(parameter);
+
+	if (name == "connection") {
+		return readInteger(fields.connection, value) ? 0 : -1;
+	}
+	if (name == "channel_id") {
+		return readInteger(fields.channel_id, value) ? 1 : -1;
+	}
+
+	return -1;
+}
 
+bool write_getUsersInChannel(const MumbleAPI &api, const APIParameter &parameter, ResponseWriter &writer) {
+	const Parameter_getUsersInChannel &fields = std::get< Parameter_getUsersInChannel >(parameter);
+
+	// Call respective API function with extracted parameter
 	try {
-		MumbleArray< mumble_userid_t > ret = api.getUsersInChannel(connection, channel_id);
-
-		// clang-format off
-		response = {
-			{"response_type", "api_call"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"function", "getUsersInChannel"},
-					{"status", "executed"},
-					{"return_value", ret}
-				}
-			}
-		};
-		// clang-format on
+		MumbleArray< mumble_userid_t > ret = api.getUsersInChannel(fields.connection, fields.channel_id);
+
+		writer.raw(R"("response_type":"api_call","response":{"function":"getUsersInChannel","status":"executed","return_value":)");
+		writer.value(ret);
+		writer.raw("}");
+
+		return true;
 	} catch (const MumbleAPIException &e) {
-		// clang-format off
-		response = {
-			{"response_type", "api_error"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"error_code", e.errorCode()},
-					{"error_message", e.what()}
-				}
-			}
-		};
-		// clang-format on
-	}
+		writeAPIError(writer, e);
 
-	return response;
+		return false;
+	}
 }
 
-nlohmann::json handle_getLocalUserTransmissionMode(const MumbleAPI &api, const std::string &bridgeSecret) {
+bool write_getLocalUserTransmissionMode(const MumbleAPI &api, const APIParameter &, ResponseWriter &writer) {
 	// Call respective API function
-	nlohmann::json response;
-
 	try {
 		mumble_transmission_mode_t ret = api.getLocalUserTransmissionMode();
 
-		// clang-format off
-		response = {
-			{"response_type", "api_call"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"function", "getLocalUserTransmissionMode"},
-					{"status", "executed"},
-					{"return_value", ret}
-				}
-			}
-		};
-		// clang-format on
+		writer.raw(R"("response_type":"api_call","response":{"function":"getLocalUserTransmissionMode","status":"executed","return_value":)");
+		writer.value(ret);
+		writer.raw("}");
+
+		return true;
 	} catch (const MumbleAPIException &e) {
-		// clang-format off
-		response = {
-			{"response_type", "api_error"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"error_code", e.errorCode()},
-					{"error_message", e.what()}
-				}
-			}
-		};
-		// clang-format on
-	}
+		writeAPIError(writer, e);
 
-	return response;
+		return false;
+	}
 }
 
-nlohmann::json handle_isUserLocallyMuted(const MumbleAPI &api, const std::string &bridgeSecret,
-										 const nlohmann::json &parameter) {
+APIParameter parse_isUserLocallyMuted(const nlohmann::json &parameter) {
 	// Validate specified parameter
 	if (parameter.size() != 2) {
 		throw InvalidMessageException(std::string("API function \"isUserLocallyMuted\" expects 2 parameter(s) but got ")
@@ -587,124 +491,83 @@ nlohmann::json handle_isUserLocallyMuted(const MumbleAPI &api, const std::string
 	MESSAGE_ASSERT_FIELD(parameter, "user_id", number_unsigned);
 
 	// Convert the parameter from JSON to the corresponding cpp types
-	mumble_connection_t connection = parameter["connection"].get< mumble_connection_t >();
-	mumble_userid_t user_id        = parameter["user_id"].get< mumble_userid_t >();
+	Parameter_isUserLocallyMuted fields;
+	fields.connection = parameter["connection"].get< mumble_connection_t >();
+	fields.user_id = parameter["user_id"].get< mumble_userid_t >();
 
-	// Call respective API function with extracted parameter
-	nlohmann::json response;
+	return fields;
+}
+
+int read_isUserLocallyMuted(APIParameter &parameter, std::string_view name, ParameterValue &value) {
+	if (!std::holds_alternative< Parameter_isUserLocallyMuted >(parameter)) {
+		parameter.emplace< Parameter_isUserLocallyMuted >();
+	}
+	Parameter_isUserLocallyMuted &fields = std::get< Parameter_isUserLocallyMuted >(parameter);
+
+	if (name == "connection") {
+		return readInteger(fields.connection, value) ? 0 : -1;
+	}
+	if (name == "user_id") {
+		return readUnsigned(fields.user_id, value) ? 1 : -1;
+	}
+
+	return -1;
+}
+
+bool write_isUserLocallyMuted(const MumbleAPI &api, const APIParameter &parameter, ResponseWriter &writer) {
+	const Parameter_isUserLocallyMuted &fields = std::get< Parameter_isUserLocallyMuted >(parameter);
 
+	// Call respective API function with extracted parameter
 	try {
-		bool ret = api.isUserLocallyMuted(connection, user_id);
-
-		// clang-format off
-		response = {
-			{"response_type", "api_call"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"function", "isUserLocallyMuted"},
-					{"status", "executed"},
-					{"return_value", ret}
-				}
-			}
-		};
-		// clang-format on
+		bool ret = api.isUserLocallyMuted(fields.connection, fields.user_id);
+
+		writer.raw(R"("response_type":"api_call","response":{"function":"isUserLocallyMuted","status":"executed","return_value":)");
+		writer.value(ret);
+		writer.raw("}");
+
+		return true;
 	} catch (const MumbleAPIException &e) {
-		// clang-format off
-		response = {
-			{"response_type", "api_error"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"error_code", e.errorCode()},
-					{"error_message", e.what()}
-				}
-			}
-		};
-		// clang-format on
-	}
+		writeAPIError(writer, e);
 
-	return response;
+		return false;
+	}
 }
 
-nlohmann::json handle_isLocalUserMuted(const MumbleAPI &api, const std::string &bridgeSecret) {
+bool write_isLocalUserMuted(const MumbleAPI &api, const APIParameter &, ResponseWriter &writer) {
 	// Call respective API function
-	nlohmann::json response;
-
 	try {
 		bool ret = api.isLocalUserMuted();
 
-		// clang-format off
-		response = {
-			{"response_type", "api_call"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"function", "isLocalUserMuted"},
-					{"status", "executed"},
-					{"return_value", ret}
-				}
-			}
-		};
-		// clang-format on
+		writer.raw(R"("response_type":"api_call","response":{"function":"isLocalUserMuted","status":"executed","return_value":)");
+		writer.value(ret);
+		writer.raw("}");
+
+		return true;
 	} catch (const MumbleAPIException &e) {
-		// clang-format off
-		response = {
-			{"response_type", "api_error"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"error_code", e.errorCode()},
-					{"error_message", e.what()}
-				}
-			}
-		};
-		// clang-format on
-	}
+		writeAPIError(writer, e);
 
-	return response;
+		return false;
+	}
 }
 
-nlohmann::json handle_isLocalUserDeafened(const MumbleAPI &api, const std::string &bridgeSecret) {
+bool write_isLocalUserDeafened(const MumbleAPI &api, const APIParameter &, ResponseWriter &writer) {
 	// Call respective API function
-	nlohmann::json response;
-
 	try {
 		bool ret = api.isLocalUserDeafened();
 
-		// clang-format off
-		response = {
-			{"response_type", "api_call"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"function", "isLocalUserDeafened"},
-					{"status", "executed"},
-					{"return_value", ret}
-				}
-			}
-		};
-		// clang-format on
+		writer.raw(R"("response_type":"api_call","response":{"function":"isLocalUserDeafened","status":"executed","return_value":)");
+		writer.value(ret);
+		writer.raw("}");
+
+		return true;
 	} catch (const MumbleAPIException &e) {
-		// clang-format off
-		response = {
-			{"response_type", "api_error"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"error_code", e.errorCode()},
-					{"error_message", e.what()}
-				}
-			}
-		};
-		// clang-format on
-	}
+		writeAPIError(writer, e);
 
-	return response;
+		return false;
+	}
 }
 
-nlohmann::json handle_getUserHash(const MumbleAPI &api, const std::string &bridgeSecret,
-								  const nlohmann::json &parameter) {
+APIParameter parse_getUserHash(const nlohmann::json &parameter) {
 	// Validate specified parameter
 	if (parameter.size() != 2) {
 		throw InvalidMessageException(std::string("API function \"getUserHash\" expects 2 parameter(s) but got ")
@@ -714,48 +577,49 @@ nlohmann::json handle_getUserHash(const MumbleAPI &api, const std::string &bridg
 	MESSAGE_ASSERT_FIELD(parameter, "user_id", number_unsigned);
 
 	// Convert the parameter from JSON to the corresponding cpp types
-	mumble_connection_t connection = parameter["connection"].get< mumble_connection_t >();
-	mumble_userid_t user_id        = parameter["user_id"].get< mumble_userid_t >();
+	Parameter_getUserHash fields;
+	fields.connection = parameter["connection"].get< mumble_connection_t >();
+	fields.user_id = parameter["user_id"].get< mumble_userid_t >();
 
-	// Call respective API function with extracted parameter
-	nlohmann::json response;
+	return fields;
+}
+
+int read_getUserHash(APIParameter &parameter, std::string_view name, ParameterValue &value) {
+	if (!std::holds_alternative< Parameter_getUserHash >(parameter)) {
+		parameter.emplace< Parameter_getUserHash >();
+	}
+	Parameter_getUserHash &fields = std::get< Parameter_getUserHash >(parameter);
+
+	if (name == "connection") {
+		return readInteger(fields.connection, value) ? 0 : -1;
+	}
+	if (name == "user_id") {
+		return readUnsigned(fields.user_id, value) ? 1 : -1;
+	}
 
+	return -1;
+}
+
+bool write_getUserHash(const MumbleAPI &api, const APIParameter &parameter, ResponseWriter &writer) {
+	const Parameter_getUserHash &fields = std::get< Parameter_getUserHash >(parameter);
+
+	// Call respective API function with extracted parameter
 	try {
-		MumbleString ret = api.getUserHash(connection, user_id);
-
-		// clang-format off
-		response = {
-			{"response_type", "api_call"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"function", "getUserHash"},
-					{"status", "executed"},
-					{"return_value", ret}
-				}
-			}
-		};
-		// clang-format on
+		MumbleString ret = api.getUserHash(fields.connection, fields.user_id);
+
+		writer.raw(R"("response_type":"api_call","response":{"function":"getUserHash","status":"executed","return_value":)");
+		writer.value(ret);
+		writer.raw("}");
+
+		return true;
 	} catch (const MumbleAPIException &e) {
-		// clang-format off
-		response = {
-			{"response_type", "api_error"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"error_code", e.errorCode()},
-					{"error_message", e.what()}
-				}
-			}
-		};
-		// clang-format on
-	}
+		writeAPIError(writer, e);
 
-	return response;
+		return false;
+	}
 }
 
-nlohmann::json handle_getServerHash(const MumbleAPI &api, const std::string &bridgeSecret,
-									const nlohmann::json &parameter) {
+APIParameter parse_getServerHash(const nlohmann::json &parameter) {
 	// Validate specified parameter
 	if (parameter.size() != 1) {
 		throw InvalidMessageException(std::string("API function \"getServerHash\" expects 1 parameter(s) but got ")
@@ -764,47 +628,45 @@ nlohmann::json handle_getServerHash(const MumbleAPI &api, const std::string &bri
 	MESSAGE_ASSERT_FIELD(parameter, "connection", number_integer);
 
 	// Convert the parameter from JSON to the corresponding cpp types
-	mumble_connection_t connection = parameter["connection"].get< mumble_connection_t >();
+	Parameter_getServerHash fields;
+	fields.connection = parameter["connection"].get< mumble_connection_t >();
 
-	// Call respective API function with extracted parameter
-	nlohmann::json response;
+	return fields;
+}
+
+int read_getServerHash(APIParameter &parameter, std::string_view name, ParameterValue &value) {
+	if (!std::holds_alternative< Parameter_getServerHash >(parameter)) {
+		parameter.emplace< Parameter_getServerHash >();
+	}
+	Parameter_getServerHash &fields = std::get< Parameter_getServerHash >(parameter);
+
+	if (name == "connection") {
+		return readInteger(fields.connection, value) ? 0 : -1;
+	}
+
+	return -1;
+}
 
+bool write_getServerHash(const MumbleAPI &api, const APIParameter &parameter, ResponseWriter &writer) {
+	const Parameter_getServerHash &fields = std::get< Parameter_getServerHash >(parameter);
+
+	// Call respective API function with extracted parameter
 	try {
-		MumbleString ret = api.getServerHash(connection);
-
-		// clang-format off
-		response = {
-			{"response_type", "api_call"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"function", "getServerHash"},
-					{"status", "executed"},
-					{"return_value", ret}
-				}
-			}
-		};
-		// clang-format on
+		MumbleString ret = api.getServerHash(fields.connection);
+
+		writer.raw(R"("response_type":"api_call","response":{"function":"getServerHash","status":"executed","return_value":)");
+		writer.value(ret);
+		writer.raw("}");
+
+		return true;
 	} catch (const MumbleAPIException &e) {
-		// clang-format off
-		response = {
-			{"response_type", "api_error"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"error_code", e.errorCode()},
-					{"error_message", e.what()}
-				}
-			}
-		};
-		// clang-format on
-	}
+		writeAPIError(writer, e);
 
-	return response;
+		return false;
+	}
 }
 
-nlohmann::json handle_getUserComment(const MumbleAPI &api, const std::string &bridgeSecret,
-									 const nlohmann::json &parameter) {
+APIParameter parse_getUserComment(const nlohmann::json &parameter) {
 	// Validate specified parameter
 	if (parameter.size() != 2) {
 		throw InvalidMessageException(std::string("API function \"getUserComment\" expects 2 parameter(s) but got ")
@@ -814,48 +676,49 @@ nlohmann::json handle_getUserComment(const MumbleAPI &api, const std::string &br
 	MESSAGE_ASSERT_FIELD(parameter, "user_id", number_unsigned);
 
 	// Convert the parameter from JSON to the corresponding cpp types
-	mumble_connection_t connection = parameter["connection"].get< mumble_connection_t >();
-	mumble_userid_t user_id        = parameter["user_id"].get< mumble_userid_t >();
+	Parameter_getUserComment fields;
+	fields.connection = parameter["connection"].get< mumble_connection_t >();
+	fields.user_id = parameter["user_id"].get< mumble_userid_t >();
 
-	// Call respective API function with extracted parameter
-	nlohmann::json response;
+	return fields;
+}
 
+int read_getUserComment(APIParameter &parameter, std::string_view name, ParameterValue &value) {
+	if (!std::holds_alternative< Parameter_getUserComment >(parameter)) {
+		parameter.emplace< Parameter_getUserComment >();
+	}
+	Parameter_getUserComment &fields = std::get< Parameter_getUserComment >(parameter);
+
+	if (name == "connection") {
+		return readInteger(fields.connection, value) ? 0 : -1;
+	}
+	if (name == "user_id") {
+		return readUnsigned(fields.user_id, value) ? 1 : -1;
+	}
+
+	return -1;
+}
+
+bool write_getUserComment(const MumbleAPI &api, const APIParameter &parameter, ResponseWriter &writer) {
+	const Parameter_getUserComment &fields = std::get< Parameter_getUserComment >(parameter);
+
+	// Call respective API function with extracted parameter
 	try {
-		MumbleString ret = api.getUserComment(connection, user_id);
-
-		// clang-format off
-		response = {
-			{"response_type", "api_call"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"function", "getUserComment"},
-					{"status", "executed"},
-					{"return_value", ret}
-				}
-			}
-		};
-		// clang-format on
+		MumbleString ret = api.getUserComment(fields.connection, fields.user_id);
+
+		writer.raw(R"("response_type":"api_call","response":{"function":"getUserComment","status":"executed","return_value":)");
+		writer.value(ret);
+		writer.raw("}");
+
+		return true;
 	} catch (const MumbleAPIException &e) {
-		// clang-format off
-		response = {
-			{"response_type", "api_error"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"error_code", e.errorCode()},
-					{"error_message", e.what()}
-				}
-			}
-		};
-		// clang-format on
-	}
+		writeAPIError(writer, e);
 
-	return response;
+		return false;
+	}
 }
 
-nlohmann::json handle_getChannelDescription(const MumbleAPI &api, const std::string &bridgeSecret,
-											const nlohmann::json &parameter) {
+APIParameter parse_getChannelDescription(const nlohmann::json &parameter) {
 	// Validate specified parameter
 	if (parameter.size() != 2) {
 		throw InvalidMessageException(
@@ -866,48 +729,49 @@ nlohmann::json handle_getChannelDescription(const MumbleAPI &api, const std::str
 	MESSAGE_ASSERT_FIELD(parameter, "channel_id", number_integer);
 
 	// Convert the parameter from JSON to the corresponding cpp types
-	mumble_connection_t connection = parameter["connection"].get< mumble_connection_t >();
-	mumble_channelid_t channel_id  = parameter["channel_id"].get< mumble_channelid_t >();
+	Parameter_getChannelDescription fields;
+	fields.connection = parameter["connection"].get< mumble_connection_t >();
+	fields.channel_id = parameter["channel_id"].get< mumble_channelid_t >();
 
-	// Call respective API function with extracted parameter
-	nlohmann::json response;
+	return fields;
+}
+
+int read_getChannelDescription(APIParameter &parameter, std::string_view name, ParameterValue &value) {
+	if (!std::holds_alternative< Parameter_getChannelDescription >(parameter)) {
+		parameter.emplace< Parameter_getChannelDescription >();
+	}
+	Parameter_getChannelDescription &fields = std::get< Parameter_getChannelDescription >(parameter);
+
+	if (name == "connection") {
+		return readInteger(fields.connection, value) ? 0 : -1;
+	}
+	if (name == "channel_id") {
+		return readInteger(fields.channel_id, value) ? 1 : -1;
+	}
 
+	return -1;
+}
+
+bool write_getChannelDescription(const MumbleAPI &api, const APIParameter &parameter, ResponseWriter &writer) {
+	const Parameter_getChannelDescription &fields = std::get< Parameter_getChannelDescription >(parameter);
+
+	// Call respective API function with extracted parameter
 	try {
-		MumbleString ret = api.getChannelDescription(connection, channel_id);
-
-		// clang-format off
-		response = {
-			{"response_type", "api_call"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"function", "getChannelDescription"},
-					{"status", "executed"},
-					{"return_value", ret}
-				}
-			}
-		};
-		// clang-format on
+		MumbleString ret = api.getChannelDescription(fields.connection, fields.channel_id);
+
+		writer.raw(R"("response_type":"api_call","response":{"function":"getChannelDescription","status":"executed","return_value":)");
+		writer.value(ret);
+		writer.raw("}");
+
+		return true;
 	} catch (const MumbleAPIException &e) {
-		// clang-format off
-		response = {
-			{"response_type", "api_error"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"error_code", e.errorCode()},
-					{"error_message", e.what()}
-				}
-			}
-		};
-		// clang-format on
-	}
+		writeAPIError(writer, e);
 
-	return response;
+		return false;
+	}
 }
 
-nlohmann::json handle_requestLocalUserTransmissionMode(const MumbleAPI &api, const std::string &bridgeSecret,
-													   const nlohmann::json &parameter) {
+APIParameter parse_requestLocalUserTransmissionMode(const nlohmann::json &parameter) {
 	// Validate specified parameter
 	if (parameter.size() != 1) {
 		throw InvalidMessageException(
@@ -917,32 +781,42 @@ nlohmann::json handle_requestLocalUserTransmissionMode(const MumbleAPI &api, con
 	MESSAGE_ASSERT_FIELD(parameter, "transmission_mode", string);
 
 	// Convert the parameter from JSON to the corresponding cpp types
-	mumble_transmission_mode_t transmission_mode = parameter["transmission_mode"].get< mumble_transmission_mode_t >();
+	Parameter_requestLocalUserTransmissionMode fields;
+	fields.transmission_mode = parameter["transmission_mode"].get< mumble_transmission_mode_t >();
 
-	// Call respective API function with extracted parameter
-	nlohmann::json response;
+	return fields;
+}
+
+int read_requestLocalUserTransmissionMode(APIParameter &parameter, std::string_view name, ParameterValue &value) {
+	if (!std::holds_alternative< Parameter_requestLocalUserTransmissionMode >(parameter)) {
+		parameter.emplace< Parameter_requestLocalUserTransmissionMode >();
+	}
+	Parameter_requestLocalUserTransmissionMode &fields =
+		std::get< Parameter_requestLocalUserTransmissionMode >(parameter);
 
-	mumble_error_t ret = api.requestLocalUserTransmissionMode(transmission_mode);
+	if (name == "transmission_mode") {
+		return readString(fields.transmission_mode, value) ? 0 : -1;
+	}
+
+	return -1;
+}
+
+bool write_requestLocalUserTransmissionMode(const MumbleAPI &api, const APIParameter &parameter,
+											ResponseWriter &writer) {
+	const Parameter_requestLocalUserTransmissionMode &fields =
+		std::get< Parameter_requestLocalUserTransmissionMode >(parameter);
 
-	// clang-format off
-	response = {
-		{"response_type", "api_call"},
-		{"secret", bridgeSecret},
-		{"response",
-			{
-				{"function", "requestLocalUserTransmissionMode"},
-				{"status", "executed"},
-				{"return_value", ret}
-			}
-		}
-	};
-	// clang-format on
+	// Call respective API function with extracted parameter
+	mumble_error_t ret = api.requestLocalUserTransmissionMode(fields.transmission_mode);
+
+	writer.raw(R"("response_type":"api_call","response":{"function":"requestLocalUserTransmissionMode","status":"executed","return_value":)");
+	writer.value(ret);
+	writer.raw("}");
 
-	return response;
+	return true;
 }
 
-nlohmann::json handle_requestUserMove(const MumbleAPI &api, const std::string &bridgeSecret,
-									  const nlohmann::json &parameter) {
+APIParameter parse_requestUserMove(const nlohmann::json &parameter) {
 	// Validate specified parameter
 	if (parameter.size() != 4) {
 		throw InvalidMessageException(std::string("API function \"requestUserMove\" expects 4 parameter(s) but got ")
@@ -954,35 +828,52 @@ nlohmann::json handle_requestUserMove(const MumbleAPI &api, const std::string &b
 	MESSAGE_ASSERT_FIELD(parameter, "password", string);
 
 	// Convert the parameter from JSON to the corresponding cpp types
-	mumble_connection_t connection = parameter["connection"].get< mumble_connection_t >();
-	mumble_userid_t user_id        = parameter["user_id"].get< mumble_userid_t >();
-	mumble_channelid_t channel_id  = parameter["channel_id"].get< mumble_channelid_t >();
-	std::string password           = parameter["password"].get< std::string >();
+	Parameter_requestUserMove fields;
+	fields.connection = parameter["connection"].get< mumble_connection_t >();
+	fields.user_id = parameter["user_id"].get< mumble_userid_t >();
+	fields.channel_id = parameter["channel_id"].get< mumble_channelid_t >();
+	fields.password = parameter["password"].get< std::string >();
 
-	// Call respective API function with extracted parameter
-	nlohmann::json response;
+	return fields;
+}
+
+int read_requestUserMove(APIParameter &parameter, std::string_view name, ParameterValue &value) {
+	if (!std::holds_alternative< Parameter_requestUserMove >(parameter)) {
+		parameter.emplace< Parameter_requestUserMove >();
+	}
+	Parameter_requestUserMove &fields = std::get< Parameter_requestUserMove >(parameter);
+
+	if (name == "connection") {
+		return readInteger(fields.connection, value) ? 0 : -1;
+	}
+	if (name == "user_id") {
+		return readUnsigned(fields.user_id, value) ? 1 : -1;
+	}
+	if (name == "channel_id") {
+		return readInteger(fields.channel_id, value) ? 2 : -1;
+	}
+	if (name == "password") {
+		return readString(fields.password, value) ? 3 : -1;
+	}
+
+	return -1;
+}
+
+bool write_requestUserMove(const MumbleAPI &api, const APIParameter &parameter, ResponseWriter &writer) {
+	const Parameter_requestUserMove &fields = std::get< Parameter_requestUserMove >(parameter);
 
-	mumble_error_t ret = api.requestUserMove(connection, user_id, channel_id, password.c_str());
+	// Call respective API function with extracted parameter
+	mumble_error_t ret = api.requestUserMove(fields.connection, fields.user_id, fields.channel_id,
+											 fields.password.c_str());
 
-	// clang-format off
-	response = {
-		{"response_type", "api_call"},
-		{"secret", bridgeSecret},
-		{"response",
-			{
-				{"function", "requestUserMove"},
-				{"status", "executed"},
-				{"return_value", ret}
-			}
-		}
-	};
-	// clang-format on
+	writer.raw(R"("response_type":"api_call","response":{"function":"requestUserMove","status":"executed","return_value":)");
+	writer.value(ret);
+	writer.raw("}");
 
-	return response;
+	return true;
 }
 
-nlohmann::json handle_requestMicrophoneActivationOvewrite(const MumbleAPI &api, const std::string &bridgeSecret,
-														  const nlohmann::json &parameter) {
+APIParameter parse_requestMicrophoneActivationOvewrite(const nlohmann::json &parameter) {
 	// Validate specified parameter
 	if (parameter.size() != 1) {
 		throw InvalidMessageException(
@@ -992,32 +883,42 @@ nlohmann::json handle_requestMicrophoneActivationOvewrite(const MumbleAPI &api,
 	MESSAGE_ASSERT_FIELD(parameter, "activate", boolean);
 
 	// Convert the parameter from JSON to the corresponding cpp types
-	bool activate = parameter["activate"].get< bool >();
+	Parameter_requestMicrophoneActivationOvewrite fields;
+	fields.activate = parameter["activate"].get< bool >();
 
-	// Call respective API function with extracted parameter
-	nlohmann::json response;
+	return fields;
+}
+
+int read_requestMicrophoneActivationOvewrite(APIParameter &parameter, std::string_view name, ParameterValue &value) {
+	if (!std::holds_alternative< Parameter_requestMicrophoneActivationOvewrite >(parameter)) {
+		parameter.emplace< Parameter_requestMicrophoneActivationOvewrite >();
+	}
+	Parameter_requestMicrophoneActivationOvewrite &fields =
+		std::get< Parameter_requestMicrophoneActivationOvewrite >(parameter);
+
+	if (name == "activate") {
+		return readBoolean(fields.activate, value) ? 0 : -1;
+	}
+
+	return -1;
+}
+
+bool write_requestMicrophoneActivationOvewrite(const MumbleAPI &api, const APIParameter &parameter,
+											   ResponseWriter &writer) {
+	const Parameter_requestMicrophoneActivationOvewrite &fields =
+		std::get< Parameter_requestMicrophoneActivationOvewrite >(parameter);
 
-	mumble_error_t ret = api.requestMicrophoneActivationOvewrite(activate);
+	// Call respective API function with extracted parameter
+	mumble_error_t ret = api.requestMicrophoneActivationOvewrite(fields.activate);
 
-	// clang-format off
-	response = {
-		{"response_type", "api_call"},
-		{"secret", bridgeSecret},
-		{"response",
-			{
-				{"function", "requestMicrophoneActivationOvewrite"},
-				{"status", "executed"},
-				{"return_value", ret}
-			}
-		}
-	};
-	// clang-format on
+	writer.raw(R"("response_type":"api_call","response":{"function":"requestMicrophoneActivationOvewrite","status":"executed","return_value":)");
+	writer.value(ret);
+	writer.raw("}");
 
-	return response;
+	return true;
 }
 
-nlohmann::json handle_requestLocalMute(const MumbleAPI &api, const std::string &bridgeSecret,
-									   const nlohmann::json &parameter) {
+APIParameter parse_requestLocalMute(const nlohmann::json &parameter) {
 	// Validate specified parameter
 	if (parameter.size() != 3) {
 		throw InvalidMessageException(std::string("API function \"requestLocalMute\" expects 3 parameter(s) but got ")
@@ -1028,34 +929,47 @@ nlohmann::json handle_requestLocalMute(const MumbleAPI &api, const std::string &
 	MESSAGE_ASSERT_FIELD(parameter, "muted", boolean);
 
 	// Convert the parameter from JSON to the corresponding cpp types
-	mumble_connection_t connection = parameter["connection"].get< mumble_connection_t >();
-	mumble_userid_t user_id        = parameter["user_id"].get< mumble_userid_t >();
-	bool muted                     = parameter["muted"].get< bool >();
+	Parameter_requestLocalMute fields;
+	fields.connection = parameter["connection"].get< mumble_connection_t >();
+	fields.user_id = parameter["user_id"].get< mumble_userid_t >();
+	fields.muted = parameter["muted"].get< bool >();
 
-	// Call respective API function with extracted parameter
-	nlohmann::json response;
+	return fields;
+}
 
-	mumble_error_t ret = api.requestLocalMute(connection, user_id, muted);
+int read_requestLocalMute(APIParameter &parameter, std::string_view name, ParameterValue &value) {
+	if (!std::holds_alternative< Parameter_requestLocalMute >(parameter)) {
+		parameter.emplace< Parameter_requestLocalMute >();
+	}
+	Parameter_requestLocalMute &fields = std::get< Parameter_requestLocalMute >(parameter);
 
-	// clang-format off
-	response = {
-		{"response_type", "api_call"},
-		{"secret", bridgeSecret},
-		{"response",
-			{
-				{"function", "requestLocalMute"},
-				{"status", "executed"},
-				{"return_value", ret}
-			}
-		}
-	};
-	// clang-format on
+	if (name == "connection") {
+		return readInteger(fields.connection, value) ? 0 : -1;
+	}
+	if (name == "user_id") {
+		return readUnsigned(fields.user_id, value) ? 1 : -1;
+	}
+	if (name == "muted") {
+		return readBoolean(fields.muted, value) ? 2 : -1;
+	}
 
-	return response;
+	return -1;
 }
 
-nlohmann::json handle_requestLocalUserMute(const MumbleAPI &api, const std::string &bridgeSecret,
-										   const nlohmann::json &parameter) {
+bool write_requestLocalMute(const MumbleAPI &api, const APIParameter &parameter, ResponseWriter &writer) {
+	const Parameter_requestLocalMute &fields = std::get< Parameter_requestLocalMute >(parameter);
+
+	// Call respective API function with extracted parameter
+	mumble_error_t ret = api.requestLocalMute(fields.connection, fields.user_id, fields.muted);
+
+	writer.raw(R"("response_type":"api_call","response":{"function":"requestLocalMute","status":"executed","return_value":)");
+	writer.value(ret);
+	writer.raw("}");
+
+	return true;
+}
+
+APIParameter parse_requestLocalUserMute(const nlohmann::json &parameter) {
 	// Validate specified parameter
 	if (parameter.size() != 1) {
 		throw InvalidMessageException(
@@ -1065,32 +979,39 @@ nlohmann::json handle_requestLocalUserMute(const MumbleAPI &api, const std::stri
 	MESSAGE_ASSERT_FIELD(parameter, "muted", boolean);
 
 	// Convert the parameter from JSON to the corresponding cpp types
-	bool muted = parameter["muted"].get< bool >();
+	Parameter_requestLocalUserMute fields;
+	fields.muted = parameter["muted"].get< bool >();
 
-	// Call respective API function with extracted parameter
-	nlohmann::json response;
+	return fields;
+}
 
-	mumble_error_t ret = api.requestLocalUserMute(muted);
+int read_requestLocalUserMute(APIParameter &parameter, std::string_view name, ParameterValue &value) {
+	if (!std::holds_alternative< Parameter_requestLocalUserMute >(parameter)) {
+		parameter.emplace< Parameter_requestLocalUserMute >();
+	}
+	Parameter_requestLocalUserMute &fields = std::get< Parameter_requestLocalUserMute >(parameter);
 
-	// clang-format off
-	response = {
-		{"response_type", "api_call"},
-		{"secret", bridgeSecret},
-		{"response",
-			{
-				{"function", "requestLocalUserMute"},
-				{"status", "executed"},
-				{"return_value", ret}
-			}
-		}
-	};
-	// clang-format on
+	if (name == "muted") {
+		return readBoolean(fields.muted, value) ? 0 : -1;
+	}
 
-	return response;
+	return -1;
 }
 
-nlohmann::json handle_requestLocalUserDeaf(const MumbleAPI &api, const std::string &bridgeSecret,
-										   const nlohmann::json &parameter) {
+bool write_requestLocalUserMute(const MumbleAPI &api, const APIParameter &parameter, ResponseWriter &writer) {
+	const Parameter_requestLocalUserMute &fields = std::get< Parameter_requestLocalUserMute >(parameter);
+
+	// Call respective API function with extracted parameter
+	mumble_error_t ret = api.requestLocalUserMute(fields.muted);
+
+	writer.raw(R"("response_type":"api_call","response":{"function":"requestLocalUserMute","status":"executed","return_value":)");
+	writer.value(ret);
+	writer.raw("}");
+
+	return true;
+}
+
+APIParameter parse_requestLocalUserDeaf(const nlohmann::json &parameter) {
 	// Validate specified parameter
 	if (parameter.size() != 1) {
 		throw InvalidMessageException(
@@ -1100,32 +1021,39 @@ nlohmann::json handle_requestLocalUserDeaf(const MumbleAPI &api, const std::stri
 	MESSAGE_ASSERT_FIELD(parameter, "deafened", boolean);
 
 	// Convert the parameter from JSON to the corresponding cpp types
-	bool deafened = parameter["deafened"].get< bool >();
+	Parameter_requestLocalUserDeaf fields;
+	fields.deafened = parameter["deafened"].get< bool >();
 
-	// Call respective API function with extracted parameter
-	nlohmann::json response;
+	return fields;
+}
+
+int read_requestLocalUserDeaf(APIParameter &parameter, std::string_view name, ParameterValue &value) {
+	if (!std::holds_alternative< Parameter_requestLocalUserDeaf >(parameter)) {
+		parameter.emplace< Parameter_requestLocalUserDeaf >();
+	}
+	Parameter_requestLocalUserDeaf &fields = std::get< Parameter_requestLocalUserDeaf >(parameter);
+
+	if (name == "deafened") {
+		return readBoolean(fields.deafened, value) ? 0 : -1;
+	}
 
-	mumble_error_t ret = api.requestLocalUserDeaf(deafened);
+	return -1;
+}
+
+bool write_requestLocalUserDeaf(const MumbleAPI &api, const APIParameter &parameter, ResponseWriter &writer) {
+	const Parameter_requestLocalUserDeaf &fields = std::get< Parameter_requestLocalUserDeaf >(parameter);
 
-	// clang-format off
-	response = {
-		{"response_type", "api_call"},
-		{"secret", bridgeSecret},
-		{"response",
-			{
-				{"function", "requestLocalUserDeaf"},
-				{"status", "executed"},
-				{"return_value", ret}
-			}
-		}
-	};
-	// clang-format on
+	// Call respective API function with extracted parameter
+	mumble_error_t ret = api.requestLocalUserDeaf(fields.deafened);
 
-	return response;
+	writer.raw(R"("response_type":"api_call","response":{"function":"requestLocalUserDeaf","status":"executed","return_value":)");
+	writer.value(ret);
+	writer.raw("}");
+
+	return true;
 }
 
-nlohmann::json handle_requestSetLocalUserComment(const MumbleAPI &api, const std::string &bridgeSecret,
-												 const nlohmann::json &parameter) {
+APIParameter parse_requestSetLocalUserComment(const nlohmann::json &parameter) {
 	// Validate specified parameter
 	if (parameter.size() != 2) {
 		throw InvalidMessageException(
@@ -1136,33 +1064,43 @@ nlohmann::json handle_requestSetLocalUserComment(const MumbleAPI &api, const std
 	MESSAGE_ASSERT_FIELD(parameter, "comment", string);
 
 	// Convert the parameter from JSON to the corresponding cpp types
-	mumble_connection_t connection = parameter["connection"].get< mumble_connection_t >();
-	std::string comment            = parameter["comment"].get< std::string >();
+	Parameter_requestSetLocalUserComment fields;
+	fields.connection = parameter["connection"].get< mumble_connection_t >();
+	fields.comment = parameter["comment"].get< std::string >();
 
-	// Call respective API function with extracted parameter
-	nlohmann::json response;
+	return fields;
+}
+
+int read_requestSetLocalUserComment(APIParameter &parameter, std::string_view name, ParameterValue &value) {
+	if (!std::holds_alternative< Parameter_requestSetLocalUserComment >(parameter)) {
+		parameter.emplace< Parameter_requestSetLocalUserComment >();
+	}
+	Parameter_requestSetLocalUserComment &fields = std::get< Parameter_requestSetLocalUserComment >(parameter);
 
-	mumble_error_t ret = api.requestSetLocalUserComment(connection, comment.c_str());
+	if (name == "connection") {
+		return readInteger(fields.connection, value) ? 0 : -1;
+	}
+	if (name == "comment") {
+		return readString(fields.comment, value) ? 1 : -1;
+	}
+
+	return -1;
+}
+
+bool write_requestSetLocalUserComment(const MumbleAPI &api, const APIParameter &parameter, ResponseWriter &writer) {
+	const Parameter_requestSetLocalUserComment &fields = std::get< Parameter_requestSetLocalUserComment >(parameter);
 
-	// clang-format off
-	response = {
-		{"response_type", "api_call"},
-		{"secret", bridgeSecret},
-		{"response",
-			{
-				{"function", "requestSetLocalUserComment"},
-				{"status", "executed"},
-				{"return_value", ret}
-			}
-		}
-	};
-	// clang-format on
+	// Call respective API function with extracted parameter
+	mumble_error_t ret = api.requestSetLocalUserComment(fields.connection, fields.comment.c_str());
 
-	return response;
+	writer.raw(R"("response_type":"api_call","response":{"function":"requestSetLocalUserComment","status":"executed","return_value":)");
+	writer.value(ret);
+	writer.raw("}");
+
+	return true;
 }
 
-nlohmann::json handle_findUserByName(const MumbleAPI &api, const std::string &bridgeSecret,
-									 const nlohmann::json &parameter) {
+APIParameter parse_findUserByName(const nlohmann::json &parameter) {
 	// Validate specified parameter
 	if (parameter.size() != 2) {
 		throw InvalidMessageException(std::string("API function \"findUserByName\" expects 2 parameter(s) but got ")
@@ -1172,48 +1110,49 @@ nlohmann::json handle_findUserByName(const MumbleAPI &api, const std::string &br
 	MESSAGE_ASSERT_FIELD(parameter, "user_name", string);
 
 	// Convert the parameter from JSON to the corresponding cpp types
-	mumble_connection_t connection = parameter["connection"].get< mumble_connection_t >();
-	std::string user_name          = parameter["user_name"].get< std::string >();
+	Parameter_findUserByName fields;
+	fields.connection = parameter["connection"].get< mumble_connection_t >();
+	fields.user_name = parameter["user_name"].get< std::string >();
 
-	// Call respective API function with extracted parameter
-	nlohmann::json response;
+	return fields;
+}
+
+int read_findUserByName(APIParameter &parameter, std::string_view name, ParameterValue &value) {
+	if (!std::holds_alternative< Parameter_findUserByName >(parameter)) {
+		parameter.emplace< Parameter_findUserByName >();
+	}
+	Parameter_findUserByName &fields = std::get< Parameter_findUserByName >(parameter);
 
+	if (name == "connection") {
+		return readInteger(fields.connection, value) ? 0 : -1;
+	}
+	if (name == "user_name") {
+		return readString(fields.user_name, value) ? 1 : -1;
+	}
+
+	return -1;
+}
+
+bool write_findUserByName(const MumbleAPI &api, const APIParameter &parameter, ResponseWriter &writer) {
+	const Parameter_findUserByName &fields = std::get< Parameter_findUserByName >(parameter);
+
+	// Call respective API function with extracted parameter
 	try {
-		mumble_userid_t ret = api.findUserByName(connection, user_name.c_str());
-
-		// clang-format off
-		response = {
-			{"response_type", "api_call"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"function", "findUserByName"},
-					{"status", "executed"},
-					{"return_value", ret}
-				}
-			}
-		};
-		// clang-format on
+		mumble_userid_t ret = api.findUserByName(fields.connection, fields.user_name.c_str());
+
+		writer.raw(R"("response_type":"api_call","response":{"function":"findUserByName","status":"executed","return_value":)");
+		writer.value(ret);
+		writer.raw("}");
+
+		return true;
 	} catch (const MumbleAPIException &e) {
-		// clang-format off
-		response = {
-			{"response_type", "api_error"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"error_code", e.errorCode()},
-					{"error_message", e.what()}
-				}
-			}
-		};
-		// clang-format on
-	}
+		writeAPIError(writer, e);
 
-	return response;
+		return false;
+	}
 }
 
-nlohmann::json handle_findUserByName_noexcept(const MumbleAPI &api, const std::string &bridgeSecret,
-											  const nlohmann::json &parameter) {
+APIParameter parse_findUserByName_noexcept(const nlohmann::json &parameter) {
 	// Validate specified parameter
 	if (parameter.size() != 2) {
 		throw InvalidMessageException(
@@ -1224,47 +1163,49 @@ nlohmann::json handle_findUserByName_noexcept(const MumbleAPI &api, const std::s
 	MESSAGE_ASSERT_FIELD(parameter, "user_name", string);
 
 	// Convert the parameter from JSON to the corresponding cpp types
-	mumble_connection_t connection = parameter["connection"].get< mumble_connection_t >();
-	std::string user_name          = parameter["user_name"].get< std::string >();
+	Parameter_findUserByName_noexcept fields;
+	fields.connection = parameter["connection"].get< mumble_connection_t >();
+	fields.user_name = parameter["user_name"].get< std::string >();
+
+	return fields;
+}
+
+int read_findUserByName_noexcept(APIParameter &parameter, std::string_view name, ParameterValue &value) {
+	if (!std::holds_alternative< Parameter_findUserByName_noexcept >(parameter)) {
+		parameter.emplace< Parameter_findUserByName_noexcept >();
+	}
+	Parameter_findUserByName_noexcept &fields = std::get< Parameter_findUserByName_noexcept >(parameter);
+
+	if (name == "connection") {
+		return readInteger(fields.connection, value) ? 0 : -1;
+	}
+	if (name == "user_name") {
+		return readString(fields.user_name, value) ? 1 : -1;
+	}
+
+	return -1;
+}
+
+bool write_findUserByName_noexcept(const MumbleAPI &api, const APIParameter &parameter, ResponseWriter &writer) {
+	const Parameter_findUserByName_noexcept &fields = std::get< Parameter_findUserByName_noexcept >(parameter);
 
 	// Call respective API function with extracted parameter
-	nlohmann::json response;
+	std::optional< mumble_userid_t > ret = api.findUserByName_noexcept(fields.connection, fields.user_name.c_str());
 
-	try {
-		std::optional< mumble_userid_t > ret = api.findUserByName_noexcept(connection, user_name.c_str());
-
-		// clang-format off
-		response = {
-			{"response_type", "api_call"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"function", "findUserByName_noexcept"},
-					{"status", "executed"},
-					{"return_value", ret.value()}
-				}
-			}
-		};
-		// clang-format on
-	} catch (const std::bad_optional_access &) {
-		// clang-format off
-		response = {
-			{"response_type", "api_error_optional"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"error_message", "Optional value not present"},
-				}
-			}
-		};
-		// clang-format on
-	}
-
-	return response;
-}
-
-nlohmann::json handle_findChannelByName(const MumbleAPI &api, const std::string &bridgeSecret,
-										const nlohmann::json &parameter) {
+	if (!ret) {
+		writer.raw(R"("response_type":"api_error_optional","response":{"error_message":"Optional value not present"})");
+
+		return false;
+	}
+
+	writer.raw(R"("response_type":"api_call","response":{"function":"findUserByName_noexcept","status":"executed","return_value":)");
+	writer.value(*ret);
+	writer.raw("}");
+
+	return true;
+}
+
+APIParameter parse_findChannelByName(const nlohmann::json &parameter) {
 	// Validate specified parameter
 	if (parameter.size() != 2) {
 		throw InvalidMessageException(std::string("API function \"findChannelByName\" expects 2 parameter(s) but got ")
@@ -1274,48 +1215,49 @@ nlohmann::json handle_findChannelByName(const MumbleAPI &api, const std::string
 	MESSAGE_ASSERT_FIELD(parameter, "channel_name", string);
 
 	// Convert the parameter from JSON to the corresponding cpp types
-	mumble_connection_t connection = parameter["connection"].get< mumble_connection_t >();
-	std::string channel_name       = parameter["channel_name"].get< std::string >();
+	Parameter_findChannelByName fields;
+	fields.connection = parameter["connection"].get< mumble_connection_t >();
+	fields.channel_name = parameter["channel_name"].get< std::string >();
 
-	// Call respective API function with extracted parameter
-	nlohmann::json response;
+	return fields;
+}
+
+int read_findChannelByName(APIParameter &parameter, std::string_view name, ParameterValue &value) {
+	if (!std::holds_alternative< Parameter_findChannelByName >(parameter)) {
+		parameter.emplace< Parameter_findChannelByName >();
+	}
+	Parameter_findChannelByName &fields = std::get< Parameter_findChannelByName >(parameter);
+
+	if (name == "connection") {
+		return readInteger(fields.connection, value) ? 0 : -1;
+	}
+	if (name == "channel_name") {
+		return readString(fields.channel_name, value) ? 1 : -1;
+	}
+
+	return -1;
+}
+
+bool write_findChannelByName(const MumbleAPI &api, const APIParameter &parameter, ResponseWriter &writer) {
+	const Parameter_findChannelByName &fields = std::get< Parameter_findChannelByName >(parameter);
 
+	// Call respective API function with extracted parameter
 	try {
-		mumble_channelid_t ret = api.findChannelByName(connection, channel_name.c_str());
-
-		// clang-format off
-		response = {
-			{"response_type", "api_call"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"function", "findChannelByName"},
-					{"status", "executed"},
-					{"return_value", ret}
-				}
-			}
-		};
-		// clang-format on
+		mumble_channelid_t ret = api.findChannelByName(fields.connection, fields.channel_name.c_str());
+
+		writer.raw(R"("response_type":"api_call","response":{"function":"findChannelByName","status":"executed","return_value":)");
+		writer.value(ret);
+		writer.raw("}");
+
+		return true;
 	} catch (const MumbleAPIException &e) {
-		// clang-format off
-		response = {
-			{"response_type", "api_error"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"error_code", e.errorCode()},
-					{"error_message", e.what()}
-				}
-			}
-		};
-		// clang-format on
-	}
+		writeAPIError(writer, e);
 
-	return response;
+		return false;
+	}
 }
 
-nlohmann::json handle_findChannelByName_noexcept(const MumbleAPI &api, const std::string &bridgeSecret,
-												 const nlohmann::json &parameter) {
+APIParameter parse_findChannelByName_noexcept(const nlohmann::json &parameter) {
 	// Validate specified parameter
 	if (parameter.size() != 2) {
 		throw InvalidMessageException(
@@ -1326,47 +1268,50 @@ nlohmann::json handle_findChannelByName_noexcept(const MumbleAPI &api, const std
 	MESSAGE_ASSERT_FIELD(parameter, "channel_name", string);
 
 	// Convert the parameter from JSON to the corresponding cpp types
-	mumble_connection_t connection = parameter["connection"].get< mumble_connection_t >();
-	std::string channel_name       = parameter["channel_name"].get< std::string >();
+	Parameter_findChannelByName_noexcept fields;
+	fields.connection = parameter["connection"].get< mumble_connection_t >();
+	fields.channel_name = parameter["channel_name"].get< std::string >();
+
+	return fields;
+}
+
+int read_findChannelByName_noexcept(APIParameter &parameter, std::string_view name, ParameterValue &value) {
+	if (!std::holds_alternative< Parameter_findChannelByName_noexcept >(parameter)) {
+		parameter.emplace< Parameter_findChannelByName_noexcept >();
+	}
+	Parameter_findChannelByName_noexcept &fields = std::get< Parameter_findChannelByName_noexcept >(parameter);
+
+	if (name == "connection") {
+		return readInteger(fields.connection, value) ? 0 : -1;
+	}
+	if (name == "channel_name") {
+		return readString(fields.channel_name, value) ? 1 : -1;
+	}
+
+	return -1;
+}
+
+bool write_findChannelByName_noexcept(const MumbleAPI &api, const APIParameter &parameter, ResponseWriter &writer) {
+	const Parameter_findChannelByName_noexcept &fields = std::get< Parameter_findChannelByName_noexcept >(parameter);
 
 	// Call respective API function with extracted parameter
-	nlohmann::json response;
+	std::optional< mumble_channelid_t > ret = api.findChannelByName_noexcept(fields.connection,
+																			 fields.channel_name.c_str());
 
-	try {
-		std::optional< mumble_channelid_t > ret = api.findChannelByName_noexcept(connection, channel_name.c_str());
-
-		// clang-format off
-		response = {
-			{"response_type", "api_call"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"function", "findChannelByName_noexcept"},
-					{"status", "executed"},
-					{"return_value", ret.value()}
-				}
-			}
-		};
-		// clang-format on
-	} catch (const std::bad_optional_access &) {
-		// clang-format off
-		response = {
-			{"response_type", "api_error_optional"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"error_message", "Optional value not present"},
-				}
-			}
-		};
-		// clang-format on
-	}
-
-	return response;
-}
-
-nlohmann::json handle_getMumbleSetting_bool(const MumbleAPI &api, const std::string &bridgeSecret,
-											const nlohmann::json &parameter) {
+	if (!ret) {
+		writer.raw(R"("response_type":"api_error_optional","response":{"error_message":"Optional value not present"})");
+
+		return false;
+	}
+
+	writer.raw(R"("response_type":"api_call","response":{"function":"findChannelByName_noexcept","status":"executed","return_value":)");
+	writer.value(*ret);
+	writer.raw("}");
+
+	return true;
+}
+
+APIParameter parse_getMumbleSetting_bool(const nlohmann::json &parameter) {
 	// Validate specified parameter
 	if (parameter.size() != 1) {
 		throw InvalidMessageException(
@@ -1376,47 +1321,45 @@ nlohmann::json handle_getMumbleSetting_bool(const MumbleAPI &api, const std::str
 	MESSAGE_ASSERT_FIELD(parameter, "key", string);
 
 	// Convert the parameter from JSON to the corresponding cpp types
-	mumble_settings_key_t key = parameter["key"].get< mumble_settings_key_t >();
+	Parameter_getMumbleSetting_bool fields;
+	fields.key = parameter["key"].get< mumble_settings_key_t >();
 
-	// Call respective API function with extracted parameter
-	nlohmann::json response;
+	return fields;
+}
+
+int read_getMumbleSetting_bool(APIParameter &parameter, std::string_view name, ParameterValue &value) {
+	if (!std::holds_alternative< Parameter_getMumbleSetting_bool >(parameter)) {
+		parameter.emplace< Parameter_getMumbleSetting_bool >();
+	}
+	Parameter_getMumbleSetting_bool &fields = std::get< Parameter_getMumbleSetting_bool >(parameter);
+
+	if (name == "key") {
+		return readString(fields.key, value) ? 0 : -1;
+	}
 
+	return -1;
+}
+
+bool write_getMumbleSetting_bool(const MumbleAPI &api, const APIParameter &parameter, ResponseWriter &writer) {
+	const Parameter_getMumbleSetting_bool &fields = std::get< Parameter_getMumbleSetting_bool >(parameter);
+
+	// Call respective API function with extracted parameter
 	try {
-		bool ret = api.getMumbleSetting_bool(key);
-
-		// clang-format off
-		response = {
-			{"response_type", "api_call"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"function", "getMumbleSetting_bool"},
-					{"status", "executed"},
-					{"return_value", ret}
-				}
-			}
-		};
-		// clang-format on
+		bool ret = api.getMumbleSetting_bool(fields.key);
+
+		writer.raw(R"("response_type":"api_call","response":{"function":"getMumbleSetting_bool","status":"executed","return_value":)");
+		writer.value(ret);
+		writer.raw("}");
+
+		return true;
 	} catch (const MumbleAPIException &e) {
-		// clang-format off
-		response = {
-			{"response_type", "api_error"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"error_code", e.errorCode()},
-					{"error_message", e.what()}
-				}
-			}
-		};
-		// clang-format on
-	}
+		writeAPIError(writer, e);
 
-	return response;
+		return false;
+	}
 }
 
-nlohmann::json handle_getMumbleSetting_int(const MumbleAPI &api, const std::string &bridgeSecret,
-										   const nlohmann::json &parameter) {
+APIParameter parse_getMumbleSetting_int(const nlohmann::json &parameter) {
 	// Validate specified parameter
 	if (parameter.size() != 1) {
 		throw InvalidMessageException(
@@ -1426,47 +1369,45 @@ nlohmann::json handle_getMumbleSetting_int(const MumbleAPI &api, const std::stri
 	MESSAGE_ASSERT_FIELD(parameter, "key", string);
 
 	// Convert the parameter from JSON to the corresponding cpp types
-	mumble_settings_key_t key = parameter["key"].get< mumble_settings_key_t >();
+	Parameter_getMumbleSetting_int fields;
+	fields.key = parameter["key"].get< mumble_settings_key_t >();
 
-	// Call respective API function with extracted parameter
-	nlohmann::json response;
+	return fields;
+}
+
+int read_getMumbleSetting_int(APIParameter &parameter, std::string_view name, ParameterValue &value) {
+	if (!std::holds_alternative< Parameter_getMumbleSetting_int >(parameter)) {
+		parameter.emplace< Parameter_getMumbleSetting_int >();
+	}
+	Parameter_getMumbleSetting_int &fields = std::get< Parameter_getMumbleSetting_int >(parameter);
+
+	if (name == "key") {
+		return readString(fields.key, value) ? 0 : -1;
+	}
+
+	return -1;
+}
+
+bool write_getMumbleSetting_int(const MumbleAPI &api, const APIParameter &parameter, ResponseWriter &writer) {
+	const Parameter_getMumbleSetting_int &fields = std::get< Parameter_getMumbleSetting_int >(parameter);
 
+	// Call respective API function with extracted parameter
 	try {
-		int64_t ret = api.getMumbleSetting_int(key);
-
-		// clang-format off
-		response = {
-			{"response_type", "api_call"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"function", "getMumbleSetting_int"},
-					{"status", "executed"},
-					{"return_value", ret}
-				}
-			}
-		};
-		// clang-format on
+		int64_t ret = api.getMumbleSetting_int(fields.key);
+
+		writer.raw(R"("response_type":"api_call","response":{"function":"getMumbleSetting_int","status":"executed","return_value":)");
+		writer.value(ret);
+		writer.raw("}");
+
+		return true;
 	} catch (const MumbleAPIException &e) {
-		// clang-format off
-		response = {
-			{"response_type", "api_error"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"error_code", e.errorCode()},
-					{"error_message", e.what()}
-				}
-			}
-		};
-		// clang-format on
-	}
+		writeAPIError(writer, e);
 
-	return response;
+		return false;
+	}
 }
 
-nlohmann::json handle_getMumbleSetting_double(const MumbleAPI &api, const std::string &bridgeSecret,
-											  const nlohmann::json &parameter) {
+APIParameter parse_getMumbleSetting_double(const nlohmann::json &parameter) {
 	// Validate specified parameter
 	if (parameter.size() != 1) {
 		throw InvalidMessageException(
@@ -1476,47 +1417,45 @@ nlohmann::json handle_getMumbleSetting_double(const MumbleAPI &api, const std::s
 	MESSAGE_ASSERT_FIELD(parameter, "key", string);
 
 	// Convert the parameter from JSON to the corresponding cpp types
-	mumble_settings_key_t key = parameter["key"].get< mumble_settings_key_t >();
+	Parameter_getMumbleSetting_double fields;
+	fields.key = parameter["key"].get< mumble_settings_key_t >();
 
-	// Call respective API function with extracted parameter
-	nlohmann::json response;
+	return fields;
+}
+
+int read_getMumbleSetting_double(APIParameter &parameter, std::string_view name, ParameterValue &value) {
+	if (!std::holds_alternative< Parameter_getMumbleSetting_double >(parameter)) {
+		parameter.emplace< Parameter_getMumbleSetting_double >();
+	}
+	Parameter_getMumbleSetting_double &fields = std::get< Parameter_getMumbleSetting_double >(parameter);
+
+	if (name == "key") {
+		return readString(fields.key, value) ? 0 : -1;
+	}
 
+	return -1;
+}
+
+bool write_getMumbleSetting_double(const MumbleAPI &api, const APIParameter &parameter, ResponseWriter &writer) {
+	const Parameter_getMumbleSetting_double &fields = std::get< Parameter_getMumbleSetting_double >(parameter);
+
+	// Call respective API function with extracted parameter
 	try {
-		double ret = api.getMumbleSetting_double(key);
-
-		// clang-format off
-		response = {
-			{"response_type", "api_call"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"function", "getMumbleSetting_double"},
-					{"status", "executed"},
-					{"return_value", ret}
-				}
-			}
-		};
-		// clang-format on
+		double ret = api.getMumbleSetting_double(fields.key);
+
+		writer.raw(R"("response_type":"api_call","response":{"function":"getMumbleSetting_double","status":"executed","return_value":)");
+		writer.value(ret);
+		writer.raw("}");
+
+		return true;
 	} catch (const MumbleAPIException &e) {
-		// clang-format off
-		response = {
-			{"response_type", "api_error"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"error_code", e.errorCode()},
-					{"error_message", e.what()}
-				}
-			}
-		};
-		// clang-format on
-	}
+		writeAPIError(writer, e);
 
-	return response;
+		return false;
+	}
 }
 
-nlohmann::json handle_getMumbleSetting_string(const MumbleAPI &api, const std::string &bridgeSecret,
-											  const nlohmann::json &parameter) {
+APIParameter parse_getMumbleSetting_string(const nlohmann::json &parameter) {
 	// Validate specified parameter
 	if (parameter.size() != 1) {
 		throw InvalidMessageException(
@@ -1526,47 +1465,45 @@ nlohmann::json handle_getMumbleSetting_string(const MumbleAPI &api, const std::s
 	MESSAGE_ASSERT_FIELD(parameter, "key", string);
 
 	// Convert the parameter from JSON to the corresponding cpp types
-	mumble_settings_key_t key = parameter["key"].get< mumble_settings_key_t >();
+	Parameter_getMumbleSetting_string fields;
+	fields.key = parameter["key"].get< mumble_settings_key_t >();
 
-	// Call respective API function with extracted parameter
-	nlohmann::json response;
+	return fields;
+}
+
+int read_getMumbleSetting_string(APIParameter &parameter, std::string_view name, ParameterValue &value) {
+	if (!std::holds_alternative< Parameter_getMumbleSetting_string >(parameter)) {
+		parameter.emplace< Parameter_getMumbleSetting_string >();
+	}
+	Parameter_getMumbleSetting_string &fields = std::get< Parameter_getMumbleSetting_string >(parameter);
+
+	if (name == "key") {
+		return readString(fields.key, value) ? 0 : -1;
+	}
+
+	return -1;
+}
 
+bool write_getMumbleSetting_string(const MumbleAPI &api, const APIParameter &parameter, ResponseWriter &writer) {
+	const Parameter_getMumbleSetting_string &fields = std::get< Parameter_getMumbleSetting_string >(parameter);
+
+	// Call respective API function with extracted parameter
 	try {
-		MumbleString ret = api.getMumbleSetting_string(key);
-
-		// clang-format off
-		response = {
-			{"response_type", "api_call"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"function", "getMumbleSetting_string"},
-					{"status", "executed"},
-					{"return_value", ret}
-				}
-			}
-		};
-		// clang-format on
+		MumbleString ret = api.getMumbleSetting_string(fields.key);
+
+		writer.raw(R"("response_type":"api_call","response":{"function":"getMumbleSetting_string","status":"executed","return_value":)");
+		writer.value(ret);
+		writer.raw("}");
+
+		return true;
 	} catch (const MumbleAPIException &e) {
-		// clang-format off
-		response = {
-			{"response_type", "api_error"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"error_code", e.errorCode()},
-					{"error_message", e.what()}
-				}
-			}
-		};
-		// clang-format on
-	}
+		writeAPIError(writer, e);
 
-	return response;
+		return false;
+	}
 }
 
-nlohmann::json handle_setMumbleSetting_bool(const MumbleAPI &api, const std::string &bridgeSecret,
-											const nlohmann::json &parameter) {
+APIParameter parse_setMumbleSetting_bool(const nlohmann::json &parameter) {
 	// Validate specified parameter
 	if (parameter.size() != 2) {
 		throw InvalidMessageException(
@@ -1577,47 +1514,47 @@ nlohmann::json handle_setMumbleSetting_bool(const MumbleAPI &api, const std::str
 	MESSAGE_ASSERT_FIELD(parameter, "value", boolean);
 
 	// Convert the parameter from JSON to the corresponding cpp types
-	mumble_settings_key_t key = parameter["key"].get< mumble_settings_key_t >();
-	bool value                = parameter["value"].get< bool >();
+	Parameter_setMumbleSetting_bool fields;
+	fields.key = parameter["key"].get< mumble_settings_key_t >();
+	fields.value = parameter["value"].get< bool >();
 
-	// Call respective API function with extracted parameter
-	nlohmann::json response;
+	return fields;
+}
 
+int read_setMumbleSetting_bool(APIParameter &parameter, std::string_view name, ParameterValue &value) {
+	if (!std::holds_alternative< Parameter_setMumbleSetting_bool >(parameter)) {
+		parameter.emplace< Parameter_setMumbleSetting_bool >();
+	}
+	Parameter_setMumbleSetting_bool &fields = std::get< Parameter_setMumbleSetting_bool >(parameter);
+
+	if (name == "key") {
+		return readString(fields.key, value) ? 0 : -1;
+	}
+	if (name == "value") {
+		return readBoolean(fields.value, value) ? 1 : -1;
+	}
+
+	return -1;
+}
+
+bool write_setMumbleSetting_bool(const MumbleAPI &api, const APIParameter &parameter, ResponseWriter &writer) {
+	const Parameter_setMumbleSetting_bool &fields = std::get< Parameter_setMumbleSetting_bool >(parameter);
+
+	// Call respective API function with extracted parameter
 	try {
-		api.setMumbleSetting_bool(key, value);
-
-		// clang-format off
-		response = {
-			{"response_type", "api_call"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"function", "setMumbleSetting_bool"},
-					{"status", "executed"}
-				}
-			}
-		};
-		// clang-format on
+		api.setMumbleSetting_bool(fields.key, fields.value);
+
+		writer.raw(R"("response_type":"api_call","response":{"function":"setMumbleSetting_bool","status":"executed"})");
+
+		return true;
 	} catch (const MumbleAPIException &e) {
-		// clang-format off
-		response = {
-			{"response_type", "api_error"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"error_code", e.errorCode()},
-					{"error_message", e.what()}
-				}
-			}
-		};
-		// clang-format on
-	}
+		writeAPIError(writer, e);
 
-	return response;
+		return false;
+	}
 }
 
-nlohmann::json handle_setMumbleSetting_int(const MumbleAPI &api, const std::string &bridgeSecret,
-										   const nlohmann::json &parameter) {
+APIParameter parse_setMumbleSetting_int(const nlohmann::json &parameter) {
 	// Validate specified parameter
 	if (parameter.size() != 2) {
 		throw InvalidMessageException(
@@ -1628,47 +1565,47 @@ nlohmann::json handle_setMumbleSetting_int(const MumbleAPI &api, const std::stri
 	MESSAGE_ASSERT_FIELD(parameter, "value", number_integer);
 
 	// Convert the parameter from JSON to the corresponding cpp types
-	mumble_settings_key_t key = parameter["key"].get< mumble_settings_key_t >();
-	int value                 = parameter["value"].get< int >();
+	Parameter_setMumbleSetting_int fields;
+	fields.key = parameter["key"].get< mumble_settings_key_t >();
+	fields.value = parameter["value"].get< int >();
 
-	// Call respective API function with extracted parameter
-	nlohmann::json response;
+	return fields;
+}
+
+int read_setMumbleSetting_int(APIParameter &parameter, std::string_view name, ParameterValue &value) {
+	if (!std::holds_alternative< Parameter_setMumbleSetting_int >(parameter)) {
+		parameter.emplace< Parameter_setMumbleSetting_int >();
+	}
+	Parameter_setMumbleSetting_int &fields = std::get< Parameter_setMumbleSetting_int >(parameter);
 
+	if (name == "key") {
+		return readString(fields.key, value) ? 0 : -1;
+	}
+	if (name == "value") {
+		return readInteger(fields.value, value) ? 1 : -1;
+	}
+
+	return -1;
+}
+
+bool write_setMumbleSetting_int(const MumbleAPI &api, const APIParameter &parameter, ResponseWriter &writer) {
+	const Parameter_setMumbleSetting_int &fields = std::get< Parameter_setMumbleSetting_int >(parameter);
+
+	// Call respective API function with extracted parameter
 	try {
-		api.setMumbleSetting_int(key, value);
-
-		// clang-format off
-		response = {
-			{"response_type", "api_call"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"function", "setMumbleSetting_int"},
-					{"status", "executed"}
-				}
-			}
-		};
-		// clang-format on
+		api.setMumbleSetting_int(fields.key, fields.value);
+
+		writer.raw(R"("response_type":"api_call","response":{"function":"setMumbleSetting_int","status":"executed"})");
+
+		return true;
 	} catch (const MumbleAPIException &e) {
-		// clang-format off
-		response = {
-			{"response_type", "api_error"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"error_code", e.errorCode()},
-					{"error_message", e.what()}
-				}
-			}
-		};
-		// clang-format on
-	}
+		writeAPIError(writer, e);
 
-	return response;
+		return false;
+	}
 }
 
-nlohmann::json handle_setMumbleSetting_double(const MumbleAPI &api, const std::string &bridgeSecret,
-											  const nlohmann::json &parameter) {
+APIParameter parse_setMumbleSetting_double(const nlohmann::json &parameter) {
 	// Validate specified parameter
 	if (parameter.size() != 2) {
 		throw InvalidMessageException(
@@ -1679,47 +1616,47 @@ nlohmann::json handle_setMumbleSetting_double(const MumbleAPI &api, const std::s
 	MESSAGE_ASSERT_FIELD(parameter, "value", number_float);
 
 	// Convert the parameter from JSON to the corresponding cpp types
-	mumble_settings_key_t key = parameter["key"].get< mumble_settings_key_t >();
-	double value              = parameter["value"].get< double >();
+	Parameter_setMumbleSetting_double fields;
+	fields.key = parameter["key"].get< mumble_settings_key_t >();
+	fields.value = parameter["value"].get< double >();
 
-	// Call respective API function with extracted parameter
-	nlohmann::json response;
+	return fields;
+}
+
+int read_setMumbleSetting_double(APIParameter &parameter, std::string_view name, ParameterValue &value) {
+	if (!std::holds_alternative< Parameter_setMumbleSetting_double >(parameter)) {
+		parameter.emplace< Parameter_setMumbleSetting_double >();
+	}
+	Parameter_setMumbleSetting_double &fields = std::get< Parameter_setMumbleSetting_double >(parameter);
+
+	if (name == "key") {
+		return readString(fields.key, value) ? 0 : -1;
+	}
+	if (name == "value") {
+		return readFloat(fields.value, value) ? 1 : -1;
+	}
 
+	return -1;
+}
+
+bool write_setMumbleSetting_double(const MumbleAPI &api, const APIParameter &parameter, ResponseWriter &writer) {
+	const Parameter_setMumbleSetting_double &fields = std::get< Parameter_setMumbleSetting_double >(parameter);
+
+	// Call respective API function with extracted parameter
 	try {
-		api.setMumbleSetting_double(key, value);
-
-		// clang-format off
-		response = {
-			{"response_type", "api_call"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"function", "setMumbleSetting_double"},
-					{"status", "executed"}
-				}
-			}
-		};
-		// clang-format on
+		api.setMumbleSetting_double(fields.key, fields.value);
+
+		writer.raw(R"("response_type":"api_call","response":{"function":"setMumbleSetting_double","status":"executed"})");
+
+		return true;
 	} catch (const MumbleAPIException &e) {
-		// clang-format off
-		response = {
-			{"response_type", "api_error"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"error_code", e.errorCode()},
-					{"error_message", e.what()}
-				}
-			}
-		};
-		// clang-format on
-	}
+		writeAPIError(writer, e);
 
-	return response;
+		return false;
+	}
 }
 
-nlohmann::json handle_setMumbleSetting_string(const MumbleAPI &api, const std::string &bridgeSecret,
-											  const nlohmann::json &parameter) {
+APIParameter parse_setMumbleSetting_string(const nlohmann::json &parameter) {
 	// Validate specified parameter
 	if (parameter.size() != 2) {
 		throw InvalidMessageException(
@@ -1730,46 +1667,47 @@ nlohmann::json handle_setMumbleSetting_string(const MumbleAPI &api, const std::s
 	MESSAGE_ASSERT_FIELD(parameter, "value", string);
 
 	// Convert the parameter from JSON to the corresponding cpp types
-	mumble_settings_key_t key = parameter["key"].get< mumble_settings_key_t >();
-	std::string value         = parameter["value"].get< std::string >();
+	Parameter_setMumbleSetting_string fields;
+	fields.key = parameter["key"].get< mumble_settings_key_t >();
+	fields.value = parameter["value"].get< std::string >();
 
-	// Call respective API function with extracted parameter
-	nlohmann::json response;
+	return fields;
+}
+
+int read_setMumbleSetting_string(APIParameter &parameter, std::string_view name, ParameterValue &value) {
+	if (!std::holds_alternative< Parameter_setMumbleSetting_string >(parameter)) {
+		parameter.emplace< Parameter_setMumbleSetting_string >();
+	}
+	Parameter_setMumbleSetting_string &fields = std::get< Parameter_setMumbleSetting_string >(parameter);
+
+	if (name == "key") {
+		return readString(fields.key, value) ? 0 : -1;
+	}
+	if (name == "value") {
+		return readString(fields.value, value) ? 1 : -1;
+	}
+
+	return -1;
+}
 
+bool write_setMumbleSetting_string(const MumbleAPI &api, const APIParameter &parameter, ResponseWriter &writer) {
+	const Parameter_setMumbleSetting_string &fields = std::get< Parameter_setMumbleSetting_string >(parameter);
+
+	// Call respective API function with extracted parameter
 	try {
-		api.setMumbleSetting_string(key, value.c_str());
-
-		// clang-format off
-		response = {
-			{"response_type", "api_call"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"function", "setMumbleSetting_string"},
-					{"status", "executed"}
-				}
-			}
-		};
-		// clang-format on
+		api.setMumbleSetting_string(fields.key, fields.value.c_str());
+
+		writer.raw(R"("response_type":"api_call","response":{"function":"setMumbleSetting_string","status":"executed"})");
+
+		return true;
 	} catch (const MumbleAPIException &e) {
-		// clang-format off
-		response = {
-			{"response_type", "api_error"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"error_code", e.errorCode()},
-					{"error_message", e.what()}
-				}
-			}
-		};
-		// clang-format on
-	}
+		writeAPIError(writer, e);
 
-	return response;
+		return false;
+	}
 }
 
-nlohmann::json handle_sendData(const MumbleAPI &api, const std::string &bridgeSecret, const nlohmann::json &parameter) {
+APIParameter parse_sendData(const nlohmann::json &parameter) {
 	// Validate specified parameter
 	if (parameter.size() != 4) {
 		throw InvalidMessageException(std::string("API function \"sendData\" expects 4 parameter(s) but got ")
@@ -1781,48 +1719,55 @@ nlohmann::json handle_sendData(const MumbleAPI &api, const std::string &bridgeSe
 	MESSAGE_ASSERT_FIELD(parameter, "data_id", string);
 
 	// Convert the parameter from JSON to the corresponding cpp types
-	mumble_connection_t connection           = parameter["connection"].get< mumble_connection_t >();
-	std::vector< mumble_userid_t > receivers = parameter["receivers"].get< std::vector< mumble_userid_t > >();
-	std::vector< uint8_t > data              = parameter["data"].get< std::vector< uint8_t > >();
-	std::string data_id                      = parameter["data_id"].get< std::string >();
+	Parameter_sendData fields;
+	fields.connection = parameter["connection"].get< mumble_connection_t >();
+	fields.receivers = parameter["receivers"].get<std::vector< mumble_userid_t >>();
+	fields.data = parameter["data"].get<std::vector< uint8_t >>();
+	fields.data_id = parameter["data_id"].get< std::string >();
 
-	// Call respective API function with extracted parameter
-	nlohmann::json response;
+	return fields;
+}
+
+int read_sendData(APIParameter &parameter, std::string_view name, ParameterValue &value) {
+	if (!std::holds_alternative< Parameter_sendData >(parameter)) {
+		parameter.emplace< Parameter_sendData >();
+	}
+	Parameter_sendData &fields = std::get< Parameter_sendData >(parameter);
+
+	if (name == "connection") {
+		return readInteger(fields.connection, value) ? 0 : -1;
+	}
+	if (name == "receivers") {
+		return readArray(fields.receivers, value) ? 1 : -1;
+	}
+	if (name == "data") {
+		return readArray(fields.data, value) ? 2 : -1;
+	}
+	if (name == "data_id") {
+		return readString(fields.data_id, value) ? 3 : -1;
+	}
+
+	return -1;
+}
+
+bool write_sendData(const MumbleAPI &api, const APIParameter &parameter, ResponseWriter &writer) {
+	const Parameter_sendData &fields = std::get< Parameter_sendData >(parameter);
 
+	// Call respective API function with extracted parameter
 	try {
-		api.sendData(connection, receivers, data, data_id.c_str());
-
-		// clang-format off
-		response = {
-			{"response_type", "api_call"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"function", "sendData"},
-					{"status", "executed"}
-				}
-			}
-		};
-		// clang-format on
+		api.sendData(fields.connection, fields.receivers, fields.data, fields.data_id.c_str());
+
+		writer.raw(R"("response_type":"api_call","response":{"function":"sendData","status":"executed"})");
+
+		return true;
 	} catch (const MumbleAPIException &e) {
-		// clang-format off
-		response = {
-			{"response_type", "api_error"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"error_code", e.errorCode()},
-					{"error_message", e.what()}
-				}
-			}
-		};
-		// clang-format on
-	}
+		writeAPIError(writer, e);
 
-	return response;
+		return false;
+	}
 }
 
-nlohmann::json handle_log(const MumbleAPI &api, const std::string &bridgeSecret, const nlohmann::json &parameter) {
+APIParameter parse_log(const nlohmann::json &parameter) {
 	// Validate specified parameter
 	if (parameter.size() != 1) {
 		throw InvalidMessageException(std::string("API function \"log\" expects 1 parameter(s) but got ")
@@ -1831,46 +1776,43 @@ nlohmann::json handle_log(const MumbleAPI &api, const std::string &bridgeSecret,
 	MESSAGE_ASSERT_FIELD(parameter, "message", string);
 
 	// Convert the parameter from JSON to the corresponding cpp types
-	std::string message = parameter["message"].get< std::string >();
+	Parameter_log fields;
+	fields.message = parameter["message"].get< std::string >();
 
-	// Call respective API function with extracted parameter
-	nlohmann::json response;
+	return fields;
+}
+
+int read_log(APIParameter &parameter, std::string_view name, ParameterValue &value) {
+	if (!std::holds_alternative< Parameter_log >(parameter)) {
+		parameter.emplace< Parameter_log >();
+	}
+	Parameter_log &fields = std::get< Parameter_log >(parameter);
 
+	if (name == "message") {
+		return readString(fields.message, value) ? 0 : -1;
+	}
+
+	return -1;
+}
+
+bool write_log(const MumbleAPI &api, const APIParameter &parameter, ResponseWriter &writer) {
+	const Parameter_log &fields = std::get< Parameter_log >(parameter);
+
+	// Call respective API function with extracted parameter
 	try {
-		api.log(message.c_str());
-
-		// clang-format off
-		response = {
-			{"response_type", "api_call"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"function", "log"},
-					{"status", "executed"}
-				}
-			}
-		};
-		// clang-format on
+		api.log(fields.message.c_str());
+
+		writer.raw(R"("response_type":"api_call","response":{"function":"log","status":"executed"})");
+
+		return true;
 	} catch (const MumbleAPIException &e) {
-		// clang-format off
-		response = {
-			{"response_type", "api_error"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"error_code", e.errorCode()},
-					{"error_message", e.what()}
-				}
-			}
-		};
-		// clang-format on
-	}
+		writeAPIError(writer, e);
 
-	return response;
+		return false;
+	}
 }
 
-nlohmann::json handle_log_noexcept(const MumbleAPI &api, const std::string &bridgeSecret,
-								   const nlohmann::json &parameter) {
+APIParameter parse_log_noexcept(const nlohmann::json &parameter) {
 	// Validate specified parameter
 	if (parameter.size() != 1) {
 		throw InvalidMessageException(std::string("API function \"log_noexcept\" expects 1 parameter(s) but got ")
@@ -1879,32 +1821,39 @@ nlohmann::json handle_log_noexcept(const MumbleAPI &api, const std::string &brid
 	MESSAGE_ASSERT_FIELD(parameter, "message", string);
 
 	// Convert the parameter from JSON to the corresponding cpp types
-	std::string message = parameter["message"].get< std::string >();
+	Parameter_log_noexcept fields;
+	fields.message = parameter["message"].get< std::string >();
 
-	// Call respective API function with extracted parameter
-	nlohmann::json response;
+	return fields;
+}
 
-	mumble_error_t ret = api.log_noexcept(message.c_str());
+int read_log_noexcept(APIParameter &parameter, std::string_view name, ParameterValue &value) {
+	if (!std::holds_alternative< Parameter_log_noexcept >(parameter)) {
+		parameter.emplace< Parameter_log_noexcept >();
+	}
+	Parameter_log_noexcept &fields = std::get< Parameter_log_noexcept >(parameter);
 
-	// clang-format off
-	response = {
-		{"response_type", "api_call"},
-		{"secret", bridgeSecret},
-		{"response",
-			{
-				{"function", "log_noexcept"},
-				{"status", "executed"},
-				{"return_value", ret}
-			}
-		}
-	};
-	// clang-format on
+	if (name == "message") {
+		return readString(fields.message, value) ? 0 : -1;
+	}
 
-	return response;
+	return -1;
 }
 
-nlohmann::json handle_playSample(const MumbleAPI &api, const std::string &bridgeSecret,
-								 const nlohmann::json &parameter) {
+bool write_log_noexcept(const MumbleAPI &api, const APIParameter &parameter, ResponseWriter &writer) {
+	const Parameter_log_noexcept &fields = std::get< Parameter_log_noexcept >(parameter);
+
+	// Call respective API function with extracted parameter
+	mumble_error_t ret = api.log_noexcept(fields.message.c_str());
+
+	writer.raw(R"("response_type":"api_call","response":{"function":"log_noexcept","status":"executed","return_value":)");
+	writer.value(ret);
+	writer.raw("}");
+
+	return true;
+}
+
+APIParameter parse_playSample(const nlohmann::json &parameter) {
 	// Validate specified parameter
 	if (parameter.size() != 1) {
 		throw InvalidMessageException(std::string("API function \"playSample\" expects 1 parameter(s) but got ")
@@ -1913,129 +1862,275 @@ nlohmann::json handle_playSample(const MumbleAPI &api, const std::string &bridge
 	MESSAGE_ASSERT_FIELD(parameter, "sample_path", string);
 
 	// Convert the parameter from JSON to the corresponding cpp types
-	std::string sample_path = parameter["sample_path"].get< std::string >();
+	Parameter_playSample fields;
+	fields.sample_path = parameter["sample_path"].get< std::string >();
 
-	// Call respective API function with extracted parameter
-	nlohmann::json response;
+	return fields;
+}
 
+int read_playSample(APIParameter &parameter, std::string_view name, ParameterValue &value) {
+	if (!std::holds_alternative< Parameter_playSample >(parameter)) {
+		parameter.emplace< Parameter_playSample >();
+	}
+	Parameter_playSample &fields = std::get< Parameter_playSample >(parameter);
+
+	if (name == "sample_path") {
+		return readString(fields.sample_path, value) ? 0 : -1;
+	}
+
+	return -1;
+}
+
+bool write_playSample(const MumbleAPI &api, const APIParameter &parameter, ResponseWriter &writer) {
+	const Parameter_playSample &fields = std::get< Parameter_playSample >(parameter);
+
+	// Call respective API function with extracted parameter
 	try {
-		api.playSample(sample_path.c_str());
-
-		// clang-format off
-		response = {
-			{"response_type", "api_call"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"function", "playSample"},
-					{"status", "executed"}
-				}
-			}
-		};
-		// clang-format on
+		api.playSample(fields.sample_path.c_str());
+
+		writer.raw(R"("response_type":"api_call","response":{"function":"playSample","status":"executed"})");
+
+		return true;
 	} catch (const MumbleAPIException &e) {
-		// clang-format off
-		response = {
-			{"response_type", "api_error"},
-			{"secret", bridgeSecret},
-			{"response",
-				{
-					{"error_code", e.errorCode()},
-					{"error_message", e.what()}
-				}
-			}
-		};
-		// clang-format on
-	}
-
-	return response;
-}
-
-nlohmann::json execute(const std::string &functionName, const MumbleAPI &api, const std::string &bridgeSecret,
-					   const nlohmann::json &msg) {
-	if (functionName == "freeMemory") {
-		return handle_freeMemory(api, bridgeSecret, msg["parameter"]);
-	} else if (functionName == "getActiveServerConnection") {
-		return handle_getActiveServerConnection(api, bridgeSecret);
-	} else if (functionName == "isConnectionSynchronized") {
-		return handle_isConnectionSynchronized(api, bridgeSecret, msg["parameter"]);
-	} else if (functionName == "getLocalUserID") {
-		return handle_getLocalUserID(api, bridgeSecret, msg["parameter"]);
-	} else if (functionName == "getUserName") {
-		return handle_getUserName(api, bridgeSecret, msg["parameter"]);
-	} else if (functionName == "getChannelName") {
-		return handle_getChannelName(api, bridgeSecret, msg["parameter"]);
-	} else if (functionName == "getAllUsers") {
-		return handle_getAllUsers(api, bridgeSecret, msg["parameter"]);
-	} else if (functionName == "getAllChannels") {
-		return handle_getAllChannels(api, bridgeSecret, msg["parameter"]);
-	} else if (functionName == "getChannelOfUser") {
-		return handle_getChannelOfUser(api, bridgeSecret, msg["parameter"]);
-	} else if (functionName == "getUsersInChannel") {
-		return handle_getUsersInChannel(api, bridgeSecret, msg["parameter"]);
-	} else if (functionName == "getLocalUserTransmissionMode") {
-		return handle_getLocalUserTransmissionMode(api, bridgeSecret);
-	} else if (functionName == "isUserLocallyMuted") {
-		return handle_isUserLocallyMuted(api, bridgeSecret, msg["parameter"]);
-	} else if (functionName == "isLocalUserMuted") {
-		return handle_isLocalUserMuted(api, bridgeSecret);
-	} else if (functionName == "isLocalUserDeafened") {
-		return handle_isLocalUserDeafened(api, bridgeSecret);
-	} else if (functionName == "getUserHash") {
-		return handle_getUserHash(api, bridgeSecret, msg["parameter"]);
-	} else if (functionName == "getServerHash") {
-		return handle_getServerHash(api, bridgeSecret, msg["parameter"]);
-	} else if (functionName == "getUserComment") {
-		return handle_getUserComment(api, bridgeSecret, msg["parameter"]);
-	} else if (functionName == "getChannelDescription") {
-		return handle_getChannelDescription(api, bridgeSecret, msg["parameter"]);
-	} else if (functionName == "requestLocalUserTransmissionMode") {
-		return handle_requestLocalUserTransmissionMode(api, bridgeSecret, msg["parameter"]);
-	} else if (functionName == "requestUserMove") {
-		return handle_requestUserMove(api, bridgeSecret, msg["parameter"]);
-	} else if (functionName == "requestMicrophoneActivationOvewrite") {
-		return handle_requestMicrophoneActivationOvewrite(api, bridgeSecret, msg["parameter"]);
-	} else if (functionName == "requestLocalMute") {
-		return handle_requestLocalMute(api, bridgeSecret, msg["parameter"]);
-	} else if (functionName == "requestLocalUserMute") {
-		return handle_requestLocalUserMute(api, bridgeSecret, msg["parameter"]);
-	} else if (functionName == "requestLocalUserDeaf") {
-		return handle_requestLocalUserDeaf(api, bridgeSecret, msg["parameter"]);
-	} else if (functionName == "requestSetLocalUserComment") {
-		return handle_requestSetLocalUserComment(api, bridgeSecret, msg["parameter"]);
-	} else if (functionName == "findUserByName") {
-		return handle_findUserByName(api, bridgeSecret, msg["parameter"]);
-	} else if (functionName == "findUserByName_noexcept") {
-		return handle_findUserByName_noexcept(api, bridgeSecret, msg["parameter"]);
-	} else if (functionName == "findChannelByName") {
-		return handle_findChannelByName(api, bridgeSecret, msg["parameter"]);
-	} else if (functionName == "findChannelByName_noexcept") {
-		return handle_findChannelByName_noexcept(api, bridgeSecret, msg["parameter"]);
-	} else if (functionName == "getMumbleSetting_bool") {
-		return handle_getMumbleSetting_bool(api, bridgeSecret, msg["parameter"]);
-	} else if (functionName == "getMumbleSetting_int") {
-		return handle_getMumbleSetting_int(api, bridgeSecret, msg["parameter"]);
-	} else if (functionName == "getMumbleSetting_double") {
-		return handle_getMumbleSetting_double(api, bridgeSecret, msg["parameter"]);
-	} else if (functionName == "getMumbleSetting_string") {
-		return handle_getMumbleSetting_string(api, bridgeSecret, msg["parameter"]);
-	} else if (functionName == "setMumbleSetting_bool") {
-		return handle_setMumbleSetting_bool(api, bridgeSecret, msg["parameter"]);
-	} else if (functionName == "setMumbleSetting_int") {
-		return handle_setMumbleSetting_int(api, bridgeSecret, msg["parameter"]);
-	} else if (functionName == "setMumbleSetting_double") {
-		return handle_setMumbleSetting_double(api, bridgeSecret, msg["parameter"]);
-	} else if (functionName == "setMumbleSetting_string") {
-		return handle_setMumbleSetting_string(api, bridgeSecret, msg["parameter"]);
-	} else if (functionName == "sendData") {
-		return handle_sendData(api, bridgeSecret, msg["parameter"]);
-	} else if (functionName == "log") {
-		return handle_log(api, bridgeSecret, msg["parameter"]);
-	} else if (functionName == "log_noexcept") {
-		return handle_log_noexcept(api, bridgeSecret, msg["parameter"]);
-	} else if (functionName == "playSample") {
-		return handle_playSample(api, bridgeSecret, msg["parameter"]);
-	}
-
-	throw std::invalid_argument(std::string("Unknown API function \"") + functionName + "\"");
+		writeAPIError(writer, e);
+
+		return false;
+	}
+}
+
+APIParameter parse_getServerSnapshot(const nlohmann::json &parameter) {
+	// Validate specified parameter
+	if (parameter.size() != 1) {
+		throw InvalidMessageException(std::string("API function \"getServerSnapshot\" expects 1 parameter(s) but got ")
+									  + std::to_string(parameter.size()));
+	}
+	MESSAGE_ASSERT_FIELD(parameter, "connection", number_integer);
+
+	// Convert the parameter from JSON to the corresponding cpp types
+	Parameter_getServerSnapshot fields;
+	fields.connection = parameter["connection"].get< mumble_connection_t >();
+
+	return fields;
+}
+
+int read_getServerSnapshot(APIParameter &parameter, std::string_view name, ParameterValue &value) {
+	if (!std::holds_alternative< Parameter_getServerSnapshot >(parameter)) {
+		parameter.emplace< Parameter_getServerSnapshot >();
+	}
+	Parameter_getServerSnapshot &fields = std::get< Parameter_getServerSnapshot >(parameter);
+
+	if (name == "connection") {
+		return readInteger(fields.connection, value) ? 0 : -1;
+	}
+
+	return -1;
+}
+
+APIParameter parse_getChangesSince(const nlohmann::json &parameter) {
+	// Validate specified parameter
+	if (parameter.size() != 2) {
+		throw InvalidMessageException(std::string("API function \"getChangesSince\" expects 2 parameter(s) but got ")
+									  + std::to_string(parameter.size()));
+	}
+	MESSAGE_ASSERT_FIELD(parameter, "connection", number_integer);
+	MESSAGE_ASSERT_FIELD(parameter, "version", number_unsigned);
+
+	// Convert the parameter from JSON to the corresponding cpp types
+	Parameter_getChangesSince fields;
+	fields.connection = parameter["connection"].get< mumble_connection_t >();
+	fields.version = parameter["version"].get< uint64_t >();
+
+	return fields;
+}
+
+int read_getChangesSince(APIParameter &parameter, std::string_view name, ParameterValue &value) {
+	if (!std::holds_alternative< Parameter_getChangesSince >(parameter)) {
+		parameter.emplace< Parameter_getChangesSince >();
+	}
+	Parameter_getChangesSince &fields = std::get< Parameter_getChangesSince >(parameter);
+
+	if (name == "connection") {
+		return readInteger(fields.connection, value) ? 0 : -1;
+	}
+	if (name == "version") {
+		return readUnsigned(fields.version, value) ? 1 : -1;
+	}
+
+	return -1;
+}
+
+APIParameter parse_findUsersByName(const nlohmann::json &parameter) {
+	// Validate specified parameter
+	if (parameter.size() != 4) {
+		throw InvalidMessageException(std::string("API function \"findUsersByName\" expects 4 parameter(s) but got ")
+									  + std::to_string(parameter.size()));
+	}
+	MESSAGE_ASSERT_FIELD(parameter, "connection", number_integer);
+	MESSAGE_ASSERT_FIELD(parameter, "user_name", string);
+	MESSAGE_ASSERT_FIELD(parameter, "case_sensitive", boolean);
+	MESSAGE_ASSERT_FIELD(parameter, "prefix", boolean);
+
+	// Convert the parameter from JSON to the corresponding cpp types
+	Parameter_findUsersByName fields;
+	fields.connection = parameter["connection"].get< mumble_connection_t >();
+	fields.user_name = parameter["user_name"].get< std::string >();
+	fields.case_sensitive = parameter["case_sensitive"].get< bool >();
+	fields.prefix = parameter["prefix"].get< bool >();
+
+	return fields;
+}
+
+int read_findUsersByName(APIParameter &parameter, std::string_view name, ParameterValue &value) {
+	if (!std::holds_alternative< Parameter_findUsersByName >(parameter)) {
+		parameter.emplace< Parameter_findUsersByName >();
+	}
+	Parameter_findUsersByName &fields = std::get< Parameter_findUsersByName >(parameter);
+
+	if (name == "connection") {
+		return readInteger(fields.connection, value) ? 0 : -1;
+	}
+	if (name == "user_name") {
+		return readString(fields.user_name, value) ? 1 : -1;
+	}
+	if (name == "case_sensitive") {
+		return readBoolean(fields.case_sensitive, value) ? 2 : -1;
+	}
+	if (name == "prefix") {
+		return readBoolean(fields.prefix, value) ? 3 : -1;
+	}
+
+	return -1;
+}
+
+APIParameter parse_findChannelsByName(const nlohmann::json &parameter) {
+	// Validate specified parameter
+	if (parameter.size() != 4) {
+		throw InvalidMessageException(std::string("API function \"findChannelsByName\" expects 4 parameter(s) but got ")
+									  + std::to_string(parameter.size()));
+	}
+	MESSAGE_ASSERT_FIELD(parameter, "connection", number_integer);
+	MESSAGE_ASSERT_FIELD(parameter, "channel_name", string);
+	MESSAGE_ASSERT_FIELD(parameter, "case_sensitive", boolean);
+	MESSAGE_ASSERT_FIELD(parameter, "prefix", boolean);
+
+	// Convert the parameter from JSON to the corresponding cpp types
+	Parameter_findChannelsByName fields;
+	fields.connection = parameter["connection"].get< mumble_connection_t >();
+	fields.channel_name = parameter["channel_name"].get< std::string >();
+	fields.case_sensitive = parameter["case_sensitive"].get< bool >();
+	fields.prefix = parameter["prefix"].get< bool >();
+
+	return fields;
+}
+
+int read_findChannelsByName(APIParameter &parameter, std::string_view name, ParameterValue &value) {
+	if (!std::holds_alternative< Parameter_findChannelsByName >(parameter)) {
+		parameter.emplace< Parameter_findChannelsByName >();
+	}
+	Parameter_findChannelsByName &fields = std::get< Parameter_findChannelsByName >(parameter);
+
+	if (name == "connection") {
+		return readInteger(fields.connection, value) ? 0 : -1;
+	}
+	if (name == "channel_name") {
+		return readString(fields.channel_name, value) ? 1 : -1;
+	}
+	if (name == "case_sensitive") {
+		return readBoolean(fields.case_sensitive, value) ? 2 : -1;
+	}
+	if (name == "prefix") {
+		return readBoolean(fields.prefix, value) ? 3 : -1;
+	}
+
+	return -1;
+}
+
+constexpr std::array< APIFunction, 45 > s_apiFunctions = { {
+	{ "freeMemory", 1, &parse_freeMemory, &read_freeMemory, &write_freeMemory },
+	{ "getActiveServerConnection", 0, nullptr, nullptr, &write_getActiveServerConnection },
+	{ "isConnectionSynchronized", 1, &parse_isConnectionSynchronized, &read_isConnectionSynchronized,
+	  &write_isConnectionSynchronized },
+	{ "getLocalUserID", 1, &parse_getLocalUserID, &read_getLocalUserID, &write_getLocalUserID },
+	{ "getUserName", 2, &parse_getUserName, &read_getUserName, &write_getUserName },
+	{ "getChannelName", 2, &parse_getChannelName, &read_getChannelName, &write_getChannelName },
+	{ "getAllUsers", 1, &parse_getAllUsers, &read_getAllUsers, &write_getAllUsers },
+	{ "getAllChannels", 1, &parse_getAllChannels, &read_getAllChannels, &write_getAllChannels },
+	{ "getChannelOfUser", 2, &parse_getChannelOfUser, &read_getChannelOfUser, &write_getChannelOfUser },
+	{ "getUsersInChannel", 2, &parse_getUsersInChannel, &read_getUsersInChannel, &write_getUsersInChannel },
+	{ "getLocalUserTransmissionMode", 0, nullptr, nullptr, &write_getLocalUserTransmissionMode },
+	{ "isUserLocallyMuted", 2, &parse_isUserLocallyMuted, &read_isUserLocallyMuted, &write_isUserLocallyMuted },
+	{ "isLocalUserMuted", 0, nullptr, nullptr, &write_isLocalUserMuted },
+	{ "isLocalUserDeafened", 0, nullptr, nullptr, &write_isLocalUserDeafened },
+	{ "getUserHash", 2, &parse_getUserHash, &read_getUserHash, &write_getUserHash },
+	{ "getServerHash", 1, &parse_getServerHash, &read_getServerHash, &write_getServerHash },
+	{ "getUserComment", 2, &parse_getUserComment, &read_getUserComment, &write_getUserComment },
+	{ "getChannelDescription", 2, &parse_getChannelDescription, &read_getChannelDescription,
+	  &write_getChannelDescription },
+	{ "requestLocalUserTransmissionMode", 1, &parse_requestLocalUserTransmissionMode,
+	  &read_requestLocalUserTransmissionMode, &write_requestLocalUserTransmissionMode },
+	{ "requestUserMove", 4, &parse_requestUserMove, &read_requestUserMove, &write_requestUserMove },
+	{ "requestMicrophoneActivationOvewrite", 1, &parse_requestMicrophoneActivationOvewrite,
+	  &read_requestMicrophoneActivationOvewrite, &write_requestMicrophoneActivationOvewrite },
+	{ "requestLocalMute", 3, &parse_requestLocalMute, &read_requestLocalMute, &write_requestLocalMute },
+	{ "requestLocalUserMute", 1, &parse_requestLocalUserMute, &read_requestLocalUserMute, &write_requestLocalUserMute },
+	{ "requestLocalUserDeaf", 1, &parse_requestLocalUserDeaf, &read_requestLocalUserDeaf, &write_requestLocalUserDeaf },
+	{ "requestSetLocalUserComment", 2, &parse_requestSetLocalUserComment, &read_requestSetLocalUserComment,
+	  &write_requestSetLocalUserComment },
+	{ "findUserByName", 2, &parse_findUserByName, &read_findUserByName, &write_findUserByName },
+	{ "findUserByName_noexcept", 2, &parse_findUserByName_noexcept, &read_findUserByName_noexcept,
+	  &write_findUserByName_noexcept },
+	{ "findChannelByName", 2, &parse_findChannelByName, &read_findChannelByName, &write_findChannelByName },
+	{ "findChannelByName_noexcept", 2, &parse_findChannelByName_noexcept, &read_findChannelByName_noexcept,
+	  &write_findChannelByName_noexcept },
+	{ "getMumbleSetting_bool", 1, &parse_getMumbleSetting_bool, &read_getMumbleSetting_bool,
+	  &write_getMumbleSetting_bool },
+	{ "getMumbleSetting_int", 1, &parse_getMumbleSetting_int, &read_getMumbleSetting_int, &write_getMumbleSetting_int },
+	{ "getMumbleSetting_double", 1, &parse_getMumbleSetting_double, &read_getMumbleSetting_double,
+	  &write_getMumbleSetting_double },
+	{ "getMumbleSetting_string", 1, &parse_getMumbleSetting_string, &read_getMumbleSetting_string,
+	  &write_getMumbleSetting_string },
+	{ "setMumbleSetting_bool", 2, &parse_setMumbleSetting_bool, &read_setMumbleSetting_bool,
+	  &write_setMumbleSetting_bool },
+	{ "setMumbleSetting_int", 2, &parse_setMumbleSetting_int, &read_setMumbleSetting_int, &write_setMumbleSetting_int },
+	{ "setMumbleSetting_double", 2, &parse_setMumbleSetting_double, &read_setMumbleSetting_double,
+	  &write_setMumbleSetting_double },
+	{ "setMumbleSetting_string", 2, &parse_setMumbleSetting_string, &read_setMumbleSetting_string,
+	  &write_setMumbleSetting_string },
+	{ "sendData", 4, &parse_sendData, &read_sendData, &write_sendData },
+	{ "log", 1, &parse_log, &read_log, &write_log },
+	{ "log_noexcept", 1, &parse_log_noexcept, &read_log_noexcept, &write_log_noexcept },
+	{ "playSample", 1, &parse_playSample, &read_playSample, &write_playSample },
+	{ "getServerSnapshot", 1, &parse_getServerSnapshot, &read_getServerSnapshot, &write_getServerSnapshot },
+	{ "getChangesSince", 2, &parse_getChangesSince, &read_getChangesSince, &write_getChangesSince },
+	{ "findUsersByName", 4, &parse_findUsersByName, &read_findUsersByName, &write_findUsersByName },
+	{ "findChannelsByName", 4, &parse_findChannelsByName, &read_findChannelsByName, &write_findChannelsByName }
+} };
+
+// Perfect hash of the function names: Every function is found in the slot given by its name's hash (-1 marks an
+// empty slot)
+constexpr std::uint32_t API_FUNCTION_HASH_SEED = 7;
+constexpr std::array< std::int8_t, 256 > s_apiFunctionSlots = { {
+	-1, -1, 16, -1, 2, -1, -1, -1, -1, -1, -1, -1, -1, 12, -1, 3, -1, -1, 11, -1, -1, -1, -1, -1,
+	-1, -1, -1, 6, 20, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 38, -1, -1, -1, -1, 17, -1, -1,
+	-1, -1, -1, -1, -1, -1, 40, -1, -1, -1, -1, -1, -1, -1, -1, 44, -1, -1, -1, 1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, 7, -1, 21, -1, -1, -1, -1, -1, -1, -1, -1, -1, 29, -1, -1, -1, -1, -1, 26,
+	-1, -1, -1, -1, 32, -1, -1, -1, 36, -1, 27, -1, 24, 43, 34, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, 23, -1, -1, -1, -1, -1, -1, -1, -1, -1, 42, -1, 33, -1, 8,
+	-1, 10, 5, -1, -1, -1, -1, -1, 37, 41, -1, -1, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, 9, -1, -1, -1, -1, -1, 18, -1, 35, -1, -1, 0, -1, -1, -1, -1,
+	-1, -1, -1, -1, 31, -1, -1, 39, -1, -1, -1, -1, -1, 28, -1, -1, 22, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, 30, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 19, -1, -1, -1, 14, -1, -1,
+	25, -1, -1, -1, -1, 15, -1, -1, -1, -1, 4, -1, -1, -1, -1, -1
+} };
+
+const APIFunction *findAPIFunction(std::string_view name) {
+	const std::int8_t index =
+		s_apiFunctionSlots[hashFunctionName(name, API_FUNCTION_HASH_SEED) % s_apiFunctionSlots.size()];
+
+	// Names that aren't known might end up in the slot of another function
+	if (index < 0 || s_apiFunctions[index].name != name) {
+		return nullptr;
+	}
+
+	return &s_apiFunctions[index];
 }
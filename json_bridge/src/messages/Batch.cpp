@@ -0,0 +1,70 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+#include "mumble/json_bridge/messages/Batch.h"
+#include "mumble/json_bridge/messages/APICall.h"
+
+namespace Mumble {
+namespace JsonBridge {
+	namespace Messages {
+
+		Batch::Batch(const MumbleAPI &api, const nlohmann::json &msg, const ServerState *serverState)
+			: Message(MessageType::BATCH), m_api(api), m_serverState(serverState) {
+			MESSAGE_ASSERT_FIELD(msg, "calls", array);
+
+			for (const nlohmann::json &current : msg["calls"]) {
+				if (!current.is_object()) {
+					throw InvalidMessageException("The entries of the \"calls\" field are expected to be objects");
+				}
+			}
+
+			if (msg.contains("stop_on_error")) {
+				MESSAGE_ASSERT_FIELD(msg, "stop_on_error", boolean);
+
+				m_stopOnError = msg["stop_on_error"].get< bool >();
+			}
+
+			m_calls = msg["calls"];
+		}
+
+		void Batch::write(ResponseWriter &writer) const {
+			writer.raw(R"("response_type":"batch","response":{"results":[)");
+
+			std::size_t executed = 0;
+			for (const nlohmann::json &current : m_calls) {
+				if (executed > 0) {
+					writer.raw(",");
+				}
+				executed++;
+
+				// The secret is part of the batch's response already, so the entries don't repeat it
+				bool succeeded;
+				try {
+					APICall call(m_api, current, m_serverState);
+
+					writer.raw("{");
+					succeeded = call.write(writer);
+					writer.raw("}");
+				} catch (const InvalidMessageException &e) {
+					writer.raw(R"({"response_type":"error","response":{"error_message":)");
+					writer.string(e.what());
+					writer.raw("}}");
+
+					succeeded = false;
+				}
+
+				if (!succeeded && m_stopOnError) {
+					break;
+				}
+			}
+
+			writer.raw(R"(],"executed":)");
+			writer.value(executed);
+			writer.raw("}");
+		}
+
+	}; // namespace Messages
+};     // namespace JsonBridge
+};     // namespace Mumble
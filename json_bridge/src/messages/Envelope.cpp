@@ -0,0 +1,159 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+#include "mumble/json_bridge/messages/Envelope.h"
+#include "mumble/json_bridge/messages/JSONTextReader.h"
+#include "mumble/json_bridge/messages/Message.h"
+
+#include <string>
+
+#include <boost/algorithm/string.hpp>
+
+namespace Mumble {
+namespace JsonBridge {
+	namespace Messages {
+
+		namespace {
+			/**
+			 * SAX handler that reads the envelope fields of a message and makes the JSONTextReader skip everything
+			 * else. Envelope fields with values of the wrong type are left empty, so that processing the message
+			 * reports them.
+			 */
+			class EnvelopeReader {
+			public:
+				explicit EnvelopeReader(Envelope &envelope) : m_envelope(envelope) {}
+
+				bool null() { return m_started; }
+
+				bool boolean(bool) { return m_started; }
+
+				bool number_integer(std::int64_t val) {
+					if (currentField() == Field::REQUEST_ID) {
+						m_envelope.requestID = val;
+					}
+
+					return m_started;
+				}
+
+				bool number_unsigned(std::uint64_t val) {
+					if (currentField() == Field::CLIENT_ID) {
+						m_envelope.clientID = val;
+					} else if (currentField() == Field::REQUEST_ID) {
+						m_envelope.requestID = val;
+					}
+
+					return m_started;
+				}
+
+				bool number_float(double) { return m_started; }
+
+				bool string(std::string_view val) {
+					switch (currentField()) {
+						case Field::MESSAGE_TYPE:
+							m_envelope.messageType = val;
+							break;
+						case Field::SECRET:
+							m_envelope.secret = val;
+							break;
+						case Field::REQUEST_ID:
+							m_envelope.requestID = std::string(val);
+							break;
+						default:
+							break;
+					}
+
+					return m_started;
+				}
+
+				bool start_object() {
+					if (m_started) {
+						m_nesting++;
+					}
+
+					m_started = true;
+					return true;
+				}
+
+				bool key(std::string_view val) {
+					if (m_nesting > 0) {
+						// The key belongs to an object nested into one of the envelope fields
+						return true;
+					}
+
+					// Later occurrences of a field replace earlier ones, just like they do for nlohmann::json
+					if (val == "message_type") {
+						m_field                = Field::MESSAGE_TYPE;
+						m_envelope.messageType = std::string_view();
+					} else if (val == "client_id") {
+						m_field = Field::CLIENT_ID;
+						m_envelope.clientID.reset();
+					} else if (val == "secret") {
+						m_field              = Field::SECRET;
+						m_envelope.hasSecret = true;
+						m_envelope.secret.reset();
+					} else if (val == "request_id") {
+						m_field              = Field::REQUEST_ID;
+						m_envelope.requestID = nullptr;
+					} else {
+						m_field = Field::OTHER;
+					}
+
+					return true;
+				}
+
+				bool skipValue() const { return currentField() == Field::OTHER; }
+
+				bool end_object() {
+					if (m_nesting > 0) {
+						m_nesting--;
+					}
+
+					return true;
+				}
+
+				bool start_array() {
+					m_nesting++;
+
+					return m_started;
+				}
+
+				bool end_array() {
+					m_nesting--;
+
+					return true;
+				}
+
+			private:
+				enum class Field { MESSAGE_TYPE, CLIENT_ID, SECRET, REQUEST_ID, OTHER };
+
+				/**
+				 * @returns The envelope field the value that is read next belongs to
+				 */
+				Field currentField() const { return m_nesting == 0 ? m_field : Field::OTHER; }
+
+				Envelope &m_envelope;
+				bool m_started = false;
+				Field m_field  = Field::OTHER;
+				/**
+				 * How deep the value that is read next is nested into the envelope field it belongs to
+				 */
+				int m_nesting = 0;
+			};
+		}; // namespace
+
+		bool Envelope::isRegistration() const {
+			return boost::iequals(messageType, to_string(MessageType::REGISTRATION));
+		}
+
+		bool readEnvelope(std::string_view message, Envelope &envelope, Arena &arena) {
+			envelope = Envelope();
+
+			EnvelopeReader reader(envelope);
+
+			return JSONTextReader< EnvelopeReader >(message, reader, arena).read();
+		}
+	}; // namespace Messages
+};     // namespace JsonBridge
+};     // namespace Mumble
@@ -19,6 +19,12 @@ namespace JsonBridge {
 					return "api_call";
 				case MessageType::DISCONNECT:
 					return "disconnect";
+				case MessageType::BATCH:
+					return "batch";
+				case MessageType::SUBSCRIBE:
+					return "subscribe";
+				case MessageType::UNSUBSCRIBE:
+					return "unsubscribe";
 			}
 
 			throw std::invalid_argument(std::string("Unknown message type \"")
@@ -32,6 +38,12 @@ namespace JsonBridge {
 				return MessageType::API_CALL;
 			} else if (boost::iequals(type, "disconnect")) {
 				return MessageType::DISCONNECT;
+			} else if (boost::iequals(type, "batch")) {
+				return MessageType::BATCH;
+			} else if (boost::iequals(type, "subscribe")) {
+				return MessageType::SUBSCRIBE;
+			} else if (boost::iequals(type, "unsubscribe")) {
+				return MessageType::UNSUBSCRIBE;
 			} else {
 				throw std::invalid_argument(std::string("Unknown message type \"") + type + "\"");
 			}
@@ -60,6 +72,20 @@ namespace JsonBridge {
 			return type;
 		}
 
+		nlohmann::json parseRequestID(const nlohmann::json &msg) {
+			if (!msg.is_object() || !msg.contains("request_id")) {
+				return nullptr;
+			}
+
+			const nlohmann::json &requestID = msg["request_id"];
+
+			if (!requestID.is_string() && !requestID.is_number_integer()) {
+				throw InvalidMessageException("The \"request_id\" field has to be a string or an integer");
+			}
+
+			return requestID;
+		}
+
 		Message::Message(MessageType type) : m_type(type) {}
 
 		Message::~Message() {}
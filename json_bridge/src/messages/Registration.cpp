@@ -10,11 +10,55 @@ namespace JsonBridge {
 	namespace Messages {
 
 		Registration::Registration(const nlohmann::json &msg) : Message(MessageType::REGISTRATION) {
+			if (msg.contains("transport")) {
+				MESSAGE_ASSERT_FIELD(msg, "transport", string);
+
+				const std::string transport = msg["transport"].get< std::string >();
+				if (transport == "shared_memory") {
+					m_sharedMemory = true;
+				} else if (transport == "socket") {
+					m_socket = true;
+				} else if (transport != "named_pipe") {
+					throw InvalidMessageException(std::string("The given transport \"") + transport + "\" is unknown");
+				}
+			}
+
+			if (msg.contains("encoding")) {
+				MESSAGE_ASSERT_FIELD(msg, "encoding", string);
+
+				try {
+					m_encoding = encoding_from_string(msg["encoding"].get< std::string >());
+				} catch (const std::invalid_argument &) {
+					throw InvalidMessageException(std::string("The given encoding \"")
+												  + msg["encoding"].get< std::string >() + "\" is unknown");
+				}
+
+				m_encodingRequested = true;
+			}
+
+			if (m_sharedMemory || m_socket) {
+				// The client is known by the socket connection the registration arrived on
+				return;
+			}
+
 			MESSAGE_ASSERT_FIELD(msg, "pipe_path", string);
 			MESSAGE_ASSERT_FIELD(msg, "secret", string);
 
 			m_pipePath = msg["pipe_path"].get< std::string >();
 			m_secret   = msg["secret"].get< std::string >();
+
+			if (msg.contains("framing")) {
+				MESSAGE_ASSERT_FIELD(msg, "framing", string);
+
+				try {
+					m_framing = framing_from_string(msg["framing"].get< std::string >());
+				} catch (const std::invalid_argument &) {
+					throw InvalidMessageException(std::string("The given framing \"")
+												  + msg["framing"].get< std::string >() + "\" is unknown");
+				}
+
+				m_framingRequested = true;
+			}
 		}
 
 	}; // namespace Messages
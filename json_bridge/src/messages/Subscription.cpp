@@ -0,0 +1,52 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+#include "mumble/json_bridge/messages/Subscription.h"
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+namespace Mumble {
+namespace JsonBridge {
+	namespace Messages {
+
+		Subscription::Subscription(MessageType type, const nlohmann::json &msg) : Message(type) {
+			MESSAGE_ASSERT_FIELD(msg, "topics", array);
+
+			for (const nlohmann::json &topic : msg["topics"]) {
+				if (!topic.is_string()) {
+					throw InvalidMessageException("The \"topics\" field is expected to only contain strings");
+				}
+
+				try {
+					m_topics.set(static_cast< std::size_t >(topic_from_string(topic.get< std::string >())));
+				} catch (const std::invalid_argument &) {
+					throw InvalidMessageException(std::string("The given topic \"") + topic.get< std::string >()
+												  + "\" is unknown");
+				}
+			}
+
+			if (msg.contains("talking_state_window")) {
+				MESSAGE_ASSERT_FIELD(msg, "talking_state_window", number_unsigned);
+
+				m_talkingStateWindow = std::chrono::milliseconds(msg["talking_state_window"].get< std::uint32_t >());
+			}
+
+			if (msg.contains("talking_state_max_rate")) {
+				MESSAGE_ASSERT_FIELD(msg, "talking_state_max_rate", number);
+
+				m_maxTalkingStateRate = msg["talking_state_max_rate"].get< double >();
+				if (*m_maxTalkingStateRate < 0) {
+					throw InvalidMessageException("The \"talking_state_max_rate\" field must not be negative");
+				}
+			}
+		}
+
+		bool Subscription::isSubscribe() const noexcept { return m_type == MessageType::SUBSCRIBE; }
+
+	}; // namespace Messages
+};     // namespace JsonBridge
+};     // namespace Mumble
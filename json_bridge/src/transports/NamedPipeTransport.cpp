@@ -0,0 +1,398 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+#include "mumble/json_bridge/transports/NamedPipeTransport.h"
+
+#include <chrono>
+#include <iostream>
+
+namespace Mumble {
+namespace JsonBridge {
+	namespace Transports {
+
+		// How long we wait for the remainder of a partially received message before giving up on it
+		constexpr std::chrono::milliseconds PARTIAL_MESSAGE_TIMEOUT(1000);
+
+		NamedPipeConnection::NamedPipeConnection(const std::filesystem::path &writePath, Framing framing)
+			: m_writer(writePath), m_framing(framing) {}
+
+		NamedPipeConnection::NamedPipeConnection(const std::filesystem::path &writePath, NamedPipe readPipe,
+												 Framing framing)
+			: m_writer(writePath), m_reader(std::move(readPipe)), m_framing(framing) {
+			// Keep our pipe open so that the other end can always write to it right away
+			m_reader.openPersistentReader();
+		}
+
+		NamedPipeConnection::~NamedPipeConnection() { unwatch(); }
+
+		bool NamedPipeConnection::open() { return m_writer.open(); }
+
+		const std::filesystem::path &NamedPipeConnection::getWritePath() const noexcept { return m_writer.getPath(); }
+
+#ifdef PLATFORM_UNIX
+		Status NamedPipeConnection::trySend(std::string_view data, std::size_t &sent) {
+			// Writing might close (and reopen) the pipe's handle, so it can't stay registered in the meantime
+			if (m_watchedWriteHandle != -1) {
+				m_loop->unwatch(m_watchedWriteHandle);
+				m_watchedWriteHandle = -1;
+			}
+
+			sent = m_writer.tryWrite(data);
+
+			updateWriteWatch();
+
+			if (sent == data.size()) {
+				return Status::OK;
+			}
+
+			return m_writer.isOpen() ? Status::WOULD_BLOCK : Status::NO_PEER;
+		}
+
+		Status NamedPipeConnection::tryReceive(std::string_view &message) {
+			if (!m_reader) {
+				return Status::WOULD_BLOCK;
+			}
+
+			if (m_receivedMessages.empty() && m_discardedMessages.empty()) {
+				for (std::string_view current : m_reader.read_available_frames()) {
+					m_receivedMessages.emplace_back(current);
+				}
+				for (DiscardedFrame &current : m_reader.takeDiscardedFrames()) {
+					m_discardedMessages.push_back(std::move(current));
+				}
+
+				if (m_receivedMessages.empty() && m_discardedMessages.empty()) {
+					return Status::WOULD_BLOCK;
+				}
+			}
+
+			if (!m_discardedMessages.empty()) {
+				m_currentMessage = std::move(m_discardedMessages.front().envelope);
+				m_discardedMessages.pop_front();
+
+				message = m_currentMessage;
+
+				return Status::DISCARDED;
+			}
+
+			m_currentMessage = std::move(m_receivedMessages.front());
+			m_receivedMessages.pop_front();
+
+			message = m_currentMessage;
+
+			return Status::OK;
+		}
+
+		void NamedPipeConnection::watch(EventLoop &loop, std::function< void() > onReadable,
+										std::function< void() > onWritable) {
+			unwatch();
+
+			m_loop       = &loop;
+			m_onReadable = std::move(onReadable);
+			m_onWritable = std::move(onWritable);
+
+			updateReadWatch();
+			updateWriteWatch();
+		}
+
+		void NamedPipeConnection::setWriteInterest(bool interested) {
+			m_writeInterest = interested;
+
+			updateWriteWatch();
+		}
+
+		void NamedPipeConnection::setReadInterest(bool interested) {
+			m_readInterest = interested;
+
+			updateReadWatch();
+		}
+
+		void NamedPipeConnection::unwatch() noexcept {
+			if (!m_loop) {
+				return;
+			}
+
+			if (m_watchedWriteHandle != -1) {
+				m_loop->unwatch(m_watchedWriteHandle);
+				m_watchedWriteHandle = -1;
+			}
+			if (m_watchedReadHandle != -1) {
+				m_loop->unwatch(m_watchedReadHandle);
+				m_watchedReadHandle = -1;
+			}
+
+			m_loop       = nullptr;
+			m_onReadable = nullptr;
+			m_onWritable = nullptr;
+		}
+
+		void NamedPipeConnection::updateReadWatch() {
+			int desiredHandle = m_loop && m_readInterest && m_reader ? m_reader.getReadHandle() : -1;
+
+			if (desiredHandle == m_watchedReadHandle) {
+				return;
+			}
+
+			if (m_watchedReadHandle != -1) {
+				m_loop->unwatch(m_watchedReadHandle);
+			}
+
+			m_watchedReadHandle = desiredHandle;
+
+			if (m_watchedReadHandle != -1) {
+				// The callback is copied, as it might end up destroying this connection
+				m_loop->watch(m_watchedReadHandle, EventLoop::READABLE,
+							  [onReadable = m_onReadable](std::uint32_t) { onReadable(); });
+			}
+		}
+
+		void NamedPipeConnection::updateWriteWatch() {
+			int desiredHandle = m_loop && m_writeInterest ? m_writer.getHandle() : -1;
+
+			if (desiredHandle == m_watchedWriteHandle) {
+				return;
+			}
+
+			if (m_watchedWriteHandle != -1) {
+				m_loop->unwatch(m_watchedWriteHandle);
+			}
+
+			m_watchedWriteHandle = desiredHandle;
+
+			if (m_watchedWriteHandle != -1) {
+				m_loop->watch(m_watchedWriteHandle, EventLoop::WRITABLE, [this](std::uint32_t) {
+					// The callback might end up destroying this connection
+					std::function< void() > callback = m_onWritable;
+					callback();
+				});
+			}
+		}
+#else
+		Status NamedPipeConnection::trySend(std::string_view data, std::size_t &sent) {
+			// On Windows there is no way of waiting for the pipe to become writable, so the data is written
+			// synchronously
+			try {
+				m_writer.write(std::string(data), 1000);
+			} catch (const TimeoutException &) {
+				sent = 0;
+
+				return Status::NO_PEER;
+			}
+
+			sent = data.size();
+
+			return Status::OK;
+		}
+
+		Status NamedPipeConnection::tryReceive(std::string_view &message) {
+			if (!m_reader) {
+				return Status::WOULD_BLOCK;
+			}
+
+			if (m_receivedMessages.empty() && m_discardedMessages.empty()) {
+				try {
+					for (std::string &current : m_reader.read_frames(0)) {
+						m_receivedMessages.push_back(std::move(current));
+					}
+				} catch (const TimeoutException &) {
+					// There is no complete message available (but there might be discarded ones)
+				}
+
+				for (DiscardedFrame &current : m_reader.takeDiscardedFrames()) {
+					m_discardedMessages.push_back(std::move(current));
+				}
+
+				if (m_receivedMessages.empty() && m_discardedMessages.empty()) {
+					return Status::WOULD_BLOCK;
+				}
+			}
+
+			if (!m_discardedMessages.empty()) {
+				m_currentMessage = std::move(m_discardedMessages.front().envelope);
+				m_discardedMessages.pop_front();
+
+				message = m_currentMessage;
+
+				return Status::DISCARDED;
+			}
+
+			m_currentMessage = std::move(m_receivedMessages.front());
+			m_receivedMessages.pop_front();
+
+			message = m_currentMessage;
+
+			return Status::OK;
+		}
+
+		void NamedPipeConnection::watch(EventLoop &, std::function< void() >, std::function< void() >) {
+			// The loop can't wait for pipes on Windows. Writes are synchronous anyway.
+		}
+
+		void NamedPipeConnection::setWriteInterest(bool) {}
+
+		void NamedPipeConnection::setReadInterest(bool) {}
+
+		void NamedPipeConnection::unwatch() noexcept {}
+#endif
+
+		void NamedPipeConnection::send(std::string_view message, unsigned int timeout) {
+			m_writer.write(std::string(message), timeout, m_framing);
+		}
+
+		std::string NamedPipeConnection::receive(unsigned int timeout) {
+			if (m_receivedMessages.empty()) {
+				for (std::string &current : m_reader.read_frames(timeout)) {
+					m_receivedMessages.push_back(std::move(current));
+				}
+			}
+
+			std::string message = std::move(m_receivedMessages.front());
+			m_receivedMessages.pop_front();
+
+			return message;
+		}
+
+
+		NamedPipeListener::NamedPipeListener(const std::filesystem::path &path, std::size_t maxMessageSize)
+			: m_path(path), m_maxMessageSize(maxMessageSize) {}
+
+		NamedPipeListener::~NamedPipeListener() { stop(); }
+
+		void NamedPipeListener::start(EventLoop &loop, connection_callback_t, message_callback_t onMessages,
+									  discard_callback_t onDiscarded) {
+			m_pipe = NamedPipe::create(m_path);
+			m_pipe.setMaxFrameSize(m_maxMessageSize);
+
+			// Keep the pipe open for as long as the listener is running so that clients never have to wait for us to
+			// reopen it between two messages
+			m_pipe.openPersistentReader();
+
+			m_loop        = &loop;
+			m_onMessages  = std::move(onMessages);
+			m_onDiscarded = std::move(onDiscarded);
+
+#ifdef PLATFORM_UNIX
+			m_loop->watch(m_pipe.getReadHandle(), EventLoop::READABLE, [this](std::uint32_t) { onReadable(); });
+			m_readInterest = true;
+#else
+			m_readerThread = boost::thread(&NamedPipeListener::readPipe, this);
+#endif
+		}
+
+		void NamedPipeListener::stop() noexcept {
+			if (!m_loop) {
+				return;
+			}
+
+#ifdef PLATFORM_UNIX
+			m_loop->unwatch(m_pipe.getReadHandle());
+			m_readInterest = false;
+
+			if (m_partialMessageTimerActive) {
+				m_loop->cancelTimer(m_partialMessageTimer);
+				m_partialMessageTimerActive = false;
+			}
+#else
+			if (m_readerThread.joinable()) {
+				m_readerThread.interrupt();
+				m_readerThread.join();
+			}
+#endif
+
+			m_loop = nullptr;
+
+			try {
+				m_pipe.destroy();
+			} catch (const std::exception &e) {
+				std::cerr << "Mumble-JSON-Bridge: Can't destroy pipe " << m_path << ": " << e.what() << std::endl;
+			}
+		}
+
+		std::string NamedPipeListener::getAddress() const { return m_path.string(); }
+
+		void NamedPipeListener::reportDiscardedMessages() {
+			for (const DiscardedFrame &current : m_pipe.takeDiscardedFrames()) {
+				m_onDiscarded(current);
+			}
+		}
+
+#ifdef PLATFORM_UNIX
+		void NamedPipeListener::setReadInterest(bool interested) {
+			if (!m_loop || interested == m_readInterest) {
+				return;
+			}
+
+			m_readInterest = interested;
+
+			// The pipe's readiness is level-triggered, so whatever has been written in the meantime is reported once
+			// the pipe is watched again
+			if (m_readInterest) {
+				m_loop->watch(m_pipe.getReadHandle(), EventLoop::READABLE, [this](std::uint32_t) { onReadable(); });
+			} else {
+				m_loop->unwatch(m_pipe.getReadHandle());
+			}
+		}
+
+		void NamedPipeListener::onReadable() {
+			// A single read may yield multiple messages (e.g. if a client pipelines its requests or multiple clients
+			// have written at the same time). These are processed back-to-back.
+			m_onMessages(m_pipe.read_available_frames());
+			reportDiscardedMessages();
+
+			if (m_partialMessageTimerActive) {
+				m_loop->cancelTimer(m_partialMessageTimer);
+				m_partialMessageTimerActive = false;
+			}
+
+			if (m_pipe.hasPartialFrame()) {
+				// We have only received the beginning of a message so far. If the rest of it doesn't arrive in time, we
+				// pass on what we have got, so that the problem can be reported instead of having the partial message
+				// prepended to whatever arrives next.
+				m_partialMessageTimer = m_loop->runAfter(PARTIAL_MESSAGE_TIMEOUT, [this]() {
+					m_partialMessageTimerActive = false;
+
+					std::string message = m_pipe.flushPartialFrame();
+
+					if (!message.empty()) {
+						m_onMessages({ message });
+					}
+					reportDiscardedMessages();
+				});
+				m_partialMessageTimerActive = true;
+			}
+		}
+#else
+		void NamedPipeListener::setReadInterest(bool) {
+			// The reader thread can't be paused. It keeps on posting the messages it receives.
+		}
+
+		void NamedPipeListener::readPipe() {
+			try {
+				while (true) {
+					std::vector< std::string > messages = m_pipe.read_frames();
+
+					std::vector< DiscardedFrame > discarded = m_pipe.takeDiscardedFrames();
+
+					m_loop->post([this, messages = std::move(messages), discarded = std::move(discarded)]() {
+						m_onMessages(std::vector< std::string_view >(messages.begin(), messages.end()));
+
+						for (const DiscardedFrame &current : discarded) {
+							m_onDiscarded(current);
+						}
+					});
+				}
+			} catch (const boost::thread_interrupted &) {
+				// We're being stopped
+			} catch (const std::exception &e) {
+				std::cerr << "Mumble-JSON-Bridge failed at reading from pipe: " << e.what() << std::endl;
+
+				m_loop->stop();
+			}
+		}
+#endif
+
+	}; // namespace Transports
+};     // namespace JsonBridge
+};     // namespace Mumble
@@ -0,0 +1,150 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+#include "mumble/json_bridge/transports/SharedMemoryTransport.h"
+#include "mumble/json_bridge/NamedPipe.h"
+
+#ifdef PLATFORM_UNIX
+#	include <iostream>
+
+namespace Mumble {
+namespace JsonBridge {
+	namespace Transports {
+
+		SharedMemoryConnection::SharedMemoryConnection(std::unique_ptr< Connection > control,
+													   SharedMemoryChannel channel)
+			: m_control(std::move(control)), m_channel(std::move(channel)) {}
+
+		SharedMemoryConnection::~SharedMemoryConnection() { unwatch(); }
+
+		const SharedMemoryChannel &SharedMemoryConnection::getChannel() const noexcept { return m_channel; }
+
+		Status SharedMemoryConnection::trySend(std::string_view data, std::size_t &sent) {
+			sent = 0;
+
+			if (m_closed) {
+				return Status::CLOSED;
+			}
+
+			if (!m_channel.trySend(data)) {
+				// The other end rings our doorbell once it has made room
+				return Status::WOULD_BLOCK;
+			}
+
+			sent = data.size();
+
+			return Status::OK;
+		}
+
+		void SharedMemoryConnection::send(std::string_view message, unsigned int timeout) {
+			m_channel.send(message, timeout);
+		}
+
+		Status SharedMemoryConnection::tryReceive(std::string_view &message) {
+			releasePeekedMessage();
+
+			try {
+				if (m_channel.peek(message)) {
+					m_peeked = true;
+
+					return Status::OK;
+				}
+			} catch (const PipeException< int > &e) {
+				// There is no way of communicating with the other end anymore
+				std::cerr << "Mumble-JSON-Bridge: Shared memory channel is corrupted: " << e.what() << std::endl;
+
+				m_closed = true;
+			}
+
+			if (m_closed) {
+				return Status::CLOSED;
+			}
+
+			// This is also how we find out about the other end going away
+			Status status = m_control->tryReceive(message);
+			if (status == Status::CLOSED) {
+				m_closed = true;
+			}
+
+			return status;
+		}
+
+		std::string SharedMemoryConnection::receive(unsigned int timeout) {
+			releasePeekedMessage();
+
+			return m_channel.receive(timeout);
+		}
+
+		void SharedMemoryConnection::watch(EventLoop &loop, std::function< void() > onReadable,
+										   std::function< void() > onWritable) {
+			unwatch();
+
+			m_loop = &loop;
+
+			m_control->watch(loop, onReadable, []() {});
+
+			auto callback = [this, onReadable = std::move(onReadable),
+							 onWritable = std::move(onWritable)](std::uint32_t) {
+				// The doorbell has to be reset before looking at the rings, so that no wakeup is lost
+				m_channel.resetDoorbell();
+
+				// The other end might have made room for the messages that didn't fit before. As the callbacks might
+				// end up destroying this connection, it must not be accessed afterwards.
+				const bool readable = m_readInterest;
+				if (m_writeInterest) {
+					onWritable();
+				}
+				if (readable) {
+					onReadable();
+				}
+			};
+
+			m_loop->watch(m_channel.getDoorbellHandle(), EventLoop::READABLE, std::move(callback));
+		}
+
+		void SharedMemoryConnection::setWriteInterest(bool interested) { m_writeInterest = interested; }
+
+		void SharedMemoryConnection::setReadInterest(bool interested) {
+			if (interested == m_readInterest) {
+				return;
+			}
+
+			m_readInterest = interested;
+
+			// The control connection only reports that the other end has gone away, which must not keep the loop busy
+			// either
+			m_control->setReadInterest(interested);
+
+			if (interested && m_loop) {
+				// The doorbell keeps being reset in the meantime, so the messages that have arrived would go unnoticed
+				m_channel.wakeSelf();
+			}
+		}
+
+		void SharedMemoryConnection::unwatch() noexcept {
+			if (m_loop) {
+				m_control->unwatch();
+				m_loop->unwatch(m_channel.getDoorbellHandle());
+
+				m_loop = nullptr;
+			}
+		}
+
+		void SharedMemoryConnection::resumeReading() noexcept {
+			// The other end only rings the doorbell if the ring has been empty before
+			m_channel.wakeSelf();
+		}
+
+		void SharedMemoryConnection::releasePeekedMessage() {
+			if (m_peeked) {
+				m_channel.pop();
+				m_peeked = false;
+			}
+		}
+
+	}; // namespace Transports
+};     // namespace JsonBridge
+};     // namespace Mumble
+#endif
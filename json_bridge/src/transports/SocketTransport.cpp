@@ -0,0 +1,185 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+#include "mumble/json_bridge/transports/SocketTransport.h"
+
+#ifdef PLATFORM_UNIX
+#	include <iostream>
+
+namespace Mumble {
+namespace JsonBridge {
+	namespace Transports {
+
+		SocketConnection::SocketConnection(SeqPacketSocket socket) : m_socket(std::move(socket)) {}
+
+		SocketConnection::~SocketConnection() { unwatch(); }
+
+		std::string SocketConnection::receive(std::vector< int > &handles, unsigned int timeout) {
+			return m_socket.receive(handles, timeout);
+		}
+
+		Status SocketConnection::trySend(std::string_view data, std::size_t &sent) {
+			// Each message is sent as a whole
+			if (m_socket.trySend(data)) {
+				sent = data.size();
+
+				return Status::OK;
+			}
+
+			sent = 0;
+
+			return m_socket.isConnected() ? Status::WOULD_BLOCK : Status::CLOSED;
+		}
+
+		void SocketConnection::send(std::string_view message, unsigned int timeout) {
+			m_socket.send(message, timeout);
+		}
+
+		Status SocketConnection::tryReceive(std::string_view &message) {
+			bool truncated;
+			if (m_socket.tryReceive(m_receiveBuffer, message, &truncated)) {
+				if (!truncated) {
+					return Status::OK;
+				}
+
+				// The rest of the message has been dropped by the kernel already. Its envelope is all that is needed in
+				// order to report the problem.
+				EnvelopeCapture capture;
+				capture.feed(message);
+
+				m_discardedEnvelope = capture.getEnvelope();
+				message             = m_discardedEnvelope;
+
+				return Status::DISCARDED;
+			}
+
+			return m_socket.isConnected() ? Status::WOULD_BLOCK : Status::CLOSED;
+		}
+
+		std::string SocketConnection::receive(unsigned int timeout) { return m_socket.receive(timeout); }
+
+		void SocketConnection::watch(EventLoop &loop, std::function< void() > onReadable,
+									 std::function< void() > onWritable) {
+			unwatch();
+
+			m_loop = &loop;
+
+			// The callbacks are captured by value, as the first one might end up destroying this connection. For the
+			// same reason, the interest in readability is looked at before invoking any of them.
+			auto callback = [this, onReadable = std::move(onReadable),
+							 onWritable = std::move(onWritable)](std::uint32_t events) {
+				// A hung up socket is reported as readable even if readability isn't watched for
+				const bool readable = (events & EventLoop::READABLE) && m_readInterest;
+
+				if (events & EventLoop::WRITABLE) {
+					onWritable();
+				}
+				if (readable) {
+					onReadable();
+				}
+			};
+
+			m_loop->watch(m_socket.getHandle(), getWatchedEvents(), std::move(callback));
+		}
+
+		std::uint32_t SocketConnection::getWatchedEvents() const noexcept {
+			std::uint32_t events = 0;
+			if (m_readInterest) {
+				events |= EventLoop::READABLE;
+			}
+			if (m_writeInterest) {
+				events |= EventLoop::WRITABLE;
+			}
+
+			return events;
+		}
+
+		void SocketConnection::setWriteInterest(bool interested) {
+			if (interested == m_writeInterest) {
+				return;
+			}
+
+			m_writeInterest = interested;
+
+			if (m_loop) {
+				m_loop->modifyWatch(m_socket.getHandle(), getWatchedEvents());
+			}
+		}
+
+		void SocketConnection::setReadInterest(bool interested) {
+			if (interested == m_readInterest) {
+				return;
+			}
+
+			m_readInterest = interested;
+
+			// The socket's readiness is level-triggered, so whatever has arrived in the meantime is reported once the
+			// socket is watched for it again
+			if (m_loop) {
+				m_loop->modifyWatch(m_socket.getHandle(), getWatchedEvents());
+			}
+		}
+
+		void SocketConnection::unwatch() noexcept {
+			if (m_loop) {
+				m_loop->unwatch(m_socket.getHandle());
+				m_loop = nullptr;
+			}
+		}
+
+		bool SocketConnection::canPassHandles() const noexcept { return true; }
+
+		Status SocketConnection::trySendWithHandles(std::string_view message, const std::vector< int > &handles) {
+			if (m_socket.trySend(message, handles)) {
+				return Status::OK;
+			}
+
+			return m_socket.isConnected() ? Status::WOULD_BLOCK : Status::CLOSED;
+		}
+
+
+		SocketListener::SocketListener(const std::string &address) : m_address(address) {}
+
+		SocketListener::~SocketListener() { stop(); }
+
+		void SocketListener::start(EventLoop &loop, connection_callback_t onConnection, message_callback_t,
+								   discard_callback_t) {
+			m_listener = SeqPacketListener::listen(m_address);
+
+			m_loop         = &loop;
+			m_onConnection = std::move(onConnection);
+
+			m_loop->watch(m_listener.getHandle(), EventLoop::READABLE, [this](std::uint32_t) { onAcceptable(); });
+		}
+
+		void SocketListener::stop() noexcept {
+			if (!m_loop) {
+				return;
+			}
+
+			m_loop->unwatch(m_listener.getHandle());
+			m_loop = nullptr;
+
+			m_listener.close();
+		}
+
+		std::string SocketListener::getAddress() const { return m_address; }
+
+		void SocketListener::onAcceptable() {
+			SeqPacketSocket socket;
+			while ((socket = m_listener.accept()).isOpen()) {
+				if (!socket.peerIsSameUser()) {
+					std::cerr << "Mumble-JSON-Bridge: Rejecting socket connection from a different user" << std::endl;
+					continue;
+				}
+
+				m_onConnection(std::make_unique< SocketConnection >(std::move(socket)));
+			}
+		}
+
+	}; // namespace Transports
+};     // namespace JsonBridge
+};     // namespace Mumble
+#endif
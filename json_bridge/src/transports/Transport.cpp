@@ -0,0 +1,27 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+#include "mumble/json_bridge/transports/Transport.h"
+#include "mumble/json_bridge/NamedPipe.h"
+
+#include <cerrno>
+
+namespace Mumble {
+namespace JsonBridge {
+	namespace Transports {
+
+		void Listener::setReadInterest(bool) {
+			// Only listeners that receive messages themselves have anything to pause
+		}
+
+#ifdef PLATFORM_UNIX
+		Status Connection::trySendWithHandles(std::string_view, const std::vector< int > &) {
+			throw PipeException< int >(ENOTSUP, "Send with handles");
+		}
+#endif
+
+	}; // namespace Transports
+};     // namespace JsonBridge
+};     // namespace Mumble
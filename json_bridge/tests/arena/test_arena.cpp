@@ -0,0 +1,95 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+#include "gtest/gtest.h"
+
+#include <mumble/json_bridge/Arena.h>
+
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Mumble::JsonBridge;
+
+TEST(Arena, alignment) {
+	Arena arena(64);
+
+	for (std::size_t alignment : { 1, 2, 8, 16, 64 }) {
+		// An odd-sized allocation in between makes sure that the next one actually has to be aligned
+		EXPECT_NE(arena.allocate(3, 1), nullptr);
+
+		void *ptr = arena.allocate(24, alignment);
+		EXPECT_EQ(reinterpret_cast< std::uintptr_t >(ptr) % alignment, 0u) << "Alignment " << alignment;
+	}
+}
+
+TEST(Arena, resetReusesMemory) {
+	Arena arena(1024);
+
+	ASSERT_EQ(arena.getCapacity(), 0u) << "Memory is allocated lazily";
+
+	void *first = arena.allocate(100, 8);
+	void *second = arena.allocate(100, 8);
+	EXPECT_NE(first, second);
+
+	arena.reset();
+
+	EXPECT_EQ(arena.allocate(100, 8), first);
+	EXPECT_EQ(arena.getBlockCount(), 1u);
+	EXPECT_EQ(arena.getCapacity(), 1024u);
+}
+
+TEST(Arena, growsAndMergesBlocks) {
+	Arena arena(128);
+
+	// Exceeds the first block several times over
+	for (int i = 0; i < 10; i++) {
+		EXPECT_NE(arena.allocate(100, 1), nullptr);
+	}
+
+	ASSERT_GT(arena.getBlockCount(), 1u);
+	std::size_t capacity = arena.getCapacity();
+	ASSERT_GE(capacity, 1000u);
+
+	arena.reset();
+
+	EXPECT_EQ(arena.getBlockCount(), 1u);
+	EXPECT_EQ(arena.getCapacity(), capacity);
+
+	// The same amount of data now fits into the merged block
+	for (int i = 0; i < 10; i++) {
+		EXPECT_NE(arena.allocate(100, 1), nullptr);
+	}
+
+	EXPECT_EQ(arena.getBlockCount(), 1u);
+
+	// Allocations larger than the arena's blocks are possible as well
+	char *large = static_cast< char * >(arena.allocate(10 * capacity, 1));
+	large[10 * capacity - 1] = 'x';
+	EXPECT_EQ(arena.getBlockCount(), 2u);
+}
+
+TEST(Arena, pmrContainers) {
+	Arena arena;
+
+	std::pmr::vector< std::pmr::string > strings(&arena);
+	for (int i = 0; i < 100; i++) {
+		strings.emplace_back("A string that is too long for the small string optimization #" + std::to_string(i));
+	}
+
+	EXPECT_EQ(strings.back(), "A string that is too long for the small string optimization #99");
+	EXPECT_EQ(strings.front().get_allocator().resource(), &arena);
+}
+
+TEST(Arena, threadLocal) {
+	Arena *mainArena = &Arena::forThisThread();
+	Arena *otherArena = nullptr;
+
+	std::thread([&]() { otherArena = &Arena::forThisThread(); }).join();
+
+	EXPECT_EQ(&Arena::forThisThread(), mainArena);
+	EXPECT_NE(otherArena, mainArena);
+}
@@ -0,0 +1,135 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+// Measures the cost of looking up the API function requested by an API call for the first and the last function in
+// the list of API functions, once by searching the set of all functions and the set of functions without parameters
+// followed by a chain of string comparisons (the way the Bridge used to operate) and once via the generated function
+// table.
+//
+// Usage: bench_apiDispatch [lookupsPerRun]
+
+#include <mumble/json_bridge/messages/APICall.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+using namespace Mumble::JsonBridge;
+
+// All API functions in the order in which they used to be compared
+const std::vector< std::string > functionNames = { "freeMemory",
+												   "getActiveServerConnection",
+												   "isConnectionSynchronized",
+												   "getLocalUserID",
+												   "getUserName",
+												   "getChannelName",
+												   "getAllUsers",
+												   "getAllChannels",
+												   "getChannelOfUser",
+												   "getUsersInChannel",
+												   "getLocalUserTransmissionMode",
+												   "isUserLocallyMuted",
+												   "isLocalUserMuted",
+												   "isLocalUserDeafened",
+												   "getUserHash",
+												   "getServerHash",
+												   "getUserComment",
+												   "getChannelDescription",
+												   "requestLocalUserTransmissionMode",
+												   "requestUserMove",
+												   "requestMicrophoneActivationOvewrite",
+												   "requestLocalMute",
+												   "requestLocalUserMute",
+												   "requestLocalUserDeaf",
+												   "requestSetLocalUserComment",
+												   "findUserByName",
+												   "findUserByName_noexcept",
+												   "findChannelByName",
+												   "findChannelByName_noexcept",
+												   "getMumbleSetting_bool",
+												   "getMumbleSetting_int",
+												   "getMumbleSetting_double",
+												   "getMumbleSetting_string",
+												   "setMumbleSetting_bool",
+												   "setMumbleSetting_int",
+												   "setMumbleSetting_double",
+												   "setMumbleSetting_string",
+												   "sendData",
+												   "log",
+												   "log_noexcept",
+												   "playSample" };
+
+const std::unordered_set< std::string > allFunctions(functionNames.begin(), functionNames.end());
+const std::unordered_set< std::string > noParamFunctions = { "getActiveServerConnection",
+															 "getLocalUserTransmissionMode", "isLocalUserMuted",
+															 "isLocalUserDeafened" };
+
+// Prevents the compiler from optimizing the lookups away
+volatile std::size_t sink = 0;
+
+/**
+ * Looks the given function up the way the Bridge used to do it
+ */
+std::size_t lookupChained(const std::string &name) {
+	if (allFunctions.count(name) == 0) {
+		return functionNames.size();
+	}
+
+	std::size_t result = noParamFunctions.count(name);
+
+	for (std::size_t i = 0; i < functionNames.size(); i++) {
+		if (name == functionNames[i]) {
+			return result + i;
+		}
+	}
+
+	return functionNames.size();
+}
+
+/**
+ * Looks the given function up via the generated function table
+ */
+std::size_t lookupTable(const std::string &name) {
+	const Messages::APIFunction *function = Messages::findAPIFunction(name);
+
+	return function ? function->parameterCount : functionNames.size();
+}
+
+/**
+ * @returns The average duration of a single lookup in nanoseconds
+ */
+template< typename Lookup > double runBenchmark(Lookup lookup, const std::string &name, std::size_t lookups) {
+	auto start = std::chrono::steady_clock::now();
+
+	for (std::size_t i = 0; i < lookups; i++) {
+		sink = sink + lookup(name);
+	}
+
+	auto end = std::chrono::steady_clock::now();
+
+	return std::chrono::duration< double, std::nano >(end - start).count() / lookups;
+}
+
+int main(int argc, char **argv) {
+	std::size_t lookups = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10 * 1000 * 1000;
+
+	std::cout << "Performing " << lookups << " lookups per run" << std::endl << std::endl;
+	std::cout << "Function                            | Sets + comparisons: ns/lookup | Function table: ns/lookup"
+			  << std::endl;
+
+	for (const std::string &name : { functionNames.front(), functionNames.back() }) {
+		double chained = runBenchmark(lookupChained, name, lookups);
+		double table   = runBenchmark(lookupTable, name, lookups);
+
+		std::printf("%-35s | %29.1f | %25.1f\n", name.c_str(), chained, table);
+		std::fflush(stdout);
+	}
+
+	return 0;
+}
@@ -0,0 +1,151 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+// Compares the encodings clients can negotiate with the Bridge: For a couple of typical messages it measures the size
+// of the encoded message (the bytes on the wire) and how long it takes to encode and decode it.
+//
+// Usage: bench_encodings [messagesPerRun]
+
+#include <mumble/json_bridge/Encoding.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+using namespace Mumble::JsonBridge;
+
+const std::string secret = "MyVerySecretSecret";
+
+// Prevents the compiler from optimizing the encoding away
+volatile std::size_t sink = 0;
+
+/**
+ * @returns A request to call getLocalUserID
+ */
+nlohmann::json smallRequest() {
+	// clang-format off
+	return {
+		{"message_type", "api_call"},
+		{"request_id", 42},
+		{"message",
+			{
+				{"function", "getLocalUserID"},
+				{"parameter",
+					{
+						{"connection", 1}
+					}
+				}
+			}
+		}
+	};
+	// clang-format on
+}
+
+/**
+ * @returns A request to call sendData with a payload of the given size
+ */
+nlohmann::json sendDataRequest(std::size_t payloadSize) {
+	std::vector< std::uint8_t > data;
+	for (std::size_t i = 0; i < payloadSize; i++) {
+		data.push_back(static_cast< std::uint8_t >(i * 31));
+	}
+
+	// clang-format off
+	return {
+		{"message_type", "api_call"},
+		{"request_id", 42},
+		{"message",
+			{
+				{"function", "sendData"},
+				{"parameter",
+					{
+						{"connection", 1},
+						{"receivers", {2, 3, 4}},
+						{"data", data},
+						{"data_id", "benchmark"}
+					}
+				}
+			}
+		}
+	};
+	// clang-format on
+}
+
+/**
+ * @returns The response to a getAllUsers call on a server with the given amount of users
+ */
+nlohmann::json getAllUsersResponse(std::size_t userCount) {
+	std::vector< std::uint32_t > users;
+	for (std::size_t i = 0; i < userCount; i++) {
+		users.push_back(static_cast< std::uint32_t >(i * 7919));
+	}
+
+	// clang-format off
+	return {
+		{"request_id", 42},
+		{"secret", secret},
+		{"response_type", "api_call"},
+		{"response",
+			{
+				{"function", "getAllUsers"},
+				{"status", "executed"},
+				{"return_value", users}
+			}
+		}
+	};
+	// clang-format on
+}
+
+/**
+ * @returns The average duration of the given operation in nanoseconds
+ */
+template< typename Operation > double measure(Operation operation, std::size_t iterations) {
+	auto start = std::chrono::steady_clock::now();
+
+	for (std::size_t i = 0; i < iterations; i++) {
+		operation();
+	}
+
+	auto end = std::chrono::steady_clock::now();
+
+	return std::chrono::duration< double, std::nano >(end - start).count() / iterations;
+}
+
+int main(int argc, char **argv) {
+	std::size_t messages = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10 * 1000;
+
+	const std::vector< std::pair< std::string, nlohmann::json > > samples = {
+		{ "getLocalUserID request", smallRequest() },
+		{ "sendData request (1 KiB)", sendDataRequest(1024) },
+		{ "getAllUsers response (100)", getAllUsersResponse(100) },
+		{ "getAllUsers response (5000)", getAllUsersResponse(5000) },
+	};
+
+	std::cout << "Encoding and decoding " << messages << " messages per run" << std::endl << std::endl;
+	std::cout << "Message                     | Encoding |  Bytes | Encode: ns/message | Decode: ns/message"
+			  << std::endl;
+
+	for (const auto &sample : samples) {
+		for (Encoding encoding : { Encoding::JSON, Encoding::CBOR, Encoding::MSGPACK }) {
+			const std::string encoded = encode(sample.second, encoding);
+
+			double encodeTime = measure([&]() { sink = sink + encode(sample.second, encoding).size(); }, messages);
+			double decodeTime = measure([&]() { sink = sink + decode(encoded, encoding).size(); }, messages);
+
+			std::printf("%-27s | %-8s | %6zu | %18.1f | %18.1f\n", sample.first.c_str(), to_string(encoding).c_str(),
+						encoded.size(), encodeTime, decodeTime);
+			std::fflush(stdout);
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,88 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+// Measures the cost of deciding that a message of an unknown client has to be discarded, once by parsing the entire
+// message into a JSON DOM (the way the Bridge used to operate) and once by reading only the message's envelope. The
+// message carries a large body, as a process flooding the Bridge's named pipe would send.
+//
+// Usage: bench_envelope [messagesPerRun] [bodySize]
+
+#include <mumble/json_bridge/Arena.h>
+#include <mumble/json_bridge/messages/Envelope.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include <nlohmann/json.hpp>
+
+using namespace Mumble::JsonBridge;
+
+// Prevents the compiler from optimizing the parsing away
+volatile std::size_t sink = 0;
+
+/**
+ * @returns The average duration of handling a single message in microseconds
+ */
+template< typename Handle > double runBenchmark(Handle handle, std::size_t messages) {
+	auto start = std::chrono::steady_clock::now();
+
+	for (std::size_t i = 0; i < messages; i++) {
+		handle();
+	}
+
+	auto end = std::chrono::steady_clock::now();
+
+	return std::chrono::duration< double, std::micro >(end - start).count() / messages;
+}
+
+int main(int argc, char **argv) {
+	std::size_t messages = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000;
+	std::size_t bodySize = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 256 * 1024;
+
+	// A body consisting of many small values is what makes building the DOM expensive
+	std::string body = "{\"function\":\"log\",\"parameter\":{\"values\":[";
+	while (body.size() < bodySize) {
+		body += "{\"a\":1,\"b\":\"text\"},";
+	}
+	body += "{}]}}";
+
+	const std::string message =
+		"{\"client_id\":42,\"message\":" + body + ",\"message_type\":\"api_call\",\"secret\":\"MyVerySecretSecret\"}";
+
+	std::cout << "Discarding " << messages << " messages of " << message.size() << " bytes per run" << std::endl
+			  << std::endl;
+	std::cout << "Method    | us/message" << std::endl;
+
+	double dom = runBenchmark(
+		[&message]() {
+			nlohmann::json msg = nlohmann::json::parse(message);
+
+			sink = sink + msg["client_id"].get< std::size_t >();
+		},
+		messages);
+
+	double envelope = runBenchmark(
+		[&message]() {
+			Arena &arena = Arena::forThisThread();
+			arena.reset();
+
+			Messages::Envelope envelope;
+			if (!Messages::readEnvelope(message, envelope, arena)) {
+				std::cerr << "Failed to read the envelope" << std::endl;
+				std::exit(1);
+			}
+
+			sink = sink + *envelope.clientID;
+		},
+		messages);
+
+	std::printf("%-9s | %10.1f\n", "JSON DOM", dom);
+	std::printf("%-9s | %10.1f\n", "Envelope", envelope);
+
+	return 0;
+}
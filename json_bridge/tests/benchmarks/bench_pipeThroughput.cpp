@@ -0,0 +1,96 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+// Measures how many messages per second can be pushed through a NamedPipe, once with the reader reopening the pipe
+// for every read (the way the Bridge used to operate) and once in long-lived reader mode.
+//
+// Usage: bench_pipeThroughput [messageCount] [messageSize]
+
+#include <mumble/json_bridge/NamedPipe.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+#include <boost/thread/thread.hpp>
+
+#ifdef PLATFORM_UNIX
+#	define PIPEDIR "."
+#else
+#	define PIPEDIR "\\\\.\\pipe\\"
+#endif
+
+using namespace Mumble::JsonBridge;
+
+const std::filesystem::path pipePath = std::filesystem::path(PIPEDIR) / "benchmarkPipe";
+
+double runBenchmark(bool persistentReader, std::size_t messageCount, std::size_t messageSize) {
+	NamedPipe pipe = NamedPipe::create(pipePath);
+
+	if (persistentReader) {
+		pipe.openPersistentReader();
+	}
+
+	const std::string message(messageSize, 'x');
+	const std::size_t expectedBytes = messageCount * messageSize;
+
+	auto start = std::chrono::steady_clock::now();
+
+	std::atomic< std::size_t > readBytes(0);
+
+	// Like a client talking to the Bridge, the writer only sends its next message once the previous one has been
+	// consumed. This also prevents the writer from overflowing the pipe's buffer.
+	boost::thread writer([&]() {
+		try {
+			for (std::size_t i = 0; i < messageCount; i++) {
+				NamedPipe::write(pipePath, message, 10 * 1000);
+
+				while (readBytes.load() < (i + 1) * messageSize) {
+					boost::this_thread::yield();
+				}
+			}
+		} catch (const std::exception &e) {
+			std::cerr << "Writer failed: " << e.what() << std::endl;
+			std::exit(1);
+		}
+	});
+
+	// Multiple messages may be read in one go, so we only count bytes
+	while (readBytes.load() < expectedBytes) {
+		readBytes += pipe.read_blocking(10 * 1000).size();
+	}
+
+	writer.join();
+
+	auto end = std::chrono::steady_clock::now();
+
+	double seconds = std::chrono::duration< double >(end - start).count();
+
+	return messageCount / seconds;
+}
+
+int main(int argc, char **argv) {
+	std::size_t messageCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000;
+	std::size_t messageSize  = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 256;
+
+	std::cout << "Sending " << messageCount << " messages of " << messageSize << " bytes each" << std::endl;
+
+	try {
+		double reopening  = runBenchmark(false, messageCount, messageSize);
+		double persistent = runBenchmark(true, messageCount, messageSize);
+
+		std::cout << "Reopen per read:    " << reopening << " msg/s" << std::endl;
+		std::cout << "Persistent reader:  " << persistent << " msg/s" << std::endl;
+		std::cout << "Speedup:            " << persistent / reopening << "x" << std::endl;
+	} catch (const std::exception &e) {
+		std::cerr << "Benchmark failed: " << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
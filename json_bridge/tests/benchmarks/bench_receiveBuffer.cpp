@@ -0,0 +1,173 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+// Measures the amount of read system calls and the throughput when receiving newline-delimited messages of different
+// sizes from a NamedPipe, once reading the pipe in 32-byte chunks (the way the Bridge used to operate) and once via
+// the pipe's receive buffer.
+//
+// Usage: bench_receiveBuffer [totalBytesPerRun]
+
+#include <mumble/json_bridge/NamedPipe.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <boost/thread/thread.hpp>
+
+#ifdef PLATFORM_UNIX
+#	include <fcntl.h>
+#	include <poll.h>
+#	include <unistd.h>
+#endif
+
+using namespace Mumble::JsonBridge;
+
+#ifdef PLATFORM_UNIX
+const std::filesystem::path pipePath = std::filesystem::path(".") / "benchmarkPipe";
+
+struct Result {
+	double bytesPerSecond;
+	double readCallsPerMessage;
+};
+
+/**
+ * Reads the given amount of messages from the given handle in 32-byte chunks
+ *
+ * @returns The amount of read system calls issued
+ */
+std::uint64_t receiveChunked(int handle, std::size_t messageCount) {
+	constexpr std::size_t chunkSize = 32;
+
+	std::uint64_t readCalls = 0;
+	std::size_t received    = 0;
+	std::string pending;
+
+	while (received < messageCount) {
+		pollfd pollData = { handle, POLLIN, 0 };
+		::poll(&pollData, 1, 1000);
+
+		char buffer[chunkSize];
+		ssize_t readBytes;
+		do {
+			readCalls++;
+			readBytes = ::read(handle, buffer, chunkSize);
+
+			if (readBytes > 0) {
+				pending.append(buffer, readBytes);
+			}
+		} while (readBytes > 0);
+
+		std::size_t frameBegin = 0;
+		std::size_t frameEnd;
+		while ((frameEnd = pending.find(FRAME_DELIMITER, frameBegin)) != std::string::npos) {
+			frameBegin = frameEnd + 1;
+			received++;
+		}
+		pending.erase(0, frameBegin);
+	}
+
+	return readCalls;
+}
+
+/**
+ * Reads the given amount of messages from the given pipe via its receive buffer
+ *
+ * @returns The amount of read system calls issued
+ */
+std::uint64_t receiveBuffered(const NamedPipe &pipe, std::size_t messageCount) {
+	std::size_t received = 0;
+
+	while (received < messageCount) {
+		pollfd pollData = { pipe.getReadHandle(), POLLIN, 0 };
+		::poll(&pollData, 1, 1000);
+
+		received += pipe.read_available_frames().size();
+	}
+
+	return pipe.getReceiveStatistics().readCalls;
+}
+
+Result runBenchmark(bool buffered, std::size_t messageSize, std::size_t messageCount) {
+	NamedPipe pipe = NamedPipe::create(pipePath);
+	pipe.openPersistentReader();
+
+	// A JSON string, so that partially received messages are recognized as such
+	std::string message = "\"" + std::string(messageSize - 3, 'x') + "\"";
+	message += FRAME_DELIMITER;
+
+	auto start = std::chrono::steady_clock::now();
+
+	boost::thread writer([&]() {
+		// Blocking writes, so that the writer simply waits whenever the pipe is full
+		int handle = ::open(pipePath.c_str(), O_WRONLY);
+
+		for (std::size_t i = 0; i < messageCount; i++) {
+			std::size_t written = 0;
+			while (written < message.size()) {
+				ssize_t result = ::write(handle, message.data() + written, message.size() - written);
+
+				if (result < 0) {
+					std::cerr << "Writer failed: " << errno << std::endl;
+					std::exit(1);
+				}
+
+				written += result;
+			}
+		}
+
+		::close(handle);
+	});
+
+	std::uint64_t readCalls = buffered ? receiveBuffered(pipe, messageCount)
+									   : receiveChunked(pipe.getReadHandle(), messageCount);
+
+	writer.join();
+
+	auto end = std::chrono::steady_clock::now();
+
+	double seconds = std::chrono::duration< double >(end - start).count();
+
+	return { messageSize * messageCount / seconds, static_cast< double >(readCalls) / messageCount };
+}
+
+int main(int argc, char **argv) {
+	std::size_t totalBytes = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 16 * 1024 * 1024;
+
+	std::cout << "Transferring " << totalBytes << " bytes per run" << std::endl << std::endl;
+	std::cout << "Size     | 32-byte chunks: reads/msg      MiB/s | Receive buffer: reads/msg      MiB/s" << std::endl;
+
+	try {
+		for (std::size_t size = 64; size <= 1024 * 1024; size *= 4) {
+			std::size_t count = std::max< std::size_t >(totalBytes / size, 1);
+
+			Result chunked  = runBenchmark(false, size, count);
+			Result buffered = runBenchmark(true, size, count);
+
+			std::printf("%8zu | %25.2f %10.1f | %25.2f %10.1f\n", size, chunked.readCallsPerMessage,
+						chunked.bytesPerSecond / (1024 * 1024), buffered.readCallsPerMessage,
+						buffered.bytesPerSecond / (1024 * 1024));
+			std::fflush(stdout);
+		}
+	} catch (const std::exception &e) {
+		std::cerr << "Benchmark failed: " << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
+#else
+int main() {
+	std::cerr << "This benchmark is only available on Unix" << std::endl;
+
+	return 1;
+}
+#endif
@@ -0,0 +1,142 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+// Measures the cost of turning a received getUserName request into the typed parameter of the API call, once by
+// parsing it into a JSON DOM and converting the parameter from there (the way the Bridge used to operate) and once by
+// reading it straight into the typed parameter. Besides the time per request, the amount of heap allocations per
+// request is reported. Reading a request into the typed parameter doesn't allocate by itself - the allocations that
+// remain are the copy of the secret (which exceeds the small string optimization). Requests of connected clients carry
+// neither client ID nor secret and are thus read without any allocation at all.
+//
+// Usage: bench_requestParsing [requestsPerRun]
+
+#include <mumble/json_bridge/messages/APICall.h>
+#include <mumble/json_bridge/messages/APICallReader.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+
+#include <nlohmann/json.hpp>
+
+using namespace Mumble::JsonBridge;
+
+static std::atomic< std::size_t > allocations(0);
+
+void *operator new(std::size_t size) {
+	allocations++;
+
+	if (void *ptr = std::malloc(size ? size : 1)) {
+		return ptr;
+	}
+
+	throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept {
+	std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept {
+	std::free(ptr);
+}
+
+const std::string request = "{\"client_id\":1,\"message\":{\"function\":\"getUserName\",\"parameter\":{\"connection\":"
+							"13,\"user_id\":5}},\"message_type\":\"api_call\",\"request_id\":42,\"secret\":"
+							"\"MyVerySecretSecret\"}";
+
+const std::string connectedRequest =
+	"{\"message\":{\"function\":\"getUserName\",\"parameter\":{\"connection\":13,\"user_id\":5}},\"message_type\":"
+	"\"api_call\",\"request_id\":42}";
+
+// Prevents the compiler from optimizing the parsing away
+volatile std::size_t sink = 0;
+
+/**
+ * Turns the request into the call's parameter the way the Bridge used to do it
+ */
+void parseDOM() {
+	nlohmann::json msg = nlohmann::json::parse(request);
+
+	Messages::parseBasicFormat(msg);
+	nlohmann::json requestID = Messages::parseRequestID(msg);
+
+	// The message body used to be copied into the APICall
+	nlohmann::json body = msg["message"];
+
+	const Messages::APIFunction *function =
+		Messages::findAPIFunction(body["function"].get_ref< const std::string & >());
+	Messages::APIParameter parameter = function->parse(body["parameter"]);
+
+	sink = sink + parameter.index() + msg["client_id"].get< std::size_t >()
+		   + msg["secret"].get_ref< const std::string & >().size();
+}
+
+/**
+ * Reads the request straight into the call's parameter
+ */
+void read() {
+	Messages::APICallRequest parsed;
+
+	if (!Messages::readAPICall(request, parsed)) {
+		std::cerr << "Failed to read the request" << std::endl;
+		std::exit(1);
+	}
+
+	sink = sink + parsed.parameter.index() + *parsed.clientID + parsed.secret->size();
+}
+
+/**
+ * Reads a request of a connected client straight into the call's parameter
+ */
+void readConnected() {
+	Messages::APICallRequest parsed;
+
+	if (!Messages::readAPICall(connectedRequest, parsed)) {
+		std::cerr << "Failed to read the request" << std::endl;
+		std::exit(1);
+	}
+
+	sink = sink + parsed.parameter.index();
+}
+
+/**
+ * @returns The average duration of turning a single request into the typed parameter in nanoseconds and the average
+ * amount of allocations doing so
+ */
+template< typename Parse > std::pair< double, double > runBenchmark(Parse parse, std::size_t requests) {
+	std::size_t allocationsBefore = allocations;
+	auto start                    = std::chrono::steady_clock::now();
+
+	for (std::size_t i = 0; i < requests; i++) {
+		parse();
+	}
+
+	auto end = std::chrono::steady_clock::now();
+
+	return { std::chrono::duration< double, std::nano >(end - start).count() / requests,
+			 static_cast< double >(allocations - allocationsBefore) / requests };
+}
+
+int main(int argc, char **argv) {
+	std::size_t requests = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000 * 1000;
+
+	std::cout << "Parsing " << requests << " requests per run" << std::endl << std::endl;
+	std::cout << "Method            | ns/request | allocations/request" << std::endl;
+
+	std::pair< double, double > dom = runBenchmark(parseDOM, requests);
+	std::pair< double, double > sax = runBenchmark(read, requests);
+	std::pair< double, double > connected = runBenchmark(readConnected, requests);
+
+	std::printf("%-17s | %10.1f | %19.1f\n", "JSON DOM", dom.first, dom.second);
+	std::printf("%-17s | %10.1f | %19.1f\n", "Typed", sax.first, sax.second);
+	std::printf("%-17s | %10.1f | %19.1f\n", "Typed (connected)", connected.first, connected.second);
+
+	return 0;
+}
@@ -0,0 +1,115 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+// Measures the cost of serializing the response to a getAllUsers call for servers of different sizes, once by building
+// a JSON DOM for the response and dumping it (the way the Bridge used to operate) and once by writing the response
+// straight into its serialized form.
+//
+// Usage: bench_responseWriting [responsesPerRun]
+
+#include <mumble/json_bridge/ResponseWriter.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+using namespace Mumble::JsonBridge;
+
+const std::string secret = "MyVerySecretSecret";
+
+// Prevents the compiler from optimizing the serialization away
+volatile std::size_t sink = 0;
+
+/**
+ * Serializes the response the way the Bridge used to do it
+ */
+void serializeDOM(const std::vector< std::uint32_t > &users) {
+	// clang-format off
+	nlohmann::json response = {
+		{"response_type", "api_call"},
+		{"secret", secret},
+		{"response",
+			{
+				{"function", "getAllUsers"},
+				{"status", "executed"},
+				{"return_value", users}
+			}
+		}
+	};
+	// clang-format on
+	response["request_id"] = 42;
+
+	sink = sink + response.dump().size();
+}
+
+/**
+ * Writes the response straight into its serialized form
+ */
+void write(const std::vector< std::uint32_t > &users) {
+	static std::string secretField;
+	if (secretField.empty()) {
+		ResponseWriter secretWriter(secretField);
+		secretWriter.raw(R"("secret":)");
+		secretWriter.string(secret);
+		secretWriter.raw(",");
+	}
+
+	std::string message;
+	ResponseWriter writer(message);
+
+	writer.raw(R"({"request_id":)");
+	writer.value(42);
+	writer.raw(",");
+	writer.raw(secretField);
+	writer.raw(R"("response_type":"api_call","response":{"function":"getAllUsers","status":"executed","return_value":)");
+	writer.value(users);
+	writer.raw("}}");
+
+	sink = sink + message.size();
+}
+
+/**
+ * @returns The average duration of serializing a single response in nanoseconds
+ */
+template< typename Serialize >
+double runBenchmark(Serialize serialize, const std::vector< std::uint32_t > &users, std::size_t responses) {
+	auto start = std::chrono::steady_clock::now();
+
+	for (std::size_t i = 0; i < responses; i++) {
+		serialize(users);
+	}
+
+	auto end = std::chrono::steady_clock::now();
+
+	return std::chrono::duration< double, std::nano >(end - start).count() / responses;
+}
+
+int main(int argc, char **argv) {
+	std::size_t responses = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10 * 1000;
+
+	std::cout << "Serializing " << responses << " responses per run" << std::endl << std::endl;
+	std::cout << "Users | JSON DOM: ns/response | Writer: ns/response" << std::endl;
+
+	for (std::size_t userCount : { 1, 100, 5000 }) {
+		std::vector< std::uint32_t > users;
+		for (std::size_t i = 0; i < userCount; i++) {
+			users.push_back(static_cast< std::uint32_t >(i * 7919));
+		}
+
+		double dom     = runBenchmark(serializeDOM, users, responses);
+		double written = runBenchmark(write, users, responses);
+
+		std::printf("%5zu | %21.1f | %19.1f\n", userCount, dom, written);
+		std::fflush(stdout);
+	}
+
+	return 0;
+}
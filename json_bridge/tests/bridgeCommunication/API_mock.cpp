@@ -11,6 +11,7 @@
 #include <cstring>
 #include <functional>
 #include <iostream>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -33,9 +34,23 @@
 
 #define UNUSED(var) (void) var
 
+// The Bridge may call the API from multiple threads at once. Like Mumble, the mock processes one call at a time.
+#define RECORD_CALL(name)                                  \
+	std::lock_guard< std::recursive_mutex > guard(mutex); \
+	calledFunctions[name]++
+
 namespace API_Mock {
 
 std::unordered_map< std::string, int > calledFunctions;
+std::recursive_mutex mutex;
+
+int getCallCount(const std::string &function) {
+	std::lock_guard< std::recursive_mutex > guard(mutex);
+
+	auto it = calledFunctions.find(function);
+
+	return it == calledFunctions.end() ? 0 : it->second;
+}
 
 /// A "curator" that will keep track of allocated resources and how to delete them
 struct MumbleAPICurator {
@@ -61,7 +76,7 @@ static MumbleAPICurator curator;
 // The description of the functions is provided in MumbleAPI.h
 
 mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION freeMemory_v_1_0_x(mumble_plugin_id_t callerID, const void *ptr) {
-	calledFunctions["freeMemory"]++;
+	RECORD_CALL("freeMemory");
 
 	// Don't verify plugin ID here to avoid memory leaks
 	UNUSED(callerID);
@@ -81,7 +96,7 @@ mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION freeMemory_v_1_0_x(mumble_plugin
 
 mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION getActiveServerConnection_v_1_0_x(mumble_plugin_id_t callerID,
 																		   mumble_connection_t *connection) {
-	calledFunctions["getActiveServerConnection"]++;
+	RECORD_CALL("getActiveServerConnection");
 
 	VERIFY_PLUGIN_ID(callerID);
 
@@ -93,7 +108,7 @@ mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION getActiveServerConnection_v_1_0_
 mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION isConnectionSynchronized_v_1_0_x(mumble_plugin_id_t callerID,
 																		  mumble_connection_t connection,
 																		  bool *synchronized) {
-	calledFunctions["isConnectionSychronized"]++;
+	RECORD_CALL("isConnectionSychronized");
 
 	VERIFY_PLUGIN_ID(callerID);
 	VERIFY_CONNECTION(connection);
@@ -107,7 +122,7 @@ mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION isConnectionSynchronized_v_1_0_x
 mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION getLocalUserID_v_1_0_x(mumble_plugin_id_t callerID,
 																mumble_connection_t connection,
 																mumble_userid_t *userID) {
-	calledFunctions["getLocalUserID"]++;
+	RECORD_CALL("getLocalUserID");
 
 	VERIFY_PLUGIN_ID(callerID);
 
@@ -122,7 +137,7 @@ mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION getLocalUserID_v_1_0_x(mumble_pl
 mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION getUserName_v_1_0_x(mumble_plugin_id_t callerID,
 															 mumble_connection_t connection, mumble_userid_t userID,
 															 const char **name) {
-	calledFunctions["getUserName"]++;
+	RECORD_CALL("getUserName");
 
 	VERIFY_PLUGIN_ID(callerID);
 
@@ -158,7 +173,7 @@ mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION getUserName_v_1_0_x(mumble_plugi
 mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION getChannelName_v_1_0_x(mumble_plugin_id_t callerID,
 																mumble_connection_t connection,
 																mumble_channelid_t channelID, const char **name) {
-	calledFunctions["getChannelName"]++;
+	RECORD_CALL("getChannelName");
 
 	VERIFY_PLUGIN_ID(callerID);
 
@@ -194,7 +209,7 @@ mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION getChannelName_v_1_0_x(mumble_pl
 mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION getAllUsers_v_1_0_x(mumble_plugin_id_t callerID,
 															 mumble_connection_t connection, mumble_userid_t **users,
 															 size_t *userCount) {
-	calledFunctions["getAllUsers"]++;
+	RECORD_CALL("getAllUsers");
 
 	VERIFY_PLUGIN_ID(callerID);
 
@@ -220,7 +235,7 @@ mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION getAllUsers_v_1_0_x(mumble_plugi
 mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION getAllChannels_v_1_0_x(mumble_plugin_id_t callerID,
 																mumble_connection_t connection,
 																mumble_channelid_t **channels, size_t *channelCount) {
-	calledFunctions["getAllChannels"]++;
+	RECORD_CALL("getAllChannels");
 
 	VERIFY_PLUGIN_ID(callerID);
 
@@ -247,7 +262,7 @@ mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION getAllChannels_v_1_0_x(mumble_pl
 mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION getChannelOfUser_v_1_0_x(mumble_plugin_id_t callerID,
 																  mumble_connection_t connection,
 																  mumble_userid_t userID, mumble_channelid_t *channel) {
-	calledFunctions["getChannelOfUser"]++;
+	RECORD_CALL("getChannelOfUser");
 
 	VERIFY_PLUGIN_ID(callerID);
 
@@ -273,7 +288,7 @@ mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION getUsersInChannel_v_1_0_x(mumble
 																   mumble_connection_t connection,
 																   mumble_channelid_t channelID,
 																   mumble_userid_t **userList, size_t *userCount) {
-	calledFunctions["getUsersInChannel"]++;
+	RECORD_CALL("getUsersInChannel");
 
 	VERIFY_PLUGIN_ID(callerID);
 
@@ -306,7 +321,7 @@ mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION getUsersInChannel_v_1_0_x(mumble
 
 mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION
 	getLocalUserTransmissionMode_v_1_0_x(mumble_plugin_id_t callerID, mumble_transmission_mode_t *transmissionMode) {
-	calledFunctions["getLocalUserTransmissionMode"]++;
+	RECORD_CALL("getLocalUserTransmissionMode");
 
 	VERIFY_PLUGIN_ID(callerID);
 
@@ -319,7 +334,7 @@ mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION
 mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION isUserLocallyMuted_v_1_0_x(mumble_plugin_id_t callerID,
 																	mumble_connection_t connection,
 																	mumble_userid_t userID, bool *muted) {
-	calledFunctions["isUserLocallyMuted"]++;
+	RECORD_CALL("isUserLocallyMuted");
 
 	VERIFY_PLUGIN_ID(callerID);
 
@@ -338,7 +353,7 @@ mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION isUserLocallyMuted_v_1_0_x(mumbl
 }
 
 mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION isLocalUserMuted_v_1_0_x(mumble_plugin_id_t callerID, bool *muted) {
-	calledFunctions["isLocalUserMuted"]++;
+	RECORD_CALL("isLocalUserMuted");
 
 	VERIFY_PLUGIN_ID(callerID);
 
@@ -348,7 +363,7 @@ mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION isLocalUserMuted_v_1_0_x(mumble_
 }
 
 mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION isLocalUserDeafened_v_1_0_x(mumble_plugin_id_t callerID, bool *deafened) {
-	calledFunctions["isLocalUserDeafened"]++;
+	RECORD_CALL("isLocalUserDeafened");
 
 	VERIFY_PLUGIN_ID(callerID);
 
@@ -360,7 +375,7 @@ mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION isLocalUserDeafened_v_1_0_x(mumb
 mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION getUserHash_v_1_0_x(mumble_plugin_id_t callerID,
 															 mumble_connection_t connection, mumble_userid_t userID,
 															 const char **hash) {
-	calledFunctions["getUserHash"]++;
+	RECORD_CALL("getUserHash");
 
 	VERIFY_PLUGIN_ID(callerID);
 
@@ -396,7 +411,7 @@ mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION getUserHash_v_1_0_x(mumble_plugi
 
 mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION getServerHash_v_1_0_x(mumble_plugin_id_t callerID,
 															   mumble_connection_t connection, const char **hash) {
-	calledFunctions["getServerHash"]++;
+	RECORD_CALL("getServerHash");
 
 	VERIFY_PLUGIN_ID(callerID);
 
@@ -422,7 +437,7 @@ mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION getServerHash_v_1_0_x(mumble_plu
 
 mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION
 	requestLocalUserTransmissionMode_v_1_0_x(mumble_plugin_id_t callerID, mumble_transmission_mode_t transmissionMode) {
-	calledFunctions["requestLocalUserTransmissionMode"]++;
+	RECORD_CALL("requestLocalUserTransmissionMode");
 
 	VERIFY_PLUGIN_ID(callerID);
 
@@ -445,7 +460,7 @@ mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION
 mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION getUserComment_v_1_0_x(mumble_plugin_id_t callerID,
 																mumble_connection_t connection, mumble_userid_t userID,
 																const char **comment) {
-	calledFunctions["getUserComment"]++;
+	RECORD_CALL("getUserComment");
 
 	VERIFY_PLUGIN_ID(callerID);
 
@@ -476,7 +491,7 @@ mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION getChannelDescription_v_1_0_x(mu
 																	   mumble_connection_t connection,
 																	   mumble_channelid_t channelID,
 																	   const char **description) {
-	calledFunctions["getChannelDescription"]++;
+	RECORD_CALL("getChannelDescription");
 
 	VERIFY_PLUGIN_ID(callerID);
 
@@ -506,7 +521,7 @@ mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION getChannelDescription_v_1_0_x(mu
 mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION requestUserMove_v_1_0_x(mumble_plugin_id_t callerID,
 																 mumble_connection_t connection, mumble_userid_t userID,
 																 mumble_channelid_t channelID, const char *password) {
-	calledFunctions["requestUserMove"]++;
+	RECORD_CALL("requestUserMove");
 
 	VERIFY_PLUGIN_ID(callerID);
 
@@ -529,7 +544,7 @@ mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION requestUserMove_v_1_0_x(mumble_p
 
 mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION requestMicrophoneActivationOverwrite_v_1_0_x(mumble_plugin_id_t callerID,
 																					  bool activate) {
-	calledFunctions["requestMicrophoneActivationOverwrite"]++;
+	RECORD_CALL("requestMicrophoneActivationOverwrite");
 
 	VERIFY_PLUGIN_ID(callerID);
 
@@ -542,7 +557,7 @@ mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION requestMicrophoneActivationOverw
 mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION requestLocalMute_v_1_0_x(mumble_plugin_id_t callerID,
 																  mumble_connection_t connection,
 																  mumble_userid_t userID, bool muted) {
-	calledFunctions["requestLocalMute"]++;
+	RECORD_CALL("requestLocalMute");
 
 	VERIFY_PLUGIN_ID(callerID);
 
@@ -562,7 +577,7 @@ mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION requestLocalMute_v_1_0_x(mumble_
 }
 
 mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION requestLocalUserMute_v_1_0_x(mumble_plugin_id_t callerID, bool muted) {
-	calledFunctions["requestLocalUserMute"]++;
+	RECORD_CALL("requestLocalUserMute");
 
 	VERIFY_PLUGIN_ID(callerID);
 
@@ -573,7 +588,7 @@ mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION requestLocalUserMute_v_1_0_x(mum
 }
 
 mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION requestLocalUserDeaf_v_1_0_x(mumble_plugin_id_t callerID, bool deafened) {
-	calledFunctions["requestLocalUserDeaf"]++;
+	RECORD_CALL("requestLocalUserDeaf");
 
 	VERIFY_PLUGIN_ID(callerID);
 
@@ -586,7 +601,7 @@ mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION requestLocalUserDeaf_v_1_0_x(mum
 mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION requestSetLocalUserComment_v_1_0_x(mumble_plugin_id_t callerID,
 																			mumble_connection_t connection,
 																			const char *comment) {
-	calledFunctions["requestSetLocalUserComment"]++;
+	RECORD_CALL("requestSetLocalUserComment");
 
 	VERIFY_PLUGIN_ID(callerID);
 
@@ -602,7 +617,7 @@ mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION requestSetLocalUserComment_v_1_0
 mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION findUserByName_v_1_0_x(mumble_plugin_id_t callerID,
 																mumble_connection_t connection, const char *userName,
 																mumble_userid_t *userID) {
-	calledFunctions["findUserByName"]++;
+	RECORD_CALL("findUserByName");
 
 	VERIFY_PLUGIN_ID(callerID);
 
@@ -626,7 +641,7 @@ mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION findChannelByName_v_1_0_x(mumble
 																   mumble_connection_t connection,
 																   const char *channelName,
 																   mumble_channelid_t *channelID) {
-	calledFunctions["findChannelByName"]++;
+	RECORD_CALL("findChannelByName");
 
 	VERIFY_PLUGIN_ID(callerID);
 
@@ -647,7 +662,7 @@ mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION findChannelByName_v_1_0_x(mumble
 
 mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION getMumbleSetting_bool_v_1_0_x(mumble_plugin_id_t callerID,
 																	   mumble_settings_key_t key, bool *outValue) {
-	calledFunctions["getMumbleSetting_bool"]++;
+	RECORD_CALL("getMumbleSetting_bool");
 
 	VERIFY_PLUGIN_ID(callerID);
 
@@ -659,7 +674,7 @@ mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION getMumbleSetting_bool_v_1_0_x(mu
 
 mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION getMumbleSetting_int_v_1_0_x(mumble_plugin_id_t callerID,
 																	  mumble_settings_key_t key, int64_t *outValue) {
-	calledFunctions["getMumbleSetting_int"]++;
+	RECORD_CALL("getMumbleSetting_int");
 
 	VERIFY_PLUGIN_ID(callerID);
 
@@ -671,7 +686,7 @@ mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION getMumbleSetting_int_v_1_0_x(mum
 
 mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION getMumbleSetting_double_v_1_0_x(mumble_plugin_id_t callerID,
 																		 mumble_settings_key_t key, double *outValue) {
-	calledFunctions["getMumbleSetting_double"]++;
+	RECORD_CALL("getMumbleSetting_double");
 
 	VERIFY_PLUGIN_ID(callerID);
 
@@ -684,7 +699,7 @@ mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION getMumbleSetting_double_v_1_0_x(
 mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION getMumbleSetting_string_v_1_0_x(mumble_plugin_id_t callerID,
 																		 mumble_settings_key_t key,
 																		 const char **outValue) {
-	calledFunctions["getMumbleSetting_string"]++;
+	RECORD_CALL("getMumbleSetting_string");
 
 	VERIFY_PLUGIN_ID(callerID);
 
@@ -696,7 +711,7 @@ mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION getMumbleSetting_string_v_1_0_x(
 
 mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION setMumbleSetting_bool_v_1_0_x(mumble_plugin_id_t callerID,
 																	   mumble_settings_key_t key, bool value) {
-	calledFunctions["setMumbleSetting_bool"]++;
+	RECORD_CALL("setMumbleSetting_bool");
 
 	VERIFY_PLUGIN_ID(callerID);
 
@@ -708,7 +723,7 @@ mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION setMumbleSetting_bool_v_1_0_x(mu
 
 mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION setMumbleSetting_int_v_1_0_x(mumble_plugin_id_t callerID,
 																	  mumble_settings_key_t key, int64_t value) {
-	calledFunctions["setMumbleSetting_int"]++;
+	RECORD_CALL("setMumbleSetting_int");
 
 	VERIFY_PLUGIN_ID(callerID);
 
@@ -720,7 +735,7 @@ mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION setMumbleSetting_int_v_1_0_x(mum
 
 mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION setMumbleSetting_double_v_1_0_x(mumble_plugin_id_t callerID,
 																		 mumble_settings_key_t key, double value) {
-	calledFunctions["setMumbleSetting_double"]++;
+	RECORD_CALL("setMumbleSetting_double");
 
 	VERIFY_PLUGIN_ID(callerID);
 
@@ -732,7 +747,7 @@ mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION setMumbleSetting_double_v_1_0_x(
 
 mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION setMumbleSetting_string_v_1_0_x(mumble_plugin_id_t callerID,
 																		 mumble_settings_key_t key, const char *value) {
-	calledFunctions["setMumbleSetting_string"]++;
+	RECORD_CALL("setMumbleSetting_string");
 
 	VERIFY_PLUGIN_ID(callerID);
 
@@ -745,7 +760,7 @@ mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION setMumbleSetting_string_v_1_0_x(
 mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION sendData_v_1_0_x(mumble_plugin_id_t callerID, mumble_connection_t connection,
 														  const mumble_userid_t *users, size_t userCount,
 														  const uint8_t *data, size_t dataLength, const char *dataID) {
-	calledFunctions["sendData"]++;
+	RECORD_CALL("sendData");
 
 	VERIFY_PLUGIN_ID(callerID);
 
@@ -763,7 +778,7 @@ mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION sendData_v_1_0_x(mumble_plugin_i
 }
 
 mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION log_v_1_0_x(mumble_plugin_id_t callerID, const char *message) {
-	calledFunctions["log"]++;
+	RECORD_CALL("log");
 
 	VERIFY_PLUGIN_ID(callerID);
 
@@ -773,7 +788,7 @@ mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION log_v_1_0_x(mumble_plugin_id_t c
 }
 
 mumble_error_t MUMBLE_PLUGIN_CALLING_CONVENTION playSample_v_1_0_x(mumble_plugin_id_t callerID, const char *samplePath, float volume) {
-	calledFunctions["playSample"]++;
+	RECORD_CALL("playSample");
 
 	VERIFY_PLUGIN_ID(callerID);
 
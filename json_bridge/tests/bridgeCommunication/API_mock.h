@@ -3,11 +3,22 @@
 
 #include <mumble/plugin/internal/MumblePlugin.h>
 
+#include <mutex>
 #include <string>
 #include <unordered_map>
 
 namespace API_Mock {
 extern std::unordered_map< std::string, int > calledFunctions;
+/**
+ * Guards calledFunctions (and all other state of the mock)
+ */
+extern std::recursive_mutex mutex;
+
+/**
+ * @param function The name of the function
+ * @returns How often the given function has been called so far. This may be called while the Bridge is running.
+ */
+int getCallCount(const std::string &function);
 
 static constexpr mumble_plugin_id_t pluginID         = 42;
 static constexpr mumble_connection_t activeConnetion = 13;
@@ -0,0 +1,191 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+#include "gtest/gtest.h"
+
+#include <mumble/json_bridge/Bridge.h>
+#include <mumble/json_bridge/SeqPacketSocket.h>
+#include <mumble/json_bridge/SharedMemoryChannel.h>
+
+#include "API_mock.h"
+
+#include <nlohmann/json.hpp>
+
+#ifdef PLATFORM_UNIX
+#	include <algorithm>
+#	include <atomic>
+#	include <cstdint>
+#	include <cstdlib>
+#	include <new>
+#	include <string>
+#	include <vector>
+
+using namespace Mumble::JsonBridge;
+
+// Allocations made by the Bridge's threads (i.e. all threads but the one running the test) are counted while a
+// measurement is running
+static std::atomic_bool s_counting(false);
+static std::atomic< std::int64_t > s_allocations(0);
+static thread_local bool s_isTestThread = false;
+
+static void *countAllocation(void *ptr) {
+	if (!ptr) {
+		throw std::bad_alloc();
+	}
+
+	if (s_counting && !s_isTestThread) {
+		s_allocations++;
+	}
+
+	return ptr;
+}
+
+static void *alignedAllocation(std::size_t size, std::align_val_t alignment) {
+	void *ptr = nullptr;
+	if (posix_memalign(&ptr, std::max(static_cast< std::size_t >(alignment), sizeof(void *)), size) != 0) {
+		return nullptr;
+	}
+	return ptr;
+}
+
+void *operator new(std::size_t size) { return countAllocation(std::malloc(std::max(size, std::size_t(1)))); }
+void *operator new[](std::size_t size) { return countAllocation(std::malloc(std::max(size, std::size_t(1)))); }
+void *operator new(std::size_t size, std::align_val_t alignment) {
+	return countAllocation(alignedAllocation(size, alignment));
+}
+void *operator new[](std::size_t size, std::align_val_t alignment) {
+	return countAllocation(alignedAllocation(size, alignment));
+}
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete[](void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void *ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void *ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void *ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
+
+constexpr unsigned int READ_TIMEOUT = 5 * 1000;
+
+class Allocations : public ::testing::Test {
+protected:
+	MumbleAPI m_api;
+	Bridge m_bridge;
+	std::string m_request;
+
+	Allocations() : m_api(API_Mock::getMumbleAPI_v_1_2_x(), API_Mock::pluginID), m_bridge(m_api) {}
+
+	void SetUp() override {
+		s_isTestThread = true;
+
+		m_bridge.start();
+
+		// Requests are answered from the model of the server, so that only the Bridge itself is measured (and not
+		// the mocked API)
+		m_bridge.getServerState().onServerSynchronized(API_Mock::activeConnetion);
+
+		// clang-format off
+		nlohmann::json request = {
+			{"message_type", "api_call"},
+			{"message",
+				{
+					{"function", "getUserName"},
+					{"parameter",
+						{
+							{"connection", API_Mock::activeConnetion},
+							{"user_id", API_Mock::localUserID}
+						}
+					}
+				}
+			}
+		};
+		// clang-format on
+		m_request = request.dump();
+	}
+
+	void TearDown() override {
+		m_bridge.stop(true);
+
+		API_Mock::calledFunctions.clear();
+	}
+
+	/**
+	 * Sends requests one after another, waiting for each response, and counts the allocations made by the Bridge for
+	 * the requests after the first few ones
+	 */
+	template< typename Send, typename Receive > std::int64_t measure(Send send, Receive receive) {
+		constexpr int warmupRequests = 200;
+		constexpr int requests       = 1000;
+
+		std::string response;
+		for (int i = 0; i < warmupRequests; i++) {
+			send(m_request);
+			response = receive();
+		}
+
+		nlohmann::json answer = nlohmann::json::parse(response);
+		EXPECT_EQ(answer["response_type"].get< std::string >(), "api_call");
+		EXPECT_EQ(answer["response"]["return_value"].get< std::string >(), API_Mock::localUserName);
+
+		s_allocations = 0;
+		s_counting    = true;
+
+		for (int i = 0; i < requests; i++) {
+			send(m_request);
+			response = receive();
+		}
+
+		s_counting = false;
+
+		return s_allocations;
+	}
+};
+
+TEST_F(Allocations, socketRequests) {
+	SeqPacketSocket socket = SeqPacketSocket::connect(Bridge::s_socketAddress, READ_TIMEOUT);
+
+	std::int64_t allocations = measure([&](const std::string &request) { socket.send(request); },
+									   [&]() { return socket.receive(READ_TIMEOUT); });
+
+	EXPECT_EQ(allocations, 0);
+}
+
+TEST_F(Allocations, socketRequestsWithoutWorkerThreads) {
+	// The thread counts can only be changed while the Bridge is not running
+	m_bridge.stop(true);
+
+	PipelineConfig config;
+	config.parseThreads         = 0;
+	config.executionThreads     = 0;
+	config.serializationThreads = 0;
+	m_bridge.setPipelineConfig(config);
+
+	m_bridge.start();
+
+	SeqPacketSocket socket = SeqPacketSocket::connect(Bridge::s_socketAddress, READ_TIMEOUT);
+
+	std::int64_t allocations = measure([&](const std::string &request) { socket.send(request); },
+									   [&]() { return socket.receive(READ_TIMEOUT); });
+
+	EXPECT_EQ(allocations, 0);
+}
+
+TEST_F(Allocations, sharedMemoryRequests) {
+	SeqPacketSocket socket = SeqPacketSocket::connect(Bridge::s_socketAddress, READ_TIMEOUT);
+
+	socket.send(R"({"message_type":"registration","message":{"transport":"shared_memory"}})");
+
+	std::vector< int > handles;
+	nlohmann::json answer = nlohmann::json::parse(socket.receive(handles, READ_TIMEOUT));
+	ASSERT_EQ(answer["response_type"].get< std::string >(), "registration");
+
+	SharedMemoryChannel channel = SharedMemoryChannel::attach(handles);
+
+	std::int64_t allocations = measure([&](const std::string &request) { channel.send(request); },
+									   [&]() { return channel.receive(READ_TIMEOUT); });
+
+	EXPECT_EQ(allocations, 0);
+}
+#endif
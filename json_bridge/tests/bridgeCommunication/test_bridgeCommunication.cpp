@@ -7,12 +7,21 @@
 
 #include <mumble/json_bridge/Bridge.h>
 #include <mumble/json_bridge/NamedPipe.h>
+#include <mumble/json_bridge/SeqPacketSocket.h>
+#include <mumble/json_bridge/SharedMemoryChannel.h>
 
 #include "API_mock.h"
 
 #include <nlohmann/json.hpp>
 
 #include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <future>
+#include <memory>
+#include <thread>
 #include <vector>
 
 using namespace Mumble::JsonBridge;
@@ -143,6 +152,63 @@ protected:
 			ASSERT_EQ(m_bridgeSecret, answer["secret"].get<std::string>()) << "Bridge used wrong secret";
 		}
 	}
+
+#ifdef PLATFORM_UNIX
+	void checkPipelinedResponseOrder() {
+		SeqPacketSocket socket = SeqPacketSocket::connect(Bridge::s_socketAddress, READ_TIMEOUT);
+
+		// clang-format off
+		nlohmann::json validCall = {
+			{"message_type", "api_call"},
+			{"message",
+				{
+					{"function", "getLocalUserID"},
+					{"parameter",
+						{
+							{"connection", API_Mock::activeConnetion}
+						}
+					}
+				}
+			}
+		};
+		// clang-format on
+
+		// Fails when being executed
+		nlohmann::json failingCall = validCall;
+		failingCall["message"]["parameter"]["connection"] = API_Mock::activeConnetion + 1;
+
+		// Fails when being validated
+		nlohmann::json invalidCall = validCall;
+		invalidCall["message"].erase("function");
+
+		const std::vector< std::string > expectedTypes = { "api_call", "api_error", "error" };
+
+		// Responses that are quick to produce must not overtake the ones that take longer
+		constexpr int requests = 300;
+		for (int i = 0; i < requests; i++) {
+			switch (i % 3) {
+				case 0:
+					socket.send(validCall.dump());
+					break;
+				case 1:
+					socket.send(failingCall.dump());
+					break;
+				default:
+					socket.send(invalidCall.dump());
+					break;
+			}
+		}
+
+		for (int i = 0; i < requests; i++) {
+			nlohmann::json answer = nlohmann::json::parse(socket.receive(READ_TIMEOUT));
+
+			checkAnswer(answer);
+			ASSERT_EQ(answer["response_type"].get< std::string >(), expectedTypes[i % 3]) << "Response #" << i;
+		}
+
+		ASSERT_API_CALL_HAPPENED("getLocalUserID", 2 * requests / 3);
+	}
+#endif
 };
 
 
@@ -351,6 +417,438 @@ TEST_F(BridgeCommunication, getUserName) {
 	ASSERT_API_CALL_HAPPENED("freeMemory", 1);
 }
 
+TEST_F(BridgeCommunication, serverState_readsAreAnsweredFromModel) {
+	int clientID = performRegistrationAndDrain();
+
+	ServerState &state = m_bridge.getServerState();
+	state.onServerSynchronized(API_Mock::activeConnetion);
+
+	ASSERT_TRUE(state.isSynchronized(API_Mock::activeConnetion));
+	// Building the model has to ask the API about everything once
+	ASSERT_API_CALL_HAPPENED("getAllUsers", 1);
+	ASSERT_API_CALL_HAPPENED("getAllChannels", 1);
+	ASSERT_API_CALL_HAPPENED("getUserName", 2);
+	ASSERT_API_CALL_HAPPENED("getChannelOfUser", 2);
+	ASSERT_API_CALL_HAPPENED("getChannelName", 2);
+	API_Mock::calledFunctions.erase("freeMemory");
+
+	auto call = [&](const std::string &function, nlohmann::json parameter) {
+		parameter["connection"] = API_Mock::activeConnetion;
+
+		// clang-format off
+		nlohmann::json message = {
+			{"message_type", "api_call"},
+			{"client_id", clientID},
+			{"secret", clientSecret},
+			{"message",
+				{
+					{"function", function},
+					{"parameter", parameter}
+				}
+			}
+		};
+		// clang-format on
+
+		NamedPipe::write(m_bridge.s_pipePath, message.dump());
+
+		nlohmann::json answer = nlohmann::json::parse(m_clientPipe.read_blocking(READ_TIMEOUT));
+
+		EXPECT_EQ(answer["response_type"].get< std::string >(), "api_call");
+		EXPECT_EQ(answer["response"]["function"].get< std::string >(), function);
+		EXPECT_EQ(answer["response"]["status"].get< std::string >(), "executed");
+
+		return answer["response"]["return_value"];
+	};
+
+	const std::vector< mumble_userid_t > allUsers = { API_Mock::localUserID, API_Mock::otherUserID };
+
+	ASSERT_EQ(call("getUserName", { { "user_id", API_Mock::otherUserID } }), API_Mock::otherUserName);
+	ASSERT_EQ(call("getChannelName", { { "channel_id", API_Mock::localUserChannel } }),
+			  API_Mock::localUserChannelName);
+	ASSERT_EQ(call("getChannelOfUser", { { "user_id", API_Mock::localUserID } }), API_Mock::localUserChannel);
+	ASSERT_EQ(call("getAllUsers", nlohmann::json::object()), allUsers);
+	ASSERT_EQ(call("getUsersInChannel", { { "channel_id", API_Mock::otherUserChannel } }),
+			  std::vector< mumble_userid_t >{ API_Mock::otherUserID });
+
+	// None of the above has reached the API
+	ASSERT_TRUE(API_Mock::calledFunctions.empty());
+
+	// Moving between channels is tracked without asking the API
+	state.onChannelExited(API_Mock::activeConnetion, API_Mock::otherUserID, API_Mock::otherUserChannel);
+	state.onChannelEntered(API_Mock::activeConnetion, API_Mock::otherUserID, API_Mock::otherUserChannel,
+						   API_Mock::localUserChannel);
+
+	ASSERT_EQ(call("getUsersInChannel", { { "channel_id", API_Mock::localUserChannel } }), allUsers);
+	ASSERT_EQ(call("getUsersInChannel", { { "channel_id", API_Mock::otherUserChannel } }),
+			  std::vector< mumble_userid_t >());
+	ASSERT_TRUE(API_Mock::calledFunctions.empty());
+
+	// Whatever the model doesn't know about is left to the API
+	state.onUserRemoved(API_Mock::activeConnetion, API_Mock::otherUserID);
+
+	ASSERT_EQ(call("getUserName", { { "user_id", API_Mock::otherUserID } }), API_Mock::otherUserName);
+	ASSERT_API_CALL_HAPPENED("getUserName", 1);
+	ASSERT_EQ(call("getAllUsers", nlohmann::json::object()),
+			  std::vector< mumble_userid_t >{ API_Mock::localUserID });
+	ASSERT_TRUE(API_Mock::calledFunctions.count("getAllUsers") == 0);
+
+	// Once disconnected, nothing is answered from the model anymore
+	state.onServerDisconnected(API_Mock::activeConnetion);
+
+	ASSERT_FALSE(state.isSynchronized(API_Mock::activeConnetion));
+	ASSERT_EQ(call("getUserName", { { "user_id", API_Mock::localUserID } }), API_Mock::localUserName);
+	ASSERT_API_CALL_HAPPENED("getUserName", 1);
+	API_Mock::calledFunctions.erase("freeMemory");
+}
+
+TEST_F(BridgeCommunication, serverState_changesSinceVersion) {
+	int clientID = performRegistrationAndDrain();
+
+	auto changesSince = [&](std::uint64_t version) {
+		// clang-format off
+		nlohmann::json message = {
+			{"message_type", "api_call"},
+			{"client_id", clientID},
+			{"secret", clientSecret},
+			{"message",
+				{
+					{"function", "getChangesSince"},
+					{"parameter",
+						{
+							{"connection", API_Mock::activeConnetion},
+							{"version", version}
+						}
+					}
+				}
+			}
+		};
+		// clang-format on
+
+		NamedPipe::write(m_bridge.s_pipePath, message.dump());
+
+		nlohmann::json answer = nlohmann::json::parse(m_clientPipe.read_blocking(READ_TIMEOUT));
+
+		EXPECT_EQ(answer["response_type"].get< std::string >(), "api_call");
+		EXPECT_EQ(answer["response"]["function"].get< std::string >(), "getChangesSince");
+
+		return answer["response"]["return_value"];
+	};
+
+	ServerState &state = m_bridge.getServerState();
+
+	// Nothing is known about servers that haven't been synchronized
+	ASSERT_TRUE(changesSince(0)["resync"].get< bool >());
+
+	state.onServerSynchronized(API_Mock::activeConnetion);
+	API_Mock::calledFunctions.clear();
+
+	const std::uint64_t synchronized = state.getVersion();
+
+	nlohmann::json changes = changesSince(synchronized);
+	ASSERT_FALSE(changes["resync"].get< bool >());
+	ASSERT_EQ(changes["version"].get< std::uint64_t >(), synchronized);
+	ASSERT_TRUE(changes["users"].empty());
+	ASSERT_TRUE(changes["channels"].empty());
+
+	// Moving a user twice is reported once, with the user's current state
+	state.onChannelExited(API_Mock::activeConnetion, API_Mock::otherUserID, API_Mock::otherUserChannel);
+	state.onChannelEntered(API_Mock::activeConnetion, API_Mock::otherUserID, API_Mock::otherUserChannel,
+						   API_Mock::localUserChannel);
+	state.onUserRemoved(API_Mock::activeConnetion, API_Mock::localUserID);
+	state.onChannelRemoved(API_Mock::activeConnetion, API_Mock::otherUserChannel);
+
+	const std::uint64_t changed = state.getVersion();
+	ASSERT_EQ(changed, synchronized + 4);
+
+	// clang-format off
+	nlohmann::json expectedUsers = {
+		{ {"id", API_Mock::otherUserID}, {"name", API_Mock::otherUserName}, {"channel", API_Mock::localUserChannel} }
+	};
+	// clang-format on
+
+	changes = changesSince(synchronized);
+	ASSERT_FALSE(changes["resync"].get< bool >());
+	ASSERT_EQ(changes["version"].get< std::uint64_t >(), changed);
+	ASSERT_EQ(changes["users"], expectedUsers);
+	ASSERT_TRUE(changes["channels"].empty());
+	ASSERT_EQ(changes["removed_users"], std::vector< mumble_userid_t >{ API_Mock::localUserID });
+	ASSERT_EQ(changes["removed_channels"], std::vector< mumble_channelid_t >{ API_Mock::otherUserChannel });
+
+	ASSERT_TRUE(changesSince(changed)["users"].empty());
+	ASSERT_TRUE(changesSince(changed)["removed_users"].empty());
+
+	// Versions from before the server has been synchronized (or from the future) can't be answered
+	ASSERT_TRUE(changesSince(synchronized - 1)["resync"].get< bool >());
+	ASSERT_TRUE(changesSince(changed + 1)["resync"].get< bool >());
+
+	// Neither can changes that have been dropped from the change log already
+	for (std::size_t i = 0; i <= ServerState::DEFAULT_CHANGE_LOG_CAPACITY; i++) {
+		state.onChannelEntered(API_Mock::activeConnetion, API_Mock::otherUserID, API_Mock::localUserChannel,
+							   API_Mock::localUserChannel);
+	}
+
+	ASSERT_TRUE(changesSince(changed)["resync"].get< bool >());
+	ASSERT_FALSE(changesSince(state.getVersion() - 1)["resync"].get< bool >());
+
+	// None of this has reached the API
+	ASSERT_TRUE(API_Mock::calledFunctions.empty());
+}
+
+TEST_F(BridgeCommunication, serverState_namesAreLookedUpInIndex) {
+	int clientID = performRegistrationAndDrain();
+
+	auto call = [&](const std::string &function, nlohmann::json parameter) {
+		parameter["connection"] = API_Mock::activeConnetion;
+
+		// clang-format off
+		nlohmann::json message = {
+			{"message_type", "api_call"},
+			{"client_id", clientID},
+			{"secret", clientSecret},
+			{"message",
+				{
+					{"function", function},
+					{"parameter", parameter}
+				}
+			}
+		};
+		// clang-format on
+
+		NamedPipe::write(m_bridge.s_pipePath, message.dump());
+
+		nlohmann::json answer = nlohmann::json::parse(m_clientPipe.read_blocking(READ_TIMEOUT));
+
+		EXPECT_EQ(answer["response_type"].get< std::string >(), "api_call");
+		EXPECT_EQ(answer["response"]["function"].get< std::string >(), function);
+
+		return answer["response"]["return_value"];
+	};
+
+	auto query = [](const std::string &nameField, const std::string &name, bool caseSensitive, bool prefix) {
+		return nlohmann::json{ { nameField, name }, { "case_sensitive", caseSensitive }, { "prefix", prefix } };
+	};
+
+	const std::vector< mumble_userid_t > allUsers       = { API_Mock::localUserID, API_Mock::otherUserID };
+	const std::vector< mumble_channelid_t > allChannels = { API_Mock::otherUserChannel, API_Mock::localUserChannel };
+
+	// Without a model, matching names are searched for via the API
+	ASSERT_EQ(call("findUsersByName", query("user_name", "OTHER", false, true)),
+			  std::vector< mumble_userid_t >{ API_Mock::otherUserID });
+	ASSERT_API_CALL_HAPPENED("getAllUsers", 1);
+	ASSERT_API_CALL_HAPPENED("getUserName", 2);
+	API_Mock::calledFunctions.erase("freeMemory");
+
+	ServerState &state = m_bridge.getServerState();
+	state.onServerSynchronized(API_Mock::activeConnetion);
+	API_Mock::calledFunctions.clear();
+
+	ASSERT_EQ(call("findUserByName", { { "user_name", API_Mock::otherUserName } }), API_Mock::otherUserID);
+	ASSERT_EQ(call("findUserByName_noexcept", { { "user_name", API_Mock::localUserName } }), API_Mock::localUserID);
+	ASSERT_EQ(call("findChannelByName", { { "channel_name", API_Mock::localUserChannelName } }),
+			  API_Mock::localUserChannel);
+	ASSERT_EQ(call("findChannelByName_noexcept", { { "channel_name", API_Mock::otherUserChannelName } }),
+			  API_Mock::otherUserChannel);
+
+	ASSERT_EQ(call("findUsersByName", query("user_name", "local user", false, false)),
+			  std::vector< mumble_userid_t >{ API_Mock::localUserID });
+	ASSERT_EQ(call("findUsersByName", query("user_name", "local user", true, false)),
+			  std::vector< mumble_userid_t >());
+	ASSERT_EQ(call("findUsersByName", query("user_name", "", true, true)), allUsers);
+	ASSERT_EQ(call("findChannelsByName", query("channel_name", "Channel of ", true, true)), allChannels);
+	ASSERT_EQ(call("findChannelsByName", query("channel_name", "channel of o", false, true)),
+			  std::vector< mumble_channelid_t >{ API_Mock::otherUserChannel });
+
+	// None of the above has reached the API
+	ASSERT_TRUE(API_Mock::calledFunctions.empty());
+
+	// The index follows the model
+	state.onUserRemoved(API_Mock::activeConnetion, API_Mock::otherUserID);
+	state.onChannelRemoved(API_Mock::activeConnetion, API_Mock::otherUserChannel);
+
+	ASSERT_EQ(call("findUsersByName", query("user_name", "", true, true)),
+			  std::vector< mumble_userid_t >{ API_Mock::localUserID });
+	ASSERT_EQ(call("findChannelsByName", query("channel_name", "Channel", true, true)),
+			  std::vector< mumble_channelid_t >{ API_Mock::localUserChannel });
+	ASSERT_TRUE(API_Mock::calledFunctions.empty());
+
+	// Names the index doesn't know are left to the API
+	ASSERT_EQ(call("findUserByName", { { "user_name", API_Mock::otherUserName } }), API_Mock::otherUserID);
+	ASSERT_API_CALL_HAPPENED("findUserByName", 1);
+}
+
+TEST_F(BridgeCommunication, getServerSnapshot) {
+	int clientID = performRegistrationAndDrain();
+
+	auto snapshot = [&](mumble_connection_t connection) {
+		// clang-format off
+		nlohmann::json message = {
+			{"message_type", "api_call"},
+			{"client_id", clientID},
+			{"secret", clientSecret},
+			{"message",
+				{
+					{"function", "getServerSnapshot"},
+					{"parameter",
+						{
+							{"connection", connection}
+						}
+					}
+				}
+			}
+		};
+		// clang-format on
+
+		NamedPipe::write(m_bridge.s_pipePath, message.dump());
+
+		nlohmann::json answer = nlohmann::json::parse(m_clientPipe.read_blocking(READ_TIMEOUT));
+
+		checkAnswer(answer);
+
+		return answer;
+	};
+
+	// 64-bit FNV-1a
+	auto hash = [](const std::string &description) {
+		std::uint64_t hash = 14695981039346656037ull;
+		for (char current : description) {
+			hash ^= static_cast< unsigned char >(current);
+			hash *= 1099511628211ull;
+		}
+
+		char digits[17];
+		std::snprintf(digits, sizeof(digits), "%016llx", static_cast< unsigned long long >(hash));
+
+		return std::string(digits);
+	};
+
+	nlohmann::json answer = snapshot(API_Mock::activeConnetion);
+
+	ASSERT_EQ(answer["response_type"].get< std::string >(), "api_call");
+
+	const nlohmann::json &response = answer["response"];
+
+	ASSERT_EQ(response["function"].get< std::string >(), "getServerSnapshot");
+	ASSERT_EQ(response["status"].get< std::string >(), "executed");
+	ASSERT_FIELD(response, "return_value", object);
+
+	// clang-format off
+	nlohmann::json expectedUsers = {
+		{ {"id", API_Mock::localUserID}, {"name", API_Mock::localUserName}, {"channel", API_Mock::localUserChannel},
+			{"locally_muted", false} },
+		{ {"id", API_Mock::otherUserID}, {"name", API_Mock::otherUserName}, {"channel", API_Mock::otherUserChannel},
+			{"locally_muted", true} }
+	};
+	nlohmann::json expectedChannels = {
+		{ {"id", API_Mock::localUserChannel}, {"name", API_Mock::localUserChannelName},
+			{"description_hash", hash(API_Mock::localUserChannelDesc)} },
+		{ {"id", API_Mock::otherUserChannel}, {"name", API_Mock::otherUserChannelName},
+			{"description_hash", hash(API_Mock::otherUserChannelDesc)} }
+	};
+	// clang-format on
+
+	ASSERT_EQ(response["return_value"]["users"], expectedUsers);
+	ASSERT_EQ(response["return_value"]["channels"], expectedChannels);
+
+	// Without a model of the server, there is no version getChangesSince could continue from
+	ASSERT_EQ(response["return_value"]["version"].get< std::uint64_t >(), 0);
+
+	ASSERT_API_CALL_HAPPENED("getAllUsers", 1);
+	ASSERT_API_CALL_HAPPENED("getUserName", 2);
+	ASSERT_API_CALL_HAPPENED("getChannelOfUser", 2);
+	ASSERT_API_CALL_HAPPENED("isUserLocallyMuted", 2);
+	ASSERT_API_CALL_HAPPENED("getAllChannels", 1);
+	ASSERT_API_CALL_HAPPENED("getChannelName", 2);
+	ASSERT_API_CALL_HAPPENED("getChannelDescription", 2);
+	// Both arrays, both user names, both channel names and both descriptions
+	ASSERT_API_CALL_HAPPENED("freeMemory", 8);
+
+	// A failing API call must not leave a partial snapshot behind
+	answer = snapshot(API_Mock::activeConnetion + 1);
+
+	ASSERT_EQ(answer["response_type"].get< std::string >(), "api_error");
+	ASSERT_FIELD(answer["response"], "error_code", number_integer);
+	ASSERT_FALSE(answer["response"].contains("return_value"));
+
+	ASSERT_API_CALL_HAPPENED("getAllUsers", 1);
+}
+
+TEST_F(BridgeCommunication, serverState_snapshot) {
+	int clientID = performRegistrationAndDrain();
+
+	auto call = [&](const std::string &function, nlohmann::json parameter) {
+		parameter["connection"] = API_Mock::activeConnetion;
+
+		// clang-format off
+		nlohmann::json message = {
+			{"message_type", "api_call"},
+			{"client_id", clientID},
+			{"secret", clientSecret},
+			{"message",
+				{
+					{"function", function},
+					{"parameter", parameter}
+				}
+			}
+		};
+		// clang-format on
+
+		NamedPipe::write(m_bridge.s_pipePath, message.dump());
+
+		nlohmann::json answer = nlohmann::json::parse(m_clientPipe.read_blocking(READ_TIMEOUT));
+
+		EXPECT_EQ(answer["response_type"].get< std::string >(), "api_call");
+		EXPECT_EQ(answer["response"]["function"].get< std::string >(), function);
+
+		return answer["response"]["return_value"];
+	};
+
+	ServerState &state = m_bridge.getServerState();
+
+	state.onServerSynchronized(API_Mock::activeConnetion);
+	API_Mock::calledFunctions.clear();
+
+	nlohmann::json snapshot = call("getServerSnapshot", nlohmann::json::object());
+
+	// The snapshot is taken at the current version
+	const std::uint64_t version = snapshot["version"].get< std::uint64_t >();
+	ASSERT_EQ(version, state.getVersion());
+
+	ASSERT_EQ(snapshot["users"].size(), 2);
+	ASSERT_EQ(snapshot["users"][1]["id"].get< mumble_userid_t >(), API_Mock::otherUserID);
+	ASSERT_EQ(snapshot["users"][1]["name"].get< std::string >(), API_Mock::otherUserName);
+	ASSERT_EQ(snapshot["users"][1]["channel"].get< mumble_channelid_t >(), API_Mock::otherUserChannel);
+	ASSERT_TRUE(snapshot["users"][1]["locally_muted"].get< bool >());
+	ASSERT_EQ(snapshot["channels"].size(), 2);
+	ASSERT_EQ(snapshot["channels"][0]["name"].get< std::string >(), API_Mock::otherUserChannelName);
+
+	// Only what the model doesn't keep is looked up via the API
+	ASSERT_API_CALL_HAPPENED("isUserLocallyMuted", 2);
+	ASSERT_API_CALL_HAPPENED("getChannelDescription", 2);
+	ASSERT_API_CALL_HAPPENED("freeMemory", 2);
+	ASSERT_TRUE(API_Mock::calledFunctions.empty());
+
+	// Nothing has changed since the snapshot has been taken
+	nlohmann::json changes = call("getChangesSince", { { "version", version } });
+	ASSERT_FALSE(changes["resync"].get< bool >());
+	ASSERT_EQ(changes["version"].get< std::uint64_t >(), version);
+	ASSERT_TRUE(changes["users"].empty());
+
+	// Whereas changes after the snapshot are reported relative to it
+	state.onChannelEntered(API_Mock::activeConnetion, API_Mock::otherUserID, API_Mock::otherUserChannel,
+						   API_Mock::localUserChannel);
+
+	changes = call("getChangesSince", { { "version", version } });
+	ASSERT_FALSE(changes["resync"].get< bool >());
+	ASSERT_EQ(changes["version"].get< std::uint64_t >(), version + 1);
+	ASSERT_EQ(changes["users"].size(), 1);
+	ASSERT_EQ(changes["users"][0]["id"].get< mumble_userid_t >(), API_Mock::otherUserID);
+	ASSERT_EQ(changes["users"][0]["channel"].get< mumble_channelid_t >(), API_Mock::localUserChannel);
+
+	ASSERT_EQ(call("getServerSnapshot", nlohmann::json::object())["version"].get< std::uint64_t >(), version + 1);
+
+	API_Mock::calledFunctions.clear();
+}
+
 TEST_F(BridgeCommunication, findUserByName) {
 	int clientID = performRegistrationAndDrain();
 
@@ -657,6 +1155,88 @@ TEST_F(BridgeCommunication, error_wrongParamType) {
 	ASSERT_TRUE(errorMsg.find("string") != std::string::npos);
 }
 
+TEST_F(BridgeCommunication, apiCall_anyFieldOrder) {
+	int clientID = performRegistrationAndDrain();
+
+	// Requests are usually read without building a JSON DOM for them. A parameter that precedes the function it
+	// belongs to can't be read that way, so this request has to take the regular route through the DOM.
+	std::string parameterFirst = std::string("{\"secret\":\"") + clientSecret + "\",\"client_id\":"
+								 + std::to_string(clientID) + ",\"message\":{\"parameter\":{\"user_id\":"
+								 + std::to_string(API_Mock::localUserID)
+								 + ",\"connection\":" + std::to_string(API_Mock::activeConnetion)
+								 + "},\"function\":\"getUserName\"},\"message_type\":\"API_CALL\"}";
+	std::string functionFirst = std::string("{\"secret\":\"") + clientSecret + "\",\"client_id\":"
+								+ std::to_string(clientID) + ",\"message\":{\"function\":\"getUserName\","
+								+ "\"parameter\":{\"user_id\":" + std::to_string(API_Mock::localUserID)
+								+ ",\"connection\":" + std::to_string(API_Mock::activeConnetion)
+								+ "}},\"message_type\":\"API_CALL\"}";
+
+	for (const std::string &message : { parameterFirst, functionFirst }) {
+		NamedPipe::write(m_bridge.s_pipePath, message);
+
+		nlohmann::json answer = nlohmann::json::parse(m_clientPipe.read_blocking(READ_TIMEOUT));
+
+		checkAnswer(answer);
+
+		ASSERT_EQ(answer["response_type"].get< std::string >(), "api_call");
+		ASSERT_EQ(answer["response"]["return_value"].get< std::string >(), API_Mock::localUserName);
+	}
+
+	ASSERT_API_CALL_HAPPENED("getUserName", 2);
+	ASSERT_API_CALL_HAPPENED("freeMemory", 2);
+}
+
+TEST_F(BridgeCommunication, apiCall_escapedStrings) {
+	int clientID = performRegistrationAndDrain();
+
+	auto findUser = [&](const std::string &escapedName) {
+		return std::string("{\"message_type\":\"api_call\",\"client_id\":") + std::to_string(clientID)
+			   + ",\"secret\":\"" + clientSecret
+			   + "\",\"message\":{\"function\":\"findUserByName\",\"parameter\":{\"connection\":"
+			   + std::to_string(API_Mock::activeConnetion) + ",\"user_name\":\"" + escapedName + "\"}}}";
+	};
+
+	// Escape sequences are decoded while reading the request (including escaped surrogate pairs)
+	for (const std::string &name : { std::string("Local\\u0020user"), std::string("\\u004cocal\\tuser"),
+									 std::string("\\ud83d\\ude00 \xc3\xa4"), std::string("Local user") }) {
+		NamedPipe::write(m_bridge.s_pipePath, findUser(name));
+
+		nlohmann::json answer = nlohmann::json::parse(m_clientPipe.read_blocking(READ_TIMEOUT));
+
+		checkAnswer(answer);
+
+		// Only the first and the last name decode to the local user's name
+		if (name == "Local\\u0020user" || name == "Local user") {
+			ASSERT_EQ(answer["response_type"].get< std::string >(), "api_call") << name;
+			ASSERT_EQ(answer["response"]["return_value"].get< unsigned int >(), API_Mock::localUserID);
+		} else {
+			ASSERT_EQ(answer["response_type"].get< std::string >(), "api_error") << name;
+		}
+	}
+
+	ASSERT_API_CALL_HAPPENED("findUserByName", 4);
+
+	// Requests that aren't read directly still get the same treatment as before: A number that doesn't fit into 64 bits
+	// yields an error, invalid escape sequences and invalid UTF-8 aren't accepted at all.
+	NamedPipe::write(m_bridge.s_pipePath,
+					 "{\"message_type\":\"api_call\",\"client_id\":" + std::to_string(clientID) + ",\"secret\":\""
+						 + clientSecret
+						 + "\",\"message\":{\"function\":\"getLocalUserID\",\"parameter\":{\"connection\":"
+						   "18446744073709551616}}}");
+
+	nlohmann::json answer = nlohmann::json::parse(m_clientPipe.read_blocking(READ_TIMEOUT));
+
+	checkAnswer(answer);
+	ASSERT_EQ(answer["response_type"].get< std::string >(), "error");
+
+	for (const std::string &name : { std::string("\\ud83d"), std::string("\\x41"), std::string("\xc0\xaf") }) {
+		NamedPipe::write(m_bridge.s_pipePath, findUser(name));
+
+		std::string content;
+		ASSERT_THROW(content = m_clientPipe.read_blocking(100), TimeoutException) << name;
+	}
+}
+
 TEST_F(BridgeCommunication, error_invalidJSON) {
 	int clientID = performRegistrationAndDrain();
 
@@ -667,3 +1247,1008 @@ TEST_F(BridgeCommunication, error_invalidJSON) {
 	std::string answer;
 	ASSERT_THROW(answer = m_clientPipe.read_blocking(100), TimeoutException);
 }
+
+TEST_F(BridgeCommunication, envelope_invalidTrafficIsCounted) {
+	// The limits can only be changed while the Bridge is not running
+	m_bridge.stop(true);
+	InboundLimits limits;
+	limits.maxMessageSize      = 64 * 1024;
+	limits.maxRegistrationSize = 1024;
+	m_bridge.setInboundLimits(limits);
+	m_bridge.start();
+
+	int clientID = performRegistrationAndDrain();
+
+	// clang-format off
+	nlohmann::json request = {
+		{"message_type", "api_call"},
+		{"client_id", clientID},
+		{"secret", clientSecret},
+		{"message",
+			{
+				{"function", "getLocalUserID"},
+				{"parameter",
+					{
+						{"connection", API_Mock::activeConnetion}
+					}
+				}
+			}
+		}
+	};
+	nlohmann::json registration = {
+		{"message_type", "registration"},
+		{"message",
+			{
+				{"pipe_path", clientPipePath.string()},
+				{"secret", clientSecret}
+			}
+		}
+	};
+	// clang-format on
+
+	// Some of the messages are incomplete, so they have to be framed in order to not run into each other
+
+	// Messages exceeding the limits. The sender is told about it, if it can be identified.
+	nlohmann::json oversized        = request;
+	oversized["message"]["padding"] = std::string(64 * 1024, 'x');
+	oversized["request_id"]         = 42;
+	NamedPipe::write(m_bridge.s_pipePath, oversized.dump(), 1000, Framing::NEWLINE);
+
+	nlohmann::json answer = nlohmann::json::parse(m_clientPipe.read_blocking(READ_TIMEOUT));
+	ASSERT_EQ(answer["request_id"], 42);
+	answer.erase("request_id");
+	checkAnswer(answer);
+	ASSERT_EQ(answer["response_type"].get< std::string >(), "error");
+	ASSERT_NE(answer["response"]["error_message"].get< std::string >().find("maximum size"), std::string::npos);
+
+	oversized                       = registration;
+	oversized["message"]["padding"] = std::string(1024, 'x');
+	NamedPipe::write(m_bridge.s_pipePath, oversized.dump(), 1000, Framing::NEWLINE);
+
+	// A message whose envelope can't be read. (A message that has been cut short would swallow the following ones, as
+	// newlines within a message don't end it.)
+	NamedPipe::write(m_bridge.s_pipePath, "{\"message_type\":\"api_call\",\"client_id\":}", 1000, Framing::NEWLINE);
+
+	// Messages of unknown clients are discarded without ever looking at their (invalid) body
+	std::string unknownClient = "{\"message_type\":\"api_call\",\"client_id\":" + std::to_string(clientID + 1)
+								+ ",\"secret\":\"" + clientSecret + "\",\"message\":{\"function\":tru}}";
+	NamedPipe::write(m_bridge.s_pipePath, unknownClient, 1000, Framing::NEWLINE);
+
+	// Whereas the body of an authenticated message is parsed (and found to be invalid)
+	std::string invalidBody = "{\"message_type\":\"api_call\",\"client_id\":" + std::to_string(clientID)
+							  + ",\"secret\":\"" + clientSecret + "\",\"message\":{\"function\":tru}}";
+	NamedPipe::write(m_bridge.s_pipePath, invalidBody, 1000, Framing::NEWLINE);
+
+	// The owner of the ID is still told about a wrong secret
+	nlohmann::json wrongSecret = request;
+	wrongSecret["secret"]      = "I am wrong";
+	NamedPipe::write(m_bridge.s_pipePath, wrongSecret.dump(), 1000, Framing::NEWLINE);
+
+	answer = nlohmann::json::parse(m_clientPipe.read_blocking(READ_TIMEOUT));
+	checkAnswer(answer);
+	ASSERT_EQ(answer["response_type"].get< std::string >(), "error");
+
+	// Messages are processed in order, so once this request has been answered, all previous ones have been handled
+	NamedPipe::write(m_bridge.s_pipePath, request.dump(), 1000, Framing::NEWLINE);
+
+	answer = nlohmann::json::parse(m_clientPipe.read_blocking(READ_TIMEOUT));
+	checkAnswer(answer);
+	ASSERT_EQ(answer["response_type"].get< std::string >(), "api_call");
+
+	ASSERT_API_CALL_HAPPENED("getLocalUserID", 1);
+
+	const InboundStatistics &statistics = m_bridge.getInboundStatistics();
+	ASSERT_EQ(statistics.receivedMessages, 8);
+	ASSERT_EQ(statistics.oversizedMessages, 2);
+	ASSERT_EQ(statistics.malformedMessages, 2);
+	ASSERT_EQ(statistics.unauthenticatedMessages, 2);
+}
+
+TEST_F(BridgeCommunication, error_unexpectedExceptionsDontStopTheBridge) {
+	// clang-format off
+	nlohmann::json request = {
+		{"message_type", "api_call"},
+		{"secret", clientSecret},
+		{"message",
+			{
+				{"function", "getLocalUserID"},
+				{"parameter",
+					{
+						{"connection", API_Mock::activeConnetion}
+					}
+				}
+			}
+		}
+	};
+	// clang-format on
+
+	// Looking for somebody to report the missing message body to runs into a client ID of the wrong type
+	const std::string invalidClientID = "{\"message_type\":\"registration\",\"client_id\":\"me\"}";
+
+	for (int parseThreads : { 1, 0 }) {
+		m_bridge.stop(true);
+		PipelineConfig config;
+		config.parseThreads = parseThreads;
+		m_bridge.setPipelineConfig(config);
+		m_bridge.start();
+
+		// Every start of the Bridge comes with a new secret
+		request["client_id"] = performRegistrationAndDrain();
+
+		NamedPipe::write(m_bridge.s_pipePath, invalidClientID, 1000, Framing::NEWLINE);
+
+		// The following messages are still processed
+		NamedPipe::write(m_bridge.s_pipePath, request.dump(), 1000, Framing::NEWLINE);
+
+		nlohmann::json answer = nlohmann::json::parse(m_clientPipe.read_blocking(READ_TIMEOUT));
+		checkAnswer(answer);
+		ASSERT_EQ(answer["response_type"].get< std::string >(), "api_call");
+	}
+
+	ASSERT_API_CALL_HAPPENED("getLocalUserID", 2);
+
+	ASSERT_EQ(m_bridge.getInboundStatistics().malformedMessages, 2);
+}
+
+/**
+ * A connection whose every attempt at receiving fails (like a socket in a persistent error state)
+ */
+class FailingConnection : public Transports::Connection {
+public:
+	std::atomic_int &m_receiveAttempts;
+	std::promise< void > &m_destroyed;
+
+	FailingConnection(std::atomic_int &receiveAttempts, std::promise< void > &destroyed)
+		: m_receiveAttempts(receiveAttempts), m_destroyed(destroyed) {}
+
+	~FailingConnection() { m_destroyed.set_value(); }
+
+	Transports::Status trySend(std::string_view data, std::size_t &sent) override {
+		sent = data.size();
+		return Transports::Status::OK;
+	}
+
+	void send(std::string_view, unsigned int) override {}
+
+	Transports::Status tryReceive(std::string_view &) override {
+		m_receiveAttempts++;
+		throw PipeException< int >(EIO, "Receive");
+	}
+
+	std::string receive(unsigned int) override { return {}; }
+
+	void watch(EventLoop &loop, std::function< void() > onReadable, std::function< void() >) override {
+		// The connection is always readable
+		loop.post(onReadable);
+	}
+
+	void setWriteInterest(bool) override {}
+	void setReadInterest(bool) override {}
+	void unwatch() noexcept override {}
+};
+
+/**
+ * A listener handing out a single FailingConnection
+ */
+class FailingListener : public Transports::Listener {
+public:
+	std::atomic_int &m_receiveAttempts;
+	std::promise< void > &m_destroyed;
+
+	FailingListener(std::atomic_int &receiveAttempts, std::promise< void > &destroyed)
+		: m_receiveAttempts(receiveAttempts), m_destroyed(destroyed) {}
+
+	void start(EventLoop &, connection_callback_t onConnection, message_callback_t, discard_callback_t) override {
+		onConnection(std::make_unique< FailingConnection >(m_receiveAttempts, m_destroyed));
+	}
+
+	void stop() noexcept override {}
+
+	std::string getAddress() const override { return "failing"; }
+};
+
+TEST_F(BridgeCommunication, error_receiveErrorsDisconnectTheClient) {
+	std::atomic_int receiveAttempts(0);
+	std::promise< void > destroyed;
+
+	// Listeners can only be added while the Bridge is not running
+	m_bridge.stop(true);
+	m_bridge.addListener(std::make_unique< FailingListener >(receiveAttempts, destroyed));
+	m_bridge.start();
+
+	// Instead of retrying the failing connection over and over again, the client is dropped right away
+	ASSERT_EQ(destroyed.get_future().wait_for(std::chrono::milliseconds(READ_TIMEOUT)), std::future_status::ready);
+	ASSERT_EQ(receiveAttempts, 1);
+}
+
+TEST_F(BridgeCommunication, framing_pipelinedRequests) {
+	// clang-format off
+	nlohmann::json registration = {
+		{"message_type", "registration"},
+		{"message",
+			{
+				{"pipe_path", clientPipePath.string()},
+				{"secret", clientSecret},
+				{"framing", "newline"}
+			}
+		}
+	};
+	// clang-format on
+
+	NamedPipe::write(m_bridge.s_pipePath, registration.dump(), 1000, Framing::NEWLINE);
+
+	std::vector< std::string > frames = m_clientPipe.read_frames(READ_TIMEOUT);
+	ASSERT_EQ(frames.size(), 1);
+
+	nlohmann::json answer = nlohmann::json::parse(frames[0]);
+	checkAnswer(answer);
+	ASSERT_EQ(answer["response_type"].get< std::string >(), "registration");
+	ASSERT_FIELD(answer["response"], "framing", string);
+	ASSERT_EQ(answer["response"]["framing"].get< std::string >(), "newline");
+
+	m_bridgeSecret = answer["secret"].get< std::string >();
+	int clientID   = answer["response"]["client_id"].get< int >();
+
+	// clang-format off
+	nlohmann::json message = {
+		{"message_type", "api_call"},
+		{"client_id", clientID},
+		{"secret", clientSecret},
+		{"message",
+			{
+				{"function", "getLocalUserID"},
+				{"parameter", 
+					{
+						{"connection", API_Mock::activeConnetion}
+					}
+				}
+			}
+		}
+	};
+	// clang-format on
+
+	// Write two requests in a single go without waiting for the first response
+	NamedPipe::write(m_bridge.s_pipePath, frame(message.dump(), Framing::NEWLINE) + message.dump(), 1000,
+					 Framing::NEWLINE);
+
+	std::vector< std::string > responses;
+	while (responses.size() < 2) {
+		for (std::string &current : m_clientPipe.read_frames(READ_TIMEOUT)) {
+			responses.push_back(std::move(current));
+		}
+	}
+
+	ASSERT_EQ(responses.size(), 2);
+
+	for (const std::string &current : responses) {
+		nlohmann::json response = nlohmann::json::parse(current);
+
+		checkAnswer(response);
+
+		ASSERT_EQ(response["response_type"].get< std::string >(), "api_call");
+		ASSERT_EQ(response["response"]["return_value"].get< unsigned int >(), API_Mock::localUserID);
+	}
+
+	ASSERT_API_CALL_HAPPENED("getLocalUserID", 2);
+}
+
+TEST_F(BridgeCommunication, requestID_isEchoed) {
+	// clang-format off
+	nlohmann::json registration = {
+		{"message_type", "registration"},
+		{"request_id", "registration"},
+		{"message",
+			{
+				{"pipe_path", clientPipePath.string()},
+				{"secret", clientSecret}
+			}
+		}
+	};
+	// clang-format on
+
+	NamedPipe::write(m_bridge.s_pipePath, registration.dump());
+
+	nlohmann::json answer = nlohmann::json::parse(m_clientPipe.read_blocking(READ_TIMEOUT));
+
+	ASSERT_EQ(answer["request_id"], "registration");
+	answer.erase("request_id");
+	checkAnswer(answer);
+
+	m_bridgeSecret = answer["secret"].get< std::string >();
+	int clientID   = answer["response"]["client_id"].get< int >();
+
+	// clang-format off
+	nlohmann::json message = {
+		{"message_type", "api_call"},
+		{"client_id", clientID},
+		{"secret", clientSecret},
+		{"request_id", 42},
+		{"message",
+			{
+				{"function", "getLocalUserID"},
+				{"parameter",
+					{
+						{"connection", API_Mock::activeConnetion}
+					}
+				}
+			}
+		}
+	};
+	// clang-format on
+
+	NamedPipe::write(m_bridge.s_pipePath, message.dump());
+
+	answer = nlohmann::json::parse(m_clientPipe.read_blocking(READ_TIMEOUT));
+
+	ASSERT_EQ(answer["request_id"], 42);
+	answer.erase("request_id");
+	checkAnswer(answer);
+	ASSERT_EQ(answer["response_type"].get< std::string >(), "api_call");
+
+	// Error responses carry the request ID as well
+	message["request_id"] = "invalid";
+	message["message"].erase("function");
+
+	NamedPipe::write(m_bridge.s_pipePath, message.dump());
+
+	answer = nlohmann::json::parse(m_clientPipe.read_blocking(READ_TIMEOUT));
+
+	ASSERT_EQ(answer["request_id"], "invalid");
+	answer.erase("request_id");
+	checkAnswer(answer);
+	ASSERT_EQ(answer["response_type"].get< std::string >(), "error");
+
+	// A request ID that is neither a string nor an integer can't be echoed
+	message["request_id"] = nlohmann::json::object();
+
+	NamedPipe::write(m_bridge.s_pipePath, message.dump());
+
+	answer = nlohmann::json::parse(m_clientPipe.read_blocking(READ_TIMEOUT));
+
+	checkAnswer(answer);
+	ASSERT_EQ(answer["response_type"].get< std::string >(), "error");
+	ASSERT_TRUE(answer["response"]["error_message"].get< std::string >().find("request_id") != std::string::npos);
+
+	ASSERT_API_CALL_HAPPENED("getLocalUserID", 1);
+}
+
+TEST_F(BridgeCommunication, batch) {
+	int clientID = performRegistrationAndDrain();
+
+	// clang-format off
+	nlohmann::json message = {
+		{"message_type", "batch"},
+		{"client_id", clientID},
+		{"secret", clientSecret},
+		{"message",
+			{
+				{"calls",
+					{
+						{
+							{"function", "getLocalUserID"},
+							{"parameter",
+								{
+									{"connection", API_Mock::activeConnetion}
+								}
+							}
+						},
+						{
+							{"function", "getUserName"},
+							{"parameter",
+								{
+									{"connection", API_Mock::activeConnetion},
+									{"user_id", API_Mock::localUserID}
+								}
+							}
+						},
+						{
+							{"function", "getLocalUserID"},
+							{"parameter",
+								{
+									{"connection", API_Mock::activeConnetion + 1}
+								}
+							}
+						},
+						{
+							{"function", "doesNotExist"}
+						},
+						{
+							{"function", "getLocalUserID"},
+							{"parameter",
+								{
+									{"connection", API_Mock::activeConnetion}
+								}
+							}
+						}
+					}
+				}
+			}
+		}
+	};
+	// clang-format on
+
+	NamedPipe::write(m_bridge.s_pipePath, message.dump());
+
+	nlohmann::json answer = nlohmann::json::parse(m_clientPipe.read_blocking(READ_TIMEOUT));
+
+	checkAnswer(answer);
+
+	ASSERT_EQ(answer["response_type"].get< std::string >(), "batch");
+	ASSERT_FIELD(answer["response"], "results", array);
+
+	const nlohmann::json &results = answer["response"]["results"];
+
+	// A failing call doesn't prevent the following ones from being executed
+	ASSERT_EQ(answer["response"]["executed"].get< std::size_t >(), 5);
+	ASSERT_EQ(results.size(), 5);
+
+	ASSERT_EQ(results[0]["response_type"].get< std::string >(), "api_call");
+	ASSERT_FALSE(results[0].contains("secret"));
+	ASSERT_EQ(results[0]["response"]["function"].get< std::string >(), "getLocalUserID");
+	ASSERT_EQ(results[0]["response"]["return_value"].get< unsigned int >(), API_Mock::localUserID);
+
+	ASSERT_EQ(results[1]["response_type"].get< std::string >(), "api_call");
+	ASSERT_EQ(results[1]["response"]["return_value"].get< std::string >(), API_Mock::localUserName);
+
+	ASSERT_EQ(results[2]["response_type"].get< std::string >(), "api_error");
+	ASSERT_EQ(results[3]["response_type"].get< std::string >(), "error");
+	ASSERT_EQ(results[4]["response_type"].get< std::string >(), "api_call");
+
+	ASSERT_API_CALL_HAPPENED("getLocalUserID", 3);
+	ASSERT_API_CALL_HAPPENED("getUserName", 1);
+	ASSERT_API_CALL_HAPPENED("freeMemory", 1);
+
+	// The remaining calls are skipped once a call has failed
+	message["message"]["stop_on_error"] = true;
+
+	NamedPipe::write(m_bridge.s_pipePath, message.dump());
+
+	answer = nlohmann::json::parse(m_clientPipe.read_blocking(READ_TIMEOUT));
+
+	checkAnswer(answer);
+
+	ASSERT_EQ(answer["response_type"].get< std::string >(), "batch");
+	ASSERT_EQ(answer["response"]["executed"].get< std::size_t >(), 3);
+	ASSERT_EQ(answer["response"]["results"].size(), 3);
+	ASSERT_EQ(answer["response"]["results"][2]["response_type"].get< std::string >(), "api_error");
+
+	ASSERT_API_CALL_HAPPENED("getLocalUserID", 2);
+	ASSERT_API_CALL_HAPPENED("getUserName", 1);
+	ASSERT_API_CALL_HAPPENED("freeMemory", 1);
+}
+
+TEST_F(BridgeCommunication, error_batchWithoutCalls) {
+	int clientID = performRegistrationAndDrain();
+
+	// clang-format off
+	nlohmann::json message = {
+		{"message_type", "batch"},
+		{"client_id", clientID},
+		{"secret", clientSecret},
+		{"message",
+			{
+				{"calls", "getLocalUserID"}
+			}
+		}
+	};
+	// clang-format on
+
+	NamedPipe::write(m_bridge.s_pipePath, message.dump());
+
+	nlohmann::json answer = nlohmann::json::parse(m_clientPipe.read_blocking(READ_TIMEOUT));
+
+	checkAnswer(answer);
+
+	ASSERT_EQ(answer["response_type"].get< std::string >(), "error");
+}
+
+TEST_F(BridgeCommunication, events_arePushedToSubscribers) {
+	int clientID = performRegistrationAndDrain();
+
+	auto subscription = [&](const std::string &type, const std::vector< std::string > &topics) {
+		// clang-format off
+		nlohmann::json message = {
+			{"message_type", type},
+			{"client_id", clientID},
+			{"secret", clientSecret},
+			{"message",
+				{
+					{"topics", topics}
+				}
+			}
+		};
+		// clang-format on
+
+		NamedPipe::write(m_bridge.s_pipePath, message.dump());
+
+		nlohmann::json answer = nlohmann::json::parse(m_clientPipe.read_blocking(READ_TIMEOUT));
+
+		checkAnswer(answer);
+		EXPECT_EQ(answer["response_type"].get< std::string >(), type);
+
+		return answer["response"]["topics"].get< std::vector< std::string > >();
+	};
+
+	Event talking;
+	talking.topic        = EventTopic::TALKING_STATE;
+	talking.connection   = API_Mock::activeConnetion;
+	talking.userID       = API_Mock::otherUserID;
+	talking.talkingState = MUMBLE_TS_TALKING;
+
+	Event entered;
+	entered.topic             = EventTopic::CHANNEL_ENTERED;
+	entered.connection        = API_Mock::activeConnetion;
+	entered.userID            = API_Mock::otherUserID;
+	entered.channelID         = API_Mock::localUserChannel;
+	entered.previousChannelID = API_Mock::otherUserChannel;
+
+	Event connected;
+	connected.topic      = EventTopic::SERVER_CONNECTED;
+	connected.connection = API_Mock::activeConnetion;
+
+	// Nobody is interested in any events yet
+	m_bridge.publish(talking);
+
+	ASSERT_EQ(subscription("subscribe", { "channel_entered", "server_connected" }),
+			  std::vector< std::string >({ "channel_entered", "server_connected" }));
+	ASSERT_EQ(subscription("subscribe", { "talking_state" }),
+			  std::vector< std::string >({ "talking_state", "channel_entered", "server_connected" }));
+
+	// The client pipe isn't framed, so the events are read one by one
+	m_bridge.publish(talking);
+
+	nlohmann::json event = nlohmann::json::parse(m_clientPipe.read_blocking(READ_TIMEOUT));
+
+	checkAnswer(event);
+	ASSERT_EQ(event["response_type"].get< std::string >(), "event");
+	// Talking-state changes are pushed in coalesced frames
+	ASSERT_EQ(event["response"],
+			  nlohmann::json({ { "topic", "talking_state" },
+							   { "changes", { { API_Mock::activeConnetion, API_Mock::otherUserID, "talking" } } },
+							   { "merged", 0 },
+							   { "dropped", 0 } }));
+
+	m_bridge.publish(entered);
+
+	event = nlohmann::json::parse(m_clientPipe.read_blocking(READ_TIMEOUT));
+
+	checkAnswer(event);
+	ASSERT_EQ(event["response"],
+			  nlohmann::json({ { "topic", "channel_entered" },
+							   { "connection", API_Mock::activeConnetion },
+							   { "user_id", API_Mock::otherUserID },
+							   { "channel_id", API_Mock::localUserChannel },
+							   { "previous_channel_id", API_Mock::otherUserChannel } }));
+
+	ASSERT_EQ(subscription("unsubscribe", { "talking_state", "channel_entered" }),
+			  std::vector< std::string >({ "server_connected" }));
+
+	// Only the event the client is still subscribed to is pushed
+	m_bridge.publish(talking);
+	m_bridge.publish(entered);
+	m_bridge.publish(connected);
+
+	event = nlohmann::json::parse(m_clientPipe.read_blocking(READ_TIMEOUT));
+
+	checkAnswer(event);
+	ASSERT_EQ(event["response"],
+			  nlohmann::json({ { "topic", "server_connected" }, { "connection", API_Mock::activeConnetion } }));
+}
+
+TEST_F(BridgeCommunication, events_talkingStatesAreCoalesced) {
+	int clientID = performRegistrationAndDrain();
+
+	// clang-format off
+	nlohmann::json message = {
+		{"message_type", "subscribe"},
+		{"client_id", clientID},
+		{"secret", clientSecret},
+		{"message",
+			{
+				{"topics", { "talking_state" }},
+				{"talking_state_window", 200},
+				{"talking_state_max_rate", 0}
+			}
+		}
+	};
+	// clang-format on
+
+	NamedPipe::write(m_bridge.s_pipePath, message.dump());
+
+	nlohmann::json answer = nlohmann::json::parse(m_clientPipe.read_blocking(READ_TIMEOUT));
+	checkAnswer(answer);
+	ASSERT_EQ(answer["response_type"].get< std::string >(), "subscribe");
+
+	Event event;
+	event.topic      = EventTopic::TALKING_STATE;
+	event.connection = API_Mock::activeConnetion;
+
+	// A burst of changes ends up in a single frame that only holds the latest state of each user
+	for (mumble_talking_state_t state : { MUMBLE_TS_TALKING, MUMBLE_TS_PASSIVE, MUMBLE_TS_TALKING }) {
+		event.userID       = API_Mock::otherUserID;
+		event.talkingState = state;
+		m_bridge.publish(event);
+	}
+	event.userID       = API_Mock::localUserID;
+	event.talkingState = MUMBLE_TS_WHISPERING;
+	m_bridge.publish(event);
+
+	nlohmann::json frame = nlohmann::json::parse(m_clientPipe.read_blocking(READ_TIMEOUT));
+
+	checkAnswer(frame);
+	ASSERT_EQ(frame["response_type"].get< std::string >(), "event");
+	ASSERT_EQ(frame["response"]["topic"], "talking_state");
+	ASSERT_EQ(frame["response"]["changes"],
+			  nlohmann::json({ { API_Mock::activeConnetion, API_Mock::otherUserID, "talking" },
+							   { API_Mock::activeConnetion, API_Mock::localUserID, "whispering" } }));
+	ASSERT_EQ(frame["response"]["merged"], 2);
+	ASSERT_EQ(frame["response"]["dropped"], 0);
+
+	const TalkingStateStatistics &statistics = m_bridge.getTalkingStateStatistics();
+	ASSERT_EQ(statistics.recordedChanges, 4u);
+	ASSERT_EQ(statistics.mergedChanges, 2u);
+	ASSERT_EQ(statistics.sentFrames, 1u);
+}
+
+TEST_F(BridgeCommunication, error_subscriptionToUnknownTopic) {
+	int clientID = performRegistrationAndDrain();
+
+	// clang-format off
+	nlohmann::json message = {
+		{"message_type", "subscribe"},
+		{"client_id", clientID},
+		{"secret", clientSecret},
+		{"message",
+			{
+				{"topics", { "talking_state", "weather" }}
+			}
+		}
+	};
+	// clang-format on
+
+	NamedPipe::write(m_bridge.s_pipePath, message.dump());
+
+	nlohmann::json answer = nlohmann::json::parse(m_clientPipe.read_blocking(READ_TIMEOUT));
+
+	checkAnswer(answer);
+
+	ASSERT_EQ(answer["response_type"].get< std::string >(), "error");
+	ASSERT_EQ(answer["response"]["error_message"].get< std::string >(), "The given topic \"weather\" is unknown");
+}
+
+#ifdef PLATFORM_UNIX
+TEST_F(BridgeCommunication, outboundQueue_slowClientDoesNotBlock) {
+	// The limit can only be changed while the Bridge is not running
+	m_bridge.stop(true);
+	m_bridge.setOutboundQueueLimit(16 * 1024, OverflowPolicy::DROP);
+	m_bridge.start();
+
+	// A client that keeps its pipe open but never reads from it
+	NamedPipe slowPipe = NamedPipe::create(std::filesystem::path(PIPEDIR) / ".slow-client-pipe");
+	slowPipe.openPersistentReader();
+
+	// clang-format off
+	nlohmann::json registration = {
+		{"message_type", "registration"},
+		{"message",
+			{
+				{"pipe_path", slowPipe.getPath().string()},
+				{"secret", clientSecret},
+				{"framing", "newline"}
+			}
+		}
+	};
+	// clang-format on
+
+	NamedPipe::write(m_bridge.s_pipePath, registration.dump(), 1000, Framing::NEWLINE);
+
+	std::vector< std::string > frames = slowPipe.read_frames(READ_TIMEOUT);
+	ASSERT_EQ(frames.size(), 1);
+	int slowClientID = nlohmann::json::parse(frames[0])["response"]["client_id"].get< int >();
+
+	// clang-format off
+	nlohmann::json request = {
+		{"message_type", "api_call"},
+		{"client_id", slowClientID},
+		{"secret", clientSecret},
+		{"message",
+			{
+				{"function", "getLocalUserID"},
+				{"parameter",
+					{
+						{"connection", API_Mock::activeConnetion}
+					}
+				}
+			}
+		}
+	};
+	// clang-format on
+
+	// Enough requests for the responses to exceed the pipe's buffer as well as the client's outbound queue
+	constexpr int requestCount = 2000;
+	std::string requests;
+	for (int i = 0; i < requestCount; i++) {
+		requests += frame(request.dump(), Framing::NEWLINE);
+	}
+	NamedPipe::write(m_bridge.s_pipePath, requests, 1000, Framing::NONE);
+
+	// Other clients are still served in time
+	int clientID = performRegistrationAndDrain();
+	request["client_id"] = clientID;
+
+	NamedPipe::write(m_bridge.s_pipePath, request.dump());
+
+	nlohmann::json answer = nlohmann::json::parse(m_clientPipe.read_blocking(READ_TIMEOUT));
+	checkAnswer(answer);
+	ASSERT_EQ(answer["response"]["return_value"].get< unsigned int >(), API_Mock::localUserID);
+
+	// The requests of the slow client might still be executed by another thread
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(READ_TIMEOUT);
+	while (API_Mock::getCallCount("getLocalUserID") < requestCount + 1
+		   && std::chrono::steady_clock::now() < deadline) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	ASSERT_API_CALL_HAPPENED("getLocalUserID", requestCount + 1);
+
+	// Make sure the Bridge has finished its bookkeeping for the last response
+	std::promise< void > synced;
+	m_bridge.post([&synced]() { synced.set_value(); });
+	synced.get_future().wait();
+
+	ASSERT_GT(m_bridge.getOutboundStatistics().droppedMessages, 0);
+	ASSERT_LE(m_bridge.getOutboundStatistics().queuedBytes, 16 * 1024);
+
+	slowPipe.destroy();
+}
+#endif
+
+#ifdef PLATFORM_UNIX
+TEST_F(BridgeCommunication, socket_apiCall) {
+	// Connecting is all it takes - there is no registration
+	SeqPacketSocket socket = SeqPacketSocket::connect(Bridge::s_socketAddress, READ_TIMEOUT);
+
+	// clang-format off
+	nlohmann::json message = {
+		{"message_type", "api_call"},
+		{"message",
+			{
+				{"function", "getLocalUserID"},
+				{"parameter",
+					{
+						{"connection", API_Mock::activeConnetion}
+					}
+				}
+			}
+		}
+	};
+	// clang-format on
+
+	// Messages keep their boundaries, so multiple requests can be sent without waiting for their responses
+	socket.send(message.dump());
+	socket.send(message.dump());
+
+	for (int i = 0; i < 2; i++) {
+		nlohmann::json answer = nlohmann::json::parse(socket.receive(READ_TIMEOUT));
+
+		checkAnswer(answer);
+		ASSERT_EQ(answer["response_type"].get< std::string >(), "api_call");
+		ASSERT_EQ(answer["response"]["return_value"].get< unsigned int >(), API_Mock::localUserID);
+	}
+
+	ASSERT_API_CALL_HAPPENED("getLocalUserID", 2);
+}
+
+TEST_F(BridgeCommunication, socket_registrationIsRejected) {
+	SeqPacketSocket socket = SeqPacketSocket::connect(Bridge::s_socketAddress, READ_TIMEOUT);
+
+	// clang-format off
+	nlohmann::json message = {
+		{"message_type", "registration"},
+		{"message",
+			{
+				{"pipe_path", clientPipePath.string()},
+				{"secret", clientSecret}
+			}
+		}
+	};
+	// clang-format on
+
+	socket.send(message.dump());
+
+	nlohmann::json answer = nlohmann::json::parse(socket.receive(READ_TIMEOUT));
+
+	checkAnswer(answer);
+	ASSERT_EQ(answer["response_type"].get< std::string >(), "error");
+}
+
+TEST_F(BridgeCommunication, socket_disconnect) {
+	SeqPacketSocket socket = SeqPacketSocket::connect(Bridge::s_socketAddress, READ_TIMEOUT);
+
+	socket.send(nlohmann::json({ { "message_type", "disconnect" } }).dump());
+
+	nlohmann::json answer = nlohmann::json::parse(socket.receive(READ_TIMEOUT));
+
+	checkAnswer(answer);
+	ASSERT_EQ(answer["response_type"].get< std::string >(), "disconnect");
+
+	// The Bridge closes the connection afterwards
+	ASSERT_THROW(socket.receive(READ_TIMEOUT), PipeException< int >);
+}
+
+TEST_F(BridgeCommunication, socket_binaryEncodings) {
+	for (Encoding encoding : { Encoding::CBOR, Encoding::MSGPACK }) {
+		SeqPacketSocket socket = SeqPacketSocket::connect(Bridge::s_socketAddress, READ_TIMEOUT);
+
+		// clang-format off
+		nlohmann::json registration = {
+			{"message_type", "registration"},
+			{"message",
+				{
+					{"transport", "socket"},
+					{"encoding", to_string(encoding)}
+				}
+			}
+		};
+		// clang-format on
+
+		socket.send(registration.dump());
+
+		// The confirmation is still sent as JSON
+		nlohmann::json answer = nlohmann::json::parse(socket.receive(READ_TIMEOUT));
+
+		checkAnswer(answer);
+		ASSERT_EQ(answer["response_type"].get< std::string >(), "registration");
+		ASSERT_EQ(answer["response"]["encoding"].get< std::string >(), to_string(encoding));
+
+		// clang-format off
+		nlohmann::json message = {
+			{"message_type", "api_call"},
+			{"request_id", 7},
+			{"message",
+				{
+					{"function", "getUserName"},
+					{"parameter",
+						{
+							{"connection", API_Mock::activeConnetion},
+							{"user_id", API_Mock::localUserID}
+						}
+					}
+				}
+			}
+		};
+		// clang-format on
+
+		socket.send(encode(message, encoding));
+
+		answer = decode(socket.receive(READ_TIMEOUT), encoding);
+
+		ASSERT_EQ(answer["request_id"].get< int >(), 7);
+		answer.erase("request_id");
+
+		checkAnswer(answer);
+		ASSERT_EQ(answer["response_type"].get< std::string >(), "api_call");
+		ASSERT_EQ(answer["response"]["return_value"].get< std::string >(), API_Mock::localUserName);
+
+		// Messages that can't be read with the DOM-free reader are decoded as well
+		message["message"]["parameter"]["unknown"] = true;
+
+		socket.send(encode(message, encoding));
+
+		answer = decode(socket.receive(READ_TIMEOUT), encoding);
+		answer.erase("request_id");
+
+		checkAnswer(answer);
+		ASSERT_EQ(answer["response_type"].get< std::string >(), "error");
+
+		// JSON text is no longer understood
+		message["message"]["parameter"].erase("unknown");
+		socket.send(message.dump());
+
+		ASSERT_THROW(socket.receive(100), TimeoutException);
+	}
+
+	ASSERT_API_CALL_HAPPENED("getUserName", 2);
+	ASSERT_API_CALL_HAPPENED("freeMemory", 2);
+}
+
+TEST_F(BridgeCommunication, sharedMemory_apiCall) {
+	SeqPacketSocket socket = SeqPacketSocket::connect(Bridge::s_socketAddress, READ_TIMEOUT);
+
+	// clang-format off
+	nlohmann::json registration = {
+		{"message_type", "registration"},
+		{"message",
+			{
+				{"transport", "shared_memory"}
+			}
+		}
+	};
+	// clang-format on
+
+	socket.send(registration.dump());
+
+	std::vector< int > handles;
+	nlohmann::json answer = nlohmann::json::parse(socket.receive(handles, READ_TIMEOUT));
+
+	checkAnswer(answer);
+	ASSERT_EQ(answer["response_type"].get< std::string >(), "registration");
+	ASSERT_EQ(answer["response"]["transport"].get< std::string >(), "shared_memory");
+	ASSERT_EQ(handles.size(), 3u);
+
+	SharedMemoryChannel channel = SharedMemoryChannel::attach(handles);
+	ASSERT_EQ(channel.getRingSize(), answer["response"]["ring_size"].get< std::size_t >());
+
+	// clang-format off
+	nlohmann::json message = {
+		{"message_type", "api_call"},
+		{"message",
+			{
+				{"function", "getLocalUserID"},
+				{"parameter",
+					{
+						{"connection", API_Mock::activeConnetion}
+					}
+				}
+			}
+		}
+	};
+	// clang-format on
+
+	// Send more requests than are processed per wakeup, without waiting for their responses
+	constexpr int requests = 100;
+	for (int i = 0; i < requests; i++) {
+		channel.send(message.dump());
+	}
+
+	for (int i = 0; i < requests; i++) {
+		answer = nlohmann::json::parse(channel.receive(READ_TIMEOUT));
+
+		checkAnswer(answer);
+		ASSERT_EQ(answer["response_type"].get< std::string >(), "api_call");
+		ASSERT_EQ(answer["response"]["return_value"].get< unsigned int >(), API_Mock::localUserID);
+	}
+
+	ASSERT_API_CALL_HAPPENED("getLocalUserID", requests);
+
+	// Switching to shared memory twice is not possible
+	channel.send(registration.dump());
+
+	answer = nlohmann::json::parse(channel.receive(READ_TIMEOUT));
+
+	checkAnswer(answer);
+	ASSERT_EQ(answer["response_type"].get< std::string >(), "error");
+}
+
+TEST_F(BridgeCommunication, pipeline_responsesKeepTheirOrder) { checkPipelinedResponseOrder(); }
+
+TEST_F(BridgeCommunication, pipeline_withoutWorkerThreads) {
+	// The thread counts can only be changed while the Bridge is not running
+	m_bridge.stop(true);
+
+	PipelineConfig config;
+	config.parseThreads         = 0;
+	config.executionThreads     = 0;
+	config.serializationThreads = 0;
+	m_bridge.setPipelineConfig(config);
+
+	m_bridge.start();
+
+	checkPipelinedResponseOrder();
+}
+
+TEST_F(BridgeCommunication, pipeline_manyWorkerThreads) {
+	m_bridge.stop(true);
+
+	PipelineConfig config;
+	config.parseThreads         = 4;
+	config.executionThreads     = 4;
+	config.serializationThreads = 4;
+	config.queueCapacity        = 1;
+	m_bridge.setPipelineConfig(config);
+
+	m_bridge.start();
+
+	checkPipelinedResponseOrder();
+}
+#endif
@@ -0,0 +1,223 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+#include "gtest/gtest.h"
+
+#include <mumble/json_bridge/Bridge.h>
+#include <mumble/json_bridge/NamedPipe.h>
+
+#include "API_mock.h"
+
+#include <nlohmann/json.hpp>
+
+#ifdef PLATFORM_UNIX
+#	include <fcntl.h>
+#	include <malloc.h>
+#	include <unistd.h>
+
+#	include <algorithm>
+#	include <atomic>
+#	include <cstdint>
+#	include <cstdlib>
+#	include <new>
+#	include <string>
+
+using namespace Mumble::JsonBridge;
+
+// All allocations of this process are tracked, so that the memory the Bridge uses while receiving hostile input can be
+// measured. The test itself takes care to not allocate anything large while the measurement is running.
+static std::atomic< std::int64_t > s_allocatedBytes(0);
+static std::atomic< std::int64_t > s_peakAllocatedBytes(0);
+
+static void *trackAllocation(void *ptr) {
+	if (!ptr) {
+		throw std::bad_alloc();
+	}
+
+	std::int64_t allocated = s_allocatedBytes += static_cast< std::int64_t >(malloc_usable_size(ptr));
+
+	std::int64_t peak = s_peakAllocatedBytes;
+	while (allocated > peak && !s_peakAllocatedBytes.compare_exchange_weak(peak, allocated)) {
+	}
+
+	return ptr;
+}
+
+static void trackDeallocation(void *ptr) noexcept {
+	if (ptr) {
+		s_allocatedBytes -= static_cast< std::int64_t >(malloc_usable_size(ptr));
+
+		std::free(ptr);
+	}
+}
+
+static void *alignedAllocation(std::size_t size, std::align_val_t alignment) {
+	std::size_t align = static_cast< std::size_t >(alignment);
+
+	// aligned_alloc requires the size to be a multiple of the alignment
+	return std::aligned_alloc(align, std::max(align, (size + align - 1) / align * align));
+}
+
+void *operator new(std::size_t size) { return trackAllocation(std::malloc(std::max(size, std::size_t(1)))); }
+void *operator new[](std::size_t size) { return trackAllocation(std::malloc(std::max(size, std::size_t(1)))); }
+void *operator new(std::size_t size, std::align_val_t alignment) {
+	return trackAllocation(alignedAllocation(size, alignment));
+}
+void *operator new[](std::size_t size, std::align_val_t alignment) {
+	return trackAllocation(alignedAllocation(size, alignment));
+}
+void operator delete(void *ptr) noexcept { trackDeallocation(ptr); }
+void operator delete[](void *ptr) noexcept { trackDeallocation(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { trackDeallocation(ptr); }
+void operator delete[](void *ptr, std::size_t) noexcept { trackDeallocation(ptr); }
+void operator delete(void *ptr, std::align_val_t) noexcept { trackDeallocation(ptr); }
+void operator delete[](void *ptr, std::align_val_t) noexcept { trackDeallocation(ptr); }
+void operator delete(void *ptr, std::size_t, std::align_val_t) noexcept { trackDeallocation(ptr); }
+void operator delete[](void *ptr, std::size_t, std::align_val_t) noexcept { trackDeallocation(ptr); }
+
+const std::filesystem::path clientPipePath(std::filesystem::path(".") / ".client-pipe");
+
+constexpr unsigned int READ_TIMEOUT = 5 * 1000;
+
+const std::string clientSecret = "superSecureClientSecret";
+
+/**
+ * The size of the hostile messages. This is far more than the Bridge is allowed to buffer.
+ */
+constexpr std::size_t HOSTILE_MESSAGE_SIZE = 8 * 1024 * 1024;
+
+class InboundLimitsTest : public ::testing::Test {
+protected:
+	MumbleAPI m_api;
+	Bridge m_bridge;
+	NamedPipe m_clientPipe;
+	int m_clientID = -1;
+	/**
+	 * The filler the hostile messages are made of. It is allocated up front, so that sending doesn't allocate.
+	 */
+	const std::string m_filler = std::string(64 * 1024, 'x');
+
+	InboundLimitsTest() : m_api(API_Mock::getMumbleAPI_v_1_2_x(), API_Mock::pluginID), m_bridge(m_api) {}
+
+	void SetUp() override {
+		InboundLimits limits;
+		limits.maxMessageSize = 64 * 1024;
+		m_bridge.setInboundLimits(limits);
+
+		m_clientPipe = NamedPipe::create(clientPipePath);
+		m_bridge.start();
+
+		// clang-format off
+		nlohmann::json registration = {
+			{"message_type", "registration"},
+			{"message",
+				{
+					{"pipe_path", clientPipePath.string()},
+					{"secret", clientSecret}
+				}
+			}
+		};
+		// clang-format on
+
+		NamedPipe::write(Bridge::s_pipePath, registration.dump());
+
+		nlohmann::json answer = nlohmann::json::parse(m_clientPipe.read_blocking(READ_TIMEOUT));
+		m_clientID            = answer["response"]["client_id"].get< int >();
+	}
+
+	void TearDown() override {
+		m_bridge.stop(true);
+		m_clientPipe.destroy();
+
+		API_Mock::calledFunctions.clear();
+	}
+
+	/**
+	 * Writes a message to the Bridge's pipe that consists of the given beginning, HOSTILE_MESSAGE_SIZE bytes of filler
+	 * and the given end. The message is written piece by piece, so that it never exists as a whole.
+	 */
+	void writeHostileMessage(const std::string &begin, const std::string &end) {
+		int handle = ::open(Bridge::s_pipePath.c_str(), O_WRONLY);
+		ASSERT_NE(handle, -1);
+
+		ASSERT_EQ(::write(handle, begin.data(), begin.size()), static_cast< ssize_t >(begin.size()));
+		for (std::size_t written = 0; written < HOSTILE_MESSAGE_SIZE; written += m_filler.size()) {
+			ASSERT_EQ(::write(handle, m_filler.data(), m_filler.size()), static_cast< ssize_t >(m_filler.size()));
+		}
+		ASSERT_EQ(::write(handle, end.data(), end.size()), static_cast< ssize_t >(end.size()));
+
+		::close(handle);
+	}
+
+	/**
+	 * @returns The beginning of an API call of the registered client that carries the given request ID
+	 */
+	std::string apiCallBeginning(int requestID) const {
+		return "{\"message_type\":\"api_call\",\"client_id\":" + std::to_string(m_clientID) + ",\"secret\":\""
+			   + clientSecret + "\",\"request_id\":" + std::to_string(requestID)
+			   + ",\"message\":{\"function\":\"getLocalUserID\",\"parameter\":{\"padding\":\"";
+	}
+
+	void expectOversizedError(int requestID) {
+		nlohmann::json answer = nlohmann::json::parse(m_clientPipe.read_blocking(READ_TIMEOUT));
+
+		ASSERT_EQ(answer["response_type"], "error");
+		ASSERT_EQ(answer["request_id"], requestID);
+		ASSERT_NE(answer["response"]["error_message"].get< std::string >().find("maximum size"), std::string::npos);
+	}
+};
+
+TEST_F(InboundLimitsTest, hostileMessagesDontGrowMemory) {
+	// Everything that is needed for sending has been allocated already
+	const std::string framedBeginning       = apiCallBeginning(1);
+	const std::string unterminatedBeginning = apiCallBeginning(2);
+
+	// clang-format off
+	nlohmann::json request = {
+		{"message_type", "api_call"},
+		{"client_id", m_clientID},
+		{"secret", clientSecret},
+		{"message",
+			{
+				{"function", "getLocalUserID"},
+				{"parameter",
+					{
+						{"connection", API_Mock::activeConnetion}
+					}
+				}
+			}
+		}
+	};
+	// clang-format on
+
+	std::int64_t baseline = s_allocatedBytes;
+	s_peakAllocatedBytes  = baseline;
+
+	// An oversized API call is reported to its sender once it has been received completely
+	writeHostileMessage(framedBeginning, "\"}}}\n");
+	expectOversizedError(1);
+
+	// Data that isn't even a JSON object can't be attributed to anybody
+	writeHostileMessage("[[[", "\n");
+
+	// An oversized message that never ends is reported once the Bridge gives up waiting for its end
+	writeHostileMessage(unterminatedBeginning, "");
+	expectOversizedError(2);
+
+	// The Bridge keeps on working normally
+	NamedPipe::write(Bridge::s_pipePath, request.dump(), 1000, Framing::NEWLINE);
+
+	nlohmann::json answer = nlohmann::json::parse(m_clientPipe.read_blocking(READ_TIMEOUT));
+	ASSERT_EQ(answer["response_type"], "api_call");
+
+	const InboundStatistics &statistics = m_bridge.getInboundStatistics();
+	ASSERT_EQ(statistics.oversizedMessages, 3);
+
+	// The Bridge has neither buffered any of the messages as a whole nor parsed them
+	std::int64_t peakGrowth = s_peakAllocatedBytes - baseline;
+	ASSERT_LT(peakGrowth, 1024 * 1024) << "Receiving " << 3 * HOSTILE_MESSAGE_SIZE
+									  << " bytes of hostile messages allocated " << peakGrowth << " bytes";
+}
+#endif
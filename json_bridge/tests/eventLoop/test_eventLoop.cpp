@@ -0,0 +1,247 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+#include "gtest/gtest.h"
+
+#include <mumble/json_bridge/EventLoop.h>
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/thread/thread.hpp>
+
+#ifdef PLATFORM_UNIX
+#	include <unistd.h>
+#endif
+
+using namespace Mumble::JsonBridge;
+
+class EventLoopTest : public ::testing::Test {
+protected:
+	EventLoop m_loop;
+	boost::thread m_loopThread;
+
+	void startLoop() {
+		m_loopThread = boost::thread([this]() { m_loop.run(); });
+	}
+
+	~EventLoopTest() {
+		m_loop.stop();
+
+		if (m_loopThread.joinable()) {
+			m_loopThread.join();
+		}
+	}
+};
+
+TEST_F(EventLoopTest, postedTasksRunInLoopThread) {
+	std::atomic< int > executedTasks(0);
+	std::atomic< bool > inLoopThread(true);
+
+	startLoop();
+
+	// Post from multiple threads at once
+	std::vector< boost::thread > posters;
+	for (int i = 0; i < 4; i++) {
+		posters.emplace_back([&]() {
+			for (int k = 0; k < 100; k++) {
+				m_loop.post([&]() {
+					if (!m_loop.isInLoopThread()) {
+						inLoopThread = false;
+					}
+
+					executedTasks++;
+				});
+			}
+		});
+	}
+
+	for (boost::thread &current : posters) {
+		current.join();
+	}
+
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+	while (executedTasks < 400 && std::chrono::steady_clock::now() < deadline) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	ASSERT_EQ(executedTasks, 400);
+	ASSERT_TRUE(inLoopThread);
+	ASSERT_FALSE(m_loop.isInLoopThread());
+}
+
+TEST_F(EventLoopTest, postedTasksKeepTheirOrder) {
+	std::vector< int > order;
+	std::atomic< bool > done(false);
+
+	for (int i = 0; i < 10; i++) {
+		m_loop.post([&order, i]() { order.push_back(i); });
+	}
+	m_loop.post([&]() { done = true; });
+
+	startLoop();
+
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+	while (!done && std::chrono::steady_clock::now() < deadline) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	ASSERT_TRUE(done);
+	ASSERT_EQ(order, std::vector< int >({ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 }));
+}
+
+TEST_F(EventLoopTest, throwingTasksDontStopTheLoop) {
+	std::vector< int > order;
+	std::atomic< bool > done(false);
+
+	m_loop.post([]() { throw std::runtime_error("Failing task"); });
+	m_loop.post([&order]() { order.push_back(1); });
+	m_loop.post([&]() {
+		m_loop.runAfter(std::chrono::milliseconds(1), []() { throw std::runtime_error("Failing timer"); });
+		m_loop.runAfter(std::chrono::milliseconds(1), [&order]() { order.push_back(2); });
+		m_loop.runAfter(std::chrono::milliseconds(20), [&]() {
+			// The loop is still running
+			m_loop.post([&]() { done = true; });
+		});
+	});
+
+	startLoop();
+
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+	while (!done && std::chrono::steady_clock::now() < deadline) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	ASSERT_TRUE(done);
+	ASSERT_EQ(order, std::vector< int >({ 1, 2 }));
+}
+
+TEST_F(EventLoopTest, stopWakesIdleLoop) {
+	startLoop();
+
+	// Give the loop the chance to go to sleep
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+	auto start = std::chrono::steady_clock::now();
+
+	m_loop.stop();
+	m_loopThread.join();
+
+	auto elapsed = std::chrono::steady_clock::now() - start;
+
+	// An idle loop has no timeout to wait for, so only an explicit wakeup can have made it return this quickly
+	ASSERT_LT(elapsed, std::chrono::milliseconds(100));
+}
+
+TEST_F(EventLoopTest, stopBeforeRun) {
+	m_loop.stop();
+
+	// The pending stop request makes run() return right away
+	m_loop.run();
+
+	// Once processed, the request is gone
+	m_loop.post([this]() { m_loop.stop(); });
+	m_loop.run();
+
+	// reset() discards a request that has not been processed yet
+	std::atomic< bool > executed(false);
+	m_loop.stop();
+	m_loop.reset();
+	m_loop.post([&]() {
+		executed = true;
+		m_loop.stop();
+	});
+	m_loop.run();
+
+	ASSERT_TRUE(executed);
+}
+
+TEST_F(EventLoopTest, timers) {
+	std::vector< int > order;
+	std::atomic< bool > done(false);
+	EventLoop::clock::time_point firedAt;
+
+	auto start = EventLoop::clock::now();
+
+	m_loop.post([&]() {
+		// Deliberately created in reverse order
+		m_loop.runAfter(std::chrono::milliseconds(60), [&]() {
+			order.push_back(3);
+			firedAt = EventLoop::clock::now();
+			done    = true;
+		});
+		EventLoop::timer_id_t cancelled =
+			m_loop.runAfter(std::chrono::milliseconds(40), [&]() { order.push_back(-1); });
+		m_loop.runAfter(std::chrono::milliseconds(20), [&]() { order.push_back(2); });
+		m_loop.runAt(start, [&]() { order.push_back(1); });
+
+		m_loop.cancelTimer(cancelled);
+		// Cancelling an unknown timer is a no-op
+		m_loop.cancelTimer(cancelled + 100);
+	});
+
+	startLoop();
+
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+	while (!done && std::chrono::steady_clock::now() < deadline) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	ASSERT_TRUE(done);
+	ASSERT_EQ(order, std::vector< int >({ 1, 2, 3 }));
+	ASSERT_GE(firedAt - start, std::chrono::milliseconds(60));
+}
+
+#ifdef PLATFORM_UNIX
+TEST_F(EventLoopTest, watchDescriptor) {
+	int fds[2];
+	ASSERT_EQ(::pipe(fds), 0);
+
+	std::string received;
+	std::atomic< bool > done(false);
+
+	m_loop.post([&]() {
+		m_loop.watch(fds[0], EventLoop::READABLE, [&](std::uint32_t events) {
+			ASSERT_TRUE(events & EventLoop::READABLE);
+
+			char buffer[16];
+			ssize_t readBytes = ::read(fds[0], buffer, sizeof(buffer));
+			ASSERT_GT(readBytes, 0);
+
+			received.append(buffer, readBytes);
+
+			if (received == "Hello") {
+				// Unwatching from within the callback is allowed
+				m_loop.unwatch(fds[0]);
+				done = true;
+			}
+		});
+	});
+
+	startLoop();
+
+	ASSERT_EQ(::write(fds[1], "Hel", 3), 3);
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	ASSERT_EQ(::write(fds[1], "lo", 2), 2);
+
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+	while (!done && std::chrono::steady_clock::now() < deadline) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	m_loop.stop();
+	m_loopThread.join();
+
+	::close(fds[0]);
+	::close(fds[1]);
+
+	ASSERT_TRUE(done);
+	ASSERT_EQ(received, "Hello");
+}
+#endif
@@ -0,0 +1,98 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+#include "gtest/gtest.h"
+
+#include <mumble/json_bridge/NameIndex.h>
+
+#include <cstdint>
+#include <vector>
+
+using namespace Mumble::JsonBridge;
+
+using IDs = std::vector< std::uint32_t >;
+
+TEST(NameIndex, exactLookup) {
+	NameIndex< std::uint32_t > index;
+	index.add("Alice", 3);
+	index.add("Bob", 1);
+
+	ASSERT_NE(index.find("Alice"), nullptr);
+	ASSERT_EQ(*index.find("Alice"), 3);
+	ASSERT_EQ(*index.find("Bob"), 1);
+	ASSERT_EQ(index.find("alice"), nullptr);
+	ASSERT_EQ(index.find("Ali"), nullptr);
+
+	ASSERT_EQ(index.find("Alice", true, false), IDs{ 3 });
+	ASSERT_EQ(index.find("alice", true, false), IDs{});
+}
+
+TEST(NameIndex, sharedNames) {
+	NameIndex< std::uint32_t > index;
+	index.add("Lobby", 9);
+	index.add("Lobby", 4);
+	index.add("Lobby", 6);
+
+	// Single lookups yield the lowest ID
+	ASSERT_EQ(*index.find("Lobby"), 4);
+	ASSERT_EQ(index.find("Lobby", true, false), (IDs{ 4, 6, 9 }));
+
+	index.remove("Lobby", 4);
+
+	ASSERT_EQ(*index.find("Lobby"), 6);
+	ASSERT_EQ(index.find("lobby", false, false), (IDs{ 6, 9 }));
+}
+
+TEST(NameIndex, caseInsensitiveAndPrefixLookup) {
+	NameIndex< std::uint32_t > index;
+	index.add("Alice", 1);
+	index.add("alex", 2);
+	index.add("ALBERT", 3);
+	index.add("Bob", 4);
+	index.add("Al", 5);
+
+	ASSERT_EQ(index.find("ALICE", false, false), IDs{ 1 });
+	ASSERT_EQ(index.find("al", false, true), (IDs{ 1, 2, 3, 5 }));
+	ASSERT_EQ(index.find("Al", true, true), (IDs{ 1, 5 }));
+	ASSERT_EQ(index.find("ali", true, true), IDs{});
+	ASSERT_EQ(index.find("", false, true), (IDs{ 1, 2, 3, 4, 5 }));
+	ASSERT_EQ(index.find("Alicia", false, true), IDs{});
+}
+
+TEST(NameIndex, renameAndRemove) {
+	NameIndex< std::uint32_t > index;
+	index.add("Alice", 1);
+
+	index.remove("Alice", 1);
+	index.add("Alicia", 1);
+
+	ASSERT_EQ(index.find("Alice"), nullptr);
+	ASSERT_EQ(*index.find("Alicia"), 1);
+	ASSERT_EQ(index.find("alice", false, false), IDs{});
+	ASSERT_EQ(index.find("ALI", false, true), IDs{ 1 });
+
+	// Removing what isn't there is fine
+	index.remove("Alice", 1);
+	index.remove("Alicia", 2);
+
+	ASSERT_EQ(*index.find("Alicia"), 1);
+
+	index.clear();
+
+	ASSERT_EQ(index.find("Alicia"), nullptr);
+	ASSERT_EQ(index.find("", false, true), IDs{});
+}
+
+TEST(NameIndex, nameMatches) {
+	ASSERT_TRUE(nameMatches("Alice", "Alice", true, false));
+	ASSERT_FALSE(nameMatches("Alice", "alice", true, false));
+	ASSERT_TRUE(nameMatches("Alice", "aLiCe", false, false));
+	ASSERT_TRUE(nameMatches("Alice", "ALI", false, true));
+	ASSERT_FALSE(nameMatches("Alice", "ALI", true, true));
+	ASSERT_FALSE(nameMatches("Al", "Alice", false, true));
+
+	// Only ASCII letters are folded
+	ASSERT_EQ(foldCase("ÄBC-xyz"), "Äbc-xyz");
+}
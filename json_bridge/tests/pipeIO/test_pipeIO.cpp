@@ -5,17 +5,28 @@
 
 #include "gtest/gtest.h"
 
+#include <mumble/json_bridge/BufferPool.h>
 #include <mumble/json_bridge/NamedPipe.h>
+#include <mumble/json_bridge/OutboundQueue.h>
+#include <mumble/json_bridge/SeqPacketSocket.h>
+#include <mumble/json_bridge/SharedMemoryChannel.h>
 
 #include <atomic>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <string>
+#include <vector>
 
 #include <boost/chrono.hpp>
 #include <boost/thread/thread.hpp>
 
+#ifdef PLATFORM_UNIX
+#	include <fcntl.h>
+#	include <poll.h>
+#	include <unistd.h>
+#endif
+
 #define PIPENAME "testPipe"
 
 #ifdef PLATFORM_UNIX
@@ -182,3 +193,447 @@ TEST(PipeIOTest4, create_destroy_check_existence) {
 
 	ASSERT_FALSE(NamedPipe::exists(pipePath));
 }
+
+TEST(PipeIOTest4, persistentReader) {
+	NamedPipe pipe = NamedPipe::create(std::filesystem::path(PIPEDIR) / "persistentPipe");
+
+	pipe.openPersistentReader();
+
+	// Since the reader is kept open, writing must not time out even though nobody is currently reading from the pipe
+	for (int i = 0; i < 3; i++) {
+		pipe.write(TEST_STRING, 100);
+
+		ASSERT_EQ(pipe.read_blocking(READ_TIMOUT), TEST_STRING);
+	}
+
+	// There is nothing left to read
+	std::string content;
+	ASSERT_THROW(content = pipe.read_blocking(100), TimeoutException);
+}
+
+TEST(PipeIOTest4, framing_multipleMessagesInOneRead) {
+	NamedPipe pipe = NamedPipe::create(std::filesystem::path(PIPEDIR) / "framedPipe");
+	pipe.openPersistentReader();
+
+	pipe.write("{\"id\":1}", 100, Framing::NEWLINE);
+	pipe.write("{\"id\":2}", 100, Framing::NEWLINE);
+	pipe.write("{\"id\":3}", 100, Framing::NEWLINE);
+
+	std::vector< std::string > frames = pipe.read_frames(READ_TIMOUT);
+
+	ASSERT_EQ(frames.size(), 3);
+	ASSERT_EQ(frames[0], "{\"id\":1}");
+	ASSERT_EQ(frames[1], "{\"id\":2}");
+	ASSERT_EQ(frames[2], "{\"id\":3}");
+}
+
+TEST(PipeIOTest4, framing_splitMessage) {
+	NamedPipe pipe = NamedPipe::create(std::filesystem::path(PIPEDIR) / "framedPipe");
+	pipe.openPersistentReader();
+
+	// Simulate a slow writer that writes its message in two parts
+	boost::thread writer([&pipe]() {
+		pipe.write("{\"first\":", 100);
+		boost::this_thread::sleep_for(boost::chrono::milliseconds(100));
+		pipe.write("\"part\"}", 100, Framing::NEWLINE);
+	});
+
+	std::vector< std::string > frames = pipe.read_frames(READ_TIMOUT);
+
+	writer.join();
+
+	ASSERT_EQ(frames.size(), 1);
+	ASSERT_EQ(frames[0], "{\"first\":\"part\"}");
+}
+
+TEST(PipeIOTest4, framing_unframedMessage) {
+	NamedPipe pipe = NamedPipe::create(std::filesystem::path(PIPEDIR) / "framedPipe");
+	pipe.openPersistentReader();
+
+	// Legacy writers don't use any framing at all
+	pipe.write("{\"legacy\":true}", 100);
+
+	std::vector< std::string > frames = pipe.read_frames(READ_TIMOUT);
+
+	ASSERT_EQ(frames.size(), 1);
+	ASSERT_EQ(frames[0], "{\"legacy\":true}");
+}
+
+TEST(PipeIOTest4, framing_prettyPrintedMessage) {
+	NamedPipe pipe = NamedPipe::create(std::filesystem::path(PIPEDIR) / "framedPipe");
+	pipe.openPersistentReader();
+
+	const std::string prettyMessage = "{\n    \"legacy\": true,\n    \"nested\": [\n        {\n            \"id\": 1\n"
+									  "        }\n    ]\n}";
+	// As written by e.g. json.dump(0) or Python's json.dumps(indent=0), which don't indent nested values
+	const std::string unindentedBatch = "{\n\"message_type\": \"batch\",\n\"message\": {\n\"calls\": [\n{\n"
+										"\"function\": \"getLocalUserID\"\n},\n{\n"
+										"\"function\": \"getActiveServerConnection\"\n}\n]\n}\n}";
+
+	// Newlines within a message don't end it, regardless of whether the message is framed
+	pipe.write(prettyMessage, 100, Framing::NEWLINE);
+	pipe.write(unindentedBatch, 100, Framing::NEWLINE);
+	pipe.write("{\"id\":2}", 100, Framing::NEWLINE);
+	pipe.write(prettyMessage, 100);
+
+	std::vector< std::string > frames;
+	while (frames.size() < 4) {
+		std::vector< std::string > received = pipe.read_frames(READ_TIMOUT);
+		frames.insert(frames.end(), received.begin(), received.end());
+	}
+
+	ASSERT_EQ(frames, std::vector< std::string >({ prettyMessage, unindentedBatch, "{\"id\":2}", prettyMessage }));
+}
+
+TEST(PipeIOTest4, framing_truncatedMessage) {
+	NamedPipe pipe = NamedPipe::create(std::filesystem::path(PIPEDIR) / "framedPipe");
+	pipe.openPersistentReader();
+	pipe.setMaxFrameSize(64);
+
+	const std::string truncatedMessage = "{\"truncated\":";
+
+	std::vector< std::string > messages;
+	for (int i = 1; i <= 8; i++) {
+		messages.push_back("{\"id\":" + std::to_string(i) + "}");
+	}
+
+	// A message that has been cut short swallows the following ones until it exceeds the maximum frame size. Only
+	// then it is discarded, up to the line where the next message begins.
+	pipe.write(truncatedMessage, 100, Framing::NEWLINE);
+	for (const std::string &message : messages) {
+		pipe.write(message, 100, Framing::NEWLINE);
+	}
+
+	std::vector< std::string > frames;
+	while (frames.size() < messages.size()) {
+		std::vector< std::string > received = pipe.read_frames(READ_TIMOUT);
+		frames.insert(frames.end(), received.begin(), received.end());
+	}
+
+	ASSERT_EQ(frames, messages);
+
+	std::vector< DiscardedFrame > discarded = pipe.takeDiscardedFrames();
+	ASSERT_EQ(discarded.size(), 1);
+	ASSERT_EQ(discarded[0].size, truncatedMessage.size());
+}
+
+TEST(PipeIOTest4, receiveBuffer_growsUpToCap) {
+	ReceiveBuffer buffer(10 * 1024);
+
+	ASSERT_EQ(buffer.capacity(), 0);
+
+	const std::string chunk(3000, 'x');
+	ASSERT_EQ(buffer.append(chunk), chunk.size());
+	ASSERT_EQ(buffer.capacity(), ReceiveBuffer::INITIAL_CAPACITY);
+
+	ASSERT_EQ(buffer.append(chunk), chunk.size());
+	ASSERT_EQ(buffer.append(chunk), chunk.size());
+	ASSERT_EQ(buffer.size(), 3 * chunk.size());
+
+	// Data exceeding the cap is not accepted
+	ASSERT_EQ(buffer.append(chunk), 10 * 1024 - 3 * chunk.size());
+	ASSERT_EQ(buffer.size(), 10 * 1024);
+	ASSERT_EQ(buffer.freeCapacity(), 0);
+	ASSERT_LE(buffer.capacity(), 10 * 1024);
+
+	// Consumed space is reused instead of growing the buffer any further
+	std::size_t capacity = buffer.capacity();
+	buffer.consume(5000);
+	ASSERT_EQ(buffer.append(chunk), chunk.size());
+	ASSERT_EQ(buffer.capacity(), capacity);
+	ASSERT_EQ(buffer.view(), std::string(10 * 1024 - 5000 + chunk.size(), 'x'));
+}
+
+#ifdef PLATFORM_UNIX
+TEST(PipeIOTest4, receiveBuffer_largeMessage) {
+	NamedPipe pipe = NamedPipe::create(std::filesystem::path(PIPEDIR) / "framedPipe");
+	pipe.openPersistentReader();
+
+	// Exceeds the pipe's capacity, so the writer has to wait for the reader to make room
+	const std::string message = "\"" + std::string(256 * 1024, 'x') + "\"";
+
+	boost::thread writer([&message]() {
+		std::filesystem::path path = std::filesystem::path(PIPEDIR) / "framedPipe";
+		int handle                 = ::open(path.c_str(), O_WRONLY);
+		std::string framed         = message + FRAME_DELIMITER;
+
+		std::size_t written = 0;
+		while (written < framed.size()) {
+			ssize_t result = ::write(handle, framed.data() + written, framed.size() - written);
+			if (result < 0) {
+				break;
+			}
+			written += result;
+		}
+
+		::close(handle);
+	});
+
+	std::vector< std::string > frames = pipe.read_frames(READ_TIMOUT);
+
+	writer.join();
+
+	ASSERT_EQ(frames.size(), 1);
+	ASSERT_EQ(frames[0], message);
+
+	// Scatter reads receive large chunks at once rather than a few bytes per system call
+	const ReceiveBuffer::Statistics &statistics = pipe.getReceiveStatistics();
+	ASSERT_EQ(statistics.readBytes, message.size() + 1);
+	ASSERT_LT(statistics.readCalls, 64);
+}
+#endif
+
+TEST(PipeIOTest4, receiveBuffer_oversizedMessage) {
+	NamedPipe pipe = NamedPipe::create(std::filesystem::path(PIPEDIR) / "framedPipe");
+	pipe.openPersistentReader();
+	pipe.setMaxFrameSize(16);
+
+	const std::string message = "{\"client_id\":3,\"key\":\"This message exceeds the buffer\",\"request_id\":[1]}";
+	pipe.write(message, 100, Framing::NEWLINE);
+	pipe.write("{}", 100, Framing::NEWLINE);
+
+	// The oversized message is dropped instead of stalling the pipe forever
+	std::vector< std::string > frames = pipe.read_frames(READ_TIMOUT);
+
+	ASSERT_EQ(frames, std::vector< std::string >({ "{}" }));
+
+	// Only its scalar envelope fields are kept
+	std::vector< DiscardedFrame > discarded = pipe.takeDiscardedFrames();
+	ASSERT_EQ(discarded.size(), 1);
+	ASSERT_EQ(discarded[0].size, message.size());
+	ASSERT_EQ(discarded[0].envelope, "{\"client_id\":3}");
+
+	ASSERT_TRUE(pipe.takeDiscardedFrames().empty());
+}
+
+TEST(PipeIOTest4, envelopeCapture) {
+	const std::string message = R"({ "secret" : "a\"b" , "message":{"secret":"nested"},"client_id":12 , "secret":"c",)"
+								R"("request_id":")"
+								+ std::string(EnvelopeCapture::MAX_VALUE_SIZE, 'x') + R"(","message_type":"api_call"})";
+
+	// The capture has to work no matter how the message is split up
+	for (std::size_t pieceSize : { std::size_t(1), std::size_t(7), message.size() }) {
+		EnvelopeCapture capture;
+
+		std::size_t consumed = 0;
+		for (std::size_t i = 0; i < message.size(); i += pieceSize) {
+			consumed += capture.feed(std::string_view(message).substr(i, pieceSize));
+		}
+
+		ASSERT_TRUE(capture.isComplete());
+		ASSERT_EQ(consumed, message.size());
+		ASSERT_EQ(capture.getEnvelope(), R"({"secret":"a\"b","client_id":12,"message_type":"api_call"})");
+	}
+
+	// The end of an unframed message is recognized
+	EnvelopeCapture capture;
+	ASSERT_EQ(capture.feed("{\"client_id\":1}{\"client_id\":2}"), 15);
+	ASSERT_EQ(capture.getEnvelope(), "{\"client_id\":1}");
+}
+
+#ifdef PLATFORM_UNIX
+TEST(PipeIOTest4, pipeWriter_reconnects) {
+	NamedPipe pipe = NamedPipe::create(std::filesystem::path(PIPEDIR) / "writerPipe");
+	PipeWriter writer(pipe.getPath());
+
+	// There is no reader yet
+	ASSERT_FALSE(writer.open());
+
+	int reader = ::open(pipe.getPath().c_str(), O_RDONLY | O_NONBLOCK);
+	ASSERT_NE(reader, -1);
+
+	ASSERT_TRUE(writer.open());
+	writer.write("first", 100);
+	ASSERT_TRUE(writer.isOpen());
+
+	char buffer[16];
+	ASSERT_EQ(::read(reader, buffer, sizeof(buffer)), 5);
+
+	// Once the reader is gone, writing must neither succeed nor raise SIGPIPE
+	::close(reader);
+	ASSERT_THROW(writer.write("lost", 100), TimeoutException);
+
+	// A new reader is picked up automatically
+	reader = ::open(pipe.getPath().c_str(), O_RDONLY | O_NONBLOCK);
+	ASSERT_NE(reader, -1);
+
+	writer.write("second", 100);
+	ASSERT_EQ(::read(reader, buffer, sizeof(buffer)), 6);
+	ASSERT_EQ(std::string(buffer, 6), "second");
+
+	writer.close();
+	ASSERT_FALSE(writer.isOpen());
+	::close(reader);
+}
+#endif
+
+TEST(PipeIOTest4, outboundQueue_boundedWithPartialWrites) {
+	OutboundStatistics statistics;
+	OutboundQueue queue(10, &statistics);
+
+	// A message exceeding the limit is still admitted into an empty queue
+	ASSERT_TRUE(queue.push("0123456789ab"));
+	ASSERT_FALSE(queue.push("x"));
+	ASSERT_EQ(queue.getQueuedBytes(), 12);
+	ASSERT_EQ(queue.getDroppedMessages(), 1);
+
+	// Partial writes only remove the message once it has been written completely
+	queue.consume(4);
+	ASSERT_TRUE(queue.isFrontPartiallyWritten());
+	ASSERT_EQ(queue.front(), "456789ab");
+	ASSERT_EQ(statistics.queuedBytes, 8);
+
+	queue.consume(8);
+	ASSERT_TRUE(queue.empty());
+	ASSERT_EQ(statistics.queuedBytes, 0);
+
+	ASSERT_TRUE(queue.push("abc"));
+	ASSERT_TRUE(queue.push("defg"));
+	queue.forcePush("overflow");
+	ASSERT_EQ(queue.size(), 3);
+
+	queue.dropAll();
+	ASSERT_TRUE(queue.empty());
+	ASSERT_EQ(statistics.queuedBytes, 0);
+	ASSERT_EQ(statistics.droppedMessages, 4);
+}
+
+TEST(PipeIOTest4, outboundQueue_recyclesBuffers) {
+	BufferPool &pool = BufferPool::shared();
+	while (pool.size() > 0) {
+		(void) pool.take();
+	}
+
+	// Messages too short to have memory of their own aren't worth recycling
+	const std::string longMessage(100, 'x');
+
+	OutboundQueue queue;
+	queue.forcePush(longMessage + "1");
+	queue.forcePush(longMessage + "2");
+	queue.forcePush("short");
+	queue.forcePush(longMessage + "3");
+
+	// Written messages are erased in bulk, which must not mix up the order of the remaining ones
+	queue.consume(queue.front().size());
+	ASSERT_EQ(queue.front(), longMessage + "2");
+	queue.consume(queue.front().size());
+	ASSERT_EQ(queue.front(), "short");
+	queue.consume(queue.front().size());
+	ASSERT_EQ(queue.front(), longMessage + "3");
+	ASSERT_EQ(queue.size(), 1);
+
+	queue.forcePush(longMessage + "4");
+	queue.consume(queue.front().size());
+	ASSERT_EQ(queue.front(), longMessage + "4");
+	queue.dropFront();
+	ASSERT_TRUE(queue.empty());
+
+	ASSERT_EQ(pool.size(), 4);
+
+	std::string buffer = pool.take();
+	ASSERT_TRUE(buffer.empty());
+	ASSERT_GE(buffer.capacity(), longMessage.size());
+	ASSERT_EQ(pool.size(), 3);
+
+	// Buffers exceeding the pool's limit are freed instead
+	pool.giveBack(std::string(BufferPool::DEFAULT_MAX_BUFFER_SIZE + 1, 'x'));
+	ASSERT_EQ(pool.size(), 3);
+}
+
+#ifdef PLATFORM_UNIX
+TEST(PipeIOTest4, seqPacketSocket_preservesMessageBoundaries) {
+	const std::string address = (std::filesystem::path(PIPEDIR) / "testSocket").string();
+
+	SeqPacketListener listener = SeqPacketListener::listen(address);
+	ASSERT_TRUE(std::filesystem::exists(address));
+
+	SeqPacketSocket client = SeqPacketSocket::connect(address, 100);
+	SeqPacketSocket server = listener.accept();
+	ASSERT_TRUE(server.isOpen());
+	ASSERT_TRUE(server.peerIsSameUser());
+
+	client.send("first");
+	client.send("second");
+
+	std::vector< char > buffer;
+	std::string_view message;
+	ASSERT_TRUE(server.tryReceive(buffer, message));
+	ASSERT_EQ(message, "first");
+	ASSERT_TRUE(server.tryReceive(buffer, message));
+	ASSERT_EQ(message, "second");
+	ASSERT_FALSE(server.tryReceive(buffer, message));
+	ASSERT_TRUE(server.isConnected());
+
+	ASSERT_TRUE(server.trySend("reply"));
+	ASSERT_EQ(client.receive(READ_TIMOUT), "reply");
+
+	// Once the peer has gone away, the connection is reported as closed
+	client.close();
+	ASSERT_FALSE(server.tryReceive(buffer, message));
+	ASSERT_FALSE(server.isConnected());
+
+	listener.close();
+	ASSERT_FALSE(std::filesystem::exists(address));
+}
+
+bool doorbellRung(int handle) {
+	pollfd descriptor = { handle, POLLIN, 0 };
+
+	return ::poll(&descriptor, 1, 0) == 1;
+}
+
+TEST(PipeIOTest4, sharedMemoryChannel_roundTrip) {
+	SharedMemoryChannel bridge = SharedMemoryChannel::create(4096);
+
+	// The client gets its own copies of the handles (as it would when they are passed via a socket)
+	std::vector< int > handles;
+	for (int handle : bridge.getHandles()) {
+		handles.push_back(::dup(handle));
+	}
+
+	SharedMemoryChannel client = SharedMemoryChannel::attach(handles);
+	ASSERT_TRUE(client);
+	ASSERT_EQ(client.getRingSize(), bridge.getRingSize());
+
+	// Only the transition from an empty ring rings the doorbell
+	ASSERT_FALSE(doorbellRung(bridge.getDoorbellHandle()));
+	client.send("first");
+	client.send("second");
+	ASSERT_TRUE(doorbellRung(bridge.getDoorbellHandle()));
+	bridge.resetDoorbell();
+
+	std::string_view message;
+	ASSERT_TRUE(bridge.peek(message));
+	ASSERT_EQ(message, "first");
+	bridge.pop();
+	ASSERT_TRUE(bridge.peek(message));
+	ASSERT_EQ(message, "second");
+	bridge.pop();
+	ASSERT_FALSE(bridge.peek(message));
+	ASSERT_FALSE(doorbellRung(bridge.getDoorbellHandle()));
+
+	// Fill the ring a couple of times with messages of varying size, so that they wrap around its end
+	for (std::size_t size : { 100, 333, 1000, 7 }) {
+		const std::string payload(size, 'x');
+
+		std::size_t sent = 0;
+		while (bridge.trySend(payload)) {
+			sent++;
+		}
+		ASSERT_GT(sent, 0u);
+
+		// As the ring was full, making room in it wakes up the Bridge again
+		ASSERT_EQ(client.receive(READ_TIMOUT), payload);
+		ASSERT_TRUE(doorbellRung(bridge.getDoorbellHandle()));
+		bridge.resetDoorbell();
+
+		for (std::size_t i = 1; i < sent; i++) {
+			ASSERT_EQ(client.receive(READ_TIMOUT), payload);
+		}
+		ASSERT_THROW(client.receive(10), TimeoutException);
+	}
+
+	// Messages that could never fit into the ring are rejected right away
+	ASSERT_THROW((void) bridge.trySend(std::string(bridge.getRingSize(), 'x')), PipeException< int >);
+}
+#endif
@@ -0,0 +1,80 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+#include "gtest/gtest.h"
+
+#include <mumble/json_bridge/ResponseWriter.h>
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+using namespace Mumble::JsonBridge;
+
+enum class TestEnum { FIRST, SECOND, THIRD };
+
+// The writer has to produce the exact same text as nlohmann::json::dump()
+template< typename T > void expectSameAsDump(const T &value) {
+	std::string buffer;
+	ResponseWriter writer(buffer);
+	writer.value(value);
+
+	EXPECT_EQ(buffer, nlohmann::json(value).dump());
+}
+
+TEST(ResponseWriter, strings) {
+	const std::vector< std::string > strings = { "",
+												 "Plain text",
+												 "\"Quoted\" and \\escaped\\",
+												 "Line\nbreaks\r\nand\ttabs",
+												 std::string("Control\x01\x1f characters and a ") + '\0' + " byte",
+												 "Ünïcödé ✓" };
+
+	for (const std::string &current : strings) {
+		std::string buffer;
+		ResponseWriter writer(buffer);
+		writer.string(current);
+
+		EXPECT_EQ(buffer, nlohmann::json(current).dump());
+	}
+}
+
+TEST(ResponseWriter, numbers) {
+	expectSameAsDump(true);
+	expectSameAsDump(false);
+	expectSameAsDump(0);
+	expectSameAsDump(-42);
+	expectSameAsDump(std::numeric_limits< std::int64_t >::min());
+	expectSameAsDump(std::numeric_limits< std::uint64_t >::max());
+	expectSameAsDump(std::uint8_t(255));
+	expectSameAsDump(0.5);
+	expectSameAsDump(TestEnum::THIRD);
+}
+
+TEST(ResponseWriter, arrays) {
+	expectSameAsDump(std::vector< std::uint32_t >());
+	expectSameAsDump(std::vector< std::uint32_t >({ 1, 2, 3 }));
+	expectSameAsDump(std::vector< std::int32_t >({ -1, 0, 1 }));
+	expectSameAsDump(std::vector< bool >({ true, false }));
+}
+
+TEST(ResponseWriter, composedResponse) {
+	std::string buffer;
+	ResponseWriter writer(buffer);
+
+	writer.raw(R"({"response_type":"api_call","response":{"return_value":)");
+	writer.value(std::vector< int >({ 1, 2 }));
+	writer.raw(R"(,"name":)");
+	writer.string("a\"b");
+	writer.raw("}}");
+
+	nlohmann::json expected = { { "response_type", "api_call" },
+								{ "response", { { "return_value", { 1, 2 } }, { "name", "a\"b" } } } };
+
+	EXPECT_EQ(nlohmann::json::parse(buffer), expected);
+}
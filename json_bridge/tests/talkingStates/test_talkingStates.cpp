@@ -0,0 +1,199 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+#include "gtest/gtest.h"
+
+#include <mumble/json_bridge/TalkingStateCoalescer.h>
+
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Mumble::JsonBridge;
+
+using Clock = TalkingStateCoalescer::clock;
+
+static TalkingStateChange makeChange(mumble_userid_t userID, mumble_talking_state_t state) {
+	TalkingStateChange change;
+	change.connection = 1;
+	change.userID     = userID;
+	change.state      = state;
+
+	return change;
+}
+
+static nlohmann::json writeFrame(TalkingStateCoalescer &coalescer, Clock::time_point now) {
+	std::string message = "{";
+	ResponseWriter writer(message);
+	coalescer.write(writer, now);
+	writer.raw("}");
+
+	return nlohmann::json::parse(message)["response"];
+}
+
+TEST(TalkingStateRecorder, keepsLatestStatePerUser) {
+	TalkingStateStatistics statistics;
+	TalkingStateRecorder recorder(64, &statistics);
+
+	ASSERT_TRUE(recorder.record(1, 7, MUMBLE_TS_TALKING));
+	ASSERT_TRUE(recorder.record(1, 5, MUMBLE_TS_WHISPERING));
+	ASSERT_TRUE(recorder.record(1, 7, MUMBLE_TS_PASSIVE));
+	ASSERT_TRUE(recorder.record(2, 7, MUMBLE_TS_INVALID));
+
+	std::vector< TalkingStateChange > changes;
+	ASSERT_EQ(recorder.drain(changes), 0u);
+
+	// The changes are ordered by the time of their latest change
+	ASSERT_EQ(changes.size(), 3u);
+	EXPECT_EQ(changes[0].userID, 5u);
+	EXPECT_EQ(changes[0].state, MUMBLE_TS_WHISPERING);
+	EXPECT_EQ(changes[1].userID, 7u);
+	EXPECT_EQ(changes[1].connection, 1);
+	EXPECT_EQ(changes[1].state, MUMBLE_TS_PASSIVE);
+	EXPECT_EQ(changes[1].merged, 1u);
+	EXPECT_EQ(changes[2].connection, 2);
+	EXPECT_EQ(changes[2].state, MUMBLE_TS_INVALID);
+
+	EXPECT_EQ(statistics.recordedChanges, 4u);
+	EXPECT_EQ(statistics.mergedChanges, 1u);
+
+	// Nothing is drained twice
+	changes.clear();
+	recorder.drain(changes);
+	EXPECT_TRUE(changes.empty());
+}
+
+TEST(TalkingStateRecorder, dropsChangesOnceFull) {
+	TalkingStateStatistics statistics;
+	TalkingStateRecorder recorder(16, &statistics);
+
+	std::size_t recorded = 0;
+	for (mumble_userid_t user = 0; user < 64; user++) {
+		if (recorder.record(1, user, MUMBLE_TS_TALKING)) {
+			recorded++;
+		}
+	}
+
+	ASSERT_EQ(recorded, 16u);
+	ASSERT_EQ(statistics.droppedChanges, 48u);
+
+	std::vector< TalkingStateChange > changes;
+	ASSERT_EQ(recorder.drain(changes), 48u);
+	ASSERT_EQ(changes.size(), 16u);
+}
+
+TEST(TalkingStateRecorder, reclaimsIdleSlots) {
+	TalkingStateRecorder recorder(16);
+
+	std::vector< TalkingStateChange > changes;
+	for (mumble_userid_t user = 0; user < 16; user++) {
+		ASSERT_TRUE(recorder.record(1, user, MUMBLE_TS_TALKING));
+	}
+
+	// Once the users have been quiet for long enough, their slots can be used by others
+	for (int i = 0; i < 100; i++) {
+		recorder.drain(changes);
+	}
+
+	for (mumble_userid_t user = 16; user < 32; user++) {
+		ASSERT_TRUE(recorder.record(1, user, MUMBLE_TS_TALKING));
+	}
+
+	changes.clear();
+	recorder.drain(changes);
+	ASSERT_EQ(changes.size(), 16u);
+}
+
+TEST(TalkingStateRecorder, concurrentRecordingKeepsLatestState) {
+	constexpr int threads        = 4;
+	constexpr int changesPerUser = 10000;
+	constexpr int usersPerThread = 8;
+
+	TalkingStateRecorder recorder(256);
+	std::vector< TalkingStateChange > changes;
+
+	std::vector< std::thread > producers;
+	for (int t = 0; t < threads; t++) {
+		producers.emplace_back([&recorder, t]() {
+			for (int i = 0; i < changesPerUser; i++) {
+				for (int u = 0; u < usersPerThread; u++) {
+					mumble_talking_state_t state = i % 2 == 0 ? MUMBLE_TS_TALKING : MUMBLE_TS_PASSIVE;
+
+					recorder.record(1, static_cast< mumble_userid_t >(t * usersPerThread + u), state);
+				}
+			}
+		});
+	}
+
+	// Drain while the changes are being recorded
+	for (int i = 0; i < 1000; i++) {
+		recorder.drain(changes);
+	}
+
+	for (std::thread &producer : producers) {
+		producer.join();
+	}
+
+	recorder.drain(changes);
+
+	// The last change of every user is the last one that has been drained for that user
+	std::vector< mumble_talking_state_t > latest(threads * usersPerThread, MUMBLE_TS_INVALID);
+	for (const TalkingStateChange &change : changes) {
+		latest[change.userID] = change.state;
+	}
+
+	for (mumble_talking_state_t state : latest) {
+		EXPECT_EQ(state, MUMBLE_TS_PASSIVE);
+	}
+}
+
+TEST(TalkingStateCoalescer, mergesChangesWithinWindow) {
+	TalkingStateStatistics statistics;
+	TalkingStateCoalescer coalescer(std::chrono::milliseconds(100), 0, 2, &statistics);
+
+	Clock::time_point start = Clock::now();
+
+	coalescer.add(makeChange(7, MUMBLE_TS_TALKING), start);
+	coalescer.add(makeChange(5, MUMBLE_TS_TALKING), start);
+	coalescer.add(makeChange(7, MUMBLE_TS_PASSIVE), start + std::chrono::milliseconds(10));
+	// There is only room for two users
+	coalescer.add(makeChange(9, MUMBLE_TS_TALKING), start + std::chrono::milliseconds(20));
+
+	ASSERT_FALSE(coalescer.isDue(start + std::chrono::milliseconds(99)));
+	ASSERT_TRUE(coalescer.isDue(start + std::chrono::milliseconds(100)));
+
+	nlohmann::json frame = writeFrame(coalescer, start + std::chrono::milliseconds(100));
+
+	ASSERT_EQ(frame["topic"], "talking_state");
+	ASSERT_EQ(frame["changes"], nlohmann::json::parse(R"([[1,7,"passive"],[1,5,"talking"]])"));
+	ASSERT_EQ(frame["merged"], 1);
+	ASSERT_EQ(frame["dropped"], 1);
+
+	EXPECT_EQ(statistics.mergedChanges, 1u);
+	EXPECT_EQ(statistics.droppedChanges, 1u);
+	EXPECT_EQ(statistics.sentFrames, 1u);
+
+	// The counters are reported per frame
+	ASSERT_EQ(coalescer.pendingChanges(), 0u);
+	ASSERT_FALSE(coalescer.isDue(start + std::chrono::seconds(10)));
+}
+
+TEST(TalkingStateCoalescer, respectsMaxRate) {
+	TalkingStateCoalescer coalescer(std::chrono::milliseconds(0), 10);
+
+	Clock::time_point start = Clock::now();
+
+	coalescer.add(makeChange(7, MUMBLE_TS_TALKING), start);
+	ASSERT_TRUE(coalescer.isDue(start));
+	writeFrame(coalescer, start);
+
+	// At most ten frames per second
+	coalescer.add(makeChange(7, MUMBLE_TS_PASSIVE), start + std::chrono::milliseconds(1));
+	ASSERT_FALSE(coalescer.isDue(start + std::chrono::milliseconds(99)));
+	ASSERT_TRUE(coalescer.isDue(start + std::chrono::milliseconds(100)));
+}
@@ -0,0 +1,411 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+// Sets up both ends of every transport the Bridge supports in the same way the Bridge and its clients use them, so
+// that the very same tests and benchmarks can be run against each of them.
+
+#ifndef MUMBLE_JSONBRIDGE_TESTS_TRANSPORTHARNESS_H_
+#define MUMBLE_JSONBRIDGE_TESTS_TRANSPORTHARNESS_H_
+
+#include <mumble/json_bridge/EventLoop.h>
+#include <mumble/json_bridge/Framing.h>
+#include <mumble/json_bridge/NamedPipe.h>
+#include <mumble/json_bridge/transports/NamedPipeTransport.h>
+#include <mumble/json_bridge/transports/SharedMemoryTransport.h>
+#include <mumble/json_bridge/transports/SocketTransport.h>
+#include <mumble/json_bridge/transports/Transport.h>
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+#ifdef PLATFORM_UNIX
+#	define PIPEDIR "."
+#else
+#	define PIPEDIR "\\\\.\\pipe\\"
+#endif
+
+namespace TransportHarness {
+
+using namespace Mumble::JsonBridge;
+
+constexpr unsigned int TRANSPORT_TIMEOUT = 5 * 1000;
+
+const std::filesystem::path bridgePipePath(std::filesystem::path(PIPEDIR) / ".transport-bridge-pipe");
+const std::filesystem::path clientPipePath(std::filesystem::path(PIPEDIR) / ".transport-client-pipe");
+
+const std::string socketAddress = "@mumble-json-bridge-transport-test";
+
+/**
+ * Knows how to set up both ends of one kind of transport
+ */
+class Backend {
+public:
+	virtual ~Backend() = default;
+
+	/**
+	 * @returns Whether the Bridge's end of the transport is handed out by the listener. If it isn't, the Bridge's end
+	 * is write-only and messages from the client arrive via the listener instead.
+	 */
+	[[nodiscard]] virtual bool isConnectionOriented() const = 0;
+	/**
+	 * @returns The framing the Bridge has to apply to the messages it sends
+	 */
+	[[nodiscard]] virtual Framing getFraming() const { return Framing::NONE; }
+
+	/**
+	 * @returns The Bridge's listener
+	 */
+	[[nodiscard]] virtual std::unique_ptr< Transports::Listener > createListener() = 0;
+	/**
+	 * Connects a client to the (started) listener. This is called from the client's thread.
+	 *
+	 * @returns The client's end of the connection
+	 */
+	[[nodiscard]] virtual std::unique_ptr< Transports::Connection > connect() = 0;
+	/**
+	 * Turns a connection handed out by the listener into the Bridge's end of the transport. This is called from
+	 * the loop's thread.
+	 */
+	[[nodiscard]] virtual std::unique_ptr< Transports::Connection >
+		accept(std::unique_ptr< Transports::Connection > connection) {
+		return connection;
+	}
+	/**
+	 * Opens the Bridge's end of the transport to the connected client, if the transport isn't connection-oriented.
+	 * This is called from the loop's thread.
+	 */
+	[[nodiscard]] virtual std::unique_ptr< Transports::Connection > open() { return nullptr; }
+};
+
+class NamedPipeBackend : public Backend {
+public:
+	bool isConnectionOriented() const override { return false; }
+
+	Framing getFraming() const override { return Framing::NEWLINE; }
+
+	std::unique_ptr< Transports::Listener > createListener() override {
+		return std::make_unique< Transports::NamedPipeListener >(bridgePipePath);
+	}
+
+	std::unique_ptr< Transports::Connection > connect() override {
+		return std::make_unique< Transports::NamedPipeConnection >(bridgePipePath, NamedPipe::create(clientPipePath),
+																   Framing::NEWLINE);
+	}
+
+	std::unique_ptr< Transports::Connection > open() override {
+		return std::make_unique< Transports::NamedPipeConnection >(clientPipePath, Framing::NEWLINE);
+	}
+};
+
+#ifdef PLATFORM_UNIX
+class SocketBackend : public Backend {
+public:
+	bool isConnectionOriented() const override { return true; }
+
+	std::unique_ptr< Transports::Listener > createListener() override {
+		return std::make_unique< Transports::SocketListener >(socketAddress);
+	}
+
+	std::unique_ptr< Transports::Connection > connect() override {
+		return std::make_unique< Transports::SocketConnection >(
+			SeqPacketSocket::connect(socketAddress, TRANSPORT_TIMEOUT));
+	}
+};
+
+class SharedMemoryBackend : public SocketBackend {
+public:
+	std::unique_ptr< Transports::Connection > connect() override {
+		auto socket = std::make_unique< Transports::SocketConnection >(
+			SeqPacketSocket::connect(socketAddress, TRANSPORT_TIMEOUT));
+
+		std::vector< int > handles;
+		std::string setupMessage = socket->receive(handles, TRANSPORT_TIMEOUT);
+
+		return std::make_unique< Transports::SharedMemoryConnection >(std::move(socket),
+																	  SharedMemoryChannel::attach(handles));
+	}
+
+	std::unique_ptr< Transports::Connection > accept(std::unique_ptr< Transports::Connection > connection) override {
+		SharedMemoryChannel channel = SharedMemoryChannel::create();
+
+		if (connection->trySendWithHandles("{}", channel.getHandles()) != Transports::Status::OK) {
+			throw std::runtime_error("Can't pass the shared memory to the client");
+		}
+
+		return std::make_unique< Transports::SharedMemoryConnection >(std::move(connection), std::move(channel));
+	}
+};
+#endif
+
+struct BackendInfo {
+	const char *name;
+	std::function< std::unique_ptr< Backend >() > create;
+};
+
+inline std::vector< BackendInfo > getBackends() {
+	return {
+		{ "NamedPipe", []() { return std::make_unique< NamedPipeBackend >(); } },
+#ifdef PLATFORM_UNIX
+		{ "Socket", []() { return std::make_unique< SocketBackend >(); } },
+		{ "SharedMemory", []() { return std::make_unique< SharedMemoryBackend >(); } },
+#endif
+	};
+}
+
+/**
+ * Runs the Bridge's end of a transport in an EventLoop of its own (just like the Bridge does) and holds the client's
+ * end, which is meant to be used from the thread owning the harness. The Bridge's end collects the messages it
+ * receives and sends queued messages the way the Bridge does: without ever blocking the loop.
+ */
+class Harness {
+private:
+	std::unique_ptr< Backend > m_backend;
+	EventLoop m_loop;
+	boost::thread m_loopThread;
+	std::unique_ptr< Transports::Listener > m_listener;
+	std::unique_ptr< Transports::Connection > m_bridgeEnd;
+	std::unique_ptr< Transports::Connection > m_client;
+
+	mutable boost::mutex m_mutex;
+	boost::condition_variable m_condition;
+	std::vector< std::string > m_received;
+	std::size_t m_receivedCount = 0;
+	bool m_bridgeEndReady       = false;
+	bool m_closed               = false;
+	bool m_sendFailed           = false;
+	bool m_keepMessages         = true;
+	bool m_echo                 = false;
+
+	// Only accessed from within the loop
+	std::deque< std::string > m_outbound;
+	std::size_t m_outboundOffset = 0;
+	std::size_t m_blockedSends   = 0;
+
+	void runInLoop(std::function< void() > task) {
+		std::promise< void > done;
+
+		m_loop.post([&]() {
+			try {
+				task();
+				done.set_value();
+			} catch (...) {
+				done.set_exception(std::current_exception());
+			}
+		});
+
+		done.get_future().get();
+	}
+
+	void setBridgeEnd(std::unique_ptr< Transports::Connection > connection) {
+		m_bridgeEnd = std::move(connection);
+		m_bridgeEnd->watch(
+			m_loop, [this]() { onBridgeEndReadable(); }, [this]() { flushOutbound(); });
+
+		boost::lock_guard< boost::mutex > guard(m_mutex);
+		m_bridgeEndReady = true;
+		m_condition.notify_all();
+	}
+
+	void onMessage(std::string_view message) {
+		{
+			boost::lock_guard< boost::mutex > guard(m_mutex);
+
+			if (m_keepMessages) {
+				m_received.emplace_back(message);
+			}
+			m_receivedCount++;
+			m_condition.notify_all();
+		}
+
+		if (m_echo) {
+			m_outbound.push_back(frame(std::string(message), m_backend->getFraming()));
+			flushOutbound();
+		}
+	}
+
+	void onBridgeEndReadable() {
+		while (true) {
+			std::string_view message;
+			switch (m_bridgeEnd->tryReceive(message)) {
+				case Transports::Status::OK:
+					onMessage(message);
+					break;
+				case Transports::Status::CLOSED: {
+					m_bridgeEnd->unwatch();
+
+					boost::lock_guard< boost::mutex > guard(m_mutex);
+					m_closed = true;
+					m_condition.notify_all();
+
+					return;
+				}
+				default:
+					return;
+			}
+		}
+	}
+
+	void flushOutbound() {
+		while (!m_outbound.empty()) {
+			std::string_view data = m_outbound.front();
+			data.remove_prefix(m_outboundOffset);
+
+			std::size_t sent = 0;
+			switch (m_bridgeEnd->trySend(data, sent)) {
+				case Transports::Status::OK:
+					m_outbound.pop_front();
+					m_outboundOffset = 0;
+					break;
+				case Transports::Status::WOULD_BLOCK:
+					m_outboundOffset += sent;
+					m_blockedSends++;
+					m_bridgeEnd->setWriteInterest(true);
+					return;
+				default: {
+					m_outbound.clear();
+					m_outboundOffset = 0;
+
+					boost::lock_guard< boost::mutex > guard(m_mutex);
+					m_sendFailed = true;
+					m_condition.notify_all();
+
+					return;
+				}
+			}
+		}
+
+		m_bridgeEnd->setWriteInterest(false);
+	}
+
+	bool waitFor(std::function< bool() > predicate) {
+		boost::unique_lock< boost::mutex > lock(m_mutex);
+
+		return m_condition.wait_for(lock, boost::chrono::milliseconds(TRANSPORT_TIMEOUT), predicate);
+	}
+
+public:
+	/**
+	 * @param backend The backend of the transport to set up
+	 * @param keepMessages Whether the messages received by the Bridge's end shall be kept (or only counted)
+	 * @param echo Whether the Bridge's end shall send every message it receives back to the client
+	 */
+	explicit Harness(std::unique_ptr< Backend > backend, bool keepMessages = true, bool echo = false)
+		: m_backend(std::move(backend)), m_keepMessages(keepMessages), m_echo(echo) {
+		m_loopThread = boost::thread([this]() { m_loop.run(); });
+
+		m_listener = m_backend->createListener();
+
+		runInLoop([this]() {
+			m_listener->start(
+				m_loop,
+				[this](std::unique_ptr< Transports::Connection > connection) {
+					setBridgeEnd(m_backend->accept(std::move(connection)));
+				},
+				[this](const std::vector< std::string_view > &messages) {
+					for (std::string_view current : messages) {
+						onMessage(current);
+					}
+				},
+				[](const DiscardedFrame &) {});
+		});
+
+		m_client = m_backend->connect();
+
+		if (!m_backend->isConnectionOriented()) {
+			runInLoop([this]() { setBridgeEnd(m_backend->open()); });
+		}
+
+		if (!waitFor([this]() { return m_bridgeEndReady; })) {
+			throw std::runtime_error("The Bridge's end of the transport has not been set up");
+		}
+	}
+
+	~Harness() {
+		runInLoop([this]() {
+			m_bridgeEnd.reset();
+			m_listener->stop();
+		});
+
+		m_loop.stop();
+		m_loopThread.join();
+	}
+
+	/**
+	 * @returns The client's end of the transport or nullptr if it has been disconnected
+	 */
+	[[nodiscard]] Transports::Connection *getClient() const noexcept { return m_client.get(); }
+
+	/**
+	 * Closes the client's end of the transport
+	 */
+	void disconnectClient() { m_client.reset(); }
+
+	/**
+	 * Queues the given messages for being sent from the Bridge's end and starts sending them
+	 */
+	void sendFromBridge(const std::vector< std::string > &messages) {
+		runInLoop([&]() {
+			for (const std::string &current : messages) {
+				m_outbound.push_back(frame(current, m_backend->getFraming()));
+			}
+
+			flushOutbound();
+		});
+	}
+
+	/**
+	 * @returns How often the Bridge's end could not send (all of) a message right away
+	 */
+	[[nodiscard]] std::size_t getBlockedSends() {
+		std::size_t blockedSends = 0;
+		runInLoop([&]() { blockedSends = m_blockedSends; });
+
+		return blockedSends;
+	}
+
+	/**
+	 * Waits until the Bridge's end has received at least the given amount of messages
+	 *
+	 * @returns The received messages (if they are kept)
+	 */
+	[[nodiscard]] std::vector< std::string > waitForMessages(std::size_t count) {
+		if (!waitFor([&]() { return m_receivedCount >= count; })) {
+			throw std::runtime_error("Only received " + std::to_string(m_receivedCount) + " of "
+									 + std::to_string(count) + " messages");
+		}
+
+		boost::lock_guard< boost::mutex > guard(m_mutex);
+
+		return m_received;
+	}
+
+	/**
+	 * Waits until the Bridge's end has noticed that the client is gone - either because the connection has been
+	 * closed or because sending to the client failed
+	 *
+	 * @returns Whether the client's disappearance has been noticed in time
+	 */
+	[[nodiscard]] bool waitForDisconnect() {
+		return waitFor([this]() { return m_closed || m_sendFailed; });
+	}
+
+	[[nodiscard]] const Backend &getBackend() const noexcept { return *m_backend; }
+};
+
+}; // namespace TransportHarness
+
+#endif // MUMBLE_JSONBRIDGE_TESTS_TRANSPORTHARNESS_H_
@@ -0,0 +1,97 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+// Measures the throughput (client to Bridge) and the round-trip latency (client to Bridge and back) of every
+// transport, so that the backends can be compared with one another.
+//
+// Usage: bench_transports [messageCount] [messageSize]
+
+#include "TransportHarness.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace Mumble::JsonBridge;
+using namespace TransportHarness;
+
+double measureThroughput(const BackendInfo &backend, std::size_t messageCount, const std::string &message) {
+	Harness harness(backend.create(), false);
+
+	auto start = std::chrono::steady_clock::now();
+
+	for (std::size_t i = 0; i < messageCount; i++) {
+		harness.getClient()->send(message, TRANSPORT_TIMEOUT);
+	}
+
+	// The messages aren't kept, so there is nothing to look at
+	std::vector< std::string > received = harness.waitForMessages(messageCount);
+
+	auto end = std::chrono::steady_clock::now();
+
+	return messageCount / std::chrono::duration< double >(end - start).count();
+}
+
+std::vector< double > measureRoundTrips(const BackendInfo &backend, std::size_t messageCount,
+										const std::string &message) {
+	Harness harness(backend.create(), false, true);
+
+	std::vector< double > roundTrips;
+	roundTrips.reserve(messageCount);
+
+	for (std::size_t i = 0; i < messageCount; i++) {
+		auto start = std::chrono::steady_clock::now();
+
+		harness.getClient()->send(message, TRANSPORT_TIMEOUT);
+		std::string answer = harness.getClient()->receive(TRANSPORT_TIMEOUT);
+
+		auto end = std::chrono::steady_clock::now();
+
+		roundTrips.push_back(std::chrono::duration< double, std::micro >(end - start).count());
+	}
+
+	std::sort(roundTrips.begin(), roundTrips.end());
+
+	return roundTrips;
+}
+
+int main(int argc, char **argv) {
+	std::size_t messageCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000;
+	std::size_t messageSize  = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 256;
+
+	if (messageCount == 0 || messageSize < 2) {
+		std::cerr << "Invalid arguments" << std::endl;
+		return 1;
+	}
+
+	// A JSON string of the requested size
+	const std::string message = "\"" + std::string(messageSize - 2, 'x') + "\"";
+
+	std::cout << "Sending " << messageCount << " messages of " << messageSize << " bytes each" << std::endl;
+	std::cout << std::left << std::setw(14) << "Backend" << std::setw(16) << "Throughput" << std::setw(16)
+			  << "RTT (median)" << "RTT (p99)" << std::endl;
+
+	try {
+		for (const BackendInfo &current : getBackends()) {
+			double throughput                = measureThroughput(current, messageCount, message);
+			std::vector< double > roundTrips = measureRoundTrips(current, messageCount, message);
+
+			std::cout << std::left << std::setw(14) << current.name << std::setw(16)
+					  << (std::to_string(static_cast< long >(throughput)) + " msg/s") << std::setw(16)
+					  << (std::to_string(static_cast< long >(roundTrips[roundTrips.size() / 2])) + " us")
+					  << (std::to_string(static_cast< long >(roundTrips[roundTrips.size() * 99 / 100])) + " us")
+					  << std::endl;
+		}
+	} catch (const std::exception &e) {
+		std::cerr << "Benchmark failed: " << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,116 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+// Checks that every transport behaves the way the Bridge expects a Transports::Connection and Transports::Listener
+// to behave. Every test is run against every backend.
+
+#include "gtest/gtest.h"
+
+#include "TransportHarness.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace Mumble::JsonBridge;
+using namespace TransportHarness;
+
+class TransportConformance : public ::testing::TestWithParam< BackendInfo > {
+protected:
+	std::unique_ptr< Harness > m_harness;
+
+	void SetUp() override { m_harness = std::make_unique< Harness >(GetParam().create()); }
+
+	void TearDown() override { m_harness.reset(); }
+
+	static std::vector< std::string > createMessages(std::size_t count, std::size_t padding = 0) {
+		std::vector< std::string > messages;
+
+		for (std::size_t i = 0; i < count; i++) {
+			messages.push_back("{\"index\":" + std::to_string(i) + ",\"padding\":\"" + std::string(padding, 'x')
+							   + "\"}");
+		}
+
+		return messages;
+	}
+};
+
+TEST_P(TransportConformance, clientToBridge_keepsMessagesInOrder) {
+	std::vector< std::string > messages = createMessages(100);
+
+	for (const std::string &current : messages) {
+		m_harness->getClient()->send(current, TRANSPORT_TIMEOUT);
+	}
+
+	ASSERT_EQ(m_harness->waitForMessages(messages.size()), messages);
+}
+
+TEST_P(TransportConformance, bridgeToClient_keepsMessagesInOrder) {
+	std::vector< std::string > messages = createMessages(100);
+
+	m_harness->sendFromBridge(messages);
+
+	for (const std::string &current : messages) {
+		ASSERT_EQ(m_harness->getClient()->receive(TRANSPORT_TIMEOUT), current);
+	}
+}
+
+TEST_P(TransportConformance, largeMessages) {
+	std::vector< std::string > messages = createMessages(2, 64 * 1024);
+
+	for (const std::string &current : messages) {
+		m_harness->getClient()->send(current, TRANSPORT_TIMEOUT);
+	}
+
+	ASSERT_EQ(m_harness->waitForMessages(messages.size()), messages);
+
+	m_harness->sendFromBridge(messages);
+
+	for (const std::string &current : messages) {
+		ASSERT_EQ(m_harness->getClient()->receive(TRANSPORT_TIMEOUT), current);
+	}
+}
+
+TEST_P(TransportConformance, tryReceive_doesNotBlock) {
+	std::string_view message;
+
+	ASSERT_EQ(m_harness->getClient()->tryReceive(message), Transports::Status::WOULD_BLOCK);
+
+	m_harness->sendFromBridge({ "{\"index\":0}" });
+
+	// The message is received as soon as it has arrived
+	std::string received = m_harness->getClient()->receive(TRANSPORT_TIMEOUT);
+	ASSERT_EQ(received, "{\"index\":0}");
+
+	ASSERT_EQ(m_harness->getClient()->tryReceive(message), Transports::Status::WOULD_BLOCK);
+}
+
+TEST_P(TransportConformance, backpressure_resumesOnceClientReads) {
+	// Way more than fits into any of the transports' buffers. The Bridge's end must neither block nor drop anything
+	// while the client isn't reading.
+	std::vector< std::string > messages = createMessages(1000, 4 * 1024);
+
+	m_harness->sendFromBridge(messages);
+
+	ASSERT_GT(m_harness->getBlockedSends(), 0u) << "The transport has never been full";
+
+	for (const std::string &current : messages) {
+		ASSERT_EQ(m_harness->getClient()->receive(TRANSPORT_TIMEOUT), current);
+	}
+}
+
+TEST_P(TransportConformance, clientDisconnect_isNoticed) {
+	m_harness->disconnectClient();
+
+	if (!m_harness->getBackend().isConnectionOriented()) {
+		// There is nothing that could tell that the client is gone but trying to send something to it
+		m_harness->sendFromBridge({ "{\"index\":0}" });
+	}
+
+	ASSERT_TRUE(m_harness->waitForDisconnect());
+}
+
+INSTANTIATE_TEST_SUITE_P(AllBackends, TransportConformance, ::testing::ValuesIn(getBackends()),
+						 [](const ::testing::TestParamInfo< BackendInfo > &info) { return info.param.name; });
@@ -0,0 +1,114 @@
+// Copyright 2020 The Mumble Developers. All rights reserved.
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file at the root of the
+// source tree.
+
+#include "gtest/gtest.h"
+
+#include <mumble/json_bridge/WorkerGroup.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace Mumble::JsonBridge;
+
+TEST(BoundedQueue, tryPushFailsWhileFull) {
+	BoundedQueue< int > queue(1);
+
+	int item = 1;
+	ASSERT_TRUE(queue.tryPush(item));
+
+	item = 2;
+	ASSERT_FALSE(queue.tryPush(item));
+	ASSERT_EQ(item, 2);
+	ASSERT_EQ(queue.size(), 1);
+
+	bool wasFull;
+	ASSERT_TRUE(queue.pop(item, wasFull));
+	ASSERT_EQ(item, 1);
+	ASSERT_TRUE(wasFull);
+
+	item = 3;
+	ASSERT_TRUE(queue.tryPush(item));
+
+	queue.close();
+
+	item = 4;
+	ASSERT_FALSE(queue.tryPush(item));
+}
+
+TEST(WorkerGroup, tryDispatchHoldsBackJobsWhileQueueIsFull) {
+	std::atomic_bool started    = false;
+	std::atomic_bool released   = false;
+	std::atomic_int roomReports = 0;
+
+	std::mutex processedMutex;
+	std::vector< int > processed;
+
+	WorkerGroup< int > group;
+	group.start(
+		1, 1,
+		[&](int &job) {
+			started = true;
+			while (!released) {
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+
+			std::lock_guard< std::mutex > guard(processedMutex);
+			processed.push_back(job);
+		},
+		[&]() { roomReports++; });
+
+	// The first job keeps the worker busy, the second one fills its queue
+	ASSERT_TRUE(group.tryDispatch(0, 1));
+	while (!started) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	ASSERT_TRUE(group.tryDispatch(0, 2));
+
+	// Neither of these may overtake the other
+	ASSERT_FALSE(group.tryDispatch(0, 3));
+	ASSERT_FALSE(group.tryDispatch(0, 4));
+	ASSERT_TRUE(group.hasBacklog());
+	ASSERT_FALSE(group.drain());
+
+	released = true;
+
+	while (!group.drain()) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	ASSERT_FALSE(group.hasBacklog());
+	ASSERT_GE(roomReports, 1);
+
+	group.stop();
+
+	ASSERT_EQ(processed, (std::vector< int >{ 1, 2, 3, 4 }));
+}
+
+TEST(WorkerGroup, stopDiscardsHeldBackJobs) {
+	std::atomic_bool released = false;
+	std::atomic_int processed = 0;
+
+	WorkerGroup< int > group;
+	group.start(1, 1, [&](int &) {
+		while (!released) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		processed++;
+	});
+
+	// At most two of these fit into the worker and its queue
+	for (int i = 0; i < 4; i++) {
+		group.tryDispatch(0, i);
+	}
+	ASSERT_TRUE(group.hasBacklog());
+
+	released = true;
+	group.stop();
+
+	ASSERT_FALSE(group.hasBacklog());
+	ASSERT_LE(processed, 2);
+}
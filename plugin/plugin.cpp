@@ -12,6 +12,16 @@ class MumbleJsonBridge : public MumblePlugin {
 private:
 	Mumble::JsonBridge::Bridge m_bridge;
 
+	static Mumble::JsonBridge::Event createEvent(Mumble::JsonBridge::EventTopic topic, mumble_connection_t connection,
+												 mumble_userid_t userID = 0) {
+		Mumble::JsonBridge::Event event;
+		event.topic      = topic;
+		event.connection = connection;
+		event.userID     = userID;
+
+		return event;
+	}
+
 public:
 	MumbleJsonBridge()
 		: MumblePlugin("JSON Bridge", "Mumble Developers",
@@ -32,6 +42,80 @@ public:
 	}
 
 	void releaseResource(const void *ptr) noexcept override { std::terminate(); }
+
+	// The Bridge keeps a model of the servers' users and channels, so that it can answer read-only API calls without
+	// going through Mumble's main thread. Some of the callbacks are also pushed as events to the clients that have
+	// subscribed to them.
+
+	void onServerConnected(mumble_connection_t connection) noexcept override {
+		m_bridge.publish(createEvent(Mumble::JsonBridge::EventTopic::SERVER_CONNECTED, connection));
+	}
+
+	void onServerSynchronized(mumble_connection_t connection) noexcept override {
+		m_bridge.getServerState().onServerSynchronized(connection);
+	}
+
+	void onServerDisconnected(mumble_connection_t connection) noexcept override {
+		m_bridge.getServerState().onServerDisconnected(connection);
+
+		m_bridge.publish(createEvent(Mumble::JsonBridge::EventTopic::SERVER_DISCONNECTED, connection));
+	}
+
+	void onUserAdded(mumble_connection_t connection, mumble_userid_t userID) noexcept override {
+		m_bridge.getServerState().onUserAdded(connection, userID);
+
+		m_bridge.publish(createEvent(Mumble::JsonBridge::EventTopic::USER_ADDED, connection, userID));
+	}
+
+	void onUserRemoved(mumble_connection_t connection, mumble_userid_t userID) noexcept override {
+		m_bridge.getServerState().onUserRemoved(connection, userID);
+
+		m_bridge.publish(createEvent(Mumble::JsonBridge::EventTopic::USER_REMOVED, connection, userID));
+	}
+
+	void onChannelAdded(mumble_connection_t connection, mumble_channelid_t channelID) noexcept override {
+		m_bridge.getServerState().onChannelAdded(connection, channelID);
+	}
+
+	void onChannelRemoved(mumble_connection_t connection, mumble_channelid_t channelID) noexcept override {
+		m_bridge.getServerState().onChannelRemoved(connection, channelID);
+	}
+
+	void onChannelRenamed(mumble_connection_t connection, mumble_channelid_t channelID) noexcept override {
+		m_bridge.getServerState().onChannelRenamed(connection, channelID);
+	}
+
+	void onChannelEntered(mumble_connection_t connection, mumble_userid_t userID, mumble_channelid_t previousChannelID,
+						  mumble_channelid_t newChannelID) noexcept override {
+		m_bridge.getServerState().onChannelEntered(connection, userID, previousChannelID, newChannelID);
+
+		Mumble::JsonBridge::Event event =
+			createEvent(Mumble::JsonBridge::EventTopic::CHANNEL_ENTERED, connection, userID);
+		event.channelID         = newChannelID;
+		event.previousChannelID = previousChannelID;
+
+		m_bridge.publish(event);
+	}
+
+	void onChannelExited(mumble_connection_t connection, mumble_userid_t userID,
+						 mumble_channelid_t channelID) noexcept override {
+		m_bridge.getServerState().onChannelExited(connection, userID, channelID);
+
+		Mumble::JsonBridge::Event event =
+			createEvent(Mumble::JsonBridge::EventTopic::CHANNEL_EXITED, connection, userID);
+		event.channelID = channelID;
+
+		m_bridge.publish(event);
+	}
+
+	void onUserTalkingStateChanged(mumble_connection_t connection, mumble_userid_t userID,
+								   mumble_talking_state_t talkingState) noexcept override {
+		Mumble::JsonBridge::Event event =
+			createEvent(Mumble::JsonBridge::EventTopic::TALKING_STATE, connection, userID);
+		event.talkingState = talkingState;
+
+		m_bridge.publish(event);
+	}
 };
 
 MumblePlugin &MumblePlugin::getPlugin() noexcept {
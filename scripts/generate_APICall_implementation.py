@@ -14,6 +14,18 @@ class Parameter:
         self.m_name = name
         self.m_type = paramType
 
+# Functions that are provided by the Bridge itself rather than by the Mumble API. They are called like any API function,
+# so their parse_* and read_* functions are generated and they are part of the function table. Their write_* functions
+# are implemented by hand in APICall.cpp.
+BRIDGE_FUNCTIONS = [
+    ("getServerSnapshot", [Parameter("connection", "mumble_connection_t")]),
+    ("getChangesSince", [Parameter("connection", "mumble_connection_t"), Parameter("version", "uint64_t")]),
+    ("findUsersByName", [Parameter("connection", "mumble_connection_t"), Parameter("user_name", "std::string"),
+                         Parameter("case_sensitive", "bool"), Parameter("prefix", "bool")]),
+    ("findChannelsByName", [Parameter("connection", "mumble_connection_t"), Parameter("channel_name", "std::string"),
+                            Parameter("case_sensitive", "bool"), Parameter("prefix", "bool")]),
+]
+
 def camel_to_snake(name):
     converted = ""
     prevConverted = False
@@ -35,7 +47,8 @@ def getJsonType(cppType):
         return "string"
     elif cppType == "int":
         return "number_integer"
-    elif cppType == "unsigned int" or cppType == "uint8_t" or cppType == "uint16_t" or cppType == "uint32_t":
+    elif cppType == "unsigned int" or cppType == "uint8_t" or cppType == "uint16_t" or cppType == "uint32_t" \
+            or cppType == "uint64_t":
         return "number_unsigned"
     elif cppType == "double" or cppType == "float":
         return "number_float"
@@ -70,44 +83,225 @@ def generateLicenseHeader():
 
     return licenseHeader
 
-def generateSetInit(name, elements):
-    init = "const std::unordered_set<std::string> APICall::" + name + " = {\n"
-    for current in elements:
-        init += "\t\"" + current + "\",\n"
-
-    # remove last ",\n"
-    init = init[0 : -2]
-    init += "\n};"
-
-    return init
-
-def generateExecuteFunction(functionNames, functionsWithoutParameters):
-    func = "nlohmann::json execute(const std::string &functionName, const MumbleAPI &api, const std::string &bridgeSecret, "\
-            + "const nlohmann::json &msg) {\n"
-    
-    for i in range(len(functionNames)):
-        if i == 0:
-            func += "\tif ("
+def getCppType(paramType):
+    # Use std::string for const char * types
+    if paramType == "const char *":
+        paramType = "std::string"
+    # Remove const
+    if paramType.startswith("const"):
+        paramType = paramType[len("const"): ].strip()
+    # Remove reference
+    if paramType.endswith("&"):
+        paramType = paramType[ : -1].strip()
+
+    return paramType
+
+def getReadFunction(jsonType):
+    # The functions used for reading a value of the given JSON type (see APICall.cpp)
+    if jsonType == "number_integer":
+        return "readInteger"
+    elif jsonType == "number_unsigned":
+        return "readUnsigned"
+    elif jsonType == "number_float":
+        return "readFloat"
+    elif jsonType == "boolean":
+        return "readBoolean"
+    elif jsonType == "string":
+        return "readString"
+    elif jsonType == "array":
+        return "readArray"
+
+    raise RuntimeError("Unable to read JSON type " + jsonType)
+
+def getStructName(functionName):
+    return "Parameter_" + functionName
+
+def generateParameterStruct(functionName, parameter):
+    struct = "/**\n"
+    struct += " * The parameter of the API function " + functionName + "\n"
+    struct += " */\n"
+    struct += "struct " + getStructName(functionName) + " {\n"
+    for currentParam in parameter:
+        paramType = getCppType(currentParam.m_type)
+        if not paramType.endswith("*"):
+            paramType += " "
+        struct += "\t" + paramType + currentParam.m_name + " = {};\n"
+    struct += "};"
+
+    return struct
+
+def generateParseFunction(functionName, parameter):
+    func = "APIParameter parse_" + functionName + "(const nlohmann::json &parameter) {\n"
+
+    # Generate verification code
+    func += "\t// Validate specified parameter\n"
+    func += "\tif (parameter.size() != " + str(len(parameter)) + ") {\n"
+    func += "\t\tthrow InvalidMessageException(std::string(\"API function \\\"" + functionName + "\\\" expects " \
+            + str(len(parameter)) + " parameter(s) but got \") + std::to_string(parameter.size()));\n"
+    func += "\t}\n"
+
+    for currentParam in parameter:
+        func += "\tMESSAGE_ASSERT_FIELD(parameter, \"" + currentParam.m_name + "\", " + getJsonType(currentParam.m_type) + ");\n"
+
+    func += "\n"
+    func += "\t// Convert the parameter from JSON to the corresponding cpp types\n"
+    func += "\t" + getStructName(functionName) + " fields;\n"
+
+    # convert JSON to cpp
+    for currentParam in parameter:
+        paramType = getCppType(currentParam.m_type)
+
+        if not "*" in paramType:
+            # Non-pointers
+            func += "\tfields." + currentParam.m_name + " = parameter[\"" + currentParam.m_name + "\"].get<" + paramType + ">();\n"
         else:
-            func += " else if ("
+            # pointers
+            func += "\tfields." + currentParam.m_name + " = reinterpret_cast<" + paramType + \
+                    ">(parameter[\"" + currentParam.m_name + "\"].get<" + "uintptr_t" + ">());\n"
 
-        func += "functionName == \"" + functionNames[i] + "\") {\n"
-        func += "\t\treturn handle_" + functionNames[i] + "(api, bridgeSecret"
-        if not functionNames[i] in functionsWithoutParameters:
-            func += ", msg[\"parameter\"]"
-        func += ");\n"
-        func += "\t}"
+    func += "\n"
+    func += "\treturn fields;\n"
+    func += "}"
+
+    return func
 
-    func += "\n\n"
-    func += "\tthrow std::invalid_argument(std::string(\"Unknown API function \\\"\") + functionName + \"\\\"\");\n"
+def generateReadFunction(functionName, parameter):
+    func = "int read_" + functionName + "(APIParameter &parameter, std::string_view name, ParameterValue &value) {\n"
+    func += "\tif (!std::holds_alternative<" + getStructName(functionName) + ">(parameter)) {\n"
+    func += "\t\tparameter.emplace<" + getStructName(functionName) + ">();\n"
+    func += "\t}\n"
+    func += "\t" + getStructName(functionName) + " &fields = std::get<" + getStructName(functionName) + ">(parameter);\n"
+    func += "\n"
+
+    # Values are validated by the read functions as they are read
+    for i in range(len(parameter)):
+        func += "\tif (name == \"" + parameter[i].m_name + "\") {\n"
+        func += "\t\treturn " + getReadFunction(getJsonType(parameter[i].m_type)) + "(fields." + parameter[i].m_name + ", value) ? " \
+                + str(i) + " : -1;\n"
+        func += "\t}\n"
+
+    func += "\n"
+    func += "\treturn -1;\n"
     func += "}"
 
     return func
 
+def generateParameterHeader(structNames, parameterStructs):
+    header = generateLicenseHeader()
+    header += "\n"
+    header += "// This file was auto-generated by scripts/generate_APICall_implementation.py. DO NOT EDIT MANUALLY!\n"
+    header += "\n"
+    header += "#ifndef MUMBLE_JSONBRIDGE_MESSAGES_APIPARAMETER_H_\n"
+    header += "#define MUMBLE_JSONBRIDGE_MESSAGES_APIPARAMETER_H_\n"
+    header += "\n"
+    header += "#include <mumble/plugin/MumbleAPI.h>\n"
+    header += "\n"
+    header += "#include <cstdint>\n"
+    header += "#include <string>\n"
+    header += "#include <variant>\n"
+    header += "#include <vector>\n"
+    header += "\n"
+    header += "namespace Mumble {\n"
+    header += "namespace JsonBridge {\n"
+    header += "\tnamespace Messages {\n"
+    header += "\n"
+
+    for currentStruct in parameterStructs:
+        for line in currentStruct.split("\n"):
+            header += "\t\t" + line + "\n"
+        header += "\n"
+
+    header += "\t\t/**\n"
+    header += "\t\t * The parameter of any API function. Functions that don't take any parameter use std::monostate.\n"
+    header += "\t\t */\n"
+    header += "\t\tusing APIParameter = std::variant<std::monostate"
+    for currentName in structNames:
+        header += ", " + currentName
+    header += ">;\n"
+
+    header += "\t}; // namespace Messages\n"
+    header += "};     // namespace JsonBridge\n"
+    header += "};     // namespace Mumble\n"
+    header += "\n"
+    header += "#endif // MUMBLE_JSONBRIDGE_MESSAGES_APIPARAMETER_H_\n"
+
+    return header
+
+def hashFunctionName(name, seed):
+    # Has to match hashFunctionName() in APICall.cpp (32-bit FNV-1a, mixed with the seed)
+    hashValue = (2166136261 ^ seed) & 0xFFFFFFFF
+    for c in name.encode("utf-8"):
+        hashValue ^= c
+        hashValue = (hashValue * 16777619) & 0xFFFFFFFF
+
+    return hashValue
+
+def findPerfectHash(functionNames):
+    # Look for a seed for which every function name ends up in a slot of its own
+    tableSize = 1
+    while tableSize < 2 * len(functionNames):
+        tableSize *= 2
+
+    while True:
+        for seed in range(100000):
+            slots = [-1] * tableSize
+            collision = False
+
+            for i in range(len(functionNames)):
+                slot = hashFunctionName(functionNames[i], seed) % tableSize
+
+                if slots[slot] != -1:
+                    collision = True
+                    break
+
+                slots[slot] = i
+
+            if not collision:
+                return seed, slots
+
+        tableSize *= 2
+
+def generateFunctionTable(functionNames, parameterCounts):
+    seed, slots = findPerfectHash(functionNames)
+
+    table = "constexpr std::array<APIFunction, " + str(len(functionNames)) + "> s_apiFunctions = { {\n"
+    for i in range(len(functionNames)):
+        table += "\t{ \"" + functionNames[i] + "\", " + str(parameterCounts[i]) + ", "
+        if parameterCounts[i] > 0:
+            table += "&parse_" + functionNames[i] + ", &read_" + functionNames[i]
+        else:
+            table += "nullptr, nullptr"
+        table += ", &write_" + functionNames[i] + " },\n"
+
+    # remove last ",\n"
+    table = table[0 : -2]
+    table += "\n} };\n\n"
+
+    table += "// Perfect hash of the function names: Every function is found in the slot given by its name's hash (-1 marks an\n"
+    table += "// empty slot)\n"
+    table += "constexpr std::uint32_t API_FUNCTION_HASH_SEED = " + str(seed) + ";\n"
+    table += "constexpr std::array<std::int8_t, " + str(len(slots)) + "> s_apiFunctionSlots = { {\n\t"
+    table += ", ".join([str(current) for current in slots])
+    table += "\n} };\n\n"
+
+    table += "const APIFunction *findAPIFunction(std::string_view name) {\n"
+    table += "\tconst std::int8_t index = s_apiFunctionSlots[hashFunctionName(name, API_FUNCTION_HASH_SEED) % s_apiFunctionSlots.size()];\n"
+    table += "\n"
+    table += "\t// Names that aren't known might end up in the slot of another function\n"
+    table += "\tif (index < 0 || s_apiFunctions[index].name != name) {\n"
+    table += "\t\treturn nullptr;\n"
+    table += "\t}\n"
+    table += "\n"
+    table += "\treturn &s_apiFunctions[index];\n"
+    table += "}"
+
+    return table
+
 def main():
-    parser = argparse.ArgumentParser(description="Generates the implementation for the handle_* functions of the APICall class")
+    parser = argparse.ArgumentParser(description="Generates the implementation for the write_* functions of the APICall class")
     parser.add_argument("-i", "--api-header", help="The path to the C++ API-wrapper header-file")
     parser.add_argument("-o", "--output-file", help="Path to which the generated source code shall be written")
+    parser.add_argument("-p", "--parameter-header", help="Path to which the generated header declaring the parameter structs shall be written")
 
     args = parser.parse_args()
 
@@ -123,12 +317,9 @@ def main():
 
     generatedImpl += "\n"
 
-    # Add place-holder for init of static member variables containing function names
-    generatedImpl += "%s\n\n"
-
-
     functionNames = []
-    noParamFunctionNames = []
+    parameterCounts = []
+    parameterStructs = []
 
     functionPattern = re.compile("((?:\w|:|\<[^>]*\>)+)\s*(\w+)\s*\(([^)]*)\)\s*(.*)")
     functions = apiHeader.split(";")
@@ -174,66 +365,30 @@ def main():
             parameter.append(Parameter(paramName, paramType))
 
         functionNames.append(functionName)
-        if len(parameter) == 0:
-            noParamFunctionNames.append(functionName);
-        
-        generatedFunction = "nlohmann::json handle_" + functionName + "(const MumbleAPI &api, const std::string &bridgeSecret"
+        parameterCounts.append(len(parameter))
 
         if len(parameter) > 0:
-            generatedFunction += ", const nlohmann::json &parameter"
+            parameterStructs.append(generateParameterStruct(functionName, parameter))
 
-        generatedFunction += ") {\n"
+            generatedImpl += generateParseFunction(functionName, parameter) + "\n\n"
+            generatedImpl += generateReadFunction(functionName, parameter) + "\n\n"
 
-        # Generate verification code
-        if len(parameter) > 0:
-            generatedFunction += "\t// Validate specified parameter\n"
-            generatedFunction += "\tif (parameter.size() != " + str(len(parameter)) + ") {\n"
-            generatedFunction += "\t\tthrow InvalidMessageException(std::string(\"API function \\\"" + functionName + "\\\" expects " \
-                    + str(len(parameter)) + " parameter(s) but got \") + std::to_string(parameter.size()));\n"
-            generatedFunction += "\t}\n"
-
-        for currentParam in parameter:
-            generatedFunction += "\tMESSAGE_ASSERT_FIELD(parameter, \"" + currentParam.m_name + "\", " + getJsonType(currentParam.m_type) + ");\n"
+        # All writers share the same signature, so that they can be put into the function table
+        generatedFunction = "bool write_" + functionName + "(const MumbleAPI &api"
 
-        generatedFunction += "\n"
         if len(parameter) > 0:
-            generatedFunction += "\t// Convert the parameter from JSON to the corresponding cpp types\n"
-
-        # convert JSON to cpp
-        for currentParam in parameter:
-            paramType = currentParam.m_type
-            # Use std::string for const char * types
-            if paramType == "const char *":
-                paramType = "std::string"
-            # Remove const
-            if paramType.startswith("const"):
-                paramType = paramType[len("const"): ].strip()
-            # Remove reference
-            if paramType.endswith("&"):
-                paramType = paramType[ : -1].strip()
-
-            if not "*" in paramType:
-                # Non-pointers
-                generatedFunction += "\t" + paramType + " " +  currentParam.m_name + " = parameter[\"" + currentParam.m_name + "\"].get<"\
-                        + paramType + ">();\n"
-            else:
-                # pointers
-                generatedFunction += "\t" + paramType + " " +  currentParam.m_name + " = reinterpret_cast<" + paramType + \
-                        ">(parameter[\"" + currentParam.m_name + "\"].get<" + "uintptr_t" + ">());\n"
-
-        generatedFunction += "\n"
+            generatedFunction += ", const APIParameter &parameter, ResponseWriter &writer) {\n"
+            generatedFunction += "\tconst " + getStructName(functionName) + " &fields = std::get<" + getStructName(functionName) + ">(parameter);\n"
+            generatedFunction += "\n"
+        else:
+            generatedFunction += ", const APIParameter &, ResponseWriter &writer) {\n"
         generatedFunction += "\t// Call respective API function"
         if len(parameter) > 0:
             generatedFunction += " with extracted parameter"
         generatedFunction += "\n"
 
-        # call API with extracted parameter
-        generatedFunction += "\tnlohmann::json response;\n"
-
-        generatedFunction += "\n"
-
         indent = "\t"
-        if not "noexcept" in modifiers or "std::optional" in returnType:
+        if not "noexcept" in modifiers:
             generatedFunction += "\ttry {\n"
             indent = "\t\t"
 
@@ -244,7 +399,7 @@ def main():
         generatedFunction += "api." + functionName + "("
 
         for currentParam in parameter:
-            generatedFunction += currentParam.m_name
+            generatedFunction += "fields." + currentParam.m_name
             if currentParam.m_type == "const char *":
                 generatedFunction += ".c_str()"
 
@@ -258,79 +413,57 @@ def main():
 
         generatedFunction += "\n"
 
-        # report result
-        generatedFunction += indent + "// clang-format off\n"
-        generatedFunction += indent + "response = {\n"
-        generatedFunction += indent + "\t{\"response_type\", \"api_call\"},\n"
-        generatedFunction += indent + "\t{\"secret\", bridgeSecret},\n"
-        generatedFunction += indent + "\t{\"response\",\n"
-        generatedFunction += indent + "\t\t{\n"
-        generatedFunction += indent + "\t\t\t{\"function\", \"" + functionName + "\"},\n"
-        generatedFunction += indent + "\t\t\t{\"status\", \"executed\"}"
+        if "std::optional" in returnType:
+            generatedFunction += indent + "if (!ret) {\n"
+            generatedFunction += indent + "\twriter.raw(R\"(\"response_type\":\"api_error_optional\",\"response\":{\"error_message\":" \
+                    + "\"Optional value not present\"})\");\n"
+            generatedFunction += "\n"
+            generatedFunction += indent + "\treturn false;\n"
+            generatedFunction += indent + "}\n"
+            generatedFunction += "\n"
+
+        # report result (the constant parts of the response are written as they are)
+        generatedFunction += indent + "writer.raw(R\"(\"response_type\":\"api_call\",\"response\":{\"function\":\"" + functionName \
+                + "\",\"status\":\"executed\""
         if not returnType == "void":
+            generatedFunction += ",\"return_value\":)\");\n"
             if not "std::optional" in returnType:
-                generatedFunction += ",\n" + indent + "\t\t\t{\"return_value\", ret}"
+                generatedFunction += indent + "writer.value(ret);\n"
             else:
-                generatedFunction += ",\n" + indent + "\t\t\t{\"return_value\", ret.value()}"
-        generatedFunction += "\n" + indent + "\t\t}\n"
-        generatedFunction += indent + "\t}\n"
-        generatedFunction += indent + "};\n"
-        generatedFunction += indent + "// clang-format on\n"
-
-
-        if not "noexcept" in modifiers or "std::optional" in returnType:
-            generatedFunction += "\t}"
-
-            if not "noexcept" in modifiers:
-                generatedFunction += " catch (const MumbleAPIException &e) {\n"
-                generatedFunction += "\t\t// clang-format off\n"
-                generatedFunction += "\t\tresponse = {\n"
-                generatedFunction += "\t\t\t{\"response_type\", \"api_error\"},\n"
-                generatedFunction += "\t\t\t{\"secret\", bridgeSecret},\n"
-                generatedFunction += "\t\t\t{\"response\",\n"
-                generatedFunction += "\t\t\t\t{\n"
-                generatedFunction += "\t\t\t\t\t{\"error_code\", e.errorCode()},\n"
-                generatedFunction += "\t\t\t\t\t{\"error_message\", e.what()}\n"
-                generatedFunction += "\t\t\t\t}\n"
-                generatedFunction += "\t\t\t}\n"
-                generatedFunction += "\t\t};\n"
-                generatedFunction += "\t\t// clang-format on\n"
-                generatedFunction += "\t}"
-
-            if "std::optional" in returnType:
-                generatedFunction += " catch (const std::bad_optional_access &) {\n"
-                generatedFunction += "\t\t// clang-format off\n"
-                generatedFunction += "\t\tresponse = {\n"
-                generatedFunction += "\t\t\t{\"response_type\", \"api_error_optional\"},\n"
-                generatedFunction += "\t\t\t{\"secret\", bridgeSecret},\n"
-                generatedFunction += "\t\t\t{\"response\",\n"
-                generatedFunction += "\t\t\t\t{\n"
-                generatedFunction += "\t\t\t\t\t{\"error_message\", \"Optional value not present\"},\n"
-                generatedFunction += "\t\t\t\t}\n"
-                generatedFunction += "\t\t\t}\n"
-                generatedFunction += "\t\t};\n"
-                generatedFunction += "\t\t// clang-format on\n"
-                generatedFunction += "\t}"
-
-            generatedFunction += "\n"
+                generatedFunction += indent + "writer.value(*ret);\n"
+            generatedFunction += indent + "writer.raw(\"}\");\n"
+        else:
+            generatedFunction += "})\");\n"
 
         generatedFunction += "\n"
+        generatedFunction += indent + "return true;\n"
 
-        generatedFunction += "\treturn response;\n"
+        if not "noexcept" in modifiers:
+            generatedFunction += "\t} catch (const MumbleAPIException &e) {\n"
+            generatedFunction += "\t\twriteAPIError(writer, e);\n"
+            generatedFunction += "\n"
+            generatedFunction += "\t\treturn false;\n"
+            generatedFunction += "\t}\n"
 
         generatedFunction += "}"
 
         generatedImpl += generatedFunction
         generatedImpl += "\n\n"
 
-    
+    for functionName, parameter in BRIDGE_FUNCTIONS:
+        functionNames.append(functionName)
+        parameterCounts.append(len(parameter))
 
-    initCode = generateSetInit("s_allFunctions", functionNames) + "\n\n"
-    initCode += generateSetInit("s_noParamFunctions", noParamFunctionNames)
+        if len(parameter) > 0:
+            parameterStructs.append(generateParameterStruct(functionName, parameter))
 
-    generatedImpl = generatedImpl % initCode
+            generatedImpl += generateParseFunction(functionName, parameter) + "\n\n"
+            generatedImpl += generateReadFunction(functionName, parameter) + "\n\n"
 
-    generatedImpl += generateExecuteFunction(functionNames, noParamFunctionNames) + "\n\n"
+    generatedImpl += generateFunctionTable(functionNames, parameterCounts) + "\n\n"
+
+    structNames = [getStructName(functionNames[i]) for i in range(len(functionNames)) if parameterCounts[i] > 0]
+    generatedHeader = generateParameterHeader(structNames, parameterStructs)
 
     if args.output_file is None:
         # print to standard output
@@ -339,6 +472,10 @@ def main():
         outFile = open(args.output_file, "w")
         outFile.write(generatedImpl)
 
+    if not args.parameter_header is None:
+        headerFile = open(args.parameter_header, "w")
+        headerFile.write(generatedHeader)
+
 
 
 